@@ -15,7 +15,9 @@
 #include "megdnn/basic_types.h"
 #include "megdnn/oprs/base.h"
 
+#include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
@@ -28,12 +30,19 @@ private:
 public:
     static HeuristicCache& instance();
 
+    /*!
+     * \brief binary encoded key
+     *
+     * category identifies the handle and operator type, and input encodes the
+     * layouts and param; hash is the XXHash of both of them
+     */
     struct KeyStorage {
         std::string category;
         std::string input;
+        uint64_t hash = 0;
 
         bool operator==(const KeyStorage& k) const {
-            return category == k.category && input == k.input;
+            return hash == k.hash && category == k.category && input == k.input;
         }
     };
 
@@ -45,8 +54,7 @@ public:
         const void* m_param_ptr;
         size_t m_param_size;
 
-        mutable std::string m_category;
-        mutable std::string m_input;
+        mutable KeyStorage m_storage;
 
     public:
         Key(Handle* opr_handle, Algorithm::OprType opr_type,
@@ -59,7 +67,7 @@ public:
                   m_param_ptr{param_ptr},
                   m_param_size{param_size} {}
 
-        KeyStorage build_key_storage() const;
+        const KeyStorage& build_key_storage() const;
     };
 
     struct Result {
@@ -67,27 +75,44 @@ public:
         size_t workspace;
     };
 
+    struct Stats {
+        size_t nr_hit = 0;
+        size_t nr_miss = 0;
+    };
+
     void put(const Key& key, Result& result);
 
     Result get(const Key& key);
 
     void clear();
 
+    //! number of cache hits and misses of get() since the last clear()
+    Stats stats() const;
+
 private:
     struct Hash {
-        size_t operator()(const KeyStorage& k) const {
-            size_t h1 = std::hash<std::string>{}(k.category);
-            size_t h2 = std::hash<std::string>{}(k.input);
-            h1 ^= h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2);
-            return h1;
-        }
+        size_t operator()(const KeyStorage& k) const { return k.hash; }
     };
-    std::unordered_map<KeyStorage, Result, Hash> m_heuristic_cache;
+
+    //! the cache is split into shards by key hash, each of which has its own
+    //! lock, so that lookups from different threads rarely contend
+    static constexpr size_t NR_SHARD = 16;
+
+    struct alignas(64) Shard {
+        std::unordered_map<KeyStorage, Result, Hash> cache;
+        std::atomic_size_t nr_hit{0}, nr_miss{0};
 #if __DEPLOY_ON_XP_SP2__
-    size_t m_mtx;
+        size_t mtx;
 #else
-    std::mutex m_mtx;
+        std::shared_timed_mutex mtx;
 #endif
+    };
+    Shard m_shards[NR_SHARD];
+
+    Shard& get_shard(const KeyStorage& key) {
+        // low bits are used by the buckets of unordered_map
+        return m_shards[(key.hash >> 32) % NR_SHARD];
+    }
 };
 
 }  // namespace megdnn
@@ -1936,6 +1936,292 @@ protected:
             const TensorLayout& grad_s, size_t workspace_in_bytes);
 };
 
+class SoftmaxForward : public OperatorBase {
+    DEF_OPR_IMPL(SoftmaxForward, OperatorBase, 1, 1);
+    DEF_OPR_PARAM(Softmax);
+
+public:
+    /**
+     * \brief dst = exp(src - max(src)) / sum(exp(src - max(src))) along
+     *      param().axis
+     *
+     * \param[in] src input tensor of float dtype
+     * \param[out] dst output tensor of the same layout as src
+     *
+     * src and dst must be contiguous.
+     */
+    virtual void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(const TensorLayout& src, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& dst) = 0;
+
+    //! get the axis in [0, src.ndim) from param().axis
+    size_t get_real_axis(const TensorLayout& src) const;
+
+protected:
+    void check_exec(
+            const TensorLayout& src, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using Softmax = SoftmaxForward;
+
+class LayerNormForward : public OperatorBase {
+    DEF_OPR_IMPL(LayerNormForward, OperatorBase, 3, 1);
+    DEF_OPR_PARAM(LayerNorm);
+
+public:
+    /**
+     * \brief normalize data over its last param().normalized_dim dims
+     *
+     * dst = (data - mean) / sqrt(var + eps) * weight + bias, where mean and
+     * var are computed over the normalized dims, and weight and bias have the
+     * shape of the normalized dims. weight and bias are ignored if
+     * param().affine is false.
+     *
+     * data and dst must be contiguous.
+     */
+    virtual void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst) = 0;
+
+    //! view data as nr_row rows of row_size normalized elements
+    void get_row_size(
+            const TensorLayout& data, size_t& nr_row, size_t& row_size) const;
+
+protected:
+    void check_exec(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using LayerNorm = LayerNormForward;
+
+class GroupNormForward : public OperatorBase {
+    DEF_OPR_IMPL(GroupNormForward, OperatorBase, 3, 1);
+    DEF_OPR_PARAM(GroupNorm);
+
+public:
+    /**
+     * \brief normalize each group of channels of data in (N, C, *) layout
+     *
+     * The C channels are divided into param().group groups, and mean and var
+     * are computed over all the elements of the channels in a group. weight
+     * and bias are of shape (C) and are ignored if param().affine is false.
+     *
+     * data and dst must be contiguous.
+     */
+    virtual void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& data, const TensorLayout& weight,
+            const TensorLayout& bias, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using GroupNorm = GroupNormForward;
+
+class AttentionForward : public OperatorBase {
+    DEF_OPR_IMPL(AttentionForward, OperatorBase, 4, 1);
+    DEF_OPR_PARAM(Attention);
+
+public:
+    /**
+     * \brief dst = softmax(q * k^T * scale + mask) * v
+     *
+     * \param[in] q (..., Lq, D)
+     * \param[in] k (..., Lk, D)
+     * \param[in] v (..., Lk, Dv)
+     * \param[in] mask additive mask of shape (Lq, Lk), which is shared by all
+     *      the batches, or (..., Lq, Lk); it can also be empty
+     * \param[out] dst (..., Lq, Dv)
+     *
+     * The leading dims, e.g. the batch and the heads, are the same for all the
+     * tensors, which must be contiguous. The (Lq, Lk) scores are not required
+     * to be materialized by the impls.
+     */
+    virtual void exec(
+            _megdnn_tensor_in q, _megdnn_tensor_in k, _megdnn_tensor_in v,
+            _megdnn_tensor_in mask, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& q, const TensorLayout& k, const TensorLayout& v,
+            const TensorLayout& mask, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& q, const TensorLayout& k, const TensorLayout& v,
+            const TensorLayout& mask, const TensorLayout& dst) = 0;
+
+    //! view q, k and v as batch matrices of (Lq, D), (Lk, D) and (Lk, Dv)
+    static void get_matrix_shape(
+            const TensorLayout& q, const TensorLayout& k, const TensorLayout& v,
+            size_t& batch, size_t& Lq, size_t& Lk, size_t& D, size_t& Dv);
+
+protected:
+    void check_exec(
+            const TensorLayout& q, const TensorLayout& k, const TensorLayout& v,
+            const TensorLayout& mask, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using Attention = AttentionForward;
+
+/*!
+ * \brief base class of the recurrent sequence oprs
+ *
+ * The sequence is in (T, N, I) format, and the hidden states are of shape
+ * (num_layers * D, N, H), where D is 2 if param().bidirectional, otherwise 1.
+ * All the weights are packed into a 1-D tensor; see get_weight_offsets() for
+ * its layout.
+ *
+ * The optional seq_len of shape (N) in Int32 gives the valid length of each
+ * sequence, which must be no more than T. The outputs after the end of a
+ * sequence are zero, and its final hidden states are those at its end; the
+ * reverse direction starts from the last valid step.
+ */
+class RNNBase : public OperatorBase {
+    DEF_OPR_IMPL_CTOR(RNNBase, OperatorBase);
+    DEF_OPR_PARAM(RNN);
+
+public:
+    //! offsets of the weights of one direction of a layer, in number of elements
+    struct WeightOffset {
+        size_t w_ih, w_hh, b_ih, b_hh;
+    };
+
+    /*!
+     * \brief get the offsets of the weights in the packed weight tensor
+     *
+     * The weights of each layer are packed in order, the forward direction
+     * before the reverse one. Each direction consists of w_ih of shape
+     * (nr_gate * H, I) for the first layer or (nr_gate * H, D * H) for the
+     * others, w_hh of shape (nr_gate * H, H), then b_ih and b_hh of shape
+     * (nr_gate * H) if param.bias. The gates of each weight are stacked in
+     * the order documented by the derived class.
+     *
+     * \param[out] nr_weight total number of weights
+     * \return offsets indexed by layer * D + direction
+     */
+    static SmallVector<WeightOffset> get_weight_offsets(
+            const Param& param, size_t nr_gate, size_t input_size,
+            size_t hidden_size, size_t& nr_weight);
+
+protected:
+    //! cx and cy are empty if there is no cell state
+    void deduce_layout_fwd(
+            const TensorLayout& input, const TensorLayout& hx,
+            const TensorLayout& cx, TensorLayout& output, TensorLayout& hy,
+            TensorLayout& cy);
+    void check_exec_fwd(
+            size_t nr_gate, const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& cx,
+            const TensorLayout& flatten_weights, const TensorLayout& output,
+            const TensorLayout& hy, const TensorLayout& cy);
+};
+
+/*!
+ * \brief LSTM over a sequence
+ *
+ * The gates are stacked in the order of input, forget, cell and output:
+ * c' = f * c + i * g, h' = o * tanh(c')
+ */
+class LSTMForward : public RNNBase {
+    DEF_OPR_IMPL(LSTMForward, RNNBase, 5, 3);
+
+public:
+    static constexpr size_t NR_GATE = 4;
+
+    /**
+     * \param[in] input (T, N, I)
+     * \param[in] seq_len (N) or empty
+     * \param[in] hx initial hidden states
+     * \param[in] cx initial cell states, of the same shape as hx
+     * \param[in] flatten_weights packed weights
+     * \param[out] output (T, N, D * H), the hidden states of the last layer
+     * \param[out] hy final hidden states
+     * \param[out] cy final cell states
+     */
+    virtual void exec(
+            _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+            _megdnn_tensor_in cx, _megdnn_tensor_in flatten_weights,
+            _megdnn_tensor_out output, _megdnn_tensor_out hy, _megdnn_tensor_out cy,
+            _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& cx,
+            const TensorLayout& flatten_weights, TensorLayout& output,
+            TensorLayout& hy, TensorLayout& cy);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& cx,
+            const TensorLayout& flatten_weights, const TensorLayout& output,
+            const TensorLayout& hy, const TensorLayout& cy) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& cx,
+            const TensorLayout& flatten_weights, const TensorLayout& output,
+            const TensorLayout& hy, const TensorLayout& cy,
+            size_t workspace_in_bytes);
+};
+using LSTM = LSTMForward;
+
+/*!
+ * \brief GRU over a sequence
+ *
+ * The gates are stacked in the order of reset, update and new:
+ * n = tanh(W_in * x + b_in + r * (W_hn * h + b_hn)), h' = (1 - z) * n + z * h
+ */
+class GRUForward : public RNNBase {
+    DEF_OPR_IMPL(GRUForward, RNNBase, 4, 2);
+
+public:
+    static constexpr size_t NR_GATE = 3;
+
+    /**
+     * \param[in] input (T, N, I)
+     * \param[in] seq_len (N) or empty
+     * \param[in] hx initial hidden states
+     * \param[in] flatten_weights packed weights
+     * \param[out] output (T, N, D * H), the hidden states of the last layer
+     * \param[out] hy final hidden states
+     */
+    virtual void exec(
+            _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+            _megdnn_tensor_in flatten_weights, _megdnn_tensor_out output,
+            _megdnn_tensor_out hy, _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& flatten_weights,
+            TensorLayout& output, TensorLayout& hy);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& flatten_weights,
+            const TensorLayout& output, const TensorLayout& hy) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& flatten_weights,
+            const TensorLayout& output, const TensorLayout& hy,
+            size_t workspace_in_bytes);
+};
+using GRU = GRUForward;
+
 }  // namespace megdnn
 #include "megdnn/internal/opr_header_epilogue.h"
 
@@ -1201,3 +1201,54 @@ PADDING_MODES = [Doc('REPLICATE = 0', 'aaaaaa|abcdefgh|hhhhhhh'),
           member_alias=[(i, 'PADDING_{}'.format(i)) for i in PADDING_MODES]
           )
 )
+
+(pdef('Softmax').
+ add_fields('int32',
+            Doc('axis',
+                'axis along which softmax is performed, negative value means '
+                'counting from the last dim'),
+            -1)
+)
+
+(pdef('LayerNorm').
+ add_fields('bool',
+            Doc('affine', 'whether to apply the elementwise weight and bias'),
+            'true').
+ add_fields('float32', Doc('eps', 'added to the variance for stability'), '1e-5f').
+ add_fields('uint32',
+            Doc('normalized_dim',
+                'number of trailing dims over which the statistics are computed, '
+                'and of the weight and bias'),
+            '1')
+)
+
+(pdef('GroupNorm').
+ add_fields('bool',
+            Doc('affine', 'whether to apply the channelwise weight and bias'),
+            'true').
+ add_fields('float32', Doc('eps', 'added to the variance for stability'), '1e-5f').
+ add_fields('uint32', Doc('group', 'number of groups the channels are divided into'),
+            '1')
+)
+
+(pdef('Attention', 'scaled dot-product attention').
+ add_fields('float32',
+            Doc('scale', 'multiplied to the product of query and key, which is '
+                'usually 1 / sqrt(D)'),
+            '1.f').
+ add_fields('bool',
+            Doc('causal', 'whether the i-th query only attends to the first '
+                'i + Lk - Lq + 1 keys'),
+            'false')
+)
+
+(pdef('RNN', 'multi-layer recurrent network over a sequence, used by LSTM and GRU').
+ add_fields('uint32', Doc('num_layers', 'number of stacked layers'), '1').
+ add_fields('bool',
+            Doc('bidirectional', 'whether each layer also runs over the reversed '
+                'sequence, with the outputs of both directions concatenated'),
+            'false').
+ add_fields('bool',
+            Doc('bias', 'whether the weights contain the input and hidden biases'),
+            'true')
+)
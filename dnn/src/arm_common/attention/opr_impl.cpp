@@ -0,0 +1,26 @@
+/**
+ * \file dnn/src/arm_common/attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/attention/opr_impl.h"
+
+#include "src/arm_common/simd_vec_neon.h"
+
+#include "src/fallback/softmax/softmax_kern_helper.h"
+#include "src/fallback/attention/attention_kern_helper.h"
+
+using namespace megdnn;
+using namespace arm_common;
+
+fallback::attention::Kern AttentionForwardImpl::get_kern() const {
+    return megdnn::attention::attention<VecNEON>;
+}
+
+// vim: syntax=cpp.doxygen
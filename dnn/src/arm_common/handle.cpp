@@ -13,17 +13,21 @@
 
 #include "src/arm_common/handle.h"
 
+#include "src/arm_common/attention/opr_impl.h"
 #include "src/arm_common/conv_bias/opr_impl.h"
 #include "src/arm_common/convolution/opr_impl.h"
 #include "src/arm_common/cvt_color/opr_impl.h"
 #include "src/arm_common/elemwise/opr_impl.h"
 #include "src/arm_common/elemwise_multi_type/opr_impl.h"
 #include "src/arm_common/local/opr_impl.h"
+#include "src/arm_common/norm/opr_impl.h"
 #include "src/arm_common/pooling/opr_impl.h"
 #include "src/arm_common/reduce/opr_impl.h"
 #include "src/arm_common/resize/opr_impl.h"
+#include "src/arm_common/rnn/opr_impl.h"
 #include "src/arm_common/separable_conv/opr_impl.h"
 #include "src/arm_common/separable_filter/opr_impl.h"
+#include "src/arm_common/softmax/opr_impl.h"
 #include "src/arm_common/type_cvt/opr_impl.h"
 #include "src/arm_common/warp_affine/opr_impl.h"
 #include "src/arm_common/warp_perspective/opr_impl.h"
@@ -50,6 +54,12 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(TypeCvt)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Reduce)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionBackwardData)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SoftmaxForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LayerNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GroupNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(AttentionForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LSTMForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GRUForward)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -0,0 +1,35 @@
+/**
+ * \file dnn/src/arm_common/norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/norm/opr_impl.h"
+
+#include "src/arm_common/simd_vec_neon.h"
+
+#include "src/fallback/norm/norm_kern_helper.h"
+
+using namespace megdnn;
+using namespace arm_common;
+
+namespace {
+fallback::norm::Kern get_neon_kern() {
+    return {megdnn::norm::layer_norm<VecNEON>, megdnn::norm::group_norm<VecNEON>};
+}
+}  // anonymous namespace
+
+fallback::norm::Kern LayerNormForwardImpl::get_kern() const {
+    return get_neon_kern();
+}
+
+fallback::norm::Kern GroupNormForwardImpl::get_kern() const {
+    return get_neon_kern();
+}
+
+// vim: syntax=cpp.doxygen
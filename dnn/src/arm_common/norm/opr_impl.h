@@ -0,0 +1,38 @@
+/**
+ * \file dnn/src/arm_common/norm/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/fallback/norm/opr_impl.h"
+
+namespace megdnn {
+namespace arm_common {
+
+class LayerNormForwardImpl : public fallback::LayerNormForwardImpl {
+public:
+    using fallback::LayerNormForwardImpl::LayerNormForwardImpl;
+
+protected:
+    fallback::norm::Kern get_kern() const override;
+};
+
+class GroupNormForwardImpl : public fallback::GroupNormForwardImpl {
+public:
+    using fallback::GroupNormForwardImpl::GroupNormForwardImpl;
+
+protected:
+    fallback::norm::Kern get_kern() const override;
+};
+
+}  // namespace arm_common
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,29 @@
+/**
+ * \file dnn/src/arm_common/rnn/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/rnn/opr_impl.h"
+
+#include "src/arm_common/simd_vec_neon.h"
+
+#include "src/fallback/rnn/rnn_kern_helper.h"
+
+using namespace megdnn;
+using namespace arm_common;
+
+fallback::rnn::StepKern LSTMForwardImpl::get_kern() const {
+    return megdnn::rnn::step<VecNEON, true>;
+}
+
+fallback::rnn::StepKern GRUForwardImpl::get_kern() const {
+    return megdnn::rnn::step<VecNEON, false>;
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,63 @@
+/**
+ * \file dnn/src/arm_common/simd_vec_neon.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+//! float32 vector of NEON used by the kernels templated on Vec, like softmax,
+//! attention and rnn
+
+#include "src/arm_common/elemwise/neon_mathfun.h"
+#include "src/arm_common/simd_macro/marm_neon.h"
+#include "src/common/utils.h"
+
+//! no special target is needed by NEON
+#define MEGDNN_SIMD_VEC_TARGET
+
+namespace {
+struct VecNEON {
+    using type = float32x4_t;
+    static constexpr size_t width = 4;
+    static type load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, type v) { vst1q_f32(p, v); }
+    static type set1(float v) { return vdupq_n_f32(v); }
+    static type add(type a, type b) { return vaddq_f32(a, b); }
+    static type sub(type a, type b) { return vsubq_f32(a, b); }
+    static type mul(type a, type b) { return vmulq_f32(a, b); }
+    static type div(type a, type b) {
+#if MEGDNN_AARCH64
+        return vdivq_f32(a, b);
+#else
+        //! the reciprocal estimate refined by two newton steps
+        type r = vrecpeq_f32(b);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+#endif
+    }
+    static type fmadd(type a, type b, type c) {
+#if defined(__ARM_FEATURE_FMA)
+        return vfmaq_f32(c, a, b);
+#else
+        return vmlaq_f32(c, a, b);
+#endif
+    }
+    static type max(type a, type b) { return vmaxq_f32(a, b); }
+    static type min(type a, type b) { return vminq_f32(a, b); }
+    static type exp(type v) { return megdnn::arm_common::exp_ps_f32(v); }
+    static float reduce_add(type v) { return vaddvq_f32(v); }
+    static float reduce_max(type v) {
+        float32x2_t t = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpmax_f32(t, t), 0);
+    }
+};
+}  // anonymous namespace
+
+// vim: syntax=cpp.doxygen
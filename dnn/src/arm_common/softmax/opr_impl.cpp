@@ -0,0 +1,25 @@
+/**
+ * \file dnn/src/arm_common/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/softmax/opr_impl.h"
+
+#include "src/arm_common/simd_vec_neon.h"
+
+#include "src/fallback/softmax/softmax_kern_helper.h"
+
+using namespace megdnn;
+using namespace arm_common;
+
+fallback::SoftmaxForwardImpl::Kern SoftmaxForwardImpl::get_kern() const {
+    return {softmax::softmax_c1<VecNEON>, softmax::softmax_strided<VecNEON>};
+}
+
+// vim: syntax=cpp.doxygen
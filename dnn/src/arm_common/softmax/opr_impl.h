@@ -0,0 +1,30 @@
+/**
+ * \file dnn/src/arm_common/softmax/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/fallback/softmax/opr_impl.h"
+
+namespace megdnn {
+namespace arm_common {
+
+class SoftmaxForwardImpl : public fallback::SoftmaxForwardImpl {
+public:
+    using fallback::SoftmaxForwardImpl::SoftmaxForwardImpl;
+
+protected:
+    Kern get_kern() const override;
+};
+
+}  // namespace arm_common
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,89 @@
+/**
+ * \file dnn/src/common/attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void AttentionForward::get_matrix_shape(
+        const TensorLayout& q, const TensorLayout& k, const TensorLayout& v,
+        size_t& batch, size_t& Lq, size_t& Lk, size_t& D, size_t& Dv) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(q) + ", " + megdnn_layout_msg(k) + ", " +
+               megdnn_layout_msg(v);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    size_t ndim = q.ndim;
+    megdnn_assert(
+            ndim >= 2 && k.ndim == ndim && v.ndim == ndim, "%s", errmsg().c_str());
+    batch = 1;
+    for (size_t i = 0; i + 2 < ndim; ++i) {
+        megdnn_assert(q[i] == k[i] && q[i] == v[i], "%s", errmsg().c_str());
+        batch *= q[i];
+    }
+    Lq = q[ndim - 2];
+    Lk = k[ndim - 2];
+    D = q[ndim - 1];
+    Dv = v[ndim - 1];
+    megdnn_assert(k[ndim - 1] == D && v[ndim - 2] == Lk, "%s", errmsg().c_str());
+}
+
+void AttentionForward::deduce_layout(
+        const TensorLayout& q, const TensorLayout& k, const TensorLayout& v,
+        const TensorLayout&, TensorLayout& dst) {
+    size_t batch, Lq, Lk, D, Dv;
+    get_matrix_shape(q, k, v, batch, Lq, Lk, D, Dv);
+    dst = q;
+    dst[dst.ndim - 1] = Dv;
+    dst.init_contiguous_stride();
+}
+
+void AttentionForward::check_exec(
+        const TensorLayout& q, const TensorLayout& k, const TensorLayout& v,
+        const TensorLayout& mask, const TensorLayout& dst, size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(q);
+    megdnn_assert_contiguous(k);
+    megdnn_assert_contiguous(v);
+    megdnn_assert_contiguous(dst);
+    megdnn_assert(
+            q.dtype.category() == DTypeCategory::FLOAT && k.dtype == q.dtype &&
+                    v.dtype == q.dtype && dst.dtype == q.dtype,
+            "attention requires float inputs of the same dtype, got q=%s k=%s "
+            "v=%s dst=%s",
+            q.dtype.name(), k.dtype.name(), v.dtype.name(), dst.dtype.name());
+    size_t batch, Lq, Lk, D, Dv;
+    get_matrix_shape(q, k, v, batch, Lq, Lk, D, Dv);
+    TensorLayout dst_expected;
+    deduce_layout(q, k, v, mask, dst_expected);
+    megdnn_assert_eq_shape(dst_expected, dst);
+    if (mask.ndim) {
+        megdnn_assert_contiguous(mask);
+        bool shared = mask.ndim == 2 && mask[0] == Lq && mask[1] == Lk;
+        TensorShape full = dst;
+        full[full.ndim - 1] = Lk;
+        megdnn_assert(
+                mask.dtype == q.dtype && (shared || mask.eq_shape(full)),
+                "invalid attention mask %s for scores of shape %s",
+                mask.to_string().c_str(), full.to_string().c_str());
+    }
+    megdnn_assert(
+            !param().causal || Lq <= Lk,
+            "causal attention requires no more queries than keys, got %zu and %zu",
+            Lq, Lk);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(q, k, v, mask, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
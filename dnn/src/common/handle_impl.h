@@ -146,7 +146,13 @@ private:
                                                                                                                                                                                                                                                                                                                             LSQBackward)                                                                                                                                                                                                                \
                                                                                                                                                                                                                                                                                                                             cb(Fill) cb(                                                                                                                                                                                                                \
                                                                                                                                                                                                                                                                                                                                     PaddingForward)                                                                                                                                                                                                     \
-                                                                                                                                                                                                                                                                                                                                    cb(PaddingBackward)
+                                                                                                                                                                                                                                                                                                                                    cb(PaddingBackward)                                                                                                                                                                                                 \
+                                                                                                                                                                                                                                                                                                                                    cb(SoftmaxForward)                                                                                                                                                                                                  \
+                                                                                                                                                                                                                                                                                                                                    cb(LayerNormForward)                                                                                                                                                                                                \
+                                                                                                                                                                                                                                                                                                                                    cb(GroupNormForward)                                                                                                                                                                                                \
+                                                                                                                                                                                                                                                                                                                                    cb(AttentionForward)                                                                                                                                                                                                \
+                                                                                                                                                                                                                                                                                                                                    cb(LSTMForward)                                                                                                                                                                                                     \
+                                                                                                                                                                                                                                                                                                                                    cb(GRUForward)
 
 /*!
  * \brief specialize HandleImpl::create_operator for a single opr type;
@@ -11,6 +11,7 @@
  */
 
 #include "megdnn/heuristic_cache.h"
+#include "megdnn/tensor_format.h"
 #include "src/common/utils.h"
 #include "src/naive/handle.h"
 
@@ -31,39 +32,40 @@ HeuristicCache& HeuristicCache::instance() {
     return ins;
 }
 
-HeuristicCache::KeyStorage HeuristicCache::Key::build_key_storage() const {
-    auto&& ctg = m_category;
-    auto&& inp = m_input;
+namespace {
+template <typename T>
+void append_pod(std::string& buf, const T& val) {
+    buf.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+}  // anonymous namespace
 
-    if (!m_category.empty() && !m_input.empty())
-        return {ctg, inp};
+const HeuristicCache::KeyStorage& HeuristicCache::Key::build_key_storage() const {
+    if (m_storage.hash)
+        return m_storage;
 
-    inp.reserve(sizeof(TensorLayout) * 3 * m_inp_layouts_size + m_param_size);
+    auto&& ctg = m_storage.category;
+    auto&& inp = m_storage.input;
+    inp.reserve(
+            (sizeof(size_t) + sizeof(ptrdiff_t)) * TensorShape::MAX_NDIM *
+                    m_inp_layouts_size +
+            m_param_size);
     for (size_t i = 0; i < m_inp_layouts_size; i++) {
         auto&& ly = m_inp_layouts_ptr[i];
-        for (size_t j = 0; j < ly.ndim; j++) {
-            if (j)
-                inp.push_back(',');
-            inp.append(std::to_string(ly.shape[j]));
-        }
-        inp.push_back(';');
-        for (size_t j = 0; j < ly.ndim; j++) {
-            if (j)
-                inp.push_back(',');
-            inp.append(std::to_string(ly.stride[j]));
-        }
-        inp.push_back(';');
-        inp.append(ly.dtype.name());
-        inp.push_back(';');
-        inp.append(ly.format.to_string().c_str());
-        inp.push_back('|');
+        append_pod(inp, static_cast<uint32_t>(ly.ndim));
+        inp.append(
+                reinterpret_cast<const char*>(ly.shape), sizeof(ly.shape[0]) * ly.ndim);
+        inp.append(
+                reinterpret_cast<const char*>(ly.stride),
+                sizeof(ly.stride[0]) * ly.ndim);
+        append_pod(inp, static_cast<uint32_t>(ly.dtype.enumv()));
+        append_pod(inp, static_cast<uint32_t>(ly.format.type()));
+        ly.format.impl()->serialize_append(inp);
     }
     if (m_param_size) {
         inp.append(reinterpret_cast<const char*>(m_param_ptr), m_param_size);
     }
 
-    ctg = "plat:";
-    ctg.append(std::to_string(static_cast<uint32_t>(m_handle->type())));
+    append_pod(ctg, static_cast<uint32_t>(m_handle->type()));
     switch (m_handle->type()) {
 #if MEGDNN_WITH_CUDA
         case Handle::HandleType::CUDA: {
@@ -108,36 +110,58 @@ HeuristicCache::KeyStorage HeuristicCache::Key::build_key_storage() const {
             size_t nr_threads = static_cast<megdnn::naive::HandleImpl*>(m_handle)
                                         ->megcore_dispatcher()
                                         ->nr_threads();
-            ctg.append(";");
-            ctg.append(std::to_string(nr_threads));
-            ctg.append(";");
+            append_pod(ctg, static_cast<uint32_t>(nr_threads));
             break;
         }
         default:
-            ctg.append(";");
+            break;
     }
-    ctg.append(std::to_string(m_opr_type));
-    return {ctg, inp};
+    append_pod(ctg, m_opr_type);
+    uint64_t hash = XXHash64CT::hash(ctg.data(), ctg.size(), 20160701);
+    hash = XXHash64CT::hash(inp.data(), inp.size(), hash);
+    // zero is reserved to mark that the key storage has not been built
+    m_storage.hash = hash ? hash : 1;
+    return m_storage;
 }
 
 void HeuristicCache::put(const Key& key, Result& result) {
-    MEGDNN_LOCK_GUARD(m_mtx);
-    if (result.policy.algo.valid())
-        m_heuristic_cache[key.build_key_storage()] = result;
+    if (!result.policy.algo.valid())
+        return;
+    auto&& ks = key.build_key_storage();
+    auto&& shard = get_shard(ks);
+    MEGDNN_LOCK_GUARD(shard.mtx);
+    shard.cache[ks] = result;
 }
 
 HeuristicCache::Result HeuristicCache::get(const Key& key) {
-    MEGDNN_LOCK_GUARD(m_mtx);
-    KeyStorage ks = key.build_key_storage();
-    auto iter = m_heuristic_cache.find(ks);
-    if (iter == m_heuristic_cache.end()) {
-        return {};
-    } else {
-        return iter->second;
+    auto&& ks = key.build_key_storage();
+    auto&& shard = get_shard(ks);
+    {
+        MEGDNN_LOCK_GUARD_SHARED(shard.mtx);
+        auto iter = shard.cache.find(ks);
+        if (iter != shard.cache.end()) {
+            shard.nr_hit.fetch_add(1, std::memory_order_relaxed);
+            return iter->second;
+        }
     }
+    shard.nr_miss.fetch_add(1, std::memory_order_relaxed);
+    return {};
 }
 
 void HeuristicCache::clear() {
-    MEGDNN_LOCK_GUARD(m_mtx);
-    m_heuristic_cache.clear();
-}
\ No newline at end of file
+    for (auto&& shard : m_shards) {
+        MEGDNN_LOCK_GUARD(shard.mtx);
+        shard.cache.clear();
+        shard.nr_hit.store(0, std::memory_order_relaxed);
+        shard.nr_miss.store(0, std::memory_order_relaxed);
+    }
+}
+
+HeuristicCache::Stats HeuristicCache::stats() const {
+    Stats ret;
+    for (auto&& shard : m_shards) {
+        ret.nr_hit += shard.nr_hit.load(std::memory_order_relaxed);
+        ret.nr_miss += shard.nr_miss.load(std::memory_order_relaxed);
+    }
+    return ret;
+}
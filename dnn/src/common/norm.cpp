@@ -0,0 +1,117 @@
+/**
+ * \file dnn/src/common/norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+namespace {
+void check_affine(
+        const TensorLayout& data, const TensorLayout& weight, const TensorLayout& bias,
+        const TensorShape& expected) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(data) + ", " + megdnn_layout_msg(weight) + ", " +
+               megdnn_layout_msg(bias);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert_contiguous(weight);
+    megdnn_assert_contiguous(bias);
+    megdnn_assert(
+            weight.eq_shape(expected) && bias.eq_shape(expected), "%s",
+            errmsg().c_str());
+    megdnn_assert(
+            weight.dtype == data.dtype && bias.dtype == data.dtype, "%s",
+            errmsg().c_str());
+}
+}  // anonymous namespace
+
+/* ================ LayerNormForward ================ */
+
+void LayerNormForward::get_row_size(
+        const TensorLayout& data, size_t& nr_row, size_t& row_size) const {
+    size_t normalized_dim = param().normalized_dim;
+    megdnn_assert(
+            normalized_dim >= 1 && normalized_dim <= data.ndim,
+            "invalid normalized_dim %zu for %s", normalized_dim,
+            data.to_string().c_str());
+    nr_row = row_size = 1;
+    for (size_t i = 0; i < data.ndim; ++i) {
+        if (i + normalized_dim < data.ndim) {
+            nr_row *= data.shape[i];
+        } else {
+            row_size *= data.shape[i];
+        }
+    }
+}
+
+void LayerNormForward::deduce_layout(
+        const TensorLayout& data, const TensorLayout&, const TensorLayout&,
+        TensorLayout& dst) {
+    megdnn_assert_contiguous(data);
+    dst = data;
+}
+
+void LayerNormForward::check_exec(
+        const TensorLayout& data, const TensorLayout& weight, const TensorLayout& bias,
+        const TensorLayout& dst, size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(data);
+    megdnn_assert_eq_layout(data, dst);
+    megdnn_assert(
+            data.dtype.category() == DTypeCategory::FLOAT,
+            "layer norm only supports float input, got %s", data.dtype.name());
+    size_t nr_row, row_size;
+    get_row_size(data, nr_row, row_size);
+    if (param().affine) {
+        TensorShape normalized;
+        normalized.ndim = param().normalized_dim;
+        for (size_t i = 0; i < normalized.ndim; ++i) {
+            normalized.shape[i] = data.shape[data.ndim - normalized.ndim + i];
+        }
+        check_affine(data, weight, bias, normalized);
+    }
+    auto required_workspace_in_bytes = get_workspace_in_bytes(data, weight, bias, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+/* ================ GroupNormForward ================ */
+
+void GroupNormForward::deduce_layout(
+        const TensorLayout& data, const TensorLayout&, const TensorLayout&,
+        TensorLayout& dst) {
+    megdnn_assert_contiguous(data);
+    dst = data;
+}
+
+void GroupNormForward::check_exec(
+        const TensorLayout& data, const TensorLayout& weight, const TensorLayout& bias,
+        const TensorLayout& dst, size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(data);
+    megdnn_assert_eq_layout(data, dst);
+    megdnn_assert(
+            data.dtype.category() == DTypeCategory::FLOAT,
+            "group norm only supports float input, got %s", data.dtype.name());
+    megdnn_assert(
+            data.ndim >= 2 && param().group > 0 && data[1] % param().group == 0,
+            "group norm requires (N, C, *) input with C divisible by group %u, "
+            "got %s",
+            param().group, data.to_string().c_str());
+    if (param().affine) {
+        check_affine(data, weight, bias, TensorShape{data[1]});
+    }
+    auto required_workspace_in_bytes = get_workspace_in_bytes(data, weight, bias, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -135,6 +135,12 @@ DEF(CheckNonFinite, 2, true, true);
 DEF(LSQForward, 5, true, true);
 DEF(LSQBackward, 7, true, false);
 DEF(Fill, 1, true, false);
+DEF(SoftmaxForward, 2, true, true);
+DEF(LayerNormForward, 4, true, true);
+DEF(GroupNormForward, 4, true, true);
+DEF(AttentionForward, 5, true, true);
+DEF(LSTMForward, 8, true, true);
+DEF(GRUForward, 6, true, true);
 }  // namespace megdnn
 
 // vim: syntax=cpp.doxygen
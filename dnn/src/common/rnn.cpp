@@ -0,0 +1,145 @@
+/**
+ * \file dnn/src/common/rnn.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+SmallVector<RNNBase::WeightOffset> RNNBase::get_weight_offsets(
+        const Param& param, size_t nr_gate, size_t input_size, size_t hidden_size,
+        size_t& nr_weight) {
+    size_t D = param.bidirectional ? 2 : 1, G = nr_gate, H = hidden_size;
+    SmallVector<WeightOffset> offsets;
+    nr_weight = 0;
+    for (size_t layer = 0; layer < param.num_layers; ++layer) {
+        size_t layer_input_size = layer ? D * H : input_size;
+        for (size_t d = 0; d < D; ++d) {
+            WeightOffset off;
+            off.w_ih = nr_weight;
+            off.w_hh = off.w_ih + G * H * layer_input_size;
+            off.b_ih = off.w_hh + G * H * H;
+            off.b_hh = off.b_ih + (param.bias ? G * H : 0);
+            nr_weight = off.b_hh + (param.bias ? G * H : 0);
+            offsets.push_back(off);
+        }
+    }
+    return offsets;
+}
+
+void RNNBase::deduce_layout_fwd(
+        const TensorLayout& input, const TensorLayout& hx, const TensorLayout& cx,
+        TensorLayout& output, TensorLayout& hy, TensorLayout& cy) {
+    megdnn_assert(
+            input.ndim == 3 && hx.ndim == 3, "invalid rnn input %s and hx %s",
+            input.to_string().c_str(), hx.to_string().c_str());
+    size_t D = param().bidirectional ? 2 : 1;
+    output = TensorLayout{{input[0], input[1], D * hx[2]}, input.dtype};
+    hy = TensorLayout{hx, hx.dtype};
+    if (cx.ndim) {
+        cy = TensorLayout{cx, cx.dtype};
+    }
+}
+
+void RNNBase::check_exec_fwd(
+        size_t nr_gate, const TensorLayout& input, const TensorLayout& seq_len,
+        const TensorLayout& hx, const TensorLayout& cx,
+        const TensorLayout& flatten_weights, const TensorLayout& output,
+        const TensorLayout& hy, const TensorLayout& cy) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(input) + ", " + megdnn_layout_msg(seq_len) + ", " +
+               megdnn_layout_msg(hx) + ", " + megdnn_layout_msg(cx) + ", " +
+               megdnn_layout_msg(flatten_weights) + ", " + megdnn_layout_msg(output) +
+               ", " + megdnn_layout_msg(hy) + ", " + megdnn_layout_msg(cy);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert(param().num_layers > 0, "rnn requires at least one layer");
+    megdnn_assert(
+            input.ndim == 3 && hx.ndim == 3 && flatten_weights.ndim == 1, "%s",
+            errmsg().c_str());
+    size_t D = param().bidirectional ? 2 : 1, N = input[1], H = hx[2];
+    megdnn_assert(
+            hx[0] == param().num_layers * D && hx[1] == N && H > 0, "%s",
+            errmsg().c_str());
+    for (auto layout : {&input, &hx, &cx, &flatten_weights, &output, &hy, &cy}) {
+        if (layout->ndim) {
+            megdnn_assert_contiguous(*layout);
+            megdnn_assert(
+                    layout->dtype == input.dtype &&
+                            input.dtype.category() == DTypeCategory::FLOAT,
+                    "%s", errmsg().c_str());
+        }
+    }
+    if (seq_len.ndim) {
+        megdnn_assert_contiguous(seq_len);
+        megdnn_assert(
+                seq_len.ndim == 1 && seq_len[0] == N &&
+                        seq_len.dtype == dtype::Int32(),
+                "%s", errmsg().c_str());
+    }
+    megdnn_assert(
+            (cx.ndim != 0) == (nr_gate == LSTMForward::NR_GATE) &&
+                    (!cx.ndim || cx.eq_shape(hx)),
+            "%s", errmsg().c_str());
+    size_t nr_weight;
+    get_weight_offsets(param(), nr_gate, input[2], H, nr_weight);
+    megdnn_assert(
+            flatten_weights[0] == nr_weight, "expect %zu weights, got %s", nr_weight,
+            errmsg().c_str());
+    TensorLayout output_expected, hy_expected, cy_expected;
+    deduce_layout_fwd(input, hx, cx, output_expected, hy_expected, cy_expected);
+    megdnn_assert_eq_shape(output_expected, output);
+    megdnn_assert_eq_shape(hy_expected, hy);
+    if (cx.ndim) {
+        megdnn_assert_eq_shape(cy_expected, cy);
+    }
+}
+
+void LSTMForward::deduce_layout(
+        const TensorLayout& input, const TensorLayout&, const TensorLayout& hx,
+        const TensorLayout& cx, const TensorLayout&, TensorLayout& output,
+        TensorLayout& hy, TensorLayout& cy) {
+    deduce_layout_fwd(input, hx, cx, output, hy, cy);
+}
+
+void LSTMForward::check_exec(
+        const TensorLayout& input, const TensorLayout& seq_len, const TensorLayout& hx,
+        const TensorLayout& cx, const TensorLayout& flatten_weights,
+        const TensorLayout& output, const TensorLayout& hy, const TensorLayout& cy,
+        size_t workspace_in_bytes) {
+    megdnn_assert(cx.ndim, "cx is required by lstm");
+    check_exec_fwd(NR_GATE, input, seq_len, hx, cx, flatten_weights, output, hy, cy);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(
+            input, seq_len, hx, cx, flatten_weights, output, hy, cy);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+void GRUForward::deduce_layout(
+        const TensorLayout& input, const TensorLayout&, const TensorLayout& hx,
+        const TensorLayout&, TensorLayout& output, TensorLayout& hy) {
+    TensorLayout cy;
+    deduce_layout_fwd(input, hx, {}, output, hy, cy);
+}
+
+void GRUForward::check_exec(
+        const TensorLayout& input, const TensorLayout& seq_len, const TensorLayout& hx,
+        const TensorLayout& flatten_weights, const TensorLayout& output,
+        const TensorLayout& hy, size_t workspace_in_bytes) {
+    check_exec_fwd(NR_GATE, input, seq_len, hx, {}, flatten_weights, output, hy, {});
+    auto required_workspace_in_bytes =
+            get_workspace_in_bytes(input, seq_len, hx, flatten_weights, output, hy);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
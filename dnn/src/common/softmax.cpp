@@ -0,0 +1,49 @@
+/**
+ * \file dnn/src/common/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+size_t SoftmaxForward::get_real_axis(const TensorLayout& src) const {
+    int axis = param().axis;
+    int ndim = static_cast<int>(src.ndim);
+    if (axis < 0) {
+        axis += ndim;
+    }
+    megdnn_assert(
+            axis >= 0 && axis < ndim, "invalid softmax axis %d for %s", param().axis,
+            src.to_string().c_str());
+    return axis;
+}
+
+void SoftmaxForward::deduce_layout(const TensorLayout& src, TensorLayout& dst) {
+    megdnn_assert_contiguous(src);
+    dst = src;
+}
+
+void SoftmaxForward::check_exec(
+        const TensorLayout& src, const TensorLayout& dst, size_t workspace_in_bytes) {
+    megdnn_assert_contiguous(src);
+    megdnn_assert_eq_layout(src, dst);
+    megdnn_assert(
+            src.dtype.category() == DTypeCategory::FLOAT,
+            "softmax only supports float input, got %s", src.dtype.name());
+    get_real_axis(src);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(src, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
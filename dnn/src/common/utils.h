@@ -52,6 +52,7 @@
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <type_traits>
@@ -121,14 +122,17 @@
 #define megdnn_layout_msg(layout) std::string(#layout "=" + (layout).to_string())
 
 #if __DEPLOY_ON_XP_SP2__
-#define DNN_MUTEX              size_t
-#define MEGDNN_LOCK_GUARD(var) MEGDNN_MARK_USED_VAR(var)
+#define DNN_MUTEX                     size_t
+#define MEGDNN_LOCK_GUARD(var)        MEGDNN_MARK_USED_VAR(var)
+#define MEGDNN_LOCK_GUARD_SHARED(var) MEGDNN_MARK_USED_VAR(var)
 #else
 #define DNN_MUTEX                std::mutex
 #define DNN_TOKENPASTE(x, y)     x##y
 #define DNN_TOKENPASTE2(x, y)    DNN_TOKENPASTE(x, y)
 #define DNN_LOCK_GUARD_CTOR(mtx) DNN_TOKENPASTE2(__lock_guard_, __LINE__)(mtx)
 #define MEGDNN_LOCK_GUARD(mtx)   std::lock_guard<decltype(mtx)> DNN_LOCK_GUARD_CTOR(mtx)
+#define MEGDNN_LOCK_GUARD_SHARED(mtx) \
+    std::shared_lock<decltype(mtx)> DNN_LOCK_GUARD_CTOR(mtx)
 #endif
 
 namespace megdnn {
@@ -0,0 +1,110 @@
+/**
+ * \file dnn/src/cuda/attention/attention.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/attention/attention.cuh"
+
+#include "megdnn/dtype.h"
+#include "src/cuda/cub/block/block_reduce.cuh"
+#include "src/cuda/utils.cuh"
+
+namespace {
+
+using namespace megdnn;
+using namespace cuda;
+
+constexpr uint32_t NR_THREADS_PER_QUERY = 128;
+
+template <typename T>
+__global__ void attention_kernel(
+        const T* q, const T* k, const T* v, const T* mask, T* dst, uint32_t Lq,
+        uint32_t Lk, uint32_t D, uint32_t Dv, size_t mask_stride, float scale,
+        bool causal) {
+    using BlockReduce = cub::BlockReduce<float, NR_THREADS_PER_QUERY>;
+    __shared__ typename BlockReduce::TempStorage temp_storage;
+    __shared__ float score;
+    //! the output of the query, where each thread only touches its own elements
+    extern __shared__ float acc[];
+
+    uint32_t b = blockIdx.x / Lq, i = blockIdx.x % Lq;
+    q += (static_cast<size_t>(b) * Lq + i) * D;
+    k += static_cast<size_t>(b) * Lk * D;
+    v += static_cast<size_t>(b) * Lk * Dv;
+    dst += (static_cast<size_t>(b) * Lq + i) * Dv;
+    if (mask) {
+        mask += b * mask_stride + static_cast<size_t>(i) * Lk;
+    }
+
+    for (uint32_t d = threadIdx.x; d < Dv; d += NR_THREADS_PER_QUERY) {
+        acc[d] = 0.f;
+    }
+    float max = -INFINITY, sum = 0.f;
+    uint32_t nr_key = causal ? i + Lk - Lq + 1 : Lk;
+    for (uint32_t j = 0; j < nr_key; ++j) {
+        float partial = 0.f;
+        for (uint32_t d = threadIdx.x; d < D; d += NR_THREADS_PER_QUERY) {
+            partial += static_cast<float>(q[d]) * static_cast<float>(k[j * D + d]);
+        }
+        partial = BlockReduce(temp_storage).Sum(partial);
+        if (threadIdx.x == 0) {
+            score = partial * scale + (mask ? static_cast<float>(mask[j]) : 0.f);
+        }
+        __syncthreads();
+        float s = score, new_max = fmaxf(max, s);
+        float alpha = __expf(max - new_max), p = __expf(s - new_max);
+        sum = sum * alpha + p;
+        max = new_max;
+        for (uint32_t d = threadIdx.x; d < Dv; d += NR_THREADS_PER_QUERY) {
+            acc[d] = acc[d] * alpha + p * static_cast<float>(v[j * Dv + d]);
+        }
+        //! score and temp_storage are reused by the next key
+        __syncthreads();
+    }
+    for (uint32_t d = threadIdx.x; d < Dv; d += NR_THREADS_PER_QUERY) {
+        dst[d] = static_cast<T>(acc[d] / sum);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace attention {
+
+template <typename T>
+void forward_proxy(
+        const T* q, const T* k, const T* v, const T* mask, T* dst, size_t batch,
+        size_t Lq, size_t Lk, size_t D, size_t Dv, size_t mask_stride, float scale,
+        bool causal, cudaStream_t stream) {
+    megdnn_assert(
+            batch * Lq <= static_cast<size_t>(INT32_MAX) && Lk * D <= UINT32_MAX &&
+                    Lk * Dv <= UINT32_MAX && Dv * sizeof(float) <= 48 * 1024,
+            "attention on too large tensor: batch=%zu Lq=%zu Lk=%zu D=%zu Dv=%zu",
+            batch, Lq, Lk, D, Dv);
+    size_t smem = Dv * sizeof(float);
+    attention_kernel<T><<<batch * Lq, NR_THREADS_PER_QUERY, smem, stream>>>(
+            q, k, v, mask, dst, Lq, Lk, D, Dv, mask_stride, scale, causal);
+    after_kernel_launch();
+}
+
+#define INST(T)                                                                 \
+    template void forward_proxy<T>(                                             \
+            const T*, const T*, const T*, const T*, T*, size_t, size_t, size_t, \
+            size_t, size_t, size_t, float, bool, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace attention
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
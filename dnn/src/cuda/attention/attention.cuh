@@ -0,0 +1,38 @@
+/**
+ * \file dnn/src/cuda/attention/attention.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <cuda_runtime_api.h>
+#include <stddef.h>
+
+namespace megdnn {
+namespace cuda {
+namespace attention {
+
+/*!
+ * \brief compute the attention of batch * Lq queries
+ *
+ * Each query is handled by a block, which computes the scores one key at a
+ * time and accumulates the output by online softmax in shared memory, so the
+ * scores are never stored. mask is null if absent, and mask_stride is 0 if
+ * the mask is shared by the batches.
+ */
+template <typename T>
+void forward_proxy(
+        const T* q, const T* k, const T* v, const T* mask, T* dst, size_t batch,
+        size_t Lq, size_t Lk, size_t D, size_t Dv, size_t mask_stride, float scale,
+        bool causal, cudaStream_t stream);
+
+}  // namespace attention
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,50 @@
+/**
+ * \file dnn/src/cuda/attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/attention/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/cuda/attention/attention.cuh"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+void AttentionForwardImpl::exec(
+        _megdnn_tensor_in q, _megdnn_tensor_in k, _megdnn_tensor_in v,
+        _megdnn_tensor_in mask, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(q.layout, k.layout, v.layout, mask.layout, dst.layout, workspace.size);
+    if (dst.layout.is_empty()) {
+        return;
+    }
+    size_t batch, Lq, Lk, D, Dv;
+    get_matrix_shape(q.layout, k.layout, v.layout, batch, Lq, Lk, D, Dv);
+    size_t mask_stride = mask.layout.ndim == 2 ? 0 : Lq * Lk;
+    auto stream = cuda_stream(handle());
+#define cb(DType)                                                                 \
+    if (q.layout.dtype == DType()) {                                              \
+        using ctype = typename DTypeTrait<DType>::ctype;                          \
+        attention::forward_proxy<ctype>(                                          \
+                q.ptr<ctype>(), k.ptr<ctype>(), v.ptr<ctype>(),                   \
+                mask.layout.ndim ? mask.ptr<ctype>() : nullptr, dst.ptr<ctype>(), \
+                batch, Lq, Lk, D, Dv, mask_stride, param().scale, param().causal, \
+                stream);                                                          \
+        return;                                                                   \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_throw(ssprintf("unsupported attention dtype: %s", q.layout.dtype.name()));
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
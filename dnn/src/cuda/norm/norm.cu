@@ -0,0 +1,115 @@
+/**
+ * \file dnn/src/cuda/norm/norm.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/norm/norm.cuh"
+
+#include "megdnn/dtype.h"
+#include "src/cuda/cub/block/block_reduce.cuh"
+#include "src/cuda/utils.cuh"
+
+namespace {
+
+using namespace megdnn;
+using namespace cuda;
+
+constexpr uint32_t NR_THREADS_PER_ROW = 256;
+
+//! statistics of n elements, where m2 is the sum of squared deviations
+struct Stats {
+    float n, mean, m2;
+};
+
+struct StatsMergeOp {
+    __device__ Stats operator()(const Stats& lhs, const Stats& rhs) const {
+        float n = lhs.n + rhs.n;
+        if (n == 0.f) {
+            return lhs;
+        }
+        float delta = rhs.mean - lhs.mean, ratio = rhs.n / n;
+        return {n, lhs.mean + delta * ratio,
+                lhs.m2 + rhs.m2 + delta * delta * lhs.n * ratio};
+    }
+};
+
+template <typename T>
+__global__ void norm_kernel(
+        const T* src, const T* weight, const T* bias, T* dst, uint32_t group,
+        uint32_t channel_per_group, uint32_t HW, float eps) {
+    using BlockReduce = cub::BlockReduce<Stats, NR_THREADS_PER_ROW>;
+    __shared__ typename BlockReduce::TempStorage temp_storage;
+    __shared__ Stats row_stat;
+
+    uint32_t row_size = channel_per_group * HW;
+    size_t offset = static_cast<size_t>(blockIdx.x) * row_size;
+    src += offset;
+    dst += offset;
+
+    Stats stat{0.f, 0.f, 0.f};
+    for (uint32_t i = threadIdx.x; i < row_size; i += NR_THREADS_PER_ROW) {
+        float x = static_cast<float>(src[i]);
+        stat.n += 1.f;
+        float delta = x - stat.mean;
+        stat.mean += delta / stat.n;
+        stat.m2 += delta * (x - stat.mean);
+    }
+    stat = BlockReduce(temp_storage).Reduce(stat, StatsMergeOp());
+    if (threadIdx.x == 0) {
+        row_stat = stat;
+    }
+    __syncthreads();
+
+    float mean = row_stat.mean, rstd = rsqrtf(row_stat.m2 / row_stat.n + eps);
+    uint32_t c0 = blockIdx.x % group * channel_per_group;
+    for (uint32_t i = threadIdx.x; i < row_size; i += NR_THREADS_PER_ROW) {
+        float val = (static_cast<float>(src[i]) - mean) * rstd;
+        if (weight) {
+            uint32_t c = c0 + i / HW;
+            val = val * static_cast<float>(weight[c]) + static_cast<float>(bias[c]);
+        }
+        dst[i] = static_cast<T>(val);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace norm {
+
+template <typename T>
+void forward_proxy(
+        const T* src, const T* weight, const T* bias, T* dst, size_t nr_row,
+        size_t group, size_t channel_per_group, size_t HW, float eps,
+        cudaStream_t stream) {
+    megdnn_assert(
+            nr_row <= static_cast<size_t>(INT32_MAX) &&
+                    channel_per_group * HW <= UINT32_MAX,
+            "norm on too large tensor: nr_row=%zu row_size=%zu", nr_row,
+            channel_per_group * HW);
+    norm_kernel<T><<<nr_row, NR_THREADS_PER_ROW, 0, stream>>>(
+            src, weight, bias, dst, group, channel_per_group, HW, eps);
+    after_kernel_launch();
+}
+
+#define INST(T)                                                               \
+    template void forward_proxy<T>(                                           \
+            const T*, const T*, const T*, T*, size_t, size_t, size_t, size_t, \
+            float, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace norm
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,39 @@
+/**
+ * \file dnn/src/cuda/norm/norm.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <cuda_runtime_api.h>
+#include <stddef.h>
+
+namespace megdnn {
+namespace cuda {
+namespace norm {
+
+/*!
+ * \brief normalize nr_row rows, where each row consists of channel_per_group
+ * channels of HW elements and belongs to group row % group
+ *
+ * Layer norm is the case of group == 1 and HW == 1. Each row is handled by a
+ * block, which computes the statistics by Welford's algorithm in one pass and
+ * writes the output in another one. weight and bias are indexed by the
+ * channel and are null if not affine.
+ */
+template <typename T>
+void forward_proxy(
+        const T* src, const T* weight, const T* bias, T* dst, size_t nr_row,
+        size_t group, size_t channel_per_group, size_t HW, float eps,
+        cudaStream_t stream);
+
+}  // namespace norm
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,72 @@
+/**
+ * \file dnn/src/cuda/norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/norm/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/cuda/norm/norm.cuh"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+namespace {
+void dispatch(
+        const TensorND& data, const TensorND& weight, const TensorND& bias,
+        const TensorND& dst, bool affine, size_t nr_row, size_t group,
+        size_t channel_per_group, size_t HW, float eps, cudaStream_t stream) {
+#define cb(DType)                                                               \
+    if (data.layout.dtype == DType()) {                                         \
+        using ctype = typename DTypeTrait<DType>::ctype;                        \
+        norm::forward_proxy<ctype>(                                             \
+                data.ptr<ctype>(), affine ? weight.ptr<ctype>() : nullptr,      \
+                affine ? bias.ptr<ctype>() : nullptr, dst.ptr<ctype>(), nr_row, \
+                group, channel_per_group, HW, eps, stream);                     \
+        return;                                                                 \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_throw(ssprintf("unsupported norm dtype: %s", data.layout.dtype.name()));
+}
+}  // anonymous namespace
+
+void LayerNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(data.layout, weight.layout, bias.layout, dst.layout, workspace.size);
+    if (data.layout.is_empty()) {
+        return;
+    }
+    size_t nr_row, row_size;
+    get_row_size(data.layout, nr_row, row_size);
+    dispatch(
+            data, weight, bias, dst, param().affine, nr_row, 1, row_size, 1,
+            param().eps, cuda_stream(handle()));
+}
+
+void GroupNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(data.layout, weight.layout, bias.layout, dst.layout, workspace.size);
+    if (data.layout.is_empty()) {
+        return;
+    }
+    size_t N = data.layout[0], C = data.layout[1];
+    size_t HW = data.layout.total_nr_elems() / (N * C), group = param().group;
+    dispatch(
+            data, weight, bias, dst, param().affine, N * group, group, C / group, HW,
+            param().eps, cuda_stream(handle()));
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
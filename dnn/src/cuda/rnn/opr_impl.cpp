@@ -0,0 +1,206 @@
+/**
+ * \file dnn/src/cuda/rnn/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/rnn/opr_impl.h"
+
+#include "src/cuda/rnn/rnn.cuh"
+#include "src/cuda/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+namespace {
+
+/*!
+ * The input projections of all the time steps of a direction are computed by
+ * one matmul, then a kernel is launched for each step to compute the hidden
+ * projection and the gates; the hidden and cell states are kept in float.
+ */
+class RNNExecutor {
+    Handle* m_handle;
+    const RNNBase::Param m_param;
+    DType m_dtype;
+    size_t T, N, I, H, L, D, G;
+
+    std::unique_ptr<MatrixMulForward> make_matmul() const {
+        auto opr = m_handle->create_operator<MatrixMulForward>();
+        opr->param().transposeB = true;
+        return opr;
+    }
+
+    TensorLayout layout(size_t M, size_t K) const { return {{M, K}, m_dtype}; }
+
+public:
+    RNNExecutor(
+            Handle* handle, const RNNBase::Param& param, size_t nr_gate,
+            const TensorLayout& input, const TensorLayout& hx)
+            : m_handle{handle},
+              m_param{param},
+              m_dtype{input.dtype},
+              T{input[0]},
+              N{input[1]},
+              I{input[2]},
+              H{hx[2]},
+              L{param.num_layers},
+              D{param.bidirectional ? size_t(2) : size_t(1)},
+              G{nr_gate} {}
+
+    //! the input projection, two hidden state buffers, the cell state, the
+    //! outputs of the hidden layers and the matmul workspace
+    WorkspaceBundle get_bundle(void* ptr = nullptr) const {
+        auto opr = make_matmul();
+        size_t matmul_ws = 0;
+        for (size_t K : {I, D * H}) {
+            matmul_ws = std::max(
+                    matmul_ws, opr->get_workspace_in_bytes(
+                                       layout(T * N, K), layout(G * H, K),
+                                       layout(T * N, G * H)));
+        }
+        size_t layer_out = T * N * D * H * m_dtype.size();
+        return {ptr,
+                {T * N * G * H * m_dtype.size(), 2 * N * H * sizeof(float),
+                 N * H * sizeof(float), L > 1 ? layer_out : 0, L > 2 ? layer_out : 0,
+                 matmul_ws}};
+    }
+
+    //! cx and cy are null for GRU
+    template <typename ctype>
+    void exec(
+            const ctype* input, const int* seq_len, const ctype* hx, const ctype* cx,
+            const ctype* weights, ctype* output, ctype* hy, ctype* cy,
+            void* workspace) const;
+};
+
+template <typename ctype>
+void RNNExecutor::exec(
+        const ctype* input, const int* seq_len, const ctype* hx, const ctype* cx,
+        const ctype* weights, ctype* output, ctype* hy, ctype* cy,
+        void* workspace) const {
+    auto stream = cuda_stream(m_handle);
+    auto bundle = get_bundle(workspace);
+    ctype* gx = static_cast<ctype*>(bundle.get(0));
+    float* hbuf = static_cast<float*>(bundle.get(1));
+    float* c = cx ? static_cast<float*>(bundle.get(2)) : nullptr;
+    ctype* layer_bufs[2] = {
+            static_cast<ctype*>(bundle.get(3)), static_cast<ctype*>(bundle.get(4))};
+    auto matmul = make_matmul();
+    size_t nr_weight;
+    auto offsets = RNNBase::get_weight_offsets(m_param, G, I, H, nr_weight);
+    const ctype* src = input;
+    for (size_t layer = 0; layer < L; ++layer) {
+        size_t K = layer ? D * H : I;
+        ctype* dst = layer + 1 == L ? output : layer_bufs[layer % 2];
+        for (size_t d = 0; d < D; ++d) {
+            auto&& off = offsets[layer * D + d];
+            size_t state = (layer * D + d) * N * H;
+            matmul->exec(
+                    {const_cast<ctype*>(src), layout(T * N, K)},
+                    {const_cast<ctype*>(weights + off.w_ih), layout(G * H, K)},
+                    {gx, layout(T * N, G * H)}, bundle.get_workspace(5));
+            rnn::load_state_proxy(hx + state, hbuf, N * H, stream);
+            if (cx) {
+                rnn::load_state_proxy(cx + state, c, N * H, stream);
+            }
+            const ctype* b_ih = m_param.bias ? weights + off.b_ih : nullptr;
+            const ctype* b_hh = m_param.bias ? weights + off.b_hh : nullptr;
+            for (size_t step = 0; step < T; ++step) {
+                size_t t = d ? T - 1 - step : step;
+                rnn::step_proxy(
+                        gx + t * N * G * H, weights + off.w_hh, b_ih, b_hh,
+                        hbuf + step % 2 * N * H, hbuf + (step + 1) % 2 * N * H, c,
+                        dst + t * N * D * H + d * H, seq_len, t, N, H, G, D * H,
+                        stream);
+            }
+            rnn::store_state_proxy(hbuf + T % 2 * N * H, hy + state, N * H, stream);
+            if (cy) {
+                rnn::store_state_proxy(c, cy + state, N * H, stream);
+            }
+        }
+        src = dst;
+    }
+}
+
+}  // anonymous namespace
+
+void LSTMForwardImpl::exec(
+        _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+        _megdnn_tensor_in cx, _megdnn_tensor_in flatten_weights,
+        _megdnn_tensor_out output, _megdnn_tensor_out hy, _megdnn_tensor_out cy,
+        _megdnn_workspace workspace) {
+    check_exec(
+            input.layout, seq_len.layout, hx.layout, cx.layout, flatten_weights.layout,
+            output.layout, hy.layout, cy.layout, workspace.size);
+    if (output.layout.is_empty()) {
+        return;
+    }
+    RNNExecutor executor{handle(), param(), NR_GATE, input.layout, hx.layout};
+    const int* len = seq_len.layout.ndim ? seq_len.ptr<dt_int32>() : nullptr;
+#define cb(DType)                                                                   \
+    if (input.layout.dtype == DType()) {                                            \
+        using ctype = typename DTypeTrait<DType>::ctype;                            \
+        executor.exec<ctype>(                                                       \
+                input.ptr<ctype>(), len, hx.ptr<ctype>(), cx.ptr<ctype>(),          \
+                flatten_weights.ptr<ctype>(), output.ptr<ctype>(), hy.ptr<ctype>(), \
+                cy.ptr<ctype>(), workspace.raw_ptr);                                \
+        return;                                                                     \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_throw(ssprintf("unsupported lstm dtype: %s", input.layout.dtype.name()));
+}
+
+size_t LSTMForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& input, const TensorLayout&, const TensorLayout& hx,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&) {
+    return RNNExecutor{handle(), param(), NR_GATE, input, hx}
+            .get_bundle()
+            .total_size_in_bytes();
+}
+
+void GRUForwardImpl::exec(
+        _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+        _megdnn_tensor_in flatten_weights, _megdnn_tensor_out output,
+        _megdnn_tensor_out hy, _megdnn_workspace workspace) {
+    check_exec(
+            input.layout, seq_len.layout, hx.layout, flatten_weights.layout,
+            output.layout, hy.layout, workspace.size);
+    if (output.layout.is_empty()) {
+        return;
+    }
+    RNNExecutor executor{handle(), param(), NR_GATE, input.layout, hx.layout};
+    const int* len = seq_len.layout.ndim ? seq_len.ptr<dt_int32>() : nullptr;
+#define cb(DType)                                                                   \
+    if (input.layout.dtype == DType()) {                                            \
+        using ctype = typename DTypeTrait<DType>::ctype;                            \
+        executor.exec<ctype>(                                                       \
+                input.ptr<ctype>(), len, hx.ptr<ctype>(), nullptr,                  \
+                flatten_weights.ptr<ctype>(), output.ptr<ctype>(), hy.ptr<ctype>(), \
+                nullptr, workspace.raw_ptr);                                        \
+        return;                                                                     \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+    megdnn_throw(ssprintf("unsupported gru dtype: %s", input.layout.dtype.name()));
+}
+
+size_t GRUForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& input, const TensorLayout&, const TensorLayout& hx,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&) {
+    return RNNExecutor{handle(), param(), NR_GATE, input, hx}
+            .get_bundle()
+            .total_size_in_bytes();
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,50 @@
+/**
+ * \file dnn/src/cuda/rnn/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "megdnn/oprs.h"
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+class LSTMForwardImpl final : public LSTMForward {
+public:
+    using LSTMForward::LSTMForward;
+    void exec(
+            _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+            _megdnn_tensor_in cx, _megdnn_tensor_in flatten_weights,
+            _megdnn_tensor_out output, _megdnn_tensor_out hy, _megdnn_tensor_out cy,
+            _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& cx,
+            const TensorLayout& flatten_weights, const TensorLayout& output,
+            const TensorLayout& hy, const TensorLayout& cy) override;
+};
+
+class GRUForwardImpl final : public GRUForward {
+public:
+    using GRUForward::GRUForward;
+    void exec(
+            _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+            _megdnn_tensor_in flatten_weights, _megdnn_tensor_out output,
+            _megdnn_tensor_out hy, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& flatten_weights,
+            const TensorLayout& output, const TensorLayout& hy) override;
+};
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,146 @@
+/**
+ * \file dnn/src/cuda/rnn/rnn.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/rnn/rnn.cuh"
+
+#include "megdnn/dtype.h"
+#include "src/cuda/cuda_shfl_compat.cuh"
+#include "src/cuda/utils.cuh"
+
+namespace {
+
+using namespace megdnn;
+using namespace cuda;
+
+constexpr uint32_t WARP_SIZE = 32;
+constexpr uint32_t NR_WARPS_PER_BLOCK = 8;
+constexpr uint32_t MAX_GATE = 4;
+
+__device__ __forceinline__ float sigmoid(float x) {
+    return 1.f / (1.f + __expf(-x));
+}
+
+template <typename T>
+__global__ void step_kernel(
+        const T* gx, const T* w_hh, const T* b_ih, const T* b_hh, const float* h_prev,
+        float* h, float* c, T* out, const int* seq_len, uint32_t t, uint32_t N,
+        uint32_t H, uint32_t G, uint32_t out_stride) {
+    uint32_t lane = threadIdx.x % WARP_SIZE;
+    uint32_t unit = blockIdx.x * NR_WARPS_PER_BLOCK + threadIdx.x / WARP_SIZE;
+    if (unit >= N * H) {
+        return;
+    }
+    uint32_t n = unit / H, j = unit % H;
+    out += static_cast<size_t>(n) * out_stride + j;
+    if (seq_len && t >= static_cast<uint32_t>(seq_len[n])) {
+        if (lane == 0) {
+            h[unit] = h_prev[unit];
+            *out = T(0.f);
+        }
+        return;
+    }
+    h_prev += static_cast<size_t>(n) * H;
+    float acc[MAX_GATE] = {0.f, 0.f, 0.f, 0.f};
+    for (uint32_t k = lane; k < H; k += WARP_SIZE) {
+        float x = h_prev[k];
+        for (uint32_t g = 0; g < G; ++g) {
+            size_t row = static_cast<size_t>(g) * H + j;
+            acc[g] += x * static_cast<float>(w_hh[row * H + k]);
+        }
+    }
+    for (uint32_t g = 0; g < G; ++g) {
+        for (uint32_t offset = WARP_SIZE / 2; offset; offset /= 2) {
+            acc[g] += __shfl_down(acc[g], offset, WARP_SIZE);
+        }
+    }
+    if (lane) {
+        return;
+    }
+    float x[MAX_GATE];
+    gx += static_cast<size_t>(n) * G * H + j;
+    for (uint32_t g = 0; g < G; ++g) {
+        x[g] = static_cast<float>(gx[g * H]);
+        if (b_ih) {
+            x[g] += static_cast<float>(b_ih[g * H + j]);
+            acc[g] += static_cast<float>(b_hh[g * H + j]);
+        }
+    }
+    float hn;
+    if (c) {
+        float i = sigmoid(x[0] + acc[0]), f = sigmoid(x[1] + acc[1]),
+              gg = tanhf(x[2] + acc[2]), o = sigmoid(x[3] + acc[3]);
+        float cn = f * c[unit] + i * gg;
+        c[unit] = cn;
+        hn = o * tanhf(cn);
+    } else {
+        float r = sigmoid(x[0] + acc[0]), z = sigmoid(x[1] + acc[1]),
+              ng = tanhf(x[2] + r * acc[2]);
+        hn = (1.f - z) * ng + z * h_prev[j];
+    }
+    h[unit] = hn;
+    *out = static_cast<T>(hn);
+}
+
+template <typename T, typename U>
+__global__ void convert_kernel(const T* src, U* dst, uint32_t size) {
+    uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < size) {
+        dst[i] = static_cast<U>(static_cast<float>(src[i]));
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace rnn {
+
+template <typename T>
+void step_proxy(
+        const T* gx, const T* w_hh, const T* b_ih, const T* b_hh, const float* h_prev,
+        float* h, float* c, T* out, const int* seq_len, size_t t, size_t N, size_t H,
+        size_t G, size_t out_stride, cudaStream_t stream) {
+    uint32_t nr_blocks = DIVUP(N * H, NR_WARPS_PER_BLOCK);
+    step_kernel<T><<<nr_blocks, NR_WARPS_PER_BLOCK * WARP_SIZE, 0, stream>>>(
+            gx, w_hh, b_ih, b_hh, h_prev, h, c, out, seq_len, t, N, H, G, out_stride);
+    after_kernel_launch();
+}
+
+template <typename T>
+void load_state_proxy(const T* src, float* dst, size_t size, cudaStream_t stream) {
+    convert_kernel<T, float><<<DIVUP(size, NR_THREADS), NR_THREADS, 0, stream>>>(
+            src, dst, size);
+    after_kernel_launch();
+}
+
+template <typename T>
+void store_state_proxy(const float* src, T* dst, size_t size, cudaStream_t stream) {
+    convert_kernel<float, T><<<DIVUP(size, NR_THREADS), NR_THREADS, 0, stream>>>(
+            src, dst, size);
+    after_kernel_launch();
+}
+
+#define INST(T)                                                                       \
+    template void step_proxy<T>(                                                      \
+            const T*, const T*, const T*, const T*, const float*, float*, float*, T*, \
+            const int*, size_t, size_t, size_t, size_t, size_t, cudaStream_t);        \
+    template void load_state_proxy<T>(const T*, float*, size_t, cudaStream_t);        \
+    template void store_state_proxy<T>(const float*, T*, size_t, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace rnn
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,44 @@
+/**
+ * \file dnn/src/cuda/rnn/rnn.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <cuda_runtime_api.h>
+#include <stddef.h>
+
+namespace megdnn {
+namespace cuda {
+namespace rnn {
+
+/*!
+ * \brief one time step of a direction of a layer
+ *
+ * Each hidden unit of a row is handled by a warp, which computes the hidden
+ * projections of all the gates of the unit and applies the gates. gx is the
+ * input projection of the step without bias, the hidden and cell states are
+ * kept in float, and c is null for GRU. The biases are null if absent.
+ */
+template <typename T>
+void step_proxy(
+        const T* gx, const T* w_hh, const T* b_ih, const T* b_hh, const float* h_prev,
+        float* h, float* c, T* out, const int* seq_len, size_t t, size_t N, size_t H,
+        size_t G, size_t out_stride, cudaStream_t stream);
+
+//! convert between the states of the tensors and the float states
+template <typename T>
+void load_state_proxy(const T* src, float* dst, size_t size, cudaStream_t stream);
+template <typename T>
+void store_state_proxy(const float* src, T* dst, size_t size, cudaStream_t stream);
+
+}  // namespace rnn
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,97 @@
+/**
+ * \file dnn/src/cuda/softmax/softmax.cu
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/cuda/softmax/softmax.cuh"
+
+#include "megdnn/dtype.h"
+#include "src/cuda/cub/block/block_reduce.cuh"
+#include "src/cuda/utils.cuh"
+
+#include <cfloat>
+
+namespace {
+
+using namespace megdnn;
+using namespace cuda;
+
+constexpr uint32_t NR_THREADS_PER_ROW = 128;
+
+//! running max and sum of exp(x - max) of a part of a row
+struct MaxSum {
+    float max, sum;
+};
+
+struct MaxSumOp {
+    __device__ MaxSum operator()(const MaxSum& lhs, const MaxSum& rhs) const {
+        float max = fmaxf(lhs.max, rhs.max);
+        return {max, lhs.sum * expf(lhs.max - max) + rhs.sum * expf(rhs.max - max)};
+    }
+};
+
+template <typename T>
+__global__ void softmax_kernel(const T* src, T* dst, uint32_t B, uint32_t C) {
+    using BlockReduce = cub::BlockReduce<MaxSum, NR_THREADS_PER_ROW>;
+    __shared__ typename BlockReduce::TempStorage temp_storage;
+    __shared__ MaxSum row_stat;
+
+    uint32_t a = blockIdx.x / C, c = blockIdx.x % C;
+    size_t offset = static_cast<size_t>(a) * B * C + c;
+    src += offset;
+    dst += offset;
+
+    MaxSum stat{-FLT_MAX, 0.f};
+    for (uint32_t b = threadIdx.x; b < B; b += NR_THREADS_PER_ROW) {
+        float x = static_cast<float>(src[b * C]);
+        float max = fmaxf(stat.max, x);
+        stat.sum = stat.sum * expf(stat.max - max) + expf(x - max);
+        stat.max = max;
+    }
+    stat = BlockReduce(temp_storage).Reduce(stat, MaxSumOp());
+    if (threadIdx.x == 0) {
+        row_stat = stat;
+    }
+    __syncthreads();
+
+    float max = row_stat.max, scale = 1.f / row_stat.sum;
+    for (uint32_t b = threadIdx.x; b < B; b += NR_THREADS_PER_ROW) {
+        dst[b * C] = static_cast<T>(expf(static_cast<float>(src[b * C]) - max) * scale);
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace cuda {
+namespace softmax {
+
+template <typename T>
+void forward_proxy(
+        const T* src, T* dst, size_t A, size_t B, size_t C, cudaStream_t stream) {
+    size_t nr_rows = A * C;
+    megdnn_assert(
+            nr_rows <= static_cast<size_t>(INT32_MAX) && B * C <= UINT32_MAX,
+            "softmax on too large tensor: A=%zu B=%zu C=%zu", A, B, C);
+    softmax_kernel<T><<<nr_rows, NR_THREADS_PER_ROW, 0, stream>>>(src, dst, B, C);
+    after_kernel_launch();
+}
+
+#define INST(T) \
+    template void forward_proxy<T>(const T*, T*, size_t, size_t, size_t, cudaStream_t);
+#define cb(DType) INST(typename DTypeTrait<DType>::ctype)
+MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+#undef INST
+
+}  // namespace softmax
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,34 @@
+/**
+ * \file dnn/src/cuda/softmax/softmax.cuh
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include <cuda_runtime_api.h>
+#include <stddef.h>
+
+namespace megdnn {
+namespace cuda {
+namespace softmax {
+
+/*!
+ * \brief softmax of src of shape (A, B, C) along B
+ *
+ * each row is handled by a block, which computes the max and the sum of exp in
+ * one pass and writes the output in another one
+ */
+template <typename T>
+void forward_proxy(
+        const T* src, T* dst, size_t A, size_t B, size_t C, cudaStream_t stream);
+
+}  // namespace softmax
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,100 @@
+/**
+ * \file dnn/src/fallback/argsort/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/argsort/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_argsort)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+bool use_sort_kern(const TensorLayout& src) {
+    return (src.dtype == dtype::Float32() || src.dtype == dtype::Int32()) &&
+           !src.is_empty();
+}
+}  // anonymous namespace
+
+size_t ArgsortForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& dst,
+        const TensorLayout& indices) {
+    if (!use_sort_kern(src)) {
+        return naive::ArgsortForwardImpl::get_workspace_in_bytes(src, dst, indices);
+    }
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    return sort::TaskSplit(src[0], src[1], nr_threads).get_workspace_in_bytes();
+}
+
+template <typename ctype>
+void ArgsortForwardImpl::exec_internal(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_tensor_out indices,
+        _megdnn_workspace workspace) {
+    size_t M = src.layout[0], N = src.layout[1];
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    sort::TaskSplit split(M, N, nr_threads);
+    const ctype* sptr = src.ptr<ctype>();
+    ctype* dptr = dst.ptr<ctype>();
+    int32_t* iptr = indices.ptr<dt_int32>();
+    dt_byte* wptr = workspace.raw_ptr;
+    bool descending = param().order == Order::DESCENDING;
+    auto kern = get_kern();
+    auto run = [=](size_t index, size_t) {
+        dt_byte* task_ws = wptr + index * split.task_workspace;
+        int32_t* key = reinterpret_cast<int32_t*>(task_ws);
+        void* row_ws = task_ws + split.task_workspace -
+                       sort::get_row_workspace_in_bytes(N);
+        size_t begin = index * split.nr_row_per_task;
+        size_t end = std::min(M, begin + split.nr_row_per_task);
+        for (size_t i = begin; i < end; ++i) {
+            const ctype* s = sptr + i * N;
+            ctype* d = dptr + i * N;
+            int32_t* idx = iptr + i * N;
+            sort::encode(s, N, descending, key);
+            sort::argsort_row(kern, key, N, idx, row_ws);
+            for (size_t j = 0; j < N; ++j) {
+                d[j] = s[idx[j]];
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, split.nr_task);
+}
+
+void ArgsortForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_tensor_out indices,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, indices.layout, workspace.size);
+    if (src.layout.dtype == dtype::Float32() && !src.layout.is_empty()) {
+        MIDOUT_BEGIN(megdnn_fallback_argsort, midout_iv(0)) {
+            exec_internal<dt_float32>(src, dst, indices, workspace);
+            return;
+        }
+        MIDOUT_END();
+    }
+    if (src.layout.dtype == dtype::Int32() && !src.layout.is_empty()) {
+        MIDOUT_BEGIN(megdnn_fallback_argsort, midout_iv(1)) {
+            exec_internal<dt_int32>(src, dst, indices, workspace);
+            return;
+        }
+        MIDOUT_END();
+    }
+    naive::ArgsortForwardImpl::exec(src, dst, indices, workspace);
+}
+
+// vim: syntax=cpp.doxygen
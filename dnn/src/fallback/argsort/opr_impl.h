@@ -0,0 +1,43 @@
+/**
+ * \file dnn/src/fallback/argsort/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/fallback/argsort/sort.h"
+#include "src/naive/argsort/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+class ArgsortForwardImpl : public naive::ArgsortForwardImpl {
+public:
+    using naive::ArgsortForwardImpl::ArgsortForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_tensor_out indices,
+            _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& dst,
+            const TensorLayout& indices) override;
+
+protected:
+    //! get the row kernels; arch specific impls return their simd kernels
+    virtual sort::Kern get_kern() const { return sort::get_default_kern(); }
+
+private:
+    template <typename ctype>
+    void exec_internal(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_tensor_out indices,
+            _megdnn_workspace workspace);
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
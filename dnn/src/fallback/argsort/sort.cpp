@@ -0,0 +1,228 @@
+/**
+ * \file dnn/src/fallback/argsort/sort.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/argsort/sort.h"
+#include "src/common/utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! rows shorter than this are sorted by comparison instead of radix sort
+constexpr size_t RADIX_SORT_MIN = 1024;
+//! the bounded heap is used to select the k smallest keys if
+//! k * HEAP_RATIO <= n and k <= HEAP_MAX_K
+constexpr size_t HEAP_RATIO = 8;
+constexpr size_t HEAP_MAX_K = 4096;
+//! do not split the rows into tasks smaller than this number of values
+constexpr size_t MIN_TASK_SIZE = 4096;
+
+/*!
+ * the key and the index are packed into an uint64, whose unsigned order is
+ * the lexicographical order of the pair
+ */
+inline uint64_t pack(int32_t key, size_t i) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(key) ^ 0x80000000u) << 32 |
+           static_cast<uint64_t>(i);
+}
+
+inline int32_t unpack_key(uint64_t v) {
+    return static_cast<int32_t>(static_cast<uint32_t>(v >> 32) ^ 0x80000000u);
+}
+
+inline int32_t unpack_idx(uint64_t v) {
+    return static_cast<int32_t>(static_cast<uint32_t>(v));
+}
+
+//! lsd radix sort by the keys, which keeps the order of the indices
+void radix_sort(uint64_t* data, uint64_t* tmp, size_t n) {
+    constexpr size_t BITS = 8, NR_BUCKET = 1 << BITS, NR_PASS = 32 / BITS;
+    size_t count[NR_PASS][NR_BUCKET] = {};
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t key = static_cast<uint32_t>(data[i] >> 32);
+        for (size_t p = 0; p < NR_PASS; ++p) {
+            ++count[p][key >> (p * BITS) & (NR_BUCKET - 1)];
+        }
+    }
+    uint64_t* src = data;
+    uint64_t* dst = tmp;
+    for (size_t p = 0; p < NR_PASS; ++p) {
+        size_t shift = 32 + p * BITS;
+        auto&& cnt = count[p];
+        //! skip the pass if all the keys share the digit
+        if (cnt[src[0] >> shift & (NR_BUCKET - 1)] == n) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t b = 0; b < NR_BUCKET; ++b) {
+            size_t c = cnt[b];
+            cnt[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            dst[cnt[src[i] >> shift & (NR_BUCKET - 1)]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != data) {
+        std::copy(src, src + n, data);
+    }
+}
+
+void sort_packed(uint64_t* data, size_t n) {
+    if (n < RADIX_SORT_MIN) {
+        std::sort(data, data + n);
+    } else {
+        radix_sort(data, data + n, n);
+    }
+}
+
+void insertion_sort(int32_t* key, int32_t* idx, size_t n) {
+    for (size_t i = 1; i < n; ++i) {
+        int32_t k = key[i], v = idx[i];
+        size_t j = i;
+        for (; j && (key[j - 1] > k || (key[j - 1] == k && idx[j - 1] > v)); --j) {
+            key[j] = key[j - 1];
+            idx[j] = idx[j - 1];
+        }
+        key[j] = k;
+        idx[j] = v;
+    }
+}
+
+size_t find_less(const int32_t* key, size_t begin, size_t n, int32_t thresh) {
+    for (size_t i = begin; i < n; ++i) {
+        if (key[i] < thresh) {
+            return i;
+        }
+    }
+    return n;
+}
+
+}  // anonymous namespace
+
+sort::Kern sort::get_default_kern() {
+    return {insertion_sort, 16, find_less};
+}
+
+namespace megdnn {
+namespace fallback {
+namespace sort {
+
+//! flip the bits other than the sign of negative floats, so that the signed
+//! order of the bits is the order of the floats
+template <>
+void encode<dt_float32>(
+        const dt_float32* src, size_t n, bool descending, int32_t* key) {
+    int32_t flip = descending ? -1 : 0;
+    for (size_t i = 0; i < n; ++i) {
+        int32_t bits;
+        memcpy(&bits, src + i, sizeof(bits));
+        key[i] = (bits ^ ((bits >> 31) & 0x7fffffff)) ^ flip;
+    }
+}
+
+template <>
+void encode<dt_int32>(const dt_int32* src, size_t n, bool descending, int32_t* key) {
+    int32_t flip = descending ? -1 : 0;
+    for (size_t i = 0; i < n; ++i) {
+        key[i] = src[i] ^ flip;
+    }
+}
+
+}  // namespace sort
+}  // namespace fallback
+}  // namespace megdnn
+
+size_t sort::get_row_workspace_in_bytes(size_t n) {
+    return 2 * n * sizeof(uint64_t);
+}
+
+sort::TaskSplit::TaskSplit(size_t m, size_t n, size_t nr_threads) {
+    nr_task = std::min(m, std::max<size_t>(1, m * n / MIN_TASK_SIZE));
+    nr_task = std::max<size_t>(1, std::min(nr_task, nr_threads));
+    nr_row_per_task = div_ceil(m, nr_task);
+    nr_task = div_ceil(m, nr_row_per_task);
+    task_workspace = get_aligned_power2<size_t>(n * sizeof(int32_t), 64) +
+                     get_row_workspace_in_bytes(n);
+}
+
+void sort::argsort_row(
+        const Kern& kern, int32_t* key, size_t n, int32_t* idx, void* workspace) {
+    if (n <= kern.small_sort_max) {
+        for (size_t i = 0; i < n; ++i) {
+            idx[i] = i;
+        }
+        kern.small_sort(key, idx, n);
+        return;
+    }
+    uint64_t* data = static_cast<uint64_t*>(workspace);
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = pack(key[i], i);
+    }
+    sort_packed(data, n);
+    for (size_t i = 0; i < n; ++i) {
+        idx[i] = unpack_idx(data[i]);
+    }
+}
+
+int32_t sort::topk_row(
+        const Kern& kern, const int32_t* key, size_t n, size_t k, bool sorted,
+        int32_t* idx, void* workspace) {
+    uint64_t* data = static_cast<uint64_t*>(workspace);
+    int32_t kth;
+    if (k * HEAP_RATIO <= n && k <= HEAP_MAX_K) {
+        //! a max heap of the k smallest pairs seen so far; a key replaces the
+        //! top only if it is strictly less than the key of the top, as its
+        //! index is larger, so most keys are skipped by find_less
+        for (size_t i = 0; i < k; ++i) {
+            data[i] = pack(key[i], i);
+        }
+        std::make_heap(data, data + k);
+        int32_t thresh = unpack_key(data[0]);
+        for (size_t i = kern.find_less(key, k, n, thresh); i < n;
+             i = kern.find_less(key, i + 1, n, thresh)) {
+            std::pop_heap(data, data + k);
+            data[k - 1] = pack(key[i], i);
+            std::push_heap(data, data + k);
+            thresh = unpack_key(data[0]);
+        }
+        kth = unpack_idx(data[0]);
+        if (sorted) {
+            std::sort_heap(data, data + k);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = pack(key[i], i);
+        }
+        if (sorted && k * 2 > n) {
+            sort_packed(data, n);
+        } else {
+            std::nth_element(data, data + k - 1, data + n);
+            if (sorted) {
+                std::sort(data, data + k - 1);
+            }
+        }
+        kth = unpack_idx(data[k - 1]);
+    }
+    if (idx) {
+        for (size_t i = 0; i < k; ++i) {
+            idx[i] = unpack_idx(data[i]);
+        }
+    }
+    return kth;
+}
+
+// vim: syntax=cpp.doxygen
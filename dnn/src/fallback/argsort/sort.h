@@ -0,0 +1,86 @@
+/**
+ * \file dnn/src/fallback/argsort/sort.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/dtype.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace megdnn {
+namespace fallback {
+namespace sort {
+
+/*!
+ * \brief the simd primitives used by the row sorting routines
+ *
+ * The values are mapped to int32 keys whose signed order is the order to
+ * sort by, and the pairs of (key, index) are ordered lexicographically, so
+ * that the ties are broken by the smaller index.
+ */
+struct Kern {
+    //! sort n <= small_sort_max pairs of key and index in place
+    void (*small_sort)(int32_t* key, int32_t* idx, size_t n);
+    size_t small_sort_max;
+    //! the first i in [begin, n) with key[i] < thresh, or n if there is none
+    size_t (*find_less)(const int32_t* key, size_t begin, size_t n, int32_t thresh);
+};
+
+//! insertion sort and a plain loop
+Kern get_default_kern();
+
+/*!
+ * \brief map the n values to int32 keys preserving the order, which is
+ *      reversed if descending
+ *
+ * Only float32 and int32 are supported; NaN is not ordered.
+ */
+template <typename T>
+void encode(const T* src, size_t n, bool descending, int32_t* key);
+
+//! the workspace in bytes to sort or select a row of n values
+size_t get_row_workspace_in_bytes(size_t n);
+
+/*!
+ * \brief split m rows of n values to the tasks of nr_threads threads
+ *
+ * Each task owns task_workspace bytes, holding the keys of a row followed by
+ * the workspace of the row routines.
+ */
+struct TaskSplit {
+    size_t nr_task, nr_row_per_task, task_workspace;
+
+    TaskSplit(size_t m, size_t n, size_t nr_threads);
+
+    size_t get_workspace_in_bytes() const { return nr_task * task_workspace; }
+};
+
+//! write the indices of the keys in the sorted order to idx
+void argsort_row(
+        const Kern& kern, int32_t* key, size_t n, int32_t* idx, void* workspace);
+
+/*!
+ * \brief select the k smallest of the n keys, where 0 < k <= n
+ *
+ * \param[out] idx the indices of the selected keys, which are sorted if
+ *      sorted is true; it can be null if only the k-th key is needed
+ * \return the index of the k-th smallest key
+ */
+int32_t topk_row(
+        const Kern& kern, const int32_t* key, size_t n, size_t k, bool sorted,
+        int32_t* idx, void* workspace);
+
+}  // namespace sort
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
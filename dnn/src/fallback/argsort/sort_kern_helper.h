@@ -0,0 +1,105 @@
+/**
+ * \file dnn/src/fallback/argsort/sort_kern_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+//! this file is included by the sort kernels of each arch after
+//! MEGDNN_SORT_TARGET is set, Vec must provide the following on int32 lanes:
+//! type, width, load, store, set1, permute, exchange and less_mask
+
+#include "src/fallback/argsort/sort.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace megdnn {
+namespace sort {
+namespace {
+
+/*!
+ * \brief the compare-exchange stages of a bitonic sorting network on W lanes
+ *
+ * At each stage, lane i is compared with lane perm[i] = i ^ stride and keeps
+ * the smaller pair if want_min[i] is all ones, or the larger one otherwise.
+ */
+template <size_t W>
+struct BitonicNetwork {
+    static constexpr size_t MAX_NR_STAGE = 15;
+    alignas(64) int32_t perm[MAX_NR_STAGE][W];
+    alignas(64) int32_t want_min[MAX_NR_STAGE][W];
+    size_t nr_stage = 0;
+
+    BitonicNetwork() {
+        for (size_t size = 2; size <= W; size *= 2) {
+            for (size_t stride = size / 2; stride; stride /= 2, ++nr_stage) {
+                for (size_t i = 0; i < W; ++i) {
+                    //! the blocks of the given size are sorted in alternate
+                    //! orders to form the bitonic sequences of the next size
+                    bool lower = !(i & stride), ascending = !(i & size);
+                    perm[nr_stage][i] = i ^ stride;
+                    want_min[nr_stage][i] = lower == ascending ? -1 : 0;
+                }
+            }
+        }
+    }
+};
+
+//! sort n <= Vec::width pairs in registers, padded with the largest pair
+template <class Vec>
+MEGDNN_SORT_TARGET void bitonic_sort(int32_t* key, int32_t* idx, size_t n) {
+    constexpr size_t W = Vec::width;
+    static const BitonicNetwork<W> network;
+    alignas(64) int32_t kbuf[W], ibuf[W];
+    std::copy(key, key + n, kbuf);
+    std::copy(idx, idx + n, ibuf);
+    std::fill(kbuf + n, kbuf + W, INT32_MAX);
+    std::fill(ibuf + n, ibuf + W, INT32_MAX);
+    auto k = Vec::load(kbuf), i = Vec::load(ibuf);
+    for (size_t s = 0; s < network.nr_stage; ++s) {
+        auto perm = Vec::load(network.perm[s]);
+        Vec::exchange(
+                k, i, Vec::permute(k, perm), Vec::permute(i, perm),
+                Vec::load(network.want_min[s]));
+    }
+    Vec::store(kbuf, k);
+    Vec::store(ibuf, i);
+    std::copy(kbuf, kbuf + n, key);
+    std::copy(ibuf, ibuf + n, idx);
+}
+
+template <class Vec>
+MEGDNN_SORT_TARGET size_t
+find_less(const int32_t* key, size_t begin, size_t n, int32_t thresh) {
+    constexpr size_t W = Vec::width;
+    auto t = Vec::set1(thresh);
+    size_t i = begin;
+    for (; i + W <= n; i += W) {
+        uint32_t mask = Vec::less_mask(Vec::load(key + i), t);
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < n; ++i) {
+        if (key[i] < thresh) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <class Vec>
+fallback::sort::Kern get_kern() {
+    return {bitonic_sort<Vec>, Vec::width, find_less<Vec>};
+}
+
+}  // anonymous namespace
+}  // namespace sort
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,180 @@
+/**
+ * \file dnn/src/fallback/attention/attention_kern_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+//! this file is included by the attention kernels of each arch after
+//! src/fallback/softmax/softmax_kern_helper.h, whose row kernels are used for
+//! the softmax of the scores; Vec must also provide fmadd
+
+#include "src/fallback/attention/opr_impl.h"
+
+namespace megdnn {
+namespace attention {
+namespace {
+
+/*!
+ * The keys are processed by tiles of KEY_TILE rows. For each query, the
+ * scores of a tile are kept in a local buffer and accumulated to dst by
+ * online softmax: dst and the running sum are rescaled whenever the running
+ * max grows, and dst is divided by the sum after the last tile. Queries are
+ * grouped by QUERY_TILE, so that the K and V rows of a tile are reused from
+ * cache by the queries of a group.
+ */
+constexpr size_t KEY_TILE = 64;
+constexpr size_t QUERY_TILE = 16;
+
+//! s[j] = dot(q, k_j) * scale for the n rows of k
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void dot_rows(
+        const float* q, const float* k, size_t n, size_t D, float scale, float* s) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const float* k0 = k + j * D;
+        const float *k1 = k0 + D, *k2 = k1 + D, *k3 = k2 + D;
+        vtype a0 = Vec::set1(0.f), a1 = a0, a2 = a0, a3 = a0;
+        size_t d = 0;
+        for (; d + W <= D; d += W) {
+            vtype x = Vec::load(q + d);
+            a0 = Vec::fmadd(x, Vec::load(k0 + d), a0);
+            a1 = Vec::fmadd(x, Vec::load(k1 + d), a1);
+            a2 = Vec::fmadd(x, Vec::load(k2 + d), a2);
+            a3 = Vec::fmadd(x, Vec::load(k3 + d), a3);
+        }
+        float r0 = Vec::reduce_add(a0), r1 = Vec::reduce_add(a1),
+              r2 = Vec::reduce_add(a2), r3 = Vec::reduce_add(a3);
+        for (; d < D; ++d) {
+            r0 += q[d] * k0[d];
+            r1 += q[d] * k1[d];
+            r2 += q[d] * k2[d];
+            r3 += q[d] * k3[d];
+        }
+        s[j] = r0 * scale;
+        s[j + 1] = r1 * scale;
+        s[j + 2] = r2 * scale;
+        s[j + 3] = r3 * scale;
+    }
+    for (; j < n; ++j) {
+        const float* kj = k + j * D;
+        vtype a0 = Vec::set1(0.f);
+        size_t d = 0;
+        for (; d + W <= D; d += W) {
+            a0 = Vec::fmadd(Vec::load(q + d), Vec::load(kj + d), a0);
+        }
+        float r0 = Vec::reduce_add(a0);
+        for (; d < D; ++d) {
+            r0 += q[d] * kj[d];
+        }
+        s[j] = r0 * scale;
+    }
+}
+
+//! s += mask
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void add_mask(float* s, const float* mask, size_t n) {
+    constexpr size_t W = Vec::width;
+    size_t j = 0;
+    for (; j + W <= n; j += W) {
+        Vec::store(s + j, Vec::add(Vec::load(s + j), Vec::load(mask + j)));
+    }
+    for (; j < n; ++j) {
+        s[j] += mask[j];
+    }
+}
+
+//! o = o * alpha + sum(p[j] * v_j), where 4 vectors of o are kept in registers
+//! over the n rows of v
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void accumulate_rows(
+        const float* p, const float* v, size_t n, size_t Dv, float alpha, float* o) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    const vtype valpha = Vec::set1(alpha);
+    size_t d = 0;
+    for (; d + 4 * W <= Dv; d += 4 * W) {
+        vtype o0 = Vec::mul(Vec::load(o + d), valpha),
+              o1 = Vec::mul(Vec::load(o + d + W), valpha),
+              o2 = Vec::mul(Vec::load(o + d + 2 * W), valpha),
+              o3 = Vec::mul(Vec::load(o + d + 3 * W), valpha);
+        for (size_t j = 0; j < n; ++j) {
+            const float* vj = v + j * Dv + d;
+            vtype pj = Vec::set1(p[j]);
+            o0 = Vec::fmadd(pj, Vec::load(vj), o0);
+            o1 = Vec::fmadd(pj, Vec::load(vj + W), o1);
+            o2 = Vec::fmadd(pj, Vec::load(vj + 2 * W), o2);
+            o3 = Vec::fmadd(pj, Vec::load(vj + 3 * W), o3);
+        }
+        Vec::store(o + d, o0);
+        Vec::store(o + d + W, o1);
+        Vec::store(o + d + 2 * W, o2);
+        Vec::store(o + d + 3 * W, o3);
+    }
+    for (; d + W <= Dv; d += W) {
+        vtype o0 = Vec::mul(Vec::load(o + d), valpha);
+        for (size_t j = 0; j < n; ++j) {
+            o0 = Vec::fmadd(Vec::set1(p[j]), Vec::load(v + j * Dv + d), o0);
+        }
+        Vec::store(o + d, o0);
+    }
+    for (; d < Dv; ++d) {
+        float acc = o[d] * alpha;
+        for (size_t j = 0; j < n; ++j) {
+            acc += p[j] * v[j * Dv + d];
+        }
+        o[d] = acc;
+    }
+}
+
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void attention(
+        const fallback::attention::KernParam& p, size_t row_begin, size_t row_end) {
+    float s[KEY_TILE], max[QUERY_TILE], sum[QUERY_TILE];
+    //! the queries before this row have no causal key
+    const size_t causal_offset = p.Lk - p.Lq;
+    for (size_t q0 = row_begin; q0 < row_end; q0 += QUERY_TILE) {
+        size_t nr_query = std::min(QUERY_TILE, row_end - q0);
+        size_t nr_key = p.causal ? q0 + nr_query + causal_offset : p.Lk;
+        std::fill(p.dst + q0 * p.Dv, p.dst + (q0 + nr_query) * p.Dv, 0.f);
+        std::fill(max, max + nr_query, -INFINITY);
+        std::fill(sum, sum + nr_query, 0.f);
+        for (size_t k0 = 0; k0 < nr_key; k0 += KEY_TILE) {
+            const float* kptr = p.k + k0 * p.D;
+            const float* vptr = p.v + k0 * p.Dv;
+            for (size_t i = 0; i < nr_query; ++i) {
+                size_t row = q0 + i;
+                size_t end = p.causal ? row + causal_offset + 1 : p.Lk;
+                if (end <= k0) {
+                    continue;
+                }
+                size_t n = std::min(KEY_TILE, end - k0);
+                dot_rows<Vec>(p.q + row * p.D, kptr, n, p.D, p.scale, s);
+                if (p.mask) {
+                    add_mask<Vec>(s, p.mask + row * p.Lk + k0, n);
+                }
+                float new_max = std::max(max[i], softmax::row_max<Vec>(s, n));
+                float tile_sum = softmax::exp_store_sum<Vec>(s, s, n, new_max);
+                float alpha = std::exp(max[i] - new_max);
+                sum[i] = sum[i] * alpha + tile_sum;
+                max[i] = new_max;
+                accumulate_rows<Vec>(s, vptr, n, p.Dv, alpha, p.dst + row * p.Dv);
+            }
+        }
+        for (size_t i = 0; i < nr_query; ++i) {
+            softmax::scale_row<Vec>(p.dst + (q0 + i) * p.Dv, p.Dv, 1.f / sum[i]);
+        }
+    }
+}
+
+}  // anonymous namespace
+}  // namespace attention
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,96 @@
+/**
+ * \file dnn/src/fallback/attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/attention/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_attention)
+
+#define MEGDNN_SIMD_VEC_TARGET
+
+namespace {
+//! plain float as a vector of width 1
+struct VecScalar {
+    using type = float;
+    static constexpr size_t width = 1;
+    static type load(const float* p) { return *p; }
+    static void store(float* p, type v) { *p = v; }
+    static type set1(float v) { return v; }
+    static type add(type a, type b) { return a + b; }
+    static type mul(type a, type b) { return a * b; }
+    static type fmadd(type a, type b, type c) { return a * b + c; }
+    static type max(type a, type b) { return std::max(a, b); }
+    static type exp(type v) { return std::exp(v); }
+    static float reduce_add(type v) { return v; }
+    static float reduce_max(type v) { return v; }
+};
+}  // anonymous namespace
+
+#include "src/fallback/softmax/softmax_kern_helper.h"
+#include "src/fallback/attention/attention_kern_helper.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+//! max number of queries of a task, which is reduced to feed all the threads
+constexpr size_t MAX_ROWS_PER_TASK = 64;
+}  // anonymous namespace
+
+fallback::attention::Kern fallback::attention::get_default_kern() {
+    return megdnn::attention::attention<VecScalar>;
+}
+
+void AttentionForwardImpl::exec(
+        _megdnn_tensor_in q, _megdnn_tensor_in k, _megdnn_tensor_in v,
+        _megdnn_tensor_in mask, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(q.layout, k.layout, v.layout, mask.layout, dst.layout, workspace.size);
+    if (q.layout.dtype != dtype::Float32() || dst.layout.is_empty()) {
+        return naive::AttentionForwardImpl::exec(q, k, v, mask, dst, workspace);
+    }
+    MIDOUT_BEGIN(megdnn_fallback_attention, midout_iv(0)) {
+        size_t batch, Lq, Lk, D, Dv;
+        get_matrix_shape(q.layout, k.layout, v.layout, batch, Lq, Lk, D, Dv);
+        fallback::attention::KernParam kern_param{
+                q.ptr<dt_float32>(), k.ptr<dt_float32>(), v.ptr<dt_float32>(),
+                mask.layout.ndim ? mask.ptr<dt_float32>() : nullptr,
+                dst.ptr<dt_float32>(), Lq, Lk, D, Dv, param().scale, param().causal};
+        size_t mask_stride = mask.layout.ndim == 2 ? 0 : Lq * Lk;
+        size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                    ->megcore_dispatcher()
+                                    ->nr_threads();
+        size_t nr_row_per_task = std::min(
+                MAX_ROWS_PER_TASK, std::max<size_t>(1, batch * Lq / nr_threads));
+        size_t nr_task_per_batch = div_ceil(Lq, nr_row_per_task);
+        auto kern = get_kern();
+        auto run = [=](size_t index, size_t) {
+            size_t b = index / nr_task_per_batch;
+            size_t begin = index % nr_task_per_batch * nr_row_per_task;
+            size_t end = std::min(Lq, begin + nr_row_per_task);
+            auto p = kern_param;
+            p.q += b * Lq * D;
+            p.k += b * Lk * D;
+            p.v += b * Lk * Dv;
+            p.mask = p.mask ? p.mask + b * mask_stride : nullptr;
+            p.dst += b * Lq * Dv;
+            kern(p, begin, end);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, batch * nr_task_per_batch);
+        return;
+    }
+    MIDOUT_END();
+}
+
+// vim: syntax=cpp.doxygen
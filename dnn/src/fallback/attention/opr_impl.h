@@ -0,0 +1,52 @@
+/**
+ * \file dnn/src/fallback/attention/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/naive/attention/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+namespace attention {
+
+//! a batch of float32 attention, where mask is null if absent
+struct KernParam {
+    const float *q, *k, *v, *mask;
+    float* dst;
+    size_t Lq, Lk, D, Dv;
+    float scale;
+    bool causal;
+};
+
+//! compute the query rows [row_begin, row_end) of a batch
+using Kern = void (*)(const KernParam& param, size_t row_begin, size_t row_end);
+
+//! get the scalar kernel
+Kern get_default_kern();
+
+}  // namespace attention
+
+class AttentionForwardImpl : public naive::AttentionForwardImpl {
+public:
+    using naive::AttentionForwardImpl::AttentionForwardImpl;
+    void exec(
+            _megdnn_tensor_in q, _megdnn_tensor_in k, _megdnn_tensor_in v,
+            _megdnn_tensor_in mask, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+
+protected:
+    //! get the float32 kernel; arch specific impls return their simd kernels
+    virtual attention::Kern get_kern() const { return attention::get_default_kern(); }
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
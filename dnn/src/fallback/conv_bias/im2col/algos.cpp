@@ -365,6 +365,9 @@ bool ConvBiasImpl::AlgoIm2col::usable(
              param.src_type.enumv() != DTypeEnum::Quantized8Asymm &&
 #if !MEGDNN_DISABLE_FLOAT16
              param.src_type.enumv() != DTypeEnum::Float16 &&
+#endif
+#if MEGDNN_X86 && !MEGDNN_DISABLE_FLOAT16
+             param.src_type.enumv() != DTypeEnum::BFloat16 &&
 #endif
              param.src_type.enumv() != DTypeEnum::Float32)) {
             return false;
@@ -401,7 +404,9 @@ bool ConvBiasImpl::AlgoIm2col::usable(
                   param.filter_meta.stride[0] == 1)) &&
                (param.filter_meta.dilation[0] == param.filter_meta.dilation[1] &&
                 param.filter_meta.dilation[0] == 1) &&
-               param.compute_mode == param::ConvBias::ComputeMode::DEFAULT;
+               (param.compute_mode == param::ConvBias::ComputeMode::DEFAULT ||
+                //! bfloat16 matmuls always accumulate in float
+                param.src_type.enumv() == DTypeEnum::BFloat16);
     }
     MIDOUT_END();
     return false;
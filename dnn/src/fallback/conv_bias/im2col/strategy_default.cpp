@@ -199,6 +199,11 @@ INSTANTIAL_CLASS(
         dt_float16, dt_float16, dt_float16, dt_float16, dt_float16,
         megdnn::PostprocessMode::NO_PROCESS)
 #endif
+#if MEGDNN_X86 && !MEGDNN_DISABLE_FLOAT16
+INSTANTIAL_CLASS(
+        dt_bfloat16, dt_bfloat16, dt_bfloat16, dt_bfloat16, dt_bfloat16,
+        megdnn::PostprocessMode::FLOAT)
+#endif
 
 #if MEGDNN_AARCH64 || MEGDNN_ARMV7
 //! x86 do not have uint8 matmul so only armv7 armv8 support uint8
@@ -225,6 +225,12 @@ public:
             X86_DIRECT_AVX2_STRD2_INT8,
             X86_MKLDNN_QINT8,
             X86_MKLDNN_MATMUL_QINT8,
+            X86_CHANWISE_AVX2_F32,
+            X86_CHANWISE_AVX2_NCHW88_F32,
+            X86_DIRECT_AVX2_NCHW88_F32,
+            X86_DIRECT_AVX2_NCHW_NCHW88_F32,
+            X86_DIRECT_VNNI_INT8,
+            X86_CHANWISE_VNNI_QINT8,
 #elif MEGDNN_AARCH64 || MEGDNN_ARMV7
             ARM_COMMON_WINOGRAD_F23_FP16 = 1 << 8,
             ARM_COMMON_WINOGRAD_F45_FP16,
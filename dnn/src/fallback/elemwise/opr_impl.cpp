@@ -26,6 +26,29 @@ MIDOUT_DECL(megdnn_fallback_elemwise_exec_BINARY_FLOAT)
 namespace megdnn {
 namespace fallback {
 
+constexpr size_t ElemwiseImpl::MIN_NR_ELEMS_PER_TASK;
+
+void ElemwiseImpl::dispatch_rows(
+        size_t nr_rows, size_t row_size, thin_function<void(size_t, size_t)> kern) {
+    auto handle = static_cast<naive::HandleImpl*>(this->handle());
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads(),
+           nr_tasks = std::min(nr_threads, nr_rows * row_size / MIN_NR_ELEMS_PER_TASK);
+    if (nr_tasks <= 1) {
+        MEGDNN_DISPATCH_CPU_KERN(handle, kern(0, nr_rows));
+        return;
+    }
+
+    // align chunks to 64 elements to avoid false sharing of dst cache lines
+    size_t align = std::max<size_t>(1, 64 / std::max<size_t>(row_size, 1)),
+           rows_per_task = round_up(div_ceil(nr_rows, nr_tasks), align);
+    nr_tasks = div_ceil(nr_rows, rows_per_task);
+    auto task = [nr_rows, rows_per_task, kern](size_t task_id, size_t) {
+        size_t begin = task_id * rows_per_task;
+        kern(begin, std::min(nr_rows, begin + rows_per_task));
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_tasks, task);
+}
+
 template <typename dtype, uint32_t mode>
 void ElemwiseImpl::unary_kern(const ElemwiseOpParamN<1>& param) {
     using ctype = typename DTypeTrait<dtype>::ctype;
@@ -39,10 +62,9 @@ void ElemwiseImpl::unary_kern(const ElemwiseOpParamN<1>& param) {
             MIDOUT_BEGIN(
                     megdnn_fallback_elemwise_unary, ctype, midout_iv(mode),
                     midout_iv(1)) {
-                auto tot = param.size;
                 auto stride = param[0].layout.stride[0];
-                MEGDNN_DISPATCH_CPU_KERN_OPR({
-                    for (size_t i = 0; i < tot; ++i) {
+                dispatch_rows(param.size, 1, [=](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
                         dst[i] = Kern::apply(src[i * stride]);
                     }
                 });
@@ -69,10 +91,9 @@ void ElemwiseImpl::binary_kern(const ElemwiseOpParamN<2>& param) {
             MIDOUT_BEGIN(
                     megdnn_fallback_elemwise_binary, ctype, midout_iv(mode),
                     midout_iv(1)) {
-                auto tot = param.size;
                 auto as = param[0].layout.stride[0], bs = param[1].layout.stride[0];
-                MEGDNN_DISPATCH_CPU_KERN_OPR({
-                    for (size_t i = 0; i < tot; ++i) {
+                dispatch_rows(param.size, 1, [=](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
                         dst[i] = Kern::apply(a[i * as], b[i * bs]);
                     }
                 });
@@ -94,9 +115,9 @@ void ElemwiseImpl::binary_kern(const ElemwiseOpParamN<2>& param) {
                          bs0 = param[1].layout.stride[0],
                          bs1 = param[1].layout.stride[1];
                     auto n0 = param[1].layout.shape[0], n1 = param[1].layout.shape[1];
-                    MEGDNN_DISPATCH_CPU_KERN_OPR({
-                        ptrdiff_t toff = 0;
-                        for (size_t i = 0; i < n0; ++i) {
+                    dispatch_rows(n0, n1, [=](size_t begin, size_t end) {
+                        ptrdiff_t toff = begin * n1;
+                        for (size_t i = begin; i < end; ++i) {
                             for (size_t j = 0; j < n1; ++j) {
                                 dst[toff] =
                                         Kern::apply(a[as * toff], b[bs0 * i + bs1 * j]);
@@ -117,9 +138,9 @@ void ElemwiseImpl::binary_kern(const ElemwiseOpParamN<2>& param) {
                      as1 = param[0].layout.stride[1];
                 auto n0 = param[0].layout.shape[0], n1 = param[0].layout.shape[1];
 
-                MEGDNN_DISPATCH_CPU_KERN_OPR({
-                    ptrdiff_t toff = 0;
-                    for (size_t i = 0; i < n0; ++i) {
+                dispatch_rows(n0, n1, [=](size_t begin, size_t end) {
+                    ptrdiff_t toff = begin * n1;
+                    for (size_t i = begin; i < end; ++i) {
                         for (size_t j = 0; j < n1; ++j) {
                             dst[toff] = Kern::apply(a[as0 * i + as1 * j], b[toff * bs]);
                             ++toff;
@@ -143,14 +164,14 @@ void ElemwiseImpl::binary_kern(const ElemwiseOpParamN<2>& param) {
                     auto as = param[0].layout.stride[0], bs = param[1].layout.stride[1];
                     auto n0 = param[1].layout.shape[0], n1 = param[1].layout.shape[1],
                          n2 = param[1].layout.shape[2];
-                    MEGDNN_DISPATCH_CPU_KERN_OPR({
-                        size_t toff = 0;
-                        for (size_t i = 0; i < n0; ++i) {
-                            for (size_t j = 0; j < n1; ++j) {
-                                for (size_t k = 0; k < n2; ++k) {
-                                    dst[toff] = Kern::apply(a[as * toff], b[bs * j]);
-                                    ++toff;
-                                }
+                    // rows of (n0 * n1) are flattened to be partitioned
+                    dispatch_rows(n0 * n1, n2, [=](size_t begin, size_t end) {
+                        size_t toff = begin * n2;
+                        for (size_t ij = begin; ij < end; ++ij) {
+                            auto j = ij % n1;
+                            for (size_t k = 0; k < n2; ++k) {
+                                dst[toff] = Kern::apply(a[as * toff], b[bs * j]);
+                                ++toff;
                             }
                         }
                     });
@@ -165,14 +186,13 @@ void ElemwiseImpl::binary_kern(const ElemwiseOpParamN<2>& param) {
                     auto as = param[0].layout.stride[1], bs = param[1].layout.stride[0];
                     auto n0 = param[0].layout.shape[0], n1 = param[0].layout.shape[1],
                          n2 = param[0].layout.shape[2];
-                    MEGDNN_DISPATCH_CPU_KERN_OPR({
-                        size_t toff = 0;
-                        for (size_t i = 0; i < n0; ++i) {
-                            for (size_t j = 0; j < n1; ++j) {
-                                for (size_t k = 0; k < n2; ++k) {
-                                    dst[toff] = Kern::apply(a[as * j], b[bs * toff]);
-                                    ++toff;
-                                }
+                    dispatch_rows(n0 * n1, n2, [=](size_t begin, size_t end) {
+                        size_t toff = begin * n2;
+                        for (size_t ij = begin; ij < end; ++ij) {
+                            auto j = ij % n1;
+                            for (size_t k = 0; k < n2; ++k) {
+                                dst[toff] = Kern::apply(a[as * j], b[bs * toff]);
+                                ++toff;
                             }
                         }
                     });
@@ -33,6 +33,25 @@ class ElemwiseImpl : public naive::ElemwiseForwardImpl {
     template <uint32_t mode>
     void exec_BINARY_FLOAT();
 
+protected:
+    //! min number of elements for each task when dispatching to multiple
+    //! threads, so that small tensors are computed by a single thread
+    static constexpr size_t MIN_NR_ELEMS_PER_TASK = 32768;
+
+    /*!
+     * \brief dispatch kern(row_begin, row_end) on rows in [0, nr_rows) in
+     *      parallel
+     *
+     * The rows are partitioned into contiguous chunks, one for each thread
+     * of the handle; chunks contain at least MIN_NR_ELEMS_PER_TASK elements
+     * and are aligned to cache lines for small rows. The kernel is
+     * dispatched as a single task if there is only one chunk.
+     *
+     * \param row_size number of elements in each row
+     */
+    void dispatch_rows(
+            size_t nr_rows, size_t row_size, thin_function<void(size_t, size_t)> kern);
+
 public:
     using naive::ElemwiseForwardImpl::ElemwiseForwardImpl;
     void exec(const TensorNDArray& srcs, _megdnn_tensor_out dst) override;
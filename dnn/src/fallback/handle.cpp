@@ -13,6 +13,8 @@
 #include "src/common/handle_impl.h"
 
 #include "src/fallback/add_update/opr_impl.h"
+#include "src/fallback/argsort/opr_impl.h"
+#include "src/fallback/attention/opr_impl.h"
 #include "src/fallback/batched_matrix_mul/opr_impl.h"
 #include "src/fallback/concat/opr_impl.h"
 #include "src/fallback/conv_bias/opr_impl.h"
@@ -22,8 +24,12 @@
 #include "src/fallback/flip/opr_impl.h"
 #include "src/fallback/gaussian_blur/opr_impl.h"
 #include "src/fallback/group_local/opr_impl.h"
+#include "src/fallback/indexing_multi_axis_vec/opr_impl.h"
+#include "src/fallback/indexing_one_hot/opr_impl.h"
 #include "src/fallback/mask_conv/opr_impl.h"
 #include "src/fallback/matrix_mul/opr_impl.h"
+#include "src/fallback/mesh_indexing/opr_impl.h"
+#include "src/fallback/norm/opr_impl.h"
 #include "src/fallback/pooling/opr_impl.h"
 #include "src/fallback/powc/opr_impl.h"
 #include "src/fallback/reduce/opr_impl.h"
@@ -31,9 +37,12 @@
 #include "src/fallback/repeat/opr_impl.h"
 #include "src/fallback/resize/opr_impl.h"
 #include "src/fallback/roi_copy/opr_impl.h"
+#include "src/fallback/rnn/opr_impl.h"
 #include "src/fallback/rotate/opr_impl.h"
+#include "src/fallback/softmax/opr_impl.h"
 #include "src/fallback/split/opr_impl.h"
 #include "src/fallback/tile/opr_impl.h"
+#include "src/fallback/topk/opr_impl.h"
 #include "src/fallback/type_cvt/opr_impl.h"
 #include "src/fallback/warp_perspective/opr_impl.h"
 
@@ -70,6 +79,25 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(Resize)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedMatrixMulForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(PowC)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SoftmaxForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LayerNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GroupNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(AttentionForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LSTMForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GRUForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(TopK)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ArgsortForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingSetMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingIncrMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingOneHotForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingSetOneHotForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(MeshIndexing)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IncrMeshIndexing)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SetMeshIndexing)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedMeshIndexing)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedIncrMeshIndexing)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedSetMeshIndexing)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
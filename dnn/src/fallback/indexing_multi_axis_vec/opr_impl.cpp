@@ -0,0 +1,300 @@
+/**
+ * \file dnn/src/fallback/indexing_multi_axis_vec/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/indexing_multi_axis_vec/opr_impl.h"
+
+#include "src/common/indexing_multi_axis_vec_kdef.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cstring>
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_indexing_multi_axis_vec)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! do not split the work into tasks smaller than this number of bytes
+constexpr size_t MIN_TASK_SIZE = 16384;
+//! do not split a row into column blocks smaller than this number of bytes
+constexpr size_t MIN_COL_BLOCK_SIZE = 1024;
+
+using IndexDesc = IndexingMultiAxisVec::IndexDesc;
+using ExecInfo = IndexingMultiAxisVec::ExecInfo;
+
+/*!
+ * \brief the indexing viewed as nr_outer x nr_idx rows of row_size elements
+ *
+ * Row (o, j) of value is contiguous at (o * nr_idx + j) * row_size, and the
+ * corresponding row of data is contiguous at o * outer_stride + offset[j].
+ */
+struct RowPlan {
+    size_t nr_outer, nr_idx, row_size;
+    ptrdiff_t outer_stride;
+    //! the range of offset[j] allowed by the layout of data
+    ptrdiff_t offset_begin, offset_end;
+};
+
+//! return false if the indexing can not be viewed as rows
+bool make_row_plan(
+        const TensorLayout& data, const TensorLayout& value, const IndexDesc& index,
+        const ExecInfo& info, RowPlan& plan) {
+    if (info.value_stride != 1 || value.is_empty() || data.dtype.is_low_bit()) {
+        return false;
+    }
+    auto&& iter = IndexingMultiAxisVec::get_value_iter_optimized_layout(
+            data, value, index, info.idx_axis);
+    auto&& ly = iter.first;
+    size_t axis = iter.second;
+    if (axis > 1 || ly.ndim > axis + 2 ||
+        (ly.ndim == axis + 2 && ly.stride[axis + 1] != 1)) {
+        return false;
+    }
+    plan.nr_outer = axis ? ly.shape[0] : 1;
+    plan.outer_stride = axis ? ly.stride[0] : 0;
+    plan.nr_idx = ly.shape[axis];
+    plan.row_size = ly.ndim == axis + 2 ? ly.shape[axis + 1] : 1;
+    plan.offset_begin = plan.offset_end = 0;
+    for (auto&& i : index) {
+        ptrdiff_t span = (data.shape[i.axis] - 1) * data.stride[i.axis];
+        (span < 0 ? plan.offset_begin : plan.offset_end) += span;
+    }
+    ++plan.offset_end;
+    return true;
+}
+
+//! compute the offsets of the indexed rows in data and check the index values
+void compute_offset(
+        const TensorLayout& data, const IndexDesc& index, size_t nr_idx,
+        ptrdiff_t* offset) {
+    std::fill(offset, offset + nr_idx, 0);
+    for (size_t i = 0; i < index.size(); ++i) {
+        auto&& s = index[i];
+        const int* iptr = s.vec.ptr<dt_int32>();
+        ptrdiff_t istride = s.vec.layout.shape[0] == 1 ? 0 : s.vec.layout.stride[0];
+        int shape = data.shape[s.axis];
+        ptrdiff_t stride = data.stride[s.axis];
+        for (size_t j = 0; j < nr_idx; ++j) {
+            int idx = iptr[j * istride];
+            if (idx < 0) {
+                idx += shape;
+            }
+            megdnn_assert(
+                    idx >= 0 && idx < shape,
+                    "bad index value for index %zu at output %zu", i, j);
+            offset[j] += idx * stride;
+        }
+    }
+}
+
+size_t get_nr_task(naive::HandleImpl* handle, size_t nr_byte) {
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    return std::max<size_t>(1, std::min(nr_threads, nr_byte / MIN_TASK_SIZE));
+}
+
+//! copy the rows of data to value, where T is a type of the element size
+template <typename T>
+void gather(
+        naive::HandleImpl* handle, const TensorND& data, const TensorND& value,
+        const IndexDesc& index, const RowPlan& plan, ptrdiff_t* offset) {
+    MEGDNN_DISPATCH_CPU_KERN(
+            handle, compute_offset(data.layout, index, plan.nr_idx, offset));
+    size_t nr_row = plan.nr_outer * plan.nr_idx;
+    size_t nr_task = get_nr_task(handle, value.layout.span().dist_byte());
+    size_t nr_row_per_task = div_ceil(nr_row, nr_task);
+    nr_task = div_ceil(nr_row, nr_row_per_task);
+    const T* sptr = static_cast<const T*>(data.raw_ptr);
+    T* dptr = static_cast<T*>(value.raw_ptr);
+    auto run = [=](size_t index, size_t) {
+        size_t begin = index * nr_row_per_task;
+        size_t end = std::min(nr_row, begin + nr_row_per_task);
+        size_t row_size = plan.row_size;
+        for (size_t r = begin; r < end; ++r) {
+            const T* s = sptr + r / plan.nr_idx * plan.outer_stride +
+                         offset[r % plan.nr_idx];
+            T* d = dptr + r * row_size;
+            if (row_size == 1) {
+                *d = *s;
+            } else {
+                memcpy(d, s, row_size * sizeof(T));
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_task, run);
+}
+
+/*!
+ * \brief apply value to the rows of data by Opr
+ *
+ * A task owns a block of outer indices, a range of the row offsets in data
+ * and a block of columns, and visits the rows in the order of the index, so
+ * the tasks never touch the same element and duplicated indices are applied
+ * in the same order as the naive impl without any partial buffers.
+ */
+template <typename T, class Opr>
+void scatter(
+        naive::HandleImpl* handle, const TensorND& data, const TensorND& value,
+        const IndexDesc& index, const RowPlan& plan, ptrdiff_t* offset) {
+    MEGDNN_DISPATCH_CPU_KERN(
+            handle, compute_offset(data.layout, index, plan.nr_idx, offset));
+    size_t nr_task = get_nr_task(handle, value.layout.span().dist_byte());
+
+    size_t nr_outer_blk = std::min(plan.nr_outer, nr_task);
+    size_t outer_blk = div_ceil(plan.nr_outer, nr_outer_blk);
+    nr_outer_blk = div_ceil(plan.nr_outer, outer_blk);
+    size_t nr_inner_task = div_ceil(nr_task, nr_outer_blk);
+
+    size_t nr_col_blk = std::min(
+            nr_inner_task,
+            std::max<size_t>(1, plan.row_size * sizeof(T) / MIN_COL_BLOCK_SIZE));
+    size_t col_blk = div_ceil(plan.row_size, nr_col_blk);
+    nr_col_blk = div_ceil(plan.row_size, col_blk);
+
+    size_t nr_range = div_ceil(nr_inner_task, nr_col_blk);
+    ptrdiff_t offset_span = plan.offset_end - plan.offset_begin;
+    ptrdiff_t range = div_ceil<ptrdiff_t>(offset_span, nr_range);
+    nr_range = div_ceil<ptrdiff_t>(offset_span, range);
+
+    T* dptr = static_cast<T*>(data.raw_ptr);
+    const T* vptr = static_cast<const T*>(value.raw_ptr);
+    auto run = [=](size_t index, size_t) {
+        size_t ob = index / (nr_range * nr_col_blk),
+               rg = index / nr_col_blk % nr_range, cb = index % nr_col_blk;
+        size_t outer_begin = ob * outer_blk,
+               outer_end = std::min(plan.nr_outer, outer_begin + outer_blk);
+        ptrdiff_t off_begin = plan.offset_begin + rg * range,
+                  off_end = off_begin + range;
+        size_t col_begin = cb * col_blk,
+               col_end = std::min(plan.row_size, col_begin + col_blk);
+        for (size_t o = outer_begin; o < outer_end; ++o) {
+            T* d = dptr + o * plan.outer_stride;
+            const T* v = vptr + o * plan.nr_idx * plan.row_size;
+            for (size_t j = 0; j < plan.nr_idx; ++j) {
+                ptrdiff_t off = offset[j];
+                if (off < off_begin || off >= off_end) {
+                    continue;
+                }
+                T* drow = d + off;
+                const T* vrow = v + j * plan.row_size;
+                for (size_t c = col_begin; c < col_end; ++c) {
+                    Opr::apply(drow[c], vrow[c]);
+                }
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            handle, nr_outer_blk * nr_range * nr_col_blk, run);
+}
+
+}  // anonymous namespace
+
+#define FOREACH_ELEM_SIZE(cb) cb(1, uint8_t) cb(2, uint16_t) cb(4, uint32_t)
+
+size_t IndexingMultiAxisVecImpl::get_workspace_in_bytes(size_t index_size) {
+    return index_size * sizeof(ptrdiff_t);
+}
+
+void IndexingMultiAxisVecImpl::exec(
+        _megdnn_tensor_in src, const IndexDesc& index, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(src.layout, index, dst.layout, workspace.size);
+    RowPlan plan;
+    if (make_row_plan(src.layout, dst.layout, index, info, plan)) {
+        auto handle = static_cast<naive::HandleImpl*>(this->handle());
+        auto offset = workspace.ptr<ptrdiff_t>();
+        switch (src.layout.dtype.size()) {
+#define cb(_size, _type)                                                    \
+    case _size:                                                             \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_multi_axis_vec, midout_iv(0), \
+                     midout_iv(_size)) {                                    \
+            return gather<_type>(handle, src, dst, index, plan, offset);    \
+        }                                                                   \
+        MIDOUT_END();                                                       \
+        break;
+            FOREACH_ELEM_SIZE(cb)
+#undef cb
+            default:
+                break;
+        }
+    }
+    naive::IndexingMultiAxisVecImpl::exec(src, index, dst, workspace);
+}
+
+size_t IndexingSetMultiAxisVecImpl::get_workspace_in_bytes(size_t index_size) {
+    return index_size * sizeof(ptrdiff_t);
+}
+
+void IndexingSetMultiAxisVecImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(data.layout, value.layout, index, workspace.size);
+    RowPlan plan;
+    if (make_row_plan(data.layout, value.layout, index, info, plan)) {
+        using Opr = indexing_multi_axis_vec_kdef::OprSet;
+        auto handle = static_cast<naive::HandleImpl*>(this->handle());
+        auto offset = workspace.ptr<ptrdiff_t>();
+        switch (data.layout.dtype.size()) {
+#define cb(_size, _type)                                                          \
+    case _size:                                                                   \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_multi_axis_vec, midout_iv(1),       \
+                     midout_iv(_size)) {                                          \
+            return scatter<_type, Opr>(handle, data, value, index, plan, offset); \
+        }                                                                         \
+        MIDOUT_END();                                                             \
+        break;
+            FOREACH_ELEM_SIZE(cb)
+#undef cb
+            default:
+                break;
+        }
+    }
+    naive::IndexingSetMultiAxisVecImpl::exec(data, value, index, workspace);
+}
+
+size_t IndexingIncrMultiAxisVecImpl::get_workspace_in_bytes(size_t index_size) {
+    return index_size * sizeof(ptrdiff_t);
+}
+
+void IndexingIncrMultiAxisVecImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(data.layout, value.layout, index, workspace.size);
+    RowPlan plan;
+    if (make_row_plan(data.layout, value.layout, index, info, plan)) {
+        using Opr = indexing_multi_axis_vec_kdef::OprIncr;
+        auto handle = static_cast<naive::HandleImpl*>(this->handle());
+        auto offset = workspace.ptr<ptrdiff_t>();
+        switch (data.layout.dtype.enumv()) {
+#define cb(_dt)                                                                   \
+    case DTypeTrait<_dt>::enumv:                                                  \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_multi_axis_vec, midout_iv(2),       \
+                     midout_iv(DTypeTrait<_dt>::enumv)) {                         \
+            using ctype = DTypeTrait<_dt>::ctype;                                 \
+            return scatter<ctype, Opr>(handle, data, value, index, plan, offset); \
+        }                                                                         \
+        MIDOUT_END();                                                             \
+        break;
+            MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+#undef cb
+            default:
+                break;
+        }
+    }
+    naive::IndexingIncrMultiAxisVecImpl::exec(data, value, index, workspace);
+}
+
+#undef FOREACH_ELEM_SIZE
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,60 @@
+/**
+ * \file dnn/src/fallback/indexing_multi_axis_vec/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/naive/indexing_multi_axis_vec/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * The indexings whose data rows after the indexed axes are contiguous, such
+ * as embedding lookups, are processed row by row on multiple threads; the
+ * offsets of the indexed rows are computed into the workspace first.
+ */
+class IndexingMultiAxisVecImpl : public naive::IndexingMultiAxisVecImpl {
+public:
+    using naive::IndexingMultiAxisVecImpl::IndexingMultiAxisVecImpl;
+
+    size_t get_workspace_in_bytes(size_t index_size) override;
+
+    void exec(
+            _megdnn_tensor_in src, const IndexDesc& index, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+};
+
+class IndexingSetMultiAxisVecImpl : public naive::IndexingSetMultiAxisVecImpl {
+public:
+    using naive::IndexingSetMultiAxisVecImpl::IndexingSetMultiAxisVecImpl;
+
+    size_t get_workspace_in_bytes(size_t index_size) override;
+
+    void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+            _megdnn_workspace workspace) override;
+};
+
+class IndexingIncrMultiAxisVecImpl : public naive::IndexingIncrMultiAxisVecImpl {
+public:
+    using naive::IndexingIncrMultiAxisVecImpl::IndexingIncrMultiAxisVecImpl;
+
+    size_t get_workspace_in_bytes(size_t index_size) override;
+
+    void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+            _megdnn_workspace workspace) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
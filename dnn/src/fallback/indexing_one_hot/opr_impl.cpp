@@ -0,0 +1,155 @@
+/**
+ * \file dnn/src/fallback/indexing_one_hot/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/indexing_one_hot/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_indexing_one_hot)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! do not split the work into tasks smaller than this number of elements
+constexpr size_t MIN_TASK_SIZE = 16384;
+
+/*!
+ * \brief the layouts viewed as data of shape (A, M, B) and index of shape
+ *      (A, B), which are all contiguous
+ */
+struct Shape3 {
+    size_t A, M, B;
+
+    Shape3(const TensorLayout& data, size_t axis) : A{1}, M{data[axis]}, B{1} {
+        for (size_t i = 0; i < axis; ++i) {
+            A *= data[i];
+        }
+        for (size_t i = axis + 1; i < data.ndim; ++i) {
+            B *= data[i];
+        }
+    }
+};
+
+bool use_fast_path(const TensorLayout& data) {
+    size_t size = data.dtype.size();
+    return !data.is_empty() && !data.dtype.is_low_bit() &&
+           (size == 1 || size == 2 || size == 4);
+}
+
+void check_index(const int* index, size_t nr_elem, int M) {
+    for (size_t i = 0; i < nr_elem; ++i) {
+        int idx = index[i];
+        megdnn_assert(
+                idx >= 0 && idx < M,
+                "bad value in IndexingOneHot index: input shape is %d, "
+                "index value is %d",
+                M, idx);
+    }
+}
+
+template <typename T, bool set>
+void exec_one_hot(
+        naive::HandleImpl* handle, void* data, const int* index, void* sub,
+        Shape3 shape) {
+    size_t nr_elem = shape.A * shape.B;
+    MEGDNN_DISPATCH_CPU_KERN(
+            handle, check_index(index, nr_elem, static_cast<int>(shape.M)));
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    size_t nr_task =
+            std::max<size_t>(1, std::min(nr_threads, nr_elem / MIN_TASK_SIZE));
+    size_t nr_elem_per_task = div_ceil(nr_elem, nr_task);
+    nr_task = div_ceil(nr_elem, nr_elem_per_task);
+    T* dptr = static_cast<T*>(data);
+    T* sptr = static_cast<T*>(sub);
+    auto run = [=](size_t index_id, size_t) {
+        size_t begin = index_id * nr_elem_per_task;
+        size_t end = std::min(nr_elem, begin + nr_elem_per_task);
+        size_t B = shape.B, MB = shape.M * shape.B;
+        //! walk the (A, B) plane row by row to avoid a division per element
+        for (size_t a = begin / B, b = begin % B, i = begin; i < end; ++a, b = 0) {
+            T* drow = dptr + a * MB;
+            for (; b < B && i < end; ++b, ++i) {
+                T& elem = drow[index[i] * B + b];
+                if (set) {
+                    elem = sptr[i];
+                } else {
+                    sptr[i] = elem;
+                }
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_task, run);
+}
+
+}  // anonymous namespace
+
+#define FOREACH_ELEM_SIZE(cb) cb(1, uint8_t) cb(2, uint16_t) cb(4, uint32_t)
+
+void IndexingOneHotForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in index, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, index.layout, dst.layout, workspace.size);
+    if (use_fast_path(src.layout)) {
+        auto handle = static_cast<naive::HandleImpl*>(this->handle());
+        Shape3 shape{src.layout, static_cast<size_t>(param().axis)};
+        switch (src.layout.dtype.size()) {
+#define cb(_size, _type)                                                             \
+    case _size:                                                                      \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_one_hot, midout_iv(0),                 \
+                     midout_iv(_size)) {                                             \
+            return exec_one_hot<_type, false>(                                       \
+                    handle, src.raw_ptr, index.ptr<dt_int32>(), dst.raw_ptr, shape); \
+        }                                                                            \
+        MIDOUT_END();                                                                \
+        break;
+            FOREACH_ELEM_SIZE(cb)
+#undef cb
+            default:
+                break;
+        }
+    }
+    naive::IndexingOneHotForwardImpl::exec(src, index, dst, workspace);
+}
+
+void IndexingSetOneHotForwardImpl::exec(
+        _megdnn_tensor_inout data, _megdnn_tensor_in index, _megdnn_tensor_in sub,
+        _megdnn_workspace workspace) {
+    check_exec(data.layout, index.layout, sub.layout, workspace.size);
+    if (use_fast_path(data.layout)) {
+        auto handle = static_cast<naive::HandleImpl*>(this->handle());
+        Shape3 shape{data.layout, static_cast<size_t>(param().axis)};
+        switch (data.layout.dtype.size()) {
+#define cb(_size, _type)                                                              \
+    case _size:                                                                       \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_one_hot, midout_iv(1),                  \
+                     midout_iv(_size)) {                                              \
+            return exec_one_hot<_type, true>(                                         \
+                    handle, data.raw_ptr, index.ptr<dt_int32>(), sub.raw_ptr, shape); \
+        }                                                                             \
+        MIDOUT_END();                                                                 \
+        break;
+            FOREACH_ELEM_SIZE(cb)
+#undef cb
+            default:
+                break;
+        }
+    }
+    naive::IndexingSetOneHotForwardImpl::exec(data, index, sub, workspace);
+}
+
+#undef FOREACH_ELEM_SIZE
+
+// vim: syntax=cpp.doxygen
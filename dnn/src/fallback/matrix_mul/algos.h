@@ -74,6 +74,7 @@ public:
             static_cast<AlgoDataType>(
                     static_cast<uint32_t>(AlgoDataType::FLOAT16) |
                     static_cast<uint32_t>(AlgoDataType::FLOAT32) |
+                    static_cast<uint32_t>(AlgoDataType::BFLOAT16) |
                     static_cast<uint32_t>(AlgoDataType::INT8X8X16) |
                     static_cast<uint32_t>(AlgoDataType::QINT8X8X32) |
                     static_cast<uint32_t>(AlgoDataType::QUINT8X8X32)),
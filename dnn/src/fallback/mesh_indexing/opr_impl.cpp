@@ -0,0 +1,353 @@
+/**
+ * \file dnn/src/fallback/mesh_indexing/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/mesh_indexing/opr_impl.h"
+
+#include "src/common/indexing_multi_axis_vec_kdef.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cstring>
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_mesh_indexing)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! do not split the work into tasks smaller than this number of bytes
+constexpr size_t MIN_TASK_SIZE = 16384;
+//! do not split a row into column blocks smaller than this number of bytes
+constexpr size_t MIN_COL_BLOCK_SIZE = 1024;
+
+using IndexDesc = MeshBase::IndexDesc;
+
+/*!
+ * \brief the mesh indexing viewed as nr_outer x nr_idx rows of row_size
+ *      elements
+ *
+ * Row (o, j) of the indexed tensor is contiguous at (o * nr_idx + j) *
+ * row_size, and the corresponding row of the origin tensor is contiguous at
+ * o * outer_stride + idx * axis_stride, where idx is the j-th index of batch
+ * o / nr_outer_per_batch.
+ */
+struct RowPlan {
+    size_t nr_outer, nr_outer_per_batch, nr_batch, nr_idx, row_size;
+    ptrdiff_t outer_stride, axis_stride;
+    int axis_shape;
+    const int* idx;
+    ptrdiff_t idx_batch_stride, idx_stride;
+
+    ptrdiff_t row_offset(size_t o, size_t j) const {
+        int v = idx[o / nr_outer_per_batch * idx_batch_stride + j * idx_stride];
+        if (v < 0) {
+            v += axis_shape;
+        }
+        return o * outer_stride + v * axis_stride;
+    }
+};
+
+//! return false if the indexing can not be viewed as rows
+bool make_row_plan(
+        const TensorLayout& origin, const TensorLayout& indexed, const IndexDesc& desc,
+        bool batched, RowPlan& plan) {
+    if (desc.size() != 1 || indexed.is_empty() || origin.dtype.is_low_bit() ||
+        !indexed.is_contiguous()) {
+        return false;
+    }
+    size_t axis = desc[0].axis, ndim = origin.ndim;
+    for (size_t i = 0; i < ndim; ++i) {
+        if (i != axis && origin.shape[i] != indexed.shape[i]) {
+            return false;
+        }
+    }
+    plan.row_size = 1;
+    for (size_t i = ndim - 1; i > axis; --i) {
+        if (origin.shape[i] != 1 &&
+            origin.stride[i] != static_cast<ptrdiff_t>(plan.row_size)) {
+            return false;
+        }
+        plan.row_size *= origin.shape[i];
+    }
+    plan.nr_outer = 1;
+    plan.outer_stride = 0;
+    for (size_t i = axis; i-- > 0;) {
+        if (origin.shape[i] == 1) {
+            continue;
+        }
+        if (plan.nr_outer == 1) {
+            plan.outer_stride = origin.stride[i];
+        } else if (
+                origin.stride[i] !=
+                plan.outer_stride * static_cast<ptrdiff_t>(plan.nr_outer)) {
+            return false;
+        }
+        plan.nr_outer *= origin.shape[i];
+    }
+    auto&& vec = desc[0].vec.layout;
+    plan.nr_idx = indexed.shape[axis];
+    plan.axis_stride = origin.stride[axis];
+    plan.axis_shape = origin.shape[axis];
+    plan.idx = desc[0].vec.ptr<dt_int32>();
+    plan.idx_stride = vec.shape[vec.ndim - 1] == 1 ? 0 : vec.stride[vec.ndim - 1];
+    if (batched) {
+        plan.nr_batch = origin.shape[0];
+        plan.nr_outer_per_batch = plan.nr_outer / plan.nr_batch;
+        plan.idx_batch_stride = vec.shape[0] == 1 ? 0 : vec.stride[0];
+    } else {
+        plan.nr_batch = 1;
+        plan.nr_outer_per_batch = plan.nr_outer;
+        plan.idx_batch_stride = 0;
+    }
+    return true;
+}
+
+void check_index(const RowPlan& plan) {
+    for (size_t b = 0; b < plan.nr_batch; ++b) {
+        for (size_t j = 0; j < plan.nr_idx; ++j) {
+            int v = plan.idx[b * plan.idx_batch_stride + j * plan.idx_stride];
+            megdnn_assert(
+                    v >= -plan.axis_shape && v < plan.axis_shape,
+                    "bad index value %d at batch %zu position %zu", v, b, j);
+        }
+    }
+}
+
+size_t get_nr_task(naive::HandleImpl* handle, size_t nr_byte) {
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    return std::max<size_t>(1, std::min(nr_threads, nr_byte / MIN_TASK_SIZE));
+}
+
+//! copy the rows of origin to indexed, where T is a type of the element size
+template <typename T>
+void gather(
+        naive::HandleImpl* handle, const TensorND& origin, const TensorND& indexed,
+        const RowPlan& plan) {
+    MEGDNN_DISPATCH_CPU_KERN(handle, check_index(plan));
+    size_t nr_row = plan.nr_outer * plan.nr_idx;
+    size_t nr_task = get_nr_task(handle, indexed.layout.span().dist_byte());
+    size_t nr_row_per_task = div_ceil(nr_row, nr_task);
+    nr_task = div_ceil(nr_row, nr_row_per_task);
+    const T* sptr = static_cast<const T*>(origin.raw_ptr);
+    T* dptr = static_cast<T*>(indexed.raw_ptr);
+    auto run = [=](size_t index, size_t) {
+        size_t begin = index * nr_row_per_task;
+        size_t end = std::min(nr_row, begin + nr_row_per_task);
+        size_t row_size = plan.row_size;
+        for (size_t r = begin; r < end; ++r) {
+            const T* s = sptr + plan.row_offset(r / plan.nr_idx, r % plan.nr_idx);
+            T* d = dptr + r * row_size;
+            if (row_size == 1) {
+                *d = *s;
+            } else {
+                memcpy(d, s, row_size * sizeof(T));
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_task, run);
+}
+
+/*!
+ * \brief apply indexed to the rows of origin by Opr
+ *
+ * A task owns a block of outer indices and a block of columns and visits the
+ * rows in the order of the index, so the tasks never touch the same element
+ * and duplicated indices are applied in the same order as the naive impl.
+ */
+template <typename T, class Opr>
+void scatter(
+        naive::HandleImpl* handle, const TensorND& origin, const TensorND& indexed,
+        const RowPlan& plan) {
+    MEGDNN_DISPATCH_CPU_KERN(handle, check_index(plan));
+    size_t nr_task = get_nr_task(handle, indexed.layout.span().dist_byte());
+
+    size_t nr_outer_blk = std::min(plan.nr_outer, nr_task);
+    size_t outer_blk = div_ceil(plan.nr_outer, nr_outer_blk);
+    nr_outer_blk = div_ceil(plan.nr_outer, outer_blk);
+
+    size_t nr_col_blk = std::min(
+            div_ceil(nr_task, nr_outer_blk),
+            std::max<size_t>(1, plan.row_size * sizeof(T) / MIN_COL_BLOCK_SIZE));
+    size_t col_blk = div_ceil(plan.row_size, nr_col_blk);
+    nr_col_blk = div_ceil(plan.row_size, col_blk);
+
+    T* dptr = static_cast<T*>(origin.raw_ptr);
+    const T* vptr = static_cast<const T*>(indexed.raw_ptr);
+    auto run = [=](size_t index, size_t) {
+        size_t ob = index / nr_col_blk, cb = index % nr_col_blk;
+        size_t outer_begin = ob * outer_blk,
+               outer_end = std::min(plan.nr_outer, outer_begin + outer_blk);
+        size_t col_begin = cb * col_blk,
+               col_end = std::min(plan.row_size, col_begin + col_blk);
+        for (size_t o = outer_begin; o < outer_end; ++o) {
+            const T* v = vptr + o * plan.nr_idx * plan.row_size;
+            for (size_t j = 0; j < plan.nr_idx; ++j) {
+                T* drow = dptr + plan.row_offset(o, j);
+                const T* vrow = v + j * plan.row_size;
+                for (size_t c = col_begin; c < col_end; ++c) {
+                    Opr::apply(drow[c], vrow[c]);
+                }
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_outer_blk * nr_col_blk, run);
+}
+
+#define FOREACH_ELEM_SIZE(cb) cb(1, uint8_t) cb(2, uint16_t) cb(4, uint32_t)
+
+//! return false if the indexing is not handled and should go to naive
+bool try_gather(
+        Handle* handle, const TensorND& src, const IndexDesc& desc,
+        const TensorND& dst, bool batched) {
+    RowPlan plan;
+    if (!make_row_plan(src.layout, dst.layout, desc, batched, plan)) {
+        return false;
+    }
+    auto naive_handle = static_cast<naive::HandleImpl*>(handle);
+    switch (src.layout.dtype.size()) {
+#define cb(_size, _type)                                                     \
+    case _size:                                                              \
+        MIDOUT_BEGIN(megdnn_fallback_mesh_indexing, midout_iv(0),            \
+                     midout_iv(_size)) {                                     \
+            gather<_type>(naive_handle, src, dst, plan);                     \
+            return true;                                                     \
+        }                                                                    \
+        MIDOUT_END();                                                        \
+        break;
+        FOREACH_ELEM_SIZE(cb)
+#undef cb
+        default:
+            break;
+    }
+    return false;
+}
+
+bool try_set(
+        Handle* handle, const TensorND& data, const TensorND& value,
+        const IndexDesc& desc, bool batched) {
+    RowPlan plan;
+    if (!make_row_plan(data.layout, value.layout, desc, batched, plan)) {
+        return false;
+    }
+    using Opr = indexing_multi_axis_vec_kdef::OprSet;
+    auto naive_handle = static_cast<naive::HandleImpl*>(handle);
+    switch (data.layout.dtype.size()) {
+#define cb(_size, _type)                                                     \
+    case _size:                                                              \
+        MIDOUT_BEGIN(megdnn_fallback_mesh_indexing, midout_iv(1),            \
+                     midout_iv(_size)) {                                     \
+            scatter<_type, Opr>(naive_handle, data, value, plan);            \
+            return true;                                                     \
+        }                                                                    \
+        MIDOUT_END();                                                        \
+        break;
+        FOREACH_ELEM_SIZE(cb)
+#undef cb
+        default:
+            break;
+    }
+    return false;
+}
+
+bool try_incr(
+        Handle* handle, const TensorND& data, const TensorND& value,
+        const IndexDesc& desc, bool batched) {
+    RowPlan plan;
+    if (!make_row_plan(data.layout, value.layout, desc, batched, plan)) {
+        return false;
+    }
+    using Opr = indexing_multi_axis_vec_kdef::OprIncr;
+    auto naive_handle = static_cast<naive::HandleImpl*>(handle);
+    switch (data.layout.dtype.enumv()) {
+#define cb(_dt)                                                              \
+    case DTypeTrait<_dt>::enumv:                                             \
+        MIDOUT_BEGIN(megdnn_fallback_mesh_indexing, midout_iv(2),            \
+                     midout_iv(DTypeTrait<_dt>::enumv)) {                    \
+            using ctype = DTypeTrait<_dt>::ctype;                            \
+            scatter<ctype, Opr>(naive_handle, data, value, plan);            \
+            return true;                                                     \
+        }                                                                    \
+        MIDOUT_END();                                                        \
+        break;
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+#undef cb
+        default:
+            break;
+    }
+    return false;
+}
+
+#undef FOREACH_ELEM_SIZE
+
+}  // anonymous namespace
+
+/* =========================== MeshIndexing ============================ */
+
+void MeshIndexingImpl::exec(
+        _megdnn_tensor_in src, const IndexDesc& desc, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, desc);
+    if (!try_gather(handle(), src, desc, dst, false)) {
+        naive::MeshIndexingImpl::exec(src, desc, dst, workspace);
+    }
+}
+
+void IncrMeshIndexingImpl::exec(
+        _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+        _megdnn_workspace workspace) {
+    check_exec(data.layout, value.layout, desc);
+    if (!try_incr(handle(), data, value, desc, false)) {
+        naive::IncrMeshIndexingImpl::exec(data, value, desc, workspace);
+    }
+}
+
+void SetMeshIndexingImpl::exec(
+        _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+        _megdnn_workspace workspace) {
+    check_exec(data.layout, value.layout, desc);
+    if (!try_set(handle(), data, value, desc, false)) {
+        naive::SetMeshIndexingImpl::exec(data, value, desc, workspace);
+    }
+}
+
+/* ========================= BatchedMeshIndexing =========================== */
+
+void BatchedMeshIndexingImpl::exec(
+        _megdnn_tensor_in src, const IndexDesc& desc, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, desc);
+    if (!try_gather(handle(), src, desc, dst, true)) {
+        naive::BatchedMeshIndexingImpl::exec(src, desc, dst, workspace);
+    }
+}
+
+void BatchedIncrMeshIndexingImpl::exec(
+        _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+        _megdnn_workspace workspace) {
+    check_exec(data.layout, value.layout, desc);
+    if (!try_incr(handle(), data, value, desc, true)) {
+        naive::BatchedIncrMeshIndexingImpl::exec(data, value, desc, workspace);
+    }
+}
+
+void BatchedSetMeshIndexingImpl::exec(
+        _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+        _megdnn_workspace workspace) {
+    check_exec(data.layout, value.layout, desc);
+    if (!try_set(handle(), data, value, desc, true)) {
+        naive::BatchedSetMeshIndexingImpl::exec(data, value, desc, workspace);
+    }
+}
+
+// vim: syntax=cpp.doxygen
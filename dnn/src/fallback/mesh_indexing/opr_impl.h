@@ -0,0 +1,81 @@
+/**
+ * \file dnn/src/fallback/mesh_indexing/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/naive/mesh_indexing/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * The mesh indexings on a single axis whose data rows after the indexed axis
+ * are contiguous, such as row gathers, are processed row by row on multiple
+ * threads; the others are left to the naive impls.
+ */
+class MeshIndexingImpl : public naive::MeshIndexingImpl {
+public:
+    using naive::MeshIndexingImpl::MeshIndexingImpl;
+
+    void exec(
+            _megdnn_tensor_in src, const IndexDesc& desc, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+};
+
+class IncrMeshIndexingImpl : public naive::IncrMeshIndexingImpl {
+public:
+    using naive::IncrMeshIndexingImpl::IncrMeshIndexingImpl;
+
+    void exec(
+            _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+            _megdnn_workspace workspace) override;
+};
+
+class SetMeshIndexingImpl : public naive::SetMeshIndexingImpl {
+public:
+    using naive::SetMeshIndexingImpl::SetMeshIndexingImpl;
+
+    void exec(
+            _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+            _megdnn_workspace workspace) override;
+};
+
+class BatchedMeshIndexingImpl : public naive::BatchedMeshIndexingImpl {
+public:
+    using naive::BatchedMeshIndexingImpl::BatchedMeshIndexingImpl;
+
+    void exec(
+            _megdnn_tensor_in src, const IndexDesc& desc, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+};
+
+class BatchedIncrMeshIndexingImpl : public naive::BatchedIncrMeshIndexingImpl {
+public:
+    using naive::BatchedIncrMeshIndexingImpl::BatchedIncrMeshIndexingImpl;
+
+    void exec(
+            _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+            _megdnn_workspace workspace) override;
+};
+
+class BatchedSetMeshIndexingImpl : public naive::BatchedSetMeshIndexingImpl {
+public:
+    using naive::BatchedSetMeshIndexingImpl::BatchedSetMeshIndexingImpl;
+
+    void exec(
+            _megdnn_tensor_inout data, _megdnn_tensor_in value, const IndexDesc& desc,
+            _megdnn_workspace workspace) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
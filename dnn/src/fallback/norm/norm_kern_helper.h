@@ -0,0 +1,198 @@
+/**
+ * \file dnn/src/fallback/norm/norm_kern_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+//! this file is included by the norm kernels of each arch after
+//! MEGDNN_SIMD_VEC_TARGET is set, Vec must provide the following:
+//! type, width, load, store, set1, add, sub, mul and fmadd
+
+#include <cmath>
+#include <cstddef>
+
+namespace megdnn {
+namespace norm {
+namespace {
+
+//! statistics of n elements, where m2 is the sum of squared deviations
+struct Stats {
+    size_t n;
+    float mean, m2;
+};
+
+//! combine the statistics of two disjoint sets (Chan et al.)
+static inline Stats merge_stats(const Stats& a, const Stats& b) {
+    size_t n = a.n + b.n;
+    if (!n) {
+        return a;
+    }
+    float delta = b.mean - a.mean, ratio = static_cast<float>(b.n) / n;
+    return {n, a.mean + delta * ratio, a.m2 + b.m2 + delta * delta * a.n * ratio};
+}
+
+//! one Welford step of each lane, where rk is 1 / (number of steps)
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void welford_step(
+        typename Vec::type x, typename Vec::type rk, typename Vec::type& mean,
+        typename Vec::type& m2) {
+    auto delta = Vec::sub(x, mean);
+    mean = Vec::fmadd(delta, rk, mean);
+    m2 = Vec::fmadd(delta, Vec::sub(x, mean), m2);
+}
+
+//! merge the lane statistics of two vectors with equal counts k
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void merge_equal(
+        typename Vec::type& mean0, typename Vec::type& m20,
+        typename Vec::type mean1, typename Vec::type m21, float k) {
+    auto delta = Vec::sub(mean1, mean0);
+    auto half = Vec::set1(0.5f);
+    m20 = Vec::fmadd(Vec::mul(delta, delta), Vec::set1(k * 0.5f), Vec::add(m20, m21));
+    mean0 = Vec::fmadd(delta, half, mean0);
+}
+
+/*!
+ * compute the mean and the variance of n elements in a single pass over src
+ *
+ * Four vectors of independent Welford states are updated per step to hide
+ * the latency of the dependency chain, and they are merged when done.
+ */
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void welford(
+        const float* src, size_t n, float& mean, float& var) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    Stats res{0, 0.f, 0.f};
+    size_t i = 0;
+    if (n >= 4 * W) {
+        vtype zero = Vec::set1(0.f);
+        vtype m0 = zero, m1 = zero, m2 = zero, m3 = zero;
+        vtype q0 = zero, q1 = zero, q2 = zero, q3 = zero;
+        size_t k = 0;
+        for (; i + 4 * W <= n; i += 4 * W) {
+            ++k;
+            vtype rk = Vec::set1(1.f / k);
+            welford_step<Vec>(Vec::load(src + i), rk, m0, q0);
+            welford_step<Vec>(Vec::load(src + i + W), rk, m1, q1);
+            welford_step<Vec>(Vec::load(src + i + 2 * W), rk, m2, q2);
+            welford_step<Vec>(Vec::load(src + i + 3 * W), rk, m3, q3);
+        }
+        merge_equal<Vec>(m0, q0, m1, q1, k);
+        merge_equal<Vec>(m2, q2, m3, q3, k);
+        merge_equal<Vec>(m0, q0, m2, q2, 2 * k);
+        float lane_mean[W], lane_m2[W];
+        Vec::store(lane_mean, m0);
+        Vec::store(lane_m2, q0);
+        for (size_t j = 0; j < W; ++j) {
+            res = merge_stats(res, {4 * k, lane_mean[j], lane_m2[j]});
+        }
+    }
+    for (; i < n; ++i) {
+        ++res.n;
+        float delta = src[i] - res.mean;
+        res.mean += delta / res.n;
+        res.m2 += delta * (src[i] - res.mean);
+    }
+    mean = res.mean;
+    var = res.n ? res.m2 / res.n : 0.f;
+}
+
+//! dst = (src - mean) * scale + shift
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void normalize(
+        const float* src, float* dst, size_t n, float mean, float scale,
+        float shift) {
+    constexpr size_t W = Vec::width;
+    auto vmean = Vec::set1(mean), vscale = Vec::set1(scale),
+         vshift = Vec::set1(shift);
+    size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W) {
+        auto x0 = Vec::sub(Vec::load(src + i), vmean),
+             x1 = Vec::sub(Vec::load(src + i + W), vmean);
+        Vec::store(dst + i, Vec::fmadd(x0, vscale, vshift));
+        Vec::store(dst + i + W, Vec::fmadd(x1, vscale, vshift));
+    }
+    for (; i + W <= n; i += W) {
+        auto x = Vec::sub(Vec::load(src + i), vmean);
+        Vec::store(dst + i, Vec::fmadd(x, vscale, vshift));
+    }
+    for (; i < n; ++i) {
+        dst[i] = (src[i] - mean) * scale + shift;
+    }
+}
+
+//! dst = (src - mean) * rstd * weight + bias
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void normalize_affine(
+        const float* src, const float* weight, const float* bias, float* dst,
+        size_t n, float mean, float rstd) {
+    constexpr size_t W = Vec::width;
+    auto vmean = Vec::set1(mean), vrstd = Vec::set1(rstd);
+    size_t i = 0;
+    for (; i + W <= n; i += W) {
+        auto x = Vec::mul(Vec::sub(Vec::load(src + i), vmean), vrstd);
+        Vec::store(
+                dst + i, Vec::fmadd(x, Vec::load(weight + i), Vec::load(bias + i)));
+    }
+    for (; i < n; ++i) {
+        dst[i] = (src[i] - mean) * rstd * weight[i] + bias[i];
+    }
+}
+
+//! weight and bias are of row_size elements, or null if not affine
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void layer_norm(
+        const float* src, const float* weight, const float* bias, float* dst,
+        size_t nr_row, size_t row_size, float eps) {
+    for (size_t row = 0; row < nr_row; ++row) {
+        const float* sptr = src + row * row_size;
+        float* dptr = dst + row * row_size;
+        float mean, var;
+        welford<Vec>(sptr, row_size, mean, var);
+        float rstd = 1.f / std::sqrt(var + eps);
+        if (weight) {
+            normalize_affine<Vec>(sptr, weight, bias, dptr, row_size, mean, rstd);
+        } else {
+            normalize<Vec>(sptr, dptr, row_size, mean, rstd, 0.f);
+        }
+    }
+}
+
+/*!
+ * normalize the rows [row_begin, row_end) of (N * group) rows, where each row
+ * is a group of channel_per_group channels of HW elements; weight and bias
+ * are of group * channel_per_group elements, or null if not affine
+ */
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void group_norm(
+        const float* src, const float* weight, const float* bias, float* dst,
+        size_t row_begin, size_t row_end, size_t group, size_t channel_per_group,
+        size_t HW, float eps) {
+    size_t row_size = channel_per_group * HW;
+    for (size_t row = row_begin; row < row_end; ++row) {
+        const float* sptr = src + row * row_size;
+        float* dptr = dst + row * row_size;
+        float mean, var;
+        welford<Vec>(sptr, row_size, mean, var);
+        float rstd = 1.f / std::sqrt(var + eps);
+        size_t c0 = row % group * channel_per_group;
+        for (size_t c = 0; c < channel_per_group; ++c) {
+            //! fold the channelwise weight into the scale
+            float scale = weight ? rstd * weight[c0 + c] : rstd;
+            float shift = weight ? bias[c0 + c] : 0.f;
+            normalize<Vec>(sptr + c * HW, dptr + c * HW, HW, mean, scale, shift);
+        }
+    }
+}
+
+}  // anonymous namespace
+}  // namespace norm
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
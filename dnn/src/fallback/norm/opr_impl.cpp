@@ -0,0 +1,126 @@
+/**
+ * \file dnn/src/fallback/norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/norm/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_norm)
+
+#define MEGDNN_SIMD_VEC_TARGET
+
+namespace {
+//! plain float as a vector of width 1
+struct VecScalar {
+    using type = float;
+    static constexpr size_t width = 1;
+    static type load(const float* p) { return *p; }
+    static void store(float* p, type v) { *p = v; }
+    static type set1(float v) { return v; }
+    static type add(type a, type b) { return a + b; }
+    static type sub(type a, type b) { return a - b; }
+    static type mul(type a, type b) { return a * b; }
+    static type fmadd(type a, type b, type c) { return a * b + c; }
+};
+}  // anonymous namespace
+
+#include "src/fallback/norm/norm_kern_helper.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+//! do not split the computation into tasks smaller than this number of floats
+constexpr size_t MIN_TASK_SIZE = 16384;
+
+//! get the number of tasks to split nr_row rows of row_size elements into
+size_t get_nr_task(Handle* handle, size_t nr_row, size_t row_size) {
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle)
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    size_t nr_task =
+            std::min(nr_row, std::max<size_t>(1, nr_row * row_size / MIN_TASK_SIZE));
+    return std::min(nr_task, nr_threads);
+}
+}  // anonymous namespace
+
+fallback::norm::Kern fallback::norm::get_default_kern() {
+    return {megdnn::norm::layer_norm<VecScalar>, megdnn::norm::group_norm<VecScalar>};
+}
+
+void LayerNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(data.layout, weight.layout, bias.layout, dst.layout, workspace.size);
+    if (data.layout.dtype != dtype::Float32() || data.layout.is_empty()) {
+        return naive::LayerNormForwardImpl::exec(data, weight, bias, dst, workspace);
+    }
+    MIDOUT_BEGIN(megdnn_fallback_norm, midout_iv(0)) {
+        size_t nr_row, row_size;
+        get_row_size(data.layout, nr_row, row_size);
+        const float* sptr = data.ptr<dt_float32>();
+        const float* wptr = param().affine ? weight.ptr<dt_float32>() : nullptr;
+        const float* bptr = param().affine ? bias.ptr<dt_float32>() : nullptr;
+        float* dptr = dst.ptr<dt_float32>();
+        float eps = param().eps;
+        size_t nr_task = get_nr_task(handle(), nr_row, row_size);
+        size_t nr_row_per_task = div_ceil(nr_row, nr_task);
+        nr_task = div_ceil(nr_row, nr_row_per_task);
+        auto kern = get_kern().layer_norm;
+        auto run = [=](size_t index, size_t) {
+            size_t begin = index * nr_row_per_task;
+            size_t end = std::min(nr_row, begin + nr_row_per_task);
+            kern(sptr + begin * row_size, wptr, bptr, dptr + begin * row_size,
+                 end - begin, row_size, eps);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, nr_task);
+        return;
+    }
+    MIDOUT_END();
+}
+
+void GroupNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(data.layout, weight.layout, bias.layout, dst.layout, workspace.size);
+    if (data.layout.dtype != dtype::Float32() || data.layout.is_empty()) {
+        return naive::GroupNormForwardImpl::exec(data, weight, bias, dst, workspace);
+    }
+    MIDOUT_BEGIN(megdnn_fallback_norm, midout_iv(1)) {
+        size_t N = data.layout[0], C = data.layout[1];
+        size_t HW = data.layout.total_nr_elems() / (N * C);
+        size_t group = param().group, channel_per_group = C / group;
+        size_t nr_row = N * group;
+        const float* sptr = data.ptr<dt_float32>();
+        const float* wptr = param().affine ? weight.ptr<dt_float32>() : nullptr;
+        const float* bptr = param().affine ? bias.ptr<dt_float32>() : nullptr;
+        float* dptr = dst.ptr<dt_float32>();
+        float eps = param().eps;
+        size_t nr_task = get_nr_task(handle(), nr_row, channel_per_group * HW);
+        size_t nr_row_per_task = div_ceil(nr_row, nr_task);
+        nr_task = div_ceil(nr_row, nr_row_per_task);
+        auto kern = get_kern().group_norm;
+        auto run = [=](size_t index, size_t) {
+            size_t begin = index * nr_row_per_task;
+            size_t end = std::min(nr_row, begin + nr_row_per_task);
+            kern(sptr, wptr, bptr, dptr, begin, end, group, channel_per_group, HW,
+                 eps);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, nr_task);
+        return;
+    }
+    MIDOUT_END();
+}
+
+// vim: syntax=cpp.doxygen
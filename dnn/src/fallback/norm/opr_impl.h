@@ -0,0 +1,66 @@
+/**
+ * \file dnn/src/fallback/norm/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/naive/norm/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+namespace norm {
+
+/*!
+ * \brief float32 kernels shared by layer norm and group norm
+ *
+ * weight and bias are null if the norm is not affine; see
+ * src/fallback/norm/norm_kern_helper.h for the meaning of the other params
+ */
+struct Kern {
+    void (*layer_norm)(
+            const float* src, const float* weight, const float* bias, float* dst,
+            size_t nr_row, size_t row_size, float eps);
+    void (*group_norm)(
+            const float* src, const float* weight, const float* bias, float* dst,
+            size_t row_begin, size_t row_end, size_t group, size_t channel_per_group,
+            size_t HW, float eps);
+};
+
+//! get the scalar kernels
+Kern get_default_kern();
+
+}  // namespace norm
+
+class LayerNormForwardImpl : public naive::LayerNormForwardImpl {
+public:
+    using naive::LayerNormForwardImpl::LayerNormForwardImpl;
+    void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+
+protected:
+    //! get the float32 kernels; arch specific impls return their simd kernels
+    virtual norm::Kern get_kern() const { return norm::get_default_kern(); }
+};
+
+class GroupNormForwardImpl : public naive::GroupNormForwardImpl {
+public:
+    using naive::GroupNormForwardImpl::GroupNormForwardImpl;
+    void exec(
+            _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+
+protected:
+    virtual norm::Kern get_kern() const { return norm::get_default_kern(); }
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,297 @@
+/**
+ * \file dnn/src/fallback/rnn/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/rnn/opr_impl.h"
+
+#include "src/common/opr_delegate.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_rnn)
+
+#define MEGDNN_SIMD_VEC_TARGET
+
+#include "src/fallback/rnn/rnn_kern_helper.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+/*!
+ * The input projections of all the time steps of a direction are computed by
+ * one matrix multiplication split by rows to the threads, and then each time
+ * step is a multi-thread dispatch over the rows and the blocks of hidden units,
+ * whose kernel computes the hidden projection and applies the gates in place.
+ * The hidden states of adjacent steps are kept in two buffers, so that the
+ * tasks of a step only write their own units.
+ */
+class RNNExecutor {
+    naive::HandleImpl* m_handle;
+    const RNNBase::Param m_param;
+    size_t T, N, I, H, L, D, G;
+    size_t m_nr_threads, m_nr_proj_task, m_nr_proj_row;
+
+    //! the matmul computing the input projection, gx = src * w_ih^T
+    static std::unique_ptr<MatrixMul> make_matmul() {
+        auto opr = inplace_cpu_handle()->create_operator<MatrixMul>();
+        opr->param().transposeB = true;
+        return opr;
+    }
+
+    TensorLayout proj_layout(size_t M, size_t K) const {
+        return {{M, K}, dtype::Float32()};
+    }
+
+    size_t get_matmul_workspace() const {
+        auto opr = make_matmul();
+        size_t ws = 0, GH = G * H;
+        size_t last_row = T * N - (m_nr_proj_task - 1) * m_nr_proj_row;
+        for (size_t K : {I, D * H}) {
+            for (size_t M : {m_nr_proj_row, last_row}) {
+                ws = std::max(
+                        ws, opr->get_workspace_in_bytes(
+                                    proj_layout(M, K), proj_layout(GH, K),
+                                    proj_layout(M, GH)));
+            }
+        }
+        //! keep the workspace of each task aligned
+        return round_up<size_t>(ws, 64);
+    }
+
+public:
+    RNNExecutor(
+            naive::HandleImpl* handle, const RNNBase::Param& param, size_t nr_gate,
+            const TensorLayout& input, const TensorLayout& hx)
+            : m_handle{handle},
+              m_param{param},
+              T{input[0]},
+              N{input[1]},
+              I{input[2]},
+              H{hx[2]},
+              L{param.num_layers},
+              D{param.bidirectional ? size_t(2) : size_t(1)},
+              G{nr_gate} {
+        m_nr_threads = handle->megcore_dispatcher()->nr_threads();
+        m_nr_proj_task = std::min(T * N, m_nr_threads);
+        m_nr_proj_row = div_ceil(T * N, m_nr_proj_task);
+        m_nr_proj_task = div_ceil(T * N, m_nr_proj_row);
+    }
+
+    //! the input projection, two hidden state buffers, the outputs of the
+    //! hidden layers, and the matmul workspace of each projection task
+    WorkspaceBundle get_bundle(void* ptr = nullptr) const {
+        size_t layer_out = T * N * D * H * sizeof(float);
+        return {ptr,
+                {T * N * G * H * sizeof(float), 2 * N * H * sizeof(float),
+                 L > 1 ? layer_out : 0, L > 2 ? layer_out : 0,
+                 get_matmul_workspace() * m_nr_proj_task}};
+    }
+
+    //! cx and cy are null for GRU
+    void exec(
+            const float* input, const int* seq_len, const float* hx, const float* cx,
+            const float* weights, float* output, float* hy, float* cy,
+            fallback::rnn::StepKern kern, void* workspace) const;
+};
+
+void RNNExecutor::exec(
+        const float* input, const int* seq_len, const float* hx, const float* cx,
+        const float* weights, float* output, float* hy, float* cy,
+        fallback::rnn::StepKern kern, void* workspace) const {
+    auto handle = m_handle;
+    auto bundle = get_bundle(workspace);
+    float* gx = static_cast<float*>(bundle.get(0));
+    float* hbuf = static_cast<float*>(bundle.get(1));
+    float* layer_bufs[2] = {
+            static_cast<float*>(bundle.get(2)), static_cast<float*>(bundle.get(3))};
+    dt_byte* matmul_ws = static_cast<dt_byte*>(bundle.get(4));
+    size_t matmul_ws_size = bundle.get_size(4) / m_nr_proj_task;
+    size_t nr_weight;
+    auto offsets = RNNBase::get_weight_offsets(m_param, G, I, H, nr_weight);
+
+    //! the tasks of a step split the units into nr_htask ranges of whole
+    //! blocks and the rows into nr_rtask ranges
+    size_t nr_hblk = div_ceil(H, megdnn::rnn::HIDDEN_BLOCK);
+    size_t nr_htask = std::min(nr_hblk, m_nr_threads);
+    size_t nr_hblk_per_task = div_ceil(nr_hblk, nr_htask);
+    nr_htask = div_ceil(nr_hblk, nr_hblk_per_task);
+    size_t nr_rtask = std::min(N, std::max<size_t>(1, m_nr_threads / nr_htask));
+    size_t nr_row_per_task = div_ceil(N, nr_rtask);
+    nr_rtask = div_ceil(N, nr_row_per_task);
+
+    size_t T_ = T, N_ = N, H_ = H, G_ = G;
+    size_t nr_proj_row = m_nr_proj_row, nr_proj_task = m_nr_proj_task;
+    const float* src = input;
+    for (size_t layer = 0; layer < L; ++layer) {
+        size_t K = layer ? D * H : I;
+        float* dst = layer + 1 == L ? output : layer_bufs[layer % 2];
+        for (size_t d = 0; d < D; ++d) {
+            auto&& off = offsets[layer * D + d];
+            const float* w_ih = weights + off.w_ih;
+            size_t state = (layer * D + d) * N * H;
+            auto proj = [=](size_t index, size_t) {
+                size_t begin = index * nr_proj_row;
+                size_t M = std::min(T_ * N_ - begin, nr_proj_row);
+                auto opr = make_matmul();
+                TensorND A{const_cast<float*>(src + begin * K),
+                           {{M, K}, dtype::Float32()}},
+                        B{const_cast<float*>(w_ih), {{G_ * H_, K}, dtype::Float32()}},
+                        C{gx + begin * G_ * H_, {{M, G_ * H_}, dtype::Float32()}};
+                opr->exec(
+                        A, B, C,
+                        {matmul_ws + index * matmul_ws_size, matmul_ws_size});
+            };
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(handle, nr_proj_task, proj);
+            auto init = [=]() {
+                std::copy(hx + state, hx + state + N_ * H_, hbuf);
+                if (cx) {
+                    std::copy(cx + state, cx + state + N_ * H_, cy + state);
+                }
+            };
+            MEGDNN_DISPATCH_CPU_KERN(handle, init());
+            fallback::rnn::StepParam base{
+                    nullptr,
+                    weights + off.w_hh,
+                    m_param.bias ? weights + off.b_ih : nullptr,
+                    m_param.bias ? weights + off.b_hh : nullptr,
+                    nullptr,
+                    nullptr,
+                    cy ? cy + state : nullptr,
+                    nullptr,
+                    seq_len,
+                    0,
+                    N,
+                    H,
+                    D * H};
+            for (size_t step = 0; step < T; ++step) {
+                size_t t = d ? T - 1 - step : step;
+                auto p = base;
+                p.gx = gx + t * N * G * H;
+                p.h_prev = hbuf + step % 2 * N * H;
+                p.h = hbuf + (step + 1) % 2 * N * H;
+                p.out = dst + t * N * D * H + d * H;
+                p.t = t;
+                auto run = [=](size_t index, size_t) {
+                    size_t r = index / nr_htask, h = index % nr_htask;
+                    size_t row_begin = r * nr_row_per_task;
+                    size_t row_end = std::min(N_, row_begin + nr_row_per_task);
+                    size_t begin = h * nr_hblk_per_task * megdnn::rnn::HIDDEN_BLOCK;
+                    size_t end = std::min(
+                            H_, begin + nr_hblk_per_task * megdnn::rnn::HIDDEN_BLOCK);
+                    kern(p, row_begin, row_end, begin, end);
+                };
+                MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+                        handle, nr_rtask * nr_htask, run);
+            }
+            const float* h_last = hbuf + T % 2 * N * H;
+            MEGDNN_DISPATCH_CPU_KERN(
+                    handle, std::copy(h_last, h_last + N_ * H_, hy + state));
+        }
+        src = dst;
+    }
+}
+
+}  // anonymous namespace
+
+fallback::rnn::StepKern fallback::rnn::get_default_lstm_kern() {
+    return megdnn::rnn::step<megdnn::rnn::Scalar, true>;
+}
+
+fallback::rnn::StepKern fallback::rnn::get_default_gru_kern() {
+    return megdnn::rnn::step<megdnn::rnn::Scalar, false>;
+}
+
+void LSTMForwardImpl::exec(
+        _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+        _megdnn_tensor_in cx, _megdnn_tensor_in flatten_weights,
+        _megdnn_tensor_out output, _megdnn_tensor_out hy, _megdnn_tensor_out cy,
+        _megdnn_workspace workspace) {
+    check_exec(
+            input.layout, seq_len.layout, hx.layout, cx.layout, flatten_weights.layout,
+            output.layout, hy.layout, cy.layout, workspace.size);
+    if (input.layout.dtype != dtype::Float32() || output.layout.is_empty()) {
+        return naive::LSTMForwardImpl::exec(
+                input, seq_len, hx, cx, flatten_weights, output, hy, cy, workspace);
+    }
+    MIDOUT_BEGIN(megdnn_fallback_rnn, midout_iv(0)) {
+        RNNExecutor executor{
+                static_cast<naive::HandleImpl*>(handle()), param(), NR_GATE,
+                input.layout, hx.layout};
+        executor.exec(
+                input.ptr<dt_float32>(),
+                seq_len.layout.ndim ? seq_len.ptr<dt_int32>() : nullptr,
+                hx.ptr<dt_float32>(), cx.ptr<dt_float32>(),
+                flatten_weights.ptr<dt_float32>(), output.ptr<dt_float32>(),
+                hy.ptr<dt_float32>(), cy.ptr<dt_float32>(), get_kern(),
+                workspace.raw_ptr);
+        return;
+    }
+    MIDOUT_END();
+}
+
+size_t LSTMForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& input, const TensorLayout& seq_len, const TensorLayout& hx,
+        const TensorLayout& cx, const TensorLayout& flatten_weights,
+        const TensorLayout& output, const TensorLayout& hy, const TensorLayout& cy) {
+    if (input.dtype != dtype::Float32() || output.is_empty()) {
+        return naive::LSTMForwardImpl::get_workspace_in_bytes(
+                input, seq_len, hx, cx, flatten_weights, output, hy, cy);
+    }
+    return RNNExecutor{
+            static_cast<naive::HandleImpl*>(handle()), param(), NR_GATE, input, hx}
+            .get_bundle()
+            .total_size_in_bytes();
+}
+
+void GRUForwardImpl::exec(
+        _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+        _megdnn_tensor_in flatten_weights, _megdnn_tensor_out output,
+        _megdnn_tensor_out hy, _megdnn_workspace workspace) {
+    check_exec(
+            input.layout, seq_len.layout, hx.layout, flatten_weights.layout,
+            output.layout, hy.layout, workspace.size);
+    if (input.layout.dtype != dtype::Float32() || output.layout.is_empty()) {
+        return naive::GRUForwardImpl::exec(
+                input, seq_len, hx, flatten_weights, output, hy, workspace);
+    }
+    MIDOUT_BEGIN(megdnn_fallback_rnn, midout_iv(1)) {
+        RNNExecutor executor{
+                static_cast<naive::HandleImpl*>(handle()), param(), NR_GATE,
+                input.layout, hx.layout};
+        executor.exec(
+                input.ptr<dt_float32>(),
+                seq_len.layout.ndim ? seq_len.ptr<dt_int32>() : nullptr,
+                hx.ptr<dt_float32>(), nullptr, flatten_weights.ptr<dt_float32>(),
+                output.ptr<dt_float32>(), hy.ptr<dt_float32>(), nullptr, get_kern(),
+                workspace.raw_ptr);
+        return;
+    }
+    MIDOUT_END();
+}
+
+size_t GRUForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& input, const TensorLayout& seq_len, const TensorLayout& hx,
+        const TensorLayout& flatten_weights, const TensorLayout& output,
+        const TensorLayout& hy) {
+    if (input.dtype != dtype::Float32() || output.is_empty()) {
+        return naive::GRUForwardImpl::get_workspace_in_bytes(
+                input, seq_len, hx, flatten_weights, output, hy);
+    }
+    return RNNExecutor{
+            static_cast<naive::HandleImpl*>(handle()), param(), NR_GATE, input, hx}
+            .get_bundle()
+            .total_size_in_bytes();
+}
+
+// vim: syntax=cpp.doxygen
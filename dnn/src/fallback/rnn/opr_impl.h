@@ -0,0 +1,85 @@
+/**
+ * \file dnn/src/fallback/rnn/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/naive/rnn/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+namespace rnn {
+
+/*!
+ * \brief one time step of a direction of a layer in float32
+ *
+ * The pre-activations of the gates are gx + b_ih + h_prev * w_hh^T + b_hh,
+ * where gx of shape (N, G * H) is the input projection of the step, except
+ * that b_hh of the new gate of GRU is added before multiplied by the reset
+ * gate. The biases are null if absent, and c is null for GRU.
+ *
+ * The rows whose sequences end before t keep h_prev, and output zeros.
+ */
+struct StepParam {
+    const float *gx, *w_hh, *b_ih, *b_hh, *h_prev;
+    float *h, *c, *out;
+    const int* seq_len;
+    size_t t, N, H, out_stride;
+};
+
+//! compute the hidden units [begin, end) of the rows [row_begin, row_end)
+using StepKern = void (*)(
+        const StepParam& param, size_t row_begin, size_t row_end, size_t begin,
+        size_t end);
+
+//! get the scalar kernels
+StepKern get_default_lstm_kern();
+StepKern get_default_gru_kern();
+
+}  // namespace rnn
+
+class LSTMForwardImpl : public naive::LSTMForwardImpl {
+public:
+    using naive::LSTMForwardImpl::LSTMForwardImpl;
+    void exec(
+            _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+            _megdnn_tensor_in cx, _megdnn_tensor_in flatten_weights,
+            _megdnn_tensor_out output, _megdnn_tensor_out hy, _megdnn_tensor_out cy,
+            _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& cx,
+            const TensorLayout& flatten_weights, const TensorLayout& output,
+            const TensorLayout& hy, const TensorLayout& cy) override;
+
+protected:
+    //! get the float32 kernel; arch specific impls return their simd kernels
+    virtual rnn::StepKern get_kern() const { return rnn::get_default_lstm_kern(); }
+};
+
+class GRUForwardImpl : public naive::GRUForwardImpl {
+public:
+    using naive::GRUForwardImpl::GRUForwardImpl;
+    void exec(
+            _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+            _megdnn_tensor_in flatten_weights, _megdnn_tensor_out output,
+            _megdnn_tensor_out hy, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& input, const TensorLayout& seq_len,
+            const TensorLayout& hx, const TensorLayout& flatten_weights,
+            const TensorLayout& output, const TensorLayout& hy) override;
+
+protected:
+    virtual rnn::StepKern get_kern() const { return rnn::get_default_gru_kern(); }
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,218 @@
+/**
+ * \file dnn/src/fallback/rnn/rnn_kern_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+//! this file is included by the rnn kernels of each arch after
+//! MEGDNN_SIMD_VEC_TARGET is set, Vec must provide the following:
+//! type, width, load, store, set1, add, sub, mul, div, fmadd, exp and
+//! reduce_add
+
+#include "src/fallback/rnn/opr_impl.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace megdnn {
+namespace rnn {
+namespace {
+
+//! number of hidden units whose gates are computed together
+constexpr size_t HIDDEN_BLOCK = 16;
+
+//! plain float as a vector of width 1, used for the tails
+struct Scalar {
+    using type = float;
+    static constexpr size_t width = 1;
+    static type load(const float* p) { return *p; }
+    static void store(float* p, type v) { *p = v; }
+    static type set1(float v) { return v; }
+    static type add(type a, type b) { return a + b; }
+    static type sub(type a, type b) { return a - b; }
+    static type mul(type a, type b) { return a * b; }
+    static type div(type a, type b) { return a / b; }
+    static type fmadd(type a, type b, type c) { return a * b + c; }
+    static type exp(type v) { return std::exp(v); }
+    static float reduce_add(type v) { return v; }
+};
+
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET typename Vec::type sigmoid(typename Vec::type x) {
+    auto one = Vec::set1(1.f);
+    return Vec::div(one, Vec::add(one, Vec::exp(Vec::sub(Vec::set1(0.f), x))));
+}
+
+//! tanh(x) = 1 - 2 / (1 + exp(2x)), which saturates correctly as exp is clamped
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET typename Vec::type tanh(typename Vec::type x) {
+    auto one = Vec::set1(1.f);
+    auto e = Vec::exp(Vec::add(x, x));
+    return Vec::sub(one, Vec::div(Vec::set1(2.f), Vec::add(one, e)));
+}
+
+//! s[j] = dot(h, w_j) for the n rows of w
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void dot_rows(
+        const float* h, const float* w, size_t n, size_t H, float* s) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const float* w0 = w + j * H;
+        const float *w1 = w0 + H, *w2 = w1 + H, *w3 = w2 + H;
+        vtype a0 = Vec::set1(0.f), a1 = a0, a2 = a0, a3 = a0;
+        size_t k = 0;
+        for (; k + W <= H; k += W) {
+            vtype x = Vec::load(h + k);
+            a0 = Vec::fmadd(x, Vec::load(w0 + k), a0);
+            a1 = Vec::fmadd(x, Vec::load(w1 + k), a1);
+            a2 = Vec::fmadd(x, Vec::load(w2 + k), a2);
+            a3 = Vec::fmadd(x, Vec::load(w3 + k), a3);
+        }
+        float r0 = Vec::reduce_add(a0), r1 = Vec::reduce_add(a1),
+              r2 = Vec::reduce_add(a2), r3 = Vec::reduce_add(a3);
+        for (; k < H; ++k) {
+            r0 += h[k] * w0[k];
+            r1 += h[k] * w1[k];
+            r2 += h[k] * w2[k];
+            r3 += h[k] * w3[k];
+        }
+        s[j] = r0;
+        s[j + 1] = r1;
+        s[j + 2] = r2;
+        s[j + 3] = r3;
+    }
+    for (; j < n; ++j) {
+        const float* wj = w + j * H;
+        vtype a0 = Vec::set1(0.f);
+        size_t k = 0;
+        for (; k + W <= H; k += W) {
+            a0 = Vec::fmadd(Vec::load(h + k), Vec::load(wj + k), a0);
+        }
+        float r0 = Vec::reduce_add(a0);
+        for (; k < H; ++k) {
+            r0 += h[k] * wj[k];
+        }
+        s[j] = r0;
+    }
+}
+
+/*!
+ * the gates of a block of hidden units; gx and the biases point to the first
+ * unit of the block and their gates are H apart, while the gates of gh are
+ * HIDDEN_BLOCK apart
+ */
+struct GateArgs {
+    const float *gx, *gh, *b_ih, *b_hh, *h_prev;
+    float *h, *c, *out;
+    size_t H;
+};
+
+//! the pre-activation of gate g of the units [j, j + width)
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET typename Vec::type gate_input(
+        const GateArgs& a, size_t g, size_t j) {
+    auto x = Vec::add(
+            Vec::load(a.gx + g * a.H + j), Vec::load(a.gh + g * HIDDEN_BLOCK + j));
+    if (a.b_ih) {
+        x = Vec::add(x, Vec::load(a.b_ih + g * a.H + j));
+        x = Vec::add(x, Vec::load(a.b_hh + g * a.H + j));
+    }
+    return x;
+}
+
+//! update the units [begin, end) of the block by lstm gates
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void lstm_gates(const GateArgs& a, size_t begin, size_t end) {
+    constexpr size_t W = Vec::width;
+    for (size_t j = begin; j + W <= end; j += W) {
+        auto i = sigmoid<Vec>(gate_input<Vec>(a, 0, j));
+        auto f = sigmoid<Vec>(gate_input<Vec>(a, 1, j));
+        auto g = tanh<Vec>(gate_input<Vec>(a, 2, j));
+        auto o = sigmoid<Vec>(gate_input<Vec>(a, 3, j));
+        auto c = Vec::fmadd(f, Vec::load(a.c + j), Vec::mul(i, g));
+        auto h = Vec::mul(o, tanh<Vec>(c));
+        Vec::store(a.c + j, c);
+        Vec::store(a.h + j, h);
+        Vec::store(a.out + j, h);
+    }
+}
+
+//! update the units [begin, end) of the block by gru gates
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void gru_gates(const GateArgs& a, size_t begin, size_t end) {
+    constexpr size_t W = Vec::width;
+    for (size_t j = begin; j + W <= end; j += W) {
+        auto r = sigmoid<Vec>(gate_input<Vec>(a, 0, j));
+        auto z = sigmoid<Vec>(gate_input<Vec>(a, 1, j));
+        auto hn = Vec::load(a.gh + 2 * HIDDEN_BLOCK + j);
+        if (a.b_hh) {
+            hn = Vec::add(hn, Vec::load(a.b_hh + 2 * a.H + j));
+        }
+        auto x = Vec::load(a.gx + 2 * a.H + j);
+        if (a.b_ih) {
+            x = Vec::add(x, Vec::load(a.b_ih + 2 * a.H + j));
+        }
+        auto n = tanh<Vec>(Vec::fmadd(r, hn, x));
+        //! (1 - z) * n + z * h = n + z * (h - n)
+        auto h = Vec::fmadd(z, Vec::sub(Vec::load(a.h_prev + j), n), n);
+        Vec::store(a.h + j, h);
+        Vec::store(a.out + j, h);
+    }
+}
+
+template <class Vec, bool lstm>
+MEGDNN_SIMD_VEC_TARGET void step(
+        const fallback::rnn::StepParam& p, size_t row_begin, size_t row_end,
+        size_t begin, size_t end) {
+    constexpr size_t G = lstm ? 4 : 3, W = Vec::width;
+    float gh[G * HIDDEN_BLOCK];
+    const size_t H = p.H;
+    for (size_t n = row_begin; n < row_end; ++n) {
+        const float* h_prev = p.h_prev + n * H;
+        float* h = p.h + n * H;
+        float* out = p.out + n * p.out_stride;
+        if (p.seq_len && p.t >= static_cast<size_t>(p.seq_len[n])) {
+            std::copy(h_prev + begin, h_prev + end, h + begin);
+            std::fill(out + begin, out + end, 0.f);
+            continue;
+        }
+        for (size_t j0 = begin; j0 < end; j0 += HIDDEN_BLOCK) {
+            size_t nr_unit = std::min(HIDDEN_BLOCK, end - j0);
+            for (size_t g = 0; g < G; ++g) {
+                dot_rows<Vec>(
+                        h_prev, p.w_hh + (g * H + j0) * H, nr_unit, H,
+                        gh + g * HIDDEN_BLOCK);
+            }
+            GateArgs a{p.gx + n * G * H + j0,
+                       gh,
+                       p.b_ih ? p.b_ih + j0 : nullptr,
+                       p.b_hh ? p.b_hh + j0 : nullptr,
+                       h_prev + j0,
+                       h + j0,
+                       lstm ? p.c + n * H + j0 : nullptr,
+                       out + j0,
+                       H};
+            size_t nr_vec = nr_unit / W * W;
+            if (lstm) {
+                lstm_gates<Vec>(a, 0, nr_vec);
+                lstm_gates<Scalar>(a, nr_vec, nr_unit);
+            } else {
+                gru_gates<Vec>(a, 0, nr_vec);
+                gru_gates<Scalar>(a, nr_vec, nr_unit);
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+}  // namespace rnn
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,118 @@
+/**
+ * \file dnn/src/fallback/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/softmax/opr_impl.h"
+
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_softmax)
+
+#define MEGDNN_SIMD_VEC_TARGET
+
+namespace {
+//! plain float as a vector of width 1
+struct VecScalar {
+    using type = float;
+    static constexpr size_t width = 1;
+    static type load(const float* p) { return *p; }
+    static void store(float* p, type v) { *p = v; }
+    static type set1(float v) { return v; }
+    static type add(type a, type b) { return a + b; }
+    static type mul(type a, type b) { return a * b; }
+    static type max(type a, type b) { return std::max(a, b); }
+    static type exp(type v) { return std::exp(v); }
+    static float reduce_add(type v) { return v; }
+    static float reduce_max(type v) { return v; }
+};
+}  // anonymous namespace
+
+#include "src/fallback/softmax/softmax_kern_helper.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+//! do not split the computation into tasks smaller than this number of floats
+constexpr size_t MIN_TASK_SIZE = 16384;
+//! number of columns processed by one task when C > 1
+constexpr size_t C_BLOCK = 64;
+}  // anonymous namespace
+
+SoftmaxForwardImpl::Kern SoftmaxForwardImpl::get_kern() const {
+    return {softmax::softmax_c1<VecScalar>, softmax::softmax_strided<VecScalar>};
+}
+
+void SoftmaxForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+    if (src.layout.dtype != dtype::Float32() || src.layout.is_empty()) {
+        return naive::SoftmaxForwardImpl::exec(src, dst, workspace);
+    }
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, get_real_axis(src.layout));
+    const float* sptr = src.ptr<dt_float32>();
+    float* dptr = dst.ptr<dt_float32>();
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    auto kern = get_kern();
+    if (C == 1) {
+        MIDOUT_BEGIN(megdnn_fallback_softmax, midout_iv(0)) {
+            //! split the rows evenly to the threads
+            size_t nr_task = std::min(A, std::max<size_t>(1, A * B / MIN_TASK_SIZE));
+            nr_task = std::min(nr_task, nr_threads);
+            size_t nr_row_per_task = div_ceil(A, nr_task);
+            nr_task = div_ceil(A, nr_row_per_task);
+            auto c1 = kern.c1;
+            auto run = [=](size_t index, size_t) {
+                size_t begin = index * nr_row_per_task;
+                size_t end = std::min(A, begin + nr_row_per_task);
+                c1(sptr + begin * B, dptr + begin * B, end - begin, B);
+            };
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, nr_task);
+            return;
+        }
+        MIDOUT_END();
+    } else {
+        MIDOUT_BEGIN(megdnn_fallback_softmax, midout_iv(1)) {
+            //! the (A, C) plane is divided into blocks of C_BLOCK columns, and
+            //! each task processes a contiguous range of these blocks
+            size_t nr_cblk = div_ceil(C, C_BLOCK);
+            size_t nr_blk = A * nr_cblk;
+            size_t nr_task = std::min(
+                    nr_blk, std::max<size_t>(1, A * B * C / MIN_TASK_SIZE));
+            nr_task = std::min(nr_task, nr_threads);
+            size_t nr_blk_per_task = div_ceil(nr_blk, nr_task);
+            nr_task = div_ceil(nr_blk, nr_blk_per_task);
+            auto strided = kern.strided;
+            auto run = [=](size_t index, size_t) {
+                size_t begin = index * nr_blk_per_task;
+                size_t end = std::min(nr_blk, begin + nr_blk_per_task);
+                for (size_t blk = begin; blk < end; ++blk) {
+                    size_t a = blk / nr_cblk, c = blk % nr_cblk * C_BLOCK;
+                    size_t offset = a * B * C + c;
+                    strided(sptr + offset, dptr + offset, B, C,
+                            std::min(C_BLOCK, C - c));
+                }
+            };
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, nr_task);
+            return;
+        }
+        MIDOUT_END();
+    }
+    naive::SoftmaxForwardImpl::exec(src, dst, workspace);
+}
+
+// vim: syntax=cpp.doxygen
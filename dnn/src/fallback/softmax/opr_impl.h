@@ -0,0 +1,46 @@
+/**
+ * \file dnn/src/fallback/softmax/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/naive/softmax/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+class SoftmaxForwardImpl : public naive::SoftmaxForwardImpl {
+public:
+    using naive::SoftmaxForwardImpl::SoftmaxForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+
+    /*!
+     * \brief kernels of float32 softmax
+     *
+     * c1 computes nr_row contiguous rows of length B; strided computes the
+     * columns [0, nr_c) of a (B, C) plane along B, where src and dst point to
+     * the first column and the row stride is C
+     */
+    struct Kern {
+        void (*c1)(const float* src, float* dst, size_t nr_row, size_t B);
+        void (*strided)(
+                const float* src, float* dst, size_t B, size_t C, size_t nr_c);
+    };
+
+protected:
+    //! get the float32 kernels; arch specific impls return their simd kernels
+    virtual Kern get_kern() const;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,239 @@
+/**
+ * \file dnn/src/fallback/softmax/softmax_kern_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+//! this file is included by the softmax kernels of each arch after
+//! MEGDNN_SIMD_VEC_TARGET is set, Vec must provide the following:
+//! type, width, load, store, set1, add, mul, max, exp, reduce_add and reduce_max
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+namespace megdnn {
+namespace softmax {
+namespace {
+
+/*!
+ * rows not longer than this are computed in three passes: max of src, exp
+ * stored in dst with its sum, and the scaling of dst, where dst is still in
+ * cache in the last pass. Longer rows are computed in two passes over src:
+ * the max and the sum are computed together by the online algorithm, which
+ * rescales the partial sum whenever the max grows, and the scaled exp is
+ * written in the second pass. It computes exp twice but never reads dst back.
+ */
+constexpr size_t MAX_CACHED_ROW = 16384;
+
+//! combine the running (max, sum) with x, where sum is of exp(x - max)
+static inline void online_update(float& max, float& sum, float x) {
+    float new_max = std::max(max, x);
+    sum = sum * std::exp(max - new_max) + std::exp(x - new_max);
+    max = new_max;
+}
+
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET float row_max(const float* src, size_t B) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    size_t b = 0;
+    float res = -FLT_MAX;
+    if (B >= W) {
+        vtype m0 = Vec::set1(-FLT_MAX), m1 = m0, m2 = m0, m3 = m0;
+        for (; b + 4 * W <= B; b += 4 * W) {
+            m0 = Vec::max(m0, Vec::load(src + b));
+            m1 = Vec::max(m1, Vec::load(src + b + W));
+            m2 = Vec::max(m2, Vec::load(src + b + 2 * W));
+            m3 = Vec::max(m3, Vec::load(src + b + 3 * W));
+        }
+        for (; b + W <= B; b += W) {
+            m0 = Vec::max(m0, Vec::load(src + b));
+        }
+        res = Vec::reduce_max(Vec::max(Vec::max(m0, m1), Vec::max(m2, m3)));
+    }
+    for (; b < B; ++b) {
+        res = std::max(res, src[b]);
+    }
+    return res;
+}
+
+//! dst = exp(src - max), return the sum of dst
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET float exp_store_sum(
+        const float* src, float* dst, size_t B, float max) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    const vtype neg_max = Vec::set1(-max);
+    vtype s0 = Vec::set1(0.f), s1 = s0;
+    size_t b = 0;
+    for (; b + 2 * W <= B; b += 2 * W) {
+        vtype e0 = Vec::exp(Vec::add(Vec::load(src + b), neg_max));
+        vtype e1 = Vec::exp(Vec::add(Vec::load(src + b + W), neg_max));
+        Vec::store(dst + b, e0);
+        Vec::store(dst + b + W, e1);
+        s0 = Vec::add(s0, e0);
+        s1 = Vec::add(s1, e1);
+    }
+    for (; b + W <= B; b += W) {
+        vtype e0 = Vec::exp(Vec::add(Vec::load(src + b), neg_max));
+        Vec::store(dst + b, e0);
+        s0 = Vec::add(s0, e0);
+    }
+    float sum = Vec::reduce_add(Vec::add(s0, s1));
+    for (; b < B; ++b) {
+        dst[b] = std::exp(src[b] - max);
+        sum += dst[b];
+    }
+    return sum;
+}
+
+//! dst = dst * scale
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void scale_row(float* dst, size_t B, float scale) {
+    constexpr size_t W = Vec::width;
+    auto vscale = Vec::set1(scale);
+    size_t b = 0;
+    for (; b + W <= B; b += W) {
+        Vec::store(dst + b, Vec::mul(Vec::load(dst + b), vscale));
+    }
+    for (; b < B; ++b) {
+        dst[b] *= scale;
+    }
+}
+
+//! compute the max of src and the sum of exp(src - max) in one pass
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void online_max_sum(
+        const float* src, size_t B, float& max, float& sum) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    max = -FLT_MAX;
+    sum = 0.f;
+    size_t b = 0;
+    if (B >= 4 * W) {
+        //! each lane keeps its own (max, sum); the sum is rescaled once per
+        //! 4 vectors, so exp is computed 1.25 times per element
+        vtype vmax = Vec::set1(-FLT_MAX), vsum = Vec::set1(0.f);
+        for (; b + 4 * W <= B; b += 4 * W) {
+            vtype x0 = Vec::load(src + b), x1 = Vec::load(src + b + W),
+                  x2 = Vec::load(src + b + 2 * W), x3 = Vec::load(src + b + 3 * W);
+            vtype new_max =
+                    Vec::max(vmax, Vec::max(Vec::max(x0, x1), Vec::max(x2, x3)));
+            vtype neg_max = Vec::mul(new_max, Vec::set1(-1.f));
+            vsum = Vec::mul(vsum, Vec::exp(Vec::add(vmax, neg_max)));
+            vtype e0 = Vec::add(
+                    Vec::exp(Vec::add(x0, neg_max)), Vec::exp(Vec::add(x1, neg_max)));
+            vtype e1 = Vec::add(
+                    Vec::exp(Vec::add(x2, neg_max)), Vec::exp(Vec::add(x3, neg_max)));
+            vsum = Vec::add(vsum, Vec::add(e0, e1));
+            vmax = new_max;
+        }
+        max = Vec::reduce_max(vmax);
+        sum = Vec::reduce_add(
+                Vec::mul(vsum, Vec::exp(Vec::add(vmax, Vec::set1(-max)))));
+    }
+    for (; b < B; ++b) {
+        online_update(max, sum, src[b]);
+    }
+}
+
+//! dst = exp(src - max) * scale
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void exp_scale_store(
+        const float* src, float* dst, size_t B, float max, float scale) {
+    constexpr size_t W = Vec::width;
+    auto neg_max = Vec::set1(-max), vscale = Vec::set1(scale);
+    size_t b = 0;
+    for (; b + W <= B; b += W) {
+        Vec::store(
+                dst + b,
+                Vec::mul(Vec::exp(Vec::add(Vec::load(src + b), neg_max)), vscale));
+    }
+    for (; b < B; ++b) {
+        dst[b] = std::exp(src[b] - max) * scale;
+    }
+}
+
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void softmax_c1(
+        const float* src, float* dst, size_t nr_row, size_t B) {
+    for (size_t row = 0; row < nr_row; ++row) {
+        const float* sptr = src + row * B;
+        float* dptr = dst + row * B;
+        if (B <= MAX_CACHED_ROW) {
+            float max = row_max<Vec>(sptr, B);
+            float sum = exp_store_sum<Vec>(sptr, dptr, B, max);
+            scale_row<Vec>(dptr, B, 1.f / sum);
+        } else {
+            float max, sum;
+            online_max_sum<Vec>(sptr, B, max, sum);
+            exp_scale_store<Vec>(sptr, dptr, B, max, 1.f / sum);
+        }
+    }
+}
+
+/*!
+ * each vector holds W adjacent columns, which are computed in three passes
+ * along B like the contiguous rows
+ */
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET void softmax_strided(
+        const float* src, float* dst, size_t B, size_t C, size_t nr_c) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    size_t c = 0;
+    for (; c + W <= nr_c; c += W) {
+        const float* sptr = src + c;
+        float* dptr = dst + c;
+        vtype vmax = Vec::load(sptr);
+        for (size_t b = 1; b < B; ++b) {
+            vmax = Vec::max(vmax, Vec::load(sptr + b * C));
+        }
+        vtype neg_max = Vec::mul(vmax, Vec::set1(-1.f));
+        vtype vsum = Vec::set1(0.f);
+        for (size_t b = 0; b < B; ++b) {
+            vtype e = Vec::exp(Vec::add(Vec::load(sptr + b * C), neg_max));
+            Vec::store(dptr + b * C, e);
+            vsum = Vec::add(vsum, e);
+        }
+        float sum[W];
+        Vec::store(sum, vsum);
+        for (size_t i = 0; i < W; ++i) {
+            sum[i] = 1.f / sum[i];
+        }
+        vtype vscale = Vec::load(sum);
+        for (size_t b = 0; b < B; ++b) {
+            Vec::store(dptr + b * C, Vec::mul(Vec::load(dptr + b * C), vscale));
+        }
+    }
+    for (; c < nr_c; ++c) {
+        const float* sptr = src + c;
+        float* dptr = dst + c;
+        float max = sptr[0];
+        for (size_t b = 1; b < B; ++b) {
+            max = std::max(max, sptr[b * C]);
+        }
+        float sum = 0.f;
+        for (size_t b = 0; b < B; ++b) {
+            dptr[b * C] = std::exp(sptr[b * C] - max);
+            sum += dptr[b * C];
+        }
+        float scale = 1.f / sum;
+        for (size_t b = 0; b < B; ++b) {
+            dptr[b * C] *= scale;
+        }
+    }
+}
+
+}  // anonymous namespace
+}  // namespace softmax
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,108 @@
+/**
+ * \file dnn/src/fallback/topk/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/fallback/topk/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_topk)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+bool use_sort_kern(const TensorLayout& data) {
+    return (data.dtype == dtype::Float32() || data.dtype == dtype::Int32()) &&
+           !data.is_empty();
+}
+}  // anonymous namespace
+
+size_t TopKImpl::get_workspace_in_bytes(
+        int k, const TensorLayout& data, const TensorLayout& values,
+        const TensorLayout& indices) {
+    if (!use_sort_kern(data)) {
+        return naive::TopKImpl::get_workspace_in_bytes(k, data, values, indices);
+    }
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    return sort::TaskSplit(data[0], data[1], nr_threads).get_workspace_in_bytes();
+}
+
+template <typename ctype>
+void TopKImpl::exec_internal(
+        int k, _megdnn_tensor_in data, _megdnn_tensor_out values, int32_t* indices,
+        _megdnn_workspace workspace) {
+    size_t m = data.layout[0], n = data.layout[1];
+    ptrdiff_t lda = data.layout.stride[0];
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    sort::TaskSplit split(m, n, nr_threads);
+    const ctype* sptr = data.ptr<ctype>();
+    ctype* vptr = values.ptr<ctype>();
+    dt_byte* wptr = workspace.raw_ptr;
+    //! k < 0 selects the largest |k| values, which are the smallest of the
+    //! reversed keys
+    bool descending = k < 0;
+    size_t ow = std::abs(k);
+    bool kth_only = param().mode == Param::Mode::KTH_ONLY;
+    bool sorted = param().mode == Param::Mode::VALUE_IDX_SORTED;
+    auto kern = get_kern();
+    auto run = [=](size_t index, size_t) {
+        dt_byte* task_ws = wptr + index * split.task_workspace;
+        int32_t* key = reinterpret_cast<int32_t*>(task_ws);
+        void* row_ws = task_ws + split.task_workspace -
+                       sort::get_row_workspace_in_bytes(n);
+        size_t begin = index * split.nr_row_per_task;
+        size_t end = std::min(m, begin + split.nr_row_per_task);
+        for (size_t i = begin; i < end; ++i) {
+            const ctype* s = sptr + i * lda;
+            sort::encode(s, n, descending, key);
+            if (kth_only) {
+                vptr[i] = s[sort::topk_row(kern, key, n, ow, false, nullptr, row_ws)];
+                continue;
+            }
+            int32_t* idx = indices + i * ow;
+            sort::topk_row(kern, key, n, ow, sorted, idx, row_ws);
+            ctype* v = vptr + i * ow;
+            for (size_t j = 0; j < ow; ++j) {
+                v[j] = s[idx[j]];
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, split.nr_task);
+}
+
+void TopKImpl::do_exec(
+        int k, _megdnn_tensor_in data, _megdnn_tensor_out values, int32_t* indices,
+        _megdnn_workspace workspace) {
+    if (data.layout.dtype == dtype::Float32() && !data.layout.is_empty()) {
+        MIDOUT_BEGIN(megdnn_fallback_topk, midout_iv(0)) {
+            exec_internal<dt_float32>(k, data, values, indices, workspace);
+            return;
+        }
+        MIDOUT_END();
+    }
+    if (data.layout.dtype == dtype::Int32() && !data.layout.is_empty()) {
+        MIDOUT_BEGIN(megdnn_fallback_topk, midout_iv(1)) {
+            exec_internal<dt_int32>(k, data, values, indices, workspace);
+            return;
+        }
+        MIDOUT_END();
+    }
+    naive::TopKImpl::do_exec(k, data, values, indices, workspace);
+}
+
+// vim: syntax=cpp.doxygen
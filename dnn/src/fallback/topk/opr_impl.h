@@ -0,0 +1,44 @@
+/**
+ * \file dnn/src/fallback/topk/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/fallback/argsort/sort.h"
+#include "src/naive/topk/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+class TopKImpl : public naive::TopKImpl {
+public:
+    using naive::TopKImpl::TopKImpl;
+    size_t get_workspace_in_bytes(
+            int k, const TensorLayout& data, const TensorLayout& values,
+            const TensorLayout& indices) override;
+
+protected:
+    void do_exec(
+            int k, _megdnn_tensor_in data, _megdnn_tensor_out values, int32_t* indices,
+            _megdnn_workspace workspace) override;
+
+    //! get the row kernels; arch specific impls return their simd kernels
+    virtual sort::Kern get_kern() const { return sort::get_default_kern(); }
+
+private:
+    template <typename ctype>
+    void exec_internal(
+            int k, _megdnn_tensor_in data, _megdnn_tensor_out values, int32_t* indices,
+            _megdnn_workspace workspace);
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
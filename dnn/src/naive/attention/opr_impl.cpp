@@ -0,0 +1,97 @@
+/**
+ * \file dnn/src/naive/attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/attention/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cmath>
+
+namespace {
+
+//! mask is null if absent, and mask_stride is 0 if it is shared by the batches
+template <typename T>
+void attention(
+        const T* q, const T* k, const T* v, const T* mask, T* dst, float* score,
+        size_t batch, size_t Lq, size_t Lk, size_t D, size_t Dv, size_t mask_stride,
+        float scale, bool causal) {
+    for (size_t b = 0; b < batch; ++b) {
+        const T* qb = q + b * Lq * D;
+        const T* kb = k + b * Lk * D;
+        const T* vb = v + b * Lk * Dv;
+        const T* mb = mask ? mask + b * mask_stride : nullptr;
+        T* db = dst + b * Lq * Dv;
+        for (size_t i = 0; i < Lq; ++i) {
+            size_t nr_key = causal ? i + Lk - Lq + 1 : Lk;
+            float max = -INFINITY;
+            for (size_t j = 0; j < nr_key; ++j) {
+                float acc = 0;
+                for (size_t d = 0; d < D; ++d) {
+                    acc += static_cast<float>(qb[i * D + d]) *
+                           static_cast<float>(kb[j * D + d]);
+                }
+                score[j] = acc * scale;
+                if (mb) {
+                    score[j] += static_cast<float>(mb[i * Lk + j]);
+                }
+                max = std::max(max, score[j]);
+            }
+            float sum = 0;
+            for (size_t j = 0; j < nr_key; ++j) {
+                score[j] = std::exp(score[j] - max);
+                sum += score[j];
+            }
+            for (size_t d = 0; d < Dv; ++d) {
+                float acc = 0;
+                for (size_t j = 0; j < nr_key; ++j) {
+                    acc += score[j] * static_cast<float>(vb[j * Dv + d]);
+                }
+                db[i * Dv + d] = static_cast<T>(acc / sum);
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void AttentionForwardImpl::exec(
+        _megdnn_tensor_in q, _megdnn_tensor_in k, _megdnn_tensor_in v,
+        _megdnn_tensor_in mask, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(q.layout, k.layout, v.layout, mask.layout, dst.layout, workspace.size);
+    size_t batch, Lq, Lk, D, Dv;
+    get_matrix_shape(q.layout, k.layout, v.layout, batch, Lq, Lk, D, Dv);
+    size_t mask_stride = mask.layout.ndim == 2 ? 0 : Lq * Lk;
+    float scale = param().scale;
+    bool causal = param().causal;
+    float* score = workspace.ptr<float>();
+#define cb(DType)                                                                  \
+    if (q.layout.dtype == DType()) {                                               \
+        using ctype = DTypeTrait<DType>::ctype;                                    \
+        const ctype* mptr = mask.layout.ndim ? mask.ptr<ctype>() : nullptr;        \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(attention<ctype>(                             \
+                q.ptr<ctype>(), k.ptr<ctype>(), v.ptr<ctype>(), mptr,              \
+                dst.ptr<ctype>(), score, batch, Lq, Lk, D, Dv, mask_stride, scale, \
+                causal));                                                          \
+        return;                                                                    \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+    megdnn_assert_internal(0);
+#undef cb
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,135 @@
+/**
+ * \file dnn/src/naive/norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/norm/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cmath>
+
+namespace {
+
+//! compute the mean and 1 / sqrt(var + eps) of n elements
+template <typename T>
+void get_stats(const T* src, size_t n, float eps, float& mean, float& rstd) {
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += static_cast<float>(src[i]);
+    }
+    double m = sum / n, sqr_sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double diff = static_cast<float>(src[i]) - m;
+        sqr_sum += diff * diff;
+    }
+    mean = m;
+    rstd = 1.0 / std::sqrt(sqr_sum / n + eps);
+}
+
+template <typename T>
+void layer_norm(
+        const T* src, const T* weight, const T* bias, T* dst, size_t nr_row,
+        size_t row_size, float eps, bool affine) {
+    for (size_t row = 0; row < nr_row; ++row) {
+        const T* sptr = src + row * row_size;
+        T* dptr = dst + row * row_size;
+        float mean, rstd;
+        get_stats(sptr, row_size, eps, mean, rstd);
+        for (size_t i = 0; i < row_size; ++i) {
+            float val = (static_cast<float>(sptr[i]) - mean) * rstd;
+            if (affine) {
+                val = val * static_cast<float>(weight[i]) +
+                      static_cast<float>(bias[i]);
+            }
+            dptr[i] = static_cast<T>(val);
+        }
+    }
+}
+
+template <typename T>
+void group_norm(
+        const T* src, const T* weight, const T* bias, T* dst, size_t N, size_t C,
+        size_t HW, size_t group, float eps, bool affine) {
+    size_t group_size = C / group * HW;
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t g = 0; g < group; ++g) {
+            size_t offset = (n * group + g) * group_size;
+            float mean, rstd;
+            get_stats(src + offset, group_size, eps, mean, rstd);
+            for (size_t i = 0; i < group_size; ++i) {
+                size_t c = g * (C / group) + i / HW;
+                float val = (static_cast<float>(src[offset + i]) - mean) * rstd;
+                if (affine) {
+                    val = val * static_cast<float>(weight[c]) +
+                          static_cast<float>(bias[c]);
+                }
+                dst[offset + i] = static_cast<T>(val);
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void LayerNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(data.layout, weight.layout, bias.layout, dst.layout, workspace.size);
+    size_t nr_row, row_size;
+    get_row_size(data.layout, nr_row, row_size);
+    float eps = param().eps;
+    bool affine = param().affine;
+#define cb(DType)                                                                  \
+    if (data.layout.dtype == DType()) {                                            \
+        using ctype = DTypeTrait<DType>::ctype;                                    \
+        const ctype* wptr = affine ? weight.ptr<ctype>() : nullptr;                \
+        const ctype* bptr = affine ? bias.ptr<ctype>() : nullptr;                  \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(layer_norm<ctype>(                            \
+                data.ptr<ctype>(), wptr, bptr, dst.ptr<ctype>(), nr_row, row_size, \
+                eps, affine));                                                     \
+        return;                                                                    \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+    megdnn_assert_internal(0);
+#undef cb
+}
+
+void GroupNormForwardImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_in weight, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(data.layout, weight.layout, bias.layout, dst.layout, workspace.size);
+    size_t N = data.layout[0], C = data.layout[1];
+    size_t HW = data.layout.total_nr_elems() / (N * C);
+    size_t group = param().group;
+    float eps = param().eps;
+    bool affine = param().affine;
+#define cb(DType)                                                                 \
+    if (data.layout.dtype == DType()) {                                           \
+        using ctype = DTypeTrait<DType>::ctype;                                   \
+        const ctype* wptr = affine ? weight.ptr<ctype>() : nullptr;               \
+        const ctype* bptr = affine ? bias.ptr<ctype>() : nullptr;                 \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(group_norm<ctype>(                           \
+                data.ptr<ctype>(), wptr, bptr, dst.ptr<ctype>(), N, C, HW, group, \
+                eps, affine));                                                    \
+        return;                                                                   \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+    megdnn_assert_internal(0);
+#undef cb
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,202 @@
+/**
+ * \file dnn/src/naive/rnn/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/rnn/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cmath>
+
+using namespace megdnn;
+using namespace naive;
+
+namespace {
+
+struct RNNShape {
+    size_t T, N, I, H, L, D, G;
+    bool bias;
+};
+
+RNNShape get_shape(
+        const RNNBase::Param& param, size_t nr_gate, const TensorLayout& input,
+        const TensorLayout& hx) {
+    return {input[0],
+            input[1],
+            input[2],
+            hx[2],
+            param.num_layers,
+            param.bidirectional ? size_t(2) : size_t(1),
+            nr_gate,
+            param.bias};
+}
+
+//! two float buffers of the outputs of a layer, the hidden and cell states of
+//! N rows, and the gates of one row from the input and hidden states
+size_t get_workspace_size(const RNNShape& s) {
+    return (2 * s.T * s.N * s.D * s.H + 2 * s.N * s.H + 2 * s.G * s.H) *
+           sizeof(float);
+}
+
+float sigmoid(float x) {
+    return 1.f / (1.f + std::exp(-x));
+}
+
+//! cx and cy are null for GRU
+template <typename T>
+void rnn(const T* input, const int* seq_len, const T* hx, const T* cx,
+         const T* weights, T* output, T* hy, T* cy, const RNNShape& s,
+         const RNNBase::WeightOffset* offsets, float* workspace) {
+    size_t T_ = s.T, N = s.N, H = s.H, D = s.D, G = s.G;
+    float* bufs[2] = {workspace, workspace + T_ * N * D * H};
+    float* h = bufs[1] + T_ * N * D * H;
+    float* c = h + N * H;
+    float* gx = c + N * H;
+    float* gh = gx + G * H;
+    for (size_t layer = 0; layer < s.L; ++layer) {
+        size_t I = layer ? D * H : s.I;
+        const float* prev = bufs[(layer + 1) % 2];
+        float* out = bufs[layer % 2];
+        for (size_t d = 0; d < D; ++d) {
+            size_t state = (layer * D + d) * N * H;
+            auto&& off = offsets[layer * D + d];
+            for (size_t i = 0; i < N * H; ++i) {
+                h[i] = hx[state + i];
+                c[i] = cx ? static_cast<float>(cx[state + i]) : 0.f;
+            }
+            for (size_t step = 0; step < T_; ++step) {
+                size_t t = d ? T_ - 1 - step : step;
+                for (size_t n = 0; n < N; ++n) {
+                    float* o = out + (t * N + n) * D * H + d * H;
+                    size_t len = seq_len ? seq_len[n] : T_;
+                    if (t >= len) {
+                        std::fill(o, o + H, 0.f);
+                        continue;
+                    }
+                    float* hn = h + n * H;
+                    for (size_t gi = 0; gi < G * H; ++gi) {
+                        float accx = s.bias ? weights[off.b_ih + gi] : 0.f,
+                              acch = s.bias ? weights[off.b_hh + gi] : 0.f;
+                        const T* w_ih = weights + off.w_ih + gi * I;
+                        const T* w_hh = weights + off.w_hh + gi * H;
+                        for (size_t k = 0; k < I; ++k) {
+                            float x = layer ? prev[(t * N + n) * I + k]
+                                            : input[(t * N + n) * I + k];
+                            accx += static_cast<float>(w_ih[k]) * x;
+                        }
+                        for (size_t k = 0; k < H; ++k) {
+                            acch += static_cast<float>(w_hh[k]) * hn[k];
+                        }
+                        gx[gi] = accx;
+                        gh[gi] = acch;
+                    }
+                    for (size_t j = 0; j < H; ++j) {
+                        if (cx) {
+                            float ig = sigmoid(gx[j] + gh[j]),
+                                  fg = sigmoid(gx[H + j] + gh[H + j]),
+                                  gg = std::tanh(gx[2 * H + j] + gh[2 * H + j]),
+                                  og = sigmoid(gx[3 * H + j] + gh[3 * H + j]);
+                            float& cn = c[n * H + j];
+                            cn = fg * cn + ig * gg;
+                            hn[j] = og * std::tanh(cn);
+                        } else {
+                            float rg = sigmoid(gx[j] + gh[j]),
+                                  zg = sigmoid(gx[H + j] + gh[H + j]),
+                                  ng = std::tanh(gx[2 * H + j] + rg * gh[2 * H + j]);
+                            hn[j] = (1.f - zg) * ng + zg * hn[j];
+                        }
+                        o[j] = hn[j];
+                    }
+                }
+            }
+            for (size_t i = 0; i < N * H; ++i) {
+                hy[state + i] = h[i];
+                if (cy) {
+                    cy[state + i] = c[i];
+                }
+            }
+        }
+    }
+    const float* last = bufs[(s.L - 1) % 2];
+    for (size_t i = 0; i < T_ * N * D * H; ++i) {
+        output[i] = last[i];
+    }
+}
+
+}  // anonymous namespace
+
+void LSTMForwardImpl::exec(
+        _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+        _megdnn_tensor_in cx, _megdnn_tensor_in flatten_weights,
+        _megdnn_tensor_out output, _megdnn_tensor_out hy, _megdnn_tensor_out cy,
+        _megdnn_workspace workspace) {
+    check_exec(
+            input.layout, seq_len.layout, hx.layout, cx.layout, flatten_weights.layout,
+            output.layout, hy.layout, cy.layout, workspace.size);
+    auto s = get_shape(param(), NR_GATE, input.layout, hx.layout);
+    size_t nr_weight;
+    auto offsets = get_weight_offsets(param(), NR_GATE, s.I, s.H, nr_weight);
+    const int* len = seq_len.layout.ndim ? seq_len.ptr<dt_int32>() : nullptr;
+    float* ws = workspace.ptr<float>();
+#define cb(DType)                                                                   \
+    if (input.layout.dtype == DType()) {                                            \
+        using ctype = DTypeTrait<DType>::ctype;                                     \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(rnn<ctype>(                                    \
+                input.ptr<ctype>(), len, hx.ptr<ctype>(), cx.ptr<ctype>(),          \
+                flatten_weights.ptr<ctype>(), output.ptr<ctype>(), hy.ptr<ctype>(), \
+                cy.ptr<ctype>(), s, offsets.data(), ws));                           \
+        return;                                                                     \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+    megdnn_assert_internal(0);
+#undef cb
+}
+
+size_t LSTMForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& input, const TensorLayout&, const TensorLayout& hx,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&) {
+    return get_workspace_size(get_shape(param(), NR_GATE, input, hx));
+}
+
+void GRUForwardImpl::exec(
+        _megdnn_tensor_in input, _megdnn_tensor_in seq_len, _megdnn_tensor_in hx,
+        _megdnn_tensor_in flatten_weights, _megdnn_tensor_out output,
+        _megdnn_tensor_out hy, _megdnn_workspace workspace) {
+    check_exec(
+            input.layout, seq_len.layout, hx.layout, flatten_weights.layout,
+            output.layout, hy.layout, workspace.size);
+    auto s = get_shape(param(), NR_GATE, input.layout, hx.layout);
+    size_t nr_weight;
+    auto offsets = get_weight_offsets(param(), NR_GATE, s.I, s.H, nr_weight);
+    const int* len = seq_len.layout.ndim ? seq_len.ptr<dt_int32>() : nullptr;
+    float* ws = workspace.ptr<float>();
+#define cb(DType)                                                                   \
+    if (input.layout.dtype == DType()) {                                            \
+        using ctype = DTypeTrait<DType>::ctype;                                     \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(rnn<ctype>(                                    \
+                input.ptr<ctype>(), len, hx.ptr<ctype>(), nullptr,                  \
+                flatten_weights.ptr<ctype>(), output.ptr<ctype>(), hy.ptr<ctype>(), \
+                nullptr, s, offsets.data(), ws));                                   \
+        return;                                                                     \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+    megdnn_assert_internal(0);
+#undef cb
+}
+
+size_t GRUForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& input, const TensorLayout&, const TensorLayout& hx,
+        const TensorLayout&, const TensorLayout&, const TensorLayout&) {
+    return get_workspace_size(get_shape(param(), NR_GATE, input, hx));
+}
+
+// vim: syntax=cpp.doxygen
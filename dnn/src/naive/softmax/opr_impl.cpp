@@ -0,0 +1,72 @@
+/**
+ * \file dnn/src/naive/softmax/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/naive/softmax/opr_impl.h"
+
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+template <typename T>
+void exec_internal(const T* src, T* dst, size_t A, size_t B, size_t C) {
+    for (size_t a = 0; a < A; ++a) {
+        for (size_t c = 0; c < C; ++c) {
+            const T* sptr = src + a * B * C + c;
+            T* dptr = dst + a * B * C + c;
+            float max_val = static_cast<float>(sptr[0]);
+            for (size_t b = 1; b < B; ++b) {
+                max_val = std::max(max_val, static_cast<float>(sptr[b * C]));
+            }
+            float sum = 0;
+            for (size_t b = 0; b < B; ++b) {
+                sum += std::exp(static_cast<float>(sptr[b * C]) - max_val);
+            }
+            for (size_t b = 0; b < B; ++b) {
+                dptr[b * C] = static_cast<T>(
+                        std::exp(static_cast<float>(sptr[b * C]) - max_val) / sum);
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void SoftmaxForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, get_real_axis(src.layout));
+#define cb(DType)                                                                \
+    if (src.layout.dtype == DType()) {                                           \
+        using ctype = DTypeTrait<DType>::ctype;                                  \
+        const ctype* sptr = src.ptr<ctype>();                                    \
+        ctype* dptr = dst.ptr<ctype>();                                          \
+        MEGDNN_DISPATCH_CPU_KERN_OPR(exec_internal<ctype>(sptr, dptr, A, B, C)); \
+        return;                                                                  \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+    megdnn_assert_internal(0);
+#undef cb
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
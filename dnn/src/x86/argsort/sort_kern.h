@@ -0,0 +1,28 @@
+/**
+ * \file dnn/src/x86/argsort/sort_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/fallback/argsort/sort.h"
+
+namespace megdnn {
+namespace x86 {
+namespace sort {
+
+//! get the kernels of given simd type, which needs avx2 or avx512f
+fallback::sort::Kern get_kern_avx2();
+fallback::sort::Kern get_kern_avx512();
+
+}  // namespace sort
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
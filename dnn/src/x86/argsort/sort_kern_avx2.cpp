@@ -0,0 +1,65 @@
+/**
+ * \file dnn/src/x86/argsort/sort_kern_avx2.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/argsort/sort_kern.h"
+
+#include <immintrin.h>
+#include "src/common/utils.h"
+
+#define MEGDNN_SORT_TARGET
+#if !defined(__clang__)
+//! bypass gcc bug https://bugs.launchpad.net/ubuntu/+source/gcc-5/+bug/1642109
+#pragma GCC target("avx2")
+#else
+#undef MEGDNN_SORT_TARGET
+#define MEGDNN_SORT_TARGET MEGDNN_ATTRIBUTE_TARGET("avx2")
+#endif
+
+namespace {
+struct VecAVX2 {
+    using type = __m256i;
+    static constexpr size_t width = 8;
+    static MEGDNN_SORT_TARGET type load(const int32_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static MEGDNN_SORT_TARGET void store(int32_t* p, type v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    static MEGDNN_SORT_TARGET type set1(int32_t v) { return _mm256_set1_epi32(v); }
+    static MEGDNN_SORT_TARGET type permute(type v, type perm) {
+        return _mm256_permutevar8x32_epi32(v, perm);
+    }
+    //! replace the pairs of (k, i) by the partners (pk, pi) where the partner
+    //! is less than the pair iff want_min is set
+    static MEGDNN_SORT_TARGET void exchange(
+            type& k, type& i, type pk, type pi, type want_min) {
+        type less = _mm256_or_si256(
+                _mm256_cmpgt_epi32(k, pk),
+                _mm256_and_si256(
+                        _mm256_cmpeq_epi32(k, pk), _mm256_cmpgt_epi32(i, pi)));
+        type take = _mm256_cmpeq_epi32(less, want_min);
+        k = _mm256_blendv_epi8(k, pk, take);
+        i = _mm256_blendv_epi8(i, pi, take);
+    }
+    //! the bit mask of the lanes of v that are less than t
+    static MEGDNN_SORT_TARGET uint32_t less_mask(type v, type t) {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(t, v)));
+    }
+};
+}  // anonymous namespace
+
+#include "src/fallback/argsort/sort_kern_helper.h"
+
+megdnn::fallback::sort::Kern megdnn::x86::sort::get_kern_avx2() {
+    return megdnn::sort::get_kern<VecAVX2>();
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,64 @@
+/**
+ * \file dnn/src/x86/argsort/sort_kern_avx512.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/argsort/sort_kern.h"
+
+#include <immintrin.h>
+#include "src/common/utils.h"
+
+#define MEGDNN_SORT_TARGET
+#if !defined(__clang__)
+//! bypass gcc bug https://bugs.launchpad.net/ubuntu/+source/gcc-5/+bug/1642109
+#pragma GCC target("avx512f")
+#else
+#undef MEGDNN_SORT_TARGET
+#define MEGDNN_SORT_TARGET MEGDNN_ATTRIBUTE_TARGET("avx512f")
+#endif
+
+namespace {
+struct VecAVX512 {
+    using type = __m512i;
+    static constexpr size_t width = 16;
+    static MEGDNN_SORT_TARGET type load(const int32_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+    static MEGDNN_SORT_TARGET void store(int32_t* p, type v) {
+        _mm512_storeu_si512(p, v);
+    }
+    static MEGDNN_SORT_TARGET type set1(int32_t v) { return _mm512_set1_epi32(v); }
+    static MEGDNN_SORT_TARGET type permute(type v, type perm) {
+        return _mm512_permutexvar_epi32(perm, v);
+    }
+    //! replace the pairs of (k, i) by the partners (pk, pi) where the partner
+    //! is less than the pair iff want_min is set
+    static MEGDNN_SORT_TARGET void exchange(
+            type& k, type& i, type pk, type pi, type want_min) {
+        __mmask16 less = _mm512_cmplt_epi32_mask(pk, k) |
+                         (_mm512_cmpeq_epi32_mask(pk, k) &
+                          _mm512_cmplt_epi32_mask(pi, i));
+        __mmask16 take = ~(less ^ _mm512_test_epi32_mask(want_min, want_min));
+        k = _mm512_mask_blend_epi32(take, k, pk);
+        i = _mm512_mask_blend_epi32(take, i, pi);
+    }
+    //! the bit mask of the lanes of v that are less than t
+    static MEGDNN_SORT_TARGET uint32_t less_mask(type v, type t) {
+        return _mm512_cmplt_epi32_mask(v, t);
+    }
+};
+}  // anonymous namespace
+
+#include "src/fallback/argsort/sort_kern_helper.h"
+
+megdnn::fallback::sort::Kern megdnn::x86::sort::get_kern_avx512() {
+    return megdnn::sort::get_kern<VecAVX512>();
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,30 @@
+/**
+ * \file dnn/src/x86/attention/attention_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/fallback/attention/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace attention {
+
+using Kern = fallback::attention::Kern;
+
+//! get the kernel of given simd type, which needs avx2 and fma or avx512f
+Kern get_attention_kern_avx2();
+Kern get_attention_kern_avx512();
+
+}  // namespace attention
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
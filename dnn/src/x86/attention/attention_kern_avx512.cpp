@@ -0,0 +1,23 @@
+/**
+ * \file dnn/src/x86/attention/attention_kern_avx512.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/attention/attention_kern.h"
+
+#include "src/x86/simd_vec_avx512.h"
+
+#include "src/fallback/softmax/softmax_kern_helper.h"
+#include "src/fallback/attention/attention_kern_helper.h"
+
+megdnn::x86::attention::Kern megdnn::x86::attention::get_attention_kern_avx512() {
+    return megdnn::attention::attention<VecAVX512>;
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,30 @@
+/**
+ * \file dnn/src/x86/attention/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/attention/opr_impl.h"
+
+#include "src/x86/attention/attention_kern.h"
+#include "src/x86/utils.h"
+
+using namespace megdnn;
+using namespace x86;
+
+fallback::attention::Kern AttentionForwardImpl::get_kern() const {
+    if (is_supported(SIMDType::AVX512)) {
+        return x86::attention::get_attention_kern_avx512();
+    }
+    if (is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA)) {
+        return x86::attention::get_attention_kern_avx2();
+    }
+    return fallback::AttentionForwardImpl::get_kern();
+}
+
+// vim: syntax=cpp.doxygen
@@ -86,6 +86,81 @@ public:
     }
     MEGDNN_DECL_ALGO_TYPE(X86_DIRECT_STRD2)
 };
+
+/* ===================== avx2 fp32 chanwise algo ===================== */
+class ConvBiasImpl::AlgoF32ChanWiseAvx2 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_CONV_BIAS_CHANWISE_AVX2_F32"; }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override;
+    bool is_preferred(const NCBKernSizeParam&) const override { return true; }
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::FLOAT32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_CHANWISE_AVX2_F32)
+};
+
+class ConvBiasImpl::AlgoF32ChanWiseNCHW88Avx2 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override {
+        return "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW88";
+    }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override;
+    bool is_preferred(const NCBKernSizeParam&) const override { return true; }
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::FLOAT32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_CHANWISE_AVX2_NCHW88_F32)
+};
+
+/* ===================== avx2 fp32 nchw88 direct algo ===================== */
+class ConvBiasImpl::AlgoF32DirectNCHW88Avx2 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_CONV_BIAS_DIRECT_AVX2_F32_NCHW88"; }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override;
+    bool is_preferred(const NCBKernSizeParam& param) const override;
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::FLOAT32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_DIRECT_AVX2_NCHW88_F32)
+};
+
+//! the first layer with NCHW input and NCHW88 output
+class ConvBiasImpl::AlgoF32DirectNCHWNCHW88Avx2 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override {
+        return "X86_CONV_BIAS_DIRECT_AVX2_F32_NCHW_NCHW88";
+    }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override;
+    bool is_preferred(const NCBKernSizeParam&) const override { return true; }
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::FLOAT32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_DIRECT_AVX2_NCHW_NCHW88_F32)
+};
 /* =========================== winograd ======================== */
 class ConvBiasImpl::AlgoFP32WinogradF63_8x8 final : public AlgoBase {
 public:
@@ -0,0 +1,235 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/chanwise_algo.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/conv_bias/f32/algos.h"
+#include "src/x86/conv_bias/f32/chanwise_kern.h"
+#include "src/x86/elemwise_op.h"
+#include "src/x86/utils.h"
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+using NCBKern = fallback::ConvBiasImpl::NCBKern;
+using NCBKernSizeParam = fallback::ConvBiasImpl::NCBKernSizeParam;
+using NCBKernParam = fallback::ConvBiasImpl::NCBKernParam;
+using NCBKernIndex = fallback::ConvBiasImpl::NCBKernIndex;
+using conv_fun = void (*)(
+        const float* src, const float* filter, const float* bias, float* dst,
+        size_t IW2, size_t OH, size_t OW);
+
+template <size_t filter, size_t stride, BiasMode bias_mode, typename Op, bool nchw88>
+void do_conv_kern(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IW2, size_t OH, size_t OW) {
+    Op op;
+    if (nchw88) {
+        avx2_chanwise_f32::conv_nchw88<filter, stride, bias_mode, Op>(
+                src, filter_ptr, bias, dst, IW2, OH, OW, op);
+    } else {
+        avx2_chanwise_f32::conv_nchw<filter, stride, bias_mode, Op>(
+                src, filter_ptr, bias, dst, IW2, OH, OW, op);
+    }
+}
+
+bool chanwise_f32_usable(
+        const NCBKernSizeParam& param, param::ConvBias::Format format) {
+    auto&& fm = param.filter_meta;
+    auto FH = fm.spatial[0];
+    bool ok_type = param.src_type.enumv() == DTypeEnum::Float32 &&
+                   param.filter_type.enumv() == DTypeEnum::Float32 &&
+                   param.dst_type.enumv() == DTypeEnum::Float32;
+    bool ok_format = fm.format == format && fm.icpg == 1 && fm.ocpg == 1;
+    bool ok_filter = fm.spatial_ndim == 2 && FH == fm.spatial[1] &&
+                     (FH == 3 || FH == 5 || FH == 7);
+    bool ok_slide = fm.dilation[0] == 1 && fm.dilation[1] == 1 &&
+                    fm.stride[0] == fm.stride[1] &&
+                    (fm.stride[0] == 1 || fm.stride[0] == 2);
+    bool ok_nonline = param.nonlineMode == param::ConvBias::NonlineMode::IDENTITY ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::RELU ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::SIGMOID ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::H_SWISH;
+    return ok_type && ok_format && ok_filter && ok_slide && ok_nonline &&
+           !fm.should_flip && is_supported(SIMDType::AVX2) &&
+           is_supported(SIMDType::FMA);
+}
+
+//! whether the source plane should be copied to the padded buffer, which is
+//! needed if the kernel may read out of the plane
+bool need_src_copy(const NCBKernSizeParam& param, size_t IW2) {
+    auto&& fm = param.filter_meta;
+    return fm.padding[0] || fm.padding[1] || param.isz[1] < IW2;
+}
+
+WorkspaceBundle get_bundle(const NCBKernSizeParam& param, size_t pack_size) {
+    size_t IH2, IW2;
+    avx2_chanwise_f32::get_rectified_size(param, pack_size, IH2, IW2);
+    size_t src_size = 0;
+    if (need_src_copy(param, IW2)) {
+        src_size = IH2 * IW2 * pack_size * sizeof(float) * param.nr_threads;
+    }
+    return {nullptr, {src_size}};
+}
+
+SmallVector<NCBKern> get_kimpls(const NCBKernSizeParam& param, size_t pack_size) {
+    auto&& fm = param.filter_meta;
+    size_t group = fm.group, batch = param.n;
+    conv_fun do_conv_fun = nullptr;
+
+#define DO_CONV_KERN_FUN(filter, stride, bias_mode, op)                   \
+    if (pack_size == 8) {                                                 \
+        do_conv_fun = do_conv_kern<filter, stride, bias_mode, op, true>;  \
+    } else {                                                              \
+        do_conv_fun = do_conv_kern<filter, stride, bias_mode, op, false>; \
+    }
+
+#define GET_OP_PARAM(filter, stride, bias_mode)                        \
+    switch (param.nonlineMode) {                                       \
+        case param::ConvBias::NonlineMode::IDENTITY:                   \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    NoneOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+            break;                                                     \
+        case param::ConvBias::NonlineMode::RELU:                       \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    ReluOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+            break;                                                     \
+        case param::ConvBias::NonlineMode::SIGMOID:                    \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    SigmoidOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>) \
+            break;                                                     \
+        case param::ConvBias::NonlineMode::H_SWISH:                    \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    HSwishOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)  \
+            break;                                                     \
+        default:                                                       \
+            megdnn_assert(0);                                          \
+            break;                                                     \
+    }
+
+#define GET_BIAS_MODE_PARAM(filter, stride)                                \
+    switch (param.bias_mode) {                                             \
+        case BiasMode::NO_BIAS:                                            \
+            GET_OP_PARAM(filter, stride, BiasMode::NO_BIAS)                \
+            break;                                                         \
+        case BiasMode::BROADCAST_CHANNEL_BIAS:                             \
+            GET_OP_PARAM(filter, stride, BiasMode::BROADCAST_CHANNEL_BIAS) \
+            break;                                                         \
+        case BiasMode::BIAS:                                               \
+            GET_OP_PARAM(filter, stride, BiasMode::BIAS)                   \
+            break;                                                         \
+        default:                                                           \
+            megdnn_assert(0);                                              \
+            break;                                                         \
+    }
+
+#define GET_STRIDE_PARAM(filter)       \
+    if (fm.stride[0] == 1) {           \
+        GET_BIAS_MODE_PARAM(filter, 1) \
+    } else {                           \
+        GET_BIAS_MODE_PARAM(filter, 2) \
+    }
+
+#define DISPATCH_CONV_KERN()    \
+    switch (fm.spatial[0]) {    \
+        case 3:                 \
+            GET_STRIDE_PARAM(3) \
+            break;              \
+        case 5:                 \
+            GET_STRIDE_PARAM(5) \
+            break;              \
+        case 7:                 \
+            GET_STRIDE_PARAM(7) \
+            break;              \
+        default:                \
+            megdnn_assert(0);   \
+            break;              \
+    }
+
+    DISPATCH_CONV_KERN();
+
+#undef DO_CONV_KERN_FUN
+#undef GET_OP_PARAM
+#undef GET_BIAS_MODE_PARAM
+#undef GET_STRIDE_PARAM
+#undef DISPATCH_CONV_KERN
+
+    megdnn_assert(do_conv_fun);
+
+    size_t IH2, IW2;
+    avx2_chanwise_f32::get_rectified_size(param, pack_size, IH2, IW2);
+    bool src_copy = need_src_copy(param, IW2);
+    auto do_conv = [bundle = get_bundle(param, pack_size), do_conv_fun, pack_size, IH2,
+                    IW2, src_copy](
+                           const NCBKernParam& kern_param,
+                           const NCBKernIndex& ncb_index) mutable {
+        bundle.set(kern_param.workspace_ptr);
+        size_t IH = kern_param.isz[0], IW = kern_param.isz[1];
+        size_t OH = kern_param.osz[0], OW = kern_param.osz[1];
+        size_t group_id = ncb_index.ndrange_id[0], batch_id = ncb_index.ndrange_id[1];
+        const float* sptr = kern_param.src<float>(batch_id, group_id, 0, pack_size);
+        const float* fptr = kern_param.filter<float>(group_id, pack_size);
+        const float* bptr = kern_param.bias<float>(batch_id, group_id, 0, pack_size);
+        float* dst = kern_param.dst<float>(batch_id, group_id, 0, pack_size);
+        size_t row_stride = IW;
+        if (src_copy) {
+            float* padded = static_cast<float*>(bundle.get(0)) +
+                            ncb_index.thread_id * IH2 * IW2 * pack_size;
+            avx2_chanwise_f32::copy_padding(
+                    sptr, padded, IH, IW, IH2, IW2, kern_param.filter_meta.padding[0],
+                    kern_param.filter_meta.padding[1], pack_size);
+            sptr = padded;
+            row_stride = IW2;
+        }
+        do_conv_fun(sptr, fptr, bptr, dst, row_stride, OH, OW);
+    };
+    return {{do_conv, {group / pack_size, batch}}};
+}
+}  // anonymous namespace
+
+/* ===================== avx2 fp32 chanwise algo ===================== */
+bool ConvBiasImpl::AlgoF32ChanWiseAvx2::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    return chanwise_f32_usable(param, param::ConvBias::Format::NCHW);
+}
+
+size_t ConvBiasImpl::AlgoF32ChanWiseAvx2::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return get_bundle(param, 1).total_size_in_bytes();
+}
+
+SmallVector<ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoF32ChanWiseAvx2::dispatch_kerns(
+        const NCBKernSizeParam& param) const {
+    return get_kimpls(param, 1);
+}
+
+/* ================= avx2 fp32 nchw88 chanwise algo ================= */
+bool ConvBiasImpl::AlgoF32ChanWiseNCHW88Avx2::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    return chanwise_f32_usable(param, param::ConvBias::Format::NCHW88) &&
+           param.filter_meta.group % 8 == 0;
+}
+
+size_t ConvBiasImpl::AlgoF32ChanWiseNCHW88Avx2::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return get_bundle(param, 8).total_size_in_bytes();
+}
+
+SmallVector<ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoF32ChanWiseNCHW88Avx2::
+        dispatch_kerns(const NCBKernSizeParam& param) const {
+    return get_kimpls(param, 8);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,252 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/chanwise_kern.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/conv_bias/f32/chanwise_kern.h"
+#include "src/x86/elemwise_op.h"
+
+#include <immintrin.h>
+#include <cstring>
+
+using namespace megdnn;
+using namespace x86;
+using namespace avx2_chanwise_f32;
+
+namespace {
+
+template <size_t stride>
+struct SrcLoader;
+
+template <>
+struct SrcLoader<1> {
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+};
+
+//! gather 8 elements with stride 2, which reads ptr[0, 16)
+template <>
+struct SrcLoader<2> {
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 load(const float* ptr) {
+        __m256 t = _mm256_shuffle_ps(
+                _mm256_loadu_ps(ptr), _mm256_loadu_ps(ptr + 8),
+                _MM_SHUFFLE(2, 0, 2, 0));
+        return _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(t), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+};
+
+/*!
+ * compute nr_vec x 8 consecutive outputs in a row of NCHW; only the elements
+ * selected by mask are loaded from bias and stored if tail is true
+ */
+template <
+        size_t filter, size_t stride, BiasMode bias_mode, typename Op, size_t nr_vec,
+        bool tail>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+inline void compute_nchw(
+        const float* src, const __m256* kern, const float* bias, float* dst,
+        size_t IW2, const Op& op, __m256i mask) {
+    __m256 acc[nr_vec];
+    for (size_t i = 0; i < nr_vec; ++i) {
+        acc[i] = bias_mode == BiasMode::BROADCAST_CHANNEL_BIAS ? _mm256_set1_ps(*bias)
+                                                               : _mm256_setzero_ps();
+    }
+    for (size_t fh = 0; fh < filter; ++fh) {
+        const float* sptr = src + fh * IW2;
+        for (size_t fw = 0; fw < filter; ++fw) {
+            __m256 k = kern[fh * filter + fw];
+            for (size_t i = 0; i < nr_vec; ++i) {
+                acc[i] = _mm256_fmadd_ps(
+                        SrcLoader<stride>::load(sptr + i * 8 * stride + fw), k, acc[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < nr_vec; ++i) {
+        if (bias_mode == BiasMode::BIAS) {
+            acc[i] = _mm256_add_ps(
+                    acc[i], tail ? _mm256_maskload_ps(bias + i * 8, mask)
+                                 : _mm256_loadu_ps(bias + i * 8));
+        }
+        acc[i] = op(acc[i]);
+        if (tail) {
+            _mm256_maskstore_ps(dst + i * 8, mask, acc[i]);
+        } else {
+            _mm256_storeu_ps(dst + i * 8, acc[i]);
+        }
+    }
+}
+
+//! compute nr_pix consecutive output pixels in a row of NCHW88
+template <size_t filter, size_t stride, BiasMode bias_mode, typename Op, size_t nr_pix>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+inline void compute_nchw88(
+        const float* src, const __m256* kern, const float* bias, float* dst,
+        size_t IW2, const Op& op) {
+    __m256 acc[nr_pix];
+    for (size_t i = 0; i < nr_pix; ++i) {
+        acc[i] = bias_mode == BiasMode::BROADCAST_CHANNEL_BIAS ? _mm256_loadu_ps(bias)
+                                                               : _mm256_setzero_ps();
+    }
+    for (size_t fh = 0; fh < filter; ++fh) {
+        const float* sptr = src + fh * IW2 * 8;
+        for (size_t fw = 0; fw < filter; ++fw) {
+            __m256 k = kern[fh * filter + fw];
+            for (size_t i = 0; i < nr_pix; ++i) {
+                acc[i] = _mm256_fmadd_ps(
+                        _mm256_loadu_ps(sptr + (i * stride + fw) * 8), k, acc[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < nr_pix; ++i) {
+        if (bias_mode == BiasMode::BIAS) {
+            acc[i] = _mm256_add_ps(acc[i], _mm256_loadu_ps(bias + i * 8));
+        }
+        _mm256_storeu_ps(dst + i * 8, op(acc[i]));
+    }
+}
+
+}  // anonymous namespace
+
+void avx2_chanwise_f32::get_rectified_size(
+        const fallback::ConvBiasImpl::NCBKernSizeParam& param, size_t pack_size,
+        size_t& IH2, size_t& IW2) {
+    auto&& fm = param.filter_meta;
+    size_t stride = fm.stride[0], FH = fm.spatial[0], FW = fm.spatial[1];
+    size_t OH = param.osz[0], OW = param.osz[1];
+    IH2 = (OH - 1) * stride + FH;
+    if (pack_size == 1) {
+        IW2 = stride * round_up<size_t>(OW, 8) + FW - 1;
+    } else {
+        IW2 = (OW - 1) * stride + FW;
+    }
+}
+
+void avx2_chanwise_f32::copy_padding(
+        const float* src, float* dst, size_t IH, size_t IW, size_t IH2, size_t IW2,
+        size_t PH, size_t PW, size_t pack_size) {
+    std::memset(dst, 0, sizeof(float) * IH2 * IW2 * pack_size);
+    if (PW >= IW2) {
+        return;
+    }
+    size_t nr_copy = std::min(IW, IW2 - PW) * pack_size;
+    for (size_t ih = 0; ih < IH && ih + PH < IH2; ++ih) {
+        std::memcpy(
+                dst + ((ih + PH) * IW2 + PW) * pack_size, src + ih * IW * pack_size,
+                sizeof(float) * nr_copy);
+    }
+}
+
+template <size_t filter, size_t stride, BiasMode bias_mode, typename Op>
+void avx2_chanwise_f32::conv_nchw(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IW2, size_t OH, size_t OW, const Op& op) {
+    __m256 kern[filter * filter];
+    for (size_t i = 0; i < filter * filter; ++i) {
+        kern[i] = _mm256_set1_ps(filter_ptr[i]);
+    }
+    __m256i mask = _mm256_cmpgt_epi32(
+            _mm256_set1_epi32(OW % 8), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    for (size_t oh = 0; oh < OH; ++oh) {
+        const float* sptr = src + oh * stride * IW2;
+        const float* bptr = bias_mode == BiasMode::BIAS ? bias + oh * OW : bias;
+        float* dptr = dst + oh * OW;
+        size_t ow = 0;
+        //! the bias offset is only used in BiasMode::BIAS
+        size_t bias_step = bias_mode == BiasMode::BIAS;
+        for (; ow + 32 <= OW; ow += 32) {
+            compute_nchw<filter, stride, bias_mode, Op, 4, false>(
+                    sptr + ow * stride, kern, bptr + ow * bias_step, dptr + ow, IW2, op,
+                    mask);
+        }
+        for (; ow + 8 <= OW; ow += 8) {
+            compute_nchw<filter, stride, bias_mode, Op, 1, false>(
+                    sptr + ow * stride, kern, bptr + ow * bias_step, dptr + ow, IW2, op,
+                    mask);
+        }
+        if (ow < OW) {
+            compute_nchw<filter, stride, bias_mode, Op, 1, true>(
+                    sptr + ow * stride, kern, bptr + ow * bias_step, dptr + ow, IW2, op,
+                    mask);
+        }
+    }
+}
+
+template <size_t filter, size_t stride, BiasMode bias_mode, typename Op>
+void avx2_chanwise_f32::conv_nchw88(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IW2, size_t OH, size_t OW, const Op& op) {
+    __m256 kern[filter * filter];
+    for (size_t i = 0; i < filter * filter; ++i) {
+        kern[i] = _mm256_loadu_ps(filter_ptr + i * 8);
+    }
+    for (size_t oh = 0; oh < OH; ++oh) {
+        const float* sptr = src + oh * stride * IW2 * 8;
+        const float* bptr = bias_mode == BiasMode::BIAS ? bias + oh * OW * 8 : bias;
+        float* dptr = dst + oh * OW * 8;
+        size_t ow = 0;
+        size_t bias_step = bias_mode == BiasMode::BIAS ? 8 : 0;
+        for (; ow + 8 <= OW; ow += 8) {
+            compute_nchw88<filter, stride, bias_mode, Op, 8>(
+                    sptr + ow * stride * 8, kern, bptr + ow * bias_step, dptr + ow * 8,
+                    IW2, op);
+        }
+        for (; ow < OW; ++ow) {
+            compute_nchw88<filter, stride, bias_mode, Op, 1>(
+                    sptr + ow * stride * 8, kern, bptr + ow * bias_step, dptr + ow * 8,
+                    IW2, op);
+        }
+    }
+}
+
+#define INSTANTIATION(layout, filter, stride, bias_mode, Op)                       \
+    template void avx2_chanwise_f32::conv_##layout<filter, stride, bias_mode, Op>( \
+            const float*, const float*, const float*, float*, size_t, size_t,      \
+            size_t, const Op&);
+
+#define FOR_OP(layout, filter, stride, bias_mode)              \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            NoneOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            ReluOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            SigmoidOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>) \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            HSwishOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)
+
+#define FOR_BIAS(layout, filter, stride)                             \
+    FOR_OP(layout, filter, stride, BiasMode::NO_BIAS)                \
+    FOR_OP(layout, filter, stride, BiasMode::BROADCAST_CHANNEL_BIAS) \
+    FOR_OP(layout, filter, stride, BiasMode::BIAS)
+
+#define FOR_STRIDE(layout, filter) \
+    FOR_BIAS(layout, filter, 1)    \
+    FOR_BIAS(layout, filter, 2)
+
+#define FOR_FILTER(layout) \
+    FOR_STRIDE(layout, 3)  \
+    FOR_STRIDE(layout, 5)  \
+    FOR_STRIDE(layout, 7)
+
+FOR_FILTER(nchw)
+FOR_FILTER(nchw88)
+
+#undef FOR_FILTER
+#undef FOR_STRIDE
+#undef FOR_BIAS
+#undef FOR_OP
+#undef INSTANTIATION
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,59 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/chanwise_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/x86/conv_bias/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace avx2_chanwise_f32 {
+
+/*!
+ * \brief get the size of the padded source plane needed by the kernels
+ *
+ * For NCHW the output width is rounded up to a multiple of 8 so that the last
+ * vector never reads out of the plane.
+ */
+void get_rectified_size(
+        const fallback::ConvBiasImpl::NCBKernSizeParam& param, size_t pack_size,
+        size_t& IH2, size_t& IW2);
+
+//! copy a source plane into the zero-padded buffer of IH2 x IW2 pixels
+void copy_padding(
+        const float* src, float* dst, size_t IH, size_t IW, size_t IH2, size_t IW2,
+        size_t PH, size_t PW, size_t pack_size);
+
+/*!
+ * \brief channel-wise convolution of a single channel in NCHW, or a pack of 8
+ * channels in NCHW88
+ *
+ * \param src the source plane with the padding applied, whose row stride is
+ *      IW2 pixels
+ * \param bias bias of the channel, or the bias plane in BiasMode::BIAS
+ */
+#define KERN(layout)                                                         \
+    template <size_t filter, size_t stride, BiasMode bias_mode, typename Op> \
+    MEGDNN_ATTRIBUTE_TARGET("avx2,fma")                                      \
+    void conv_##layout(                                                      \
+            const float* src, const float* filter_ptr, const float* bias,    \
+            float* dst, size_t IW2, size_t OH, size_t OW, const Op& op);
+
+KERN(nchw)
+KERN(nchw88)
+
+#undef KERN
+
+}  // namespace avx2_chanwise_f32
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,312 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/direct_nchw88_algo.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/conv_bias/f32/algos.h"
+#include "src/x86/conv_bias/f32/direct_nchw88_kern.h"
+#include "src/x86/elemwise_op.h"
+#include "src/x86/utils.h"
+
+#include <cstring>
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+using NCBKern = fallback::ConvBiasImpl::NCBKern;
+using NCBKernSizeParam = fallback::ConvBiasImpl::NCBKernSizeParam;
+using NCBKernParam = fallback::ConvBiasImpl::NCBKernParam;
+using NCBKernIndex = fallback::ConvBiasImpl::NCBKernIndex;
+using conv_fun = void (*)(
+        const float* src, const float* filter, const float* bias, float* dst,
+        size_t IC, size_t OC, size_t IH2, size_t IW2, size_t OH, size_t oh_block,
+        size_t OW);
+
+template <size_t filter, size_t stride, BiasMode bias_mode, typename Op, bool hybrid>
+void do_conv_kern(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IC, size_t OC, size_t IH2, size_t IW2, size_t OH, size_t oh_block,
+        size_t OW) {
+    Op op;
+    if (hybrid) {
+        avx2_direct_nchw88_f32::conv_nchw_nchw88<filter, stride, bias_mode, Op>(
+                src, filter_ptr, bias, dst, IC, OC, IH2, IW2, OH, oh_block, OW, op);
+    } else {
+        avx2_direct_nchw88_f32::conv_nchw88<filter, stride, bias_mode, Op>(
+                src, filter_ptr, bias, dst, IC, OC, IH2, IW2, OH, oh_block, OW, op);
+    }
+}
+
+bool direct_nchw88_common_usable(const NCBKernSizeParam& param) {
+    auto&& fm = param.filter_meta;
+    auto FH = fm.spatial[0];
+    bool ok_filter =
+            fm.spatial_ndim == 2 && FH == fm.spatial[1] && FH >= 1 && FH <= 7;
+    bool ok_slide = fm.dilation[0] == 1 && fm.dilation[1] == 1 &&
+                    fm.stride[0] == fm.stride[1] &&
+                    (fm.stride[0] == 1 || fm.stride[0] == 2);
+    bool ok_nonline = param.nonlineMode == param::ConvBias::NonlineMode::IDENTITY ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::RELU ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::SIGMOID ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::H_SWISH;
+    return ok_filter && ok_slide && ok_nonline && !fm.should_flip &&
+           is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA);
+}
+
+//! number of output rows computed by a kernel, so that the padded source
+//! rows needed by a block fit in the L2 cache
+size_t get_oh_block(const NCBKernSizeParam& param) {
+    constexpr size_t l2_cache_size = 256 * 1024;
+    auto&& fm = param.filter_meta;
+    size_t OH = param.osz[0], stride = fm.stride[0];
+    size_t row_bytes = fm.icpg * (param.isz[1] + 2 * fm.padding[1]) * stride *
+                       sizeof(float);
+    size_t block_per_thread = div_ceil(OH, param.nr_threads);
+    size_t best_block =
+            std::max<size_t>(std::min(OH, l2_cache_size / row_bytes), 1);
+    size_t nr_block = div_ceil(block_per_thread, best_block);
+    return div_ceil(block_per_thread, nr_block);
+}
+
+void get_rectified_size(
+        const NCBKernSizeParam& param, size_t& IH2, size_t& IW2) {
+    auto&& fm = param.filter_meta;
+    size_t stride = fm.stride[0];
+    IH2 = get_oh_block(param) * stride + fm.spatial[0] - stride;
+    IW2 = param.isz[1] + 2 * fm.padding[1];
+}
+
+WorkspaceBundle get_bundle(const NCBKernSizeParam& param) {
+    size_t IH2, IW2;
+    get_rectified_size(param, IH2, IW2);
+    size_t src_size = param.filter_meta.icpg * IH2 * IW2 * sizeof(float);
+    return {nullptr, {src_size * param.nr_threads}};
+}
+
+/*!
+ * copy the source rows [ih_start, ih_start + IH2) of the padded image into dst;
+ * the source has nr_plane planes of IH x IW pixels of pack_size floats
+ */
+void copy_padding(
+        const float* src, float* dst, size_t nr_plane, size_t IH, size_t IW,
+        size_t ih_start, size_t IH2, size_t IW2, size_t PH, size_t PW,
+        size_t pack_size) {
+    for (size_t plane = 0; plane < nr_plane; ++plane) {
+        const float* sptr = src + plane * IH * IW * pack_size;
+        for (size_t row = 0; row < IH2; ++row) {
+            float* dptr = dst + (plane * IH2 + row) * IW2 * pack_size;
+            size_t ih = ih_start + row;
+            if (ih < PH || ih >= IH + PH) {
+                std::memset(dptr, 0, sizeof(float) * IW2 * pack_size);
+                continue;
+            }
+            std::memset(dptr, 0, sizeof(float) * PW * pack_size);
+            std::memcpy(
+                    dptr + PW * pack_size, sptr + (ih - PH) * IW * pack_size,
+                    sizeof(float) * IW * pack_size);
+            std::memset(
+                    dptr + (PW + IW) * pack_size, 0,
+                    sizeof(float) * (IW2 - PW - IW) * pack_size);
+        }
+    }
+}
+
+SmallVector<NCBKern> get_kimpls(const NCBKernSizeParam& param, bool hybrid) {
+    auto&& fm = param.filter_meta;
+    size_t group = fm.group, batch = param.n;
+    conv_fun do_conv_fun = nullptr;
+
+#define DO_CONV_KERN_FUN(filter, stride, bias_mode, op)                   \
+    if (hybrid) {                                                         \
+        do_conv_fun = do_conv_kern<filter, stride, bias_mode, op, true>;  \
+    } else {                                                              \
+        do_conv_fun = do_conv_kern<filter, stride, bias_mode, op, false>; \
+    }
+
+#define GET_OP_PARAM(filter, stride, bias_mode)                        \
+    switch (param.nonlineMode) {                                       \
+        case param::ConvBias::NonlineMode::IDENTITY:                   \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    NoneOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+            break;                                                     \
+        case param::ConvBias::NonlineMode::RELU:                       \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    ReluOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+            break;                                                     \
+        case param::ConvBias::NonlineMode::SIGMOID:                    \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    SigmoidOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>) \
+            break;                                                     \
+        case param::ConvBias::NonlineMode::H_SWISH:                    \
+            DO_CONV_KERN_FUN(                                          \
+                    filter, stride, bias_mode,                         \
+                    HSwishOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)  \
+            break;                                                     \
+        default:                                                       \
+            megdnn_assert(0);                                          \
+            break;                                                     \
+    }
+
+#define GET_BIAS_MODE_PARAM(filter, stride)                                \
+    switch (param.bias_mode) {                                             \
+        case BiasMode::NO_BIAS:                                            \
+            GET_OP_PARAM(filter, stride, BiasMode::NO_BIAS)                \
+            break;                                                         \
+        case BiasMode::BROADCAST_CHANNEL_BIAS:                             \
+            GET_OP_PARAM(filter, stride, BiasMode::BROADCAST_CHANNEL_BIAS) \
+            break;                                                         \
+        case BiasMode::BIAS:                                               \
+            GET_OP_PARAM(filter, stride, BiasMode::BIAS)                   \
+            break;                                                         \
+        default:                                                           \
+            megdnn_assert(0);                                              \
+            break;                                                         \
+    }
+
+#define GET_STRIDE_PARAM(filter)       \
+    if (fm.stride[0] == 1) {           \
+        GET_BIAS_MODE_PARAM(filter, 1) \
+    } else {                           \
+        GET_BIAS_MODE_PARAM(filter, 2) \
+    }
+
+#define DISPATCH_CONV_KERN()    \
+    switch (fm.spatial[0]) {    \
+        case 1:                 \
+            GET_STRIDE_PARAM(1) \
+            break;              \
+        case 2:                 \
+            GET_STRIDE_PARAM(2) \
+            break;              \
+        case 3:                 \
+            GET_STRIDE_PARAM(3) \
+            break;              \
+        case 4:                 \
+            GET_STRIDE_PARAM(4) \
+            break;              \
+        case 5:                 \
+            GET_STRIDE_PARAM(5) \
+            break;              \
+        case 6:                 \
+            GET_STRIDE_PARAM(6) \
+            break;              \
+        case 7:                 \
+            GET_STRIDE_PARAM(7) \
+            break;              \
+        default:                \
+            megdnn_assert(0);   \
+            break;              \
+    }
+
+    DISPATCH_CONV_KERN();
+
+#undef DO_CONV_KERN_FUN
+#undef GET_OP_PARAM
+#undef GET_BIAS_MODE_PARAM
+#undef GET_STRIDE_PARAM
+#undef DISPATCH_CONV_KERN
+
+    megdnn_assert(do_conv_fun);
+
+    size_t IH2, IW2;
+    get_rectified_size(param, IH2, IW2);
+    //! number of floats in the padded buffer of a thread
+    size_t padded_size = fm.icpg * IH2 * IW2;
+    size_t oh_block = get_oh_block(param);
+    size_t nr_oh_block = div_ceil<size_t>(param.osz[0], oh_block);
+    auto do_conv = [bundle = get_bundle(param), do_conv_fun, hybrid, padded_size,
+                    IW2, oh_block](
+                           const NCBKernParam& kern_param,
+                           const NCBKernIndex& ncb_index) mutable {
+        bundle.set(kern_param.workspace_ptr);
+        auto&& fm = kern_param.filter_meta;
+        size_t IC = fm.icpg, OC = fm.ocpg, stride = fm.stride[0];
+        size_t IH = kern_param.isz[0], IW = kern_param.isz[1];
+        size_t OH = kern_param.osz[0], OW = kern_param.osz[1];
+        size_t batch_id = ncb_index.ndrange_id[0], group_id = ncb_index.ndrange_id[1],
+               oh_start = ncb_index.ndrange_id[2] * oh_block;
+        size_t oh_block_real = std::min(OH - oh_start, oh_block);
+        size_t pack_size = hybrid ? 1 : 8;
+
+        float* padded = static_cast<float*>(bundle.get(0)) +
+                        ncb_index.thread_id * padded_size;
+        size_t ih2_real = (oh_block_real - 1) * stride + fm.spatial[0];
+        copy_padding(
+                kern_param.src<float>(batch_id, group_id), padded, IC / pack_size, IH,
+                IW, oh_start * stride, ih2_real, IW2, fm.padding[0], fm.padding[1],
+                pack_size);
+
+        const float* bptr = kern_param.bias<float>(batch_id, group_id);
+        if (kern_param.bias_mode == BiasMode::BIAS) {
+            bptr += oh_start * OW * 8;
+        }
+        float* dst = kern_param.dst<float>(batch_id, group_id) + oh_start * OW * 8;
+        do_conv_fun(
+                padded, kern_param.filter<float>(group_id), bptr, dst, IC, OC,
+                ih2_real, IW2, OH, oh_block_real, OW);
+    };
+    return {{do_conv, {batch, group, nr_oh_block}}};
+}
+}  // anonymous namespace
+
+/* ===================== avx2 fp32 nchw88 direct algo ===================== */
+bool ConvBiasImpl::AlgoF32DirectNCHW88Avx2::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    auto&& fm = param.filter_meta;
+    bool ok_type = param.src_type.enumv() == DTypeEnum::Float32 &&
+                   param.filter_type.enumv() == DTypeEnum::Float32 &&
+                   param.dst_type.enumv() == DTypeEnum::Float32;
+    bool ok_format = fm.format == param::ConvBias::Format::NCHW88 &&
+                     fm.icpg % 8 == 0 && fm.ocpg % 8 == 0;
+    return ok_type && ok_format && direct_nchw88_common_usable(param);
+}
+
+bool ConvBiasImpl::AlgoF32DirectNCHW88Avx2::is_preferred(
+        const NCBKernSizeParam& param) const {
+    //! 1x1 is better handled by matmul, and 3x3 stride 1 by winograd
+    auto&& fm = param.filter_meta;
+    return fm.spatial[0] != 1 && !(fm.spatial[0] == 3 && fm.stride[0] == 1);
+}
+
+size_t ConvBiasImpl::AlgoF32DirectNCHW88Avx2::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return get_bundle(param).total_size_in_bytes();
+}
+
+SmallVector<ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoF32DirectNCHW88Avx2::
+        dispatch_kerns(const NCBKernSizeParam& param) const {
+    return get_kimpls(param, false);
+}
+
+/* ================= avx2 fp32 nchw to nchw88 direct algo ================= */
+bool ConvBiasImpl::AlgoF32DirectNCHWNCHW88Avx2::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    return nchw_nchwxx_valid<NchwNchwxxType::NCHW88>(
+                   param.src_type.enumv(), param.filter_type.enumv(),
+                   param.dst_type.enumv(), param.filter_meta, param.bias_mode,
+                   param.nonlineMode) &&
+           direct_nchw88_common_usable(param);
+}
+
+size_t ConvBiasImpl::AlgoF32DirectNCHWNCHW88Avx2::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return get_bundle(param).total_size_in_bytes();
+}
+
+SmallVector<ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoF32DirectNCHWNCHW88Avx2::
+        dispatch_kerns(const NCBKernSizeParam& param) const {
+    return get_kimpls(param, true);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,31 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/direct_nchw88_kern.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/conv_bias/f32/direct_nchw88_kern_common.h"
+
+using namespace megdnn;
+using namespace x86;
+using namespace avx2_direct_nchw88_f32;
+
+template <size_t filter, size_t stride, BiasMode bias_mode, typename Op>
+void avx2_direct_nchw88_f32::conv_nchw88(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IC, size_t OC, size_t IH2, size_t IW2, size_t OH, size_t oh_block,
+        size_t OW, const Op& op) {
+    KernParam p{IC, IH2, IW2, IC * filter * filter * 8, OH * OW * 8};
+    conv_direct<ComputeNCHW88, filter, stride, bias_mode, Op>(
+            src, filter_ptr, bias, dst, p, OC, oh_block, OW, op);
+}
+
+INSTANTIATION_CONV_DIRECT(nchw88)
+
+// vim: syntax=cpp.doxygen
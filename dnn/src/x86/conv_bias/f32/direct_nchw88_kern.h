@@ -0,0 +1,46 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/direct_nchw88_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/x86/conv_bias/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace avx2_direct_nchw88_f32 {
+
+/*!
+ * \brief direct convolution of a block of output rows of one group
+ *
+ * The source is the padded buffer of IH2 x IW2 pixels per channel, laid out as
+ * (IC/8, IH2, IW2, 8) for NCHW88 and (IC, IH2, IW2) for the hybrid NCHW input.
+ * The filter is (OC/8, IC/8, FH, FW, 8, 8) for NCHW88 and (OC/8, FH, FW, IC, 8)
+ * for the hybrid one. dst and the bias plane in BiasMode::BIAS have OH rows of
+ * OW pixels per pack of 8 output channels, and oh_block rows are computed.
+ */
+#define KERN(layout)                                                             \
+    template <size_t filter, size_t stride, BiasMode bias_mode, typename Op>     \
+    MEGDNN_ATTRIBUTE_TARGET("avx2,fma")                                          \
+    void conv_##layout(                                                          \
+            const float* src, const float* filter_ptr, const float* bias,        \
+            float* dst, size_t IC, size_t OC, size_t IH2, size_t IW2, size_t OH, \
+            size_t oh_block, size_t OW, const Op& op);
+
+KERN(nchw88)
+KERN(nchw_nchw88)
+
+#undef KERN
+
+}  // namespace avx2_direct_nchw88_f32
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,263 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/direct_nchw88_kern_common.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/x86/conv_bias/f32/direct_nchw88_kern.h"
+#include "src/x86/elemwise_op.h"
+
+#include <immintrin.h>
+
+namespace megdnn {
+namespace x86 {
+namespace avx2_direct_nchw88_f32 {
+namespace {
+
+/*!
+ * Shapes of the operands shared by all the blocks of a kernel call; ld_filter
+ * and ld_dst are the number of floats between two packs of 8 output channels
+ */
+struct KernParam {
+    size_t IC, IH2, IW2, ld_filter, ld_dst;
+};
+
+/*!
+ * compute nr_oc packs of output channels by nr_ow output pixels in a row; the
+ * source of NCHW88 is (IC/8, IH2, IW2, 8) and the filter is (IC/8, FH, FW, 8, 8)
+ * in a pack of output channels
+ */
+template <size_t filter, size_t stride, size_t nr_oc, size_t nr_ow>
+struct ComputeNCHW88 {
+    static constexpr size_t src_pack = 8;
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+    static void accumulate(
+            const float* src, const float* filter_ptr, const KernParam& p,
+            __m256 (&acc)[nr_oc][nr_ow]) {
+        for (size_t ic = 0; ic < p.IC; ic += 8) {
+            const float* sptr = src + ic * p.IH2 * p.IW2;
+            const float* fptr = filter_ptr + ic * filter * filter * 8;
+            for (size_t fh = 0; fh < filter; ++fh) {
+                for (size_t fw = 0; fw < filter; ++fw) {
+                    const float* s = sptr + (fh * p.IW2 + fw) * 8;
+                    const float* f = fptr + (fh * filter + fw) * 64;
+                    for (size_t c = 0; c < 8; ++c) {
+                        __m256 w[nr_oc];
+                        for (size_t j = 0; j < nr_oc; ++j) {
+                            w[j] = _mm256_loadu_ps(f + j * p.ld_filter + c * 8);
+                        }
+                        for (size_t i = 0; i < nr_ow; ++i) {
+                            __m256 b = _mm256_broadcast_ss(s + i * stride * 8 + c);
+                            for (size_t j = 0; j < nr_oc; ++j) {
+                                acc[j][i] = _mm256_fmadd_ps(b, w[j], acc[j][i]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+/*!
+ * the hybrid first layer, whose source is (IC, IH2, IW2) and the filter is
+ * (FH, FW, IC, 8) in a pack of output channels
+ */
+template <size_t filter, size_t stride, size_t nr_oc, size_t nr_ow>
+struct ComputeNCHWNCHW88 {
+    static constexpr size_t src_pack = 1;
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+    static void accumulate(
+            const float* src, const float* filter_ptr, const KernParam& p,
+            __m256 (&acc)[nr_oc][nr_ow]) {
+        for (size_t ic = 0; ic < p.IC; ++ic) {
+            const float* sptr = src + ic * p.IH2 * p.IW2;
+            for (size_t fh = 0; fh < filter; ++fh) {
+                for (size_t fw = 0; fw < filter; ++fw) {
+                    const float* s = sptr + fh * p.IW2 + fw;
+                    const float* f = filter_ptr + ((fh * filter + fw) * p.IC + ic) * 8;
+                    __m256 w[nr_oc];
+                    for (size_t j = 0; j < nr_oc; ++j) {
+                        w[j] = _mm256_loadu_ps(f + j * p.ld_filter);
+                    }
+                    for (size_t i = 0; i < nr_ow; ++i) {
+                        __m256 b = _mm256_broadcast_ss(s + i * stride);
+                        for (size_t j = 0; j < nr_oc; ++j) {
+                            acc[j][i] = _mm256_fmadd_ps(b, w[j], acc[j][i]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+//! compute a block of outputs and apply the bias and the activation on them
+template <
+        template <size_t, size_t, size_t, size_t> class Compute, size_t filter,
+        size_t stride, BiasMode bias_mode, typename Op, size_t nr_oc, size_t nr_ow>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+inline void compute_block(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        const KernParam& p, const Op& op) {
+    __m256 acc[nr_oc][nr_ow];
+    for (size_t j = 0; j < nr_oc; ++j) {
+        __m256 init = bias_mode == BiasMode::BROADCAST_CHANNEL_BIAS
+                            ? _mm256_loadu_ps(bias + j * 8)
+                            : _mm256_setzero_ps();
+        for (size_t i = 0; i < nr_ow; ++i) {
+            acc[j][i] = init;
+        }
+    }
+    Compute<filter, stride, nr_oc, nr_ow>::accumulate(src, filter_ptr, p, acc);
+    for (size_t j = 0; j < nr_oc; ++j) {
+        for (size_t i = 0; i < nr_ow; ++i) {
+            if (bias_mode == BiasMode::BIAS) {
+                acc[j][i] = _mm256_add_ps(
+                        acc[j][i], _mm256_loadu_ps(bias + j * p.ld_dst + i * 8));
+            }
+            _mm256_storeu_ps(dst + j * p.ld_dst + i * 8, op(acc[j][i]));
+        }
+    }
+}
+
+//! compute the remaining nr_remain (< nr_ow) outputs of a row
+template <
+        template <size_t, size_t, size_t, size_t> class Compute, size_t filter,
+        size_t stride, BiasMode bias_mode, typename Op, size_t nr_oc, size_t nr_ow>
+struct ComputeRemain {
+    static void run(
+            size_t nr_remain, const float* src, const float* filter_ptr,
+            const float* bias, float* dst, const KernParam& p, const Op& op) {
+        if (nr_remain == nr_ow - 1) {
+            compute_block<Compute, filter, stride, bias_mode, Op, nr_oc, nr_ow - 1>(
+                    src, filter_ptr, bias, dst, p, op);
+        } else {
+            ComputeRemain<Compute, filter, stride, bias_mode, Op, nr_oc, nr_ow - 1>::
+                    run(nr_remain, src, filter_ptr, bias, dst, p, op);
+        }
+    }
+};
+
+template <
+        template <size_t, size_t, size_t, size_t> class Compute, size_t filter,
+        size_t stride, BiasMode bias_mode, typename Op, size_t nr_oc>
+struct ComputeRemain<Compute, filter, stride, bias_mode, Op, nr_oc, 1> {
+    static void run(
+            size_t, const float*, const float*, const float*, float*,
+            const KernParam&, const Op&) {}
+};
+
+/*!
+ * compute nr_oc packs of output channels of oh_block rows; the register
+ * blocking keeps nr_oc * ow_block accumulators, a filter vector per pack and
+ * the broadcast source in the 16 ymm registers
+ */
+template <
+        template <size_t, size_t, size_t, size_t> class Compute, size_t filter,
+        size_t stride, BiasMode bias_mode, typename Op, size_t nr_oc>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void conv_oc_block(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        const KernParam& p, size_t oh_block, size_t OW, const Op& op) {
+    constexpr size_t ow_block = nr_oc == 2 ? 6 : 8;
+    constexpr size_t src_pack = Compute<filter, stride, nr_oc, ow_block>::src_pack;
+    //! the bias offset is only used in BiasMode::BIAS
+    size_t bias_step = bias_mode == BiasMode::BIAS;
+    for (size_t oh = 0; oh < oh_block; ++oh) {
+        const float* sptr = src + oh * stride * p.IW2 * src_pack;
+        const float* bptr = bias + oh * OW * 8 * bias_step;
+        float* dptr = dst + oh * OW * 8;
+        size_t ow = 0;
+        for (; ow + ow_block <= OW; ow += ow_block) {
+            compute_block<Compute, filter, stride, bias_mode, Op, nr_oc, ow_block>(
+                    sptr + ow * stride * src_pack, filter_ptr,
+                    bptr + ow * 8 * bias_step, dptr + ow * 8, p, op);
+        }
+        if (ow < OW) {
+            ComputeRemain<Compute, filter, stride, bias_mode, Op, nr_oc, ow_block>::run(
+                    OW - ow, sptr + ow * stride * src_pack, filter_ptr,
+                    bptr + ow * 8 * bias_step, dptr + ow * 8, p, op);
+        }
+    }
+}
+
+template <
+        template <size_t, size_t, size_t, size_t> class Compute, size_t filter,
+        size_t stride, BiasMode bias_mode, typename Op>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void conv_direct(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        const KernParam& p, size_t OC, size_t oh_block, size_t OW, const Op& op) {
+    //! offset of the bias between two packs of output channels
+    size_t ld_bias = bias_mode == BiasMode::BIAS ? p.ld_dst : 8;
+    if (bias_mode == BiasMode::NO_BIAS) {
+        ld_bias = 0;
+    }
+    size_t oc = 0;
+    for (; oc + 16 <= OC; oc += 16) {
+        conv_oc_block<Compute, filter, stride, bias_mode, Op, 2>(
+                src, filter_ptr + oc / 8 * p.ld_filter, bias + oc / 8 * ld_bias,
+                dst + oc / 8 * p.ld_dst, p, oh_block, OW, op);
+    }
+    if (oc < OC) {
+        conv_oc_block<Compute, filter, stride, bias_mode, Op, 1>(
+                src, filter_ptr + oc / 8 * p.ld_filter, bias + oc / 8 * ld_bias,
+                dst + oc / 8 * p.ld_dst, p, oh_block, OW, op);
+    }
+}
+
+}  // anonymous namespace
+}  // namespace avx2_direct_nchw88_f32
+}  // namespace x86
+}  // namespace megdnn
+
+#define INSTANTIATION(layout, filter, stride, bias_mode, Op)                  \
+    template void                                                             \
+    megdnn::x86::avx2_direct_nchw88_f32::conv_##layout<                       \
+            filter, stride, bias_mode, Op>(                                   \
+            const float*, const float*, const float*, float*, size_t, size_t, \
+            size_t, size_t, size_t, size_t, size_t, const Op&);
+
+#define FOR_OP(layout, filter, stride, bias_mode)              \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            NoneOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            ReluOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)    \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            SigmoidOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>) \
+    INSTANTIATION(                                             \
+            layout, filter, stride, bias_mode,                 \
+            HSwishOp<SIMDType::AVX2 MEGDNN_COMMA dt_float32>)
+
+#define FOR_BIAS(layout, filter, stride)                             \
+    FOR_OP(layout, filter, stride, BiasMode::NO_BIAS)                \
+    FOR_OP(layout, filter, stride, BiasMode::BROADCAST_CHANNEL_BIAS) \
+    FOR_OP(layout, filter, stride, BiasMode::BIAS)
+
+#define FOR_STRIDE(layout, filter) \
+    FOR_BIAS(layout, filter, 1)    \
+    FOR_BIAS(layout, filter, 2)
+
+#define INSTANTIATION_CONV_DIRECT(layout) \
+    FOR_STRIDE(layout, 1)                 \
+    FOR_STRIDE(layout, 2)                 \
+    FOR_STRIDE(layout, 3)                 \
+    FOR_STRIDE(layout, 4)                 \
+    FOR_STRIDE(layout, 5)                 \
+    FOR_STRIDE(layout, 6)                 \
+    FOR_STRIDE(layout, 7)
+
+// vim: syntax=cpp.doxygen
@@ -174,6 +174,77 @@ bool direct_avx2_stride2_int8_usable_preferred(
            direct_avx2_stride2_int8_preferred(param);
 }
 
+#if MEGDNN_X86_WITH_VNNI
+bool direct_vnni_int8_usable(const ConvBiasImpl::NCBKernSizeParam& param) {
+    auto&& fm = param.filter_meta;
+    auto FH = fm.spatial[0];
+    bool aviliable = (param.bias_mode != BiasMode::BIAS) &&
+                     ((param.src_type.enumv() == DTypeEnum::QuantizedS8 &&
+                       param.filter_type.enumv() == DTypeEnum::QuantizedS8 &&
+                       param.dst_type.enumv() == DTypeEnum::QuantizedS8) ||
+                      (((param.src_type.enumv() == DTypeEnum::Int8 &&
+                         param.filter_type.enumv() == DTypeEnum::Int8 &&
+                         param.dst_type.enumv() == DTypeEnum::Int32) ||
+                        (param.src_type.enumv() == DTypeEnum::QuantizedS8 &&
+                         param.filter_type.enumv() == DTypeEnum::QuantizedS8 &&
+                         param.dst_type.enumv() == DTypeEnum::QuantizedS32)) &&
+                       param.nonlineMode == NonlineMode::IDENTITY)) &&
+                     fm.format == ConvBiasImpl::Param::Format::NCHW &&
+                     fm.spatial_ndim == 2 && fm.dilation[0] == 1 &&
+                     fm.dilation[1] == 1 && !fm.should_flip && FH >= 1 && FH <= 7 &&
+                     fm.spatial[1] == FH && (fm.stride[0] == 1 || fm.stride[0] == 2) &&
+                     fm.stride[1] == fm.stride[0] && is_supported(SIMDType::VNNI);
+    return aviliable;
+}
+
+bool direct_vnni_int8_preferred(const ConvBiasImpl::NCBKernSizeParam& param) {
+    auto&& fm = param.filter_meta;
+    //! wide layers are left to the vnni im2col, whose matmul reuses the packed
+    //! source across more output channels
+    //! TODO: an NCHW88/NCHW16 im2col strategy with the requantization fused
+    //! into the vnni matmul kernel; the NCHW im2col still requantizes each int32
+    //! block in a separate PostProcess
+    return !(fm.icpg >= 64 && fm.ocpg >= 64);
+}
+
+bool direct_vnni_int8_usable_preferred(const ConvBiasImpl::NCBKernSizeParam& param) {
+    return direct_vnni_int8_usable(param) && direct_vnni_int8_preferred(param);
+}
+
+bool chanwise_vnni_qint8_usable(const ConvBiasImpl::NCBKernSizeParam& param) {
+    auto&& fm = param.filter_meta;
+    auto FH = fm.spatial[0];
+    bool aviliable = (param.bias_mode != BiasMode::BIAS) &&
+                     ((param.src_type.enumv() == DTypeEnum::QuantizedS8 &&
+                       param.filter_type.enumv() == DTypeEnum::QuantizedS8 &&
+                       param.dst_type.enumv() == DTypeEnum::QuantizedS8) ||
+                      (((param.src_type.enumv() == DTypeEnum::Int8 &&
+                         param.filter_type.enumv() == DTypeEnum::Int8 &&
+                         param.dst_type.enumv() == DTypeEnum::Int32) ||
+                        (param.src_type.enumv() == DTypeEnum::QuantizedS8 &&
+                         param.filter_type.enumv() == DTypeEnum::QuantizedS8 &&
+                         param.dst_type.enumv() == DTypeEnum::QuantizedS32)) &&
+                       param.nonlineMode == NonlineMode::IDENTITY)) &&
+                     fm.format == ConvBiasImpl::Param::Format::NCHW &&
+                     fm.spatial_ndim == 2 && fm.dilation[0] == 1 &&
+                     fm.dilation[1] == 1 && !fm.should_flip &&
+                     (FH == 2 || FH == 3 || FH == 5 || FH == 7) &&
+                     fm.spatial[1] == FH && (fm.stride[0] == 1 || fm.stride[0] == 2) &&
+                     fm.stride[1] == fm.stride[0] && (fm.icpg == 1) && (fm.ocpg == 1) &&
+                     is_supported(SIMDType::VNNI);
+    return aviliable;
+}
+
+bool chanwise_vnni_qint8_preferred(const ConvBiasImpl::NCBKernSizeParam& param) {
+    MEGDNN_MARK_USED_VAR(param);
+    return true;
+}
+
+bool chanwise_vnni_qint8_usable_preferred(const ConvBiasImpl::NCBKernSizeParam& param) {
+    return chanwise_vnni_qint8_usable(param) && chanwise_vnni_qint8_preferred(param);
+}
+#endif
+
 #if MEGDNN_X86_WITH_MKL_DNN
 bool mkldnn_qint8_usable(const ConvBiasImpl::NCBKernSizeParam& param) {
     auto&& fm = param.filter_meta;
@@ -35,6 +35,16 @@ bool direct_avx2_stride2_int8_usable(const ConvBiasImpl::NCBKernSizeParam&);
 bool direct_avx2_stride2_int8_preferred(const ConvBiasImpl::NCBKernSizeParam&);
 bool direct_avx2_stride2_int8_usable_preferred(const ConvBiasImpl::NCBKernSizeParam&);
 
+#if MEGDNN_X86_WITH_VNNI
+bool direct_vnni_int8_usable(const ConvBiasImpl::NCBKernSizeParam&);
+bool direct_vnni_int8_preferred(const ConvBiasImpl::NCBKernSizeParam&);
+bool direct_vnni_int8_usable_preferred(const ConvBiasImpl::NCBKernSizeParam&);
+
+bool chanwise_vnni_qint8_usable(const ConvBiasImpl::NCBKernSizeParam&);
+bool chanwise_vnni_qint8_preferred(const ConvBiasImpl::NCBKernSizeParam&);
+bool chanwise_vnni_qint8_usable_preferred(const ConvBiasImpl::NCBKernSizeParam&);
+#endif
+
 #if MEGDNN_X86_WITH_MKL_DNN
 bool mkldnn_qint8_usable(const ConvBiasImpl::NCBKernSizeParam&);
 bool mkldnn_qint8_preferred(const ConvBiasImpl::NCBKernSizeParam&);
@@ -19,6 +19,8 @@
 #include "src/x86/conv_bias/int8/avx2_chanwise_stride2.h"
 #include "src/x86/conv_bias/int8/avx2_direct_conv_stride1.h"
 #include "src/x86/conv_bias/int8/avx2_direct_conv_stride2.h"
+#include "src/x86/conv_bias/int8/vnni_chanwise_conv.h"
+#include "src/x86/conv_bias/int8/vnni_direct_conv.h"
 #include "src/x86/conv_bias/opr_impl.h"
 #include "src/x86/conv_bias/postprocess_helper.h"
 #include "src/x86/handle.h"
@@ -238,6 +240,62 @@ bool ConvBiasImpl::AlgoAVX2DirectConvStride2::is_preferred(
     return direct_avx2_stride2_int8_preferred(param);
 }
 
+#if MEGDNN_X86_WITH_VNNI
+/* ===================== vnni int8 direct ===================== */
+bool ConvBiasImpl::AlgoDirectVnniInt8::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    return direct_vnni_int8_usable(param);
+}
+
+WorkspaceBundle ConvBiasImpl::AlgoDirectVnniInt8::get_bundle(
+        const NCBKernSizeParam& param) {
+    return direct_conv_vnni::get_bundle(param);
+}
+
+size_t ConvBiasImpl::AlgoDirectVnniInt8::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return get_bundle(param).total_size_in_bytes();
+}
+
+SmallVector<fallback::ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoDirectVnniInt8::
+        get_kimpls(const NCBKernSizeParam& param) const {
+    auto bundle = get_bundle(param);
+    return direct_conv_vnni::get_kimpls(param, bundle);
+}
+
+bool ConvBiasImpl::AlgoDirectVnniInt8::is_preferred(
+        const NCBKernSizeParam& param) const {
+    return direct_vnni_int8_preferred(param);
+}
+
+/* ===================== vnni int8 chanwise ===================== */
+bool ConvBiasImpl::AlgoChanWiseVnniQint8::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    return chanwise_vnni_qint8_usable(param);
+}
+
+WorkspaceBundle ConvBiasImpl::AlgoChanWiseVnniQint8::get_bundle(
+        const NCBKernSizeParam& param) {
+    return chanwise_conv_vnni::get_bundle(param);
+}
+
+size_t ConvBiasImpl::AlgoChanWiseVnniQint8::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return get_bundle(param).total_size_in_bytes();
+}
+
+SmallVector<fallback::ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoChanWiseVnniQint8::
+        get_kimpls(const NCBKernSizeParam& param) const {
+    auto bundle = get_bundle(param);
+    return chanwise_conv_vnni::get_kimpls(param, bundle);
+}
+
+bool ConvBiasImpl::AlgoChanWiseVnniQint8::is_preferred(
+        const NCBKernSizeParam& param) const {
+    return chanwise_vnni_qint8_preferred(param);
+}
+#endif
+
 #if MEGDNN_X86_WITH_MKL_DNN
 bool ConvBiasImpl::AlgoMkldnnQint8::usable(
         const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
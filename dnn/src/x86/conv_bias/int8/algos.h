@@ -118,6 +118,54 @@ public:
     MEGDNN_DECL_ALGO_TYPE(X86_DIRECT_AVX2_STRD2_INT8)
 };
 
+#if MEGDNN_X86_WITH_VNNI
+/* ===================== vnni int8 direct algo ===================== */
+class ConvBiasImpl::AlgoDirectVnniInt8 final : public AlgoBase {
+    SmallVector<NCBKern> get_kimpls(const NCBKernSizeParam& param) const;
+    static WorkspaceBundle get_bundle(const NCBKernSizeParam& param);
+
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_CONV_BIAS_DIRECT_VNNI_INT8"; }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override {
+        return get_kimpls(param);
+    }
+    bool is_preferred(const NCBKernSizeParam& param) const override;
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::QINT8X8X32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_DIRECT_VNNI_INT8)
+};
+
+/* ===================== vnni chanwise algo ===================== */
+class ConvBiasImpl::AlgoChanWiseVnniQint8 final : public AlgoBase {
+    SmallVector<NCBKern> get_kimpls(const NCBKernSizeParam& param) const;
+    static WorkspaceBundle get_bundle(const NCBKernSizeParam& param);
+
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_CONV_BIAS_CHANWISE_VNNI_INT8"; }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override {
+        return get_kimpls(param);
+    }
+    bool is_preferred(const NCBKernSizeParam& param) const override;
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::QINT8X8X32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_CHANWISE_VNNI_QINT8)
+};
+#endif
+
 #if MEGDNN_X86_WITH_MKL_DNN
 /* ===================== mkldnn qint8 algo ===================== */
 class ConvBiasImpl::AlgoMkldnnQint8 final : public AlgoBase {
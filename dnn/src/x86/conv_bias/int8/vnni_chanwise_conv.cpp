@@ -0,0 +1,206 @@
+/**
+ * \file dnn/src/x86/conv_bias/int8/vnni_chanwise_conv.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/conv_bias/int8/vnni_chanwise_conv.h"
+
+#if MEGDNN_X86_WITH_VNNI
+#include "src/x86/conv_bias/int8/vnni_common_helper.h"
+
+#include <immintrin.h>
+#include <cstring>
+
+namespace megdnn {
+namespace x86 {
+namespace chanwise_conv_vnni {
+
+namespace {
+
+using namespace vnni_conv;
+
+constexpr size_t TAP_STEP = 4;
+constexpr size_t OW_STEP = 16;
+constexpr size_t NR_VEC = 4;
+
+/*!
+ * The filter taps of a row are split into NG groups of 4, each group being a
+ * dword of the packed filter. The source of a channel is packed as
+ * (IH2, JW, 4) uint8 where the element (ih, j, k) is the padded pixel
+ * (ih, j * SW + k), so that tap group g of output pixel p is the dword
+ * (ih, p + 4 * g / SW) and 16 consecutive outputs are 64 contiguous bytes.
+ */
+struct Shape {
+    size_t IH, IW, OH, OW, FH, FW, PH, PW, SH, SW;
+    size_t NG, IH2, JW;
+
+    Shape(const ConvBiasImpl::NCBKernSizeParam& param) {
+        auto&& fm = param.filter_meta;
+        IH = param.isz[0];
+        IW = param.isz[1];
+        OH = param.osz[0];
+        OW = param.osz[1];
+        FH = fm.spatial[0];
+        FW = fm.spatial[1];
+        PH = fm.padding[0];
+        PW = fm.padding[1];
+        SH = fm.stride[0];
+        SW = fm.stride[1];
+        NG = div_ceil(FW, TAP_STEP);
+        IH2 = (OH - 1) * SH + FH;
+        JW = round_up(OW, OW_STEP) + TAP_STEP * (NG - 1) / SW;
+    }
+
+    size_t packed_src_size() const { return IH2 * JW * TAP_STEP; }
+};
+
+void pack_src(const int8_t* src, uint8_t* packed, const Shape& s) {
+    for (size_t ih2 = 0; ih2 < s.IH2; ++ih2) {
+        size_t ih = ih2 - s.PH;
+        uint8_t* out = packed + ih2 * s.JW * TAP_STEP;
+        if (ih >= s.IH) {
+            std::memset(out, SRC_ZERO, s.JW * TAP_STEP);
+            continue;
+        }
+        const int8_t* sptr = src + ih * s.IW;
+        for (size_t j = 0; j < s.JW; ++j) {
+            for (size_t k = 0; k < TAP_STEP; ++k) {
+                size_t iw = j * s.SW + k - s.PW;
+                out[j * TAP_STEP + k] = to_u8(iw < s.IW ? sptr[iw] : 0);
+            }
+        }
+    }
+}
+
+//! pack the filter into (FH, NG, 4) with zero taps and return the compensation
+int32_t pack_filter(const int8_t* filter, int8_t* packed, const Shape& s) {
+    int32_t sum = 0;
+    for (size_t fh = 0; fh < s.FH; ++fh) {
+        for (size_t fw = 0; fw < s.NG * TAP_STEP; ++fw) {
+            int8_t v = fw < s.FW ? filter[fh * s.FW + fw] : 0;
+            *(packed++) = v;
+            sum += v;
+        }
+    }
+    return sum * SRC_ZERO;
+}
+
+template <size_t nr_vec>
+MEGDNN_ATTRIBUTE_TARGET("avx512f,avx512vnni")
+void compute(
+        const uint8_t* src, const int8_t* filter, int32_t init, int32_t* dst,
+        const Shape& s, __mmask16 tail_mask) {
+    __m512i acc[nr_vec];
+    for (size_t v = 0; v < nr_vec; ++v) {
+        acc[v] = _mm512_set1_epi32(init);
+    }
+    for (size_t fh = 0; fh < s.FH; ++fh) {
+        const uint8_t* srow = src + fh * s.JW * TAP_STEP;
+        const int8_t* frow = filter + fh * s.NG * TAP_STEP;
+        for (size_t g = 0; g < s.NG; ++g) {
+            const uint8_t* sptr = srow + TAP_STEP * g / s.SW * TAP_STEP;
+            __m512i fv = _mm512_set1_epi32(
+                    *reinterpret_cast<const int32_t*>(frow + g * TAP_STEP));
+            for (size_t v = 0; v < nr_vec; ++v) {
+                acc[v] = _mm512_dpbusd_epi32(
+                        acc[v], _mm512_loadu_si512(sptr + v * OW_STEP * TAP_STEP),
+                        fv);
+            }
+        }
+    }
+    for (size_t v = 0; v + 1 < nr_vec; ++v) {
+        _mm512_storeu_si512(dst + v * OW_STEP, acc[v]);
+    }
+    _mm512_mask_storeu_epi32(dst + (nr_vec - 1) * OW_STEP, tail_mask, acc[nr_vec - 1]);
+}
+
+void do_conv_kern(
+        const WorkspaceBundle& bundle, const ConvBiasImpl::NCBKernParam& kern_param,
+        const ConvBiasImpl::NCBKernIndex& ncb_index) {
+    Shape s(kern_param);
+    size_t thread_id = ncb_index.thread_id;
+    size_t group_id = ncb_index.ndrange_id[0], batch_id = ncb_index.ndrange_id[1];
+
+    uint8_t* packed_src = static_cast<uint8_t*>(bundle.get(0)) +
+                          thread_id * s.packed_src_size();
+    pack_src(kern_param.src<int8_t>(batch_id, group_id), packed_src, s);
+    int8_t filter[7 * 8];
+    int32_t comp = pack_filter(kern_param.filter<int8_t>(group_id), filter, s);
+    int32_t init;
+    get_acc_init(kern_param, &comp, batch_id, group_id, 0, 1, &init);
+
+    int32_t* tmp = nullptr;
+    if (kern_param.dst_type.enumv() == DTypeEnum::QuantizedS8) {
+        tmp = static_cast<int32_t*>(bundle.get(1)) + thread_id * s.OH * s.OW;
+    }
+    int32_t* dst = get_conv_dst(kern_param, tmp, batch_id, group_id, 0);
+
+    const size_t row_stride = s.JW * TAP_STEP;
+    for (size_t oh = 0; oh < s.OH; ++oh) {
+        const uint8_t* sptr = packed_src + oh * s.SH * row_stride;
+        int32_t* dptr = dst + oh * s.OW;
+        for (size_t ow = 0; ow < s.OW; ow += NR_VEC * OW_STEP) {
+            size_t nr_ow = std::min(NR_VEC * OW_STEP, s.OW - ow);
+            size_t nr_vec = div_ceil(nr_ow, OW_STEP);
+            size_t tail = nr_ow - (nr_vec - 1) * OW_STEP;
+            __mmask16 tail_mask = static_cast<__mmask16>((1u << tail) - 1);
+#define cb(_nr_vec)                                                           \
+    case _nr_vec:                                                             \
+        compute<_nr_vec>(                                                     \
+                sptr + ow * TAP_STEP, filter, init, dptr + ow, s, tail_mask); \
+        break;
+            switch (nr_vec) {
+                cb(1);
+                cb(2);
+                cb(3);
+                cb(4);
+                default:
+                    megdnn_assert(0);
+            }
+#undef cb
+        }
+    }
+    post_process(kern_param, dst, batch_id, group_id, 0, 1);
+}
+
+}  // namespace
+
+WorkspaceBundle get_bundle(const NCBKernSizeParam& param) {
+    Shape s(param);
+    size_t nr_threads = param.nr_threads;
+    size_t src_size = nr_threads * s.packed_src_size();
+    if (param.dst_type.enumv() == DTypeEnum::QuantizedS8) {
+        size_t tmp_size = nr_threads * s.OH * s.OW * sizeof(int32_t);
+        return WorkspaceBundle(nullptr, {src_size, tmp_size});
+    }
+    return WorkspaceBundle(nullptr, {src_size});
+}
+
+SmallVector<NCBKern> get_kimpls(
+        const NCBKernSizeParam& kern_param, const WorkspaceBundle& bundle) {
+    size_t N = kern_param.n;
+    size_t group = kern_param.filter_meta.group;
+    auto exec_one_group = [bundle = bundle](
+                                  const ConvBiasImpl::NCBKernParam& kern_param,
+                                  const ConvBiasImpl::NCBKernIndex& ncb_index) mutable {
+        bundle.set(kern_param.workspace_ptr);
+        do_conv_kern(bundle, kern_param, ncb_index);
+    };
+    SmallVector<NCBKern> ncb_kerns;
+    ncb_kerns.push_back({exec_one_group, {group, N, 1_z}});
+    return ncb_kerns;
+}
+
+}  // namespace chanwise_conv_vnni
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
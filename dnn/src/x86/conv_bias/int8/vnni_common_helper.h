@@ -0,0 +1,85 @@
+/**
+ * \file dnn/src/x86/conv_bias/int8/vnni_common_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#if MEGDNN_X86_WITH_VNNI
+#include "src/x86/conv_bias/opr_impl.h"
+#include "src/x86/conv_bias/postprocess_helper.h"
+
+namespace megdnn {
+namespace x86 {
+namespace vnni_conv {
+
+/*!
+ * VNNI multiplies unsigned by signed bytes, so the source is packed as
+ * src ^ 0x80, i.e. src + 128 in uint8; the extra 128 * sum(filter) of each
+ * output channel is subtracted by initializing the accumulator with it
+ */
+static constexpr uint8_t SRC_ZERO = 0x80;
+
+static inline uint8_t to_u8(int8_t v) {
+    return static_cast<uint8_t>(v) ^ SRC_ZERO;
+}
+
+/*!
+ * get the initial value of the accumulator of nr_oc output channels starting
+ * at oc_start, i.e. the channel bias minus the compensation of the filter
+ */
+static inline void get_acc_init(
+        const ConvBiasImpl::NCBKernParam& kern_param, const int32_t* comp,
+        size_t batch_id, size_t group_id, size_t oc_start, size_t nr_oc,
+        int32_t* init) {
+    const dt_int32* bias_ptr = kern_param.bias<dt_int32>(batch_id, group_id);
+    for (size_t i = 0; i < nr_oc; ++i) {
+        init[i] = -comp[i];
+        if (kern_param.bias_mode == BiasMode::BROADCAST_CHANNEL_BIAS) {
+            init[i] += bias_ptr[oc_start + i];
+        }
+    }
+}
+
+/*!
+ * apply the nonlinearity and requantize nr_oc output channels starting at
+ * oc_start, whose int32 results with bias are in conv_dst; nothing is done if
+ * conv_dst is the dst tensor itself
+ */
+static inline void post_process(
+        const ConvBiasImpl::NCBKernParam& kern_param, int32_t* conv_dst,
+        size_t batch_id, size_t group_id, size_t oc_start, size_t nr_oc) {
+    size_t OH = kern_param.osz[0], OW = kern_param.osz[1];
+    if (kern_param.dst_type.enumv() != DTypeEnum::QuantizedS8) {
+        return;
+    }
+    dt_qint8* dst_ptr =
+            kern_param.dst<dt_qint8>(batch_id, group_id) + oc_start * OH * OW;
+    PostProcess<dt_qint32, dt_qint8, PostprocessMode::QUANTIZED>::run(
+            conv_dst, nullptr, dst_ptr, BiasMode::NO_BIAS, kern_param.nonlineMode,
+            kern_param.bias_type, kern_param.dst_type, 1, nr_oc, OH, OW);
+}
+
+//! get the int32 output of nr_oc channels starting at oc_start
+static inline int32_t* get_conv_dst(
+        const ConvBiasImpl::NCBKernParam& kern_param, int32_t* tmp, size_t batch_id,
+        size_t group_id, size_t oc_start) {
+    if (kern_param.dst_type.enumv() == DTypeEnum::QuantizedS8) {
+        return tmp;
+    }
+    return kern_param.dst<int32_t>(batch_id, group_id) +
+           oc_start * kern_param.osz[0] * kern_param.osz[1];
+}
+
+}  // namespace vnni_conv
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,307 @@
+/**
+ * \file dnn/src/x86/conv_bias/int8/vnni_direct_conv.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/conv_bias/int8/vnni_direct_conv.h"
+
+#if MEGDNN_X86_WITH_VNNI
+#include "src/x86/conv_bias/int8/vnni_common_helper.h"
+
+#include <immintrin.h>
+#include <cstring>
+
+namespace megdnn {
+namespace x86 {
+namespace direct_conv_vnni {
+
+namespace {
+
+using namespace vnni_conv;
+
+constexpr size_t IC_STEP = 4;
+constexpr size_t OC_STEP = 4;
+constexpr size_t OW_STEP = 16;
+constexpr size_t NR_VEC = 4;
+
+/*!
+ * The source of a group is packed as (IC/4, IH2, SW, IWP, 4) uint8: the
+ * padded column x of a row lands in phase x % SW at index x / SW, so that
+ * OW_STEP consecutive outputs read 64 contiguous bytes for every filter tap
+ * whatever the stride is. The filter is packed as (OC, IC/4, FH, FW, 4).
+ */
+struct Shape {
+    size_t IC, OC, IH, IW, OH, OW, FH, FW, PH, PW, SH, SW;
+    size_t IC4, IH2, IWP;
+
+    Shape(const ConvBiasImpl::NCBKernSizeParam& param) {
+        auto&& fm = param.filter_meta;
+        IC = fm.icpg;
+        OC = fm.ocpg;
+        IH = param.isz[0];
+        IW = param.isz[1];
+        OH = param.osz[0];
+        OW = param.osz[1];
+        FH = fm.spatial[0];
+        FW = fm.spatial[1];
+        PH = fm.padding[0];
+        PW = fm.padding[1];
+        SH = fm.stride[0];
+        SW = fm.stride[1];
+        IC4 = div_ceil(IC, IC_STEP);
+        IH2 = (OH - 1) * SH + FH;
+        IWP = round_up(OW, OW_STEP) + (FW - 1) / SW;
+    }
+
+    size_t packed_src_size() const { return IC4 * IH2 * SW * IWP * IC_STEP; }
+    size_t packed_filter_size() const { return OC * IC4 * FH * FW * IC_STEP; }
+};
+
+void pack_src(
+        const WorkspaceBundle& bundle, const ConvBiasImpl::NCBKernParam& kern_param,
+        const ConvBiasImpl::NCBKernIndex& ncb_index) {
+    Shape s(kern_param);
+    size_t group = kern_param.filter_meta.group;
+    size_t group_id = ncb_index.ndrange_id[0], batch_id = ncb_index.ndrange_id[1],
+           ic4 = ncb_index.ndrange_id[2];
+    const int8_t* src = kern_param.src<int8_t>(batch_id, group_id);
+    uint8_t* packed = static_cast<uint8_t*>(bundle.get(0)) +
+                      (batch_id * group + group_id) * s.packed_src_size() +
+                      ic4 * s.IH2 * s.SW * s.IWP * IC_STEP;
+    size_t nr_ic = std::min(IC_STEP, s.IC - ic4 * IC_STEP);
+    for (size_t ih2 = 0; ih2 < s.IH2; ++ih2) {
+        size_t ih = ih2 - s.PH;
+        for (size_t ph = 0; ph < s.SW; ++ph) {
+            uint8_t* out = packed + (ih2 * s.SW + ph) * s.IWP * IC_STEP;
+            if (ih >= s.IH) {
+                std::memset(out, SRC_ZERO, s.IWP * IC_STEP);
+                continue;
+            }
+            for (size_t idx = 0; idx < s.IWP; ++idx) {
+                size_t iw = idx * s.SW + ph - s.PW;
+                for (size_t c = 0; c < IC_STEP; ++c) {
+                    int8_t v = 0;
+                    if (c < nr_ic && iw < s.IW) {
+                        v = src[((ic4 * IC_STEP + c) * s.IH + ih) * s.IW + iw];
+                    }
+                    out[idx * IC_STEP + c] = to_u8(v);
+                }
+            }
+        }
+    }
+}
+
+//! pack the filter of an output channel and compute its compensation
+void pack_filter(
+        const WorkspaceBundle& bundle, const ConvBiasImpl::NCBKernParam& kern_param,
+        const ConvBiasImpl::NCBKernIndex& ncb_index) {
+    Shape s(kern_param);
+    size_t group_id = ncb_index.ndrange_id[0], oc = ncb_index.ndrange_id[1];
+    const int8_t* filter =
+            kern_param.filter<int8_t>(group_id) + oc * s.IC * s.FH * s.FW;
+    int8_t* packed = static_cast<int8_t*>(bundle.get(1)) +
+                     group_id * s.packed_filter_size() +
+                     oc * s.IC4 * s.FH * s.FW * IC_STEP;
+    int32_t* comp = static_cast<int32_t*>(bundle.get(2)) + group_id * s.OC + oc;
+    int32_t sum = 0;
+    for (size_t ic4 = 0; ic4 < s.IC4; ++ic4) {
+        for (size_t fh = 0; fh < s.FH; ++fh) {
+            for (size_t fw = 0; fw < s.FW; ++fw) {
+                for (size_t c = 0; c < IC_STEP; ++c) {
+                    size_t ic = ic4 * IC_STEP + c;
+                    int8_t v = ic < s.IC ? filter[(ic * s.FH + fh) * s.FW + fw] : 0;
+                    *(packed++) = v;
+                    sum += v;
+                }
+            }
+        }
+    }
+    *comp = sum * SRC_ZERO;
+}
+
+/*!
+ * compute nr_oc output channels by nr_vec * 16 output pixels of a row; src
+ * points to the first packed row of the output row and tail_mask selects the
+ * valid pixels of the last vector
+ */
+template <size_t nr_oc, size_t nr_vec>
+MEGDNN_ATTRIBUTE_TARGET("avx512f,avx512vnni")
+void compute(
+        const uint8_t* src, const int8_t* filter, const int32_t* init, int32_t* dst,
+        const Shape& s, __mmask16 tail_mask) {
+    const size_t row_stride = s.SW * s.IWP * IC_STEP;
+    const size_t ld_filter = s.IC4 * s.FH * s.FW * IC_STEP;
+    const size_t ld_dst = s.OH * s.OW;
+    __m512i acc[nr_oc][nr_vec];
+    for (size_t j = 0; j < nr_oc; ++j) {
+        __m512i vinit = _mm512_set1_epi32(init[j]);
+        for (size_t v = 0; v < nr_vec; ++v) {
+            acc[j][v] = vinit;
+        }
+    }
+    for (size_t ic4 = 0; ic4 < s.IC4; ++ic4) {
+        for (size_t fh = 0; fh < s.FH; ++fh) {
+            const uint8_t* srow = src + (ic4 * s.IH2 + fh) * row_stride;
+            const int8_t* frow = filter + (ic4 * s.FH + fh) * s.FW * IC_STEP;
+            for (size_t fw = 0; fw < s.FW; ++fw) {
+                const uint8_t* sptr =
+                        srow + ((fw % s.SW) * s.IWP + fw / s.SW) * IC_STEP;
+                __m512i sv[nr_vec];
+                for (size_t v = 0; v < nr_vec; ++v) {
+                    sv[v] = _mm512_loadu_si512(sptr + v * OW_STEP * IC_STEP);
+                }
+                for (size_t j = 0; j < nr_oc; ++j) {
+                    __m512i fv = _mm512_set1_epi32(*reinterpret_cast<const int32_t*>(
+                            frow + j * ld_filter + fw * IC_STEP));
+                    for (size_t v = 0; v < nr_vec; ++v) {
+                        acc[j][v] = _mm512_dpbusd_epi32(acc[j][v], sv[v], fv);
+                    }
+                }
+            }
+        }
+    }
+    for (size_t j = 0; j < nr_oc; ++j) {
+        for (size_t v = 0; v + 1 < nr_vec; ++v) {
+            _mm512_storeu_si512(dst + j * ld_dst + v * OW_STEP, acc[j][v]);
+        }
+        _mm512_mask_storeu_epi32(
+                dst + j * ld_dst + (nr_vec - 1) * OW_STEP, tail_mask,
+                acc[j][nr_vec - 1]);
+    }
+}
+
+template <size_t nr_oc>
+void conv_oc_block(
+        const uint8_t* src, const int8_t* filter, const int32_t* init, int32_t* dst,
+        const Shape& s) {
+    const size_t row_stride = s.SW * s.IWP * IC_STEP;
+    for (size_t oh = 0; oh < s.OH; ++oh) {
+        const uint8_t* sptr = src + oh * s.SH * row_stride;
+        int32_t* dptr = dst + oh * s.OW;
+        for (size_t ow = 0; ow < s.OW; ow += NR_VEC * OW_STEP) {
+            size_t nr_ow = std::min(NR_VEC * OW_STEP, s.OW - ow);
+            size_t nr_vec = div_ceil(nr_ow, OW_STEP);
+            size_t tail = nr_ow - (nr_vec - 1) * OW_STEP;
+            __mmask16 tail_mask = static_cast<__mmask16>((1u << tail) - 1);
+#define cb(_nr_vec)                                                          \
+    case _nr_vec:                                                            \
+        compute<nr_oc, _nr_vec>(                                             \
+                sptr + ow * IC_STEP, filter, init, dptr + ow, s, tail_mask); \
+        break;
+            switch (nr_vec) {
+                cb(1);
+                cb(2);
+                cb(3);
+                cb(4);
+                default:
+                    megdnn_assert(0);
+            }
+#undef cb
+        }
+    }
+}
+
+void do_conv_kern(
+        const WorkspaceBundle& bundle, const ConvBiasImpl::NCBKernParam& kern_param,
+        const ConvBiasImpl::NCBKernIndex& ncb_index) {
+    Shape s(kern_param);
+    size_t group = kern_param.filter_meta.group;
+    size_t group_id = ncb_index.ndrange_id[0], batch_id = ncb_index.ndrange_id[1],
+           oc_start = ncb_index.ndrange_id[2] * OC_STEP;
+    size_t nr_oc = std::min(OC_STEP, s.OC - oc_start);
+
+    const uint8_t* src = static_cast<const uint8_t*>(bundle.get(0)) +
+                         (batch_id * group + group_id) * s.packed_src_size();
+    const int8_t* filter = static_cast<const int8_t*>(bundle.get(1)) +
+                           group_id * s.packed_filter_size() +
+                           oc_start * s.IC4 * s.FH * s.FW * IC_STEP;
+    const int32_t* comp =
+            static_cast<const int32_t*>(bundle.get(2)) + group_id * s.OC + oc_start;
+    int32_t init[OC_STEP];
+    get_acc_init(kern_param, comp, batch_id, group_id, oc_start, nr_oc, init);
+    int32_t* tmp = nullptr;
+    if (kern_param.dst_type.enumv() == DTypeEnum::QuantizedS8) {
+        tmp = static_cast<int32_t*>(bundle.get(3)) +
+              ncb_index.thread_id * OC_STEP * s.OH * s.OW;
+    }
+    int32_t* dst = get_conv_dst(kern_param, tmp, batch_id, group_id, oc_start);
+
+    switch (nr_oc) {
+#define cb(_nr_oc)                                        \
+    case _nr_oc:                                          \
+        conv_oc_block<_nr_oc>(src, filter, init, dst, s); \
+        break;
+        cb(1);
+        cb(2);
+        cb(3);
+        cb(4);
+        default:
+            megdnn_assert(0);
+#undef cb
+    }
+    post_process(kern_param, dst, batch_id, group_id, oc_start, nr_oc);
+}
+
+}  // namespace
+
+WorkspaceBundle get_bundle(const NCBKernSizeParam& param) {
+    Shape s(param);
+    size_t group = param.filter_meta.group;
+    size_t src_size = param.n * group * s.packed_src_size();
+    size_t filter_size = group * s.packed_filter_size();
+    size_t comp_size = group * s.OC * sizeof(int32_t);
+    if (param.dst_type.enumv() == DTypeEnum::QuantizedS8) {
+        size_t tmp_size = param.nr_threads * OC_STEP * s.OH * s.OW * sizeof(int32_t);
+        return WorkspaceBundle(nullptr, {src_size, filter_size, comp_size, tmp_size});
+    }
+    return WorkspaceBundle(nullptr, {src_size, filter_size, comp_size});
+}
+
+SmallVector<NCBKern> get_kimpls(
+        const NCBKernSizeParam& kern_param, const WorkspaceBundle& bundle) {
+    SmallVector<NCBKern> ncb_kerns;
+    auto&& fm = kern_param.filter_meta;
+    size_t N = kern_param.n;
+    size_t IC = fm.icpg;
+    size_t OC = fm.ocpg;
+    size_t group = fm.group;
+#define cb(task)                                                               \
+    auto task = [bundle = bundle, tmp_func](                                   \
+                        const ConvBiasImpl::NCBKernParam& kern_param,          \
+                        const ConvBiasImpl::NCBKernIndex& ncb_index) mutable { \
+        bundle.set(kern_param.workspace_ptr);                                  \
+        tmp_func(                                                              \
+                bundle, kern_param,                                            \
+                {ncb_index.thread_id,                                          \
+                 {ncb_index.ndrange_id[0], ncb_index.ndrange_id[1],            \
+                  ncb_index.ndrange_id[2]}});                                  \
+    };
+    auto tmp_func = pack_src;
+    cb(pack_src_task);
+    ncb_kerns.push_back({pack_src_task, {group, N, div_ceil(IC, IC_STEP)}});
+
+    tmp_func = pack_filter;
+    cb(pack_filter_task);
+    ncb_kerns.push_back({pack_filter_task, {group, OC, 1_z}});
+
+    tmp_func = do_conv_kern;
+    cb(conv_task);
+    ncb_kerns.push_back({conv_task, {group, N, div_ceil(OC, OC_STEP)}});
+#undef cb
+
+    return ncb_kerns;
+}
+
+}  // namespace direct_conv_vnni
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,34 @@
+/**
+ * \file dnn/src/x86/conv_bias/int8/vnni_direct_conv.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#if MEGDNN_X86_WITH_VNNI
+#include "src/x86/conv_bias/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace direct_conv_vnni {
+
+using NCBKern = fallback::ConvBiasImpl::NCBKern;
+using NCBKernSizeParam = fallback::ConvBiasImpl::NCBKernSizeParam;
+
+WorkspaceBundle get_bundle(const NCBKernSizeParam& param);
+
+SmallVector<NCBKern> get_kimpls(
+        const NCBKernSizeParam& param, const WorkspaceBundle& bundle);
+
+}  // namespace direct_conv_vnni
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -38,6 +38,14 @@ class ConvBiasImpl::AlgoPack : NonCopyableObj {
     AlgoAVX2DirectConvStride2 avx2_stride2_direct;
     AlgoChanWiseAvx2Stride1Qint8 avx2_stride1_chanwsie_qint8;
     AlgoChanWiseAvx2Stride2Qint8 avx2_stride2_chanwsie_qint8;
+    AlgoF32ChanWiseAvx2 avx2_chanwise_f32;
+    AlgoF32ChanWiseNCHW88Avx2 avx2_chanwise_nchw88_f32;
+    AlgoF32DirectNCHW88Avx2 avx2_direct_nchw88_f32;
+    AlgoF32DirectNCHWNCHW88Avx2 avx2_direct_nchw_nchw88_f32;
+#if MEGDNN_X86_WITH_VNNI
+    AlgoDirectVnniInt8 vnni_direct_int8;
+    AlgoChanWiseVnniQint8 vnni_chanwise_qint8;
+#endif
 #if MEGDNN_X86_WITH_MKL_DNN
     AlgoMkldnnMatmulQint8 mkldnn_matmul_qint8;
     //! Because the mkldnnconv need handle
@@ -51,6 +59,10 @@ class ConvBiasImpl::AlgoPack : NonCopyableObj {
 
 public:
     AlgoPack() {
+        m_all_no_winograd_algo.emplace_back(&avx2_chanwise_f32);
+        m_all_no_winograd_algo.emplace_back(&avx2_chanwise_nchw88_f32);
+        m_all_no_winograd_algo.emplace_back(&avx2_direct_nchw88_f32);
+        m_all_no_winograd_algo.emplace_back(&avx2_direct_nchw_nchw88_f32);
         //! FIXME: preference to use mkldnn algo on VNNI devices
         //! But now mkldnn algo preference issue with NCHW->NHWC->NCHW
 #if MEGDNN_X86_WITH_MKL_DNN
@@ -61,6 +73,10 @@ public:
 #endif
         m_all_no_winograd_algo.emplace_back(&stride1_direct);
         m_all_no_winograd_algo.emplace_back(&stride2_direct);
+#if MEGDNN_X86_WITH_VNNI
+        m_all_no_winograd_algo.emplace_back(&vnni_chanwise_qint8);
+        m_all_no_winograd_algo.emplace_back(&vnni_direct_int8);
+#endif
         m_all_no_winograd_algo.emplace_back(&avx2_stride1_chanwsie_qint8);
         m_all_no_winograd_algo.emplace_back(&avx2_stride2_chanwsie_qint8);
         m_all_no_winograd_algo.emplace_back(&avx2_stride1_direct_int8);
@@ -150,6 +166,12 @@ bool ConvBiasImpl::is_matmul_quantized_prefer(
                 chanwise_avx2_stride2_qint8_usable_preferred(param) ||
                 direct_avx2_stride1_int8_usable_preferred(param) ||
                 direct_avx2_stride2_int8_usable_preferred(param);
+#if MEGDNN_X86_WITH_VNNI
+        conv_direct_chanwise_mkldnn_usable =
+                conv_direct_chanwise_mkldnn_usable ||
+                chanwise_vnni_qint8_usable_preferred(param) ||
+                direct_vnni_int8_usable_preferred(param);
+#endif
 #if MEGDNN_X86_WITH_MKL_DNN
         conv_direct_chanwise_mkldnn_usable =
                 conv_direct_chanwise_mkldnn_usable ||
@@ -158,8 +180,14 @@ bool ConvBiasImpl::is_matmul_quantized_prefer(
 #endif
     }
 
+    bool vnni_direct_preferred = false;
+#if MEGDNN_X86_WITH_VNNI
+    vnni_direct_preferred = chanwise_vnni_qint8_usable_preferred(param) ||
+                            direct_vnni_int8_usable_preferred(param);
+#endif
+
     return !conv_direct_chanwise_mkldnn_usable ||
-           (is_supported(SIMDType::VNNI) &&
+           (is_supported(SIMDType::VNNI) && !vnni_direct_preferred &&
             !chanwise_avx2_stride1_qint8_usable_preferred(param) &&
             !chanwise_avx2_stride2_qint8_usable_preferred(param));
 }
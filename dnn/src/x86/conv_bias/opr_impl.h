@@ -58,6 +58,14 @@ private:
     class AlgoAVX2DirectConvStride2;
     class AlgoChanWiseAvx2Stride1Qint8;
     class AlgoChanWiseAvx2Stride2Qint8;
+    class AlgoF32ChanWiseAvx2;
+    class AlgoF32ChanWiseNCHW88Avx2;
+    class AlgoF32DirectNCHW88Avx2;
+    class AlgoF32DirectNCHWNCHW88Avx2;
+#if MEGDNN_X86_WITH_VNNI
+    class AlgoDirectVnniInt8;
+    class AlgoChanWiseVnniQint8;
+#endif
 #if MEGDNN_X86_WITH_MKL_DNN
     class AlgoMkldnnConv;
     class AlgoMkldnnQint8;
@@ -175,6 +175,67 @@ struct PostProcess<ctype, dtype, megdnn::PostprocessMode::NO_PROCESS> {
         MEGDNN_MARK_USED_VAR(OW);
     }
 };
+
+#if !MEGDNN_DISABLE_FLOAT16
+/*!
+ * x86 has no elemwise op of bfloat16, so the bias and the nonlinearity are
+ * computed in float element by element; conv_dst_ptr may be dst_ptr itself
+ */
+template <>
+struct PostProcess<dt_bfloat16, dt_bfloat16, megdnn::PostprocessMode::FLOAT> {
+    static void run(
+            void* conv_dst_ptr, void* bias_ptr, void* dst_ptr,
+            megdnn::ConvBiasForward::BiasMode bias_mode,
+            megdnn::param::ConvBias::NonlineMode nonlineMode, DType bias_type,
+            DType dst_type, size_t N, size_t OC, size_t OH, size_t OW,
+            size_t pack_oc_size = 1) {
+        MEGDNN_MARK_USED_VAR(pack_oc_size);
+        MEGDNN_MARK_USED_VAR(bias_type);
+        MEGDNN_MARK_USED_VAR(dst_type);
+        megdnn_assert(pack_oc_size == 1, "PostProcess only support nchw in x86");
+        using NonlineMode = megdnn::param::ConvBias::NonlineMode;
+        if (bias_mode == megdnn::ConvBiasForward::BiasMode::NO_BIAS &&
+            nonlineMode == NonlineMode::IDENTITY && conv_dst_ptr == dst_ptr) {
+            return;
+        }
+        const dt_bfloat16* src = static_cast<const dt_bfloat16*>(conv_dst_ptr);
+        const dt_bfloat16* bias = static_cast<const dt_bfloat16*>(bias_ptr);
+        dt_bfloat16* dst = static_cast<dt_bfloat16*>(dst_ptr);
+        size_t OHW = OH * OW;
+        for (size_t n = 0; n < N; ++n) {
+            for (size_t oc = 0; oc < OC; ++oc) {
+                size_t offset = (n * OC + oc) * OHW;
+                for (size_t i = offset; i < offset + OHW; ++i) {
+                    float v = src[i];
+                    if (bias_mode ==
+                        megdnn::ConvBiasForward::BiasMode::BROADCAST_CHANNEL_BIAS) {
+                        v += static_cast<float>(bias[oc]);
+                    } else if (bias_mode == megdnn::ConvBiasForward::BiasMode::BIAS) {
+                        v += static_cast<float>(bias[i]);
+                    }
+                    switch (nonlineMode) {
+                        case NonlineMode::IDENTITY:
+                            break;
+                        case NonlineMode::RELU:
+                            v = std::max(v, 0.f);
+                            break;
+                        case NonlineMode::SIGMOID:
+                            v = 1.f / (1.f + std::exp(-v));
+                            break;
+                        case NonlineMode::H_SWISH:
+                            v = v * std::min(std::max(v + 3.f, 0.f), 6.f) / 6.f;
+                            break;
+                        default:
+                            megdnn_throw("unsupported nolinemode");
+                    }
+                    dst[i] = static_cast<dt_bfloat16>(v);
+                }
+            }
+        }
+    }
+};
+#endif
+
 #undef FOR_NONLINEAR_NOBIAS
 #undef FOR_NONLINEAR
 #undef FOR_BIAS
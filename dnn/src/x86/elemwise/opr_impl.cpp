@@ -54,12 +54,29 @@ void check_mkl_error(const char* func) {
     }
 }
 #endif
+
+/*!
+ * \brief split rows in [begin, end) of a (batch, channel) tensor at batch
+ *      boundaries, and call func(row, channel, nr_channel) for each part
+ */
+template <typename Func>
+void for_each_channel_range(size_t begin, size_t end, size_t nr_channel, Func&& func) {
+    while (begin < end) {
+        size_t channel = begin % nr_channel,
+               nr = std::min(end - begin, nr_channel - channel);
+        func(begin, channel, nr);
+        begin += nr;
+    }
+}
 }  // namespace
 
 #if MEGDNN_X86_WITH_MKL
-#define DISPATCH_MKL(_mode, _func)                                                   \
-    case Mode::_mode:                                                                \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(_func(n, sptr, dptr); check_mkl_error(#_func)); \
+#define DISPATCH_MKL(_mode, _func)                          \
+    case Mode::_mode:                                       \
+        dispatch_rows(n, 1, [=](size_t begin, size_t end) { \
+            _func(end - begin, sptr + begin, dptr + begin); \
+            check_mkl_error(#_func);                        \
+        });                                                 \
         return true
 #endif
 
@@ -84,15 +101,16 @@ void check_mkl_error(const char* func) {
     } while (0)
 
 bool ElemwiseImpl::exec_unary() {
-#define DISPATCH_UNARY(_mode, _type, _simd_type, _op)                           \
-    case Mode::_mode: {                                                         \
-        thin_function<void(const _type*, _type*, DType, DType, size_t)> run =   \
-                OpCallerUnary<_op<_simd_type, _type, _type>, _simd_type>::run;  \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                           \
-                run(static_cast<const _type*>(src0.raw_ptr),                    \
-                    static_cast<_type*>(dst_tensor.raw_ptr), src0.layout.dtype, \
-                    dst_tensor.layout.dtype, nr_elems));                        \
-        return true;                                                            \
+#define DISPATCH_UNARY(_mode, _type, _simd_type, _op)                               \
+    case Mode::_mode: {                                                             \
+        thin_function<void(const _type*, _type*, DType, DType, size_t)> run =       \
+                OpCallerUnary<_op<_simd_type, _type, _type>, _simd_type>::run;      \
+        dispatch_rows(nr_elems, 1, [=](size_t begin, size_t end) {                  \
+            run(static_cast<const _type*>(src0.raw_ptr) + begin,                    \
+                static_cast<_type*>(dst_tensor.raw_ptr) + begin, src0.layout.dtype, \
+                dst_tensor.layout.dtype, end - begin);                              \
+        });                                                                         \
+        return true;                                                                \
     }
 
     if (m_src->size() != 1)
@@ -207,18 +225,19 @@ bool ElemwiseImpl::exec_binary() {
     // Case 1: size of src0 and src1 are exactly match
     if (is_vector(src0.layout) && is_vector(src1.layout)) {
         megdnn_assert(n == m_dst->layout.total_nr_elems());
-#define DISPATCH_BINARY(_mode, _type, _simd_type, _op)                               \
-    case Mode::_mode: {                                                              \
-        thin_function<void(                                                          \
-                const _type*, const _type*, _type*, DType, DType, DType, size_t)>    \
-                run = OpCallerBinary<                                                \
-                        _op<_simd_type, _type, _type>, _simd_type, VEC_VEC>::run;    \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(run(                                            \
-                static_cast<const _type*>(src0.raw_ptr),                             \
-                static_cast<const _type*>(src1.raw_ptr),                             \
-                static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,                 \
-                src1.layout.dtype, dst.layout.dtype, src0.layout.total_nr_elems())); \
-        return true;                                                                 \
+#define DISPATCH_BINARY(_mode, _type, _simd_type, _op)                            \
+    case Mode::_mode: {                                                           \
+        thin_function<void(                                                       \
+                const _type*, const _type*, _type*, DType, DType, DType, size_t)> \
+                run = OpCallerBinary<                                             \
+                        _op<_simd_type, _type, _type>, _simd_type, VEC_VEC>::run; \
+        dispatch_rows(n, 1, [=](size_t begin, size_t end) {                       \
+            run(static_cast<const _type*>(src0.raw_ptr) + begin,                  \
+                static_cast<const _type*>(src1.raw_ptr) + begin,                  \
+                static_cast<_type*>(dst.raw_ptr) + begin, src0.layout.dtype,      \
+                src1.layout.dtype, dst.layout.dtype, end - begin);                \
+        });                                                                       \
+        return true;                                                              \
     }
         auto&& dst = *m_dst;
         DISPATCH_SIMD_TYPE;
@@ -233,11 +252,13 @@ bool ElemwiseImpl::exec_binary() {
                 const _type*, const _type, _type*, DType, DType, DType, size_t)>     \
                 run = OpCallerBinary<                                                \
                         _op<_simd_type, _type, _type>, _simd_type, VEC_SCALAR>::run; \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(run(                                            \
-                static_cast<const _type*>(src0.raw_ptr),                             \
-                static_cast<const _type*>(src1.raw_ptr)[0],                          \
-                static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,                 \
-                src1.layout.dtype, dst.layout.dtype, src0.layout.total_nr_elems())); \
+        dispatch_rows(                                                               \
+                src0.layout.total_nr_elems(), 1, [=](size_t begin, size_t end) {     \
+                    run(static_cast<const _type*>(src0.raw_ptr) + begin,             \
+                        static_cast<const _type*>(src1.raw_ptr)[0],                  \
+                        static_cast<_type*>(dst.raw_ptr) + begin, src0.layout.dtype, \
+                        src1.layout.dtype, dst.layout.dtype, end - begin);           \
+                });                                                                  \
         return true;                                                                 \
     }
 
@@ -263,11 +284,13 @@ bool ElemwiseImpl::exec_binary() {
                 const _type, const _type*, _type*, DType, DType, DType, size_t)>     \
                 run = OpCallerBinary<                                                \
                         _op<_simd_type, _type, _type>, _simd_type, SCALAR_VEC>::run; \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(run(                                            \
-                static_cast<const _type*>(src0.raw_ptr)[0],                          \
-                static_cast<const _type*>(src1.raw_ptr),                             \
-                static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,                 \
-                src1.layout.dtype, dst.layout.dtype, src1.layout.total_nr_elems())); \
+        dispatch_rows(                                                               \
+                src1.layout.total_nr_elems(), 1, [=](size_t begin, size_t end) {     \
+                    run(static_cast<const _type*>(src0.raw_ptr)[0],                  \
+                        static_cast<const _type*>(src1.raw_ptr) + begin,             \
+                        static_cast<_type*>(dst.raw_ptr) + begin, src0.layout.dtype, \
+                        src1.layout.dtype, dst.layout.dtype, end - begin);           \
+                });                                                                  \
         return true;                                                                 \
     }
 
@@ -288,11 +311,17 @@ bool ElemwiseImpl::exec_binary() {
                 size_t, size_t)>                                                       \
                 run = OpCallerBinary<                                                  \
                         _op<_simd_type, _type, _type>, _simd_type, VEC_BCAST101>::run; \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                  \
-                run(static_cast<const _type*>(src0.raw_ptr),                           \
-                    static_cast<const _type*>(src1.raw_ptr),                           \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,               \
-                    src1.layout.dtype, dst.layout.dtype, binfo.x, binfo.y, binfo.z));  \
+        auto kern = [=](size_t begin, size_t end) {                                    \
+            for_each_channel_range(                                                    \
+                    begin, end, binfo.y, [&](size_t row, size_t c, size_t nr_c) {      \
+                        run(static_cast<const _type*>(src0.raw_ptr) + row * binfo.z,   \
+                            static_cast<const _type*>(src1.raw_ptr) + c,               \
+                            static_cast<_type*>(dst.raw_ptr) + row * binfo.z,          \
+                            src0.layout.dtype, src1.layout.dtype, dst.layout.dtype, 1, \
+                            nr_c, binfo.z);                                            \
+                    });                                                                \
+        };                                                                             \
+        dispatch_rows(binfo.x * binfo.y, binfo.z, kern);                               \
         return true;                                                                   \
     }
 
@@ -322,11 +351,17 @@ bool ElemwiseImpl::exec_binary() {
                 size_t, size_t)>                                                       \
                 run = OpCallerBinary<                                                  \
                         _op<_simd_type, _type, _type>, _simd_type, BCAST101_VEC>::run; \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                  \
-                run(static_cast<const _type*>(src0.raw_ptr),                           \
-                    static_cast<const _type*>(src1.raw_ptr),                           \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,               \
-                    src1.layout.dtype, dst.layout.dtype, binfo.x, binfo.y, binfo.z));  \
+        auto kern = [=](size_t begin, size_t end) {                                    \
+            for_each_channel_range(                                                    \
+                    begin, end, binfo.y, [&](size_t row, size_t c, size_t nr_c) {      \
+                        run(static_cast<const _type*>(src0.raw_ptr) + c,               \
+                            static_cast<const _type*>(src1.raw_ptr) + row * binfo.z,   \
+                            static_cast<_type*>(dst.raw_ptr) + row * binfo.z,          \
+                            src0.layout.dtype, src1.layout.dtype, dst.layout.dtype, 1, \
+                            nr_c, binfo.z);                                            \
+                    });                                                                \
+        };                                                                             \
+        dispatch_rows(binfo.x * binfo.y, binfo.z, kern);                               \
         return true;                                                                   \
     }
         // BCAST_101 + VEC : only for nonswap op
@@ -346,12 +381,18 @@ bool ElemwiseImpl::exec_binary() {
                 run = OpCallerBinary<                                                  \
                         _op<_simd_type, _type, _type>, _simd_type,                     \
                         BCAST101x_VEC>::run;                                           \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                  \
-                run(static_cast<const _type*>(src0.raw_ptr),                           \
-                    static_cast<const _type*>(src1.raw_ptr),                           \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,               \
-                    src1.layout.dtype, dst.layout.dtype, batch_size, binfo.x, binfo.y, \
-                    binfo.z));                                                         \
+        size_t row_size = binfo.y * binfo.z;                                           \
+        auto kern = [=](size_t begin, size_t end) {                                    \
+            for_each_channel_range(                                                    \
+                    begin, end, binfo.x, [&](size_t row, size_t c, size_t nr_c) {      \
+                        run(static_cast<const _type*>(src0.raw_ptr) + c * binfo.z,     \
+                            static_cast<const _type*>(src1.raw_ptr) + row * row_size,  \
+                            static_cast<_type*>(dst.raw_ptr) + row * row_size,         \
+                            src0.layout.dtype, src1.layout.dtype, dst.layout.dtype, 1, \
+                            nr_c, binfo.y, binfo.z);                                   \
+                    });                                                                \
+        };                                                                             \
+        dispatch_rows(batch_size * binfo.x, row_size, kern);                           \
         return true;                                                                   \
     }
         {
@@ -427,13 +468,15 @@ bool ElemwiseImpl::exec_ternary_fma3() {
                 DType, size_t)>                                                        \
                 run = OpCallerTernary<                                                 \
                         _op<_simd_type, _type, _type>, _simd_type, VEC_VEC_VEC>::run;  \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                  \
-                run(static_cast<const _type*>(src0.raw_ptr),                           \
-                    static_cast<const _type*>(src1.raw_ptr),                           \
-                    static_cast<const _type*>(src2.raw_ptr),                           \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,               \
-                    src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,            \
-                    src0.layout.total_nr_elems()));                                    \
+        dispatch_rows(                                                                 \
+                src0.layout.total_nr_elems(), 1, [=](size_t begin, size_t end) {       \
+                    run(static_cast<const _type*>(src0.raw_ptr) + begin,               \
+                        static_cast<const _type*>(src1.raw_ptr) + begin,               \
+                        static_cast<const _type*>(src2.raw_ptr) + begin,               \
+                        static_cast<_type*>(dst.raw_ptr) + begin, src0.layout.dtype,   \
+                        src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,        \
+                        end - begin);                                                  \
+                });                                                                    \
         return true;                                                                   \
     }
 
@@ -456,13 +499,15 @@ bool ElemwiseImpl::exec_ternary_fma3() {
                 run = OpCallerTernary<                                                \
                         _op<_simd_type, _type, _type>, _simd_type,                    \
                         VEC_VEC_SCALAR>::run;                                         \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                 \
-                run(static_cast<const _type*>(src0.raw_ptr),                          \
-                    static_cast<const _type*>(src1.raw_ptr),                          \
-                    static_cast<const _type*>(src2.raw_ptr)[0],                       \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,              \
-                    src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,           \
-                    src0.layout.total_nr_elems()));                                   \
+        dispatch_rows(                                                                \
+                src0.layout.total_nr_elems(), 1, [=](size_t begin, size_t end) {      \
+                    run(static_cast<const _type*>(src0.raw_ptr) + begin,              \
+                        static_cast<const _type*>(src1.raw_ptr) + begin,              \
+                        static_cast<const _type*>(src2.raw_ptr)[0],                   \
+                        static_cast<_type*>(dst.raw_ptr) + begin, src0.layout.dtype,  \
+                        src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,       \
+                        end - begin);                                                 \
+                });                                                                   \
         return true;                                                                  \
     }
 
@@ -487,13 +532,18 @@ bool ElemwiseImpl::exec_ternary_fma3() {
                 run = OpCallerTernary<                                                 \
                         _op<_simd_type, _type, _type>, _simd_type,                     \
                         BCAST101_VEC_BCAST101>::run;                                   \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                  \
-                run(static_cast<const _type*>(src0.raw_ptr),                           \
-                    static_cast<const _type*>(src1.raw_ptr),                           \
-                    static_cast<const _type*>(src2.raw_ptr),                           \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,               \
-                    src1.layout.dtype, src2.layout.dtype, dst.layout.dtype, binfo.x,   \
-                    binfo.y, binfo.z));                                                \
+        auto kern = [=](size_t begin, size_t end) {                                    \
+            for_each_channel_range(                                                    \
+                    begin, end, binfo.y, [&](size_t row, size_t c, size_t nr_c) {      \
+                        run(static_cast<const _type*>(src0.raw_ptr) + c,               \
+                            static_cast<const _type*>(src1.raw_ptr) + row * binfo.z,   \
+                            static_cast<const _type*>(src2.raw_ptr) + c,               \
+                            static_cast<_type*>(dst.raw_ptr) + row * binfo.z,          \
+                            src0.layout.dtype, src1.layout.dtype, src2.layout.dtype,   \
+                            dst.layout.dtype, 1, nr_c, binfo.z);                       \
+                    });                                                                \
+        };                                                                             \
+        dispatch_rows(binfo.x * binfo.y, binfo.z, kern);                               \
         return true;                                                                   \
     }
 
@@ -518,13 +568,18 @@ bool ElemwiseImpl::exec_ternary_fma3() {
                 run = OpCallerTernary<                                                 \
                         _op<_simd_type, _type, _type>, _simd_type,                     \
                         VEC_BCAST101_VEC>::run;                                        \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                  \
-                run(static_cast<const _type*>(src0.raw_ptr),                           \
-                    static_cast<const _type*>(src1.raw_ptr),                           \
-                    static_cast<const _type*>(src2.raw_ptr),                           \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,               \
-                    src1.layout.dtype, src2.layout.dtype, dst.layout.dtype, binfo.x,   \
-                    binfo.y, binfo.z));                                                \
+        auto kern = [=](size_t begin, size_t end) {                                    \
+            for_each_channel_range(                                                    \
+                    begin, end, binfo.y, [&](size_t row, size_t c, size_t nr_c) {      \
+                        run(static_cast<const _type*>(src0.raw_ptr) + row * binfo.z,   \
+                            static_cast<const _type*>(src1.raw_ptr) + c,               \
+                            static_cast<const _type*>(src2.raw_ptr) + row * binfo.z,   \
+                            static_cast<_type*>(dst.raw_ptr) + row * binfo.z,          \
+                            src0.layout.dtype, src1.layout.dtype, src2.layout.dtype,   \
+                            dst.layout.dtype, 1, nr_c, binfo.z);                       \
+                    });                                                                \
+        };                                                                             \
+        dispatch_rows(binfo.x * binfo.y, binfo.z, kern);                               \
         return true;                                                                   \
     }
 
@@ -547,13 +602,15 @@ bool ElemwiseImpl::exec_ternary_fma3() {
                 run = OpCallerTernary<                                                \
                         _op<_simd_type, _type, _type>, _simd_type,                    \
                         VEC_SCALAR_VEC>::run;                                         \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                 \
-                run(static_cast<const _type*>(src0.raw_ptr),                          \
-                    static_cast<const _type*>(src1.raw_ptr)[0],                       \
-                    static_cast<const _type*>(src2.raw_ptr),                          \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,              \
-                    src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,           \
-                    src0.layout.total_nr_elems()));                                   \
+        dispatch_rows(                                                                \
+                src0.layout.total_nr_elems(), 1, [=](size_t begin, size_t end) {      \
+                    run(static_cast<const _type*>(src0.raw_ptr) + begin,              \
+                        static_cast<const _type*>(src1.raw_ptr)[0],                   \
+                        static_cast<const _type*>(src2.raw_ptr) + begin,              \
+                        static_cast<_type*>(dst.raw_ptr) + begin, src0.layout.dtype,  \
+                        src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,       \
+                        end - begin);                                                 \
+                });                                                                   \
         return true;                                                                  \
     }
 
@@ -576,13 +633,15 @@ bool ElemwiseImpl::exec_ternary_fma3() {
                 run = OpCallerTernary<                                               \
                         _op<_simd_type, _type, _type>, _simd_type,                   \
                         VEC_SCALAR_SCALAR>::run;                                     \
-        MEGDNN_DISPATCH_CPU_KERN_OPR(                                                \
-                run(static_cast<const _type*>(src0.raw_ptr),                         \
-                    static_cast<const _type*>(src1.raw_ptr)[0],                      \
-                    static_cast<const _type*>(src2.raw_ptr)[0],                      \
-                    static_cast<_type*>(dst.raw_ptr), src0.layout.dtype,             \
-                    src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,          \
-                    src0.layout.total_nr_elems()));                                  \
+        dispatch_rows(                                                               \
+                src0.layout.total_nr_elems(), 1, [=](size_t begin, size_t end) {     \
+                    run(static_cast<const _type*>(src0.raw_ptr) + begin,             \
+                        static_cast<const _type*>(src1.raw_ptr)[0],                  \
+                        static_cast<const _type*>(src2.raw_ptr)[0],                  \
+                        static_cast<_type*>(dst.raw_ptr) + begin, src0.layout.dtype, \
+                        src1.layout.dtype, src2.layout.dtype, dst.layout.dtype,      \
+                        end - begin);                                                \
+                });                                                                  \
         return true;                                                                 \
     }
             auto&& dst = *m_dst;
@@ -0,0 +1,45 @@
+/**
+ * \file dnn/src/x86/exp_approx.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+//! this file is included by simd_vec_{avx2,avx512}.h after
+//! MEGDNN_SIMD_VEC_TARGET is set, Vec must provide the following:
+//! type, set1, add, mul, fmadd, min, max, round and pow2n
+
+namespace {
+
+/*!
+ * exp(x) = 2^n * exp(r), where n = round(x / ln2) and r = x - n * ln2 is in
+ * [-ln2 / 2, ln2 / 2]. exp(r) is evaluated by the polynomial of cephes expf,
+ * whose relative error is within 2 ulp; ln2 is split into two constants so
+ * that r is exact. x is clamped to keep 2^n a normal float.
+ */
+template <class Vec>
+MEGDNN_SIMD_VEC_TARGET typename Vec::type exp_approx(typename Vec::type x) {
+    using vtype = typename Vec::type;
+    x = Vec::min(Vec::max(x, Vec::set1(-87.3365f)), Vec::set1(88.0f));
+    vtype n = Vec::round(Vec::mul(x, Vec::set1(1.44269504088896341f)));
+    vtype r = Vec::fmadd(n, Vec::set1(-0.693359375f), x);
+    r = Vec::fmadd(n, Vec::set1(2.12194440e-4f), r);
+    vtype p = Vec::set1(1.9875691500e-4f);
+    p = Vec::fmadd(p, r, Vec::set1(1.3981999507e-3f));
+    p = Vec::fmadd(p, r, Vec::set1(8.3334519073e-3f));
+    p = Vec::fmadd(p, r, Vec::set1(4.1665795894e-2f));
+    p = Vec::fmadd(p, r, Vec::set1(1.6666665459e-1f));
+    p = Vec::fmadd(p, r, Vec::set1(5.0000001201e-1f));
+    p = Vec::fmadd(p, Vec::mul(r, r), Vec::add(r, Vec::set1(1.f)));
+    return Vec::mul(p, Vec::pow2n(n));
+}
+
+}  // anonymous namespace
+
+// vim: syntax=cpp.doxygen
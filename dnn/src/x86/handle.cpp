@@ -15,6 +15,8 @@
 #include "src/x86/handle.h"
 
 #include "src/x86/add_update/opr_impl.h"
+#include "src/x86/argsort/opr_impl.h"
+#include "src/x86/attention/opr_impl.h"
 #include "src/x86/conv_bias/opr_impl.h"
 #include "src/x86/cvt_color/opr_impl.h"
 #include "src/x86/elemwise/opr_impl.h"
@@ -23,10 +25,15 @@
 #include "src/x86/local/opr_impl.h"
 #include "src/x86/lrn/opr_impl.h"
 #include "src/x86/matrix_mul/opr_impl.h"
+#include "src/x86/norm/opr_impl.h"
 #include "src/x86/pooling/opr_impl.h"
+#include "src/x86/reduce/opr_impl.h"
 #include "src/x86/resize/opr_impl.h"
+#include "src/x86/rnn/opr_impl.h"
 #include "src/x86/separable_conv/opr_impl.h"
 #include "src/x86/separable_filter/opr_impl.h"
+#include "src/x86/softmax/opr_impl.h"
+#include "src/x86/topk/opr_impl.h"
 #include "src/x86/type_cvt/opr_impl.h"
 #include "src/x86/utils.h"
 #include "src/x86/warp_affine/opr_impl.h"
@@ -87,6 +94,15 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(WarpPerspective)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(AddUpdate)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(TypeCvt)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(Reduce)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(SoftmaxForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LayerNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GroupNormForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(AttentionForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(LSTMForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GRUForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(TopK)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ArgsortForward)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
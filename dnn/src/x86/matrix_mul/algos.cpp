@@ -13,6 +13,7 @@
 #include "src/x86/matrix_mul/algos.h"
 #include "src/common/utils.h"
 #include "src/fallback/matrix_mul/gemm_impl.h"
+#include "src/x86/matrix_mul/bf16/strategy.h"
 #include "src/x86/matrix_mul/f32/strategy.h"
 #include "src/x86/matrix_mul/int8/strategy.h"
 
@@ -625,4 +626,186 @@ size_t MatrixMulImpl::AlgoF32MK8_8x8::get_workspace(
     MIDOUT_END();
 }
 
+/*************************AlgoF32AVX2M6N16********************/
+namespace {
+template <typename Strategy>
+void f32_packed_gemm_kern(const MatrixMulImpl::KernParam& kern_param) {
+    constexpr int cacheline = 64;
+    auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+    Strategy strategy(M, N, K, kern_param.A_type, kern_param.B_type, kern_param.C_type);
+    megdnn::matmul::GemmInterleaved<Strategy>(
+            M, N, K, kern_param.trA, kern_param.trB, strategy, cacheline)
+            .execute(
+                    kern_param.A<float>(), kern_param.LDA, kern_param.B<float>(),
+                    kern_param.LDB, kern_param.C<float>(), kern_param.LDC,
+                    kern_param.workspace_ptr);
+}
+
+template <typename Strategy>
+size_t f32_packed_gemm_workspace(const MatrixMulImpl::KernSizeParam& kern_param) {
+    constexpr int cacheline = 64;
+    auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+    Strategy strategy(M, N, K, kern_param.A_type, kern_param.B_type, kern_param.C_type);
+    return megdnn::matmul::GemmInterleaved<Strategy>(
+                   M, N, K, kern_param.trA, kern_param.trB, strategy, cacheline)
+            .get_workspace_size();
+}
+
+bool f32_packed_gemm_usable(const MatrixMulImpl::KernSizeParam& kern_size_param) {
+    return kern_size_param.compute_mode == param::MatrixMul::ComputeMode::DEFAULT &&
+           kern_size_param.format == param::MatrixMul::Format::DEFAULT &&
+           kern_size_param.B_type == kern_size_param.A_type &&
+           kern_size_param.C_type == kern_size_param.A_type &&
+           kern_size_param.A_type == dtype::Float32();
+}
+
+void f32_avx2_6x16_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("AlgoF32AVX2M6N16"_hash)) {
+        f32_packed_gemm_kern<x86::matmul::sgemm_pack_6x16_avx2>(kern_param);
+    }
+    MIDOUT_END();
+}
+
+void f32_avx512_14x32_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("AlgoF32AVX512M14N32"_hash)) {
+        f32_packed_gemm_kern<x86::matmul::sgemm_pack_14x32_avx512>(kern_param);
+    }
+    MIDOUT_END();
+}
+}  // namespace
+
+bool MatrixMulImpl::AlgoF32AVX2M6N16::usable(
+        const KernSizeParam& kern_size_param) const {
+    return f32_packed_gemm_usable(kern_size_param) && is_supported(SIMDType::AVX2) &&
+           is_supported(SIMDType::FMA);
+}
+
+size_t MatrixMulImpl::AlgoF32AVX2M6N16::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    return f32_packed_gemm_workspace<x86::matmul::sgemm_pack_6x16_avx2>(
+            kern_size_param);
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32AVX2M6N16::get_kern(
+        const KernSizeParam&) const {
+    return f32_avx2_6x16_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
+        AlgoF32AVX2M6N16, megdnn_x86_matmul_kern, "AlgoF32AVX2M6N16"_hash,
+        x86::matmul::sgemm_pack_6x16_avx2, float, float, AlgoDataType::FLOAT32,
+        DEFAULT);
+
+/*************************AlgoF32AVX512M14N32********************/
+bool MatrixMulImpl::AlgoF32AVX512M14N32::usable(
+        const KernSizeParam& kern_size_param) const {
+    return f32_packed_gemm_usable(kern_size_param) && is_supported(SIMDType::AVX512);
+}
+
+size_t MatrixMulImpl::AlgoF32AVX512M14N32::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    return f32_packed_gemm_workspace<x86::matmul::sgemm_pack_14x32_avx512>(
+            kern_size_param);
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32AVX512M14N32::get_kern(
+        const KernSizeParam&) const {
+    return f32_avx512_14x32_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
+        AlgoF32AVX512M14N32, megdnn_x86_matmul_kern, "AlgoF32AVX512M14N32"_hash,
+        x86::matmul::sgemm_pack_14x32_avx512, float, float, AlgoDataType::FLOAT32,
+        DEFAULT);
+
+#if !MEGDNN_DISABLE_FLOAT16
+/*************************AlgoBF16AVX2M6N16********************/
+namespace {
+template <typename Strategy>
+void bf16_packed_gemm_kern(const MatrixMulImpl::KernParam& kern_param) {
+    constexpr int cacheline = 64;
+    auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+    Strategy strategy(M, N, K, kern_param.A_type, kern_param.B_type, kern_param.C_type);
+    megdnn::matmul::GemmInterleaved<Strategy>(
+            M, N, K, kern_param.trA, kern_param.trB, strategy, cacheline)
+            .execute(
+                    kern_param.A<dt_bfloat16>(), kern_param.LDA,
+                    kern_param.B<dt_bfloat16>(), kern_param.LDB,
+                    kern_param.C<dt_bfloat16>(), kern_param.LDC,
+                    kern_param.workspace_ptr);
+}
+
+//! products are always accumulated in float, so both compute modes are served
+bool bf16_packed_gemm_usable(const MatrixMulImpl::KernSizeParam& kern_size_param) {
+    return kern_size_param.format == param::MatrixMul::Format::DEFAULT &&
+           kern_size_param.B_type == kern_size_param.A_type &&
+           kern_size_param.C_type == kern_size_param.A_type &&
+           kern_size_param.A_type == dtype::BFloat16();
+}
+
+void bf16_avx2_6x16_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("AlgoBF16AVX2M6N16"_hash)) {
+        bf16_packed_gemm_kern<x86::matmul::bf16gemm_pack_6x16_avx2>(kern_param);
+    }
+    MIDOUT_END();
+}
+}  // namespace
+
+bool MatrixMulImpl::AlgoBF16AVX2M6N16::usable(
+        const KernSizeParam& kern_size_param) const {
+    return bf16_packed_gemm_usable(kern_size_param) && is_supported(SIMDType::AVX2) &&
+           is_supported(SIMDType::FMA);
+}
+
+size_t MatrixMulImpl::AlgoBF16AVX2M6N16::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    return f32_packed_gemm_workspace<x86::matmul::bf16gemm_pack_6x16_avx2>(
+            kern_size_param);
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoBF16AVX2M6N16::get_kern(
+        const KernSizeParam&) const {
+    return bf16_avx2_6x16_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL_DETAIL(
+        AlgoBF16AVX2M6N16, megdnn_x86_matmul_kern, "AlgoBF16AVX2M6N16"_hash,
+        x86::matmul::bf16gemm_pack_6x16_avx2, dt_bfloat16, dt_bfloat16, float,
+        AlgoDataType::BFLOAT16, DEFAULT);
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+/*************************AlgoBF16AVX512M8N32********************/
+namespace {
+void bf16_avx512_8x32_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("AlgoBF16AVX512M8N32"_hash)) {
+        bf16_packed_gemm_kern<x86::matmul::bf16gemm_pack_8x32_avx512_bf16>(
+                kern_param);
+    }
+    MIDOUT_END();
+}
+}  // namespace
+
+bool MatrixMulImpl::AlgoBF16AVX512M8N32::usable(
+        const KernSizeParam& kern_size_param) const {
+    return bf16_packed_gemm_usable(kern_size_param) && is_supported(SIMDType::BF16);
+}
+
+size_t MatrixMulImpl::AlgoBF16AVX512M8N32::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    return f32_packed_gemm_workspace<x86::matmul::bf16gemm_pack_8x32_avx512_bf16>(
+            kern_size_param);
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoBF16AVX512M8N32::get_kern(
+        const KernSizeParam&) const {
+    return bf16_avx512_8x32_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
+        AlgoBF16AVX512M8N32, megdnn_x86_matmul_kern, "AlgoBF16AVX512M8N32"_hash,
+        x86::matmul::bf16gemm_pack_8x32_avx512_bf16, dt_bfloat16, dt_bfloat16,
+        AlgoDataType::BFLOAT16, DEFAULT);
+#endif
+#endif
+
 // vim: syntax=cpp.doxygen
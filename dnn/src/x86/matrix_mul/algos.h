@@ -57,6 +57,54 @@ public:
 };
 #endif
 
+class MatrixMulImpl::AlgoF32AVX2M6N16 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_F32_AVX2_6X16"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_F32_AVX2_6X16)
+};
+
+class MatrixMulImpl::AlgoF32AVX512M14N32 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_F32_AVX512_14X32"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_F32_AVX512_14X32)
+};
+
+#if !MEGDNN_DISABLE_FLOAT16
+class MatrixMulImpl::AlgoBF16AVX2M6N16 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_BF16_AVX2_6X16"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_BF16_AVX2_6X16)
+};
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+class MatrixMulImpl::AlgoBF16AVX512M8N32 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_BF16_AVX512_BF16_8X32"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_BF16_AVX512_BF16_8X32)
+};
+#endif
+#endif
+
 class MatrixMulImpl::AlgoInt8x8x32AVX2M2N4K16 : public AlgoBase {
 public:
     AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
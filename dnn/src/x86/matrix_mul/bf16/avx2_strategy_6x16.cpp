@@ -0,0 +1,98 @@
+/**
+ * \file dnn/src/x86/matrix_mul/bf16/avx2_strategy_6x16.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/matrix_mul/bf16/strategy.h"
+
+#if !MEGDNN_DISABLE_FLOAT16
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/bf16/kernel_avx2_6x16.h"
+
+using namespace megdnn;
+using namespace x86;
+using namespace x86::matmul;
+
+namespace {
+
+void bf16gemm_kern_6x16(
+        const float* packA, const uint16_t* packB, size_t M, size_t N, size_t K,
+        uint16_t* C, size_t LDC, bool is_first_k) {
+    constexpr size_t m_tile = 6;
+    constexpr size_t n_tile = 16;
+    //! the B panel of n_tile cols is reused by all the A panels
+    for (size_t n = 0; n < N; n += n_tile) {
+        int n_remain = static_cast<int>(std::min(N - n, n_tile));
+        const uint16_t* b_ptr = packB + n * K;
+        for (size_t m = 0; m < M; m += m_tile) {
+            const float* a_ptr = packA + m * K;
+            uint16_t* c_ptr = C + m * LDC + n;
+            switch (std::min(M - m, m_tile)) {
+#define cb(i)                                                       \
+    case i + 1:                                                     \
+        matmul_bf16_avx2_6x16::kern_6x16<i + 1>(                    \
+                a_ptr, b_ptr, K, c_ptr, LDC, is_first_k, n_remain); \
+        break;
+                UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+                default:
+                    megdnn_assert_internal(0);
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+MEGDNN_REG_GEMM_STRATEGY_IMPL(bf16gemm_pack_6x16_avx2);
+
+void bf16gemm_pack_6x16_avx2::pack_A(
+        float* out, const dt_bfloat16* in, int ldin, int y0, int ymax, int k0,
+        int kmax, bool transpose_A) const {
+    auto inptr = reinterpret_cast<const uint16_t*>(in);
+    if (transpose_A) {
+        matmul_bf16_avx2_6x16::bf16gemm_avx2_6x16_pack_at(
+                out, inptr, ldin, y0, ymax, k0, kmax);
+    } else {
+        matmul_bf16_avx2_6x16::bf16gemm_avx2_6x16_pack_an(
+                out, inptr, ldin, y0, ymax, k0, kmax);
+    }
+}
+
+void bf16gemm_pack_6x16_avx2::pack_B(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int x0, int xmax, int k0,
+        int kmax, bool transpose_B) const {
+    auto outptr = reinterpret_cast<uint16_t*>(out);
+    auto inptr = reinterpret_cast<const uint16_t*>(in);
+    if (transpose_B) {
+        matmul_bf16_avx2_6x16::bf16gemm_avx2_6x16_pack_bt(
+                outptr, inptr, ldin, x0, xmax, k0, kmax);
+    } else {
+        matmul_bf16_avx2_6x16::bf16gemm_avx2_6x16_pack_bn(
+                outptr, inptr, ldin, x0, xmax, k0, kmax);
+    }
+}
+
+void bf16gemm_pack_6x16_avx2::kern(
+        const float* packA, const dt_bfloat16* packB, size_t M, size_t N, size_t K,
+        dt_bfloat16* C, size_t LDC, bool is_first_k, const float*, float*) const {
+    megdnn_assert(
+            A_dtype.enumv() == B_dtype.enumv() && A_dtype.enumv() == C_dtype.enumv() &&
+            A_dtype.enumv() == DTypeEnum::BFloat16);
+    MEGDNN_MARK_USED_VAR(A_dtype);
+    MEGDNN_MARK_USED_VAR(B_dtype);
+    MEGDNN_MARK_USED_VAR(C_dtype);
+    bf16gemm_kern_6x16(
+            packA, reinterpret_cast<const uint16_t*>(packB), M, N, K,
+            reinterpret_cast<uint16_t*>(C), LDC, is_first_k);
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,206 @@
+/**
+ * \file dnn/src/x86/matrix_mul/bf16/kernel_avx2_6x16.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include <immintrin.h>
+#include <cstring>
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace x86 {
+namespace matmul_bf16_avx2_6x16 {
+
+//! a bfloat16 is the high half of the float with the same bits
+static inline float bf16_to_f32(uint16_t v) {
+    uint32_t bits = static_cast<uint32_t>(v) << 16;
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+//! convert the 8 floats of each of lo and hi to bfloat16, rounding to the
+//! nearest even, and return them as 16 consecutive bfloat16
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+static inline __m256i cvt_f32x16_bf16(__m256 lo, __m256 hi) {
+    const __m256i bias = _mm256_set1_epi32(0x7fff);
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i l = _mm256_castps_si256(lo), h = _mm256_castps_si256(hi);
+    l = _mm256_add_epi32(
+            l, _mm256_add_epi32(bias, _mm256_and_si256(_mm256_srli_epi32(l, 16), one)));
+    h = _mm256_add_epi32(
+            h, _mm256_add_epi32(bias, _mm256_and_si256(_mm256_srli_epi32(h, 16), one)));
+    //! packus works in 128-bit lanes, so the two middle quadwords are swapped
+    __m256i ret =
+            _mm256_packus_epi32(_mm256_srli_epi32(l, 16), _mm256_srli_epi32(h, 16));
+    return _mm256_permute4x64_epi64(ret, 0xd8);
+}
+
+//! add the 16 consecutive bfloat16 at ptr to the two float vectors
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+static inline void add_bf16x16(const uint16_t* ptr, __m256& lo, __m256& hi) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __m256i l = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v));
+    __m256i h = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1));
+    lo = _mm256_add_ps(lo, _mm256_castsi256_ps(_mm256_slli_epi32(l, 16)));
+    hi = _mm256_add_ps(hi, _mm256_castsi256_ps(_mm256_slli_epi32(h, 16)));
+}
+
+/*!
+ * \brief compute a (m_remain, n_remain) block of C with packA of layout
+ * (K, 6) in float and packB of layout (K, 16) in bfloat16, where the 16
+ * bfloat16 of a row are the cols (0, 8, 1, 9, ..., 7, 15). Shifting the
+ * dwords of a row left by 16 bits gives the float of cols [0, 8) and masking
+ * the low 16 bits gives cols [8, 16), so B is widened with one instruction per
+ * ymm; the 12 accumulators are rounded to bfloat16 on store.
+ *
+ * \tparam m_remain number of valid rows, which is in [1, 6]
+ * \param n_remain number of valid cols, which is in [1, 16]
+ */
+template <int m_remain>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+static inline void kern_6x16(
+        const float* packA, const uint16_t* packB, int K, uint16_t* output, int LDC,
+        bool is_first_k, int n_remain) {
+    __m256 c[6][2];
+#define cb(i)                          \
+    if (i < m_remain) {                \
+        c[i][0] = _mm256_setzero_ps(); \
+        c[i][1] = _mm256_setzero_ps(); \
+    }
+    UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+    const __m256i high_mask = _mm256_set1_epi32(static_cast<int>(0xffff0000u));
+    for (int k = 0; k < K; ++k) {
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packB));
+        __m256 b0 = _mm256_castsi256_ps(_mm256_slli_epi32(b, 16));
+        __m256 b1 = _mm256_castsi256_ps(_mm256_and_si256(b, high_mask));
+#define cb(i)                                      \
+    if (i < m_remain) {                            \
+        __m256 a = _mm256_broadcast_ss(packA + i); \
+        c[i][0] = _mm256_fmadd_ps(a, b0, c[i][0]); \
+        c[i][1] = _mm256_fmadd_ps(a, b1, c[i][1]); \
+    }
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+        packA += 6;
+        packB += 16;
+    }
+
+    uint16_t tmp[16];
+#define cb(i)                                                                     \
+    if (i < m_remain) {                                                           \
+        uint16_t* cptr = output + i * LDC;                                        \
+        uint16_t* dst = n_remain == 16 ? cptr : tmp;                              \
+        if (!is_first_k) {                                                        \
+            if (n_remain < 16) {                                                  \
+                memcpy(tmp, cptr, n_remain * sizeof(uint16_t));                   \
+            }                                                                     \
+            add_bf16x16(dst, c[i][0], c[i][1]);                                   \
+        }                                                                         \
+        _mm256_storeu_si256(                                                      \
+                reinterpret_cast<__m256i*>(dst), cvt_f32x16_bf16(c[i][0], c[i][1])); \
+        if (n_remain < 16) {                                                      \
+            memcpy(cptr, tmp, n_remain * sizeof(uint16_t));                       \
+        }                                                                         \
+    }
+    UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+}
+
+//! pack rows [y0, ymax) of a (M, K) matrix into panels of 6 rows of floats
+static inline void bf16gemm_avx2_6x16_pack_an(
+        float* out, const uint16_t* in, int ldin, int y0, int ymax, int k0,
+        int kmax) {
+    for (int y = y0; y < ymax; y += 6) {
+        const int nr_row = std::min(6, ymax - y);
+        for (int k = k0; k < kmax; ++k) {
+            int i = 0;
+            for (; i < nr_row; ++i) {
+                *out++ = bf16_to_f32(in[(y + i) * ldin + k]);
+            }
+            for (; i < 6; ++i) {
+                *out++ = 0.f;
+            }
+        }
+    }
+}
+
+//! pack cols [y0, ymax) of a (K, M) matrix into panels of 6 rows of floats
+static inline void bf16gemm_avx2_6x16_pack_at(
+        float* out, const uint16_t* in, int ldin, int y0, int ymax, int k0,
+        int kmax) {
+    for (int y = y0; y < ymax; y += 6) {
+        const int nr_row = std::min(6, ymax - y);
+        for (int k = k0; k < kmax; ++k) {
+            const uint16_t* inptr = in + k * ldin + y;
+            int i = 0;
+            for (; i < nr_row; ++i) {
+                *out++ = bf16_to_f32(inptr[i]);
+            }
+            for (; i < 6; ++i) {
+                *out++ = 0.f;
+            }
+        }
+    }
+}
+
+//! pack cols [x0, xmax) of a (K, N) matrix into panels of 16 cols
+static inline void bf16gemm_avx2_6x16_pack_bn(
+        uint16_t* out, const uint16_t* in, int ldin, int x0, int xmax, int k0,
+        int kmax) {
+    for (int x = x0; x < xmax; x += 16) {
+        const int nr_col = std::min(16, xmax - x);
+        for (int k = k0; k < kmax; ++k) {
+            const uint16_t* inptr = in + k * ldin + x;
+            if (nr_col == 16) {
+                __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inptr));
+                __m128i hi =
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(inptr + 8));
+                _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, hi));
+                _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(out + 8),
+                        _mm_unpackhi_epi16(lo, hi));
+            } else {
+                for (int i = 0; i < 8; ++i) {
+                    out[2 * i] = i < nr_col ? inptr[i] : 0;
+                    out[2 * i + 1] = i + 8 < nr_col ? inptr[i + 8] : 0;
+                }
+            }
+            out += 16;
+        }
+    }
+}
+
+//! pack rows [x0, xmax) of a (N, K) matrix into panels of 16 cols
+static inline void bf16gemm_avx2_6x16_pack_bt(
+        uint16_t* out, const uint16_t* in, int ldin, int x0, int xmax, int k0,
+        int kmax) {
+    for (int x = x0; x < xmax; x += 16) {
+        const int nr_col = std::min(16, xmax - x);
+        for (int k = k0; k < kmax; ++k) {
+            for (int i = 0; i < 8; ++i) {
+                out[2 * i] = i < nr_col ? in[(x + i) * ldin + k] : 0;
+                out[2 * i + 1] = i + 8 < nr_col ? in[(x + i + 8) * ldin + k] : 0;
+            }
+            out += 16;
+        }
+    }
+}
+
+}  // namespace matmul_bf16_avx2_6x16
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
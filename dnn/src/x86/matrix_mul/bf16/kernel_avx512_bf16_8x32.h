@@ -0,0 +1,186 @@
+/**
+ * \file dnn/src/x86/matrix_mul/bf16/kernel_avx512_bf16_8x32.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+#include <immintrin.h>
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace x86 {
+namespace matmul_avx512_bf16_8x32 {
+
+//! widen 16 bfloat16 to float
+MEGDNN_ATTRIBUTE_TARGET("avx512f")
+static inline __m512 cvt_bf16x16_f32(__m256i v) {
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16));
+}
+
+/*!
+ * \brief compute a (m_remain, n_remain) block of C with packA of layout
+ * (K / 2, 8, 2) and packB of layout (K / 2, 32, 2), where odd K is padded with
+ * zero. Each vdpbf16ps multiplies a dword pair of A broadcast to all lanes by
+ * 16 pairs of B and accumulates both products in float; 16 zmm registers are
+ * used as the accumulators, which are rounded to bfloat16 on store.
+ *
+ * \tparam m_remain number of valid rows, which is in [1, 8]
+ * \param n_remain number of valid cols, which is in [1, 32]
+ */
+template <int m_remain>
+MEGDNN_ATTRIBUTE_TARGET("avx512f,avx512bw,avx512vl,avx512bf16")
+static inline void kern_8x32(
+        const uint16_t* packA, const uint16_t* packB, int K, uint16_t* output,
+        int LDC, bool is_first_k, int n_remain) {
+    __m512 c[8][2];
+#define cb(i)                          \
+    if (i < m_remain) {                \
+        c[i][0] = _mm512_setzero_ps(); \
+        c[i][1] = _mm512_setzero_ps(); \
+    }
+    UNROLL_CALL_NOWRAPPER(8, cb);
+#undef cb
+
+    const int* a_pairs = reinterpret_cast<const int*>(packA);
+    for (int k = 0; k < K; k += 2) {
+        __m512bh b0 = (__m512bh)_mm512_loadu_si512(packB);
+        __m512bh b1 = (__m512bh)_mm512_loadu_si512(packB + 32);
+#define cb(i)                                                \
+    if (i < m_remain) {                                      \
+        __m512bh a = (__m512bh)_mm512_set1_epi32(a_pairs[i]); \
+        c[i][0] = _mm512_dpbf16_ps(c[i][0], a, b0);          \
+        c[i][1] = _mm512_dpbf16_ps(c[i][1], a, b1);          \
+    }
+        UNROLL_CALL_NOWRAPPER(8, cb);
+#undef cb
+        a_pairs += 8;
+        packB += 64;
+    }
+
+    int n0 = std::min(n_remain, 16), n1 = n_remain - n0;
+    __mmask16 mask0 = static_cast<__mmask16>((1u << n0) - 1);
+    __mmask16 mask1 = static_cast<__mmask16>((1u << n1) - 1);
+#define cb(i)                                                                      \
+    if (i < m_remain) {                                                            \
+        uint16_t* cptr = output + i * LDC;                                         \
+        if (!is_first_k) {                                                         \
+            c[i][0] = _mm512_add_ps(                                               \
+                    c[i][0], cvt_bf16x16_f32(_mm256_maskz_loadu_epi16(mask0, cptr))); \
+            c[i][1] = _mm512_add_ps(                                               \
+                    c[i][1],                                                       \
+                    cvt_bf16x16_f32(_mm256_maskz_loadu_epi16(mask1, cptr + 16)));  \
+        }                                                                          \
+        _mm256_mask_storeu_epi16(                                                  \
+                cptr, mask0, (__m256i)_mm512_cvtneps_pbh(c[i][0]));                \
+        _mm256_mask_storeu_epi16(                                                  \
+                cptr + 16, mask1, (__m256i)_mm512_cvtneps_pbh(c[i][1]));           \
+    }
+    UNROLL_CALL_NOWRAPPER(8, cb);
+#undef cb
+}
+
+/*!
+ * pack the (K, 8) panels of A into dword pairs of adjacent k, where get(y, k)
+ * returns the element of row y and col k of A
+ */
+template <typename Getter>
+static inline void pack_a_pairs(
+        uint16_t* out, int y0, int ymax, int k0, int kmax, Getter get) {
+    for (int y = y0; y < ymax; y += 8) {
+        const int nr_row = std::min(8, ymax - y);
+        for (int k = k0; k < kmax; k += 2) {
+            for (int i = 0; i < 8; ++i) {
+                bool valid = i < nr_row;
+                out[2 * i] = valid ? get(y + i, k) : 0;
+                out[2 * i + 1] = valid && k + 1 < kmax ? get(y + i, k + 1) : 0;
+            }
+            out += 16;
+        }
+    }
+}
+
+static inline void bf16gemm_avx512_8x32_pack_an(
+        uint16_t* out, const uint16_t* in, int ldin, int y0, int ymax, int k0,
+        int kmax) {
+    pack_a_pairs(out, y0, ymax, k0, kmax, [=](int y, int k) {
+        return in[y * ldin + k];
+    });
+}
+
+static inline void bf16gemm_avx512_8x32_pack_at(
+        uint16_t* out, const uint16_t* in, int ldin, int y0, int ymax, int k0,
+        int kmax) {
+    pack_a_pairs(out, y0, ymax, k0, kmax, [=](int y, int k) {
+        return in[k * ldin + y];
+    });
+}
+
+//! pack cols [x0, xmax) of a (K, N) matrix into (K / 2, 32, 2) panels
+static inline void bf16gemm_avx512_8x32_pack_bn(
+        uint16_t* out, const uint16_t* in, int ldin, int x0, int xmax, int k0,
+        int kmax) {
+    for (int x = x0; x < xmax; x += 32) {
+        const int nr_col = std::min(32, xmax - x);
+        for (int k = k0; k < kmax; k += 2) {
+            const uint16_t* row0 = in + k * ldin + x;
+            const uint16_t* row1 = k + 1 < kmax ? row0 + ldin : nullptr;
+            if (nr_col == 32) {
+                //! interleave the two rows 8 cols at a time
+                for (int i = 0; i < 32; i += 8) {
+                    __m128i r0 = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(row0 + i));
+                    __m128i r1 = row1 ? _mm_loadu_si128(
+                                                reinterpret_cast<const __m128i*>(
+                                                        row1 + i))
+                                      : _mm_setzero_si128();
+                    _mm_storeu_si128(
+                            reinterpret_cast<__m128i*>(out + 2 * i),
+                            _mm_unpacklo_epi16(r0, r1));
+                    _mm_storeu_si128(
+                            reinterpret_cast<__m128i*>(out + 2 * i + 8),
+                            _mm_unpackhi_epi16(r0, r1));
+                }
+            } else {
+                for (int i = 0; i < 32; ++i) {
+                    bool valid = i < nr_col;
+                    out[2 * i] = valid ? row0[i] : 0;
+                    out[2 * i + 1] = valid && row1 ? row1[i] : 0;
+                }
+            }
+            out += 64;
+        }
+    }
+}
+
+//! pack rows [x0, xmax) of a (N, K) matrix into (K / 2, 32, 2) panels
+static inline void bf16gemm_avx512_8x32_pack_bt(
+        uint16_t* out, const uint16_t* in, int ldin, int x0, int xmax, int k0,
+        int kmax) {
+    for (int x = x0; x < xmax; x += 32) {
+        const int nr_col = std::min(32, xmax - x);
+        for (int k = k0; k < kmax; k += 2) {
+            for (int i = 0; i < 32; ++i) {
+                bool valid = i < nr_col;
+                out[2 * i] = valid ? in[(x + i) * ldin + k] : 0;
+                out[2 * i + 1] = valid && k + 1 < kmax ? in[(x + i) * ldin + k + 1] : 0;
+            }
+            out += 64;
+        }
+    }
+}
+
+}  // namespace matmul_avx512_bf16_8x32
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
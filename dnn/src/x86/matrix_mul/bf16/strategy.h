@@ -0,0 +1,37 @@
+/**
+ * \file dnn/src/x86/matrix_mul/bf16/strategy.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#pragma once
+#include "src/fallback/matrix_mul/gemm_common.h"
+
+namespace megdnn {
+namespace x86 {
+namespace matmul {
+
+#if !MEGDNN_DISABLE_FLOAT16
+//! A is widened to float when packed, as it is reused by all the cols of B
+MEGDNN_REG_GEMM_STRATEGY_WITH_PACK_A_TYPE(
+        dt_bfloat16, float, dt_bfloat16, float, 6, 16, 1, false, false,
+        bf16gemm_pack_6x16_avx2);
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+MEGDNN_REG_GEMM_STRATEGY(
+        dt_bfloat16, dt_bfloat16, float, 8, 32, 2, false, false,
+        bf16gemm_pack_8x32_avx512_bf16);
+#endif
+#endif
+
+}  // namespace matmul
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
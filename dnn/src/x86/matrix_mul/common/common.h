@@ -17,6 +17,7 @@
 #include <fmaintrin.h>
 #include <smmintrin.h>
 #endif
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <type_traits>
@@ -979,6 +980,173 @@ static inline void transpose_4x12_1_b_add_128(
     inptr2 += 12;
     inptr3 += 12;
 }
+
+//! mask of the first n of the 8 float lanes, n in [0, 8]
+MEGDNN_ATTRIBUTE_TARGET("avx")
+static inline __m256i mask_first_n_ps_8(int n) {
+    static const int32_t mask_table[16] = {-1, -1, -1, -1, -1, -1, -1, -1,
+                                           0,  0,  0,  0,  0,  0,  0,  0};
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask_table + 8 - n));
+}
+
+//! transpose the 8x8 matrix whose rows are r[0..7] in place
+MEGDNN_ATTRIBUTE_TARGET("avx")
+static inline void transpose_8x8_ps(__m256 (&r)[8]) {
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]),
+           t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]),
+           t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]),
+           t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+           s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+           s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+           s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2)),
+           s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)),
+           s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2)),
+           s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)),
+           s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+/*!
+ * \brief pack rows [y0, ymax) x cols [k0, kmax) of a row major float matrix
+ * into panels of interleave rows, each panel is stored as (k, interleave) and
+ * the rows out of range are filled with zero
+ *
+ * Each group of 8 rows is transposed by 8x8 blocks, only AVX is required so it
+ * is also used by the AVX-512 kernels.
+ */
+template <int interleave>
+MEGDNN_ATTRIBUTE_TARGET("avx")
+static inline void pack_rows_interleave_avx(
+        float* out, const float* in, int ldin, int y0, int ymax, int k0, int kmax) {
+    constexpr int NR_GROUP = (interleave + 7) / 8;
+    //! mask of the output lanes of each group
+    __m256i store_mask[NR_GROUP];
+    for (int g = 0; g < NR_GROUP; ++g) {
+        store_mask[g] = mask_first_n_ps_8(std::min(8, interleave - g * 8));
+    }
+    const int ksize = kmax - k0;
+    for (int y = y0; y < ymax; y += interleave) {
+        const int nr_row = std::min(interleave, ymax - y);
+        const float* inptr = in + y * ldin + k0;
+        int k = 0;
+        for (; k + 8 <= ksize; k += 8) {
+            for (int g = 0; g < NR_GROUP; ++g) {
+                __m256 r[8];
+                for (int i = 0; i < 8; ++i) {
+                    int row = g * 8 + i;
+                    r[i] = row < nr_row ? _mm256_loadu_ps(inptr + row * ldin + k)
+                                        : _mm256_setzero_ps();
+                }
+                transpose_8x8_ps(r);
+                float* optr = out + k * interleave + g * 8;
+                if (interleave - g * 8 >= 8) {
+                    for (int i = 0; i < 8; ++i) {
+                        _mm256_storeu_ps(optr + i * interleave, r[i]);
+                    }
+                } else {
+                    for (int i = 0; i < 8; ++i) {
+                        _mm256_maskstore_ps(optr + i * interleave, store_mask[g], r[i]);
+                    }
+                }
+            }
+        }
+        for (; k < ksize; ++k) {
+            float* optr = out + k * interleave;
+            int i = 0;
+            for (; i < nr_row; ++i) {
+                optr[i] = inptr[i * ldin + k];
+            }
+            for (; i < interleave; ++i) {
+                optr[i] = 0;
+            }
+        }
+        out += ksize * interleave;
+    }
+}
+
+/*!
+ * \brief pack cols [x0, xmax) x rows [k0, kmax) of a row major float matrix
+ * into panels of interleave cols, each panel is stored as (k, interleave) and
+ * the cols out of range are filled with zero
+ */
+template <int interleave>
+MEGDNN_ATTRIBUTE_TARGET("avx")
+static inline void pack_cols_interleave_avx(
+        float* out, const float* in, int ldin, int x0, int xmax, int k0, int kmax) {
+    constexpr int NR_GROUP = (interleave + 7) / 8;
+    __m256i store_mask[NR_GROUP], load_mask[NR_GROUP];
+    for (int g = 0; g < NR_GROUP; ++g) {
+        store_mask[g] = mask_first_n_ps_8(std::min(8, interleave - g * 8));
+    }
+    for (int x = x0; x < xmax; x += interleave) {
+        const int nr_col = std::min(interleave, xmax - x);
+        const float* inptr = in + k0 * ldin + x;
+        if (interleave % 8 == 0 && nr_col == interleave) {
+            for (int k = k0; k < kmax; ++k, inptr += ldin, out += interleave) {
+                for (int g = 0; g < NR_GROUP; ++g) {
+                    _mm256_storeu_ps(out + g * 8, _mm256_loadu_ps(inptr + g * 8));
+                }
+            }
+            continue;
+        }
+        //! the masked lanes are neither read nor written
+        for (int g = 0; g < NR_GROUP; ++g) {
+            load_mask[g] = mask_first_n_ps_8(std::max(0, std::min(8, nr_col - g * 8)));
+        }
+        for (int k = k0; k < kmax; ++k, inptr += ldin, out += interleave) {
+            for (int g = 0; g < NR_GROUP; ++g) {
+                _mm256_maskstore_ps(
+                        out + g * 8, store_mask[g],
+                        _mm256_maskload_ps(inptr + g * 8, load_mask[g]));
+            }
+        }
+    }
+}
+
+//! the AVX-512 version of pack_cols_interleave_avx
+template <int interleave>
+MEGDNN_ATTRIBUTE_TARGET("avx512f")
+static inline void pack_cols_interleave_avx512(
+        float* out, const float* in, int ldin, int x0, int xmax, int k0, int kmax) {
+    constexpr int NR_GROUP = (interleave + 15) / 16;
+    auto first_n = [](int n) {
+        return static_cast<__mmask16>((1u << std::max(0, std::min(16, n))) - 1);
+    };
+    __mmask16 store_mask[NR_GROUP], load_mask[NR_GROUP];
+    for (int g = 0; g < NR_GROUP; ++g) {
+        store_mask[g] = first_n(interleave - g * 16);
+    }
+    for (int x = x0; x < xmax; x += interleave) {
+        const int nr_col = std::min(interleave, xmax - x);
+        const float* inptr = in + k0 * ldin + x;
+        if (interleave % 16 == 0 && nr_col == interleave) {
+            for (int k = k0; k < kmax; ++k, inptr += ldin, out += interleave) {
+                for (int g = 0; g < NR_GROUP; ++g) {
+                    _mm512_storeu_ps(out + g * 16, _mm512_loadu_ps(inptr + g * 16));
+                }
+            }
+            continue;
+        }
+        for (int g = 0; g < NR_GROUP; ++g) {
+            load_mask[g] = first_n(nr_col - g * 16);
+        }
+        for (int k = k0; k < kmax; ++k, inptr += ldin, out += interleave) {
+            for (int g = 0; g < NR_GROUP; ++g) {
+                _mm512_mask_storeu_ps(
+                        out + g * 16, store_mask[g],
+                        _mm512_maskz_loadu_ps(load_mask[g], inptr + g * 16));
+            }
+        }
+    }
+}
 }  // namespace x86
 }  // namespace megdnn
 // vim: syntax=cpp.doxygen
@@ -0,0 +1,90 @@
+/**
+ * \file dnn/src/x86/matrix_mul/f32/avx512_strategy_14x32.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/f32/kernel_avx512_14x32.h"
+#include "src/x86/matrix_mul/f32/strategy.h"
+
+using namespace megdnn;
+using namespace x86;
+using namespace x86::matmul;
+
+namespace {
+
+void sgemm_kern_14x32(
+        const float* packA, const float* packB, size_t M, size_t N, size_t K, float* C,
+        size_t LDC, bool is_first_k) {
+    constexpr size_t m_tile = 14;
+    constexpr size_t n_tile = 32;
+    //! the B panel of n_tile cols is reused by all the A panels
+    for (size_t n = 0; n < N; n += n_tile) {
+        int n_remain = static_cast<int>(std::min(N - n, n_tile));
+        const float* b_ptr = packB + n * K;
+        for (size_t m = 0; m < M; m += m_tile) {
+            const float* a_ptr = packA + m * K;
+            float* c_ptr = C + m * LDC + n;
+            switch (std::min(M - m, m_tile)) {
+#define cb(i)                                                       \
+    case i + 1:                                                     \
+        matmul_avx512_14x32::kern_14x32<i + 1>(                     \
+                a_ptr, b_ptr, K, c_ptr, LDC, is_first_k, n_remain); \
+        break;
+                UNROLL_CALL_NOWRAPPER(14, cb);
+#undef cb
+                default:
+                    megdnn_assert_internal(0);
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+MEGDNN_REG_GEMM_STRATEGY_IMPL(sgemm_pack_14x32_avx512);
+
+void sgemm_pack_14x32_avx512::pack_A(
+        float* out, const float* in, int ldin, int y0, int ymax, int k0, int kmax,
+        bool transpose_A) const {
+    if (transpose_A) {
+        matmul_avx512_14x32::sgemm_avx512_14x32_pack_at(
+                out, in, ldin, y0, ymax, k0, kmax);
+    } else {
+        matmul_avx512_14x32::sgemm_avx512_14x32_pack_an(
+                out, in, ldin, y0, ymax, k0, kmax);
+    }
+}
+
+void sgemm_pack_14x32_avx512::pack_B(
+        float* out, const float* in, int ldin, int x0, int xmax, int k0, int kmax,
+        bool transpose_B) const {
+    if (transpose_B) {
+        matmul_avx512_14x32::sgemm_avx512_14x32_pack_bt(
+                out, in, ldin, x0, xmax, k0, kmax);
+    } else {
+        matmul_avx512_14x32::sgemm_avx512_14x32_pack_bn(
+                out, in, ldin, x0, xmax, k0, kmax);
+    }
+}
+
+void sgemm_pack_14x32_avx512::kern(
+        const float* packA, const float* packB, size_t M, size_t N, size_t K, float* C,
+        size_t LDC, bool is_first_k, const float*, float*) const {
+    megdnn_assert(
+            A_dtype.enumv() == B_dtype.enumv() && A_dtype.enumv() == C_dtype.enumv() &&
+            A_dtype.enumv() == DTypeEnum::Float32);
+    MEGDNN_MARK_USED_VAR(A_dtype);
+    MEGDNN_MARK_USED_VAR(B_dtype);
+    MEGDNN_MARK_USED_VAR(C_dtype);
+    sgemm_kern_14x32(packA, packB, M, N, K, C, LDC, is_first_k);
+}
+
+// vim: syntax=cpp.doxygen
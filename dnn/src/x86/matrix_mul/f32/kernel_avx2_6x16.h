@@ -0,0 +1,121 @@
+/**
+ * \file dnn/src/x86/matrix_mul/f32/kernel_avx2_6x16.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include <immintrin.h>
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/common/common.h"
+
+namespace megdnn {
+namespace x86 {
+namespace matmul_avx2_6x16 {
+
+/*!
+ * \brief compute a (m_remain, n_remain) block of C with packA of layout
+ * (K, 6) and packB of layout (K, 16), 12 ymm registers are used as the
+ * accumulators
+ *
+ * \tparam m_remain number of valid rows, which is in [1, 6]
+ * \param n_remain number of valid cols, which is in [1, 16]
+ */
+template <int m_remain>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+static inline void kern_6x16(
+        const float* packA, const float* packB, int K, float* output, int LDC,
+        bool is_first_k, int n_remain) {
+    __m256 c[6][2];
+#define cb(i)                          \
+    if (i < m_remain) {                \
+        c[i][0] = _mm256_setzero_ps(); \
+        c[i][1] = _mm256_setzero_ps(); \
+    }
+    UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+    for (int k = 0; k < K; ++k) {
+        __m256 b0 = _mm256_loadu_ps(packB);
+        __m256 b1 = _mm256_loadu_ps(packB + 8);
+#define cb(i)                                      \
+    if (i < m_remain) {                            \
+        __m256 a = _mm256_broadcast_ss(packA + i); \
+        c[i][0] = _mm256_fmadd_ps(a, b0, c[i][0]); \
+        c[i][1] = _mm256_fmadd_ps(a, b1, c[i][1]); \
+    }
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+        packA += 6;
+        packB += 16;
+    }
+
+    if (n_remain == 16) {
+#define cb(i)                                                            \
+    if (i < m_remain) {                                                  \
+        float* cptr = output + i * LDC;                                  \
+        if (!is_first_k) {                                               \
+            c[i][0] = _mm256_add_ps(c[i][0], _mm256_loadu_ps(cptr));     \
+            c[i][1] = _mm256_add_ps(c[i][1], _mm256_loadu_ps(cptr + 8)); \
+        }                                                                \
+        _mm256_storeu_ps(cptr, c[i][0]);                                 \
+        _mm256_storeu_ps(cptr + 8, c[i][1]);                             \
+    }
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+    } else {
+        //! load the masks of the valid lanes from a sliding window
+        static const int32_t mask_table[16] = {-1, -1, -1, -1, -1, -1, -1, -1,
+                                               0,  0,  0,  0,  0,  0,  0,  0};
+        int n0 = std::min(n_remain, 8), n1 = n_remain - n0;
+        __m256i mask0 = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(mask_table + 8 - n0));
+        __m256i mask1 = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(mask_table + 8 - n1));
+#define cb(i)                                                                      \
+    if (i < m_remain) {                                                            \
+        float* cptr = output + i * LDC;                                            \
+        if (!is_first_k) {                                                         \
+            c[i][0] = _mm256_add_ps(c[i][0], _mm256_maskload_ps(cptr, mask0));     \
+            c[i][1] = _mm256_add_ps(c[i][1], _mm256_maskload_ps(cptr + 8, mask1)); \
+        }                                                                          \
+        _mm256_maskstore_ps(cptr, mask0, c[i][0]);                                 \
+        _mm256_maskstore_ps(cptr + 8, mask1, c[i][1]);                             \
+    }
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+    }
+}
+
+static inline void sgemm_avx2_6x16_pack_an(
+        float* out, const float* in, int ldin, int y0, int ymax, int k0, int kmax) {
+    pack_rows_interleave_avx<6>(out, in, ldin, y0, ymax, k0, kmax);
+}
+
+static inline void sgemm_avx2_6x16_pack_at(
+        float* out, const float* in, int ldin, int y0, int ymax, int k0, int kmax) {
+    pack_cols_interleave_avx<6>(out, in, ldin, y0, ymax, k0, kmax);
+}
+
+static inline void sgemm_avx2_6x16_pack_bn(
+        float* out, const float* in, int ldin, int x0, int xmax, int k0, int kmax) {
+    pack_cols_interleave_avx<16>(out, in, ldin, x0, xmax, k0, kmax);
+}
+
+static inline void sgemm_avx2_6x16_pack_bt(
+        float* out, const float* in, int ldin, int x0, int xmax, int k0, int kmax) {
+    pack_rows_interleave_avx<16>(out, in, ldin, x0, xmax, k0, kmax);
+}
+
+}  // namespace matmul_avx2_6x16
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,102 @@
+/**
+ * \file dnn/src/x86/matrix_mul/f32/kernel_avx512_14x32.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include <immintrin.h>
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/common/common.h"
+
+namespace megdnn {
+namespace x86 {
+namespace matmul_avx512_14x32 {
+
+/*!
+ * \brief compute a (m_remain, n_remain) block of C with packA of layout
+ * (K, 14) and packB of layout (K, 32), 28 zmm registers are used as the
+ * accumulators, 2 for B and 1 for the broadcast of A
+ *
+ * \tparam m_remain number of valid rows, which is in [1, 14]
+ * \param n_remain number of valid cols, which is in [1, 32]
+ */
+template <int m_remain>
+MEGDNN_ATTRIBUTE_TARGET("avx512f")
+static inline void kern_14x32(
+        const float* packA, const float* packB, int K, float* output, int LDC,
+        bool is_first_k, int n_remain) {
+    __m512 c[14][2];
+#define cb(i)                          \
+    if (i < m_remain) {                \
+        c[i][0] = _mm512_setzero_ps(); \
+        c[i][1] = _mm512_setzero_ps(); \
+    }
+    UNROLL_CALL_NOWRAPPER(14, cb);
+#undef cb
+
+    for (int k = 0; k < K; ++k) {
+        __m512 b0 = _mm512_loadu_ps(packB);
+        __m512 b1 = _mm512_loadu_ps(packB + 16);
+#define cb(i)                                      \
+    if (i < m_remain) {                            \
+        __m512 a = _mm512_set1_ps(packA[i]);       \
+        c[i][0] = _mm512_fmadd_ps(a, b0, c[i][0]); \
+        c[i][1] = _mm512_fmadd_ps(a, b1, c[i][1]); \
+    }
+        UNROLL_CALL_NOWRAPPER(14, cb);
+#undef cb
+        packA += 14;
+        packB += 32;
+    }
+
+    int n0 = std::min(n_remain, 16), n1 = n_remain - n0;
+    __mmask16 mask0 = static_cast<__mmask16>((1u << n0) - 1);
+    __mmask16 mask1 = static_cast<__mmask16>((1u << n1) - 1);
+#define cb(i)                                                                     \
+    if (i < m_remain) {                                                           \
+        float* cptr = output + i * LDC;                                           \
+        if (!is_first_k) {                                                        \
+            c[i][0] = _mm512_add_ps(c[i][0], _mm512_maskz_loadu_ps(mask0, cptr)); \
+            c[i][1] = _mm512_add_ps(                                              \
+                    c[i][1], _mm512_maskz_loadu_ps(mask1, cptr + 16));            \
+        }                                                                         \
+        _mm512_mask_storeu_ps(cptr, mask0, c[i][0]);                              \
+        _mm512_mask_storeu_ps(cptr + 16, mask1, c[i][1]);                         \
+    }
+    UNROLL_CALL_NOWRAPPER(14, cb);
+#undef cb
+}
+
+static inline void sgemm_avx512_14x32_pack_an(
+        float* out, const float* in, int ldin, int y0, int ymax, int k0, int kmax) {
+    pack_rows_interleave_avx<14>(out, in, ldin, y0, ymax, k0, kmax);
+}
+
+static inline void sgemm_avx512_14x32_pack_at(
+        float* out, const float* in, int ldin, int y0, int ymax, int k0, int kmax) {
+    pack_cols_interleave_avx512<14>(out, in, ldin, y0, ymax, k0, kmax);
+}
+
+static inline void sgemm_avx512_14x32_pack_bn(
+        float* out, const float* in, int ldin, int x0, int xmax, int k0, int kmax) {
+    pack_cols_interleave_avx512<32>(out, in, ldin, x0, xmax, k0, kmax);
+}
+
+static inline void sgemm_avx512_14x32_pack_bt(
+        float* out, const float* in, int ldin, int x0, int xmax, int k0, int kmax) {
+    pack_rows_interleave_avx<32>(out, in, ldin, x0, xmax, k0, kmax);
+}
+
+}  // namespace matmul_avx512_14x32
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
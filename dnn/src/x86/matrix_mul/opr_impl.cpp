@@ -34,6 +34,14 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
     AlgoInt8x8x16AVX2 algoint8x8x16avx2_m4n16k2;
     AlgoInt8x8x16SSE algoint8x8x16sse_m4n8k2;
     AlgoF32MK8_8x8 algof32mk8_8x8;
+    AlgoF32AVX512M14N32 algof32avx512_m14n32;
+    AlgoF32AVX2M6N16 algof32avx2_m6n16;
+#if !MEGDNN_DISABLE_FLOAT16
+    AlgoBF16AVX2M6N16 algobf16avx2_m6n16;
+#if MEGDNN_X86_WITH_AVX512_BF16
+    AlgoBF16AVX512M8N32 algobf16avx512_m8n32;
+#endif
+#endif
 
     SmallVector<fallback::MatrixMulImpl::AlgoBase*> m_all_algos;
     fallback::MatrixMulImpl::AlgoBase::Mapper m_all_algos_map;
@@ -58,6 +66,18 @@ public:
 #if MEGDNN_X86_WITH_MKL && SUPPORT_MKL_PACKED_GEMM
         m_all_algos.emplace_back(&f32mkl_packa);
 #endif
+        //! placed after blas, so they are only chosen by heuristic when the
+        //! blas library is not available
+        m_all_algos.emplace_back(&algof32avx512_m14n32);
+        m_all_algos.emplace_back(&algof32avx2_m6n16);
+#if !MEGDNN_DISABLE_FLOAT16
+        if (is_supported(SIMDType::BF16)) {
+#if MEGDNN_X86_WITH_AVX512_BF16
+            m_all_algos.emplace_back(&algobf16avx512_m8n32);
+#endif
+        }
+        m_all_algos.emplace_back(&algobf16avx2_m6n16);
+#endif
 
         for (auto&& algo : m_all_algos) {
             m_all_algos_map.emplace(algo->info().desc, algo);
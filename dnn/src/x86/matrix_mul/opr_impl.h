@@ -67,6 +67,14 @@ private:
     class AlgoInt8x8x16SSE;
     class AlgoPack;
     class AlgoF32MK8_8x8;
+    class AlgoF32AVX2M6N16;
+    class AlgoF32AVX512M14N32;
+#if !MEGDNN_DISABLE_FLOAT16
+    class AlgoBF16AVX2M6N16;
+#if MEGDNN_X86_WITH_AVX512_BF16
+    class AlgoBF16AVX512M8N32;
+#endif
+#endif
 
 public:
     static const AlgoPack& algo_pack();
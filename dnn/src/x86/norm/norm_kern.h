@@ -0,0 +1,33 @@
+/**
+ * \file dnn/src/x86/norm/norm_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/fallback/norm/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace norm {
+
+using Kern = fallback::norm::Kern;
+
+//! get the kernels of given simd type, which needs avx2 and fma or avx512f
+Kern get_norm_kern_avx2();
+Kern get_norm_kern_avx512();
+
+//! get the best kernels supported by the cpu
+Kern get_norm_kern();
+
+}  // namespace norm
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
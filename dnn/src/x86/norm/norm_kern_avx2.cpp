@@ -0,0 +1,22 @@
+/**
+ * \file dnn/src/x86/norm/norm_kern_avx2.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/norm/norm_kern.h"
+
+#include "src/x86/simd_vec_avx2.h"
+
+#include "src/fallback/norm/norm_kern_helper.h"
+
+megdnn::x86::norm::Kern megdnn::x86::norm::get_norm_kern_avx2() {
+    return {megdnn::norm::layer_norm<VecAVX2>, megdnn::norm::group_norm<VecAVX2>};
+}
+
+// vim: syntax=cpp.doxygen
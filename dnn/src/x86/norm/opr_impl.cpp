@@ -0,0 +1,38 @@
+/**
+ * \file dnn/src/x86/norm/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/norm/opr_impl.h"
+
+#include "src/x86/norm/norm_kern.h"
+#include "src/x86/utils.h"
+
+using namespace megdnn;
+using namespace x86;
+
+norm::Kern norm::get_norm_kern() {
+    if (is_supported(SIMDType::AVX512)) {
+        return get_norm_kern_avx512();
+    }
+    if (is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA)) {
+        return get_norm_kern_avx2();
+    }
+    return fallback::norm::get_default_kern();
+}
+
+fallback::norm::Kern LayerNormForwardImpl::get_kern() const {
+    return norm::get_norm_kern();
+}
+
+fallback::norm::Kern GroupNormForwardImpl::get_kern() const {
+    return norm::get_norm_kern();
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,111 @@
+/**
+ * \file dnn/src/x86/reduce/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/reduce/opr_impl.h"
+
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+#include "src/x86/reduce/reduce_kern.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_x86_reduce)
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+//! do not split the computation into tasks smaller than this number of floats
+constexpr size_t MIN_TASK_SIZE = 16384;
+//! number of columns processed by one task when C > 1
+constexpr size_t C_BLOCK = 64;
+}  // anonymous namespace
+
+x86::reduce::ReduceKern x86::reduce::get_reduce_kern(Mode mode) {
+    if (is_supported(SIMDType::AVX512)) {
+        return get_reduce_kern_avx512(mode);
+    }
+    if (is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA)) {
+        return get_reduce_kern_avx2(mode);
+    }
+    if (is_supported(SIMDType::SSE)) {
+        return get_reduce_kern_sse(mode);
+    }
+    return {};
+}
+
+void ReduceImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+    if (src.layout.dtype != dtype::Float32() ||
+        param().data_type != Param::DataType::DEFAULT || src.layout.is_empty()) {
+        return fallback::ReduceImpl::exec(src, dst, workspace);
+    }
+    auto kern = x86::reduce::get_reduce_kern(param().mode);
+    if (!kern.c1) {
+        return fallback::ReduceImpl::exec(src, dst, workspace);
+    }
+    size_t A, B, C;
+    megdnn::reduce::get_ABC(src.layout, A, B, C, param().axis);
+    const float* sptr = src.ptr<dt_float32>();
+    float* dptr = dst.ptr<dt_float32>();
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    if (C == 1) {
+        MIDOUT_BEGIN(megdnn_x86_reduce, midout_iv(0)) {
+            //! split the rows evenly to the threads, each task reduces
+            //! nr_row_per_task contiguous rows
+            size_t nr_task = std::min(A, std::max<size_t>(1, A * B / MIN_TASK_SIZE));
+            nr_task = std::min(nr_task, nr_threads);
+            size_t nr_row_per_task = div_ceil(A, nr_task);
+            nr_task = div_ceil(A, nr_row_per_task);
+            auto c1 = kern.c1;
+            auto run = [=](size_t index, size_t) {
+                size_t begin = index * nr_row_per_task;
+                size_t end = std::min(A, begin + nr_row_per_task);
+                c1(sptr + begin * B, dptr + begin, end - begin, B);
+            };
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, nr_task);
+            return;
+        }
+        MIDOUT_END();
+    } else {
+        MIDOUT_BEGIN(megdnn_x86_reduce, midout_iv(1)) {
+            //! the (A, C) plane is divided into blocks of C_BLOCK columns, and
+            //! each task processes a contiguous range of these blocks
+            size_t nr_cblk = div_ceil(C, C_BLOCK);
+            size_t nr_blk = A * nr_cblk;
+            size_t nr_task = std::min(
+                    nr_blk, std::max<size_t>(1, A * B * C / MIN_TASK_SIZE));
+            nr_task = std::min(nr_task, nr_threads);
+            size_t nr_blk_per_task = div_ceil(nr_blk, nr_task);
+            nr_task = div_ceil(nr_blk, nr_blk_per_task);
+            auto strided = kern.strided;
+            auto run = [=](size_t index, size_t) {
+                size_t begin = index * nr_blk_per_task;
+                size_t end = std::min(nr_blk, begin + nr_blk_per_task);
+                for (size_t blk = begin; blk < end; ++blk) {
+                    size_t a = blk / nr_cblk, c = blk % nr_cblk * C_BLOCK;
+                    strided(sptr + a * B * C + c, dptr + a * C + c, B, C,
+                            std::min(C_BLOCK, C - c));
+                }
+            };
+            MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(run, nr_task);
+            return;
+        }
+        MIDOUT_END();
+    }
+    fallback::ReduceImpl::exec(src, dst, workspace);
+}
+
+// vim: syntax=cpp.doxygen
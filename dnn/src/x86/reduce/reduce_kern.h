@@ -0,0 +1,58 @@
+/**
+ * \file dnn/src/x86/reduce/reduce_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/opr_param_defs.h"
+#include "src/x86/utils.h"
+
+#include <cstddef>
+
+namespace megdnn {
+namespace x86 {
+namespace reduce {
+
+using Mode = param::Reduce::Mode;
+
+/*!
+ * \brief reduce contiguous float rows
+ *
+ * src is of shape (nr_row, B) and dst is of shape (nr_row)
+ */
+using ReduceC1Kern = void (*)(const float* src, float* dst, size_t nr_row, size_t B);
+
+/*!
+ * \brief reduce float src of shape (B, C) along B, for columns [0, nr_c)
+ *
+ * src and dst point to the first column to be reduced, the row stride of src
+ * is C
+ */
+using ReduceStridedKern = void (*)(
+        const float* src, float* dst, size_t B, size_t C, size_t nr_c);
+
+struct ReduceKern {
+    ReduceC1Kern c1 = nullptr;
+    ReduceStridedKern strided = nullptr;
+};
+
+//! get the kernels of given mode, simd_type must be SSE, AVX2 or AVX512
+ReduceKern get_reduce_kern_sse(Mode mode);
+ReduceKern get_reduce_kern_avx2(Mode mode);
+ReduceKern get_reduce_kern_avx512(Mode mode);
+
+//! get the kernels of the most advanced simd type supported by the cpu
+ReduceKern get_reduce_kern(Mode mode);
+
+}  // namespace reduce
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,20 @@
+/**
+ * \file dnn/src/x86/reduce/reduce_kern_avx2.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/simd_vec_avx2.h"
+
+#include "src/x86/reduce/reduce_kern_helper.h"
+
+megdnn::x86::reduce::ReduceKern megdnn::x86::reduce::get_reduce_kern_avx2(Mode mode) {
+    return get_reduce_kern_impl<VecAVX2>(mode);
+}
+
+// vim: syntax=cpp.doxygen
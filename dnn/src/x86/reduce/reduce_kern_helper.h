@@ -0,0 +1,228 @@
+/**
+ * \file dnn/src/x86/reduce/reduce_kern_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+//! this file is included by reduce_kern_{sse,avx2,avx512}.cpp after the
+//! simd_vec header of the arch, Vec must provide the following: type, width,
+//! load, set1, add, mul, fmadd, max, min, reduce_add, reduce_mul, reduce_max
+//! and reduce_min
+
+#include "src/x86/reduce/reduce_kern.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace megdnn {
+namespace x86 {
+namespace reduce {
+namespace {
+
+template <class Vec>
+struct SumOp {
+    using vtype = typename Vec::type;
+    static constexpr float INIT = 0.f;
+    static MEGDNN_SIMD_VEC_TARGET vtype feed(vtype acc, vtype v) {
+        return Vec::add(acc, v);
+    }
+    static float feed(float acc, float v) { return acc + v; }
+    static MEGDNN_SIMD_VEC_TARGET vtype apply(vtype a, vtype b) {
+        return Vec::add(a, b);
+    }
+    static float apply(float a, float b) { return a + b; }
+    static MEGDNN_SIMD_VEC_TARGET float hreduce(vtype v) { return Vec::reduce_add(v); }
+    static MEGDNN_SIMD_VEC_TARGET vtype post(vtype v, vtype) { return v; }
+    static float post(float v, float) { return v; }
+};
+
+template <class Vec>
+struct MeanOp : SumOp<Vec> {
+    using vtype = typename Vec::type;
+    using SumOp<Vec>::post;
+    //! the second argument is 1 / B
+    static MEGDNN_SIMD_VEC_TARGET vtype post(vtype v, vtype coef) {
+        return Vec::mul(v, coef);
+    }
+    static float post(float v, float coef) { return v * coef; }
+};
+
+template <class Vec>
+struct SumSqrOp : SumOp<Vec> {
+    using vtype = typename Vec::type;
+    static MEGDNN_SIMD_VEC_TARGET vtype feed(vtype acc, vtype v) {
+        return Vec::fmadd(v, v, acc);
+    }
+    static float feed(float acc, float v) { return acc + v * v; }
+};
+
+template <class Vec>
+struct ProductOp {
+    using vtype = typename Vec::type;
+    static constexpr float INIT = 1.f;
+    static MEGDNN_SIMD_VEC_TARGET vtype feed(vtype acc, vtype v) {
+        return Vec::mul(acc, v);
+    }
+    static float feed(float acc, float v) { return acc * v; }
+    static MEGDNN_SIMD_VEC_TARGET vtype apply(vtype a, vtype b) {
+        return Vec::mul(a, b);
+    }
+    static float apply(float a, float b) { return a * b; }
+    static MEGDNN_SIMD_VEC_TARGET float hreduce(vtype v) { return Vec::reduce_mul(v); }
+    static MEGDNN_SIMD_VEC_TARGET vtype post(vtype v, vtype) { return v; }
+    static float post(float v, float) { return v; }
+};
+
+template <class Vec>
+struct MaxOp {
+    using vtype = typename Vec::type;
+    static constexpr float INIT = -std::numeric_limits<float>::max();
+    static MEGDNN_SIMD_VEC_TARGET vtype feed(vtype acc, vtype v) {
+        return Vec::max(acc, v);
+    }
+    static float feed(float acc, float v) { return std::max(acc, v); }
+    static MEGDNN_SIMD_VEC_TARGET vtype apply(vtype a, vtype b) {
+        return Vec::max(a, b);
+    }
+    static float apply(float a, float b) { return std::max(a, b); }
+    static MEGDNN_SIMD_VEC_TARGET float hreduce(vtype v) { return Vec::reduce_max(v); }
+    static MEGDNN_SIMD_VEC_TARGET vtype post(vtype v, vtype) { return v; }
+    static float post(float v, float) { return v; }
+};
+
+template <class Vec>
+struct MinOp {
+    using vtype = typename Vec::type;
+    static constexpr float INIT = std::numeric_limits<float>::max();
+    static MEGDNN_SIMD_VEC_TARGET vtype feed(vtype acc, vtype v) {
+        return Vec::min(acc, v);
+    }
+    static float feed(float acc, float v) { return std::min(acc, v); }
+    static MEGDNN_SIMD_VEC_TARGET vtype apply(vtype a, vtype b) {
+        return Vec::min(a, b);
+    }
+    static float apply(float a, float b) { return std::min(a, b); }
+    static MEGDNN_SIMD_VEC_TARGET float hreduce(vtype v) { return Vec::reduce_min(v); }
+    static MEGDNN_SIMD_VEC_TARGET vtype post(vtype v, vtype) { return v; }
+    static float post(float v, float) { return v; }
+};
+
+//! the elements in a block are accumulated in simd registers, and the
+//! results of blocks are accumulated in a scalar, which bounds the rounding
+//! error like the pairwise reduction in fallback
+constexpr size_t C1_BLOCK = 4096;
+
+template <class Vec, class Op>
+MEGDNN_SIMD_VEC_TARGET void reduce_c1(
+        const float* src, float* dst, size_t nr_row, size_t B) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    const float coef = 1.f / B;
+    for (size_t row = 0; row < nr_row; ++row) {
+        const float* sptr = src + row * B;
+        float res = Op::INIT;
+        for (size_t bl = 0; bl < B; bl += C1_BLOCK) {
+            size_t br = std::min(B, bl + C1_BLOCK);
+            size_t b = bl;
+            vtype init = Vec::set1(Op::INIT);
+            vtype acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+            for (; b + 4 * W <= br; b += 4 * W) {
+                acc0 = Op::feed(acc0, Vec::load(sptr + b));
+                acc1 = Op::feed(acc1, Vec::load(sptr + b + W));
+                acc2 = Op::feed(acc2, Vec::load(sptr + b + 2 * W));
+                acc3 = Op::feed(acc3, Vec::load(sptr + b + 3 * W));
+            }
+            for (; b + W <= br; b += W) {
+                acc0 = Op::feed(acc0, Vec::load(sptr + b));
+            }
+            acc0 = Op::apply(Op::apply(acc0, acc1), Op::apply(acc2, acc3));
+            float block_res = Op::hreduce(acc0);
+            for (; b < br; ++b) {
+                block_res = Op::feed(block_res, sptr[b]);
+            }
+            res = Op::apply(res, block_res);
+        }
+        dst[row] = Op::post(res, coef);
+    }
+}
+
+template <class Vec, class Op>
+MEGDNN_SIMD_VEC_TARGET void reduce_strided(
+        const float* src, float* dst, size_t B, size_t C, size_t nr_c) {
+    using vtype = typename Vec::type;
+    constexpr size_t W = Vec::width;
+    const vtype vcoef = Vec::set1(1.f / B);
+    const vtype init = Vec::set1(Op::INIT);
+    size_t c = 0;
+    for (; c + 4 * W <= nr_c; c += 4 * W) {
+        vtype acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+        const float* sptr = src + c;
+        for (size_t b = 0; b < B; ++b, sptr += C) {
+            acc0 = Op::feed(acc0, Vec::load(sptr));
+            acc1 = Op::feed(acc1, Vec::load(sptr + W));
+            acc2 = Op::feed(acc2, Vec::load(sptr + 2 * W));
+            acc3 = Op::feed(acc3, Vec::load(sptr + 3 * W));
+        }
+        Vec::store(dst + c, Op::post(acc0, vcoef));
+        Vec::store(dst + c + W, Op::post(acc1, vcoef));
+        Vec::store(dst + c + 2 * W, Op::post(acc2, vcoef));
+        Vec::store(dst + c + 3 * W, Op::post(acc3, vcoef));
+    }
+    for (; c + W <= nr_c; c += W) {
+        vtype acc = init;
+        const float* sptr = src + c;
+        for (size_t b = 0; b < B; ++b, sptr += C) {
+            acc = Op::feed(acc, Vec::load(sptr));
+        }
+        Vec::store(dst + c, Op::post(acc, vcoef));
+    }
+    if (c < nr_c) {
+        const float coef = 1.f / B;
+        float acc[W];
+        std::fill_n(acc, nr_c - c, Op::INIT);
+        const float* sptr = src + c;
+        for (size_t b = 0; b < B; ++b, sptr += C) {
+            for (size_t i = 0; i < nr_c - c; ++i) {
+                acc[i] = Op::feed(acc[i], sptr[i]);
+            }
+        }
+        for (size_t i = 0; i < nr_c - c; ++i) {
+            dst[c + i] = Op::post(acc[i], coef);
+        }
+    }
+}
+
+template <class Vec>
+ReduceKern get_reduce_kern_impl(Mode mode) {
+    ReduceKern ret;
+#define cb(_mode, _op)                                 \
+    case Mode::_mode:                                  \
+        ret.c1 = reduce_c1<Vec, _op<Vec>>;             \
+        ret.strided = reduce_strided<Vec, _op<Vec>>;   \
+        break;
+    switch (mode) {
+        cb(SUM, SumOp);
+        cb(MEAN, MeanOp);
+        cb(SUM_SQR, SumSqrOp);
+        cb(PRODUCT, ProductOp);
+        cb(MAX, MaxOp);
+        cb(MIN, MinOp);
+        default:
+            break;
+    }
+#undef cb
+    return ret;
+}
+
+}  // anonymous namespace
+}  // namespace reduce
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
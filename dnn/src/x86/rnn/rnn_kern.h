@@ -0,0 +1,32 @@
+/**
+ * \file dnn/src/x86/rnn/rnn_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/fallback/rnn/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace rnn {
+
+using StepKern = fallback::rnn::StepKern;
+
+//! get the kernels of given simd type, which needs avx2 and fma or avx512f
+StepKern get_lstm_kern_avx2();
+StepKern get_gru_kern_avx2();
+StepKern get_lstm_kern_avx512();
+StepKern get_gru_kern_avx512();
+
+}  // namespace rnn
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,26 @@
+/**
+ * \file dnn/src/x86/rnn/rnn_kern_avx2.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/rnn/rnn_kern.h"
+
+#include "src/x86/simd_vec_avx2.h"
+
+#include "src/fallback/rnn/rnn_kern_helper.h"
+
+megdnn::x86::rnn::StepKern megdnn::x86::rnn::get_lstm_kern_avx2() {
+    return megdnn::rnn::step<VecAVX2, true>;
+}
+
+megdnn::x86::rnn::StepKern megdnn::x86::rnn::get_gru_kern_avx2() {
+    return megdnn::rnn::step<VecAVX2, false>;
+}
+
+// vim: syntax=cpp.doxygen
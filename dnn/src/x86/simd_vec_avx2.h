@@ -0,0 +1,111 @@
+/**
+ * \file dnn/src/x86/simd_vec_avx2.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+//! float32 vector of AVX2 used by the kernels templated on Vec, like softmax,
+//! attention and rnn. The rest of the including file is compiled for
+//! avx2 and fma by gcc, so it should only be included by the translation units
+//! of AVX2 kernels; the templated kernels must be marked with
+//! MEGDNN_SIMD_VEC_TARGET for clang.
+
+#include <immintrin.h>
+#include "src/common/utils.h"
+
+#define MEGDNN_SIMD_VEC_TARGET
+#if !defined(__clang__)
+//! bypass gcc bug https://bugs.launchpad.net/ubuntu/+source/gcc-5/+bug/1642109
+#pragma GCC target("avx2,fma")
+#else
+#undef MEGDNN_SIMD_VEC_TARGET
+#define MEGDNN_SIMD_VEC_TARGET MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+#endif
+
+#include "src/x86/exp_approx.h"
+
+namespace {
+struct VecAVX2 {
+    using type = __m256;
+    static constexpr size_t width = 8;
+    static MEGDNN_SIMD_VEC_TARGET type load(const float* p) {
+        return _mm256_loadu_ps(p);
+    }
+    static MEGDNN_SIMD_VEC_TARGET void store(float* p, type v) {
+        _mm256_storeu_ps(p, v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type set1(float v) { return _mm256_set1_ps(v); }
+    static MEGDNN_SIMD_VEC_TARGET type add(type a, type b) {
+        return _mm256_add_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type sub(type a, type b) {
+        return _mm256_sub_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type mul(type a, type b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type div(type a, type b) {
+        return _mm256_div_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type fmadd(type a, type b, type c) {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type max(type a, type b) {
+        return _mm256_max_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type min(type a, type b) {
+        return _mm256_min_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type round(type v) {
+        return _mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    //! 2^n for integral n in [-126, 127]
+    static MEGDNN_SIMD_VEC_TARGET type pow2n(type n) {
+        __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+    }
+    static MEGDNN_SIMD_VEC_TARGET type exp(type v) { return exp_approx<VecAVX2>(v); }
+
+    //! fold the high 128 bits, then reduce 4 lanes by two shuffles
+    template <__m128 (*op)(__m128, __m128)>
+    static MEGDNN_SIMD_VEC_TARGET float hreduce(type v) {
+        __m128 x = op(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        x = op(x, _mm_movehl_ps(x, x));
+        x = op(x, _mm_shuffle_ps(x, x, 0x55));
+        return _mm_cvtss_f32(x);
+    }
+    static MEGDNN_SIMD_VEC_TARGET __m128 add4(__m128 a, __m128 b) {
+        return _mm_add_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET __m128 mul4(__m128 a, __m128 b) {
+        return _mm_mul_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET __m128 max4(__m128 a, __m128 b) {
+        return _mm_max_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET __m128 min4(__m128 a, __m128 b) {
+        return _mm_min_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_add(type v) {
+        return hreduce<add4>(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_mul(type v) {
+        return hreduce<mul4>(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_max(type v) {
+        return hreduce<max4>(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_min(type v) {
+        return hreduce<min4>(v);
+    }
+};
+}  // anonymous namespace
+
+// vim: syntax=cpp.doxygen
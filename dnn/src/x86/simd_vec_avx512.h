@@ -0,0 +1,91 @@
+/**
+ * \file dnn/src/x86/simd_vec_avx512.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+//! float32 vector of AVX-512 used by the kernels templated on Vec, like
+//! softmax, attention and rnn. The rest of the including file is compiled for
+//! avx512f by gcc, so it should only be included by the translation units of
+//! AVX-512 kernels; the templated kernels must be marked with
+//! MEGDNN_SIMD_VEC_TARGET for clang.
+
+#include <immintrin.h>
+#include "src/common/utils.h"
+
+#define MEGDNN_SIMD_VEC_TARGET
+#if !defined(__clang__)
+#pragma GCC target("avx512f")
+#else
+#undef MEGDNN_SIMD_VEC_TARGET
+#define MEGDNN_SIMD_VEC_TARGET MEGDNN_ATTRIBUTE_TARGET("avx512f")
+#endif
+
+#include "src/x86/exp_approx.h"
+
+namespace {
+struct VecAVX512 {
+    using type = __m512;
+    static constexpr size_t width = 16;
+    static MEGDNN_SIMD_VEC_TARGET type load(const float* p) {
+        return _mm512_loadu_ps(p);
+    }
+    static MEGDNN_SIMD_VEC_TARGET void store(float* p, type v) {
+        _mm512_storeu_ps(p, v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type set1(float v) { return _mm512_set1_ps(v); }
+    static MEGDNN_SIMD_VEC_TARGET type add(type a, type b) {
+        return _mm512_add_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type sub(type a, type b) {
+        return _mm512_sub_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type mul(type a, type b) {
+        return _mm512_mul_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type div(type a, type b) {
+        return _mm512_div_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type fmadd(type a, type b, type c) {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type max(type a, type b) {
+        return _mm512_max_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type min(type a, type b) {
+        return _mm512_min_ps(a, b);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type round(type v) {
+        return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+    //! 2^n for integral n in [-126, 127]
+    static MEGDNN_SIMD_VEC_TARGET type pow2n(type n) {
+        __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+    }
+    static MEGDNN_SIMD_VEC_TARGET type exp(type v) {
+        return exp_approx<VecAVX512>(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_add(type v) {
+        return _mm512_reduce_add_ps(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_mul(type v) {
+        return _mm512_reduce_mul_ps(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_max(type v) {
+        return _mm512_reduce_max_ps(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_min(type v) {
+        return _mm512_reduce_min_ps(v);
+    }
+};
+}  // anonymous namespace
+
+// vim: syntax=cpp.doxygen
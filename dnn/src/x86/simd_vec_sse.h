@@ -0,0 +1,62 @@
+/**
+ * \file dnn/src/x86/simd_vec_sse.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+//! float32 vector of SSE used by the kernels templated on Vec, like reduce.
+//! The rest of the including file is compiled for sse by gcc, so it should
+//! only be included by the translation units of SSE kernels; the templated
+//! kernels must be marked with MEGDNN_SIMD_VEC_TARGET for clang. There is no
+//! exp since SSE lacks round, and fmadd is not fused.
+
+#include <xmmintrin.h>
+#include "src/common/utils.h"
+
+#define MEGDNN_SIMD_VEC_TARGET
+#if !defined(__clang__)
+#pragma GCC target("sse")
+#else
+#undef MEGDNN_SIMD_VEC_TARGET
+#define MEGDNN_SIMD_VEC_TARGET MEGDNN_ATTRIBUTE_TARGET("sse")
+#endif
+
+namespace {
+struct VecSSE {
+    using type = __m128;
+    static constexpr size_t width = 4;
+    static MEGDNN_SIMD_VEC_TARGET type load(const float* p) { return _mm_loadu_ps(p); }
+    static MEGDNN_SIMD_VEC_TARGET void store(float* p, type v) { _mm_storeu_ps(p, v); }
+    static MEGDNN_SIMD_VEC_TARGET type set1(float v) { return _mm_set1_ps(v); }
+    static MEGDNN_SIMD_VEC_TARGET type add(type a, type b) { return _mm_add_ps(a, b); }
+    static MEGDNN_SIMD_VEC_TARGET type sub(type a, type b) { return _mm_sub_ps(a, b); }
+    static MEGDNN_SIMD_VEC_TARGET type mul(type a, type b) { return _mm_mul_ps(a, b); }
+    static MEGDNN_SIMD_VEC_TARGET type div(type a, type b) { return _mm_div_ps(a, b); }
+    static MEGDNN_SIMD_VEC_TARGET type fmadd(type a, type b, type c) {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    static MEGDNN_SIMD_VEC_TARGET type max(type a, type b) { return _mm_max_ps(a, b); }
+    static MEGDNN_SIMD_VEC_TARGET type min(type a, type b) { return _mm_min_ps(a, b); }
+
+    //! reduce 4 lanes to lane 0 by two shuffles
+    template <type (*op)(type, type)>
+    static MEGDNN_SIMD_VEC_TARGET float hreduce(type v) {
+        v = op(v, _mm_movehl_ps(v, v));
+        v = op(v, _mm_shuffle_ps(v, v, 0x55));
+        return _mm_cvtss_f32(v);
+    }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_add(type v) { return hreduce<add>(v); }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_mul(type v) { return hreduce<mul>(v); }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_max(type v) { return hreduce<max>(v); }
+    static MEGDNN_SIMD_VEC_TARGET float reduce_min(type v) { return hreduce<min>(v); }
+};
+}  // anonymous namespace
+
+// vim: syntax=cpp.doxygen
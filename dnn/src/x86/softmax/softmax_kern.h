@@ -0,0 +1,30 @@
+/**
+ * \file dnn/src/x86/softmax/softmax_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/fallback/softmax/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace softmax {
+
+using Kern = fallback::SoftmaxForwardImpl::Kern;
+
+//! get the kernels of given simd type, which needs avx2 and fma or avx512f
+Kern get_softmax_kern_avx2();
+Kern get_softmax_kern_avx512();
+
+}  // namespace softmax
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -96,6 +96,36 @@ bool feature_detect_avx2() {
     return (eax & 6) == 6;
 }
 
+bool feature_detect_avx512() {
+    uint32_t eax, ebx, ecx, edx;
+
+    // check cpu support
+#if defined(_WIN32)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 7);
+    eax = cpuInfo[0];
+    ebx = cpuInfo[1];
+    ecx = cpuInfo[2];
+    edx = cpuInfo[3];
+#else
+    asm volatile("cpuid\n"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(7), "c"(0)
+                 : "cc");
+#endif
+    // avx512f  ---> 16 ebx
+    // avx512dq ---> 17 ebx
+    // avx512bw ---> 30 ebx
+    // avx512vl ---> 31 ebx
+    if (!(bit(ebx, 16) && bit(ebx, 17) && bit(ebx, 30) && bit(ebx, 31)))
+        return false;
+
+    // check os support of the opmask and zmm state
+    asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return (eax & 0xe6) == 0xe6;
+}
+
 bool feature_detect_vnni() {
     uint32_t eax, ebx, ecx, edx;
 
@@ -127,6 +157,32 @@ bool feature_detect_vnni() {
     return (eax & 6) == 6;
 }
 
+bool feature_detect_bf16() {
+    if (!feature_detect_avx512())
+        return false;
+    uint32_t eax, ebx, ecx, edx;
+
+    // check cpu support
+#if defined(_WIN32)
+    int cpuInfo[4];
+    __cpuidex(cpuInfo, 7, 1);
+    eax = cpuInfo[0];
+    ebx = cpuInfo[1];
+    ecx = cpuInfo[2];
+    edx = cpuInfo[3];
+#else
+    asm volatile("cpuid\n"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(7), "c"(1)
+                 : "cc");
+#endif
+    MEGDNN_MARK_USED_VAR(ebx);
+    MEGDNN_MARK_USED_VAR(ecx);
+    MEGDNN_MARK_USED_VAR(edx);
+    // avx512_bf16 ---> 5 eax of subleaf 1
+    return bit(eax, 5);
+}
+
 bool feature_detect_avx_fma(int ftr) {
     // see Detecting Availability and Support in
     // https://software.intel.com/en-us/articles/introduction-to-intel-advanced-vector-extensions
@@ -145,7 +201,9 @@ bool feature_detect_avx_fma(int ftr) {
 bool is_avx_supported = feature_detect_avx_fma(28);
 bool is_fma_supported = feature_detect_avx_fma(12);
 bool is_avx2_supported = feature_detect_avx2();
+bool is_avx512_supported = feature_detect_avx512();
 bool is_vnni_supported = feature_detect_vnni();
+bool is_bf16_supported = feature_detect_bf16();
 
 SIMDType disabled_simd_type_thresh = SIMDType::__NR_SIMD_TYPE;
 
@@ -177,8 +235,12 @@ bool x86::is_supported(SIMDType type) {
             return is_fma_supported;
         case SIMDType::AVX2:
             return is_avx2_supported;
+        case SIMDType::AVX512:
+            return is_avx512_supported;
         case SIMDType::VNNI:
             return is_vnni_supported;
+        case SIMDType::BF16:
+            return is_bf16_supported;
         default:
             break;
     }
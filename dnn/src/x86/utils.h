@@ -37,7 +37,9 @@ enum class SIMDType {
     AVX,
     AVX2,
     FMA,
+    AVX512,  //! avx512f, avx512dq, avx512bw and avx512vl
     VNNI,
+    BF16,  //! avx512_bf16 on top of AVX512
     NONE,
     __NR_SIMD_TYPE  //! total number of SIMD types; used for testing
 };
@@ -0,0 +1,39 @@
+/**
+ * \file dnn/test/arm_common/attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/arm_common/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(ARM_COMMON_MULTI_THREADS, ATTENTION) {
+    Checker<Attention> checker(handle());
+    UniformFloatRNG rng(-2.f, 2.f);
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_epsilon(1e-4);
+    for (bool causal : {false, true})
+        for (size_t Lq : {1, 7, 70})
+            for (size_t Lk : {70, 129})
+                for (size_t D : {3, 16, 64}) {
+                    checker.set_param({1.f / std::sqrt(float(D)), causal});
+                    TensorShape q{2, Lq, D}, kv{2, Lk, D};
+                    checker.execs({q, kv, kv, {}, {}});
+                    checker.execs({q, kv, kv, {Lq, Lk}, {}});
+                }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,47 @@
+/**
+ * \file dnn/test/arm_common/norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/arm_common/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(ARM_COMMON_MULTI_THREADS, LAYER_NORM) {
+    Checker<LayerNorm> checker(handle());
+    UniformFloatRNG rng(-5.f, 5.f);
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    for (bool affine : {false, true})
+        for (size_t nr_row : {1, 3, 64})
+            for (size_t row_size : {1, 7, 16, 17, 127, 768}) {
+                LayerNorm::Param param{affine, 1e-5f, 1};
+                TensorShape w = affine ? TensorShape{row_size} : TensorShape{};
+                checker.set_param(param).execs({{nr_row, row_size}, w, w, {}});
+            }
+}
+
+TEST_F(ARM_COMMON_MULTI_THREADS, GROUP_NORM) {
+    Checker<GroupNorm> checker(handle());
+    UniformFloatRNG rng(-5.f, 5.f);
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    for (bool affine : {false, true})
+        for (uint32_t group : {1, 4, 8})
+            for (size_t HW : {1, 7, 64, 3136}) {
+                GroupNorm::Param param{affine, 1e-5f, group};
+                TensorShape w = affine ? TensorShape{16} : TensorShape{};
+                checker.set_param(param).execs({{2, 16, HW}, w, w, {}});
+            }
+}
+
+// vim: syntax=cpp.doxygen
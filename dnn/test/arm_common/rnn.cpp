@@ -0,0 +1,51 @@
+/**
+ * \file dnn/test/arm_common/rnn.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/arm_common/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+#include "test/common/rnn.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(ARM_COMMON_MULTI_THREADS, LSTM) {
+    Checker<LSTM> checker(handle());
+    UniformFloatRNG rng(-1.f, 1.f);
+    for (size_t i : {0, 2, 3, 4}) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_dtype(1, dtype::Int32()).set_epsilon(1e-4);
+    for (auto&& arg : rnn::get_args(LSTM::NR_GATE)) {
+        UniformIntRNG len_rng(0, arg.input[0]);
+        checker.set_rng(1, &len_rng).set_param(arg.param);
+        checker.execs(
+                {arg.input, arg.seq_len, arg.hx, arg.cx, arg.weights, {}, {}, {}});
+    }
+}
+
+TEST_F(ARM_COMMON_MULTI_THREADS, GRU) {
+    Checker<GRU> checker(handle());
+    UniformFloatRNG rng(-1.f, 1.f);
+    for (size_t i : {0, 2, 3}) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_dtype(1, dtype::Int32()).set_epsilon(1e-4);
+    for (auto&& arg : rnn::get_args(GRU::NR_GATE)) {
+        UniformIntRNG len_rng(0, arg.input[0]);
+        checker.set_rng(1, &len_rng).set_param(arg.param);
+        checker.execs({arg.input, arg.seq_len, arg.hx, arg.weights, {}, {}});
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,48 @@
+/**
+ * \file dnn/test/common/argsort.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/oprs/general.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+//! check ArgsortForward against the naive impl on rows of distinct values,
+//! covering the small, comparison and radix sort sizes of the cpu kernels
+static inline void run_argsort_forward_test(Handle* handle, DType dtype) {
+    Checker<ArgsortForward> checker(handle);
+    using Order = ArgsortForward::Param::Order;
+    std::unique_ptr<IIDRNG> iid_rng;
+    if (dtype == dtype::Float32()) {
+        iid_rng = std::make_unique<UniformFloatRNG>(-100.f, 100.f);
+    } else {
+        megdnn_assert(dtype == dtype::Int32());
+        iid_rng = std::make_unique<UniformIntRNG>(INT_MIN, INT_MAX);
+    }
+    NoReplacementRNG rng(iid_rng.get());
+    checker.set_dtype(0, dtype).set_dtype(2, dtype::Int32()).set_rng(0, &rng);
+    for (auto order : {Order::ASCENDING, Order::DESCENDING}) {
+        checker.set_param({order});
+        for (size_t n : {1, 7, 8, 16, 17, 100, 1023, 1024, 5000}) {
+            checker.execs({{1, n}, {}, {}});
+            checker.execs({{13, n}, {}, {}});
+        }
+        checker.execs({{2, 70001}, {}, {}});
+    }
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
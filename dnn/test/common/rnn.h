@@ -0,0 +1,67 @@
+/**
+ * \file dnn/test/common/rnn.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/basic_types.h"
+#include "megdnn/oprs/nn.h"
+
+namespace megdnn {
+namespace test {
+namespace rnn {
+
+struct TestArg {
+    param::RNN param;
+    //! input, seq_len, hx, cx and flatten_weights, where cx is empty for GRU
+    TensorShape input, seq_len, hx, cx, weights;
+    TestArg(param::RNN param_, TensorShape input_, TensorShape seq_len_,
+            TensorShape hx_, TensorShape cx_, TensorShape weights_)
+            : param(param_),
+              input(input_),
+              seq_len(seq_len_),
+              hx(hx_),
+              cx(cx_),
+              weights(weights_) {}
+};
+
+static inline std::vector<TestArg> get_args(size_t nr_gate) {
+    std::vector<TestArg> args;
+    auto add = [&](size_t T, size_t N, size_t I, size_t H, size_t L, bool bidirectional,
+                   bool bias, bool with_seq_len) {
+        param::RNN param{static_cast<uint32_t>(L), bidirectional, bias};
+        size_t D = bidirectional ? 2 : 1, nr_weight;
+        RNNBase::get_weight_offsets(param, nr_gate, I, H, nr_weight);
+        TensorShape state{L * D, N, H};
+        args.emplace_back(
+                param, TensorShape{T, N, I},
+                with_seq_len ? TensorShape{N} : TensorShape{}, state,
+                nr_gate == LSTM::NR_GATE ? state : TensorShape{},
+                TensorShape{nr_weight});
+    };
+    for (size_t L : {1, 2, 3})
+        for (bool bidirectional : {false, true})
+            for (bool bias : {false, true})
+                for (bool with_seq_len : {false, true}) {
+                    add(5, 3, 7, 17, L, bidirectional, bias, with_seq_len);
+                }
+    //! a single step and a single row
+    add(1, 1, 4, 8, 1, false, true, false);
+    add(9, 1, 33, 40, 1, true, true, true);
+    //! hidden size larger than the block of units and not a multiple of simd
+    add(4, 6, 64, 131, 2, true, true, true);
+    return args;
+}
+
+}  // namespace rnn
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
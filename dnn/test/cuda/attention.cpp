@@ -0,0 +1,44 @@
+/**
+ * \file dnn/test/cuda/attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(CUDA, ATTENTION_FORWARD) {
+    Checker<Attention> checker(handle_cuda());
+    UniformFloatRNG rng(-2.f, 2.f);
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Float16()}) {
+        for (size_t i = 0; i < 5; ++i) {
+            checker.set_dtype(i, dtype);
+        }
+        checker.set_epsilon(dtype == dtype::Float16() ? 1e-2 : 1e-4);
+        for (bool causal : {false, true}) {
+            checker.set_param({0.125f, causal});
+            checker.execs({{2, 7, 64}, {2, 70, 64}, {2, 70, 33}, {}, {}});
+            checker.execs({{2, 7, 64}, {2, 70, 64}, {2, 70, 33}, {7, 70}, {}});
+            checker.execs(
+                    {{2, 3, 5, 16}, {2, 3, 9, 16}, {2, 3, 9, 16}, {2, 3, 5, 9}, {}});
+        }
+    }
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,60 @@
+/**
+ * \file dnn/test/cuda/norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(CUDA, LAYER_NORM_FORWARD) {
+    Checker<LayerNorm> checker(handle_cuda());
+    UniformFloatRNG rng(-5.f, 5.f);
+    checker.set_rng(0, &rng);
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Float16()}) {
+        for (size_t i = 0; i < 4; ++i) {
+            checker.set_dtype(i, dtype);
+        }
+        checker.set_epsilon(dtype == dtype::Float16() ? 1e-2 : 1e-4);
+        for (bool affine : {false, true}) {
+            checker.set_param({affine, 1e-5f, 1});
+            TensorShape w = affine ? TensorShape{768} : TensorShape{};
+            checker.execs({{3, 768}, w, w, {}});
+            w = affine ? TensorShape{5} : TensorShape{};
+            checker.execs({{2, 7, 5}, w, w, {}});
+        }
+        checker.set_param({true, 1e-5f, 2}).execs({{4, 6, 65}, {6, 65}, {6, 65}, {}});
+    }
+}
+
+TEST_F(CUDA, GROUP_NORM_FORWARD) {
+    Checker<GroupNorm> checker(handle_cuda());
+    UniformFloatRNG rng(-5.f, 5.f);
+    checker.set_rng(0, &rng);
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Float16()}) {
+        for (size_t i = 0; i < 4; ++i) {
+            checker.set_dtype(i, dtype);
+        }
+        checker.set_epsilon(dtype == dtype::Float16() ? 1e-2 : 1e-4);
+        for (bool affine : {false, true})
+            for (uint32_t group : {1, 4}) {
+                checker.set_param({affine, 1e-5f, group});
+                TensorShape w = affine ? TensorShape{8} : TensorShape{};
+                checker.execs({{2, 8, 7, 9}, w, w, {}});
+            }
+    }
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
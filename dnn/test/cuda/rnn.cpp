@@ -0,0 +1,65 @@
+/**
+ * \file dnn/test/cuda/rnn.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+#include "test/common/rnn.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(CUDA, LSTM_FORWARD) {
+    Checker<LSTM> checker(handle_cuda());
+    UniformFloatRNG rng(-1.f, 1.f);
+    for (size_t i : {0, 2, 3, 4}) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_dtype(1, dtype::Int32());
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Float16()}) {
+        for (size_t i : {0, 2, 3, 4, 5, 6, 7}) {
+            checker.set_dtype(i, dtype);
+        }
+        checker.set_epsilon(dtype == dtype::Float16() ? 1e-2 : 1e-4);
+        for (auto&& arg : rnn::get_args(LSTM::NR_GATE)) {
+            UniformIntRNG len_rng(0, arg.input[0]);
+            checker.set_rng(1, &len_rng).set_param(arg.param);
+            checker.execs(
+                    {arg.input, arg.seq_len, arg.hx, arg.cx, arg.weights, {}, {}, {}});
+        }
+    }
+}
+
+TEST_F(CUDA, GRU_FORWARD) {
+    Checker<GRU> checker(handle_cuda());
+    UniformFloatRNG rng(-1.f, 1.f);
+    for (size_t i : {0, 2, 3}) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_dtype(1, dtype::Int32());
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Float16()}) {
+        for (size_t i : {0, 2, 3, 4, 5}) {
+            checker.set_dtype(i, dtype);
+        }
+        checker.set_epsilon(dtype == dtype::Float16() ? 1e-2 : 1e-4);
+        for (auto&& arg : rnn::get_args(GRU::NR_GATE)) {
+            UniformIntRNG len_rng(0, arg.input[0]);
+            checker.set_rng(1, &len_rng).set_param(arg.param);
+            checker.execs({arg.input, arg.seq_len, arg.hx, arg.weights, {}, {}});
+        }
+    }
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
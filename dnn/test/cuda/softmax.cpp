@@ -0,0 +1,39 @@
+/**
+ * \file dnn/test/cuda/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/cuda/fixture.h"
+
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(CUDA, SOFTMAX_FORWARD) {
+    Checker<Softmax> checker(handle_cuda());
+    UniformFloatRNG rng(-20.f, 20.f);
+    checker.set_rng(0, &rng);
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Float16()}) {
+        checker.set_dtype(0, dtype).set_dtype(1, dtype);
+        checker.set_epsilon(dtype == dtype::Float16() ? 1e-2 : 1e-4);
+        for (int32_t axis : {0, 1, 2, -1}) {
+            checker.set_param(axis);
+            checker.execs({{3, 7, 5}, {}});
+            checker.execs({{2, 130, 33}, {}});
+            checker.execs({{1, 1, 1}, {}});
+        }
+        checker.set_param(-1).execs({{4, 40000}, {}});
+    }
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,30 @@
+/**
+ * \file dnn/test/fallback/argsort.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/common/argsort.h"
+#include "test/fallback/fixture.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(FALLBACK, ARGSORT_FORWARD_F32) {
+    run_argsort_forward_test(handle(), dtype::Float32{});
+}
+
+TEST_F(FALLBACK, ARGSORT_FORWARD_I32) {
+    run_argsort_forward_test(handle(), dtype::Int32{});
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, ARGSORT_FORWARD_F32) {
+    run_argsort_forward_test(handle(), dtype::Float32{});
+}
+
+// vim: syntax=cpp.doxygen
@@ -26,6 +26,21 @@ TYPED_TEST_CASE(FALLBACK_ELEMWISE, elemwise::test_types);
 TYPED_TEST(FALLBACK_ELEMWISE, run) {
     elemwise::run_test<TypeParam>(this->handle());
 }
+
+TEST_F(FALLBACK_MULTI_THREADS, ELEMWISE_FORWARD_LARGE) {
+    using Mode = ElemwiseForward::Param::Mode;
+    Checker<ElemwiseForward> checker(handle());
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Int32()}) {
+        checker.set_dtype(0, dtype).set_dtype(1, dtype);
+        checker.set_param(Mode::NEGATE).execs({{3, 50021}, {}});
+        checker.set_param(Mode::ADD).execs({{3, 50021}, {3, 50021}, {}});
+        checker.set_param(Mode::SUB).execs({{300, 503}, {1, 503}, {}});
+        checker.set_param(Mode::SUB).execs({{300, 1}, {300, 503}, {}});
+        checker.set_param(Mode::MUL).execs({{2, 37, 2021}, {1, 37, 1}, {}});
+        checker.set_param(Mode::SUB).execs({{1, 37, 1}, {2, 37, 2021}, {}});
+    }
+}
+
 #if MEGDNN_WITH_BENCHMARK
 TEST_F(FALLBACK, BENCHMARK_ELEMWISE) {
     auto naive_handle = create_cpu_handle(2);
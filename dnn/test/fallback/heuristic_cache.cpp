@@ -0,0 +1,134 @@
+/**
+ * \file dnn/test/fallback/heuristic_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/heuristic_cache.h"
+#include "megdnn/oprs.h"
+
+#include <thread>
+
+namespace megdnn {
+namespace test {
+
+namespace {
+HeuristicCache::Result make_result(uint32_t algo_type, size_t workspace) {
+    HeuristicCache::Result ret;
+    ret.policy.algo.handle_type = Handle::HandleType::FALLBACK;
+    ret.policy.algo.type = algo_type;
+    ret.workspace = workspace;
+    return ret;
+}
+}  // anonymous namespace
+
+TEST_F(FALLBACK, HEURISTIC_CACHE) {
+    auto&& cache = HeuristicCache::instance();
+    cache.clear();
+    using OprType = Algorithm::OprType;
+    ConvolutionForward::Param param;
+    TensorLayout src{{2, 3, 16, 16}, dtype::Float32()},
+            filter{{8, 3, 3, 3}, dtype::Float32()},
+            dst{{2, 8, 14, 14}, dtype::Float32()};
+    TensorLayout layouts[] = {src, filter, dst};
+    HeuristicCache::Key key{
+            handle(), OprType::CONVOLUTION_FORWARD, layouts, 3, &param, sizeof(param)};
+
+    ASSERT_FALSE(cache.get(key).policy.algo.valid());
+    auto result = make_result(1, 123);
+    cache.put(key, result);
+    auto got = cache.get(key);
+    ASSERT_TRUE(got.policy.algo.valid());
+    ASSERT_EQ(1u, got.policy.algo.type);
+    ASSERT_EQ(123u, got.workspace);
+
+    // keys differing in stride, dtype, param or opr type must not collide
+    TensorLayout src_strided = src;
+    src_strided.stride[0] *= 2;
+    TensorLayout layouts_strided[] = {src_strided, filter, dst};
+    ASSERT_FALSE(cache.get({handle(), OprType::CONVOLUTION_FORWARD, layouts_strided, 3,
+                            &param, sizeof(param)})
+                         .policy.algo.valid());
+    TensorLayout layouts_f16[] = {src, filter, dst};
+    for (auto&& i : layouts_f16) {
+        i.dtype = dtype::Float16();
+    }
+    ASSERT_FALSE(cache.get({handle(), OprType::CONVOLUTION_FORWARD, layouts_f16, 3,
+                            &param, sizeof(param)})
+                         .policy.algo.valid());
+    auto param_pad = param;
+    param_pad.pad_h = 1;
+    ASSERT_FALSE(cache.get({handle(), OprType::CONVOLUTION_FORWARD, layouts, 3,
+                            &param_pad, sizeof(param_pad)})
+                         .policy.algo.valid());
+    ASSERT_FALSE(cache.get({handle(), OprType::CONVOLUTION_BACKWARD_DATA, layouts, 3,
+                            &param, sizeof(param)})
+                         .policy.algo.valid());
+
+    auto stats = cache.stats();
+    ASSERT_EQ(1u, stats.nr_hit);
+    ASSERT_EQ(5u, stats.nr_miss);
+
+    cache.clear();
+    ASSERT_FALSE(cache.get(key).policy.algo.valid());
+    stats = cache.stats();
+    ASSERT_EQ(0u, stats.nr_hit);
+    ASSERT_EQ(1u, stats.nr_miss);
+}
+
+TEST_F(FALLBACK, HEURISTIC_CACHE_CONCURRENT) {
+    auto&& cache = HeuristicCache::instance();
+    cache.clear();
+    constexpr size_t NR_THREAD = 8, NR_KEY = 64, NR_ITER = 20;
+    ConvolutionForward::Param param;
+
+    auto make_layouts = [](size_t i) {
+        return TensorLayoutArray{
+                TensorLayout{{1, 3, i + 1, 16}, dtype::Float32()},
+                TensorLayout{{8, 3, 1, 1}, dtype::Float32()},
+                TensorLayout{{1, 8, i + 1, 16}, dtype::Float32()}};
+    };
+
+    std::vector<std::thread> workers;
+    std::atomic_size_t nr_error{0};
+    for (size_t tid = 0; tid < NR_THREAD; ++tid) {
+        workers.emplace_back([&, tid]() {
+            for (size_t iter = 0; iter < NR_ITER; ++iter) {
+                for (size_t i = tid; i < NR_KEY + tid; ++i) {
+                    auto idx = i % NR_KEY;
+                    auto layouts = make_layouts(idx);
+                    HeuristicCache::Key key{
+                            handle(),       Algorithm::OprType::CONVOLUTION_FORWARD,
+                            layouts.data(), layouts.size(),
+                            &param,         sizeof(param)};
+                    auto got = cache.get(key);
+                    if (got.policy.algo.valid()) {
+                        nr_error += got.workspace != idx;
+                    } else {
+                        auto result = make_result(1, idx);
+                        cache.put(key, result);
+                    }
+                }
+            }
+        });
+    }
+    for (auto&& i : workers) {
+        i.join();
+    }
+    ASSERT_EQ(0u, nr_error.load());
+    auto stats = cache.stats();
+    ASSERT_EQ(NR_THREAD * NR_KEY * NR_ITER, stats.nr_hit + stats.nr_miss);
+    ASSERT_GE(stats.nr_miss, NR_KEY);
+    cache.clear();
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
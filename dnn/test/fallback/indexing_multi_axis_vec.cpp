@@ -0,0 +1,115 @@
+/**
+ * \file dnn/test/fallback/indexing_multi_axis_vec.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/common/index.h"
+#include "test/common/indexing_multi_axis_vec.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+template <class Opr>
+void run_check(Handle* handle, DType dtype) {
+    Checker<Opr> checker(handle);
+    size_t idx_size0, idx_size1;
+    UniformIntRNG rng_inp{-100, 100};
+    IndexRNG rng0{idx_size0, 2}, rng1{idx_size1, 3};
+    checker.set_dtype(0, dtype)
+            .set_dtype(1, dtype)
+            .set_dtype(2, dtype::Int32())
+            .set_dtype(3, dtype::Int32())
+            .set_rng(0, &rng_inp)
+            .set_rng(1, &rng_inp)
+            .set_rng(2, &rng0)
+            .set_rng(3, &rng1);
+
+    idx_size0 = 23;
+    checker.set_proxy({{0}})
+            .execs({{23}, {100}, {100}})
+            .execs({{23, 5}, {100, 5}, {100}});
+
+    // embedding lookup with duplicated rows
+    idx_size0 = 1000;
+    checker.set_proxy({{0}}).execs({{1000, 64}, {4096, 64}, {4096}});
+    idx_size0 = 50;
+    checker.set_proxy({{0}}).execs({{50, 2000}, {300, 2000}, {300}});
+
+    idx_size0 = 2;
+    idx_size1 = 3;
+    checker.set_proxy({{0, 1}})
+            .execs({{2, 3}, {10}, {10}, {10}})
+            .execs({{2, 3, 5}, {10, 5}, {10}, {10}});
+
+    idx_size0 = 4;
+    idx_size1 = 6;
+    TensorLayout inp_layout{{3, 4, 5, 6}, dtype};
+    inp_layout.stride[0] *= 8;
+    inp_layout.stride[1] *= 2;
+    checker.set_proxy({{1, 3}}).execl({
+            inp_layout,
+            {{7, 3, 5}, dtype},
+            {{7}, dtype::Int32()},
+            {{1}, dtype::Int32()},
+    });
+
+    idx_size0 = 4;
+    idx_size1 = 5;
+    checker.set_proxy({{2, 3}}).execs(
+            {{2, 3, 4, 5, 6, 7}, {2, 3, 10, 6, 7}, {10}, {10}});
+
+    idx_size0 = 4;
+    checker.set_proxy({{1}}).execs({{1, 4}, {1, 1024 * 1024}, {1024 * 1024}});
+    checker.set_proxy({{1}}).execs({{16, 4, 100}, {16, 300, 100}, {300}});
+
+    if (std::is_same<Opr, IndexingIncrMultiAxisVec>::value) {
+        idx_size0 = 4;
+        TensorLayout val_layout{{23}, dtype};
+        val_layout.stride[0] = 0;
+        checker.set_proxy({{0}}).execl(
+                {{{4}, dtype}, val_layout, {{23}, dtype::Int32()}});
+    }
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, INDEXING_MULTI_AXIS_VEC) {
+    run_check<IndexingMultiAxisVec>(handle(), dtype::Float32());
+    run_check<IndexingMultiAxisVec>(handle(), dtype::Int8());
+}
+
+TEST_F(FALLBACK, INDEXING_SET_MULTI_AXIS_VEC) {
+    run_check<IndexingSetMultiAxisVec>(handle(), dtype::Float32());
+    run_check<IndexingSetMultiAxisVec>(handle(), dtype::Int16());
+}
+
+TEST_F(FALLBACK, INDEXING_INCR_MULTI_AXIS_VEC) {
+    run_check<IndexingIncrMultiAxisVec>(handle(), dtype::Float32());
+    run_check<IndexingIncrMultiAxisVec>(handle(), dtype::Int32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_MULTI_AXIS_VEC) {
+    run_check<IndexingMultiAxisVec>(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_SET_MULTI_AXIS_VEC) {
+    run_check<IndexingSetMultiAxisVec>(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_INCR_MULTI_AXIS_VEC) {
+    run_check<IndexingIncrMultiAxisVec>(handle(), dtype::Float32());
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,35 @@
+/**
+ * \file dnn/test/fallback/indexing_one_hot.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/indexing_one_hot.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(FALLBACK, INDEXING_ONE_HOT) {
+    run_indexing_one_hot_test(handle());
+}
+
+TEST_F(FALLBACK, INDEXING_SET_ONE_HOT) {
+    run_indexing_set_one_hot_test(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_ONE_HOT) {
+    run_indexing_one_hot_test(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_SET_ONE_HOT) {
+    run_indexing_set_one_hot_test(handle());
+}
+
+// vim: syntax=cpp.doxygen
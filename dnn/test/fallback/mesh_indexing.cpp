@@ -0,0 +1,150 @@
+/**
+ * \file dnn/test/fallback/mesh_indexing.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/common/index.h"
+#include "test/common/mesh_indexing.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+
+template <class Opr, class RNG>
+void run_check(Handle* handle, DType dtype) {
+    Checker<Opr> checker(handle);
+    size_t idx_size0, idx_size1;
+    UniformIntRNG rng_inp{-100, 100};
+    RNG rng0{idx_size0, 2}, rng1{idx_size1, 3};
+    checker.set_dtype(0, dtype)
+            .set_dtype(1, dtype)
+            .set_dtype(2, dtype::Int32())
+            .set_dtype(3, dtype::Int32())
+            .set_rng(0, &rng_inp)
+            .set_rng(1, &rng_inp)
+            .set_rng(2, &rng0)
+            .set_rng(3, &rng1);
+
+    idx_size0 = 230;
+    checker.set_proxy({{0}})
+            .execs({{230}, {100}, {100}})
+            .execs({{230, 5}, {100, 5}, {100}});
+
+    // row gathers large enough to be split into tasks
+    idx_size0 = 1000;
+    checker.set_proxy({{0}}).execs({{1000, 64}, {512, 64}, {512}});
+    idx_size0 = 50;
+    checker.set_proxy({{0}}).execs({{50, 2000}, {30, 2000}, {30}});
+
+    idx_size0 = 30;
+    checker.set_proxy({{1}})
+            .execs({{2, 30}, {2, 10}, {10}})
+            .execs({{2, 30, 5}, {2, 20, 5}, {20}})
+            .execs({{2, 30, 5, 7}, {2, 25, 5, 7}, {25}})
+            .execs({{16, 30, 100}, {16, 20, 100}, {20}});
+
+    TensorLayout inp_layout{{3, 30, 5}, dtype};
+    inp_layout.stride[0] *= 2;
+    checker.set_proxy({{1}}).execl(
+            {inp_layout, {{3, 20, 5}, dtype}, {{20}, dtype::Int32()}});
+
+    idx_size0 = 23;
+    idx_size1 = 17;
+    checker.set_proxy({{3, 1}}).execs(
+            {{3, 17, 9, 23}, {3, 10, 9, 10}, {10}, {10}});
+}
+
+template <class Opr, class RNG>
+void run_batched_check(Handle* handle, DType dtype) {
+    Checker<Opr> checker(handle);
+    size_t idx_size0, idx_size1;
+    UniformIntRNG rng_inp{-100, 100};
+    RNG rng0{idx_size0, 2}, rng1{idx_size1, 3};
+    checker.set_dtype(0, dtype)
+            .set_dtype(1, dtype)
+            .set_dtype(2, dtype::Int32())
+            .set_dtype(3, dtype::Int32())
+            .set_rng(0, &rng_inp)
+            .set_rng(1, &rng_inp)
+            .set_rng(2, &rng0)
+            .set_rng(3, &rng1);
+
+    idx_size0 = 5;
+    checker.set_proxy({{1}}).execs({{2, 5}, {2, 3}, {2, 3}});
+    idx_size0 = 50;
+    checker.set_proxy({{1}})
+            .execs({{4, 50, 300}, {4, 20, 300}, {4, 20}})
+            .execs({{2, 3, 50, 7}, {2, 3, 20, 7}, {2, 20}});
+    checker.set_proxy({{2}}).execs({{2, 3, 50, 7}, {2, 3, 20, 7}, {2, 20}});
+
+    if (!std::is_same<Opr, BatchedSetMeshIndexing>::value) {
+        idx_size0 = 5;
+        TensorLayout index_layout{TensorShape{1, 3}, dtype::Int32()};
+        index_layout = index_layout.broadcast({2, 3});
+        checker.set_proxy({{1}}).execl(
+                {TensorLayout{TensorShape{2, idx_size0}, dtype},
+                 TensorLayout{TensorShape{2, 3}, dtype}, index_layout});
+    }
+
+    idx_size0 = 23;
+    idx_size1 = 17;
+    checker.set_proxy({{3, 1}}).execs(
+            {{3, 17, 9, 23}, {3, 10, 9, 10}, {3, 10}, {3, 10}});
+}
+
+}  // anonymous namespace
+
+TEST_F(FALLBACK, MESH_INDEXING) {
+    run_check<MeshIndexing, IndexRNG>(handle(), dtype::Float32());
+    run_check<MeshIndexing, IndexRNG>(handle(), dtype::Int8());
+}
+
+TEST_F(FALLBACK, MESH_MODIFY_INCREMENT) {
+    run_check<IncrMeshIndexing, IndexRNG>(handle(), dtype::Float32());
+    run_check<IncrMeshIndexing, IndexRNG>(handle(), dtype::Int32());
+}
+
+TEST_F(FALLBACK, MESH_MODIFY_SETTING) {
+    using RNG = mesh_indexing::NoReplacementIndexRNG;
+    run_check<SetMeshIndexing, RNG>(handle(), dtype::Float32());
+    run_check<SetMeshIndexing, RNG>(handle(), dtype::Int16());
+}
+
+TEST_F(FALLBACK, BATCHED_MESH_INDEXING) {
+    run_batched_check<BatchedMeshIndexing, IndexRNG>(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK, BATCHED_MESH_MODIFY_INCREMENT) {
+    run_batched_check<BatchedIncrMeshIndexing, IndexRNG>(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK, BATCHED_MESH_MODIFY_SETTING) {
+    using RNG = mesh_indexing::NoReplacementIndexRNG;
+    run_batched_check<BatchedSetMeshIndexing, RNG>(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, MESH_INDEXING) {
+    run_check<MeshIndexing, IndexRNG>(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, MESH_MODIFY_INCREMENT) {
+    run_check<IncrMeshIndexing, IndexRNG>(handle(), dtype::Float32());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BATCHED_MESH_MODIFY_SETTING) {
+    using RNG = mesh_indexing::NoReplacementIndexRNG;
+    run_batched_check<BatchedSetMeshIndexing, RNG>(handle(), dtype::Float32());
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,30 @@
+/**
+ * \file dnn/test/fallback/topk.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/common/topk.h"
+#include "test/fallback/fixture.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(FALLBACK, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+
+TEST_F(FALLBACK, TOP_K_I32) {
+    run_topk_test<dtype::Int32>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+
+// vim: syntax=cpp.doxygen
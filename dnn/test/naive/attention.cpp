@@ -0,0 +1,46 @@
+/**
+ * \file dnn/test/naive/attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/naive/fixture.h"
+
+#include "megdnn/oprs/nn.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(NAIVE, ATTENTION_FORWARD) {
+    Checker<Attention> checker(handle(), /* check_dispatch */ false);
+    checker.set_epsilon(1e-5);
+
+    TensorND q = TensorValue({1, 2, 2}, dtype::Float32(), {1, 0, 0, 1});
+    TensorND k = TensorValue({1, 2, 2}, dtype::Float32(), {1, 0, 0, 1});
+    TensorND v = TensorValue({1, 2, 2}, dtype::Float32(), {1, 2, 3, 4});
+    TensorND output = TensorValue(
+            {1, 2, 2}, dtype::Float32(), {1.5378828, 2.5378828, 2.4621172, 3.4621172});
+    checker.set_param({1.f, false})
+            .exect(Testcase{q, k, v, {}, {}}, Testcase{{}, {}, {}, {}, output});
+
+    //! the first query only attends to the first key
+    output = TensorValue({1, 2, 2}, dtype::Float32(), {1., 2., 2.4621172, 3.4621172});
+    checker.set_param({1.f, true})
+            .exect(Testcase{q, k, v, {}, {}}, Testcase{{}, {}, {}, {}, output});
+    TensorND mask = TensorValue({2, 2}, dtype::Float32(), {0., -1e4, 0., 0.});
+    checker.set_param({1.f, false})
+            .exect(Testcase{q, k, v, mask, {}}, Testcase{{}, {}, {}, {}, output});
+
+    //! zero scale gives the mean of the values
+    output = TensorValue({1, 2, 2}, dtype::Float32(), {2, 3, 2, 3});
+    checker.set_param({0.f, false})
+            .exect(Testcase{q, k, v, {}, {}}, Testcase{{}, {}, {}, {}, output});
+}
+
+// vim: syntax=cpp.doxygen
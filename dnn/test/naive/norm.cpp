@@ -0,0 +1,59 @@
+/**
+ * \file dnn/test/naive/norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/naive/fixture.h"
+
+#include "megdnn/oprs/nn.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(NAIVE, LAYER_NORM_FORWARD) {
+    Checker<LayerNorm> checker(handle(), /* check_dispatch */ false);
+    checker.set_epsilon(1e-5);
+
+    TensorND input = TensorValue({2, 3}, dtype::Float32(), {0, 1, 2, 3, 3, 3});
+    TensorND output = TensorValue(
+            {2, 3}, dtype::Float32(), {-1.2247357, 0., 1.2247357, 0., 0., 0.});
+    LayerNorm::Param param{false, 1e-5f, 1};
+    checker.set_param(param).exect(
+            Testcase{input, {}, {}, {}}, Testcase{{}, {}, {}, output});
+
+    TensorND weight = TensorValue({3}, dtype::Float32(), {1., 2., 0.5});
+    TensorND bias = TensorValue({3}, dtype::Float32(), {0, 1, 2});
+    output = TensorValue(
+            {2, 3}, dtype::Float32(), {-1.2247357, 1., 2.6123678, 0., 1., 2.});
+    param.affine = true;
+    checker.set_param(param).exect(
+            Testcase{input, weight, bias, {}}, Testcase{{}, {}, {}, output});
+}
+
+TEST_F(NAIVE, GROUP_NORM_FORWARD) {
+    Checker<GroupNorm> checker(handle(), /* check_dispatch */ false);
+    checker.set_epsilon(1e-5);
+
+    TensorND input = TensorValue({1, 2, 2}, dtype::Float32(), {0, 1, 2, 3});
+    TensorND weight = TensorValue({2}, dtype::Float32(), {1, 2});
+    TensorND bias = TensorValue({2}, dtype::Float32(), {0, 1});
+    TensorND output = TensorValue(
+            {1, 2, 2}, dtype::Float32(),
+            {-1.3416354, -0.4472118, 1.8944236, 3.6832708});
+    checker.set_param({true, 1e-5f, 1})
+            .exect(Testcase{input, weight, bias, {}}, Testcase{{}, {}, {}, output});
+
+    //! each channel is a group
+    output = TensorValue({1, 2, 2}, dtype::Float32(), {-1, 1, -1, 1});
+    checker.set_param({false, 0.f, 2})
+            .exect(Testcase{input, {}, {}, {}}, Testcase{{}, {}, {}, output});
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,84 @@
+/**
+ * \file dnn/test/naive/rnn.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/naive/fixture.h"
+
+#include "megdnn/oprs/nn.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(NAIVE, LSTM_FORWARD) {
+    Checker<LSTM> checker(handle(), /* check_dispatch */ false);
+    checker.set_epsilon(1e-5);
+
+    //! two rows of one unit without bias, whose weights are all 1 except
+    //! w_hh of the forget and output gates
+    TensorND input = TensorValue({2, 2, 1}, dtype::Float32(), {1., 1., 2., -1.});
+    TensorND hx = TensorValue({1, 2, 1}, dtype::Float32(), {0., 0.});
+    TensorND cx = TensorValue({1, 2, 1}, dtype::Float32(), {0., 0.});
+    TensorND weights = TensorValue(
+            {8}, dtype::Float32(), {1., 1., 1., 1., 1., -1., 1., -1.});
+    TensorND output = TensorValue(
+            {2, 2, 1}, dtype::Float32(),
+            {0.36960635, 0.36960635, 0.7336736, -0.016406782});
+    TensorND hy = TensorValue({1, 2, 1}, dtype::Float32(), {0.7336736, -0.016406782});
+    TensorND cy = TensorValue({1, 2, 1}, dtype::Float32(), {1.3642077, -0.08112531});
+    checker.set_param({1, false, false})
+            .exect(Testcase{input, {}, hx, cx, weights, {}, {}, {}},
+                   Testcase{{}, {}, {}, {}, {}, output, hy, cy});
+
+    //! the second row ends after the first step
+    TensorND seq_len = TensorValue({2}, dtype::Int32(), {2, 1});
+    output = TensorValue(
+            {2, 2, 1}, dtype::Float32(), {0.36960635, 0.36960635, 0.7336736, 0.});
+    hy = TensorValue({1, 2, 1}, dtype::Float32(), {0.7336736, 0.36960635});
+    cy = TensorValue({1, 2, 1}, dtype::Float32(), {1.3642077, 0.55676997});
+    checker.exect(
+            Testcase{input, seq_len, hx, cx, weights, {}, {}, {}},
+            Testcase{{}, {}, {}, {}, {}, output, hy, cy});
+}
+
+TEST_F(NAIVE, GRU_FORWARD) {
+    Checker<GRU> checker(handle(), /* check_dispatch */ false);
+    checker.set_epsilon(1e-5);
+
+    TensorND input = TensorValue({2, 2, 1}, dtype::Float32(), {1., 1., 2., -1.});
+    TensorND hx = TensorValue({1, 2, 1}, dtype::Float32(), {0., 0.});
+    TensorND weights = TensorValue({6}, dtype::Float32(), {1., 1., 1., 1., -1., 2.});
+    TensorND output = TensorValue(
+            {2, 2, 1}, dtype::Float32(),
+            {0.20482421, 0.20482421, 0.31561555, -0.49339328});
+    TensorND hy = TensorValue({1, 2, 1}, dtype::Float32(), {0.31561555, -0.49339328});
+    checker.set_param({1, false, false})
+            .exect(Testcase{input, {}, hx, weights, {}, {}},
+                   Testcase{{}, {}, {}, {}, output, hy});
+
+    //! the reverse direction starts from the last valid step of each row
+    TensorND seq_len = TensorValue({2}, dtype::Int32(), {2, 1});
+    input = TensorValue({2, 2, 1}, dtype::Float32(), {2., 1., 1., 5.});
+    hx = TensorValue({2, 2, 1}, dtype::Float32(), {0., 0., 0., 0.});
+    weights = TensorValue(
+            {12}, dtype::Float32(), {1., 1., 1., 1., -1., 2., 1., 1., 1., 1., -1., 2.});
+    output = TensorValue(
+            {2, 2, 2}, dtype::Float32(),
+            {0.1149149, 0.31561555, 0.20482421, 0.20482421, 0.32242295, 0.20482421,
+             0., 0.});
+    hy = TensorValue(
+            {2, 2, 1}, dtype::Float32(),
+            {0.32242295, 0.20482421, 0.31561555, 0.20482421});
+    checker.set_param({1, true, false})
+            .exect(Testcase{input, seq_len, hx, weights, {}, {}},
+                   Testcase{{}, {}, {}, {}, output, hy});
+}
+
+// vim: syntax=cpp.doxygen
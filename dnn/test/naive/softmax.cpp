@@ -0,0 +1,36 @@
+/**
+ * \file dnn/test/naive/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/naive/fixture.h"
+
+#include "megdnn/oprs/nn.h"
+#include "test/common/checker.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(NAIVE, SOFTMAX_FORWARD) {
+    Checker<Softmax> checker(handle(), /* check_dispatch */ false);
+    checker.set_epsilon(1e-5);
+
+    TensorND input = TensorValue({2, 3}, dtype::Float32(), {0, 1, 2, 3, 3, 3});
+    TensorND output = TensorValue(
+            {2, 3}, dtype::Float32(),
+            {0.0900306, 0.2447285, 0.6652410, 0.3333333, 0.3333333, 0.3333333});
+    checker.set_param({-1}).exect(Testcase{input, {}}, Testcase{{}, output});
+
+    output = TensorValue(
+            {2, 3}, dtype::Float32(),
+            {0.0474259, 0.1192029, 0.2689414, 0.9525741, 0.8807971, 0.7310586});
+    checker.set_param({0}).exect(Testcase{input, {}}, Testcase{{}, output});
+}
+
+// vim: syntax=cpp.doxygen
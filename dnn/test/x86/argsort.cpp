@@ -0,0 +1,58 @@
+/**
+ * \file dnn/test/x86/argsort.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/argsort.h"
+#include "test/common/benchmarker.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(X86, ARGSORT_FORWARD_F32) {
+    run_argsort_forward_test(handle(), dtype::Float32{});
+}
+
+TEST_F(X86, ARGSORT_FORWARD_I32) {
+    run_argsort_forward_test(handle(), dtype::Int32{});
+}
+
+TEST_F(X86_MULTI_THREADS, ARGSORT_FORWARD_F32) {
+    run_argsort_forward_test(handle(), dtype::Float32{});
+}
+
+TEST_F(X86_MULTI_THREADS, ARGSORT_FORWARD_I32) {
+    run_argsort_forward_test(handle(), dtype::Int32{});
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_ARGSORT_FORWARD) {
+    auto run = [&](size_t M, size_t N) {
+        Benchmarker<ArgsortForward> benchmarker(handle());
+        constexpr size_t RUNS = 10;
+        UniformFloatRNG rng(-100.f, 100.f);
+        benchmarker.set_times(RUNS).set_display(false).set_rng(0, &rng);
+        benchmarker.set_dtype(2, dtype::Int32());
+        float time = benchmarker.execs({{M, N}, {}, {}}) / RUNS;
+        printf("M=%zu N=%zu: %.3fms %.3fGelem/s\n", M, N, time,
+               M * N / time / 1e6);
+    };
+    run(65536, 16);
+    run(1024, 1000);
+    run(64, 100000);
+    run(1, 1000000);
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
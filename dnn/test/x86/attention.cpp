@@ -0,0 +1,88 @@
+/**
+ * \file dnn/test/x86/attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+void run_attention_test(Handle* handle) {
+    Checker<Attention> checker(handle);
+    UniformFloatRNG rng(-2.f, 2.f);
+    for (size_t i = 0; i < 4; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_epsilon(1e-4);
+    for (bool causal : {false, true})
+        for (size_t B : {1, 3})
+            for (size_t Lq : {1, 7, 16, 70})
+                for (size_t Lk : {70, 129})
+                    for (size_t D : {1, 8, 17, 64}) {
+                        size_t Dv = D == 8 ? 35 : D;
+                        checker.set_param({1.f / std::sqrt(float(D)), causal});
+                        TensorShape q{B, Lq, D}, k{B, Lk, D}, v{B, Lk, Dv};
+                        checker.execs({q, k, v, {}, {}});
+                        checker.execs({q, k, v, {Lq, Lk}, {}});
+                        checker.execs({q, k, v, {B, Lq, Lk}, {}});
+                    }
+    //! multi-head layout and queries split into multiple tasks
+    checker.set_param({0.125f, false});
+    checker.execs({{2, 4, 200, 64}, {2, 4, 200, 64}, {2, 4, 200, 64}, {}, {}});
+    checker.set_param({0.125f, true});
+    checker.execs({{1, 300, 64}, {1, 300, 64}, {1, 300, 64}, {300, 300}, {}});
+    //! float16 goes through the naive impl
+    for (size_t i = 0; i < 5; ++i) {
+        checker.set_dtype(i, dtype::Float16());
+    }
+    checker.set_epsilon(1e-2);
+    checker.set_param({0.25f, false});
+    checker.execs({{2, 9, 16}, {2, 33, 16}, {2, 33, 16}, {9, 33}, {}});
+}
+}  // anonymous namespace
+
+TEST_F(X86, ATTENTION) {
+    run_attention_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, ATTENTION) {
+    run_attention_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_ATTENTION) {
+    auto run = [&](size_t B, size_t L, size_t D, bool causal) {
+        Benchmarker<Attention> benchmarker(handle());
+        constexpr size_t RUNS = 20;
+        benchmarker.set_times(RUNS).set_display(false);
+        benchmarker.set_param({1.f / std::sqrt(float(D)), causal});
+        TensorShape shape{B, L, D};
+        float time = benchmarker.execs({shape, shape, shape, {}, {}}) / RUNS;
+        float computations = 4.f * B * L * L * D / (causal ? 2 : 1);
+        printf("%s causal=%d: %.3fms %.3fGflops\n", shape.to_string().c_str(),
+               causal, time, computations / time / 1e6);
+    };
+    for (bool causal : {false, true}) {
+        run(12, 384, 64, causal);
+        run(16, 1024, 64, causal);
+        run(8, 2048, 128, causal);
+    }
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
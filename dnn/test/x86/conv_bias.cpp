@@ -230,6 +230,160 @@ TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_STRIDE2_QuantizedS8x8x8) {
             handle(), 2, "X86_CONV_BIAS_CHANWISE_AVX2_INT8_STRIDE2");
 }
 
+static void avx2_chanwise_direct_f32(
+        Handle* handle, uint32_t stride, bool nchw88, const char* algo) {
+    using namespace conv_bias;
+    std::vector<TestArg> args;
+    size_t pack = nchw88 ? 8 : 1;
+
+    auto shape = [&](size_t n, size_t c, size_t h, size_t w) {
+        return nchw88 ? TensorShape{n, c / 8, h, w, 8} : TensorShape{n, c, h, w};
+    };
+    auto run = [&](size_t ic, size_t w, size_t h, size_t kernel, size_t p,
+                   NonlineMode nonline_mode) {
+        if (w + 2 * p < kernel || h + 2 * p < kernel)
+            return;
+        param::ConvBias param;
+        param.stride_h = stride;
+        param.stride_w = stride;
+        param.pad_h = p;
+        param.pad_w = p;
+        param.nonlineMode = nonline_mode;
+        param.sparse = param::ConvBias::Sparse::GROUP;
+        if (nchw88) {
+            param.format = param::ConvBias::Format::NCHW88;
+        }
+        auto filter = nchw88 ? TensorShape{ic / 8, 1, 1, kernel, kernel, 8}
+                             : TensorShape{ic, 1, 1, kernel, kernel};
+        size_t oh = (h + 2 * p - kernel) / stride + 1,
+               ow = (w + 2 * p - kernel) / stride + 1;
+        //! no bias
+        args.emplace_back(param, shape(2, ic, h, w), filter, TensorShape{});
+        //! bias channel
+        args.emplace_back(param, shape(2, ic, h, w), filter, shape(1, ic, 1, 1));
+        //! bias
+        args.emplace_back(param, shape(2, ic, h, w), filter, shape(2, ic, oh, ow));
+    };
+
+    for (size_t kernel : {3, 5, 7})
+        for (size_t pad : {0, 1, 3})
+            for (size_t ic : {8, 24})
+                for (size_t h : {7, 16, 33})
+                    for (size_t w : {7, 16, 41, 80})
+                        for (NonlineMode nonline_mode :
+                             {NonlineMode::IDENTITY, NonlineMode::RELU,
+                              NonlineMode::SIGMOID, NonlineMode::H_SWISH})
+                            run(ic * pack / 8, w, h, kernel, pad, nonline_mode);
+
+    Checker<ConvBias> checker(handle);
+    UniformFloatRNG rng{-2.f, 2.f};
+    checker.set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Float32())
+            .set_rng(0, &rng)
+            .set_rng(1, &rng)
+            .set_rng(2, &rng)
+            .set_epsilon(1e-3);
+    checker.set_before_exec_callback(
+            conv_bias::ConvBiasAlgoChecker<ConvBiasForward>(algo));
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).exec({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_STRIDE1_FP32) {
+    avx2_chanwise_direct_f32(handle(), 1, false, "X86_CONV_BIAS_CHANWISE_AVX2_F32");
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_STRIDE2_FP32) {
+    avx2_chanwise_direct_f32(handle(), 2, false, "X86_CONV_BIAS_CHANWISE_AVX2_F32");
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_STRIDE1_FP32_NCHW88) {
+    avx2_chanwise_direct_f32(
+            handle(), 1, true, "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW88");
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_STRIDE2_FP32_NCHW88) {
+    avx2_chanwise_direct_f32(
+            handle(), 2, true, "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW88");
+}
+
+static void avx2_direct_nchw88_f32(Handle* handle, bool hybrid, const char* algo) {
+    using namespace conv_bias;
+    std::vector<TestArg> args;
+
+    auto run = [&](size_t oc, size_t ic, size_t h, size_t w, size_t kernel,
+                   size_t stride, size_t group, NonlineMode nonline_mode) {
+        size_t p = kernel / 2;
+        param::ConvBias param;
+        param.format = param::ConvBias::Format::NCHW88;
+        param.stride_h = stride;
+        param.stride_w = stride;
+        param.pad_h = p;
+        param.pad_w = p;
+        param.nonlineMode = nonline_mode;
+        size_t oh = (h + 2 * p - kernel) / stride + 1,
+               ow = (w + 2 * p - kernel) / stride + 1;
+        TensorShape src{2, ic / 8, h, w, 8},
+                filter{oc / 8, ic / 8, kernel, kernel, 8, 8};
+        if (hybrid) {
+            src = {2, ic, h, w};
+            filter = {oc / 8, kernel, kernel, ic, 8};
+        } else if (group > 1) {
+            param.sparse = param::ConvBias::Sparse::GROUP;
+            filter = {group, oc / group / 8, ic / group / 8, kernel, kernel, 8, 8};
+        }
+        //! no bias
+        args.emplace_back(param, src, filter, TensorShape{});
+        //! bias channel
+        args.emplace_back(param, src, filter, TensorShape{1, oc / 8, 1, 1, 8});
+        //! bias, which is not supported by the hybrid layer
+        if (!hybrid) {
+            args.emplace_back(param, src, filter, TensorShape{2, oc / 8, oh, ow, 8});
+        }
+    };
+
+    for (size_t kernel : {1, 2, 3, 5, 7})
+        for (size_t stride : {1, 2})
+            for (size_t oc : {8, 24})
+                for (size_t hw : {5, 14, 23})
+                    for (NonlineMode nonline_mode :
+                         {NonlineMode::IDENTITY, NonlineMode::RELU,
+                          NonlineMode::SIGMOID, NonlineMode::H_SWISH}) {
+                        if (hybrid) {
+                            run(oc, 3, hw, hw + 2, kernel, stride, 1, nonline_mode);
+                        } else {
+                            run(oc, 16, hw, hw + 2, kernel, stride, 1, nonline_mode);
+                            run(oc * 2, 16, hw, hw + 2, kernel, stride, 2,
+                                nonline_mode);
+                        }
+                    }
+
+    Checker<ConvBias> checker(handle);
+    UniformFloatRNG rng{-2.f, 2.f};
+    checker.set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Float32())
+            .set_rng(0, &rng)
+            .set_rng(1, &rng)
+            .set_rng(2, &rng)
+            .set_epsilon(1e-3);
+    checker.set_before_exec_callback(
+            conv_bias::ConvBiasAlgoChecker<ConvBiasForward>(algo));
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).exec({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_DIRECT_FP32_NCHW88) {
+    avx2_direct_nchw88_f32(handle(), false, "X86_CONV_BIAS_DIRECT_AVX2_F32_NCHW88");
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_DIRECT_FP32_NCHW_NCHW88) {
+    avx2_direct_nchw88_f32(handle(), true, "X86_CONV_BIAS_DIRECT_AVX2_F32_NCHW_NCHW88");
+}
+
 TEST_F(X86_MULTI_THREADS, AVX2_CONV_BIAS_DIRECT_STRIDE1_INT8x8x32) {
     using namespace conv_bias;
     std::vector<TestArg> args;
@@ -572,6 +726,121 @@ TEST_F(X86_MULTI_THREADS, AVX2_CONV_BIAS_DIRECT_STRIDE2_S8S8S8) {
     }
 }
 
+#if MEGDNN_X86_WITH_VNNI
+static void vnni_direct_int8(Handle* handle, uint32_t stride, bool quantized) {
+    using namespace conv_bias;
+    std::vector<TestArg> args;
+
+    auto run = [&](size_t oc, size_t ic, size_t w, size_t h, size_t kernel, size_t p,
+                   NonlineMode nonline_mode) {
+        if (w + 2 * p < kernel || h + 2 * p < kernel)
+            return;
+        param::ConvBias param;
+        param.stride_h = stride;
+        param.stride_w = stride;
+        param.pad_h = p;
+        param.pad_w = p;
+        param.nonlineMode = nonline_mode;
+
+        param.sparse = param::ConvBias::Sparse::DENSE;
+        //! no bias
+        args.emplace_back(
+                param, TensorShape{2, ic, h, w}, TensorShape{oc, ic, kernel, kernel},
+                TensorShape{});
+        param.sparse = param::ConvBias::Sparse::GROUP;
+        args.emplace_back(
+                param, TensorShape{2, 2 * ic, h, w},
+                TensorShape{2, oc / 2, ic, kernel, kernel}, TensorShape{});
+        //! bias channel
+        args.emplace_back(
+                param, TensorShape{2, 2 * ic, h, w},
+                TensorShape{2, oc / 2, ic, kernel, kernel}, TensorShape{1, oc, 1, 1});
+    };
+
+    for (size_t kernel : {1, 2, 3, 4, 5, 7})
+        for (size_t pad : {0, 1, 3})
+            for (size_t oc : {2, 6, 8, 18})
+                for (size_t ic : {1, 3, 4, 9})
+                    for (size_t h : {1, 10, 17})
+                        for (size_t w : {3, 16, 37, 70})
+                            for (NonlineMode nonline_mode : {NonlineMode::IDENTITY})
+                                run(oc, ic, w, h, kernel, pad, nonline_mode);
+    if (quantized) {
+        for (NonlineMode nonline_mode : {NonlineMode::RELU, NonlineMode::H_SWISH})
+            run(8, 5, 35, 9, 3, 1, nonline_mode);
+    }
+
+    Checker<ConvBias> checker(handle);
+    UniformIntRNG rng{-128, 127};
+    if (quantized) {
+        checker.set_dtype(0, dtype::QuantizedS8(2.5f))
+                .set_dtype(1, dtype::QuantizedS8(2.5f))
+                .set_dtype(2, dtype::QuantizedS32(6.25f))
+                .set_dtype(4, dtype::QuantizedS8(600.25f))
+                .set_epsilon(1e-3);
+    } else {
+        checker.set_dtype(0, dtype::Int8())
+                .set_dtype(1, dtype::Int8())
+                .set_dtype(2, dtype::Int32())
+                .set_dtype(4, dtype::Int32());
+    }
+    checker.set_rng(0, &rng).set_rng(1, &rng).set_rng(2, &rng);
+    checker.set_before_exec_callback(conv_bias::ConvBiasAlgoChecker<ConvBiasForward>(
+            "X86_CONV_BIAS_DIRECT_VNNI_INT8"));
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).exec({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, VNNI_CONV_BIAS_DIRECT_STRIDE1_INT8x8x32) {
+    if (!megdnn::x86::is_supported(x86::SIMDType::VNNI))
+        return;
+    vnni_direct_int8(handle(), 1, false);
+}
+
+TEST_F(X86_MULTI_THREADS, VNNI_CONV_BIAS_DIRECT_STRIDE2_INT8x8x32) {
+    if (!megdnn::x86::is_supported(x86::SIMDType::VNNI))
+        return;
+    vnni_direct_int8(handle(), 2, false);
+}
+
+TEST_F(X86_MULTI_THREADS, VNNI_CONV_BIAS_DIRECT_STRIDE1_S8S8S8) {
+    if (!megdnn::x86::is_supported(x86::SIMDType::VNNI))
+        return;
+    vnni_direct_int8(handle(), 1, true);
+}
+
+TEST_F(X86_MULTI_THREADS, VNNI_CONV_BIAS_DIRECT_STRIDE2_S8S8S8) {
+    if (!megdnn::x86::is_supported(x86::SIMDType::VNNI))
+        return;
+    vnni_direct_int8(handle(), 2, true);
+}
+
+TEST_F(X86_MULTI_THREADS, VNNI_CHANWISE_DIRECT_INT8x8x32) {
+    if (!megdnn::x86::is_supported(x86::SIMDType::VNNI))
+        return;
+    for (uint32_t stride : {1, 2})
+        avx2_chanwise_direct_int8x8x32(
+                handle(), stride, "X86_CONV_BIAS_CHANWISE_VNNI_INT8");
+}
+
+TEST_F(X86_MULTI_THREADS, VNNI_CHANWISE_DIRECT_QuantizedS32) {
+    if (!megdnn::x86::is_supported(x86::SIMDType::VNNI))
+        return;
+    for (uint32_t stride : {1, 2})
+        avx2_chanwise_direct_quantizeds32(
+                handle(), stride, "X86_CONV_BIAS_CHANWISE_VNNI_INT8");
+}
+
+TEST_F(X86_MULTI_THREADS, VNNI_CHANWISE_DIRECT_QuantizedS8x8x8) {
+    if (!megdnn::x86::is_supported(x86::SIMDType::VNNI))
+        return;
+    for (uint32_t stride : {1, 2})
+        avx2_chanwise_direct_quantizeds8x8x8(
+                handle(), stride, "X86_CONV_BIAS_CHANWISE_VNNI_INT8");
+}
+#endif
+
 TEST_F(X86_MULTI_THREADS, CONV_BIAS_DIRECT_STRIDE1_DENSE) {
     using namespace conv_bias;
     std::vector<TestArg> args;
@@ -1362,6 +1631,54 @@ TEST_F(X86_MULTI_THREADS, CONV_BIAS_CONV1X1_S1_FP32_BLAS_NOPACK_REPROCESS) {
 }
 #endif
 
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_CONV1X1_S1_FP32_PACKED) {
+    using namespace conv_bias;
+    std::vector<conv_bias::TestArg> args = get_conv_bias_1x1_args(false, false);
+    if (x86::is_supported(x86::SIMDType::AVX512)) {
+        check_conv_bias(args, handle(), "CONV1x1:X86_F32_AVX512_14X32:28");
+    }
+    if (x86::is_supported(x86::SIMDType::FMA)) {
+        check_conv_bias(args, handle(), "CONV1x1:X86_F32_AVX2_6X16:24");
+    }
+}
+
+#if !MEGDNN_DISABLE_FLOAT16
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COL_CONV1X1_BF16) {
+    using namespace conv_bias;
+    std::vector<TestArg> args = get_conv_bias_args({2, 3, 5}, 1, false, false, false);
+    std::vector<TestArg> args_1x1 = get_conv_bias_1x1_args(false, false);
+    NormalRNG rng(1.f);
+    Checker<ConvBias> checker(handle());
+    checker.set_dtype(0, dtype::BFloat16())
+            .set_dtype(1, dtype::BFloat16())
+            .set_dtype(2, dtype::BFloat16())
+            .set_dtype(4, dtype::BFloat16())
+            .set_rng(0, &rng)
+            .set_rng(1, &rng)
+            .set_rng(2, &rng)
+            .set_epsilon(3e-2);
+    auto run = [&](const std::vector<TestArg>& args, const char* algo_name) {
+        checker.set_before_exec_callback(ConvBiasAlgoChecker<ConvBias>(algo_name));
+        for (auto&& arg : args) {
+            //! the reference of bfloat16 is only defined with float32 compute
+            auto param = arg.param;
+            param.compute_mode = param::ConvBias::ComputeMode::FLOAT32;
+            checker.set_param(param).execs({arg.src, arg.filter, arg.bias, {}, {}});
+        }
+    };
+    if (x86::is_supported(x86::SIMDType::FMA)) {
+        run(args, "IM2COLMATMUL:X86_BF16_AVX2_6X16");
+        run(args_1x1, "CONV1x1:X86_BF16_AVX2_6X16:24");
+    }
+#if MEGDNN_X86_WITH_AVX512_BF16
+    if (x86::is_supported(x86::SIMDType::BF16)) {
+        run(args, "IM2COLMATMUL:X86_BF16_AVX512_BF16_8X32");
+        run(args_1x1, "CONV1x1:X86_BF16_AVX512_BF16_8X32:24");
+    }
+#endif
+}
+#endif
+
 TEST_F(X86_MULTI_THREADS, CONV_BIAS_CONV1X1_S1_INT8X8X32) {
     using namespace conv_bias;
     UniformIntRNG rng{-50, 50};
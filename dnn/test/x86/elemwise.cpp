@@ -219,6 +219,42 @@ TEST_F(X86, ELEMWISE_FORWARD_TERNARY) {
     BUILD_TERNARY_COMPLATE_TEST_CASE
 }
 
+TEST_F(X86_MULTI_THREADS, ELEMWISE_FORWARD_LARGE) {
+    using Mode = ElemwiseForward::Param::Mode;
+    Checker<ElemwiseForward> checker(handle());
+    UniformFloatRNG rng(1e-5, 7e1);
+    checker.set_rng(0, &rng);
+    checker.set_epsilon(1e-5);
+
+    // sizes are not multiples of the thread number or simd width
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Int16()}) {
+        checker.set_dtype(0, dtype).set_dtype(1, dtype).set_dtype(2, dtype);
+        checker.set_param(Mode::RELU).execs({{3, 50021}, {}});
+        checker.set_param(Mode::ADD).execs({{3, 50021}, {3, 50021}, {}});
+        checker.set_param(Mode::SUB).execs({{3, 50021}, {1, 1}, {}});
+        checker.set_param(Mode::SUB).execs({{1, 1}, {3, 50021}, {}});
+        checker.set_param(Mode::ADD).execs({{2, 37, 41, 43}, {1, 37, 1, 1}, {}});
+        checker.set_param(Mode::SUB).execs({{1, 37, 1, 1}, {2, 37, 41, 43}, {}});
+        checker.set_param(Mode::MAX).execs({{1, 64, 57, 31}, {1, 64, 1, 1}, {}});
+    }
+
+    checker.set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Float32());
+    checker.set_param(Mode::EXP).execs({{3, 50021}, {}});
+    checker.set_param(Mode::ADD).execs({{2, 9, 33, 29, 8}, {1, 9, 1, 1, 8}, {}});
+    checker.set_param(Mode::FUSE_ADD_RELU)
+            .execs({{1, 9, 1, 1, 8}, {1, 9, 33, 29, 8}, {}});
+
+    checker.set_param(Mode::FUSE_MUL_ADD3);
+    checker.execs({{3, 50021}, {3, 50021}, {3, 50021}, {}});
+    checker.execs({{3, 50021}, {3, 50021}, {1, 1}, {}});
+    checker.execs({{3, 50021}, {1, 1}, {3, 50021}, {}});
+    checker.execs({{3, 50021}, {1, 1}, {1, 1}, {}});
+    checker.execs({{1, 37, 1, 1}, {2, 37, 41, 43}, {1, 37, 1, 1}, {}});
+    checker.execs({{2, 37, 41, 43}, {1, 37, 1, 1}, {2, 37, 41, 43}, {}});
+}
+
 template <typename tag>
 class X86_ELEMWISE : public X86 {};
 TYPED_TEST_CASE(X86_ELEMWISE, elemwise::test_types);
@@ -83,6 +83,44 @@ TEST_F(X86, MATRIX_MUL_AVX2_MK8_8X8) {
             "X86_F32MK8_8X8", param::MatrixMul::Format::MK8, 1, 1e-3, false);
 }
 
+TEST_F(X86, MATRIX_MUL_F32_AVX2_6X16) {
+    if (is_supported(SIMDType::FMA)) {
+        matrix_mul::check_matrix_mul(
+                dtype::Float32{}, dtype::Float32{}, dtype::Float32{}, handle(),
+                "X86_F32_AVX2_6X16", param::MatrixMul::Format::DEFAULT, 1);
+    }
+}
+
+TEST_F(X86, MATRIX_MUL_F32_AVX512_14X32) {
+    if (is_supported(SIMDType::AVX512)) {
+        matrix_mul::check_matrix_mul(
+                dtype::Float32{}, dtype::Float32{}, dtype::Float32{}, handle(),
+                "X86_F32_AVX512_14X32", param::MatrixMul::Format::DEFAULT, 1);
+    }
+}
+
+#if !MEGDNN_DISABLE_FLOAT16
+TEST_F(X86, MATRIX_MUL_BF16_AVX2_6X16) {
+    if (is_supported(SIMDType::FMA)) {
+        matrix_mul::check_matrix_mul(
+                dtype::BFloat16{}, dtype::BFloat16{}, dtype::BFloat16{}, handle(),
+                "X86_BF16_AVX2_6X16", param::MatrixMul::Format::DEFAULT, 1, 1e-2, {},
+                true, param::MatrixMul::ComputeMode::FLOAT32);
+    }
+}
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+TEST_F(X86, MATRIX_MUL_BF16_AVX512_BF16_8X32) {
+    if (is_supported(SIMDType::BF16)) {
+        matrix_mul::check_matrix_mul(
+                dtype::BFloat16{}, dtype::BFloat16{}, dtype::BFloat16{}, handle(),
+                "X86_BF16_AVX512_BF16_8X32", param::MatrixMul::Format::DEFAULT, 1,
+                1e-2, {}, true, param::MatrixMul::ComputeMode::FLOAT32);
+    }
+}
+#endif
+#endif
+
 #if MEGDNN_WITH_BENCHMARK
 
 TEST_F(X86, BENCHMARK_MATRIX_MUL_AVX2_MK8_8X8) {
@@ -93,6 +131,22 @@ TEST_F(X86, BENCHMARK_MATRIX_MUL_AVX2_MK8_8X8) {
             dtype::Float32{}, dtype::Float32{}, "X86_F32_BLAS");
 }
 
+TEST_F(X86, BENCHMARK_MATRIX_MUL_F32_AVX2_6X16) {
+    auto args = matrix_mul::get_benchmark_matmul_args();
+    matrix_mul::benchmark_with_contrast(
+            handle(), args, dtype::Float32{}, dtype::Float32{}, dtype::Float32{},
+            "X86_F32_AVX2_6X16", param::MatrixMul::Format::DEFAULT, dtype::Float32{},
+            dtype::Float32{}, dtype::Float32{}, "FB_F32_K8X12X1");
+}
+
+TEST_F(X86, BENCHMARK_MATRIX_MUL_F32_AVX512_14X32) {
+    auto args = matrix_mul::get_benchmark_matmul_args();
+    matrix_mul::benchmark_with_contrast(
+            handle(), args, dtype::Float32{}, dtype::Float32{}, dtype::Float32{},
+            "X86_F32_AVX512_14X32", param::MatrixMul::Format::DEFAULT,
+            dtype::Float32{}, dtype::Float32{}, dtype::Float32{}, "X86_F32_AVX2_6X16");
+}
+
 TEST_F(X86, BENCHMARK_MATRIX_MUL_8X8X32) {
     constexpr size_t RUNS = 50;
     auto rng = std::make_unique<UniformIntRNG>(-127, 127);
@@ -0,0 +1,98 @@
+/**
+ * \file dnn/test/x86/norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+void run_layer_norm_test(Handle* handle) {
+    Checker<LayerNorm> checker(handle);
+    UniformFloatRNG rng(-5.f, 5.f);
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    for (bool affine : {false, true})
+        for (size_t nr_row : {1, 3, 64})
+            for (size_t row_size : {1, 7, 32, 33, 127, 768, 5000}) {
+                LayerNorm::Param param{affine, 1e-5f, 1};
+                TensorShape w = affine ? TensorShape{row_size} : TensorShape{};
+                checker.set_param(param).execs({{nr_row, row_size}, w, w, {}});
+            }
+    //! normalize over the last two dims
+    checker.set_param({true, 1e-5f, 2}).execs({{4, 6, 65}, {6, 65}, {6, 65}, {}});
+    checker.set_dtype(0, dtype::Float16())
+            .set_dtype(1, dtype::Float16())
+            .set_dtype(2, dtype::Float16())
+            .set_dtype(3, dtype::Float16())
+            .set_epsilon(1e-2);
+    checker.set_param({true, 1e-5f, 1}).execs({{5, 100}, {100}, {100}, {}});
+}
+
+void run_group_norm_test(Handle* handle) {
+    Checker<GroupNorm> checker(handle);
+    UniformFloatRNG rng(-5.f, 5.f);
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    for (bool affine : {false, true})
+        for (size_t N : {1, 3})
+            for (uint32_t group : {1, 4, 8})
+                for (size_t HW : {1, 7, 64, 3136}) {
+                    size_t C = 16;
+                    GroupNorm::Param param{affine, 1e-5f, group};
+                    TensorShape w = affine ? TensorShape{C} : TensorShape{};
+                    checker.set_param(param).execs({{N, C, HW}, w, w, {}});
+                }
+    checker.set_param({true, 1e-5f, 2}).execs({{2, 6, 5, 7}, {6}, {6}, {}});
+}
+}  // anonymous namespace
+
+TEST_F(X86, LAYER_NORM) {
+    run_layer_norm_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, LAYER_NORM) {
+    run_layer_norm_test(handle());
+}
+
+TEST_F(X86, GROUP_NORM) {
+    run_group_norm_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, GROUP_NORM) {
+    run_group_norm_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_LAYER_NORM) {
+    auto run = [&](size_t nr_row, size_t row_size) {
+        Benchmarker<LayerNorm> benchmarker(handle());
+        constexpr size_t RUNS = 50;
+        benchmarker.set_times(RUNS).set_display(false);
+        benchmarker.set_param({true, 1e-5f, 1});
+        float time =
+                benchmarker.execs({{nr_row, row_size}, {row_size}, {row_size}, {}}) /
+                RUNS;
+        float bandwidth = nr_row * row_size * sizeof(float) * 2 / time / 1e6;
+        printf("(%zu, %zu): %.3fms %.3fGB/s\n", nr_row, row_size, time, bandwidth);
+    };
+    run(128, 768);
+    run(384, 1024);
+    run(4096, 4096);
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,79 @@
+/**
+ * \file dnn/test/x86/reduce.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+void run_reduce_test(Handle* handle) {
+    using Param = Reduce::Param;
+    using Mode = Param::Mode;
+    Checker<Reduce> checker(handle);
+    UniformFloatRNG rng(0.5f, 1.5f);
+    checker.set_rng(0, &rng).set_epsilon(1e-3);
+    for (auto mode :
+         {Mode::SUM, Mode::MEAN, Mode::SUM_SQR, Mode::PRODUCT, Mode::MAX, Mode::MIN})
+        for (int32_t axis : {0, 1, 2})
+            for (size_t A : {1, 3})
+                for (size_t B : {1, 7, 33, 130})
+                    for (size_t C : {1, 5, 16, 77}) {
+                        //! avoid overflow of product
+                        if (mode == Mode::PRODUCT && std::max({A, B, C}) > 33)
+                            continue;
+                        checker.set_param(Param(mode, axis)).execs({{A, B, C}, {}});
+                    }
+    //! large tensors to be split into multiple tasks
+    for (auto mode : {Mode::SUM, Mode::MEAN, Mode::MAX, Mode::MIN}) {
+        checker.set_param(Param(mode, 1)).execs({{64, 5000, 1}, {}});
+        checker.set_param(Param(mode, 1)).execs({{8, 1000, 130}, {}});
+        checker.set_param(Param(mode, 0)).execs({{1000, 300}, {}});
+    }
+}
+}  // anonymous namespace
+
+TEST_F(X86, REDUCE) {
+    run_reduce_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, REDUCE) {
+    run_reduce_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_REDUCE) {
+    using Mode = Reduce::Param::Mode;
+    auto run = [&](const TensorShape& shape, int32_t axis) {
+        Benchmarker<Reduce> benchmarker(handle());
+        constexpr size_t RUNS = 50;
+        benchmarker.set_times(RUNS).set_display(false);
+        benchmarker.set_param({Mode::SUM, axis});
+        float time = benchmarker.execs({shape, {}}) / RUNS;
+        float bandwidth = shape.total_nr_elems() * sizeof(float) / time / 1e6;
+        printf("%s axis=%d: %.3fms %.3fGB/s\n", shape.to_string().c_str(), axis,
+               time, bandwidth);
+    };
+    run({64, 65536}, 1);
+    run({64, 1024, 64}, 1);
+    run({1024, 64, 3}, 1);
+    run({4096, 4096}, 0);
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,96 @@
+/**
+ * \file dnn/test/x86/rnn.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+#include "test/common/rnn.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+void run_lstm_test(Handle* handle) {
+    Checker<LSTM> checker(handle);
+    UniformFloatRNG rng(-1.f, 1.f);
+    for (size_t i : {0, 2, 3, 4}) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_dtype(1, dtype::Int32()).set_epsilon(1e-4);
+    for (auto&& arg : rnn::get_args(LSTM::NR_GATE)) {
+        UniformIntRNG len_rng(0, arg.input[0]);
+        checker.set_rng(1, &len_rng).set_param(arg.param);
+        checker.execs(
+                {arg.input, arg.seq_len, arg.hx, arg.cx, arg.weights, {}, {}, {}});
+    }
+}
+
+void run_gru_test(Handle* handle) {
+    Checker<GRU> checker(handle);
+    UniformFloatRNG rng(-1.f, 1.f);
+    for (size_t i : {0, 2, 3}) {
+        checker.set_rng(i, &rng);
+    }
+    checker.set_dtype(1, dtype::Int32()).set_epsilon(1e-4);
+    for (auto&& arg : rnn::get_args(GRU::NR_GATE)) {
+        UniformIntRNG len_rng(0, arg.input[0]);
+        checker.set_rng(1, &len_rng).set_param(arg.param);
+        checker.execs({arg.input, arg.seq_len, arg.hx, arg.weights, {}, {}});
+    }
+}
+}  // anonymous namespace
+
+TEST_F(X86, LSTM) {
+    run_lstm_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, LSTM) {
+    run_lstm_test(handle());
+}
+
+TEST_F(X86, GRU) {
+    run_gru_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, GRU) {
+    run_gru_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_LSTM) {
+    auto run = [&](size_t T, size_t N, size_t I, size_t H, size_t L) {
+        Benchmarker<LSTM> benchmarker(handle());
+        constexpr size_t RUNS = 10;
+        benchmarker.set_times(RUNS).set_display(false);
+        param::RNN param{static_cast<uint32_t>(L), false, true};
+        size_t nr_weight;
+        RNNBase::get_weight_offsets(param, LSTM::NR_GATE, I, H, nr_weight);
+        benchmarker.set_param(param);
+        TensorShape state{L, N, H};
+        float time = benchmarker.execs(
+                             {{T, N, I}, {}, state, state, {nr_weight}, {}, {}, {}}) /
+                     RUNS;
+        float computations = 2.f * T * N * 4 * H * (I + H + (L - 1) * 2 * H);
+        printf("T=%zu N=%zu I=%zu H=%zu L=%zu: %.3fms %.3fGflops\n", T, N, I, H, L,
+               time, computations / time / 1e6);
+    };
+    run(100, 1, 256, 256, 1);
+    run(100, 16, 256, 256, 2);
+    run(50, 64, 512, 512, 1);
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,76 @@
+/**
+ * \file dnn/test/x86/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+void run_softmax_test(Handle* handle) {
+    Checker<Softmax> checker(handle);
+    UniformFloatRNG rng(-20.f, 20.f);
+    checker.set_rng(0, &rng).set_epsilon(1e-4);
+    for (int32_t axis : {0, 1, 2, -1})
+        for (size_t A : {1, 3})
+            for (size_t B : {1, 7, 33, 130})
+                for (size_t C : {1, 5, 16, 77}) {
+                    checker.set_param(axis).execs({{A, B, C}, {}});
+                }
+    //! large tensors to be split into multiple tasks, and rows long enough
+    //! for the online max and sum
+    checker.set_param(-1).execs({{64, 1000}, {}});
+    checker.set_param(-1).execs({{3, 40000}, {}});
+    checker.set_param(1).execs({{8, 1000, 130}, {}});
+    checker.set_param(0).execs({{1000, 300}, {}});
+    //! float16 goes through the naive impl
+    checker.set_dtype(0, dtype::Float16())
+            .set_dtype(1, dtype::Float16())
+            .set_epsilon(1e-2);
+    checker.set_param(-1).execs({{5, 100}, {}});
+}
+}  // anonymous namespace
+
+TEST_F(X86, SOFTMAX) {
+    run_softmax_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, SOFTMAX) {
+    run_softmax_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_SOFTMAX) {
+    auto run = [&](const TensorShape& shape, int32_t axis) {
+        Benchmarker<Softmax> benchmarker(handle());
+        constexpr size_t RUNS = 50;
+        benchmarker.set_times(RUNS).set_display(false);
+        benchmarker.set_param(axis);
+        float time = benchmarker.execs({shape, {}}) / RUNS;
+        float bandwidth = shape.total_nr_elems() * sizeof(float) * 2 / time / 1e6;
+        printf("%s axis=%d: %.3fms %.3fGB/s\n", shape.to_string().c_str(), axis,
+               time, bandwidth);
+    };
+    run({64, 1000}, 1);
+    run({12, 384, 384}, 2);
+    run({4, 65536}, 1);
+    run({64, 1000, 16}, 1);
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
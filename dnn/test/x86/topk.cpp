@@ -0,0 +1,65 @@
+/**
+ * \file dnn/test/x86/topk.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/rng.h"
+#include "test/common/topk.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(X86, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+
+TEST_F(X86, TOP_K_I32) {
+    run_topk_test<dtype::Int32>(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, TOP_K_I32) {
+    run_topk_test<dtype::Int32>(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_TOP_K) {
+    using Mode = TopK::Param::Mode;
+    auto run = [&](int k, size_t M, size_t N, Mode mode) {
+        Benchmarker<TopK> benchmarker(handle());
+        constexpr size_t RUNS = 10;
+        UniformFloatRNG rng(-100.f, 100.f);
+        std::unique_ptr<OprProxy<TopK>> proxy{new OprProxy<TopK>{k}};
+        benchmarker.set_times(RUNS).set_display(false).set_rng(0, &rng);
+        benchmarker.set_proxy(proxy).set_param(mode);
+        float time = mode == Mode::KTH_ONLY
+                           ? benchmarker.execs({{M, N}, {}})
+                           : benchmarker.execs({{M, N}, {}, {}});
+        printf("k=%d M=%zu N=%zu mode=%d: %.3fms\n", k, M, N,
+               static_cast<int>(mode), time / RUNS);
+    };
+    for (auto mode : {Mode::KTH_ONLY, Mode::VALUE_IDX_NOSORT, Mode::VALUE_IDX_SORTED}) {
+        run(-5, 1024, 1000, mode);
+        run(-100, 64, 100000, mode);
+        run(-1000, 1, 1000000, mode);
+        run(20000, 16, 50000, mode);
+    }
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -233,6 +233,10 @@ def optimize_for_inference(dest_vars, **kwargs):
         * enable_ioc16 --
           whether to use float16 for both I/O and computation
           precision.
+        * enable_iobf16xc32 --
+          whether to use bfloat16 for I/O between oprs and use
+          float32 as internal computation precision. Note the output var would be
+          changed to bfloat16.
         * enable_hwcd4 --
           whether to use NHWCD4 data layout. This is faster on some
           OpenCL backend.
@@ -263,6 +267,12 @@ def optimize_for_inference(dest_vars, **kwargs):
           input for inference on nvidia backend(this optimization pass will
           result in mismatch of the precision of output of training and
           inference)
+        * enable_fuse_softmax: whether to fuse the decomposed softmax into
+          one opr.
+        * enable_fuse_layer_norm: whether to fuse the decomposed layer norm
+          into one opr.
+        * enable_fuse_attention: whether to fuse the scaled dot-product
+          attention, i.e. softmax(q @ k^T * scale + mask) @ v, into one opr.
     """
     inference_options = GraphOptimizeOptions()
     inference_optimize_layout_transform_map = {
@@ -284,12 +294,20 @@ def optimize_for_inference(dest_vars, **kwargs):
         inference_options.f16_io_f32_comp = True
     if kwargs.pop("enable_ioc16", False):
         inference_options.f16_io_comp = True
+    if kwargs.pop("enable_iobf16xc32", False):
+        inference_options.bf16_io_f32_comp = True
     if kwargs.pop("enable_fuse_conv_bias_nonlinearity", False):
         inference_options.fuse_conv_bias_nonlinearity = True
     if kwargs.pop("enable_fuse_conv_bias_with_z", False):
         inference_options.fuse_conv_bias_with_z = True
     if kwargs.pop("enable_fuse_preprocess", False):
         inference_options.fuse_preprocess = True
+    if kwargs.pop("enable_fuse_softmax", False):
+        inference_options.fuse_softmax = True
+    if kwargs.pop("enable_fuse_layer_norm", False):
+        inference_options.fuse_layer_norm = True
+    if kwargs.pop("enable_fuse_attention", False):
+        inference_options.fuse_attention = True
 
     if kwargs:
         raise ValueError("unknown options: %s" % list(kwargs))
@@ -332,12 +350,20 @@ def deserialize_infer_option(x: int) -> Dict[str, bool]:
         ret["enable_io16xc32"] = True
     if inference_options.f16_io_comp:
         ret["enable_ioc16"] = True
+    if inference_options.bf16_io_f32_comp:
+        ret["enable_iobf16xc32"] = True
     if inference_options.fuse_conv_bias_nonlinearity:
         ret["enable_fuse_conv_bias_nonlinearity"] = True
     if inference_options.fuse_conv_bias_with_z:
         ret["enable_fuse_conv_bias_with_z"] = True
     if inference_options.fuse_preprocess:
         ret["enable_fuse_preprocess"] = True
+    if inference_options.fuse_softmax:
+        ret["enable_fuse_softmax"] = True
+    if inference_options.fuse_layer_norm:
+        ret["enable_fuse_layer_norm"] = True
+    if inference_options.fuse_attention:
+        ret["enable_fuse_attention"] = True
 
     return ret
 
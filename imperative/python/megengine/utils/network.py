@@ -159,6 +159,12 @@ class Network:
           input for inference on nvidia backend(this optimization pass will
           result in mismatch of the precision of output of training and
           inference)
+        * enable_fuse_softmax: whether to fuse the decomposed softmax into
+          one opr.
+        * enable_fuse_layer_norm: whether to fuse the decomposed layer norm
+          into one opr.
+        * enable_fuse_attention: whether to fuse the scaled dot-product
+          attention, i.e. softmax(q @ k^T * scale + mask) @ v, into one opr.
         """
 
         if not isinstance(dest_vars, Sequence):
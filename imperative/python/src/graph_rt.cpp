@@ -285,6 +285,17 @@ void init_graph_rt(py::module m) {
                             &_OptimizeForInferenceOptions::f16_io_f32_comp)
                     .def_readwrite(
                             "f16_io_comp", &_OptimizeForInferenceOptions::f16_io_comp)
+                    .def_readwrite(
+                            "bf16_io_f32_comp",
+                            &_OptimizeForInferenceOptions::bf16_io_f32_comp)
+                    .def_readwrite(
+                            "fuse_softmax", &_OptimizeForInferenceOptions::fuse_softmax)
+                    .def_readwrite(
+                            "fuse_layer_norm",
+                            &_OptimizeForInferenceOptions::fuse_layer_norm)
+                    .def_readwrite(
+                            "fuse_attention",
+                            &_OptimizeForInferenceOptions::fuse_attention)
                     .def_readwrite(
                             "fuse_conv_bias_nonlinearity",
                             &_OptimizeForInferenceOptions::fuse_conv_bias_nonlinearity)
@@ -485,7 +496,10 @@ void init_graph_rt(py::module m) {
 
     py::class_<cg::ComputingGraph::Options::SeqOpt>(PyComputingGraphOptions, "SeqOpt")
             DEF_READWRITE(enable_mem_plan_opt) DEF_READWRITE(enable_mem_reuse_alloc)
-                    DEF_READWRITE(enable_seq_comp_node_opt);
+                    DEF_READWRITE(mem_reuse_alloc_search_time)
+                            DEF_READWRITE(static_mem_plan_cache_size)
+                                    DEF_READWRITE(enable_seq_comp_node_opt)
+                                            DEF_READWRITE(cpu_inter_op_parallelism);
 
 #undef CURRENT_CLASS
 #define CURRENT_CLASS cg::ComputingGraph::Options::GraphOpt
@@ -16,6 +16,7 @@
 #include "megbrain/opr/basic_arith.h"
 #include "megbrain/opr/blas.h"
 #include "megbrain/opr/dnn/adaptive_pooling.h"
+#include "megbrain/opr/dnn/attention.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/dnn/correlation.h"
 #include "megbrain/opr/dnn/fake_quant.h"
@@ -23,10 +24,13 @@
 #include "megbrain/opr/dnn/local.h"
 #include "megbrain/opr/dnn/lrn.h"
 #include "megbrain/opr/dnn/lsq.h"
+#include "megbrain/opr/dnn/norm.h"
 #include "megbrain/opr/dnn/pooling.h"
+#include "megbrain/opr/dnn/rnn.h"
 #include "megbrain/opr/dnn/roi_align.h"
 #include "megbrain/opr/dnn/roi_pooling.h"
 #include "megbrain/opr/dnn/sliding_window_transpose.h"
+#include "megbrain/opr/dnn/softmax.h"
 #include "megbrain/opr/dnn/tqt.h"
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/indexing.h"
@@ -636,4 +640,84 @@ auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
 }
 OP_TRAIT_REG(LRN, LRN).apply_on_var_node(apply_on_var_node).fallback();
 }  // namespace lrn
+
+namespace softmax {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const Softmax&>(def);
+    mgb_assert(inputs.size() == 1);
+    return opr::Softmax::make(inputs[0], op.param());
+}
+OP_TRAIT_REG(Softmax, Softmax).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace softmax
+
+namespace layer_norm {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const LayerNorm&>(def);
+    if (inputs.size() == 1) {
+        return opr::LayerNorm::make(inputs[0], op.param());
+    }
+    mgb_assert(inputs.size() == 3);
+    return opr::LayerNorm::make(inputs[0], inputs[1], inputs[2], op.param());
+}
+OP_TRAIT_REG(LayerNorm, LayerNorm).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace layer_norm
+
+namespace group_norm {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const GroupNorm&>(def);
+    if (inputs.size() == 1) {
+        return opr::GroupNorm::make(inputs[0], op.param());
+    }
+    mgb_assert(inputs.size() == 3);
+    return opr::GroupNorm::make(inputs[0], inputs[1], inputs[2], op.param());
+}
+OP_TRAIT_REG(GroupNorm, GroupNorm).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace group_norm
+
+namespace attention {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const Attention&>(def);
+    if (inputs.size() == 3) {
+        return opr::Attention::make(inputs[0], inputs[1], inputs[2], op.param());
+    }
+    mgb_assert(inputs.size() == 4);
+    return opr::Attention::make(inputs[0], inputs[1], inputs[2], inputs[3], op.param());
+}
+OP_TRAIT_REG(Attention, Attention).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace attention
+
+//! seq_len is the optional last input of both LSTM and GRU
+namespace lstm {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const LSTM&>(def);
+    if (inputs.size() == 4) {
+        return opr::LSTM::make(
+                       inputs[0], inputs[1], inputs[2], inputs[3], op.param())[0]
+                .node()
+                ->owner_opr();
+    }
+    mgb_assert(inputs.size() == 5);
+    return opr::LSTM::make(
+                   inputs[0], inputs[1], inputs[2], inputs[3], inputs[4], op.param())[0]
+            .node()
+            ->owner_opr();
+}
+OP_TRAIT_REG(LSTM, LSTM).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace lstm
+
+namespace gru {
+auto apply_on_var_node(const OpDef& def, const VarNodeArray& inputs) {
+    auto&& op = static_cast<const GRU&>(def);
+    if (inputs.size() == 3) {
+        return opr::GRU::make(inputs[0], inputs[1], inputs[2], op.param())[0]
+                .node()
+                ->owner_opr();
+    }
+    mgb_assert(inputs.size() == 4);
+    return opr::GRU::make(inputs[0], inputs[1], inputs[2], inputs[3], op.param())[0]
+            .node()
+            ->owner_opr();
+}
+OP_TRAIT_REG(GRU, GRU).apply_on_var_node(apply_on_var_node).fallback();
+}  // namespace gru
 }  // namespace mgb::imperative
@@ -15,6 +15,7 @@
 #include "tensor.h"
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -84,6 +85,9 @@ LITE_API inline LiteAlgoSelectStrategy operator|(
  * 1: dispatch async if there are more than one comp node with limited queue
  * mask 0b10: async if there are multiple comp nodes with
  * mask 0b100: always async
+ *
+ * \param enable_bf16_io_f32_comp convert the float32 graph to bfloat16 I/O
+ * with float32 computation, so that the bfloat16 kernels can be used
  */
 struct LITE_API Options {
     bool weight_preprocess = false;
@@ -107,6 +111,9 @@ struct LITE_API Options {
     bool enable_nchw4 = false;
     bool enable_nchw32 = false;
     bool enable_nchw64 = false;
+
+    //! dtype conversion options
+    bool enable_bf16_io_f32_comp = false;
 };
 
 /*!
@@ -117,9 +124,14 @@ struct LITE_API Options {
  *
  *\param has_compression flag whether the model is compressed, the compress
  *method will read form the model
+ *
+ * \param mmap_model map the model file into memory when loading from a path,
+ *so the aligned params of a bare, unencrypted model share the mapped pages
+ *instead of a private copy, ignored on Windows
  */
 struct LITE_API Config {
     bool has_compression = false;
+    bool mmap_model = false;
     int device_id = 0;
     LiteDeviceType device_type = LiteDeviceType::LITE_CPU;
     LiteBackend backend = LiteBackend::LITE_DEFAULT;
@@ -300,6 +312,60 @@ private:
     std::string m_extra_info;
 };
 
+/*!
+ * \brief configuration of the dynamic batching in BatchedNetwork
+ *
+ * \param max_batch max number of samples, i.e. the sum of the sizes of the
+ * first dimension of the coalesced requests, in one forward
+ *
+ * \param max_queue_delay_us max time in microseconds that a request waits in
+ * the queue for the later requests to be coalesced with
+ *
+ * \param pad_to_max_batch pad every batch with zeros to max_batch, so the
+ * input shape of the network never changes
+ */
+struct LITE_API BatchConfig {
+    size_t max_batch = 8;
+    size_t max_queue_delay_us = 1000;
+    bool pad_to_max_batch = false;
+};
+
+/*!
+ * \brief dynamic batching front-end of a loaded network
+ *
+ * Requests can be submitted from multiple threads. They are queued and
+ * coalesced along the first dimension of the inputs by a worker thread, which
+ * runs one forward for the whole batch and scatters the outputs back to the
+ * requests by the finish callback of the network. Requests are coalesced only
+ * when their input layouts are equal except the first dimension.
+ *
+ * The network is owned by the BatchedNetwork until it is destructed, which
+ * means the network should not be forwarded elsewhere and its finish callback
+ * should not be changed.
+ */
+class LITE_API BatchedNetwork {
+public:
+    class Impl;
+
+    //! map from the io tensor name to the tensor of a single request
+    using TensorMap = std::unordered_map<std::string, std::shared_ptr<Tensor>>;
+
+    BatchedNetwork(std::shared_ptr<Network> network, const BatchConfig& config = {});
+
+    //! all the pending requests are finished before return
+    ~BatchedNetwork();
+
+    //! submit a request with all the network inputs, the future would get the
+    //! outputs of the request which are copied to CPU tensors
+    std::future<TensorMap> submit(const TensorMap& inputs);
+
+    //! submit a request and wait for its outputs
+    TensorMap forward(const TensorMap& inputs);
+
+private:
+    std::unique_ptr<Impl> m_impl;
+};
+
 /*********************** MGE special network function ***************/
 class LITE_API Runtime {
 public:
@@ -309,6 +375,12 @@ public:
             std::shared_ptr<Network> dst_network, size_t nr_threads);
     static size_t get_cpu_threads_number(std::shared_ptr<Network> dst_network);
 
+    //! When device is CPU, place the threads and the memory of the to be
+    //! loaded model on the given NUMA node. Weights shared from a network on
+    //! another NUMA node by shared_weight_with_network are replicated on it.
+    static void set_cpu_numa_node(
+            std::shared_ptr<Network> dst_network, size_t numa_node);
+
     //! set threads affinity callback;
     static void set_runtime_thread_affinity(
             std::shared_ptr<Network> network,
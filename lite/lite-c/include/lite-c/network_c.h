@@ -74,6 +74,9 @@ extern "C" {
  * 1: dispatch async if there are more than one comp node with limited queue
  * mask 0b10: async if there are multiple comp nodes with
  * mask 0b100: always async
+ *
+ * \param enable_bf16_io_f32_comp convert the float32 graph to bfloat16 I/O
+ * with float32 computation, so that the bfloat16 kernels can be used
  */
 typedef struct Options {
     int weight_preprocess;
@@ -97,6 +100,9 @@ typedef struct Options {
     int enable_nchw4;
     int enable_nchw32;
     int enable_nchw64;
+
+    //! dtype conversion options
+    int enable_bf16_io_f32_comp;
 } LiteOptions;
 
 //! define a default Options
@@ -380,6 +386,14 @@ LITE_API int LITE_set_cpu_inplace_mode(LiteNetwork network);
  */
 LITE_API int LITE_set_cpu_threads_number(LiteNetwork network, size_t nr_threads);
 
+/**
+ * \brief When device is CPU, this interface will place the threads and the
+ * memory of the to be loaded model on the given NUMA node.
+ * \param[in] network The loaded model
+ * \param[in] numa_node The NUMA node
+ */
+LITE_API int LITE_set_cpu_numa_node(LiteNetwork network, size_t numa_node);
+
 /**
  * \brief set device id, default device id = 0
  * \param[in] network The loaded model
@@ -42,7 +42,8 @@ const LiteOptions default_option = {
         .enable_nchw4 = 0,
         .enable_nchw32 = 0,
         .enable_nchw64 = 0,
-
+        //! dtype conversion options
+        .enable_bf16_io_f32_comp = 0,
 };
 
 //! define a default config
@@ -140,6 +141,8 @@ lite::Config convert_to_lite_config(const LiteConfig c_config) {
     lite_config.options.enable_nhwcd4 = c_config.options.enable_nhwcd4;
     lite_config.options.enable_nchw32 = c_config.options.enable_nchw32;
     lite_config.options.enable_nchw64 = c_config.options.enable_nchw64;
+    lite_config.options.enable_bf16_io_f32_comp =
+            c_config.options.enable_bf16_io_f32_comp;
 
     return lite_config;
 }
@@ -458,6 +461,15 @@ int LITE_set_cpu_threads_number(LiteNetwork network, size_t nr_threads) {
     LITE_CAPI_END();
 }
 
+int LITE_set_cpu_numa_node(LiteNetwork network, size_t numa_node) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    lite::Runtime::set_cpu_numa_node(network_shared, numa_node);
+    LITE_CAPI_END();
+}
+
 int LITE_set_network_algo_policy(LiteNetwork network, LiteAlgoSelectStrategy strategy) {
     LITE_CAPI_BEGIN();
     LITE_ASSERT(network, "The network pass to LITE api is null");
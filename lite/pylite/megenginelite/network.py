@@ -42,6 +42,8 @@ class LiteOptions(Structure):
         ("enable_nchw4", c_int),
         ("enable_nchw32", c_int),
         ("enable_nchw64", c_int),
+        # dtype conversion options
+        ("enable_bf16_io_f32_comp", c_int),
     ]
 
     def __init__(self):
@@ -57,6 +59,7 @@ class LiteOptions(Structure):
         self.comp_node_seq_record_level = 0
         self.graph_opt_level = 2
         self.async_exec_level = 1
+        self.enable_bf16_io_f32_comp = False
 
     def __repr__(self):
         data = {
@@ -72,6 +75,7 @@ class LiteOptions(Structure):
             "comp_node_seq_record_level": self.comp_node_seq_record_level,
             "graph_opt_level": self.graph_opt_level,
             "async_exec_level": self.async_exec_level,
+            "enable_bf16_io_f32_comp": bool(self.enable_bf16_io_f32_comp),
         }
         return data.__repr__()
 
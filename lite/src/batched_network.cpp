@@ -0,0 +1,266 @@
+/**
+ * \file src/batched_network.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "lite/network.h"
+#include "misc.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+using namespace lite;
+
+class BatchedNetwork::Impl {
+    using clock = std::chrono::steady_clock;
+    using IOMap =
+            std::unordered_map<std::string, std::pair<IO, std::shared_ptr<Tensor>>>;
+
+    struct Request {
+        TensorMap inputs, outputs;
+        //! size of the first dimension of the inputs
+        size_t batch;
+        clock::time_point enqueue_time;
+        std::promise<TensorMap> promise;
+    };
+
+    std::shared_ptr<Network> m_network;
+    const BatchConfig m_config;
+    std::vector<std::string> m_input_names;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::deque<std::unique_ptr<Request>> m_queue;
+    bool m_stop = false;
+
+    //! requests in the running batch and the number of rows of the network
+    //! inputs, which are only accessed by the worker thread
+    std::vector<std::unique_ptr<Request>> m_running;
+    size_t m_nr_running_rows = 0;
+
+    std::thread m_worker;
+
+    static bool batchable(const Request& a, const Request& b);
+
+    //! number of requests at the front of the queue that can be coalesced
+    //! into the next batch; m_mtx must be locked
+    size_t nr_next_batch_requests(size_t* nr_samples) const;
+
+    void worker();
+    void run_batch();
+    void scatter_outputs(const IOMap& outputs);
+
+public:
+    Impl(std::shared_ptr<Network> network, const BatchConfig& config);
+    ~Impl();
+
+    std::future<TensorMap> submit(const TensorMap& inputs);
+};
+
+BatchedNetwork::Impl::Impl(std::shared_ptr<Network> network, const BatchConfig& config)
+        : m_network{std::move(network)}, m_config{config} {
+    LITE_ASSERT(m_network, "BatchedNetwork is constructed with null network.");
+    LITE_ASSERT(m_config.max_batch > 0, "max_batch of BatchedNetwork is zero.");
+    m_input_names = m_network->get_all_input_name();
+    m_network->set_finish_callback(
+            [this](const IOMap& outputs) { scatter_outputs(outputs); });
+    m_worker = std::thread{[this]() { worker(); }};
+}
+
+BatchedNetwork::Impl::~Impl() {
+    {
+        std::lock_guard<std::mutex> lock{m_mtx};
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_worker.join();
+    m_network->set_finish_callback({});
+}
+
+bool BatchedNetwork::Impl::batchable(const Request& a, const Request& b) {
+    for (auto&& i : a.inputs) {
+        auto la = i.second->get_layout(), lb = b.inputs.at(i.first)->get_layout();
+        if (la.ndim != lb.ndim || la.data_type != lb.data_type) {
+            return false;
+        }
+        for (size_t dim = 1; dim < la.ndim; ++dim) {
+            if (la.shapes[dim] != lb.shapes[dim]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+size_t BatchedNetwork::Impl::nr_next_batch_requests(size_t* nr_samples) const {
+    size_t nr_req = 0, nr = 0;
+    for (auto&& req : m_queue) {
+        if (nr + req->batch > m_config.max_batch ||
+            !batchable(*m_queue.front(), *req)) {
+            break;
+        }
+        nr += req->batch;
+        ++nr_req;
+    }
+    *nr_samples = nr;
+    return nr_req;
+}
+
+std::future<BatchedNetwork::TensorMap> BatchedNetwork::Impl::submit(
+        const TensorMap& inputs) {
+    auto req = std::make_unique<Request>();
+    req->batch = 0;
+    for (auto&& name : m_input_names) {
+        auto iter = inputs.find(name);
+        LITE_ASSERT(
+                iter != inputs.end() && iter->second,
+                "input %s of the request is not given.", name.c_str());
+        auto&& layout = iter->second->get_layout();
+        LITE_ASSERT(layout.ndim > 0, "input %s of the request is empty.", name.c_str());
+        if (!req->batch) {
+            req->batch = layout.shapes[0];
+        }
+        LITE_ASSERT(
+                layout.shapes[0] == req->batch,
+                "inputs of a request must have the same batch size, got %zu "
+                "and %zu.",
+                req->batch, layout.shapes[0]);
+        req->inputs[name] = iter->second;
+    }
+    LITE_ASSERT(
+            req->batch > 0 && req->batch <= m_config.max_batch,
+            "batch size of the request %zu is not in (0, %zu].", req->batch,
+            m_config.max_batch);
+    auto ret = req->promise.get_future();
+    req->enqueue_time = clock::now();
+    {
+        std::lock_guard<std::mutex> lock{m_mtx};
+        m_queue.emplace_back(std::move(req));
+    }
+    m_cv.notify_one();
+    return ret;
+}
+
+void BatchedNetwork::Impl::worker() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock{m_mtx};
+            m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            auto deadline = m_queue.front()->enqueue_time +
+                            std::chrono::microseconds(m_config.max_queue_delay_us);
+            size_t nr_samples, nr_req;
+            for (;;) {
+                nr_req = nr_next_batch_requests(&nr_samples);
+                //! the batch is full, or it can not be enlarged by the next
+                //! request in the queue
+                if (m_stop || nr_samples == m_config.max_batch ||
+                    nr_req < m_queue.size()) {
+                    break;
+                }
+                if (m_cv.wait_until(lock, deadline) == std::cv_status::timeout) {
+                    nr_req = nr_next_batch_requests(&nr_samples);
+                    break;
+                }
+            }
+            for (size_t i = 0; i < nr_req; ++i) {
+                m_running.emplace_back(std::move(m_queue.front()));
+                m_queue.pop_front();
+            }
+            m_nr_running_rows =
+                    m_config.pad_to_max_batch ? m_config.max_batch : nr_samples;
+        }
+        run_batch();
+    }
+}
+
+void BatchedNetwork::Impl::run_batch() {
+    bool succeed = false;
+#if LITE_ENABLE_EXCEPTION
+    try {
+#endif
+        auto&& first = *m_running.front();
+        for (auto&& name : m_input_names) {
+            auto dst = m_network->get_io_tensor(name, LiteTensorPhase::LITE_INPUT);
+            auto layout = first.inputs.at(name)->get_layout();
+            layout.shapes[0] = m_nr_running_rows;
+            dst->set_layout(layout);
+            size_t offset = 0;
+            for (auto&& req : m_running) {
+                dst->slice({offset}, {offset + req->batch})
+                        ->copy_from(*req->inputs.at(name));
+                offset += req->batch;
+            }
+            if (offset < m_nr_running_rows) {
+                dst->slice({offset}, {m_nr_running_rows})->fill_zero();
+            }
+        }
+        //! outputs are scattered by the finish callback in wait()
+        m_network->forward();
+        m_network->wait();
+        succeed = true;
+#if LITE_ENABLE_EXCEPTION
+    } catch (...) {
+        for (auto&& req : m_running) {
+            req->promise.set_exception(std::current_exception());
+        }
+    }
+#endif
+    if (succeed) {
+        for (auto&& req : m_running) {
+            req->promise.set_value(std::move(req->outputs));
+        }
+    }
+    m_running.clear();
+}
+
+void BatchedNetwork::Impl::scatter_outputs(const IOMap& outputs) {
+    for (auto&& i : outputs) {
+        auto&& src = i.second.second;
+        auto layout = src->get_layout();
+        LITE_ASSERT(
+                layout.ndim > 0 && layout.shapes[0] == m_nr_running_rows,
+                "first dimension of output %s is not the batch size %zu.",
+                i.first.c_str(), m_nr_running_rows);
+        size_t offset = 0;
+        for (auto&& req : m_running) {
+            auto dst = std::make_shared<Tensor>();
+            dst->copy_from(*src->slice({offset}, {offset + req->batch}));
+            req->outputs[i.first] = std::move(dst);
+            offset += req->batch;
+        }
+    }
+}
+
+BatchedNetwork::BatchedNetwork(
+        std::shared_ptr<Network> network, const BatchConfig& config) {
+    LITE_ERROR_HANDLER_BEGIN
+    m_impl = std::make_unique<Impl>(std::move(network), config);
+    LITE_ERROR_HANDLER_END
+}
+
+BatchedNetwork::~BatchedNetwork() = default;
+
+std::future<BatchedNetwork::TensorMap> BatchedNetwork::submit(const TensorMap& inputs) {
+    LITE_ERROR_HANDLER_BEGIN
+    return m_impl->submit(inputs);
+    LITE_ERROR_HANDLER_END
+}
+
+BatchedNetwork::TensorMap BatchedNetwork::forward(const TensorMap& inputs) {
+    LITE_ERROR_HANDLER_BEGIN
+    return submit(inputs).get();
+    LITE_ERROR_HANDLER_END
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -107,6 +107,8 @@ inline void call_func<NetworkImplDft, void>(
         std::string func_name, Network::NetworkImplBase* network_impl, size_t num) {
     if (func_name == "set_cpu_threads_number") {
         CALL_FUNC(set_cpu_threads_number, num);
+    } else if (func_name == "set_cpu_numa_node") {
+        CALL_FUNC(set_cpu_numa_node, num);
     } else if (func_name == "set_network_algo_workspace_limit") {
         CALL_FUNC(set_network_algo_workspace_limit, num);
     } else {
@@ -95,6 +95,7 @@ void NetworkImplDft::application_config() {
     ConfigOption(comp_node_seq_record_level, comp_node_seq_record_level);
     ConfigOption(graph_opt_level, graph_opt_level);
     ConfigOption(async_exec_level, async_exec_level);
+    ConfigOption(graph_opt.bf16_io_f32_comp, enable_bf16_io_f32_comp);
 
 #undef ConfigOption
 #define ConfigOptionLayoutTransform(name) \
@@ -174,6 +175,15 @@ void NetworkImplDft::set_cpu_threads_number(size_t nr_threads) {
     }
 }
 
+void NetworkImplDft::set_cpu_numa_node(size_t numa_node) {
+    LITE_ASSERT(
+            m_user_config->device_type == LiteDeviceType::LITE_CPU,
+            "numa node is only avaliable in CPU.");
+    m_compnode_locator.numa_node = numa_node;
+    //! weights shared from another network are copied to this numa node
+    m_load_config.numa_local_shared_tensor = true;
+}
+
 void NetworkImplDft::set_runtime_thread_affinity(
         const ThreadAffinityCallback& thread_affinity_callback) {
     LITE_ASSERT(
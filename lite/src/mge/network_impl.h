@@ -118,6 +118,9 @@ public:
     void set_cpu_threads_number(size_t nr_threads);
     size_t get_cpu_threads_number() const { return m_nr_threads; }
 
+    //! place the threads and memory of the model on a NUMA node
+    void set_cpu_numa_node(size_t numa_node);
+
     //! set device id, default device id = 0
     void set_device_id(int device_id) override;
     int get_device_id() const override { return m_compnode_locator.device; };
@@ -23,6 +23,13 @@
 #include <fstream>
 #include <memory>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace lite;
 
 /**
@@ -72,6 +79,29 @@ void Network::load_model(void* model_mem, size_t size) {
 void Network::load_model(std::string model_path) {
     LITE_ERROR_HANDLER_BEGIN
     LITE_CHECK_NON_NULL_POINTER(m_impl);
+#if !defined(_WIN32)
+    if (m_config.mmap_model) {
+        int fd = open(model_path.c_str(), O_RDONLY);
+        LITE_ASSERT(
+                fd >= 0, "failed to open %s: %s", model_path.c_str(), strerror(errno));
+        struct stat st;
+        size_t size = fstat(fd, &st) ? 0 : st.st_size;
+        //! the same private copy-on-write mapping as InputFile::make_mmap, the
+        //! model parser needs the whole file in memory to unpack it first
+        void* ptr = MAP_FAILED;
+        if (size) {
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        }
+        auto err = errno;
+        close(fd);
+        LITE_ASSERT(
+                ptr != MAP_FAILED, "failed to mmap %s: %s", model_path.c_str(),
+                strerror(err));
+        std::shared_ptr<void> buf{ptr, [size](void* p) { munmap(p, size); }};
+        prase_model(buf, size);
+        return;
+    }
+#endif
     FILE* fin = fopen(model_path.c_str(), "rb");
     LITE_ASSERT(fin, "failed to open %s: %s", model_path.c_str(), strerror(errno));
     fseek(fin, 0, SEEK_END);
@@ -301,6 +331,20 @@ void Runtime::set_cpu_threads_number(
     LITE_ERROR_HANDLER_END
 }
 
+void Runtime::set_cpu_numa_node(std::shared_ptr<Network> network, size_t numa_node) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl = NetworkHelper::implement(network);
+    if (network_impl->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                !NetworkHelper::loaded(network),
+                "set_cpu_numa_node should be used before model loaded.");
+        call_func<NetworkImplDft, void>("set_cpu_numa_node", network_impl, numa_node);
+        return;
+    }
+    LITE_THROW("set_cpu_numa_node is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
 void Runtime::use_tensorrt(std::shared_ptr<Network> network) {
     LITE_ERROR_HANDLER_BEGIN
     auto network_impl = NetworkHelper::implement(network);
@@ -126,6 +126,9 @@ bool default_parse_info(
             config.options.graph_opt_level = options["graph_opt_level"];
         if (options.contains("async_exec_level"))
             config.options.async_exec_level = options["async_exec_level"];
+        if (options.contains("enable_bf16_io_f32_comp"))
+            config.options.enable_bf16_io_f32_comp =
+                    options["enable_bf16_io_f32_comp"];
     }
     //! IO
     auto get_io_type = [](std::string type) -> LiteIOType {
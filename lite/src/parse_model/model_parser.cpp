@@ -99,6 +99,10 @@ std::shared_ptr<void> ModelParser::parse_model(
     model_length = m_model_data->data()->size();
     const uint8_t* model_data = m_model_data->data()->Data();
     LITE_ASSERT(model_length > 0, "The loaded model is of zero length.");
+    if (m_model_decryption_name == "NONE") {
+        //! params may be shared with the model memory, keep it alive
+        return std::shared_ptr<void>(m_model, const_cast<uint8_t*>(model_data));
+    }
     return decrypt_memory(
             model_data, model_length, m_model_decryption_name, model_length);
 }
@@ -18,6 +18,7 @@
 #include <chrono>
 #include <memory>
 #include <random>
+#include <thread>
 #include <unordered_map>
 using namespace lite;
 
@@ -65,6 +66,16 @@ TEST(TestNetWork, Basic) {
     compare_lite_tensor<float>(result_lite, result_mgb);
 }
 
+TEST(TestNetWork, MmapModel) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+    config.mmap_model = true;
+    auto result_lite = mgelite_lar(model_path, config, "data", lite_tensor);
+    compare_lite_tensor<float>(result_lite, result_mgb);
+}
+
 TEST(TestNetWork, SetDeviceId) {
     Config config;
     auto lite_tensor = get_input_data("./input_data.npy");
@@ -235,6 +246,78 @@ TEST(TestNetWork, BasicMultiThread) {
     compare_lite_tensor<float>(output_tensor, result_mgb);
 }
 
+TEST(TestNetWork, BatchedNetwork) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+
+    BatchConfig batch_config;
+    batch_config.max_batch = 4;
+    batch_config.max_queue_delay_us = 100000;
+    BatchedNetwork batched_network{network, batch_config};
+
+    //! requests from multiple threads, one of which has batch size 2
+    auto lite_tensor2 = TensorUtils::concat({*lite_tensor, *lite_tensor}, 0);
+    constexpr size_t NR_REQUEST = 5;
+    std::vector<BatchedNetwork::TensorMap> outputs(NR_REQUEST);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NR_REQUEST; ++i) {
+        threads.emplace_back([&, i]() {
+            auto input = i ? lite_tensor : lite_tensor2;
+            outputs[i] = batched_network.forward({{"data", input}});
+        });
+    }
+    for (auto&& i : threads) {
+        i.join();
+    }
+    for (size_t i = 0; i < NR_REQUEST; ++i) {
+        ASSERT_EQ(1u, outputs[i].size());
+        auto out = outputs[i].begin()->second;
+        ASSERT_EQ(i ? 1u : 2u, out->get_layout().shapes[0]);
+        for (size_t j = 0; j < out->get_layout().shapes[0]; ++j) {
+            compare_lite_tensor<float>(out->slice({j}, {j + 1}), result_mgb);
+        }
+    }
+
+    ASSERT_ANY_THROW(batched_network.forward({}));
+}
+
+TEST(TestNetWork, BatchedNetworkPadding) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::shared_ptr<Network> network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+
+    BatchConfig batch_config;
+    batch_config.max_batch = 3;
+    batch_config.pad_to_max_batch = true;
+    {
+        BatchedNetwork batched_network{network, batch_config};
+        auto future0 = batched_network.submit({{"data", lite_tensor}});
+        auto future1 = batched_network.submit({{"data", lite_tensor}});
+        for (auto* i : {&future0, &future1}) {
+            auto out = i->get().at(network->get_output_name(0));
+            ASSERT_EQ(1u, out->get_layout().shapes[0]);
+            compare_lite_tensor<float>(out, result_mgb);
+        }
+        ASSERT_EQ(3u, network->get_input_tensor(0)->get_layout().shapes[0]);
+    }
+
+    //! the network can be used directly after the BatchedNetwork is destructed
+    auto input_tensor = network->get_input_tensor(0);
+    input_tensor->copy_from(*lite_tensor);
+    network->forward();
+    network->wait();
+    compare_lite_tensor<float>(network->get_output_tensor(0), result_mgb);
+}
+
 TEST(TestNetWork, ThreadAffinity) {
     size_t nr_threads = 4;
     Config config;
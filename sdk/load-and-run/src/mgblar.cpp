@@ -30,6 +30,7 @@
 #include "megbrain/serialization/extern_c_opr.h"
 #include "megbrain/serialization/serializer.h"
 #include "megbrain/utils/debug.h"
+#include "megbrain/utils/mmap_persistent_cache.h"
 
 #include "megbrain/system.h"
 #include "megbrain/version.h"
@@ -123,6 +124,14 @@ R"__usage__(
   --disable-mem-opt
     Disable memory optimizations. This is used to check whether memory
     optimization is the cause for unexpected behavior.
+  --mem-alloc-search-time <seconds>
+    Search for a static memory allocation plan with lower peak memory usage
+    within the given time, which is useful on memory-constrained devices. The
+    faster heuristic allocator is used by default.
+  --cpu-inter-op <number>
+    Run independent branches of a model on a single CPU comp node concurrently,
+    on at most the given number of lanes. The threads of a multithread comp node
+    are split between the lanes in proportion to their loads.
   --fake-first
     Enable fake exec for the first run. In fake exec mode, some initialization
     job would be done, but no actual computing is performed. This can be used in
@@ -135,6 +144,10 @@ R"__usage__(
   --share-param-mem
     Share the memory used by model params with model storage. This can be used
     to reduce memory usage when computing on CPU.
+  --mmap-model
+    Map the model file into memory instead of reading it, and share the params
+    that happen to be aligned with the mapped pages. Pages are copy-on-write,
+    so untouched params are backed by the page cache.
   --record-comp-seq | --record-comp-seq2
     Record the computing sequence, in level 1 or 2. It reduces overhead of API
     calls of some asynchronous computing devices, especially for OpenCL. In
@@ -167,8 +180,16 @@ R"__usage__(
 R"__usage__(
   --fast-run-algo-policy <path>
     It will read the cache file before profile, and save new fastrun in cache file.
+  --fast-run-shared-cache <path>
+    Use a cache file that can be shared by concurrent processes. New fastrun
+    results are appended to the file once they are profiled, so the file need
+    not be dumped on exit. Can not be used with --fast-run-algo-policy.
   --fast-run-shared-batch-size
     Set the batch size used during fastrun, Note that it may not be the same as the actual running batch size
+  --fast-run-max-candidates <n>
+    Only profile the first n candidate algorithms of each operator, ranked with
+    the heuristic choice first and naive algorithms last. Zero means profiling
+    all candidates.
   --binary-equal-between-batch
     Each batch of output is promised binary equal if each batch of input is binary equal.
     Note that if this option is turned on, `--reproducible` will also be turned on.
@@ -244,6 +265,23 @@ R"__usage__(
   --enable-fuse-preprocess
     Fusion astype\pad_channel\dimshuffle and etc opr from h2d op
 )__usage__"
+R"__usage__(
+  --enable-fuse-softmax
+    Fuse the exp, sub, max, sum and div oprs of decomposed softmax into a single Softmax opr
+)__usage__"
+R"__usage__(
+  --enable-fuse-layer-norm
+    Fuse the mean, sub, pow, add and div oprs of decomposed layer norm into a single LayerNorm opr
+)__usage__"
+R"__usage__(
+  --enable-fuse-attention
+    Fuse the matmul, scale, mask, softmax and matmul oprs of scaled dot-product attention into a single Attention opr
+)__usage__"
+R"__usage__(
+  --enable-io-bf16-comp-f32
+    Convert a float32 model to take and produce bfloat16 tensors while computing in float32, so that
+    the bfloat16 matmul and convolution kernels can be used
+)__usage__"
 R"__usage__(
   --enable-nchw64
     Execute operators with kernels implemented in MegDNN with NCHW64 tensor format. Can only be used
@@ -553,12 +591,14 @@ struct Args {
     bool display_model_info = false;
     bool disable_assert_throw = false;
     bool share_param_mem = false;
+    bool mmap_model = false;
 #if MGB_ENABLE_FASTRUN
     bool use_full_run = false;
     bool use_fast_run = false;
 #endif
     bool reproducible = false;
     std::string fast_run_cache_path;
+    std::string fast_run_shared_cache_path;
 #ifndef __IN_TEE_ENV__
 #if MGB_ENABLE_JSON
     std::string static_mem_log_dir_path;
@@ -704,7 +744,11 @@ void format_and_print(const std::string& tablename, const Args& env) {
 void run_test_st(Args &env) {
     std::unique_ptr<serialization::InputFile> inp_file;
 
-    if (env.share_param_mem) {
+    if (env.mmap_model) {
+        mgb_assert(!env.share_param_mem,
+                   "--mmap-model and --share-param-mem are exclusive");
+        inp_file = serialization::InputFile::make_mmap(env.model_path.c_str());
+    } else if (env.share_param_mem) {
         FILE *fin = fopen(env.model_path.c_str(), "rb");
         mgb_assert(fin, "failed to open %s: %s", env.model_path.c_str(),
                 strerror(errno));
@@ -784,6 +828,14 @@ void run_test_st(Args &env) {
 #endif
             mgb::gopt::enable_opr_use_profiling_cache_inplace(output_var_list);
     }
+    if (!env.fast_run_shared_cache_path.empty()) {
+        PersistentCache::set_impl(std::make_shared<MmapPersistentCache>(
+                env.fast_run_shared_cache_path));
+#if MGB_ENABLE_FASTRUN
+        if (!env.use_full_run && !env.use_fast_run)
+#endif
+            mgb::gopt::enable_opr_use_profiling_cache_inplace(output_var_list);
+    }
 
     // load testcase
     decltype(env.load_ret) testcase;
@@ -1283,6 +1335,26 @@ Args Args::from_argv(int argc, char **argv) {
             graph_opt.graph_opt.enable_fuse_preprocess();
             continue;
         }
+        if (!strcmp(argv[i], "--enable-fuse-softmax")) {
+            mgb_log_warn("enable-fuse-softmax optimization");
+            graph_opt.graph_opt.enable_fuse_softmax();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-fuse-layer-norm")) {
+            mgb_log_warn("enable-fuse-layer-norm optimization");
+            graph_opt.graph_opt.enable_fuse_layer_norm();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-fuse-attention")) {
+            mgb_log_warn("enable-fuse-attention optimization");
+            graph_opt.graph_opt.enable_fuse_attention();
+            continue;
+        }
+        if (!strcmp(argv[i], "--enable-io-bf16-comp-f32")) {
+            mgb_log_warn("enable bf16_io_f32_comp optimization");
+            graph_opt.graph_opt.enable_bf16_io_f32_comp();
+            continue;
+        }
         if (!strcmp(argv[i], "--enable-fuse-conv-bias-nonlinearity")) {
             mgb_log_warn("enable fuse-conv-bias-nonlinearity optimization");
             graph_opt.graph_opt.enable_fuse_conv_bias_nonlinearity();
@@ -1411,6 +1483,19 @@ Args Args::from_argv(int argc, char **argv) {
             graph_opt.seq_opt.enable_mem_plan_opt = false;
             continue;
         }
+        if (!strcmp(argv[i], "--mem-alloc-search-time")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --mem-alloc-search-time");
+            graph_opt.seq_opt.mem_reuse_alloc_search_time = std::stod(argv[i]);
+            mgb_assert(graph_opt.seq_opt.mem_reuse_alloc_search_time >= 0);
+            continue;
+        }
+        if (!strcmp(argv[i], "--cpu-inter-op")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --cpu-inter-op");
+            graph_opt.seq_opt.cpu_inter_op_parallelism = std::stoul(argv[i]);
+            continue;
+        }
         if (!strcmp(argv[i], "--copy-to-host")) {
             ret.copy_to_host = true;
             continue;
@@ -1477,6 +1562,12 @@ Args Args::from_argv(int argc, char **argv) {
             ret.fast_run_cache_path = argv[i];
             continue;
         }
+        if (!strcmp(argv[i], "--fast-run-shared-cache")) {
+            ++i;
+            mgb_assert(i < argc, "path not given for --fast-run-shared-cache");
+            ret.fast_run_shared_cache_path = argv[i];
+            continue;
+        }
         if (!strcmp(argv[i], "--fast-run-shared-batch-size")) {
             ++i;
             mgb_assert(i < argc,
@@ -1486,6 +1577,14 @@ Args Args::from_argv(int argc, char **argv) {
             graph_opt.fast_run_config.shared_batch_size = batch_size;
             continue;
         }
+        if (!strcmp(argv[i], "--fast-run-max-candidates")) {
+            ++i;
+            mgb_assert(i < argc, "value not given for --fast-run-max-candidates");
+            int32_t nr_candidates = std::stoi(argv[i]);
+            mgb_assert(nr_candidates >= 0);
+            graph_opt.fast_run_config.max_profile_candidates = nr_candidates;
+            continue;
+        }
         if (!strcmp(argv[i], "--binary-equal-between-batch")) {
             graph_opt.fast_run_config.binary_equal_between_batch = true;
             ret.reproducible = true;
@@ -1503,6 +1602,10 @@ Args Args::from_argv(int argc, char **argv) {
             ret.share_param_mem = true;
             continue;
         }
+        if (!strcmp(argv[i], "--mmap-model")) {
+            ret.mmap_model = true;
+            continue;
+        }
         if (!strcmp(argv[i], "--disable-assert-throw")) {
             ret.disable_assert_throw = true;
             continue;
@@ -1625,12 +1728,18 @@ Args Args::from_argv(int argc, char **argv) {
         return ret;
     }
 
+    mgb_assert(ret.fast_run_cache_path.empty() ||
+                       ret.fast_run_shared_cache_path.empty(),
+               "--fast-run-algo-policy and --fast-run-shared-cache can not be "
+               "used together");
 #if MGB_ENABLE_FASTRUN
     if (graph_opt.fast_run_config.shared_batch_size) {
         mgb_assert(ret.use_fast_run || ret.use_full_run ||
-                           !ret.fast_run_cache_path.empty(),
+                           !ret.fast_run_cache_path.empty() ||
+                           !ret.fast_run_shared_cache_path.empty(),
                    "--fast-run-shared-batch-size should be used with "
-                   "--fast-run/--full-run/--fast-run-algo-policy");
+                   "--fast-run/--full-run/--fast-run-algo-policy/"
+                   "--fast-run-shared-cache");
     }
 #endif
     return ret;
@@ -134,6 +134,25 @@ CompNode::Locator CompNode::Locator::parse(const std::string& id) {
     };
     if (id.size() < 3)
         err();
+    // a NUMA node can be given for CPU comp nodes like cpu0@numa1
+    auto numa_pos = id.find('@');
+    if (numa_pos != std::string::npos) {
+        auto numa = id.substr(numa_pos + 1);
+        if (numa.size() <= 4 || numa.size() > 8 || numa.compare(0, 4, "numa") ||
+            numa.find_first_not_of("0123456789", 4) != std::string::npos) {
+            err();
+        }
+        auto ret = parse(id.substr(0, numa_pos));
+        if (ret.type != DeviceType::CPU && ret.type != DeviceType::MULTITHREAD) {
+            err();
+        }
+        ret.numa_node = std::stoi(numa.substr(4));
+        if (ret.numa_node >= MAX_NR_NUMA_NODE) {
+            err();
+        }
+        return ret;
+    }
+
     // current parsing location
     const char* ptr = id.data();
     if (id == "cpu:default") {
@@ -288,10 +307,20 @@ CompNode::Locator CompNode::Locator::to_physical() const {
             stream_physical = 1023;
         }
     }
-    return {type_physical, device_physical, {stream_physical}};
+    mgb_assert(
+            numa_node >= -1 && numa_node < MAX_NR_NUMA_NODE, "bad numa node: %d",
+            numa_node);
+    Locator ret{type_physical, device_physical, {stream_physical}};
+    ret.numa_node = numa_node;
+    return ret;
 }
 
 std::string CompNode::Locator::to_string() const {
+    if (numa_node >= 0) {
+        auto loc = *this;
+        loc.numa_node = -1;
+        return loc.to_string() + ssprintf("@numa%d", numa_node);
+    }
     if (device == DEVICE_CPU_DEFAULT) {
         return "cpu:default";
     } else if (device == DEVICE_MULTITHREAD_DEFAULT) {
@@ -572,6 +601,7 @@ void CompNode::finalize() {
 
 void CompNode::try_coalesce_all_free_memory() {
     CudaCompNode::try_coalesce_all_free_memory();
+    CpuCompNode::try_coalesce_all_free_memory();
     ROCmCompNode::try_coalesce_all_free_memory();
     CambriconCompNode::try_coalesce_all_free_memory();
 }
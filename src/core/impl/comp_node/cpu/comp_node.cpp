@@ -12,6 +12,7 @@
 #include "./comp_node.h"
 
 #include "megbrain/common.h"
+#include "megbrain/comp_node/alloc.h"
 #include "megbrain/comp_node_env.h"
 #include "megbrain/system.h"
 #include "megbrain/utils/arith_helper.h"
@@ -42,6 +43,33 @@ struct TaskElem {
     //! number of the parallelism
     size_t nr_parallelism;
 };
+
+//! pin the caller thread to the CPU cores of a NUMA node
+void set_numa_node_affinity(int numa_node) {
+    auto cpus = sys::get_numa_node_cpus(numa_node);
+    auto nr_cpu = sys::get_cpu_count();
+    cpus.erase(
+            std::remove_if(
+                    cpus.begin(), cpus.end(), [nr_cpu](int i) { return i >= nr_cpu; }),
+            cpus.end());
+    if (cpus.empty()) {
+        mgb_log_warn(
+                "CPU cores of numa node %d are unknown; thread affinity is not set",
+                numa_node);
+        return;
+    }
+    sys::set_cpu_affinity(cpus);
+}
+
+//! whether device memory is allocated by mem_alloc::CpuCachingAlloc, which
+//! could be disabled by setting MGB_CPU_CACHING_ALLOC=0
+bool cpu_caching_alloc_enabled() {
+    static bool ret = [] {
+        auto setting = MGB_GETENV("MGB_CPU_CACHING_ALLOC");
+        return !setting || strcmp(setting, "0");
+    }();
+    return ret;
+}
 }  // anonymous namespace
 
 void CpuCompNode::CpuDispatchableBase::add_callback(Task&& task) {
@@ -54,11 +82,15 @@ class CpuCompNode::WorkerQueue final : public AsyncQueueSC<TaskElem, WorkerQueue
 
     void on_async_queue_worker_thread_start() override {
         mgb_assert(m_locator.device >= 0);
-        if (enable_affinity) {
 #if !defined(ANDROID) && !defined(__ANDROID__)
+        if (m_locator.numa_node >= 0) {
+            set_numa_node_affinity(m_locator.numa_node);
+        } else if (enable_affinity && m_locator.device < sys::get_cpu_count()) {
+            // the devices beyond the cpus, like those of the inter-op lanes of
+            // SeqCompNodeOptimizer, are not bound
             sys::set_cpu_affinity({m_locator.device});
-#endif
         }
+#endif
 #if __DEPLOY_ON_XP_SP2__
         __builtin_trap();
 #else
@@ -77,6 +109,8 @@ public:
 
     explicit WorkerQueue(Locator locator) : m_locator(locator) {}
 
+    const Locator& locator() const { return m_locator; }
+
     void attach_thread_pool(std::shared_ptr<ThreadPool> thread_pool) {
         m_thread_pool = thread_pool;
     }
@@ -251,9 +285,41 @@ using CompNodeRecorderImpl = CpuCompNode::CompNodeRecorderImpl;
 
 //! ==================== CompNodeBaseImpl ======================
 class CpuCompNode::CompNodeBaseImpl : public CpuDispatchableBase {
+    //! raw allocator of m_mem_alloc
+    class RawAllocImpl final : public mem_alloc::RawAllocator {
+        const size_t m_alignment;
+        const int m_numa_node;
+
+    public:
+        RawAllocImpl(size_t alignment, int numa_node)
+                : m_alignment(alignment), m_numa_node(numa_node) {}
+
+        void* alloc(size_t size) override {
+            return raw_aligned_alloc(size, m_alignment, m_numa_node);
+        }
+
+        void free(void* ptr) override { mgb_aligned_free(ptr); }
+
+        void get_mem_info(size_t& free, size_t& tot) override {
+            std::tie(tot, free) = sys::get_ram_status_bytes();
+        }
+    };
+
+    mem_alloc::CpuCachingAlloc::UniquePtr m_mem_alloc;
+
 protected:
     Locator m_locator, m_locator_logical;
 
+    //! should be called after m_env is initialized
+    void init_mem_alloc() {
+        if (cpu_caching_alloc_enabled()) {
+            auto alignment = get_mem_addr_alignment();
+            m_mem_alloc = mem_alloc::CpuCachingAlloc::make(
+                    std::make_unique<RawAllocImpl>(alignment, m_locator.numa_node),
+                    alignment);
+        }
+    }
+
 public:
     CompNodeBaseImpl(
             const Locator& locator, const Locator& locator_logical, free_func_t fd,
@@ -264,20 +330,34 @@ public:
 
     virtual ~CompNodeBaseImpl() {}
 
-    void* mgb_aligned_alloc(size_t size) {
-        auto alignment = get_mem_addr_alignment();
+    //! return nullptr if failed
+    static void* raw_aligned_alloc(size_t size, size_t alignment, int numa_node) {
+        MGB_MARK_USED_VAR(numa_node);
 #ifdef WIN32
         return _aligned_malloc(size, alignment);
 #elif defined(__ANDROID__) || defined(ANDROID)
         return memalign(alignment, size);
 #else
         void* ptr = nullptr;
-        auto err = posix_memalign(&ptr, alignment, size);
-        mgb_assert(!err, "failed to malloc %zubytes with align %zu", size, alignment);
+        if (posix_memalign(&ptr, alignment, size)) {
+            return nullptr;
+        }
+        if (numa_node >= 0) {
+            // bind before the memory is written so fresh pages are placed on
+            // the node; pages of reused chunks are migrated
+            sys::bind_mem_to_numa_node(ptr, size, numa_node);
+        }
         return ptr;
 #endif
     }
 
+    void* mgb_aligned_alloc(size_t size) {
+        auto alignment = get_mem_addr_alignment();
+        auto ptr = raw_aligned_alloc(size, alignment, m_locator.numa_node);
+        mgb_assert(ptr, "failed to malloc %zubytes with align %zu", size, alignment);
+        return ptr;
+    }
+
     static void mgb_aligned_free(void* ptr) {
 #ifdef WIN32
         _aligned_free(ptr);
@@ -286,7 +366,21 @@ public:
 #endif
     }
 
-    void* alloc_device(size_t size) override { return mgb_aligned_alloc(size); }
+    //! free memory returned by alloc_device() of any comp node
+    static void free_device_mem(void* ptr) {
+        if (cpu_caching_alloc_enabled()) {
+            mem_alloc::CpuCachingAlloc::free(ptr);
+        } else {
+            mgb_aligned_free(ptr);
+        }
+    }
+
+    void* alloc_device(size_t size) override {
+        return m_mem_alloc ? m_mem_alloc->alloc(size) : mgb_aligned_alloc(size);
+    }
+
+    //! release the cached free memory; return number of bytes released
+    size_t trim_mem_alloc() { return m_mem_alloc ? m_mem_alloc->trim() : 0; }
 
     void* alloc_host(size_t size) override { return mgb_aligned_alloc(size); }
 
@@ -316,7 +410,8 @@ public:
     void dispatch(Task&& task) override { m_env.cpu_env().dispatch(std::move(task)); }
 
     MemNode mem_node() override {
-        // TODO: numa nodes
+        // memory on other NUMA nodes is still directly accessible, so all the
+        // CPU comp nodes share the host mem node
         return get_host_cpu_mem_node();
     }
 
@@ -324,6 +419,12 @@ public:
         return sys::get_ram_status_bytes();
     }
 
+#if !MGB_BUILD_SLIM_SERVING
+    size_t get_used_memory() override {
+        return m_mem_alloc ? m_mem_alloc->get_used_memory() : 0;
+    }
+#endif
+
     Locator locator() override { return m_locator; }
 
     Locator locator_logical() override { return m_locator_logical; }
@@ -394,6 +495,12 @@ public:
             m_queue->add_task({affinity_run, 1_z});
         }
     }
+
+    void set_schedule_mode(ThreadPoolScheduleMode mode) override {
+        if (auto thread_pool = m_queue->get_thread_pool()) {
+            thread_pool->set_schedule_mode(mode);
+        }
+    }
 };
 
 //! implementation of InplaceCPUDispatcher
@@ -460,6 +567,12 @@ public:
             affinity_cb(0);
         }
     }
+
+    void set_schedule_mode(ThreadPoolScheduleMode mode) override {
+        if (m_thread_pool) {
+            m_thread_pool->set_schedule_mode(mode);
+        }
+    }
 };
 
 //! ==================== CompNodeDefaultImpl ======================
@@ -493,6 +606,7 @@ public:
                 "CompNodeNoRecorder is only constructed On DEVICE_CPU_DEFAULT");
         auto cn = make_comp_node_from_impl(this);
         m_env.init_cpu({std::make_shared<InplaceCPUDispatcher>(this)}, cn);
+        init_mem_alloc();
         sm_default_cpu_comp_node_ptr = this;
     }
 
@@ -519,10 +633,10 @@ public:
 
     void free_device(void* ptr) {
         if (check_global_finalized("free_device()")) {
-            CompNodeBaseImpl::mgb_aligned_free(ptr);
+            CompNodeBaseImpl::free_device_mem(ptr);
             return;
         } else {
-            auto do_free = [ptr]() { CompNodeBaseImpl::mgb_aligned_free(ptr); };
+            auto do_free = [ptr]() { CompNodeBaseImpl::free_device_mem(ptr); };
             m_env.cpu_env().dispatch(do_free);
         }
     }
@@ -623,6 +737,13 @@ public:
             m_thread_pool = std::shared_ptr<ThreadPool>(
                     new ThreadPool(static_cast<size_t>(locator.nr_threads)));
             mgb_assert(m_thread_pool, "ThradPool create failed");
+#if !defined(ANDROID) && !defined(__ANDROID__)
+            if (locator.numa_node >= 0) {
+                int numa_node = locator.numa_node;
+                m_thread_pool->set_affinity(
+                        [numa_node](size_t) { set_numa_node_affinity(numa_node); });
+            }
+#endif
         }
         if (locator.type == DeviceType::CPU) {
             if (locator.device == Locator::DEVICE_CPU_DEFAULT) {
@@ -646,6 +767,7 @@ public:
                         cn);
             }
         }
+        init_mem_alloc();
     }
 
     ~CompNodeRecorderImpl() {
@@ -690,13 +812,13 @@ public:
 
     void free_device(void* ptr) {
         if (sm_cur_recorder || check_global_finalized("free_device()")) {
-            CompNodeBaseImpl::mgb_aligned_free(ptr);
+            CompNodeBaseImpl::free_device_mem(ptr);
             if (sm_cur_recorder) {
                 sm_cur_recorder->on_free(this);
             }
             return;
         } else {
-            auto do_free = [ptr]() { CompNodeBaseImpl::mgb_aligned_free(ptr); };
+            auto do_free = [ptr]() { CompNodeBaseImpl::free_device_mem(ptr); };
             m_env.cpu_env().dispatch(do_free);
         }
     }
@@ -920,6 +1042,10 @@ CpuCompNode::Impl* CpuCompNode::load_cpu(Locator locator, Locator locator_logica
             pqueue = std::make_shared<WorkerQueue>(locator);
             pqueue_weak = pqueue;
         }
+        mgb_assert(
+                pqueue->locator().numa_node == locator.numa_node,
+                "worker thread of %s is already placed on numa node %d",
+                locator.to_string().c_str(), pqueue->locator().numa_node);
         auto&& pimpl = sm_pool->locator2impl[{locator, locator_logical}];
         if (!pimpl) {
             mgb_assert(
@@ -939,6 +1065,10 @@ CpuCompNode::Impl* CpuCompNode::load_cpu(Locator locator, Locator locator_logica
             pqueue = std::make_shared<WorkerQueue>(locator);
             pqueue_weak = pqueue;
         }
+        mgb_assert(
+                pqueue->locator().numa_node == locator.numa_node,
+                "worker thread of %s is already placed on numa node %d",
+                locator.to_string().c_str(), pqueue->locator().numa_node);
         auto&& pimpl = sm_pool->locator2impl_multi_thread[{locator, locator_logical}];
         if (!pimpl) {
             mgb_assert(
@@ -953,6 +1083,23 @@ CpuCompNode::Impl* CpuCompNode::load_cpu(Locator locator, Locator locator_logica
     }
 }
 
+void CpuCompNode::try_coalesce_all_free_memory() {
+    size_t size = 0;
+    if (auto cn = CompNodeDefaultImpl::sm_default_cpu_comp_node_ptr) {
+        size += cn->trim_mem_alloc();
+    }
+    if (sm_pool) {
+        MGB_LOCK_GUARD(sm_pool->mtx);
+        for (auto&& i : sm_pool->locator2impl)
+            size += i.second->trim_mem_alloc();
+        for (auto&& i : sm_pool->locator2impl_multi_thread)
+            size += i.second->trim_mem_alloc();
+    }
+    if (size) {
+        mgb_log_debug("%zu bytes freed by try_coalesce_all_free_memory()", size);
+    }
+}
+
 void CpuCompNode::sync_all() {
     if (!sm_pool)
         return;
@@ -61,6 +61,7 @@ public:
     static void finalize();
     static size_t get_device_count();
     static Impl* load_cpu(Locator locator, Locator locator_logical);
+    static void try_coalesce_all_free_memory();
     static void sync_all();
 };
 
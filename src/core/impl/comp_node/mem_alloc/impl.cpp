@@ -15,6 +15,8 @@
 #include "megbrain/utils/arith_helper.h"
 
 #include <algorithm>
+#include <functional>
+#include <thread>
 
 using namespace mgb;
 using namespace mem_alloc;
@@ -489,4 +491,271 @@ FreeMemStat SimpleCachingAllocImpl::get_free_memory_dev() {
     return get_free_memory();
 }
 
+/* ===================== CpuCachingAllocImpl ===================== */
+constexpr size_t CpuCachingAllocImpl::MAX_SMALL_SIZE;
+constexpr size_t CpuCachingAllocImpl::NR_SIZE_CLASS;
+constexpr size_t CpuCachingAllocImpl::NR_SHARD;
+constexpr size_t CpuCachingAllocImpl::SHARD_CACHE_LIMIT;
+constexpr size_t CpuCachingAllocImpl::MIN_CHUNK_SIZE;
+constexpr size_t CpuCachingAllocImpl::MAX_CHUNK_SIZE;
+
+CpuCachingAlloc::UniquePtr CpuCachingAlloc::make(
+        std::unique_ptr<RawAllocator> raw_alloc, size_t alignment) {
+    return UniquePtr{new CpuCachingAllocImpl(std::move(raw_alloc), alignment)};
+}
+
+void CpuCachingAlloc::free(void* ptr) {
+    auto block = static_cast<CpuCachingAllocImpl::BlockHeader*>(ptr) - 1;
+    block->owner->free_block(block);
+}
+
+size_t CpuCachingAllocImpl::size_class(size_t size) {
+    if (size <= 256) {
+        return 0;
+    }
+    // size is in (2^p, 2^(p+1)], which is divided into 4 classes
+    size_t p = 0;
+    while ((size - 1) >> (p + 1)) {
+        ++p;
+    }
+    return (p - 8) * 4 + ((size - 1 - (1_z << p)) >> (p - 2)) + 1;
+}
+
+size_t CpuCachingAllocImpl::class_size(size_t size_class) {
+    if (!size_class) {
+        return 256;
+    }
+    size_t p = 8 + (size_class - 1) / 4, k = (size_class - 1) % 4;
+    return (1_z << p) + ((k + 1) << (p - 2));
+}
+
+CpuCachingAllocImpl::CpuCachingAllocImpl(
+        std::unique_ptr<RawAllocator> raw_alloc, size_t alignment)
+        : m_alignment(std::max<size_t>(alignment, 64)),
+          m_raw_alloc(std::move(raw_alloc)),
+          m_shards(new Shard[NR_SHARD]) {
+    mgb_assert(alignment && !(alignment & (alignment - 1)));
+    static_assert(sizeof(BlockHeader) <= 64, "block header too large");
+}
+
+CpuCachingAllocImpl::~CpuCachingAllocImpl() {
+    for (auto&& i : m_alloc_from_raw) {
+        m_raw_alloc->free(i.first);
+    }
+}
+
+CpuCachingAllocImpl::Shard& CpuCachingAllocImpl::cur_shard() {
+#if MGB_HAVE_THREAD
+    // thread ids are usually addresses, so mix the bits before taking the
+    // high bits
+    uint64_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return m_shards[(hash * 0x9E3779B97F4A7C15ull) >> 61];
+#else
+    return m_shards[0];
+#endif
+}
+
+CpuCachingAllocImpl::BlockHeader* CpuCachingAllocImpl::take_cached(
+        size_t size_class) {
+    auto take = [size_class](Shard& shard) -> BlockHeader* {
+        auto&& blocks = shard.blocks[size_class];
+        if (blocks.empty()) {
+            return nullptr;
+        }
+        auto ret = blocks.back();
+        blocks.pop_back();
+        shard.cached_size -= ret->size;
+        return ret;
+    };
+    auto&& own = cur_shard();
+    {
+        MGB_LOCK_GUARD(own.mtx);
+        if (auto ret = take(own)) {
+            return ret;
+        }
+    }
+    // blocks are usually freed on the worker thread and allocated on the
+    // caller thread, so try the caches of other threads without waiting
+    for (size_t i = 0; i < NR_SHARD; ++i) {
+        auto&& shard = m_shards[i];
+        if (&shard != &own && shard.mtx.try_lock()) {
+            auto ret = take(shard);
+            shard.mtx.unlock();
+            if (ret) {
+                return ret;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool CpuCachingAllocImpl::put_cached(BlockHeader* block) {
+    auto&& shard = cur_shard();
+    MGB_LOCK_GUARD(shard.mtx);
+    if (shard.cached_size + block->size > SHARD_CACHE_LIMIT) {
+        return false;
+    }
+    shard.blocks[block->size_class].push_back(block);
+    shard.cached_size += block->size;
+    return true;
+}
+
+void CpuCachingAllocImpl::flush_cache() {
+    std::vector<BlockHeader*> blocks;
+    for (size_t i = 0; i < NR_SHARD; ++i) {
+        auto&& shard = m_shards[i];
+        MGB_LOCK_GUARD(shard.mtx);
+        for (auto&& j : shard.blocks) {
+            blocks.insert(blocks.end(), j.begin(), j.end());
+            j.clear();
+        }
+        shard.cached_size = 0;
+    }
+    MGB_LOCK_GUARD(m_mutex);
+    for (auto i : blocks) {
+        auto addr = reinterpret_cast<size_t>(i + 1) - m_alignment;
+        merge_free_unsafe({MemAddr{i->is_head, addr}, i->size});
+    }
+}
+
+void* CpuCachingAllocImpl::alloc(size_t size) {
+    size_t blk_size = get_aligned_power2(size, m_alignment) + m_alignment;
+    size_t cls = NR_SIZE_CLASS;
+    BlockHeader* block = nullptr;
+    if (blk_size <= MAX_SMALL_SIZE) {
+        cls = size_class(blk_size);
+        blk_size = get_aligned_power2(class_size(cls), m_alignment);
+        block = take_cached(cls);
+    }
+    if (block) {
+        m_nr_cache_hit.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        auto addr = do_alloc(blk_size, true);
+        block = reinterpret_cast<BlockHeader*>(addr.addr + m_alignment) - 1;
+        block->owner = this;
+        block->size = blk_size;
+        block->size_class = cls;
+        block->is_head = addr.is_head;
+    }
+    m_nr_ref.fetch_add(1, std::memory_order_relaxed);
+    m_nr_alloc.fetch_add(1, std::memory_order_relaxed);
+    m_used_size.fetch_add(blk_size, std::memory_order_relaxed);
+    return block + 1;
+}
+
+void CpuCachingAllocImpl::free_block(BlockHeader* block) {
+    mgb_assert(block->owner == this, "releasing bad pointer: %p", block + 1);
+    m_used_size.fetch_sub(block->size, std::memory_order_relaxed);
+    if (block->size_class >= NR_SIZE_CLASS || !put_cached(block)) {
+        auto addr = reinterpret_cast<size_t>(block + 1) - m_alignment;
+        MGB_LOCK_GUARD(m_mutex);
+        merge_free_unsafe({MemAddr{block->is_head, addr}, block->size});
+    }
+    unref();
+}
+
+void CpuCachingAllocImpl::unref() {
+    if (m_nr_ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+void CpuCachingAllocImpl::release() {
+    trim();
+    unref();
+}
+
+CpuCachingAllocImpl::MemAddr CpuCachingAllocImpl::alloc_from_parent(size_t size) {
+    size_t chunk_size;
+    {
+        MGB_LOCK_GUARD(m_mutex);
+        chunk_size = std::max(
+                size, std::min(
+                              std::max(m_tot_allocated_from_raw, MIN_CHUNK_SIZE),
+                              MAX_CHUNK_SIZE));
+    }
+    auto ptr = m_raw_alloc->alloc(chunk_size);
+    if (!ptr && chunk_size > size) {
+        chunk_size = size;
+        ptr = m_raw_alloc->alloc(chunk_size);
+    }
+    if (!ptr) {
+        auto get = trim();
+        MGB_MARK_USED_VAR(get);
+        mgb_log("could not allocate %zu bytes on CPU; release cached chunks and "
+                "try again: got %.2fMiB(%zu bytes).",
+                size, get / 1024.0 / 1024, get);
+        ptr = m_raw_alloc->alloc(chunk_size);
+        mgb_throw_if(
+                !ptr, MemAllocError, "out of memory while requesting %zu bytes on CPU",
+                size);
+    }
+    m_nr_raw_alloc.fetch_add(1, std::memory_order_relaxed);
+
+    MGB_LOCK_GUARD(m_mutex);
+    m_alloc_from_raw[ptr] = chunk_size;
+    auto ptr_int = reinterpret_cast<size_t>(ptr);
+    if (chunk_size > size) {
+        insert_free_unsafe({MemAddr{false, ptr_int + size}, chunk_size - size});
+    }
+    m_tot_allocated_from_raw += chunk_size;
+    return {true, ptr_int};
+}
+
+size_t CpuCachingAllocImpl::trim() {
+    flush_cache();
+
+    size_t free_size = 0;
+    std::vector<void*> to_free_by_raw;
+    {
+        MGB_LOCK_GUARD(m_mutex);
+        using Iter = decltype(m_free_blk_size.begin());
+        for (Iter i = m_free_blk_size.begin(), inext; i != m_free_blk_size.end();
+             i = inext) {
+            inext = i;
+            ++inext;
+            auto&& blk = i->first;
+            if (blk.addr.is_head) {
+                auto riter = m_alloc_from_raw.find(blk.addr.addr_ptr());
+                mgb_assert(
+                        riter != m_alloc_from_raw.end() && blk.size <= riter->second);
+                if (blk.size == riter->second) {
+                    to_free_by_raw.push_back(blk.addr.addr_ptr());
+                    free_size += blk.size;
+                    auto j = i->second.aiter;
+                    m_free_blk_size.erase(i);
+                    m_free_blk_addr.erase(j);
+                    m_alloc_from_raw.erase(riter);
+                }
+            }
+        }
+        m_tot_allocated_from_raw -= free_size;
+    }
+
+    // all the blocks in the free list have been freed by the worker thread,
+    // so no kernel could still use them
+    for (auto i : to_free_by_raw) {
+        m_raw_alloc->free(i);
+    }
+    return free_size;
+}
+
+CpuCachingAlloc::Stat CpuCachingAllocImpl::get_stat() {
+    Stat stat;
+    stat.cached = 0;
+    for (size_t i = 0; i < NR_SHARD; ++i) {
+        MGB_LOCK_GUARD(m_shards[i].mtx);
+        stat.cached += m_shards[i].cached_size;
+    }
+    {
+        MGB_LOCK_GUARD(m_mutex);
+        stat.reserved = m_tot_allocated_from_raw;
+    }
+    stat.used = m_used_size.load(std::memory_order_relaxed);
+    stat.nr_alloc = m_nr_alloc.load(std::memory_order_relaxed);
+    stat.nr_cache_hit = m_nr_cache_hit.load(std::memory_order_relaxed);
+    stat.nr_raw_alloc = m_nr_raw_alloc.load(std::memory_order_relaxed);
+    return stat;
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
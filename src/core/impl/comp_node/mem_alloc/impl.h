@@ -12,9 +12,11 @@
 #pragma once
 
 #include "megbrain/comp_node/alloc.h"
+#include "megbrain/utils/thread.h"
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <set>
 #include <unordered_map>
 #include <vector>
@@ -247,6 +249,94 @@ protected:
     std::string get_name() const override;
 };
 
+class CpuCachingAllocImpl final : public CpuCachingAlloc, public MemAllocImplHelper {
+public:
+    /*!
+     * \brief header placed before each allocated block
+     *
+     * The first m_alignment bytes of a block are reserved, and the header is
+     * put right before the address returned by alloc(); size includes the
+     * reserved bytes.
+     */
+    struct BlockHeader {
+        CpuCachingAllocImpl* owner;
+        size_t size;
+        //! NR_SIZE_CLASS for blocks that are not cached
+        uint32_t size_class;
+        bool is_head;
+    };
+
+    //! blocks larger than this are not cached
+    static constexpr size_t MAX_SMALL_SIZE = 1024 * 1024;
+    //! classes of 256 bytes and 4 classes per power of 2 up to MAX_SMALL_SIZE
+    static constexpr size_t NR_SIZE_CLASS = 49;
+    static constexpr size_t NR_SHARD = 8;
+    //! max total size of blocks cached in a shard
+    static constexpr size_t SHARD_CACHE_LIMIT = 8 * 1024 * 1024;
+    static constexpr size_t MIN_CHUNK_SIZE = 4 * 1024 * 1024,
+                            MAX_CHUNK_SIZE = 64 * 1024 * 1024;
+
+    static size_t size_class(size_t size);
+    static size_t class_size(size_t size_class);
+
+private:
+    struct Shard {
+        Spinlock mtx;
+        //! headers of cached blocks of each size class
+        std::vector<BlockHeader*> blocks[NR_SIZE_CLASS];
+        size_t cached_size = 0;
+    };
+
+    const size_t m_alignment;
+    std::unique_ptr<RawAllocator> m_raw_alloc;
+    std::unique_ptr<Shard[]> m_shards;
+
+    //! chunks from raw alloc, addr to size
+    std::unordered_map<void*, size_t> m_alloc_from_raw;
+    size_t m_tot_allocated_from_raw = 0;
+
+    //! number of live blocks, plus one if not released by the owner
+    std::atomic_size_t m_nr_ref{1};
+    std::atomic_size_t m_used_size{0}, m_nr_alloc{0}, m_nr_cache_hit{0},
+            m_nr_raw_alloc{0};
+
+    ~CpuCachingAllocImpl();
+
+    Shard& cur_shard();
+
+    //! take a cached block of the size class; return nullptr if none
+    BlockHeader* take_cached(size_t size_class);
+
+    //! put a block into the cache of current thread; return whether succeeded
+    bool put_cached(BlockHeader* block);
+
+    //! move all cached blocks to the free list
+    void flush_cache();
+
+    void unref();
+
+    MemAddr alloc_from_parent(size_t size) override;
+
+    std::string get_name() const override { return "cpu caching allocator"; }
+
+    void release() override;
+
+public:
+    CpuCachingAllocImpl(std::unique_ptr<RawAllocator> raw_alloc, size_t alignment);
+
+    void* alloc(size_t size) override;
+
+    void free_block(BlockHeader* block);
+
+    size_t trim() override;
+
+    Stat get_stat() override;
+
+    size_t get_used_memory() override { return m_used_size.load(); }
+
+    FreeMemStat get_free_memory_dev() override { return get_free_memory(); }
+};
+
 }  // namespace mem_alloc
 }  // namespace mgb
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
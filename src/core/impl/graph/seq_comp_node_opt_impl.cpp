@@ -13,16 +13,28 @@
 #include "./cg_impl.h"
 #include "./var_node_mem_mgr.h"
 
+#include "megbrain/plugin/opr_footprint.h"
+
+#include <algorithm>
 #include <queue>
 
 using namespace mgb;
 using namespace cg;
 
+namespace {
+//! max number of lanes that distribute_cpu_branches() splits a graph into
+constexpr size_t MAX_NR_CPU_LANE = 64;
+//! lane i of a CPU comp node on device d runs on device
+//! CPU_LANE_DEVICE_BASE + d * MAX_NR_CPU_LANE + i, which are not used otherwise
+constexpr int CPU_LANE_DEVICE_BASE = 1 << 20;
+}  // anonymous namespace
+
 void SeqCompNodeOptimizerImpl::optimize_comp_nodes(const VarNodeArray& endpoints) {
     mgb_assert(
             m_comp_node_to_restore.empty() && m_comp_node_changed_oprs.empty(),
             "restore_comp_nodes not called");
     change_to_specific_stream(endpoints);
+    distribute_cpu_branches(endpoints);
 
     for (auto&& i : m_comp_node_to_restore) {
         auto opr = i.first->owner_opr();
@@ -173,6 +185,208 @@ void SeqCompNodeOptimizerImpl::change_to_specific_stream(
     }
 }
 
+void SeqCompNodeOptimizerImpl::distribute_cpu_branches(const VarNodeArray& endpoints) {
+    auto&& options = m_owner_graph->options();
+    size_t max_nr_lane = options.seq_opt.cpu_inter_op_parallelism;
+    if (max_nr_lane <= 1 || !options.seq_opt.enable_seq_comp_node_opt ||
+        options.comp_node_seq_record_level) {
+        return;
+    }
+
+    OprNodeArray oprs;
+    CompNode::UnorderedSet comp_nodes;
+    DepOprIter dep_iter{[&](OperatorNodeBase* opr) {
+        oprs.push_back(opr);
+        for (auto i : opr->output()) {
+            comp_nodes.insert(i->comp_node());
+        }
+    }};
+    for (auto i : endpoints) {
+        dep_iter.add(i->owner_opr());
+    }
+
+    // only the graphs on a single CPU comp node with its own worker thread are
+    // handled; inplace comp nodes run on the caller thread
+    if (comp_nodes.size() != 1) {
+        return;
+    }
+    auto cn = *comp_nodes.begin();
+    auto locator = cn.locator();
+    using DeviceType = CompNode::DeviceType;
+    bool multithread = locator.type == DeviceType::MULTITHREAD;
+    if ((locator.type != DeviceType::CPU && !multithread) || locator.device < 0) {
+        return;
+    }
+    max_nr_lane = std::min(max_nr_lane, MAX_NR_CPU_LANE);
+    if (multithread) {
+        max_nr_lane = std::min<size_t>(max_nr_lane, locator.nr_threads);
+    }
+
+    using NodeProp = OperatorNodeBase::NodeProp;
+    auto movable = [](OperatorNodeBase* opr) {
+        // oprs without input (e.g. the holders of persistent values) are cheap
+        // and are kept on the original comp node
+        if (opr->input().empty() ||
+            opr->node_prop().contain(NodeProp::Flag::DISALLOW_COMP_NODE_OPTIMIZE)) {
+            return false;
+        }
+        for (auto i : opr->output()) {
+            if (i->contain_flag(
+                        VarNode::Flag::PERSISTENT_DEVICE_VALUE |
+                        VarNode::Flag::NO_SYS_MEM_ALLOC)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // the cost is the number of output elements, or the computation given by
+    // OprFootprint if it is larger; shapes are statically inferred at this time
+    OprFootprint footprint;
+    auto get_cost = [&](OperatorNodeBase* opr) {
+        uint64_t cost = 1;
+        bool shape_valid = true;
+        for (auto i : opr->input()) {
+            shape_valid &= i->shape().ndim > 0;
+        }
+        for (auto i : opr->output()) {
+            if (!i->shape().ndim) {
+                shape_valid = false;
+            } else if (!i->contain_flag(VarNode::Flag::VOLATILE_CONTENT)) {
+                cost += i->shape().total_nr_elems();
+            }
+        }
+        if (shape_valid) {
+            cost = std::max(cost, footprint.get_computation(opr));
+        }
+        return cost;
+    };
+
+    // estimated cost of waiting for an opr on another comp node, in the same
+    // unit as the opr cost
+    constexpr uint64_t SYNC_COST = 1 << 16;
+
+    // list scheduling: in topological order, each opr is assigned to the lane
+    // on which it can start the earliest
+    struct OprSchedule {
+        size_t lane;
+        uint64_t finish;
+    };
+    ThinHashMap<OperatorNodeBase*, OprSchedule> opr2schedule;
+    std::vector<uint64_t> lane_free(max_nr_lane, 0), lane_load(max_nr_lane, 0);
+    std::vector<uint64_t> lane_ready(max_nr_lane);
+    for (auto opr : oprs) {
+        std::fill(lane_ready.begin(), lane_ready.end(), 0);
+        uint64_t ready_other = 0;
+        for (auto i : opr->input()) {
+            auto iter = opr2schedule.find(i->owner_opr());
+            if (iter == opr2schedule.end()) {
+                continue;
+            }
+            auto&& dep = iter->second;
+            lane_ready[dep.lane] = std::max(lane_ready[dep.lane], dep.finish);
+            ready_other = std::max(ready_other, dep.finish + SYNC_COST);
+        }
+        size_t lane = 0;
+        uint64_t start = std::numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < (movable(opr) ? max_nr_lane : 1); ++i) {
+            // deps on other lanes must be waited for
+            uint64_t ready = lane_ready[i];
+            for (size_t j = 0; j < max_nr_lane; ++j) {
+                if (j != i && lane_ready[j]) {
+                    ready = std::max(ready, ready_other);
+                    break;
+                }
+            }
+            ready = std::max(ready, lane_free[i]);
+            if (ready < start) {
+                start = ready;
+                lane = i;
+            }
+        }
+        auto cost = get_cost(opr);
+        lane_free[lane] = start + cost;
+        lane_load[lane] += cost;
+        opr2schedule[opr] = {lane, start + cost};
+    }
+
+    size_t nr_lane = 0;
+    for (size_t i = 0; i < max_nr_lane; ++i) {
+        nr_lane += lane_load[i] != 0;
+    }
+    if (nr_lane <= 1) {
+        return;
+    }
+
+    // the lanes run on a dedicated range of devices, which are not bound to
+    // cpu cores like the original device. A plain CPU comp node keeps lane 0,
+    // and each of the other lanes gets its own worker thread. The threads of a
+    // multithread comp node are split between all the lanes in proportion to
+    // their loads, so that no more than nr_threads threads are busy; the
+    // original comp node then only runs the oprs that can not be moved.
+    SmallVector<int> lane_nr_threads(max_nr_lane, 0);
+    if (multithread) {
+        // each lane gets at least one thread and the rest are assigned by the
+        // largest remainder of their shares
+        uint64_t tot_load = 0;
+        for (auto i : lane_load) {
+            tot_load += i;
+        }
+        int nr_spare = locator.nr_threads - static_cast<int>(nr_lane);
+        int nr_assigned = 0;
+        SmallVector<std::pair<double, size_t>> remainder;
+        for (size_t i = 0; i < max_nr_lane; ++i) {
+            if (!lane_load[i]) {
+                continue;
+            }
+            double share = static_cast<double>(lane_load[i]) * nr_spare / tot_load;
+            int extra = static_cast<int>(share);
+            lane_nr_threads[i] = 1 + extra;
+            nr_assigned += extra;
+            remainder.emplace_back(share - extra, i);
+        }
+        std::stable_sort(
+                remainder.begin(), remainder.end(),
+                [](const std::pair<double, size_t>& x,
+                   const std::pair<double, size_t>& y) { return x.first > y.first; });
+        for (size_t i = 0; nr_assigned < nr_spare; ++i, ++nr_assigned) {
+            ++lane_nr_threads[remainder[i].second];
+        }
+    }
+
+    SmallVector<CompNode> lane_cn(max_nr_lane);
+    for (size_t i = 0; i < max_nr_lane; ++i) {
+        if (!lane_load[i]) {
+            continue;
+        }
+        if (!i && !multithread) {
+            lane_cn[i] = cn;
+            continue;
+        }
+        auto loc = locator, loc_logical = cn.locator_logical();
+        loc.device = loc_logical.device = static_cast<int>(
+                CPU_LANE_DEVICE_BASE + locator.device * MAX_NR_CPU_LANE + i);
+        if (multithread) {
+            loc.nr_threads = loc_logical.nr_threads = lane_nr_threads[i];
+        }
+        lane_cn[i] = CompNode::load(loc, loc_logical);
+    }
+
+    for (auto opr : oprs) {
+        auto new_cn = lane_cn[opr2schedule.at(opr).lane];
+        if (new_cn == cn || !movable(opr)) {
+            continue;
+        }
+        for (auto i : opr->output()) {
+            m_comp_node_to_restore.emplace_back(i, cn);
+            i->comp_node(new_cn);
+        }
+    }
+    mgb_log_debug(
+            "distributed oprs on %s to %zu comp nodes for inter-op parallelism",
+            cn.to_string().c_str(), nr_lane);
+}
+
 void SeqCompNodeOptimizerImpl::register_stream_var(
         VarNode* var, StreamPropType stream_prop_type) {
     int stream = stream_prop_type.stream;
@@ -44,6 +44,14 @@ class SeqCompNodeOptimizerImpl final : public SeqCompNodeOptimizer {
     //! m_comp_node_to_restore
     void var_to_specific_stream(VarNode* var, const int stream);
 
+    /*!
+     * \brief distribute independent branches of a graph on a single CPU comp
+     *      node to multiple CPU comp nodes, so they can run concurrently
+     *
+     * See ComputingGraph::Options::SeqOpt::cpu_inter_op_parallelism
+     */
+    void distribute_cpu_branches(const VarNodeArray& endpoints);
+
 public:
     SeqCompNodeOptimizerImpl(ComputingGraphImpl* graph) : m_owner_graph(graph) {}
 
@@ -17,6 +17,7 @@
 #include "megbrain/graph/exc_extra_info.h"
 #include "megbrain/graph/helper.h"
 #include "megbrain/utils/arith_helper.h"
+#include "megbrain/utils/hash.h"
 #include "megbrain/utils/metahelper.h"
 
 using namespace mgb;
@@ -168,6 +169,150 @@ bool SeqMemOptimizer::plan_chunk_allocation() {
 }
 
 bool SeqMemOptimizer::run_static_mem_alloc() {
+    StaticMemPlan plan;
+    Chunk2Id chunk2id;
+    std::vector<MemAllocPlan::Chunk*> chunks;
+    init_static_mem_plan_key(plan, chunk2id, chunks);
+
+    bool plan_reused = false;
+#ifndef __IN_TEE_ENV__
+    // the recorder needs the intervals, so the plan is always solved
+    if (!StaticMemRecorder::Instance().valid())
+#endif
+    {
+        // the plan is removed from the cache if found, and saved again at the
+        // end
+        plan_reused = take_static_mem_plan(plan);
+    }
+    if (!plan_reused) {
+        solve_static_mem_plan(plan, chunk2id);
+    }
+    {
+        // force release memory
+        decltype(chunk2id) v;
+        chunk2id.swap(v);
+    }
+
+    StaticMemAllocLogger::FakeImpl fake_logger;
+#if MGB_ENABLE_LOGGING
+    StaticMemAllocLogger::LogImpl real_logger;
+    StaticMemAllocLogger* logger =
+            m_graph->options().log_level
+                    ? static_cast<StaticMemAllocLogger*>(&real_logger)
+                    : static_cast<StaticMemAllocLogger*>(&fake_logger);
+#else
+    StaticMemAllocLogger* logger = &fake_logger;
+#endif
+
+    bool ret = false;
+    CompNode::UnorderedSet cn_applied;
+    for (auto&& usage : plan.usages) {
+        logger->push(usage.comp_node, usage.size, usage.size_lb, usage.size_ub);
+
+        bool should_realloc = false;
+        m_graph->event().signal_inplace<event::StaticMemAlloc>(
+                &should_realloc, usage.comp_node, usage.size, plan_reused);
+        if (should_realloc) {
+            ret = true;
+        } else {
+            m_static_mem_usage.val()[usage.comp_node] = usage.size;
+            cn_applied.insert(usage.comp_node);
+        }
+    }
+    logger->flush();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (cn_applied.count(chunks[i]->owner_var->comp_node())) {
+            chunks[i]->mem_alloc_status.set_static_offset(plan.offsets[i]);
+        }
+    }
+
+    // trigger event for other comp nodes
+    for (auto i : m_all_comp_nodes) {
+        bool found = false;
+        for (auto&& usage : plan.usages) {
+            found |= usage.comp_node == i;
+        }
+        if (!found) {
+            bool need_realloc = false;
+            m_graph->event().signal_inplace<event::StaticMemAlloc>(
+                    &need_realloc, i, static_cast<size_t>(0), false);
+            ret |= need_realloc;
+        }
+    }
+
+    m_graph->event().signal_inplace<event::StaticMemAlloc>(
+            nullptr, CompNode{}, static_cast<size_t>(0), false);
+
+    save_static_mem_plan(std::move(plan));
+    return ret;
+}
+
+void SeqMemOptimizer::init_static_mem_plan_key(
+        StaticMemPlan& plan, Chunk2Id& chunk2id,
+        std::vector<MemAllocPlan::Chunk*>& chunks) {
+    auto search_time = m_graph->options().seq_opt.mem_reuse_alloc_search_time;
+    auto&& key = plan.key;
+    key.reserve(m_cur_static_alloc_var->size() * 2 +
+                m_writable_fwd_mem_plans.size() * 3 + 1);
+    key.push_back(static_cast<size_t>(search_time * 1e6));
+
+    // the owner var of a chunk is always visited before the vars that the
+    // chunk is forwarded to
+    for (auto opr : *m_cur_seq_sys_alloc) {
+        for (VarNode* i : opr->output()) {
+            if (!should_static_alloc_var(i))
+                continue;
+            auto chk = &i->mem_plan().chunk();
+            auto ins_rst = chunk2id.emplace(chk, chunks.size());
+            if (ins_rst.second) {
+                mgb_assert(chk->owner_var == i);
+                chunks.push_back(chk);
+            }
+            key.push_back(ins_rst.first->second);
+            key.push_back(chk->size());
+        }
+    }
+
+    for (auto&& i : m_writable_fwd_mem_plans) {
+        auto from_iter = chunk2id.find(&i.first->chunk()),
+             to_iter = chunk2id.find(&i.second->chunk());
+        if (from_iter != chunk2id.end() && to_iter != chunk2id.end()) {
+            key.push_back(to_iter->second);
+            key.push_back(from_iter->second);
+            key.push_back(i.first->offset_in_chunk_byte());
+        }
+    }
+
+    plan.hash = XXHash{}.update(key.data(), key.size() * sizeof(size_t)).digest();
+}
+
+bool SeqMemOptimizer::take_static_mem_plan(StaticMemPlan& plan) {
+    for (auto iter = m_static_mem_plan_cache.begin();
+         iter != m_static_mem_plan_cache.end(); ++iter) {
+        if (iter->hash == plan.hash && iter->key == plan.key) {
+            plan.offsets = std::move(iter->offsets);
+            plan.usages = std::move(iter->usages);
+            m_static_mem_plan_cache.erase(iter);
+            return true;
+        }
+    }
+    return false;
+}
+
+void SeqMemOptimizer::save_static_mem_plan(StaticMemPlan plan) {
+    auto capacity = m_graph->options().seq_opt.static_mem_plan_cache_size;
+    if (!capacity) {
+        m_static_mem_plan_cache.clear();
+        return;
+    }
+    m_static_mem_plan_cache.emplace_front(std::move(plan));
+    while (m_static_mem_plan_cache.size() > capacity) {
+        m_static_mem_plan_cache.pop_back();
+    }
+}
+
+void SeqMemOptimizer::solve_static_mem_plan(
+        StaticMemPlan& plan, const Chunk2Id& chunk2id) {
     // map from chunk pointer to life interval
     // multiple var nodes share the same chunk pointer by readonly memory
     // forwarding
@@ -256,50 +401,28 @@ bool SeqMemOptimizer::run_static_mem_alloc() {
         chk2interval.swap(v);
     }
 
-    StaticMemAllocLogger::FakeImpl fake_logger;
-#if MGB_ENABLE_LOGGING
-    StaticMemAllocLogger::LogImpl real_logger;
-    StaticMemAllocLogger* logger =
-            m_graph->options().log_level
-                    ? static_cast<StaticMemAllocLogger*>(&real_logger)
-                    : static_cast<StaticMemAllocLogger*>(&fake_logger);
-#else
-    StaticMemAllocLogger* logger = &fake_logger;
-#endif
-
-    bool ret = false;
+    plan.offsets.resize(chunk2id.size());
     for (auto&& i : group_by_cn) {
         auto cmp = [](const MemChunkLifeInterval& a, const MemChunkLifeInterval& b) {
             return a.begin < b.begin || (a.begin == b.begin && a.end < b.end);
         };
         // sort for stable order
         std::sort(i.second.begin(), i.second.end(), cmp);
-        ret |= run_static_mem_alloc_on_comp_node(i.first, i.second, *logger);
+        solve_static_mem_plan_on_comp_node(i.first, i.second, chunk2id, plan);
     }
-    logger->flush();
-
-    // trigger event for other comp nodes
-    for (auto i : m_all_comp_nodes) {
-        if (!group_by_cn.count(i)) {
-            bool need_realloc = false;
-            m_graph->event().signal_inplace<event::StaticMemAlloc>(
-                    &need_realloc, i, static_cast<size_t>(0));
-            ret |= need_realloc;
-        }
-    }
-
-    m_graph->event().signal_inplace<event::StaticMemAlloc>(
-            nullptr, CompNode{}, static_cast<size_t>(0));
-
-    return ret;
 }
 
-bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
+void SeqMemOptimizer::solve_static_mem_plan_on_comp_node(
         CompNode comp_node, const std::vector<MemChunkLifeInterval>& chunks,
-        StaticMemAllocLogger& static_mem_alloc_logger) {
-    size_t size_ub = 0;
-
-    auto allocator = StaticMemAlloc::make(StaticMemAlloc::AllocatorAlgo::PUSHDOWN);
+        const Chunk2Id& chunk2id, StaticMemPlan& plan) {
+    StaticMemPlan::Usage usage;
+    usage.comp_node = comp_node;
+
+    auto search_time = m_graph->options().seq_opt.mem_reuse_alloc_search_time;
+    auto algo = search_time > 0 ? StaticMemAlloc::AllocatorAlgo::BRANCH_BOUND
+                                : StaticMemAlloc::AllocatorAlgo::PUSHDOWN;
+    auto allocator = StaticMemAlloc::make(algo);
+    allocator->time_budget(search_time);
     allocator->alignment(comp_node.get_mem_addr_alignment());
     allocator->padding(comp_node.get_mem_padding());
 #if MGB_ENABLE_DEBUG_UTIL
@@ -307,12 +430,13 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
         return static_cast<const MemChunkLifeInterval*>(key)->chunk->owner_var;
     };
 #endif
+
     ThinHashMap<MemAllocPlan::Chunk*, size_t> chunk2allocatorid;
     for (auto&& chk : chunks) {
         auto id = allocator->add(chk.begin, chk.end, chk.chunk->size(), &chk);
         auto ins_rst = chunk2allocatorid.emplace(chk.chunk, id);
         mgb_assert(ins_rst.second);
-        size_ub += chk.chunk->size();
+        usage.size_ub += chk.chunk->size();
     }
 
     for (auto&& i : m_writable_fwd_mem_plans) {
@@ -333,33 +457,23 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
     }
 
     allocator->solve();
-    size_t size = allocator->tot_alloc(), size_lb = allocator->tot_alloc_lower_bound();
-
-    static_mem_alloc_logger.push(comp_node, size, size_lb, size_ub);
-
-    bool should_realloc = false;
-    m_graph->event().signal_inplace<event::StaticMemAlloc>(
-            &should_realloc, comp_node, size);
+    usage.size = allocator->tot_alloc();
+    usage.size_lb = allocator->tot_alloc_lower_bound();
+    for (auto&& chk : chunks) {
+        plan.offsets[chunk2id.at(chk.chunk)] = allocator->get_start_addr(&chk);
+    }
+    plan.usages.push_back(usage);
 
-    if (!should_realloc) {
-        m_static_mem_usage.val()[comp_node] = size;
-        for (auto&& chk : chunks) {
-            chk.chunk->mem_alloc_status.set_static_offset(
-                    allocator->get_start_addr(&chk));
-        }
 #ifndef __IN_TEE_ENV__
-        auto& recorder = StaticMemRecorder::Instance();
-        if (recorder.valid()) {
-            for (size_t i = 0; i < chunks.size(); i++) {
-                recorder.regist_memory_chunk_owner_var_name(
-                        i, chunks.at(i).chunk->owner_var->name());
-            }
-            recorder.regist_peak_mem_size(size);
+    auto& recorder = StaticMemRecorder::Instance();
+    if (recorder.valid()) {
+        for (size_t i = 0; i < chunks.size(); i++) {
+            recorder.regist_memory_chunk_owner_var_name(
+                    i, chunks.at(i).chunk->owner_var->name());
         }
-#endif
+        recorder.regist_peak_mem_size(usage.size);
     }
-
-    return should_realloc;
+#endif
 }
 
 void SeqMemOptimizer::reset_opr_seq(
@@ -371,6 +485,8 @@ void SeqMemOptimizer::reset_opr_seq(
     m_cur_static_alloc_var = static_alloc_var;
     m_all_comp_nodes = std::move(all_comp_nodes);
     m_static_mem_usage.invalidate();
+    // the cached plans refer to the chunks by their order in the sequence
+    m_static_mem_plan_cache.clear();
 }
 
 void SeqMemOptimizer::add_writable_fwd_mem_plan_pair(
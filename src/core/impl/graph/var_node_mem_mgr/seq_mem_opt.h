@@ -13,6 +13,8 @@
 
 #include "../impl_common.h"
 
+#include <list>
+
 namespace mgb {
 namespace cg {
 
@@ -33,6 +35,31 @@ class SeqMemOptimizer {
         CompNode comp_node;
     };
 
+    /*!
+     * \brief solved static allocation of all the chunks in current sequence
+     *
+     * The key is the signature of the allocation problem: the allocator
+     * settings, the chunk and its size for each statically allocated var in
+     * sequence order, and the writable forward specs. The life intervals of
+     * the chunks only depend on it for a given sequence, so when the shapes
+     * switch back to previously seen ones the plan is looked up without
+     * building the intervals or solving them again.
+     */
+    struct StaticMemPlan {
+        //! static memory usage on a comp node
+        struct Usage {
+            CompNode comp_node;
+            size_t size = 0, size_lb = 0, size_ub = 0;
+        };
+        uint64_t hash = 0;
+        std::vector<size_t> key;
+        //! offset of each chunk, in the order of their owner vars
+        std::vector<size_t> offsets;
+        SmallVector<Usage> usages;
+    };
+
+    using Chunk2Id = ThinHashMap<MemAllocPlan::Chunk*, size_t>;
+
     using CompNode2Chunkset = CompNode::UnorderedMap<ThinHashSet<MemAllocPlan::Chunk*>>;
 
     ComputingGraphImpl* m_graph;
@@ -46,6 +73,10 @@ class SeqMemOptimizer {
     size_t m_status = 0;
     std::vector<std::pair<MemAllocPlan*, MemAllocPlan*>> m_writable_fwd_mem_plans;
 
+    //! recently solved plans for current sequence, with the most recently
+    //! used one at the front
+    std::list<StaticMemPlan> m_static_mem_plan_cache;
+
     bool should_static_alloc_var(VarNode* var);
 
     bool in_sys_alloc(OperatorNodeBase* opr) const {
@@ -55,10 +86,34 @@ class SeqMemOptimizer {
     //! return as alloc_mem_chunk_storage
     bool run_static_mem_alloc();
 
-    //! return as alloc_mem_chunk_storage
-    bool run_static_mem_alloc_on_comp_node(
+    /*!
+     * \brief setup the key of \p plan and number the chunks to be
+     *      allocated in the order of their owner vars
+     */
+    void init_static_mem_plan_key(
+            StaticMemPlan& plan, Chunk2Id& chunk2id,
+            std::vector<MemAllocPlan::Chunk*>& chunks);
+
+    /*!
+     * \brief find a cached plan with the same key as \p plan, and move its
+     *      offsets and usages into \p plan
+     *
+     * The cached plan is removed; it should be put back by
+     * save_static_mem_plan() to become the most recently used one.
+     *
+     * \return whether the plan is found
+     */
+    bool take_static_mem_plan(StaticMemPlan& plan);
+
+    //! add a solved plan to the cache, evicting the least recently used one
+    void save_static_mem_plan(StaticMemPlan plan);
+
+    //! compute chunk life intervals and solve the allocation on each comp node
+    void solve_static_mem_plan(StaticMemPlan& plan, const Chunk2Id& chunk2id);
+
+    void solve_static_mem_plan_on_comp_node(
             CompNode cn, const std::vector<MemChunkLifeInterval>& chunks,
-            StaticMemAllocLogger& static_mem_alloc_logger);
+            const Chunk2Id& chunk2id, StaticMemPlan& plan);
 
 public:
     SeqMemOptimizer(ComputingGraphImpl* graph) : m_graph(graph) {}
@@ -40,6 +40,11 @@ public:
 
         //! O(n log n) allocator with better performance
         PUSHDOWN,
+
+        //! branch-and-bound search seeded by PUSHDOWN, which runs until
+        //! the time budget is exhausted; for offline planning where memory
+        //! usage matters more than planning time
+        BRANCH_BOUND,
     };
 
     static std::unique_ptr<StaticMemAlloc> make(AllocatorAlgo algo);
@@ -99,6 +104,15 @@ public:
      */
     virtual StaticMemAlloc& padding(size_t padding) = 0;
 
+    /*!
+     * \brief set time budget for algorithms that search for better solutions
+     *
+     * Must be called before calling solve(); ignored by heuristic algorithms
+     *
+     * \param seconds max time to be spent in the search
+     */
+    virtual StaticMemAlloc& time_budget(double seconds) = 0;
+
 #if MGB_ENABLE_DEBUG_UTIL
     //! set by the caller to convert key to VarNode* for debug logging
     VarNode* (*dbg_key2varnode)(UserKeyType) = nullptr;
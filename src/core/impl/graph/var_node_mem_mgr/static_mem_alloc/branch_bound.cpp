@@ -0,0 +1,231 @@
+/**
+ * \file src/core/impl/graph/var_node_mem_mgr/static_mem_alloc/branch_bound.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./branch_bound.h"
+
+#include <algorithm>
+
+using namespace mgb;
+using namespace cg;
+
+namespace {
+//! max number of conflicting group pairs; search is skipped beyond this limit
+constexpr size_t MAX_NR_CONFLICT = 1 << 22;
+
+//! max number of alternatives to the heuristic choice at each search node
+constexpr size_t MAX_NR_ALTERNATIVE = 3;
+
+//! number of search nodes between two timer checks
+constexpr size_t TIMER_CHECK_INTERVAL = 256;
+}  // anonymous namespace
+
+void StaticMemAllocBranchBound::init_groups() {
+    m_group.clear();
+    ThinHashMap<Interval*, uint32_t> root2group;
+    for (auto i : m_interval) {
+        if (!i->is_overwrite_root())
+            continue;
+        root2group[i] = m_group.size();
+        m_group.emplace_back();
+        auto&& grp = m_group.back();
+        grp.size = i->size;
+        for (auto j = i; j; j = j->overwrite_src()) {
+            auto offset = j->offset_in_overwrite_dest_root();
+            mgb_assert(offset + j->size <= grp.size);
+            grp.members.push_back({j, j->time_begin, j->time_end, offset, j->size});
+        }
+    }
+
+    m_seed_order.resize(m_group.size());
+    for (size_t i = 0; i < m_group.size(); ++i)
+        m_seed_order[i] = i;
+    auto cmp = [this](uint32_t a, uint32_t b) {
+        auto ia = m_group[a].members[0].interval, ib = m_group[b].members[0].interval;
+        if (ia->addr_begin != ib->addr_begin)
+            return ia->addr_begin < ib->addr_begin;
+        if (ia->size != ib->size)
+            return ia->size > ib->size;
+        return a < b;
+    };
+    std::sort(m_seed_order.begin(), m_seed_order.end(), cmp);
+}
+
+bool StaticMemAllocBranchBound::init_conflict() {
+    // (time_begin, time_end, group id) of all the members
+    std::vector<std::tuple<size_t, size_t, uint32_t>> members, active;
+    for (size_t i = 0; i < m_group.size(); ++i) {
+        for (auto&& j : m_group[i].members)
+            members.emplace_back(j.time_begin, j.time_end, i);
+    }
+    std::sort(members.begin(), members.end());
+
+    size_t nr_conflict = 0;
+    for (auto&& i : members) {
+        auto time_begin = std::get<0>(i);
+        auto gid = std::get<2>(i);
+        auto iter = std::remove_if(active.begin(), active.end(), [&](auto&& j) {
+            return std::get<1>(j) <= time_begin;
+        });
+        active.erase(iter, active.end());
+        for (auto&& j : active) {
+            auto other = std::get<2>(j);
+            if (other != gid) {
+                m_group[gid].conflict.push_back(other);
+                m_group[other].conflict.push_back(gid);
+                if (++nr_conflict > MAX_NR_CONFLICT)
+                    return false;
+            }
+        }
+        active.push_back(i);
+    }
+
+    for (auto&& i : m_group) {
+        auto&& c = i.conflict;
+        std::sort(c.begin(), c.end());
+        c.erase(std::unique(c.begin(), c.end()), c.end());
+    }
+    return true;
+}
+
+void StaticMemAllocBranchBound::init_lower_bound() {
+    // each member is accounted until its overwriter starts, so the sizes of
+    // members in a group are never summed
+    std::vector<std::pair<size_t, ptrdiff_t>> time2delta;
+    for (auto&& grp : m_group) {
+        for (auto&& i : grp.members) {
+            auto src = i.interval->overwrite_src();
+            auto end = src ? std::min(i.time_end, src->time_begin) : i.time_end;
+            if (i.time_begin < end) {
+                time2delta.emplace_back(i.time_begin, i.size);
+                time2delta.emplace_back(end, -static_cast<ptrdiff_t>(i.size));
+            }
+        }
+    }
+    // frees are sorted before allocs at the same time
+    std::sort(time2delta.begin(), time2delta.end());
+
+    size_t usage = 0, peak = 0;
+    for (auto&& i : time2delta) {
+        usage += i.second;
+        update_max(peak, usage);
+    }
+    mgb_assert(!usage);
+    m_lower_bound = align(peak);
+}
+
+size_t StaticMemAllocBranchBound::find_lowest_addr(Group& group) {
+    m_forbidden.clear();
+    for (auto other_id : group.conflict) {
+        auto&& other = m_group[other_id];
+        if (other.addr == INVALID)
+            continue;
+        for (auto&& a : group.members) {
+            for (auto&& b : other.members) {
+                if (a.time_begin >= b.time_end || b.time_begin >= a.time_end)
+                    continue;
+                // a conflicts with b if
+                // b_begin - a.size < addr + a.offset < b_end
+                size_t b_begin = other.addr + b.offset, b_end = b_begin + b.size,
+                       a_end = a.offset + a.size;
+                if (b_end <= a.offset)
+                    continue;
+                size_t lo = b_begin + 1 > a_end ? b_begin + 1 - a_end : 0;
+                m_forbidden.emplace_back(lo, b_end - a.offset);
+            }
+        }
+    }
+    std::sort(m_forbidden.begin(), m_forbidden.end());
+
+    size_t addr = 0;
+    for (auto&& i : m_forbidden) {
+        if (i.first > addr)
+            break;
+        if (i.second > addr)
+            addr = align(i.second);
+    }
+    return addr;
+}
+
+void StaticMemAllocBranchBound::search(size_t first, size_t peak, size_t discrepancy) {
+    while (first < m_seed_order.size() && m_group[m_seed_order[first]].addr != INVALID)
+        ++first;
+    if (first == m_seed_order.size()) {
+        // pruning ensures that this is a better solution
+        mgb_assert(peak < m_peak_usage);
+        m_peak_usage = peak;
+        m_best_addr.resize(m_group.size());
+        for (size_t i = 0; i < m_group.size(); ++i)
+            m_best_addr[i] = m_group[i].addr;
+        return;
+    }
+
+    if (!(++m_nr_node % TIMER_CHECK_INTERVAL) && m_timer.get_secs() > time_budget())
+        m_timeout = true;
+    if (m_timeout)
+        return;
+
+    // the first unplaced group in seed order is the heuristic choice, and
+    // choosing any other group costs one discrepancy
+    size_t nr_choice = 1 + std::min(discrepancy, MAX_NR_ALTERNATIVE);
+    for (size_t i = first, choice = 0; i < m_seed_order.size() && choice < nr_choice;
+         ++i) {
+        auto&& grp = m_group[m_seed_order[i]];
+        if (grp.addr != INVALID)
+            continue;
+        size_t addr = find_lowest_addr(grp),
+               cur_peak = std::max(peak, align(addr + grp.size));
+        if (std::max(cur_peak, m_lower_bound) < m_peak_usage) {
+            grp.addr = addr;
+            search(first, cur_peak, discrepancy - (choice ? 1 : 0));
+            grp.addr = INVALID;
+            if (m_timeout || m_peak_usage <= m_lower_bound)
+                return;
+        }
+        ++choice;
+    }
+}
+
+void StaticMemAllocBranchBound::do_solve() {
+    m_timer.reset();
+    StaticMemAllocPushdown::do_solve();
+    m_peak_usage = StaticMemAllocPushdown::tot_alloc();
+    m_best_addr.clear();
+    m_nr_node = 0;
+    m_timeout = false;
+
+    init_groups();
+    init_lower_bound();
+    if (m_peak_usage <= m_lower_bound || !init_conflict())
+        return;
+
+    auto seed_peak = m_peak_usage;
+    // deeper searches revisit shallower ones; at most one discrepancy could be
+    // used at each group
+    for (size_t discrepancy = 0; discrepancy < m_group.size(); ++discrepancy) {
+        search(0, 0, discrepancy);
+        if (m_timeout || m_peak_usage <= m_lower_bound)
+            break;
+    }
+
+    if (!m_best_addr.empty()) {
+        for (size_t i = 0; i < m_group.size(); ++i) {
+            for (auto&& j : m_group[i].members)
+                j.interval->addr_begin = m_best_addr[i] + j.offset;
+        }
+    }
+    mgb_log_debug(
+            "static mem alloc branch-and-bound: nr_group=%zu nr_node=%zu "
+            "time=%.3fs peak=%zu seed=%zu lower_bound=%zu",
+            m_group.size(), m_nr_node, m_timer.get_secs(), m_peak_usage, seed_peak,
+            m_lower_bound);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,103 @@
+/**
+ * \file src/core/impl/graph/var_node_mem_mgr/static_mem_alloc/branch_bound.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "./pushdown.h"
+
+#include "megbrain/utils/timer.h"
+
+namespace mgb {
+namespace cg {
+
+/*!
+ * \brief search for better allocation by branch-and-bound, seeded by the
+ *      result of PUSHDOWN
+ *
+ * Intervals chained by overwrite specs are placed together as a group. Given
+ * an order of groups, each group is placed at the lowest aligned address that
+ * does not conflict with groups placed before it. Without overwrite specs,
+ * placing in the order of addresses of any solution yields a solution that is
+ * no worse, so an optimal solution is reachable by searching over the orders.
+ *
+ * The orders are explored by limited discrepancy search following the order
+ * of PUSHDOWN addresses, and partial orders whose peak usage already reaches
+ * the best known solution are pruned. The search stops when the time budget is
+ * exhausted or a lower bound is reached; the result is never worse than
+ * PUSHDOWN.
+ */
+class StaticMemAllocBranchBound final : public StaticMemAllocPushdown {
+    //! an interval in a group, with address relative to the group
+    struct Member {
+        Interval* interval;
+        size_t time_begin, time_end, offset, size;
+    };
+
+    struct Group {
+        std::vector<Member> members;
+
+        //! IDs of other groups that overlap with this group in time
+        std::vector<uint32_t> conflict;
+
+        //! size of the root interval, which covers all the members
+        size_t size;
+
+        //! address of the group in current partial solution
+        size_t addr = INVALID;
+    };
+
+    std::vector<Group> m_group;
+
+    //! group IDs sorted by PUSHDOWN addresses, which is the search heuristic
+    std::vector<uint32_t> m_seed_order;
+
+    //! group addresses of the best solution found by search
+    std::vector<size_t> m_best_addr;
+
+    //! forbidden address ranges; used by find_lowest_addr()
+    std::vector<std::pair<size_t, size_t>> m_forbidden;
+
+    size_t m_peak_usage = 0, m_lower_bound = 0, m_nr_node = 0;
+    bool m_timeout = false;
+    RealTimer m_timer;
+
+    void init_groups();
+
+    /*!
+     * \brief compute Group::conflict
+     * \return false if the problem is too large to be searched
+     */
+    bool init_conflict();
+
+    void init_lower_bound();
+
+    //! lowest aligned address to place a group given current partial solution
+    size_t find_lowest_addr(Group& group);
+
+    /*!
+     * \brief place remaining groups with at most *discrepancy* deviations
+     *      from the heuristic order
+     * \param first all groups before this position in m_seed_order have been
+     *      placed
+     * \param peak peak usage of current partial solution
+     */
+    void search(size_t first, size_t peak, size_t discrepancy);
+
+public:
+    void do_solve() override;
+
+    size_t tot_alloc() const override { return m_peak_usage; }
+};
+
+}  // namespace cg
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -11,6 +11,7 @@
 
 #include "./impl.h"
 #include "./best_fit.h"
+#include "./branch_bound.h"
 #include "./interval_move.h"
 #include "./pushdown.h"
 
@@ -388,6 +389,8 @@ std::unique_ptr<StaticMemAlloc> StaticMemAlloc::make(AllocatorAlgo algo) {
 #endif
         case AllocatorAlgo::PUSHDOWN:
             return std::make_unique<StaticMemAllocPushdown>();
+        case AllocatorAlgo::BRANCH_BOUND:
+            return std::make_unique<StaticMemAllocBranchBound>();
         default:
             mgb_assert(0, "unknown mem allocator algorithm");
     }
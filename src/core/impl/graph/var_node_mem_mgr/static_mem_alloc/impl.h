@@ -49,6 +49,12 @@ public:
         return *this;
     }
 
+    StaticMemAlloc& time_budget(double seconds) override final {
+        mgb_assert(seconds >= 0);
+        m_time_budget = seconds;
+        return *this;
+    }
+
     size_t tot_alloc_lower_bound() const override final { return m_peak_lower_bound; }
 
 protected:
@@ -68,8 +74,11 @@ protected:
      */
     size_t align(size_t addr) { return get_aligned_power2(addr, m_alignment); }
 
+    double time_budget() const { return m_time_budget; }
+
 private:
     size_t m_alignment = 1, m_padding = 0, m_peak_lower_bound = 0;
+    double m_time_budget = 1;
 
     //! original interval storage
     std::vector<Interval> m_interval_storage;
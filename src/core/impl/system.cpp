@@ -149,6 +149,87 @@ bool sys::stderr_ansi_color() {
 }
 #endif
 
+#if defined(__linux) && !defined(ANDROID) && !defined(__ANDROID__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+
+int sys::get_numa_node_count() {
+    // the nodes are consecutively numbered in sysfs
+    int nr = 0;
+    while (!access(ssprintf("/sys/devices/system/node/node%d", nr).c_str(), F_OK)) {
+        ++nr;
+    }
+    return std::max(nr, 1);
+}
+
+std::vector<int> sys::get_numa_node_cpus(int node) {
+    std::vector<int> ret;
+    std::ifstream fin(ssprintf("/sys/devices/system/node/node%d/cpulist", node));
+    std::string list;
+    if (!(fin >> list)) {
+        return ret;
+    }
+    // the list is like 0-3,8,10-11
+    const char* ptr = list.c_str();
+    while (*ptr) {
+        char* end;
+        int begin = strtol(ptr, &end, 10), last = begin;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        for (int i = begin; i <= last; ++i) {
+            ret.push_back(i);
+        }
+        ptr = *end == ',' ? end + 1 : end;
+        if (end == ptr && *ptr) {
+            // malformed list
+            return {};
+        }
+    }
+    return ret;
+}
+
+void sys::bind_mem_to_numa_node(void* ptr, size_t size, int node) {
+    constexpr int MPOL_PREFERRED_MODE = 1;
+    //! MPOL_MF_MOVE: also migrate the pages that have already been touched,
+    //! e.g. chunks reused by malloc
+    constexpr unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+    constexpr size_t NR_BITS = sizeof(unsigned long) * 8;
+    size_t page = sysconf(_SC_PAGESIZE);
+    auto addr = reinterpret_cast<uintptr_t>(ptr);
+    auto begin = (addr + page - 1) / page * page, end = (addr + size) / page * page;
+    if (node < 0 || begin >= end) {
+        return;
+    }
+    std::vector<unsigned long> nodemask(node / NR_BITS + 1);
+    nodemask[node / NR_BITS] |= 1ul << (node % NR_BITS);
+    auto err =
+            syscall(SYS_mbind, begin, end - begin, MPOL_PREFERRED_MODE,
+                    nodemask.data(), nodemask.size() * NR_BITS + 1,
+                    MPOL_MF_MOVE_FLAG);
+    if (err) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            mgb_log_warn(
+                    "failed to bind memory to numa node %d: %s (error ignored)",
+                    node, strerror(errno));
+        }
+    }
+}
+#else
+int sys::get_numa_node_count() {
+    return 1;
+}
+
+std::vector<int> sys::get_numa_node_cpus(int) {
+    return {};
+}
+
+void sys::bind_mem_to_numa_node(void*, size_t, int) {}
+#endif
+
 #if MGB_BUILD_SLIM_SERVING || defined(ANDROID) || defined(WIN32) || defined(IOS) || \
         defined(__APPLE__)
 
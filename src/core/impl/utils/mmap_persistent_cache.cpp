@@ -0,0 +1,436 @@
+/**
+ * \file src/core/impl/utils/mmap_persistent_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/utils/mmap_persistent_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace mgb;
+
+#ifndef WIN32
+
+/*!
+ * file layout (all integers in native endian):
+ *
+ * FileHeader, followed by nr_bucket uint64 bucket heads, followed by records
+ * aligned to RECORD_ALIGN. Each record consists of RecordHeader, value,
+ * category and key. Offset 0 is used as the end of bucket chains.
+ */
+struct MmapPersistentCache::FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t nr_bucket;
+    //! set to nonzero after the file is replaced by a compacted one
+    uint64_t obsolete;
+    uint64_t reserved[5];
+
+    uint64_t* buckets() { return reinterpret_cast<uint64_t*>(this + 1); }
+
+    size_t data_begin() const { return sizeof(FileHeader) + nr_bucket * 8; }
+};
+
+struct MmapPersistentCache::RecordHeader {
+    //! offset of the next record in the bucket chain, which is always less
+    //! than the offset of this record
+    uint64_t next;
+    uint64_t hash;
+    uint32_t value_size, category_size, key_size, reserved;
+
+    const uint8_t* value() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+    const uint8_t* category() const { return value() + value_size; }
+    const uint8_t* key() const { return category() + category_size; }
+
+    size_t size() const;
+};
+
+namespace {
+constexpr uint32_t MAGIC = 0x4347424d;  // "MBGC"
+constexpr uint32_t VERSION = 1;
+constexpr uint64_t MIN_NR_BUCKET = 1024;
+constexpr size_t RECORD_ALIGN = 8;
+
+size_t align_record(size_t size) {
+    return (size + RECORD_ALIGN - 1) / RECORD_ALIGN * RECORD_ALIGN;
+}
+
+uint64_t atomic_load(const uint64_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void atomic_store(uint64_t* ptr, uint64_t val) {
+    __atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+
+uint64_t hash_record(const std::string& category, const PersistentCache::Blob& key) {
+    uint32_t category_size = category.size();
+    return XXHash{}
+            .update(&category_size, sizeof(category_size))
+            .update(category.data(), category.size())
+            .update(key.ptr, key.size)
+            .digest();
+}
+
+//! exclusive advisory lock on the whole file, used to serialize writers
+//! across processes
+class FileLock : NonCopyableObj {
+    const int m_fd;
+
+public:
+    explicit FileLock(int fd) : m_fd{fd} {
+        while (flock(m_fd, LOCK_EX)) {
+            mgb_assert(errno == EINTR, "failed to lock file: %s", strerror(errno));
+        }
+    }
+
+    ~FileLock() { flock(m_fd, LOCK_UN); }
+};
+
+size_t get_file_size(int fd) {
+    struct stat st;
+    mgb_assert(!fstat(fd, &st), "failed to stat file: %s", strerror(errno));
+    return st.st_size;
+}
+
+void write_all(int fd, const void* buf, size_t size, size_t offset) {
+    auto ptr = static_cast<const uint8_t*>(buf);
+    while (size) {
+        auto nr = pwrite(fd, ptr, size, offset);
+        if (nr < 0 && errno == EINTR)
+            continue;
+        mgb_assert(nr > 0, "failed to write cache file: %s", strerror(errno));
+        ptr += nr;
+        size -= nr;
+        offset += nr;
+    }
+}
+}  // anonymous namespace
+
+size_t MmapPersistentCache::RecordHeader::size() const {
+    return align_record(sizeof(RecordHeader) + value_size + category_size + key_size);
+}
+
+std::vector<uint8_t> MmapPersistentCache::make_empty_file(uint64_t nr_bucket) {
+    std::vector<uint8_t> ret(sizeof(FileHeader) + nr_bucket * 8);
+    auto hdr = reinterpret_cast<FileHeader*>(ret.data());
+    hdr->magic = MAGIC;
+    hdr->version = VERSION;
+    hdr->nr_bucket = nr_bucket;
+    return ret;
+}
+
+MmapPersistentCache::MmapPersistentCache(std::string path) : m_path{std::move(path)} {
+    open_file();
+}
+
+MmapPersistentCache::~MmapPersistentCache() {
+    close_file();
+    for (auto&& i : m_mappings) {
+        munmap(i.addr, i.size);
+    }
+}
+
+void MmapPersistentCache::open_file() {
+    for (;;) {
+        m_fd = open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        mgb_assert(
+                m_fd >= 0, "failed to open %s: %s", m_path.c_str(), strerror(errno));
+        bool reopen;
+        {
+            FileLock lock{m_fd};
+            if (!get_file_size(m_fd)) {
+                auto buf = make_empty_file(MIN_NR_BUCKET);
+                write_all(m_fd, buf.data(), buf.size(), 0);
+            }
+            mgb_throw_if(
+                    !ensure_mapped(0, sizeof(FileHeader)) ||
+                            header()->magic != MAGIC || header()->version != VERSION ||
+                            !header()->nr_bucket ||
+                            !ensure_mapped(0, header()->data_begin()),
+                    MegBrainError, "invalid persistent cache file: %s",
+                    m_path.c_str());
+            reopen = obsolete() || compact_if_needed();
+        }
+        if (!reopen)
+            return;
+        close_file();
+    }
+}
+
+void MmapPersistentCache::close_file() {
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_cur_mapping = {nullptr, 0};
+    m_cur_file_size = 0;
+}
+
+bool MmapPersistentCache::ensure_mapped(size_t offset, size_t size) {
+    if (offset + size <= m_cur_file_size)
+        return true;
+    auto file_size = get_file_size(m_fd);
+    if (offset + size > file_size)
+        return false;
+    m_cur_file_size = file_size;
+    if (file_size > m_cur_mapping.size) {
+        // reserve address space for future appends to avoid remapping for
+        // each new record; pages beyond the end of file are never accessed
+        auto map_size = std::max<size_t>(file_size * 2, 1 << 20);
+        auto addr =
+                mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        mgb_assert(
+                addr != MAP_FAILED, "failed to mmap %s: %s", m_path.c_str(),
+                strerror(errno));
+        m_cur_mapping = {addr, map_size};
+        m_mappings.push_back(m_cur_mapping);
+    }
+    return true;
+}
+
+MmapPersistentCache::FileHeader* MmapPersistentCache::header() const {
+    return static_cast<FileHeader*>(m_cur_mapping.addr);
+}
+
+bool MmapPersistentCache::obsolete() const {
+    return atomic_load(&header()->obsolete);
+}
+
+const MmapPersistentCache::RecordHeader* MmapPersistentCache::get_record(
+        uint64_t offset) {
+    if (!ensure_mapped(offset, sizeof(RecordHeader)))
+        return nullptr;
+    auto rec = reinterpret_cast<const RecordHeader*>(
+            static_cast<const uint8_t*>(m_cur_mapping.addr) + offset);
+    if (!ensure_mapped(offset, rec->size()))
+        return nullptr;
+    // the mapping may have been changed
+    return reinterpret_cast<const RecordHeader*>(
+            static_cast<const uint8_t*>(m_cur_mapping.addr) + offset);
+}
+
+bool MmapPersistentCache::record_eq(
+        const RecordHeader* rec, uint64_t hash, const void* category,
+        size_t category_size, const void* key, size_t key_size) {
+    return rec->hash == hash && rec->category_size == category_size &&
+           rec->key_size == key_size &&
+           !memcmp(rec->category(), category, category_size) &&
+           !memcmp(rec->key(), key, key_size);
+}
+
+const MmapPersistentCache::RecordHeader* MmapPersistentCache::find(
+        uint64_t hash, const std::string& category, const Blob& key) {
+    auto hdr = header();
+    auto data_begin = hdr->data_begin();
+    auto offset = atomic_load(&hdr->buckets()[hash % hdr->nr_bucket]);
+    // offsets in a chain are strictly decreasing, which also protects us
+    // from looping on corrupted files
+    for (uint64_t prev = std::numeric_limits<uint64_t>::max();
+         offset >= data_begin && offset < prev;) {
+        auto rec = get_record(offset);
+        if (!rec)
+            break;
+        if (record_eq(
+                    rec, hash, category.data(), category.size(), key.ptr, key.size)) {
+            return rec;
+        }
+        prev = offset;
+        offset = rec->next;
+    }
+    return nullptr;
+}
+
+std::vector<uint64_t> MmapPersistentCache::collect_live_records() {
+    std::vector<uint64_t> ret;
+    auto nr_bucket = header()->nr_bucket;
+    auto data_begin = header()->data_begin();
+    std::vector<const RecordHeader*> chain;
+    for (uint64_t bucket = 0; bucket < nr_bucket; ++bucket) {
+        chain.clear();
+        auto offset = atomic_load(&header()->buckets()[bucket]);
+        for (uint64_t prev = std::numeric_limits<uint64_t>::max();
+             offset >= data_begin && offset < prev;) {
+            auto rec = get_record(offset);
+            if (!rec)
+                break;
+            bool shadowed = false;
+            for (auto i : chain) {
+                if (record_eq(
+                            i, rec->hash, rec->category(), rec->category_size,
+                            rec->key(), rec->key_size)) {
+                    shadowed = true;
+                    break;
+                }
+            }
+            if (!shadowed) {
+                chain.push_back(rec);
+                ret.push_back(offset);
+            }
+            prev = offset;
+            offset = rec->next;
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+bool MmapPersistentCache::compact_if_needed() {
+    auto live = collect_live_records();
+    size_t live_size = 0;
+    for (auto i : live) {
+        live_size += get_record(i)->size();
+    }
+    auto nr_bucket = header()->nr_bucket;
+    if (header()->data_begin() + live_size == get_file_size(m_fd) &&
+        live.size() <= nr_bucket) {
+        return false;
+    }
+
+    // keep load factor below 0.5 after compaction
+    uint64_t new_nr_bucket = MIN_NR_BUCKET;
+    while (new_nr_bucket < live.size() * 2) {
+        new_nr_bucket *= 2;
+    }
+    auto buf = make_empty_file(new_nr_bucket);
+    buf.reserve(buf.size() + live_size);
+    for (auto i : live) {
+        auto rec = get_record(i);
+        auto offset = buf.size();
+        auto size = rec->size();
+        buf.resize(offset + size);
+        memcpy(buf.data() + offset, rec, size);
+        auto new_rec = reinterpret_cast<RecordHeader*>(buf.data() + offset);
+        auto bucket = reinterpret_cast<FileHeader*>(buf.data())->buckets() +
+                      new_rec->hash % new_nr_bucket;
+        new_rec->next = *bucket;
+        *bucket = offset;
+    }
+
+    auto tmp_path = ssprintf("%s.tmp.%d", m_path.c_str(), static_cast<int>(getpid()));
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        mgb_log_warn(
+                "failed to create %s for compacting persistent cache: %s",
+                tmp_path.c_str(), strerror(errno));
+        return false;
+    }
+    write_all(fd, buf.data(), buf.size(), 0);
+    fsync(fd);
+    close(fd);
+    if (rename(tmp_path.c_str(), m_path.c_str())) {
+        mgb_log_warn(
+                "failed to replace %s with compacted persistent cache: %s",
+                m_path.c_str(), strerror(errno));
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    mgb_log_debug(
+            "persistent cache %s compacted: %zu records, %zu bytes", m_path.c_str(),
+            live.size(), buf.size());
+    atomic_store(&header()->obsolete, 1);
+    return true;
+}
+
+Maybe<PersistentCache::Blob> MmapPersistentCache::get(
+        const std::string& category, const Blob& key) {
+    auto hash = hash_record(category, key);
+    MGB_LOCK_GUARD(m_mtx);
+    for (bool retry = false;; retry = true) {
+        if (auto rec = find(hash, category, key)) {
+            return Blob{rec->value(), rec->value_size};
+        }
+        if (retry || !obsolete())
+            return None;
+        // the record may have been put into the compacted file
+        close_file();
+        open_file();
+    }
+}
+
+void MmapPersistentCache::put(
+        const std::string& category, const Blob& key, const Blob& value) {
+    auto hash = hash_record(category, key);
+    MGB_LOCK_GUARD(m_mtx);
+    for (;;) {
+        {
+            FileLock lock{m_fd};
+            if (!obsolete()) {
+                auto old = find(hash, category, key);
+                if (old && old->value_size == value.size &&
+                    !memcmp(old->value(), value.ptr, value.size)) {
+                    return;
+                }
+                RecordHeader rec;
+                memset(&rec, 0, sizeof(rec));
+                rec.hash = hash;
+                rec.value_size = value.size;
+                rec.category_size = category.size();
+                rec.key_size = key.size;
+                std::vector<uint8_t> buf(rec.size());
+                auto data = buf.data() + sizeof(rec);
+                memcpy(data, value.ptr, value.size);
+                memcpy(data + value.size, category.data(), category.size());
+                memcpy(data + value.size + category.size(), key.ptr, key.size);
+
+                auto bucket = header()->buckets() + hash % header()->nr_bucket;
+                rec.next = atomic_load(bucket);
+                memcpy(buf.data(), &rec, sizeof(rec));
+                auto offset = align_record(get_file_size(m_fd));
+                write_all(m_fd, buf.data(), buf.size(), offset);
+                // publish the record after it has been completely written
+                atomic_store(bucket, offset);
+                return;
+            }
+        }
+        close_file();
+        open_file();
+    }
+}
+
+size_t MmapPersistentCache::nr_record() {
+    MGB_LOCK_GUARD(m_mtx);
+    return collect_live_records().size();
+}
+
+#else  // WIN32
+
+struct MmapPersistentCache::FileHeader {};
+struct MmapPersistentCache::RecordHeader {};
+
+MmapPersistentCache::MmapPersistentCache(std::string path) : m_path{std::move(path)} {
+    mgb_throw(MegBrainError, "MmapPersistentCache is not supported on this platform");
+}
+
+MmapPersistentCache::~MmapPersistentCache() = default;
+
+Maybe<PersistentCache::Blob> MmapPersistentCache::get(
+        const std::string&, const Blob&) {
+    return None;
+}
+
+void MmapPersistentCache::put(const std::string&, const Blob&, const Blob&) {}
+
+size_t MmapPersistentCache::nr_record() {
+    return 0;
+}
+
+#endif  // WIN32
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
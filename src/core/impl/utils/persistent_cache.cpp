@@ -97,24 +97,24 @@ bool InMemoryPersistentCache::BlobStorage::operator==(const BlobStorage& rhs) co
 }
 
 Maybe<Blob> InMemoryPersistentCache::get(const std::string& category, const Blob& key) {
-    decltype(m_cache.begin()) iter0;
-    {
-        MGB_LOCK_GUARD(m_mtx);
-        iter0 = m_cache.find(category);
-        if (iter0 == m_cache.end())
-            return None;
-    }
-
     BlobStorage key_storage;
     key_storage.Blob::operator=(key);
     key_storage.init_hash();
 
-    MGB_LOCK_GUARD(m_mtx);
-
-    auto iter1 = iter0->second.find(key_storage);
-    if (iter1 == iter0->second.end())
-        return None;
-    return iter1->second;
+    auto&& shard = m_shards[key_storage.hash % NR_SHARD];
+    {
+        MGB_LOCK_GUARD_SHARED(shard.mtx);
+        auto iter0 = shard.cache.find(category);
+        if (iter0 != shard.cache.end()) {
+            auto iter1 = iter0->second.find(key_storage);
+            if (iter1 != iter0->second.end()) {
+                shard.nr_hit.fetch_add(1, std::memory_order_relaxed);
+                return iter1->second;
+            }
+        }
+    }
+    shard.nr_miss.fetch_add(1, std::memory_order_relaxed);
+    return None;
 }
 
 void InMemoryPersistentCache::put(
@@ -122,14 +122,29 @@ void InMemoryPersistentCache::put(
     BlobStorage key_storage;
     key_storage.init_data_ref(key).init_hash();
 
-    MGB_LOCK_GUARD(m_mtx);
-    auto size0 = m_cache.size();
-    m_cache[category][std::move(key_storage)].init_data_ref(value);
-    if (m_cache.size() > size0) {
+    auto&& shard = m_shards[key_storage.hash % NR_SHARD];
+    MGB_LOCK_GUARD(shard.mtx);
+    auto size0 = shard.cache.size();
+    auto&& val = shard.cache[category][std::move(key_storage)];
+    // keep previously returned blobs valid if the value is not changed
+    if (!val.data_refhold || val.size != value.size ||
+        memcmp(val.ptr, value.ptr, value.size)) {
+        val.init_data_ref(value);
+    }
+    if (shard.cache.size() > size0) {
         mgb_log_debug("new cache category: %s", category.c_str());
     }
 }
 
+InMemoryPersistentCache::Stats InMemoryPersistentCache::stats() const {
+    Stats ret;
+    for (auto&& shard : m_shards) {
+        ret.nr_hit += shard.nr_hit.load(std::memory_order_relaxed);
+        ret.nr_miss += shard.nr_miss.load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
 // ================= AlgoChooserProfileCache ==================
 AlgoChooserProfileCache::AlgoChooserProfileCache(CompNode cn, const char* opr_type) {
     m_category = "profile:";
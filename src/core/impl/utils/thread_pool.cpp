@@ -10,13 +10,53 @@
  */
 
 #include "megbrain/utils/thread_pool.h"
+#include "megbrain/utils/thread.h"
+#include "megbrain/utils/thread_local.h"
 #include <chrono>
+#include <cstring>
+#include <limits>
 
 using namespace mgb;
 
 #if MGB_HAVE_THREAD
+namespace {
+ThreadPoolScheduleMode get_default_schedule_mode() {
+    if (auto env = MGB_GETENV("MGB_THREAD_POOL_SCHEDULE")) {
+        if (!strcmp(env, "WORK_STEALING")) {
+            return ThreadPoolScheduleMode::WORK_STEALING;
+        }
+        mgb_assert(
+                !strcmp(env, "SHARED_COUNTER"),
+                "invalid MGB_THREAD_POOL_SCHEDULE: %s, expect SHARED_COUNTER or "
+                "WORK_STEALING",
+                env);
+    }
+    return ThreadPoolScheduleMode::SHARED_COUNTER;
+}
+
+//! split nr_parallelism sub tasks into pieces so that each thread could get
+//! several pieces, which is the unit of stealing
+size_t get_grain_size(const TaskElem& task_elem, size_t nr_threads) {
+    if (task_elem.grain_size) {
+        return task_elem.grain_size;
+    }
+    constexpr size_t NR_PIECE_PER_THREAD = 4;
+    return std::max<size_t>(
+            1, task_elem.nr_parallelism / (nr_threads * NR_PIECE_PER_THREAD));
+}
+
+//! the thread pool whose task is being executed by current thread
+MGB_THREAD_LOCAL_PTR(ThreadPool) tl_running_pool = nullptr;
+}  // anonymous namespace
+
+constexpr size_t ThreadPool::MAX_NR_TASK_GROUP;
+
 ThreadPool::ThreadPool(size_t threads_num)
-        : m_nr_threads(threads_num),
+        : ThreadPool(threads_num, get_default_schedule_mode()) {}
+
+ThreadPool::ThreadPool(size_t threads_num, ScheduleMode mode)
+        : m_schedule_mode{mode},
+          m_nr_threads(threads_num),
           m_main_affinity_flag{false},
           m_stop{false},
           m_active{false} {
@@ -30,46 +70,198 @@ ThreadPool::ThreadPool(size_t threads_num)
                     "physical cpu cores, got: %zu core_number: %zu",
                     static_cast<size_t>(sys::get_cpu_count()), nr_threads());
         }
+        m_task_groups.reset(new TaskGroup[MAX_NR_TASK_GROUP]);
+        for (size_t i = 0; i < MAX_NR_TASK_GROUP; ++i) {
+            m_task_groups[i].ranges.reset(new TaskRange[m_nr_threads]);
+        }
+        m_max_spin = SCQueueSynchronizer::get_default_max_spin();
         for (uint32_t i = 0; i < m_nr_threads - 1; i++) {
-            m_workers.push_back(new Worker([this, i]() {
-                while (!m_stop) {
-                    while (m_active) {
-                        if (m_workers[i]->affinity_flag &&
-                            m_core_binding_function != nullptr) {
-                            m_core_binding_function(i);
-                            m_workers[i]->affinity_flag = false;
-                        }
-                        //! if the thread should work
-                        if (m_workers[i]->work_flag.load(std::memory_order_acquire)) {
-                            int index = -1;
-                            //! Get one task and execute
-                            while ((index = m_task_iter.fetch_sub(
-                                            1, std::memory_order_acq_rel)) &&
-                                   index > 0) {
-                                //! index is decrease, use
-                                //! m_all_task_number - index to get the
-                                //! increase id which will pass to task
-                                m_task(static_cast<size_t>(m_nr_parallelism - index),
-                                       i);
-                            }
-                            //! Flag worker is finished
-                            m_workers[i]->work_flag.store(
-                                    false, std::memory_order_release);
-                        }
-                        //! Wait next task coming
-                        std::this_thread::yield();
-                    }
-                    {
-                        std::unique_lock<std::mutex> lock(m_mutex);
-                        if (!m_stop && !m_active) {
-                            m_cv.wait(lock, [this] { return m_stop || m_active; });
-                        }
-                    }
-                }
-            }));
+            m_workers.push_back(new Worker([this, i]() { worker_main(i); }));
+        }
+    }
+}
+
+void ThreadPool::worker_main(size_t id) {
+    tl_running_pool = this;
+    while (!m_stop) {
+        if (m_schedule_mode.load(std::memory_order_acquire) ==
+            ScheduleMode::WORK_STEALING) {
+            work_stealing_worker_loop(id);
+        } else {
+            shared_counter_worker_loop(id);
+        }
+    }
+}
+
+void ThreadPool::bind_worker_affinity(size_t id) {
+    if (m_workers[id]->affinity_flag && m_core_binding_function != nullptr) {
+        m_core_binding_function(id);
+        m_workers[id]->affinity_flag = false;
+    }
+}
+
+void ThreadPool::shared_counter_worker_loop(size_t i) {
+    auto mode_changed = [this]() {
+        return m_schedule_mode.load(std::memory_order_acquire) !=
+               ScheduleMode::SHARED_COUNTER;
+    };
+    while (m_active && !mode_changed()) {
+        bind_worker_affinity(i);
+        //! if the thread should work
+        if (m_workers[i]->work_flag.load(std::memory_order_acquire)) {
+            int index = -1;
+            //! Get one task and execute
+            while ((index = m_task_iter.fetch_sub(1, std::memory_order_acq_rel)) &&
+                   index > 0) {
+                //! index is decrease, use
+                //! m_all_task_number - index to get the
+                //! increase id which will pass to task
+                m_task(static_cast<size_t>(m_nr_parallelism - index), i);
+            }
+            //! Flag worker is finished
+            m_workers[i]->work_flag.store(false, std::memory_order_release);
+        }
+        //! Wait next task coming
+        std::this_thread::yield();
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_stop && !m_active && !mode_changed()) {
+            m_cv.wait(lock, [this, &mode_changed] {
+                return m_stop || m_active || mode_changed();
+            });
+        }
+    }
+}
+
+void ThreadPool::work_stealing_worker_loop(size_t i) {
+    auto should_return = [this]() {
+        return m_stop || m_schedule_mode.load(std::memory_order_acquire) !=
+                                 ScheduleMode::WORK_STEALING;
+    };
+    while (!should_return()) {
+        //! the epoch must be read before scanning the groups, so a group opened
+        //! during scanning would not be missed
+        size_t epoch = m_group_epoch.load();
+        if (work_stealing_join_groups(i)) {
+            continue;
+        }
+        auto has_new_group = [this, epoch]() { return m_group_epoch.load() != epoch; };
+        //! spin for a bounded period before going to sleep
+        size_t spin = 0;
+        while (!has_new_group() && spin < m_max_spin) {
+            ++spin;
+        }
+        if (!has_new_group()) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_nr_sleeping.fetch_add(1);
+            m_cv.wait(lock, [&] { return should_return() || has_new_group(); });
+            m_nr_sleeping.fetch_sub(1);
         }
     }
 }
+
+bool ThreadPool::work_stealing_join_groups(size_t id) {
+    bool executed = false;
+    //! groups which have been joined without executing any sub task
+    uint32_t drained = 0;
+    for (;;) {
+        TaskGroup* best = nullptr;
+        size_t best_nr_running = std::numeric_limits<size_t>::max();
+        for (size_t i = 0; i < MAX_NR_TASK_GROUP; ++i) {
+            auto&& group = m_task_groups[i];
+            if (drained & (1u << i) ||
+                group.state.load(std::memory_order_relaxed) != TaskGroup::OPEN ||
+                !group.nr_pending.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            auto nr_running = group.nr_running.load(std::memory_order_relaxed);
+            if (nr_running < best_nr_running) {
+                best = &group;
+                best_nr_running = nr_running;
+            }
+        }
+        if (!best) {
+            return executed;
+        }
+        //! the state must be checked after nr_running is increased, see
+        //! add_task_work_stealing()
+        best->nr_running.fetch_add(1);
+        bool group_executed = false;
+        if (best->state.load() == TaskGroup::OPEN) {
+            bind_worker_affinity(id);
+            group_executed = work_stealing_run(*best, id);
+        }
+        best->nr_running.fetch_sub(1, std::memory_order_release);
+        if (group_executed) {
+            executed = true;
+            drained = 0;
+        } else {
+            drained |= 1u << (best - m_task_groups.get());
+        }
+    }
+}
+
+bool ThreadPool::work_stealing_run(TaskGroup& group, size_t id) {
+    auto try_pop = [&group](size_t owner, uint32_t& begin, uint32_t& end) {
+        auto&& range = group.ranges[owner].range;
+        uint64_t cur = range.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t b = TaskRange::begin(cur), e = TaskRange::end(cur);
+            if (b >= e) {
+                return false;
+            }
+            uint32_t nb = static_cast<uint32_t>(
+                    std::min<size_t>(e, static_cast<size_t>(b) + group.grain_size));
+            if (range.compare_exchange_weak(
+                        cur, TaskRange::pack(nb, e), std::memory_order_acq_rel)) {
+                begin = b;
+                end = nb;
+                return true;
+            }
+        }
+    };
+    //! steal the upper half of the range of victim, and put it into the range
+    //! of thief
+    auto try_steal = [&group](size_t victim, size_t thief) {
+        auto&& range = group.ranges[victim].range;
+        uint64_t cur = range.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t b = TaskRange::begin(cur), e = TaskRange::end(cur);
+            if (b >= e) {
+                return false;
+            }
+            uint32_t mid = b + (e - b) / 2;
+            if (range.compare_exchange_weak(
+                        cur, TaskRange::pack(b, mid), std::memory_order_acq_rel)) {
+                group.ranges[thief].range.store(
+                        TaskRange::pack(mid, e), std::memory_order_release);
+                return true;
+            }
+        }
+    };
+
+    auto&& task = group.task_elem->task;
+    bool executed = false;
+    for (;;) {
+        uint32_t begin, end;
+        while (try_pop(id, begin, end)) {
+            for (uint32_t i = begin; i < end; ++i) {
+                task(i, id);
+            }
+            group.nr_pending.fetch_sub(end - begin, std::memory_order_acq_rel);
+            executed = true;
+        }
+        bool stolen = false;
+        for (size_t i = 1; i < m_nr_threads && !stolen; ++i) {
+            stolen = try_steal((id + i) % m_nr_threads, id);
+        }
+        if (!stolen) {
+            return executed;
+        }
+    }
+}
+
 void ThreadPool::add_task(const TaskElem& task_elem) {
     //! Make sure the main thread have bind
     if (m_main_affinity_flag && m_core_binding_function != nullptr) {
@@ -78,37 +270,138 @@ void ThreadPool::add_task(const TaskElem& task_elem) {
         m_main_affinity_flag = false;
     }
     size_t parallelism = task_elem.nr_parallelism;
-    //! If only one thread or one task, execute directly
-    if (task_elem.nr_parallelism == 1 || m_nr_threads == 1) {
+    bool work_stealing = m_schedule_mode.load(std::memory_order_relaxed) ==
+                         ScheduleMode::WORK_STEALING;
+    //! If only one thread or one task, execute directly; nested task in
+    //! SHARED_COUNTER mode is also executed directly as m_mutex_task has been
+    //! held by the outer task
+    if (task_elem.nr_parallelism == 1 || m_nr_threads == 1 ||
+        (!work_stealing && tl_running_pool == this)) {
         for (size_t i = 0; i < parallelism; i++) {
             task_elem.task(i, 0);
         }
         return;
-    } else {
+    }
+    if (!work_stealing) {
         std::lock_guard<std::mutex> lock(m_mutex_task);
-        mgb_assert(
-                m_task_iter.load(std::memory_order_acquire) <= 0,
-                "The init value of m_all_sub_task is not zero.");
-        active();
-        //! Set the task number, task iter and task
-        m_nr_parallelism = parallelism;
-        m_task_iter.exchange(parallelism, std::memory_order_relaxed);
-        m_task = [&task_elem](size_t index, size_t thread_id) {
-            task_elem.task(index, thread_id);
-        };
-        //! Set flag to start thread working
-        for (uint32_t i = 0; i < m_nr_threads - 1; i++) {
-            m_workers[i]->work_flag = true;
+        add_task_shared_counter(task_elem);
+        return;
+    }
+    //! the range of sub tasks is packed into 32 bits, so split the task if
+    //! it is too large
+    constexpr size_t max_range = std::numeric_limits<uint32_t>::max();
+    if (parallelism <= max_range) {
+        add_task_work_stealing(task_elem);
+        return;
+    }
+    for (size_t offset = 0; offset < parallelism; offset += max_range) {
+        TaskElem sub_task{
+                [&task_elem, offset](size_t index, size_t thread_id) {
+                    task_elem.task(index + offset, thread_id);
+                },
+                std::min(max_range, parallelism - offset), task_elem.grain_size};
+        add_task_work_stealing(sub_task);
+    }
+}
+
+void ThreadPool::add_task_shared_counter(const TaskElem& task_elem) {
+    size_t parallelism = task_elem.nr_parallelism;
+    mgb_assert(
+            m_task_iter.load(std::memory_order_acquire) <= 0,
+            "The init value of m_all_sub_task is not zero.");
+    active();
+    //! Set the task number, task iter and task
+    m_nr_parallelism = parallelism;
+    m_task_iter.exchange(parallelism, std::memory_order_relaxed);
+    m_task = [&task_elem](size_t index, size_t thread_id) {
+        task_elem.task(index, thread_id);
+    };
+    //! Set flag to start thread working
+    for (uint32_t i = 0; i < m_nr_threads - 1; i++) {
+        m_workers[i]->work_flag = true;
+    }
+    //! Main thread working
+    ThreadPool* prev_pool = tl_running_pool;
+    tl_running_pool = this;
+    int index = -1;
+    while ((index = m_task_iter.fetch_sub(1, std::memory_order_acq_rel)) &&
+           (index > 0)) {
+        m_task(static_cast<size_t>(m_nr_parallelism - index), m_nr_threads - 1);
+    }
+    tl_running_pool = prev_pool;
+    //! make sure all threads done
+    sync();
+}
+
+void ThreadPool::add_task_work_stealing(const TaskElem& task_elem) {
+    TaskGroup* group = nullptr;
+    for (size_t i = 0; i < MAX_NR_TASK_GROUP && !group; ++i) {
+        uint32_t state = TaskGroup::FREE;
+        if (m_task_groups[i].state.compare_exchange_strong(
+                    state, TaskGroup::SETUP, std::memory_order_acquire)) {
+            group = &m_task_groups[i];
         }
-        //! Main thread working
-        int index = -1;
-        while ((index = m_task_iter.fetch_sub(1, std::memory_order_acq_rel)) &&
-               (index > 0)) {
-            m_task(static_cast<size_t>(m_nr_parallelism - index), m_nr_threads - 1);
+    }
+    size_t parallelism = task_elem.nr_parallelism;
+    //! the submitting thread takes the thread id of the main thread
+    const size_t main_id = m_nr_threads - 1;
+    if (!group) {
+        mgb_log_debug(
+                "too many tasks are running on the thread pool, execute the "
+                "task on the calling thread");
+        for (size_t i = 0; i < parallelism; i++) {
+            task_elem.task(i, main_id);
         }
-        //! make sure all threads done
-        sync();
+        return;
+    }
+
+    group->task_elem = &task_elem;
+    group->grain_size = get_grain_size(task_elem, m_nr_threads);
+    //! give each thread a contiguous range of the sub tasks
+    for (size_t i = 0; i < m_nr_threads; ++i) {
+        group->ranges[i].range.store(
+                TaskRange::pack(
+                        static_cast<uint32_t>(parallelism * i / m_nr_threads),
+                        static_cast<uint32_t>(parallelism * (i + 1) / m_nr_threads)),
+                std::memory_order_relaxed);
+    }
+    group->nr_pending.store(parallelism, std::memory_order_relaxed);
+    //! open the group to the workers, the seq_cst store pairs with the load in
+    //! work_stealing_join_groups()
+    group->state.store(TaskGroup::OPEN);
+    m_group_epoch.fetch_add(1);
+    if (m_nr_sleeping.load()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_all();
+    }
+
+    //! the calling thread working
+    ThreadPool* prev_pool = tl_running_pool;
+    tl_running_pool = this;
+    work_stealing_run(*group, main_id);
+    tl_running_pool = prev_pool;
+    while (group->nr_pending.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
     }
+
+    //! close the group, and wait for workers which have joined but found no
+    //! sub task to leave, so the group can be reused by the next task
+    group->state.store(TaskGroup::CLOSED);
+    while (group->nr_running.load()) {
+        std::this_thread::yield();
+    }
+    group->task_elem = nullptr;
+    group->state.store(TaskGroup::FREE, std::memory_order_release);
+}
+
+void ThreadPool::set_schedule_mode(ScheduleMode mode) {
+    std::lock_guard<std::mutex> lock_task(m_mutex_task);
+    if (m_schedule_mode.load() == mode) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_schedule_mode.store(mode, std::memory_order_release);
+    m_cv.notify_all();
 }
 
 void ThreadPool::set_affinity(AffinityCallBack affinity_cb) {
@@ -18,6 +18,7 @@
 #include <exception>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 
 #include <cstdarg>
@@ -215,12 +216,14 @@ void __log__(
 //! disable some MegEngine feature on xp sp2 env, for exampe, multi-thread etc!
 #define MGB_MUTEX                  size_t
 #define MGB_RECURSIVE_MUTEX        size_t
+#define MGB_SHARED_MUTEX           size_t
 #define MGB_LOCK_GUARD(mtx)        MGB_MARK_USED_VAR(mtx)
 #define MGB_LOCK_GUARD_UNIQUE(mtx) MGB_MARK_USED_VAR(mtx)
-#define MGB_LOCK_GUARD_SHARED(mtx) MGB_MARK_USED_VAR(MGB_MARK_USED_VAR)
+#define MGB_LOCK_GUARD_SHARED(mtx) MGB_MARK_USED_VAR(mtx)
 #else
 #define MGB_MUTEX           std::mutex
 #define MGB_RECURSIVE_MUTEX std::recursive_mutex
+#define MGB_SHARED_MUTEX    std::shared_timed_mutex
 #define MGB_LOCK_GUARD(mtx) std::lock_guard<decltype(mtx)> MGB_LOCK_GUARD_CTOR(mtx)
 
 #define MGB_LOCK_GUARD_UNIQUE(mtx) \
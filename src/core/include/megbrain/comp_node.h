@@ -123,11 +123,23 @@ public:
             int nr_threads;
         };
 
+        /*!
+         * NUMA node of a CPU comp node, or -1 if unspecified; the worker
+         * threads are placed on the CPU cores of this node and the memory is
+         * allocated from it; must be less than MAX_NR_NUMA_NODE
+         */
+        int numa_node = -1;
+
+        //! upper bound of numa_node, which is the largest node count a
+        //! Linux kernel can be configured with (NODES_SHIFT <= 10)
+        static constexpr int MAX_NR_NUMA_NODE = 1024;
+
         /*!
          * \brief parse a string identifier
          *
          * currently supported ID format: (gpu|cpu)<n>[:m] where n is the
-         * device number, possibly with m as the stream id.
+         * device number, possibly with m as the stream id. CPU comp nodes
+         * can be placed on a NUMA node by appending @numa<k>.
          */
         static Locator parse(const std::string& id);
 
@@ -157,7 +169,8 @@ public:
         std::string to_string() const;
 
         bool operator==(const Locator& rhs) const {
-            return type == rhs.type && device == rhs.device && stream == rhs.stream;
+            return type == rhs.type && device == rhs.device && stream == rhs.stream &&
+                   numa_node == rhs.numa_node;
         }
     };
 
@@ -690,7 +703,8 @@ template <>
 struct HashTrait<CompNode::Locator> {
     static size_t eval(const CompNode::Locator& val) {
         return static_cast<size_t>(val.device) + (static_cast<size_t>(val.type) << 4) +
-               (static_cast<size_t>(val.stream) << 8);
+               (static_cast<size_t>(val.stream) << 8) +
+               (static_cast<size_t>(val.numa_node + 1) << 24);
     }
 };
 
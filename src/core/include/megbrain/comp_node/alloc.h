@@ -382,6 +382,72 @@ public:
     size_t alignment() const { return m_alignment; };
 };
 
+/* ===================== CpuCachingAlloc  ===================== */
+/*!
+ * \brief caching allocator for CPU comp nodes
+ *
+ * Small blocks are rounded to size classes and kept in caches selected by
+ * the calling thread, so that a block freed on the worker thread can be
+ * reused by the next allocation without locking the whole allocator. Other
+ * blocks are allocated by best-fit from chunks requested from the raw
+ * allocator.
+ *
+ * The allocator is referenced by the header of each block it allocates, so
+ * free() is static and it stays alive until all its blocks are freed, even if
+ * the owner has released it.
+ *
+ * All methods are thread safe.
+ */
+class CpuCachingAlloc : virtual public MemAllocBase {
+protected:
+    //! called when the owner releases this allocator
+    virtual void release() = 0;
+
+public:
+    struct Deleter {
+        void operator()(CpuCachingAlloc* alloc) { alloc->release(); }
+    };
+    using UniquePtr = std::unique_ptr<CpuCachingAlloc, Deleter>;
+
+    struct Stat {
+        size_t reserved;      //!< total size of chunks from the raw allocator
+        size_t used;          //!< total size of live blocks
+        size_t cached;        //!< total size of blocks in the small block caches
+        size_t nr_alloc;      //!< number of calls to alloc()
+        size_t nr_cache_hit;  //!< number of alloc() served by the caches
+        size_t nr_raw_alloc;  //!< number of chunks from the raw allocator
+    };
+
+    /*!
+     * \brief create a new allocator
+     * \param raw_alloc the raw allocator to request chunks from, whose
+     *      addresses must be aligned to \p alignment
+     * \param alignment alignment of allocated addresses, which must be a
+     *      power of 2
+     */
+    static UniquePtr make(std::unique_ptr<RawAllocator> raw_alloc, size_t alignment);
+
+    /*!
+     * \brief allocate memory; MemAllocError is thrown if the raw allocator
+     *      fails even after trim()
+     */
+    virtual void* alloc(size_t size) = 0;
+
+    //! free memory returned by alloc() of any CpuCachingAlloc
+    static void free(void* ptr);
+
+    /*!
+     * \brief move all the cached blocks back to the free list, and release
+     *      the chunks that become entirely free to the raw allocator
+     * \return number of bytes released
+     */
+    virtual size_t trim() = 0;
+
+    virtual Stat get_stat() = 0;
+
+    virtual ~CpuCachingAlloc() = default;
+};
+
 }  // namespace mem_alloc
 }  // namespace mgb
 
@@ -15,6 +15,7 @@
 #include "megbrain/comp_node.h"
 #include "megbrain/utils/metahelper.h"
 #include "megbrain/utils/thread.h"
+#include "megbrain/utils/thread_pool.h"
 #include "megbrain_build_config.h"
 
 #include "megdnn/handle.h"
@@ -224,6 +225,11 @@ public:
     virtual void set_affinity(AffinityCallBack&& /*affinity_cb*/) {
         mgb_assert(0, "The CompNode set_affinity is not implement");
     }
+    //! set how the multithreading tasks are scheduled on the thread pool,
+    //! it has no effect if the comp node has no thread pool
+    virtual void set_schedule_mode(ThreadPoolScheduleMode /*mode*/) {
+        mgb_assert(0, "The CompNode set_schedule_mode is not implement");
+    }
 };
 using AtlasDispatcher = CPUDispatcher;
 
@@ -513,6 +519,10 @@ public:
         void set_affinity(AffinityCallBack&& cb) const {
             dispatcher->set_affinity(std::move(cb));
         }
+
+        void set_schedule_mode(ThreadPoolScheduleMode mode) const {
+            dispatcher->set_schedule_mode(mode);
+        }
     };
 
     const CpuEnv& cpu_env() const {
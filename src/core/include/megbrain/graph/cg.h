@@ -89,6 +89,8 @@ struct GraphCommonOptimizeOptions {
     bool f16_io_f32_comp = false;
     //! whether to enable tranform to pure float16 model
     bool f16_io_comp = false;
+    //! whether to enable IO in bfloat16 compute in float32
+    bool bf16_io_f32_comp = false;
     //! whether to enable conv bias nonlinearity fusion
     bool fuse_conv_bias_nonlinearity = false;
     //! fuse pattern like ReLU(conv_bias(x, w, b) + z) or conv_bias(x, w, b)
@@ -100,6 +102,12 @@ struct GraphCommonOptimizeOptions {
     bool weight_preprocess = false;
     //! fuse preprocess patten, like astype + pad_channel + dimshuffle
     bool fuse_preprocess = false;
+    //! fuse exp(x - max(x)) / sum(exp(x - max(x))) into a Softmax opr
+    bool fuse_softmax = false;
+    //! fuse (x - mean(x)) / sqrt(var(x) + eps) into a LayerNorm opr
+    bool fuse_layer_norm = false;
+    //! fuse softmax(q * k^T * scale + mask) * v into an Attention opr
+    bool fuse_attention = false;
     enum LayoutTransform : uint32_t {
         DEFAULT,
         NCHW4,       ///< compute using NCHW4 tensor format
@@ -129,10 +137,14 @@ struct GraphCommonOptimizeOptions {
 
     SET(f16_io_f32_comp);
     SET(f16_io_comp);
+    SET(bf16_io_f32_comp);
     SET(fuse_conv_bias_nonlinearity);
     SET(fuse_conv_bias_with_z);
     SET(fuse_preprocess);
     SET(weight_preprocess);
+    SET(fuse_softmax);
+    SET(fuse_layer_norm);
+    SET(fuse_attention);
 #undef SET
 #define SET(_trans, _trans_capital)                                 \
     GraphCommonOptimizeOptions& enable_##_trans() {                 \
@@ -320,9 +332,30 @@ public:
             //! static memory allocation algorithm)
             bool enable_mem_reuse_alloc = true;
 
+            //! time budget in seconds for searching a better static memory
+            //! allocation by branch-and-bound, which is useful to reduce
+            //! peak memory when planning cost does not matter; the faster
+            //! heuristic allocator is used if it is zero
+            double mem_reuse_alloc_search_time = 0;
+
+            //! max number of recently seen shapes whose static memory
+            //! allocation plans, and whose algorithms and workspace sizes of
+            //! each fastrun opr, are cached, so that they are looked up rather
+            //! than planned or chosen again when the input shapes switch back
+            //! to previously seen ones; 0 to disable the cache
+            size_t static_mem_plan_cache_size = 8;
+
             //! whether to enable comp node optimization (e.g. using copy
             //! stream for I/O operators)
             bool enable_seq_comp_node_opt = true;
+
+            //! max number of lanes that the independent branches of a graph
+            //! on a single CPU comp node are distributed to, so they run
+            //! concurrently; the extra lanes of a CPU comp node have their own
+            //! worker threads, while the threads of a multithread comp node
+            //! are split between all the lanes by their loads; 0 or 1 to
+            //! disable
+            size_t cpu_inter_op_parallelism = 0;
         } seq_opt;
 
         //! graph optimization options
@@ -541,6 +574,20 @@ public:
              * equal
              */
             bool binary_equal_between_batch = false;
+
+            /*!
+             * \brief max number of algorithms to be profiled for each opr
+             *
+             * Candidates are ranked with the heuristic choice first and naive
+             * algorithms last, and only the leading ones are profiled (along
+             * with their sub-oprs). Zero means profiling all the candidates.
+             *
+             * When set, the searches of all the oprs in the graph are also
+             * deduplicated and profiled together, and the independent ones
+             * on CPU comp nodes run concurrently, each on its own cores and
+             * without the profiling timeout.
+             */
+            uint32_t max_profile_candidates = 0;
         } fast_run_config;
 
     };  // Options
@@ -127,6 +127,10 @@ struct StaticMemAlloc {
     bool* need_realloc;
     CompNode comp_node;
     size_t alloc_size;
+    //! whether the allocation is taken from the cache of solved plans (see
+    //! ComputingGraph::Options::SeqOpt::static_mem_plan_cache_size) rather
+    //! than solved again
+    bool plan_reused;
 
     MGB_TYPEINFO_OBJ_DECL;
 };
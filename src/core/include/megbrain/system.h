@@ -41,6 +41,22 @@ int get_cpu_count();
 //! set cpu affinity for caller thread
 void set_cpu_affinity(const std::vector<int>& cpuset);
 
+//! get number of NUMA nodes on this system; 1 if NUMA is not supported
+int get_numa_node_count();
+
+//! get IDs of the CPU cores on a NUMA node, or empty if they are unknown
+std::vector<int> get_numa_node_cpus(int node);
+
+/*!
+ * \brief set the memory policy of an address range to prefer a NUMA node
+ *
+ * Physical pages are placed when they are first touched, so this should be
+ * called before the memory is written; pages that have already been touched
+ * are migrated to the node. Only the pages that are entirely in the range are
+ * affected. Failures are ignored since the policy only affects performance.
+ */
+void bind_mem_to_numa_node(void* ptr, size_t size, int node);
+
 //! whether stderr supports ansi color code
 bool stderr_ansi_color();
 
@@ -0,0 +1,108 @@
+/**
+ * \file src/core/include/megbrain/utils/mmap_persistent_cache.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/utils/persistent_cache.h"
+
+namespace mgb {
+
+/*!
+ * \brief persistent cache backed by an append-only log file that is shared
+ *      by multiple processes
+ *
+ * The file starts with a fixed-size hash index whose buckets store the
+ * offset of the newest record in each bucket chain; records are appended to
+ * the end of the file and never modified, so a newer record shadows the older
+ * ones with the same category and key.
+ *
+ * Lookups read the memory-mapped file directly without any file lock, and
+ * the returned blobs stay valid until this object is destructed. put()
+ * appends the record under an exclusive file lock and then publishes it by
+ * atomically updating the bucket, so concurrent readers in other processes
+ * either see the complete record or do not see it at all.
+ *
+ * When the file is opened, shadowed records and garbage left by crashed
+ * writers are dropped, and the index is resized according to the number of
+ * records. This is done by writing a new file and renaming it over the old
+ * one; the old file is marked obsolete so that other processes switch to the
+ * new file on their next put() or cache miss.
+ *
+ * This is only available on platforms supporting mmap and flock.
+ */
+class MmapPersistentCache final : public PersistentCache {
+    struct FileHeader;
+    struct RecordHeader;
+    struct Mapping {
+        void* addr;
+        size_t size;
+    };
+
+    const std::string m_path;
+    int m_fd = -1;
+    //! mapping of current file, which may be larger than the file
+    Mapping m_cur_mapping{nullptr, 0};
+    //! file size known to be covered by m_cur_mapping
+    size_t m_cur_file_size = 0;
+    //! all mappings that have been created, which are kept alive for the
+    //! returned blobs until destruction
+    std::vector<Mapping> m_mappings;
+    MGB_MUTEX m_mtx;
+
+    static std::vector<uint8_t> make_empty_file(uint64_t nr_bucket);
+
+    static bool record_eq(
+            const RecordHeader* rec, uint64_t hash, const void* category,
+            size_t category_size, const void* key, size_t key_size);
+
+    //! open the file at m_path and compact it if needed
+    void open_file();
+
+    //! close current file; the mappings are kept
+    void close_file();
+
+    //! ensure that current mapping covers the given range of the file;
+    //! return false if the file is not large enough
+    bool ensure_mapped(size_t offset, size_t size);
+
+    FileHeader* header() const;
+
+    //! whether current file has been replaced by a compacted one
+    bool obsolete() const;
+
+    //! get the record at given offset, or nullptr if it is out of range
+    const RecordHeader* get_record(uint64_t offset);
+
+    //! find the newest record with given category and key
+    const RecordHeader* find(
+            uint64_t hash, const std::string& category, const Blob& key);
+
+    //! offsets of records not shadowed by newer ones, in ascending order
+    std::vector<uint64_t> collect_live_records();
+
+    //! compact current file, which must be locked; return whether the file
+    //! has been replaced
+    bool compact_if_needed();
+
+public:
+    explicit MmapPersistentCache(std::string path);
+    ~MmapPersistentCache();
+
+    Maybe<Blob> get(const std::string& category, const Blob& key) override;
+    void put(const std::string& category, const Blob& key, const Blob& value) override;
+
+    //! number of live records in the index, mainly for testing
+    size_t nr_record();
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
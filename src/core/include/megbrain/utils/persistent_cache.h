@@ -54,7 +54,10 @@ public:
 
 /*!
  * \brief persistent cache that keep in memory
- * The implementation is thread safe.
+ *
+ * The implementation is thread safe. Entries are split into shards by key
+ * hash, each of which is guarded by a reader-writer lock, so concurrent
+ * lookups neither block each other nor contend on a single lock.
  */
 class InMemoryPersistentCache final : public PersistentCache {
     struct BlobStorage : public PersistentCache::Blob {
@@ -72,14 +75,30 @@ class InMemoryPersistentCache final : public PersistentCache {
         };
     };
 
+    static constexpr size_t NR_SHARD = 16;
+
+    struct Shard {
+        std::unordered_map<
+                std::string,
+                std::unordered_map<BlobStorage, BlobStorage, BlobStorage::Hash>>
+                cache;
+        std::atomic_size_t nr_hit{0}, nr_miss{0};
+        MGB_SHARED_MUTEX mtx;
+    };
+
+    Shard m_shards[NR_SHARD];
+
     Maybe<Blob> get(const std::string& category, const Blob& key) override;
     void put(const std::string& category, const Blob& key, const Blob& value) override;
 
-    std::unordered_map<
-            std::string,
-            std::unordered_map<BlobStorage, BlobStorage, BlobStorage::Hash>>
-            m_cache;
-    MGB_MUTEX m_mtx;
+public:
+    struct Stats {
+        size_t nr_hit = 0;
+        size_t nr_miss = 0;
+    };
+
+    //! number of cache hits and misses of get()
+    Stats stats() const;
 };
 
 /*!
@@ -23,6 +23,7 @@ namespace mgb {
 class Spinlock final : public NonCopyableObj {
 public:
     void lock() {}
+    bool try_lock() { return true; }
     void unlock() {}
 };
 
@@ -28,6 +28,8 @@ public:
         };
     }
 
+    bool try_lock() { return !m_state.test_and_set(std::memory_order_acquire); }
+
     void unlock() { m_state.clear(std::memory_order_release); }
 };
 
@@ -17,6 +17,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -34,6 +35,22 @@ struct TaskElem {
     MultiThreadingTask task;
     //! number of the parallelism
     size_t nr_parallelism;
+    //! number of sub tasks a worker takes from its range at a time in the
+    //! WORK_STEALING schedule mode, 0 means chosen by the thread pool
+    size_t grain_size = 0;
+};
+
+/**
+ * \brief how the sub tasks of a TaskElem are distributed among the workers
+ */
+enum class ThreadPoolScheduleMode : uint32_t {
+    //! all the workers fetch one sub task at a time from a shared counter,
+    //! idle workers busy wait until the pool is deactived
+    SHARED_COUNTER = 0,
+    //! the sub tasks are split into one contiguous range per worker, a worker
+    //! which runs out of work steals half of the remaining range of another
+    //! worker; idle workers spin for a short while and then go to sleep
+    WORK_STEALING = 1,
 };
 
 #if MGB_HAVE_THREAD
@@ -58,10 +75,21 @@ public:
  */
 class ThreadPool : public NonCopyableObj {
 public:
-    //! Create thread-pool nr_threads thread_pool
+    using ScheduleMode = ThreadPoolScheduleMode;
+
+    //! Create thread-pool nr_threads thread_pool, the default schedule mode
+    //! can be overwritten by env var MGB_THREAD_POOL_SCHEDULE
     ThreadPool(size_t nr_threads);
-    //! The main thread set the task, parallelism and worker flag to
-    //! notify other thread.
+    ThreadPool(size_t nr_threads, ScheduleMode mode);
+    /*!
+     * \brief the calling thread set the task, parallelism and worker flag to
+     * notify other thread, and wait for the task finished.
+     *
+     * In WORK_STEALING mode, add_task can be called concurrently by different
+     * threads or from inside a running task, the workers would be split
+     * between the tasks. In SHARED_COUNTER mode, concurrent calls are
+     * serialized and nested calls are executed by the calling thread alone.
+     */
     void add_task(const TaskElem& task_elem);
 
     size_t nr_threads() const;
@@ -75,9 +103,82 @@ public:
     void active();
     //! all the threads go to sleep which will reduce CPU occupation
     void deactive();
+
+    /*!
+     * \brief change the schedule mode
+     *
+     * It waits for the running task in SHARED_COUNTER mode, but not for the
+     * tasks dispatched in WORK_STEALING mode: they can still be running after
+     * the switch, and workers which have left would leave the remaining sub
+     * tasks to the submitting threads.
+     */
+    void set_schedule_mode(ScheduleMode mode);
+    ScheduleMode schedule_mode() const {
+        return m_schedule_mode.load(std::memory_order_relaxed);
+    }
     ~ThreadPool();
 
 private:
+    /*!
+     * \brief the range [begin, end) of sub tasks owned by one thread in
+     * WORK_STEALING mode, packed into one word so that both the owner and the
+     * thieves can update it by a single CAS; it is padded to the size of a
+     * cache line so that the ranges of different threads never share one,
+     * which does not rely on the alignment of the array allocation
+     */
+    struct TaskRange {
+        std::atomic<uint64_t> range{0};
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+
+        static uint64_t pack(uint32_t begin, uint32_t end) {
+            return (static_cast<uint64_t>(begin) << 32) | end;
+        }
+        static uint32_t begin(uint64_t r) { return static_cast<uint32_t>(r >> 32); }
+        static uint32_t end(uint64_t r) { return static_cast<uint32_t>(r); }
+    };
+
+    /*!
+     * \brief a multithreading task being executed in WORK_STEALING mode
+     *
+     * Several task groups can be open at the same time, either submitted by
+     * different threads or nested inside a running task, and the idle
+     * workers are split between them.
+     */
+    struct TaskGroup {
+        enum State : uint32_t { FREE = 0, SETUP, OPEN, CLOSED };
+        std::atomic<uint32_t> state{FREE};
+        //! number of workers which have joined this group
+        std::atomic_size_t nr_running{0};
+        //! number of the sub tasks not finished
+        std::atomic_size_t nr_pending{0};
+        const TaskElem* task_elem = nullptr;
+        size_t grain_size = 1;
+        //! one range for each thread id
+        std::unique_ptr<TaskRange[]> ranges;
+    };
+    //! max number of task groups which can be open at the same time, more
+    //! tasks would be executed by the submitting thread alone
+    static constexpr size_t MAX_NR_TASK_GROUP = 8;
+
+    void worker_main(size_t id);
+    //! the worker loop of SHARED_COUNTER mode, return when mode changed or
+    //! the pool stopped
+    void shared_counter_worker_loop(size_t id);
+    //! the worker loop of WORK_STEALING mode, return when mode changed or
+    //! the pool stopped
+    void work_stealing_worker_loop(size_t id);
+    void add_task_shared_counter(const TaskElem& task_elem);
+    void add_task_work_stealing(const TaskElem& task_elem);
+    //! join the open task groups with unfinished sub tasks, prefer the group
+    //! with the fewest workers; return whether any sub task is executed
+    bool work_stealing_join_groups(size_t id);
+    //! run the sub tasks of group owned by thread id and steal from others
+    //! until no sub task is left; return whether any sub task is executed
+    bool work_stealing_run(TaskGroup& group, size_t id);
+    //! check and bind the current worker thread if required
+    void bind_worker_affinity(size_t id);
+
+    std::atomic<ScheduleMode> m_schedule_mode{ScheduleMode::SHARED_COUNTER};
     size_t m_nr_threads = 1;
     //! Indicate whether the main thread have binding
     bool m_main_affinity_flag;
@@ -97,6 +198,15 @@ private:
     std::condition_variable m_cv;
     std::mutex m_mutex;
     std::mutex m_mutex_task;
+
+    //! the following are used by WORK_STEALING mode
+    std::unique_ptr<TaskGroup[]> m_task_groups;
+    //! max number of spins before an idle worker goes to sleep
+    size_t m_max_spin = 0;
+    //! increased whenever a task group is opened, used to wake up workers
+    std::atomic_size_t m_group_epoch{0};
+    //! number of workers sleeping on m_cv
+    std::atomic_size_t m_nr_sleeping{0};
 };
 #else
 /**
@@ -104,12 +214,16 @@ private:
  */
 class ThreadPool : public NonCopyableObj {
 public:
+    using ScheduleMode = ThreadPoolScheduleMode;
     ThreadPool(size_t) {}
+    ThreadPool(size_t, ScheduleMode) {}
     void add_task(const TaskElem& task_elem);
     void set_affinity(AffinityCallBack affinity_cb);
     void active() {}
     void deactive() {}
     void sync() {}
+    void set_schedule_mode(ScheduleMode) {}
+    ScheduleMode schedule_mode() const { return ScheduleMode::SHARED_COUNTER; }
     ~ThreadPool() {}
     size_t nr_threads() const { return 1_z; }
 };
@@ -18,10 +18,15 @@
 #include "megbrain/utils/comp_node_sync_manager.h"
 #include "megbrain/utils/timer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #if MGB_HAVE_THREAD
 #include <thread>
 #endif
+#if defined(__linux) && !defined(ANDROID) && !defined(__ANDROID__)
+#include <sched.h>
+#endif
 
 using namespace mgb;
 
@@ -61,6 +66,16 @@ TEST(TestCompNode, Parse) {
     ASSERT_EQ(
             L::parse("multithread:default:2"),
             make_lc(D::MULTITHREAD, L::DEVICE_MULTITHREAD_DEFAULT, 2));
+    {
+        auto loc = make_lc(D::CPU, 2, 3);
+        loc.numa_node = 1;
+        ASSERT_EQ(L::parse("cpu2:3@numa1"), loc);
+        ASSERT_EQ("cpu2:3@numa1", loc.to_string());
+        loc = make_lc(D::MULTITHREAD, 0, 4);
+        loc.numa_node = 12;
+        ASSERT_EQ(L::parse("multithread4:0@numa12"), loc);
+        ASSERT_EQ(L::parse(loc.to_string()), loc);
+    }
 
     ASSERT_THROW(L::parse("apu"), MegBrainError);
     ASSERT_THROW(L::parse("fpgbx"), MegBrainError);
@@ -77,6 +92,12 @@ TEST(TestCompNode, Parse) {
     ASSERT_THROW(L::parse("multithread1:"), MegBrainError);
     ASSERT_THROW(L::parse("multithread1:default"), MegBrainError);
     ASSERT_THROW(L::parse("multithread1:default:0"), MegBrainError);
+    ASSERT_THROW(L::parse("cpu0@"), MegBrainError);
+    ASSERT_THROW(L::parse("cpu0@numa"), MegBrainError);
+    ASSERT_THROW(L::parse("cpu0@numa1x"), MegBrainError);
+    ASSERT_THROW(L::parse("gpu0@numa1"), MegBrainError);
+    ASSERT_THROW(L::parse("cpu0@numa1024"), MegBrainError);
+    ASSERT_THROW(L::parse("cpu0@numa99999999999"), MegBrainError);
 }
 
 TEST(TestCompNode, SetDefaultDev) {
@@ -247,6 +268,39 @@ TEST(TestCompNodeCPU, CoreAffinity) {
     ASSERT_EQ(data_v[1], static_cast<size_t>(30));
 }
 
+TEST(TestCompNodeCPU, NumaNode) {
+    REQUIRE_THREAD();
+    auto cpus = sys::get_numa_node_cpus(0);
+    for (auto&& name : {"cpu3@numa0", "multithread2:3@numa0"}) {
+        auto cn = CompNode::load(name);
+        ASSERT_EQ(0, cn.locator().numa_node);
+        ASSERT_FALSE(CompNode::Locator::parse("cpu3") == cn.locator());
+        ASSERT_EQ(CompNode::default_cpu().mem_node(), cn.mem_node());
+
+        constexpr size_t SIZE = 1 << 20;
+        auto ptr = static_cast<int*>(cn.alloc_device(SIZE * sizeof(int)));
+        std::atomic_size_t nr_bad_cpu{0};
+        auto task = [&](size_t index, size_t) {
+            for (size_t i = index; i < SIZE; i += 4) {
+                ptr[i] = i;
+            }
+#if defined(__linux) && !defined(ANDROID) && !defined(__ANDROID__)
+            if (!cpus.empty() &&
+                std::find(cpus.begin(), cpus.end(), sched_getcpu()) == cpus.end()) {
+                ++nr_bad_cpu;
+            }
+#endif
+        };
+        CompNodeEnv::from_comp_node(cn).cpu_env().dispatch(task, 4u);
+        cn.sync();
+        ASSERT_EQ(0u, nr_bad_cpu.load());
+        for (size_t i = 0; i < SIZE; ++i) {
+            ASSERT_EQ(static_cast<int>(i), ptr[i]);
+        }
+        cn.free_device(ptr);
+    }
+}
+
 TEST(TestCompNode, CPU_MULTI_THREAD) {
     REQUIRE_THREAD();
     std::vector<int> source(100), dst0(100), dst1(100);
@@ -25,6 +25,7 @@
 #include "megbrain/opr/tensor_manip.h"
 #include "megbrain/opr/utility.h"
 #include "megbrain/plugin/profiler.h"
+#include "megbrain/system.h"
 #include "megbrain/utils/timer.h"
 
 #include "megbrain/test/helper.h"
@@ -1795,6 +1796,79 @@ TEST(TestGraph, In2OutOpStreamPropagate) {
         }
 }
 
+TEST(TestGraph, CPUInterOpParallelism) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({64, 64}, cn), host_w0 = gen({64, 64}, cn),
+         host_w1 = gen({64, 64}, cn);
+    HostTensorND host_y[2];
+    for (int i = 0; i < 2; ++i) {
+        auto graph = ComputingGraph::make();
+        graph->options().seq_opt.cpu_inter_op_parallelism = i ? 2 : 0;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+             w0 = opr::SharedDeviceTensor::make(*graph, *host_w0),
+             w1 = opr::SharedDeviceTensor::make(*graph, *host_w1),
+             a = opr::MatrixMul::make(opr::MatrixMul::make(x, w0), w0),
+             b = opr::MatrixMul::make(opr::MatrixMul::make(x, w1), w1), y = a + b;
+        auto func = graph->compile({make_callback_copy(y, host_y[i])});
+        func->execute();
+        auto cn_a = a.node()->comp_node(), cn_b = b.node()->comp_node();
+        if (i) {
+            // one branch stays on the original comp node, and the other one
+            // runs on a lane comp node of another device that is not a cpu
+            // core, so it is never bound to the core of cpu0
+            ASSERT_NE(cn_a, cn_b);
+            ASSERT_TRUE(cn_a == cn || cn_b == cn);
+            auto other = cn_a == cn ? cn_b : cn_a;
+            ASSERT_EQ(CompNode::DeviceType::CPU, other.device_type());
+            ASSERT_GE(other.locator().device, sys::get_cpu_count());
+        } else {
+            ASSERT_EQ(cn, cn_a);
+            ASSERT_EQ(cn, cn_b);
+        }
+    }
+    MGB_ASSERT_TENSOR_NEAR(host_y[0], host_y[1], 1e-6);
+}
+
+TEST(TestGraph, CPUInterOpParallelismMultithread) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("multithread0:4");
+    auto host_x = gen({64, 64}, cn), host_w0 = gen({64, 64}, cn),
+         host_w1 = gen({64, 64}, cn);
+    HostTensorND host_y[2];
+    for (int i = 0; i < 2; ++i) {
+        auto graph = ComputingGraph::make();
+        graph->options().seq_opt.cpu_inter_op_parallelism = i ? 2 : 0;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+             w0 = opr::SharedDeviceTensor::make(*graph, *host_w0),
+             w1 = opr::SharedDeviceTensor::make(*graph, *host_w1);
+        // branch a has four times the computation of branch b
+        auto a = x;
+        for (int j = 0; j < 4; ++j) {
+            a = opr::MatrixMul::make(a, w0);
+        }
+        auto b = opr::MatrixMul::make(x, w1), y = a + b;
+        auto func = graph->compile({make_callback_copy(y, host_y[i])});
+        func->execute();
+        auto cn_a = a.node()->comp_node(), cn_b = b.node()->comp_node();
+        if (!i) {
+            ASSERT_EQ(cn, cn_a);
+            ASSERT_EQ(cn, cn_b);
+            continue;
+        }
+        // both branches leave the original comp node, and its threads are
+        // split between them by their loads
+        ASSERT_NE(cn_a, cn_b);
+        ASSERT_NE(cn, cn_a);
+        ASSERT_NE(cn, cn_b);
+        ASSERT_EQ(CompNode::DeviceType::MULTITHREAD, cn_a.device_type());
+        ASSERT_EQ(CompNode::DeviceType::MULTITHREAD, cn_b.device_type());
+        ASSERT_EQ(3, cn_a.locator().nr_threads);
+        ASSERT_EQ(1, cn_b.locator().nr_threads);
+    }
+    MGB_ASSERT_TENSOR_NEAR(host_y[0], host_y[1], 1e-6);
+}
+
 TEST(TestGraph, OperatorNodeConfigInstanceID) {
     OperatorNodeConfig config0, config1;
     void *p0 = &config0, *p1 = &config1;
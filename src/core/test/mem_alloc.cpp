@@ -17,9 +17,13 @@
 #include "megbrain/opr/utility.h"
 #include "megbrain/test/helper.h"
 
+#include "../impl/comp_node/mem_alloc/impl.h"
+
 #include <atomic>
+#include <cstring>
 #include <map>
 #include <random>
+#include <set>
 #include <thread>
 
 using namespace mgb;
@@ -511,6 +515,114 @@ TEST(TestSimpleCachingAlloc, Basic) {
     EXPECT_EQ(0u, raw_alloc->nr_free());
 };
 
+namespace {
+//! raw allocator by malloc, which counts the live chunks
+class MallocAllocator final : public RawAllocator {
+    std::atomic_size_t& m_nr_chunk;
+
+public:
+    explicit MallocAllocator(std::atomic_size_t& nr_chunk) : m_nr_chunk(nr_chunk) {}
+
+    void* alloc(size_t size) override {
+        ++m_nr_chunk;
+        return ::malloc(size);
+    }
+
+    void free(void* ptr) override {
+        --m_nr_chunk;
+        ::free(ptr);
+    }
+
+    void get_mem_info(size_t& free, size_t& tot) override { free = tot = 0; }
+};
+}  // anonymous namespace
+
+TEST(TestCpuCachingAlloc, Basic) {
+    std::atomic_size_t nr_chunk{0};
+    auto alloc = CpuCachingAlloc::make(std::make_unique<MallocAllocator>(nr_chunk), 16);
+
+    // small blocks of the same size class are reused
+    auto ptr0 = alloc->alloc(100);
+    ASSERT_EQ(0u, reinterpret_cast<size_t>(ptr0) % 16);
+    memset(ptr0, -1, 100);
+    CpuCachingAlloc::free(ptr0);
+    auto ptr1 = alloc->alloc(120);
+    ASSERT_EQ(ptr0, ptr1);
+    auto stat = alloc->get_stat();
+    ASSERT_EQ(2u, stat.nr_alloc);
+    ASSERT_EQ(1u, stat.nr_cache_hit);
+    ASSERT_EQ(1u, stat.nr_raw_alloc);
+    ASSERT_EQ(256u, stat.used);
+    ASSERT_EQ(0u, stat.cached);
+
+    // large blocks are allocated by best fit from the chunk
+    constexpr size_t LARGE = 2 * 1024 * 1024;
+    auto ptr2 = alloc->alloc(LARGE);
+    memset(ptr2, -1, LARGE);
+    CpuCachingAlloc::free(ptr2);
+    auto ptr3 = alloc->alloc(LARGE);
+    ASSERT_EQ(ptr2, ptr3);
+    ASSERT_EQ(1u, nr_chunk.load());
+
+    CpuCachingAlloc::free(ptr3);
+    CpuCachingAlloc::free(ptr1);
+    stat = alloc->get_stat();
+    ASSERT_EQ(0u, stat.used);
+    ASSERT_EQ(256u, stat.cached);
+    ASSERT_EQ(stat.reserved, alloc->trim());
+    stat = alloc->get_stat();
+    ASSERT_EQ(0u, stat.reserved);
+    ASSERT_EQ(0u, stat.cached);
+    ASSERT_EQ(0u, nr_chunk.load());
+
+    alloc.reset();
+    ASSERT_EQ(0u, nr_chunk.load());
+}
+
+TEST(TestCpuCachingAlloc, SizeClass) {
+    using Impl = CpuCachingAllocImpl;
+    size_t prev = 0;
+    for (size_t i = 0; i < Impl::NR_SIZE_CLASS; ++i) {
+        auto size = Impl::class_size(i);
+        ASSERT_GT(size, prev);
+        ASSERT_EQ(i, Impl::size_class(size));
+        ASSERT_EQ(i, Impl::size_class(prev + 1));
+        prev = size;
+    }
+    ASSERT_EQ(Impl::MAX_SMALL_SIZE, prev);
+}
+
+TEST(TestCpuCachingAlloc, FreeOnOtherThread) {
+    std::atomic_size_t nr_chunk{0};
+    auto alloc = CpuCachingAlloc::make(std::make_unique<MallocAllocator>(nr_chunk), 16);
+    constexpr size_t NR_BLOCK = 16;
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < NR_BLOCK; ++i) {
+        ptrs.push_back(alloc->alloc(1000));
+    }
+    // blocks freed by the worker are reused by the caller
+    std::thread worker{[&ptrs]() {
+        for (auto i : ptrs) {
+            CpuCachingAlloc::free(i);
+        }
+    }};
+    worker.join();
+    std::set<void*> freed(ptrs.begin(), ptrs.end());
+    for (size_t i = 0; i < NR_BLOCK; ++i) {
+        ptrs[i] = alloc->alloc(1000);
+        ASSERT_TRUE(freed.count(ptrs[i]));
+    }
+    ASSERT_EQ(NR_BLOCK, alloc->get_stat().nr_cache_hit);
+
+    // the allocator lives until all the blocks are freed
+    alloc.reset();
+    ASSERT_EQ(1u, nr_chunk.load());
+    for (auto i : ptrs) {
+        CpuCachingAlloc::free(i);
+    }
+    ASSERT_EQ(0u, nr_chunk.load());
+}
+
 namespace {
 class DevicePolicy {
 public:
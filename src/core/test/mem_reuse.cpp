@@ -130,6 +130,62 @@ TEST(TestMemReuse, PureMLP1) {
     EXPECT_EQ(host_inp->layout().span().dist_byte() * 32 * 2, alloc_size);
 }
 
+TEST(TestMemReuse, StaticMemPlanCache) {
+    HostTensorGenerator<> gen;
+    CompNode cn = CompNode::load("cpu0");
+    auto host_inp = gen({4, 1, 16, 16}, cn), host_kern0 = gen({8, 1, 1, 1}, cn),
+         host_kern1 = gen({8, 8, 1, 1}, cn);
+    TensorShape shapes[] = {{4, 1, 16, 16}, {8, 1, 32, 16}, {4, 1, 16, 16},
+                            {2, 1, 8, 8},   {8, 1, 32, 16}, {2, 1, 8, 8}};
+    std::vector<std::shared_ptr<HostTensorND>> inputs;
+    for (auto&& shape : shapes) {
+        inputs.push_back(gen(shape, cn));
+    }
+
+    // graph 0 caches the plans, and graph 1 solves each of them
+    std::vector<size_t> alloc_sizes[2];
+    size_t nr_reused[2] = {0, 0};
+    std::vector<HostTensorND> outputs[2];
+    for (int i = 0; i < 2; ++i) {
+        auto graph = ComputingGraph::make();
+        if (i) {
+            graph->options().seq_opt.static_mem_plan_cache_size = 0;
+        }
+        auto inp = opr::Host2DeviceCopy::make(*graph, host_inp),
+             kern0 = opr::SharedDeviceTensor::make(*graph, *host_kern0),
+             kern1 = opr::SharedDeviceTensor::make(*graph, *host_kern1),
+             layer0 = make_conv(inp, kern0), layer1 = make_conv(layer0, kern1),
+             out = make_conv(layer1 + layer0, kern1) + 1;
+        auto hdl = graph->event().register_receiver<cg::event::StaticMemAlloc>(
+                [&](const cg::event::StaticMemAlloc& s) {
+                    if (s.comp_node.valid()) {
+                        alloc_sizes[i].push_back(s.alloc_size);
+                        nr_reused[i] += s.plan_reused;
+                    }
+                });
+        HostTensorND host_out;
+        auto func = graph->compile({make_callback_copy(out, host_out)});
+        for (auto&& input : inputs) {
+            host_inp->copy_from(*input);
+            func->execute();
+            outputs[i].emplace_back();
+            outputs[i].back().copy_from(host_out);
+        }
+    }
+
+    ASSERT_EQ(alloc_sizes[1], alloc_sizes[0]);
+    // the last three shapes are all seen before
+    ASSERT_EQ(6u, alloc_sizes[0].size());
+    ASSERT_EQ(3u, nr_reused[0]);
+    ASSERT_EQ(0u, nr_reused[1]);
+    ASSERT_EQ(alloc_sizes[0][0], alloc_sizes[0][2]);
+    ASSERT_EQ(alloc_sizes[0][1], alloc_sizes[0][4]);
+    ASSERT_EQ(alloc_sizes[0][3], alloc_sizes[0][5]);
+    for (size_t i = 0; i < outputs[0].size(); ++i) {
+        MGB_ASSERT_TENSOR_EQ(outputs[1][i], outputs[0][i]);
+    }
+}
+
 TEST(TestMemReuse, MultiCardSafety) {
     auto cns = load_multiple_xpus(3);
     static constexpr size_t N = 4;
@@ -24,7 +24,7 @@ using namespace cg;
         "static_mem_alloc disabled because it causes the program to crash at startup"
 #else
 
-#define ITER_ALGO(cb) cb(INTERVAL_MOVE) cb(BEST_FIT) cb(PUSHDOWN)
+#define ITER_ALGO(cb) cb(INTERVAL_MOVE) cb(BEST_FIT) cb(PUSHDOWN) cb(BRANCH_BOUND)
 
 namespace {
 
@@ -86,6 +86,7 @@ public:
         m_allocator = StaticMemAlloc::make(GetParam().algo);
         m_allocator->alignment(GetParam().align);
         m_allocator->padding(GetParam().padding);
+        m_allocator->time_budget(0.05);
     }
 };
 
@@ -233,6 +234,29 @@ TEST(TestStaticMemAllocAlgo, PushdownChain) {
     ASSERT_EQ(NR + NR - 1, allocator->tot_alloc());
 }
 
+TEST(TestStaticMemAllocAlgo, BranchBound) {
+    // (begin, end, size) where PUSHDOWN is not optimal
+    std::tuple<size_t, size_t, size_t> reqs[] = {{4, 5, 8}, {5, 6, 5}, {3, 4, 5},
+                                                 {3, 5, 5}, {3, 4, 5}, {2, 3, 4}};
+    size_t tot_alloc[2];
+    StaticMemAlloc::AllocatorAlgo algos[] = {
+            StaticMemAlloc::AllocatorAlgo::PUSHDOWN,
+            StaticMemAlloc::AllocatorAlgo::BRANCH_BOUND};
+    for (int i = 0; i < 2; ++i) {
+        auto allocator = StaticMemAlloc::make(algos[i]);
+        for (size_t j = 0; j < 6; ++j) {
+            allocator->add(
+                    std::get<0>(reqs[j]), std::get<1>(reqs[j]), std::get<2>(reqs[j]),
+                    makeuk(j));
+        }
+        allocator->solve();
+        ASSERT_EQ(15u, allocator->tot_alloc_lower_bound());
+        tot_alloc[i] = allocator->tot_alloc();
+    }
+    ASSERT_GT(tot_alloc[0], 15u);
+    ASSERT_EQ(15u, tot_alloc[1]);
+}
+
 #endif  // WIN32
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,113 @@
+/**
+ * \file src/core/test/utils/mmap_persistent_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/utils/mmap_persistent_cache.h"
+#include "megbrain/test/helper.h"
+
+#ifndef WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace mgb;
+
+namespace {
+using Blob = PersistentCache::Blob;
+
+Blob make_blob(const std::string& str) {
+    return {str.data(), str.size()};
+}
+
+void check_value(const Maybe<Blob>& got, const std::string& expect) {
+    ASSERT_TRUE(got.valid());
+    ASSERT_EQ(expect, std::string(static_cast<const char*>(got->ptr), got->size));
+}
+}  // anonymous namespace
+
+TEST(TestMmapPersistentCache, PutGet) {
+    auto fname = output_file("TestMmapPersistentCache.PutGet");
+    unlink(fname.c_str());
+    {
+        MmapPersistentCache cache{fname};
+        ASSERT_FALSE(cache.get("cat", make_blob("k")).valid());
+        cache.put("cat", make_blob("k"), make_blob("v0"));
+        auto v0 = cache.get("cat", make_blob("k"));
+        check_value(v0, "v0");
+        ASSERT_FALSE(cache.get("cat1", make_blob("k")).valid());
+
+        // newer records shadow older ones, and old blobs are still valid
+        cache.put("cat", make_blob("k"), make_blob("value1"));
+        check_value(cache.get("cat", make_blob("k")), "value1");
+        check_value(v0, "v0");
+
+        for (int i = 0; i < 3000; ++i) {
+            auto str = std::to_string(i);
+            cache.put("many", make_blob(str), make_blob(str + "v"));
+        }
+        ASSERT_EQ(3001u, cache.nr_record());
+    }
+
+    // compacted on open: shadowed record removed and index enlarged
+    MmapPersistentCache cache{fname};
+    ASSERT_EQ(3001u, cache.nr_record());
+    check_value(cache.get("cat", make_blob("k")), "value1");
+    for (int i = 0; i < 3000; ++i) {
+        auto str = std::to_string(i);
+        check_value(cache.get("many", make_blob(str)), str + "v");
+    }
+}
+
+TEST(TestMmapPersistentCache, MultiProcess) {
+    auto fname = output_file("TestMmapPersistentCache.MultiProcess");
+    unlink(fname.c_str());
+    constexpr int NR_PROC = 4, NR_PUT = 500;
+
+    MmapPersistentCache cache{fname};
+    cache.put("init", make_blob("k"), make_blob("v"));
+    for (int proc = 0; proc < NR_PROC; ++proc) {
+        if (!fork()) {
+            int ret = 0;
+            {
+                MmapPersistentCache child{fname};
+                for (int i = 0; i < NR_PUT; ++i) {
+                    auto key = ssprintf("%d:%d", proc, i);
+                    child.put("proc", make_blob(key), make_blob(key));
+                    ret |= !child.get("proc", make_blob(key)).valid();
+                }
+            }
+            _exit(ret);
+        }
+    }
+    for (int proc = 0; proc < NR_PROC; ++proc) {
+        int status;
+        wait(&status);
+        ASSERT_TRUE(WIFEXITED(status));
+        ASSERT_EQ(0, WEXITSTATUS(status));
+    }
+
+    // records appended by other processes are visible without reopening
+    for (int proc = 0; proc < NR_PROC; ++proc) {
+        for (int i = 0; i < NR_PUT; ++i) {
+            auto key = ssprintf("%d:%d", proc, i);
+            check_value(cache.get("proc", make_blob(key)), key);
+        }
+    }
+    ASSERT_EQ(1u + NR_PROC * NR_PUT, cache.nr_record());
+
+    // reopen to trigger compaction, and the old instance should follow
+    MmapPersistentCache cache_new{fname};
+    cache.put("after", make_blob("k"), make_blob("v1"));
+    check_value(cache_new.get("after", make_blob("k")), "v1");
+    check_value(cache.get("init", make_blob("k")), "v");
+}
+
+#endif  // WIN32
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,60 @@
+/**
+ * \file src/core/test/utils/persistent_cache.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/utils/persistent_cache.h"
+#include "megbrain/test/helper.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace mgb;
+
+TEST(TestInMemoryPersistentCache, ConcurrentGetPut) {
+    auto cache = std::make_shared<InMemoryPersistentCache>();
+    PersistentCache& pcache = *cache;
+    constexpr size_t NR_THREAD = 8, NR_KEY = 256, NR_ITER = 10;
+
+    std::atomic_size_t nr_error{0};
+    std::vector<std::thread> workers;
+    for (size_t tid = 0; tid < NR_THREAD; ++tid) {
+        workers.emplace_back([&, tid]() {
+            for (size_t iter = 0; iter < NR_ITER; ++iter) {
+                for (size_t i = 0; i < NR_KEY; ++i) {
+                    auto key = std::to_string((i + tid) % NR_KEY);
+                    auto val = key + "v";
+                    auto got = pcache.get("cat", {key.data(), key.size()});
+                    if (got.valid()) {
+                        nr_error += std::string(
+                                            static_cast<const char*>(got->ptr),
+                                            got->size) != val;
+                    } else {
+                        pcache.put(
+                                "cat", {key.data(), key.size()},
+                                {val.data(), val.size()});
+                    }
+                }
+            }
+        });
+    }
+    for (auto&& i : workers) {
+        i.join();
+    }
+    ASSERT_EQ(0u, nr_error.load());
+
+    auto stats = cache->stats();
+    ASSERT_EQ(NR_THREAD * NR_KEY * NR_ITER, stats.nr_hit + stats.nr_miss);
+    ASSERT_GE(stats.nr_miss, NR_KEY);
+
+    ASSERT_FALSE(pcache.get("cat1", {"0", 1}).valid());
+    ASSERT_EQ(stats.nr_miss + 1, cache->stats().nr_miss);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -12,6 +12,7 @@
 #include <atomic>
 #include <random>
 #include "megbrain/comp_node.h"
+#include "megbrain/comp_node_env.h"
 #include "megbrain/opr/io.h"
 #include "megbrain/opr/utility.h"
 #include "megbrain/system.h"
@@ -62,6 +63,144 @@ TEST(TestThreadPool, BASIC) {
     }
 }
 
+TEST(TestThreadPool, WORK_STEALING) {
+    using Mode = ThreadPool::ScheduleMode;
+    auto thread_pool = std::make_shared<ThreadPool>(4u, Mode::WORK_STEALING);
+    ASSERT_EQ(Mode::WORK_STEALING, thread_pool->schedule_mode());
+    for (size_t total_task : {2, 3, 7, 64, 1001}) {
+        for (size_t grain_size : {0, 1, 5}) {
+            std::vector<std::atomic_size_t> count(total_task);
+            for (auto&& i : count) {
+                i = 0;
+            }
+            std::atomic_bool bad_thread_id{false};
+            auto func = [&](size_t index, size_t thread_id) {
+                count[index]++;
+                if (thread_id >= 4) {
+                    bad_thread_id = true;
+                }
+            };
+            for (size_t run = 0; run < 10; ++run) {
+                thread_pool->add_task({func, total_task, grain_size});
+            }
+            ASSERT_FALSE(bad_thread_id);
+            for (size_t i = 0; i < total_task; ++i) {
+                ASSERT_EQ(10u, count[i]) << "total_task=" << total_task
+                                         << " grain_size=" << grain_size;
+            }
+        }
+    }
+}
+
+TEST(TestThreadPool, SWITCH_SCHEDULE_MODE) {
+    using Mode = ThreadPool::ScheduleMode;
+    auto thread_pool = std::make_shared<ThreadPool>(3u, Mode::SHARED_COUNTER);
+    std::atomic_size_t count{0};
+    auto func = [&](size_t, size_t) { count++; };
+    for (size_t i = 0; i < 6; ++i) {
+        thread_pool->set_schedule_mode(
+                i % 2 ? Mode::SHARED_COUNTER : Mode::WORK_STEALING);
+        thread_pool->active();
+        thread_pool->add_task({func, 20});
+        thread_pool->deactive();
+    }
+    ASSERT_EQ(120u, count);
+}
+
+TEST(TestThreadPool, NESTED_TASK) {
+    using Mode = ThreadPool::ScheduleMode;
+    for (auto mode : {Mode::SHARED_COUNTER, Mode::WORK_STEALING}) {
+        auto thread_pool = std::make_shared<ThreadPool>(4u, mode);
+        std::atomic_size_t count{0};
+        std::atomic_bool bad_thread_id{false};
+        auto inner = [&](size_t, size_t thread_id) {
+            if (thread_id >= 4) {
+                bad_thread_id = true;
+            }
+            count++;
+        };
+        auto outer = [&](size_t, size_t) { thread_pool->add_task({inner, 5}); };
+        thread_pool->active();
+        for (size_t i = 0; i < 20; ++i) {
+            thread_pool->add_task({outer, 6});
+        }
+        thread_pool->deactive();
+        ASSERT_FALSE(bad_thread_id);
+        ASSERT_EQ(20u * 6 * 5, count);
+    }
+}
+
+TEST(TestThreadPool, CONCURRENT_TASK) {
+    auto thread_pool =
+            std::make_shared<ThreadPool>(4u, ThreadPool::ScheduleMode::WORK_STEALING);
+    constexpr size_t NR_SUBMITTER = 6, NR_RUN = 50, NR_SUB_TASK = 17;
+    std::vector<std::atomic_size_t> count(NR_SUBMITTER);
+    std::atomic_bool bad_thread_id{false};
+    std::vector<std::thread> submitters;
+    for (size_t i = 0; i < NR_SUBMITTER; ++i) {
+        count[i] = 0;
+        submitters.emplace_back([&, i]() {
+            auto task = [&, i](size_t, size_t thread_id) {
+                if (thread_id >= 4) {
+                    bad_thread_id = true;
+                }
+                count[i]++;
+            };
+            for (size_t run = 0; run < NR_RUN; ++run) {
+                thread_pool->add_task({task, NR_SUB_TASK});
+            }
+        });
+    }
+    for (auto&& i : submitters) {
+        i.join();
+    }
+    ASSERT_FALSE(bad_thread_id);
+    for (size_t i = 0; i < NR_SUBMITTER; ++i) {
+        ASSERT_EQ(NR_RUN * NR_SUB_TASK, count[i]);
+    }
+}
+
+TEST(TestThreadPool, RepeatedDispatch) {
+    using Mode = ThreadPool::ScheduleMode;
+    size_t nr_threads = std::max(2, std::min(sys::get_cpu_count(), 8));
+    constexpr size_t RUNS = 200;
+    for (size_t parallelism : {size_t(8), size_t(256)}) {
+        for (auto mode : {Mode::SHARED_COUNTER, Mode::WORK_STEALING}) {
+            ThreadPool thread_pool(nr_threads, mode);
+            std::vector<std::atomic_size_t> count(parallelism);
+            for (auto&& i : count) {
+                i = 0;
+            }
+            auto func = [&](size_t index, size_t) {
+                count[index].fetch_add(1, std::memory_order_relaxed);
+            };
+            thread_pool.active();
+            for (size_t i = 0; i < RUNS; ++i) {
+                thread_pool.add_task({func, parallelism});
+            }
+            thread_pool.deactive();
+            //! each sub task runs exactly once per dispatch
+            for (auto&& i : count) {
+                ASSERT_EQ(RUNS, i.load());
+            }
+        }
+    }
+}
+
+TEST(TestThreadPool, CompNodeScheduleMode) {
+    auto cn = CompNode::load("multithread:default:4");
+    auto&& env = CompNodeEnv::from_comp_node(cn).cpu_env();
+    env.set_schedule_mode(ThreadPoolScheduleMode::WORK_STEALING);
+    std::vector<size_t> dst(100, 0);
+    auto task = [&](size_t index, size_t) { dst[index] = index * 2; };
+    env.dispatch(task, dst.size());
+    cn.sync();
+    env.set_schedule_mode(ThreadPoolScheduleMode::SHARED_COUNTER);
+    for (size_t i = 0; i < dst.size(); ++i) {
+        ASSERT_EQ(i * 2, dst[i]);
+    }
+}
+
 TEST(TestGraph, ParallelRunMultithreadMode) {
     // check race conditions when graphs are executed on multple threads
     std::atomic_size_t sync_counter{0};
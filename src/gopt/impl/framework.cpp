@@ -620,6 +620,11 @@ GraphOptimizer& GraphOptimizer::add_preset_passes(
             inference_opt ? ConstVarType::IMMUTABLE_AND_PARAM : ConstVarType::IMMUTABLE;
     if (inference_opt) {
         add_pass<ConvertBatchNormToElemwisePass>();
+        // the arith passes below may distribute the normalization into
+        // x * rstd - mean * rstd, so the layer norm has to be fused first
+        if (inference_opt->fuse_layer_norm) {
+            add_pass<FuseLayerNormPass>();
+        }
     }
     if (!after_grad || inference_opt) {
         add_pass<CondExecConstPredicateFolding>();
@@ -735,6 +740,15 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
     });
     cb(f16_io_comp, { add_pass(ConvertF32ToF16Pass::make(false)); });
     cb(f16_io_f32_comp, { add_pass(ConvertF32ToF16Pass::make(true)); });
+    cb(bf16_io_f32_comp, {
+        add_pass(ConvertF32ToF16Pass::make(true, dtype::BFloat16()));
+    });
+    cb(fuse_softmax, { add_pass<FuseSoftmaxPass>(); });
+    cb(fuse_layer_norm, { add_pass<FuseLayerNormPass>(); });
+    cb(fuse_attention, {
+        add_pass<FuseSoftmaxPass>();
+        add_pass<FuseAttentionPass>();
+    });
 
     cb(nchw4, {
         add_pass<FuseConvBiasNonlinPass>();
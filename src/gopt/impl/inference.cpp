@@ -15,10 +15,13 @@
 #include "megbrain/graph/event.h"
 #include "megbrain/opr/basic_arith.h"
 #include "megbrain/opr/blas.h"
+#include "megbrain/opr/dnn/attention.h"
 #include "megbrain/opr/dnn/batch_norm.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/dnn/local.h"
+#include "megbrain/opr/dnn/norm.h"
 #include "megbrain/opr/dnn/pooling.h"
+#include "megbrain/opr/dnn/softmax.h"
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/misc.h"
 #include "megbrain/opr/nn_int.h"
@@ -610,6 +613,9 @@ void ParamFusePass::apply(OptState& state) const {
 
 /* ================ One2OneOprReplacePass ================ */
 const char* ConvertF32ToF16Pass::name() const {
+    if (m_target_dtype.enumv() == DTypeEnum::BFloat16) {
+        return mgb_cstr_log("convert_f32_to_bf16");
+    }
     return mgb_cstr_log("convert_f32_to_f16");
 }
 
@@ -672,53 +678,58 @@ void ConvertF32ToF16Pass::apply(OptState& state) const {
     MIDOUT_E
 }
 
-std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp) {
+std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(
+        bool use_f32_comp, DType target_dtype) {
 #if MEGDNN_DISABLE_FLOAT16
     mgb_throw(SystemError, "float16 disabled at compile time.");
 #else
-    auto replace_h2d_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_h2d_opr = [target_dtype](
+                                   OperatorNodeBase* opr, const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
         auto& h2d_opr = opr->cast_final_safe<opr::Host2DeviceCopy>();
         if (h2d_opr.output(0)->dtype() == dtype::Float32()) {
-            auto cvt_var = opr::TypeCvt::make(h2d_opr.output(0), dtype::Float16(), {});
+            auto cvt_var = opr::TypeCvt::make(h2d_opr.output(0), target_dtype, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_sdt_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_sdt_opr = [target_dtype](
+                                   OperatorNodeBase* opr, const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
         auto& sdt_opr = opr->cast_final_safe<opr::SharedDeviceTensor>();
         if (sdt_opr.output(0)->dtype() == dtype::Float32()) {
-            auto cvt_var = opr::TypeCvt::make(sdt_opr.output(0), dtype::Float16(), {});
+            auto cvt_var = opr::TypeCvt::make(sdt_opr.output(0), target_dtype, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_imt_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_imt_opr = [target_dtype](
+                                   OperatorNodeBase* opr, const VarNodeArray& new_inp) {
         mgb_assert(opr->same_type<opr::ImmutableTensor>());
         mgb_assert(opr->input().size() == new_inp.size());
         auto& imt_opr = opr->cast_final_safe<opr::ImmutableTensor>();
         if (imt_opr.output(0)->dtype() == dtype::Float32()) {
-            auto cvt_var = opr::TypeCvt::make(imt_opr.output(0), dtype::Float16(), {});
+            auto cvt_var = opr::TypeCvt::make(imt_opr.output(0), target_dtype, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_lsp_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_lsp_opr = [target_dtype](
+                                   OperatorNodeBase* opr, const VarNodeArray& new_inp) {
         mgb_assert(opr->same_type<opr::Linspace>());
         mgb_assert(opr->input().size() == new_inp.size());
         auto& lsp_opr = opr->cast_final_safe<opr::Linspace>();
-        if (lsp_opr.output(0)->dtype() != dtype::Float16()) {
-            auto cvt_var = opr::TypeCvt::make(lsp_opr.output(0), dtype::Float16(), {});
+        if (lsp_opr.output(0)->dtype() != target_dtype) {
+            auto cvt_var = opr::TypeCvt::make(lsp_opr.output(0), target_dtype, {});
             return cvt_var.node()->owner_opr();
         }
         return opr;
     };
 
-    auto replace_conv_opr = [use_f32_comp](
+    auto replace_conv_opr = [use_f32_comp, target_dtype](
                                     OperatorNodeBase* opr,
                                     const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
@@ -728,11 +739,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::Convolution::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         auto new_conv_opr = opr::Convolution::make(
@@ -741,7 +752,7 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         return new_conv_opr.node()->owner_opr();
     };
 
-    auto replace_deconv_opr = [use_f32_comp](
+    auto replace_deconv_opr = [use_f32_comp, target_dtype](
                                       OperatorNodeBase* opr,
                                       const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
@@ -751,11 +762,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::Convolution::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         auto new_deconv_opr = opr::ConvolutionBackwardData::make(
@@ -764,7 +775,7 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         return new_deconv_opr.node()->owner_opr();
     };
 
-    auto replace_convbias_opr = [use_f32_comp](
+    auto replace_convbias_opr = [use_f32_comp, target_dtype](
                                         OperatorNodeBase* opr,
                                         const VarNodeArray& new_inp) {
         auto& convbias_opr = opr->cast_final_safe<opr::ConvBiasForward>();
@@ -773,11 +784,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::ConvBias::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         if (opr->input().size() == 2) {
@@ -816,7 +827,7 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
                 return new_matmul_opr.node()->owner_opr();
             };
 
-    auto replace_batched_matmul_opr = [use_f32_comp](
+    auto replace_batched_matmul_opr = [use_f32_comp, target_dtype](
                                               OperatorNodeBase* opr,
                                               const VarNodeArray& new_inp) {
         mgb_assert(opr->input().size() == new_inp.size());
@@ -826,11 +837,11 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
             new_param.compute_mode = megdnn::param::MatrixMul::ComputeMode::FLOAT32;
         }
         mgb_assert(
-                new_inp[0]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[0]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[0]->dtype().name(), new_inp[0]->name().c_str(),
                 new_inp[0]->owner_opr()->name().c_str());
         mgb_assert(
-                new_inp[1]->dtype() == dtype::Float16(), "inp %s:%s, owner_opr:%s",
+                new_inp[1]->dtype() == target_dtype, "inp %s:%s, owner_opr:%s",
                 new_inp[1]->dtype().name(), new_inp[1]->name().c_str(),
                 new_inp[1]->owner_opr()->name().c_str());
         auto new_matmul_opr = opr::BatchedMatrixMul::make(
@@ -839,12 +850,13 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         return new_matmul_opr.node()->owner_opr();
     };
 
-    auto replace_reduce_opr = [use_f32_comp](
+    auto replace_reduce_opr = [use_f32_comp, target_dtype](
                                       OperatorNodeBase* opr,
                                       const VarNodeArray& new_inp) {
         auto& reduce_opr = opr->cast_final_safe<opr::Reduce>();
         auto new_param = reduce_opr.param();
-        if (use_f32_comp) {
+        //! the float32 accumulated output of Reduce is only defined for float16
+        if (use_f32_comp && target_dtype == dtype::Float16()) {
             new_param.data_type = megdnn::param::Reduce::DataType::FLOAT_O16xC32;
         }
         if (opr->input().size() == 1) {
@@ -861,12 +873,12 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
         }
     };
 
-    auto replace_cvt_opr = [](OperatorNodeBase* opr, const VarNodeArray& new_inp) {
+    auto replace_cvt_opr = [target_dtype](
+                                   OperatorNodeBase* opr, const VarNodeArray& new_inp) {
         auto& cvt_opr = opr->cast_final_safe<opr::TypeCvt>();
         SymbolVar new_cvt;
         if (cvt_opr.output(0)->dtype() == dtype::Float32()) {
-            new_cvt =
-                    opr::TypeCvt::make(new_inp[0], dtype::Float16(), cvt_opr.config());
+            new_cvt = opr::TypeCvt::make(new_inp[0], target_dtype, cvt_opr.config());
         } else {
             new_cvt = opr::TypeCvt::make(
                     new_inp[0], cvt_opr.output()[0]->dtype(), cvt_opr.config());
@@ -922,6 +934,7 @@ std::unique_ptr<ConvertF32ToF16Pass> ConvertF32ToF16Pass::make(bool use_f32_comp
     };
 
     auto ret = std::make_unique<ConvertF32ToF16Pass>();
+    ret->m_target_dtype = target_dtype;
     // don't check dtype
     ret->set_var_replace_check_flag(
             VarReplaceCheckFlag::CHECK_ALL ^ VarReplaceCheckFlag::CHECK_DTYPE);
@@ -2170,6 +2183,482 @@ void FuseDeconvCvtPass::apply(OptState& state) const {
     MIDOUT_E
 }
 
+namespace {
+//! skip the oprs which only mark the var, like the detach of max(x)
+VarNode* skip_marker(VarNode* var) {
+    for (;;) {
+        auto type = var->owner_opr()->dyn_typeinfo();
+        if (type != opr::MarkNoBroadcastElemwise::typeinfo() &&
+            type != opr::SetGrad::typeinfo() && type != opr::Identity::typeinfo()) {
+            return var;
+        }
+        var = var->owner_opr()->input(0);
+    }
+}
+
+//! get the elemwise opr of given mode which computes var, or nullptr
+opr::Elemwise* as_elemwise(VarNode* var, opr::Elemwise::Mode mode) {
+    auto elem = try_cast_as_op<opr::Elemwise>(skip_marker(var)->owner_opr());
+    return elem && elem->param().mode == mode ? elem : nullptr;
+}
+
+//! get the value of a float scalar ImmutableTensor
+bool as_scalar(VarNode* var, float& val) {
+    auto imm = try_cast_as_op<opr::ImmutableTensor>(skip_marker(var)->owner_opr());
+    if (!imm || imm->host_value().shape().total_nr_elems() != 1) {
+        return false;
+    }
+    auto&& hv = imm->host_value();
+    if (hv.dtype() == dtype::Float32()) {
+        val = hv.ptr<dt_float32>()[0];
+    } else if (hv.dtype() == dtype::Float16()) {
+        val = static_cast<float>(hv.ptr<dt_float16>()[0]);
+    } else {
+        return false;
+    }
+    return true;
+}
+}  // anonymous namespace
+
+/* ================ FuseSoftmaxPass ================ */
+const char* FuseSoftmaxPass::name() const {
+    return mgb_cstr_log("fuse_softmax");
+}
+
+void FuseSoftmaxPass::apply(OptState& state) const {
+    MIDOUT_B("FuseSoftmaxPass::apply")
+    auto rewriter = state.graph().make_rewriter();
+
+    //! return the axis if var is reduced from src along a single axis
+    auto reduce_axis = [&](VarNode* var, VarNode* src,
+                           opr::Reduce::Mode mode) -> int {
+        auto reduce = try_cast_as_op<opr::Reduce>(skip_marker(var)->owner_opr());
+        if (!reduce || reduce->input().size() != 1 ||
+            reduce->param().mode != mode ||
+            reduce->param().data_type != opr::Reduce::Param::DataType::DEFAULT ||
+            skip_marker(reduce->input(0)) != src) {
+            return -1;
+        }
+        return reduce->param().axis;
+    };
+
+    //! match div(exp(sub(x, max(x))), sum(exp(sub(x, max(x))))) and return x
+    auto try_match = [&](opr::Elemwise* div, int& axis) -> VarNode* {
+        using Mode = opr::Elemwise::Mode;
+        if (div->param().mode != Mode::TRUE_DIV) {
+            return nullptr;
+        }
+        auto exp = as_elemwise(div->input(0), Mode::EXP);
+        if (!exp) {
+            return nullptr;
+        }
+        auto sub = as_elemwise(exp->input(0), Mode::SUB);
+        if (!sub) {
+            return nullptr;
+        }
+        auto x = skip_marker(sub->input(0));
+        auto dtype = x->dtype();
+        if (dtype != dtype::Float32() && dtype != dtype::Float16()) {
+            return nullptr;
+        }
+        axis = reduce_axis(sub->input(1), x, opr::Reduce::Mode::MAX);
+        if (axis < 0 ||
+            reduce_axis(div->input(1), exp->output(0), opr::Reduce::Mode::SUM) !=
+                    axis ||
+            !div->output(0)->shape().eq_shape(x->shape())) {
+            return nullptr;
+        }
+        return x;
+    };
+
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        if (auto div = try_cast_as_op<opr::Elemwise>(opr)) {
+            int axis;
+            if (auto x = try_match(div, axis)) {
+                auto softmax = opr::Softmax::make(
+                        rewriter.get_var(x), {axis}, div->config());
+                rewriter.replace_var(
+                        opr->output(0), softmax.node(),
+                        mgb_cstr_log("replace exp(x - max(x)) / sum(exp(x - "
+                                     "max(x))) -> softmax(x)"));
+                return;
+            }
+        }
+        rewriter.auto_replace_outputs(opr);
+    };
+    state.graph().iter(on_opr);
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FuseLayerNormPass ================ */
+const char* FuseLayerNormPass::name() const {
+    return mgb_cstr_log("fuse_layer_norm");
+}
+
+void FuseLayerNormPass::apply(OptState& state) const {
+    MIDOUT_B("FuseLayerNormPass::apply")
+    using Mode = opr::Elemwise::Mode;
+    auto rewriter = state.graph().make_rewriter();
+
+    //! return the base if var is pow(base, exp) by PowC or Elemwise
+    auto as_pow = [&](VarNode* var, float exp) -> VarNode* {
+        var = skip_marker(var);
+        if (auto powc = try_cast_as_op<opr::PowC>(var->owner_opr())) {
+            return powc->param().exp == exp ? skip_marker(powc->input(0)) : nullptr;
+        }
+        float val;
+        auto pow = as_elemwise(var, Mode::POW);
+        if (pow && as_scalar(pow->input(1), val) && val == exp) {
+            return skip_marker(pow->input(0));
+        }
+        return nullptr;
+    };
+    //! return x if var is the mean of x along the last axis
+    auto as_mean = [&](VarNode* var) -> VarNode* {
+        auto reduce = try_cast_as_op<opr::Reduce>(skip_marker(var)->owner_opr());
+        if (!reduce || reduce->input().size() != 1 ||
+            reduce->param().mode != opr::Reduce::Mode::MEAN ||
+            reduce->param().data_type != opr::Reduce::Param::DataType::DEFAULT) {
+            return nullptr;
+        }
+        auto x = skip_marker(reduce->input(0));
+        int ndim = x->shape().ndim, axis = reduce->param().axis;
+        return ndim && (axis == ndim - 1 || axis == -1) ? x : nullptr;
+    };
+    //! return x if var is x - mean(x)
+    auto as_centered = [&](VarNode* var) -> VarNode* {
+        auto sub = as_elemwise(var, Mode::SUB);
+        if (!sub) {
+            return nullptr;
+        }
+        auto x = skip_marker(sub->input(0));
+        return as_mean(sub->input(1)) == x ? x : nullptr;
+    };
+    //! check whether var is mean((x - mean(x))^2) + eps
+    auto is_var_eps = [&](VarNode* var, VarNode* x, float& eps) {
+        auto add = as_elemwise(var, Mode::ADD);
+        if (!add) {
+            return false;
+        }
+        for (size_t i = 0; i < 2; ++i) {
+            if (!as_scalar(add->input(1 - i), eps)) {
+                continue;
+            }
+            auto sqr = as_mean(add->input(i));
+            if (!sqr) {
+                return false;
+            }
+            auto centered = as_pow(sqr, 2.f);
+            if (auto mul = as_elemwise(sqr, Mode::MUL)) {
+                if (skip_marker(mul->input(0)) == skip_marker(mul->input(1))) {
+                    centered = skip_marker(mul->input(0));
+                }
+            }
+            return centered && as_centered(centered) == x;
+        }
+        return false;
+    };
+    //! match (x - mean(x)) / sqrt(var(x) + eps), or the product of x - mean(x)
+    //! and pow(var(x) + eps, -0.5), where var(x) is computed from x - mean(x)
+    auto match_norm = [&](VarNode* var, float& eps) -> VarNode* {
+        var = skip_marker(var);
+        auto elem = try_cast_as_op<opr::Elemwise>(var->owner_opr());
+        if (!elem || elem->input().size() != 2) {
+            return nullptr;
+        }
+        VarNode *centered = nullptr, *var_eps = nullptr;
+        if (elem->param().mode == Mode::TRUE_DIV) {
+            centered = elem->input(0);
+            var_eps = as_pow(elem->input(1), 0.5f);
+        } else if (elem->param().mode == Mode::MUL) {
+            for (size_t i = 0; i < 2 && !var_eps; ++i) {
+                centered = elem->input(1 - i);
+                var_eps = as_pow(elem->input(i), -0.5f);
+            }
+        }
+        if (!var_eps) {
+            return nullptr;
+        }
+        auto x = as_centered(centered);
+        if (!x || !is_var_eps(var_eps, x, eps) ||
+            !var->shape().eq_shape(x->shape())) {
+            return nullptr;
+        }
+        auto dtype = x->dtype();
+        return dtype == dtype::Float32() || dtype == dtype::Float16() ? x : nullptr;
+    };
+    //! whether var can be used as the weight or bias of x
+    auto is_affine_param = [](VarNode* var, VarNode* x) {
+        auto&& shp = var->shape();
+        size_t nr_col = x->shape()[x->shape().ndim - 1];
+        return var->dtype() == x->dtype() && shp.ndim &&
+               shp[shp.ndim - 1] == nr_col && shp.total_nr_elems() == nr_col;
+    };
+    //! match norm(x) * weight + bias, and return the norm opr
+    auto match_affine = [&](opr::Elemwise* add, float& eps, VarNode*& x,
+                            VarNode*& weight, VarNode*& bias) -> cg::OperatorNodeBase* {
+        if (add->param().mode != Mode::ADD) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < 2; ++i) {
+            auto mul = as_elemwise(add->input(i), Mode::MUL);
+            if (!mul) {
+                continue;
+            }
+            for (size_t j = 0; j < 2; ++j) {
+                auto src = match_norm(mul->input(j), eps);
+                if (src && is_affine_param(mul->input(1 - j), src) &&
+                    is_affine_param(add->input(1 - i), src) &&
+                    add->output(0)->shape().eq_shape(src->shape())) {
+                    x = src;
+                    weight = mul->input(1 - j);
+                    bias = add->input(1 - i);
+                    return skip_marker(mul->input(j))->owner_opr();
+                }
+            }
+        }
+        return nullptr;
+    };
+
+    //! the norm oprs which would be fused with their affine transforms, so
+    //! that no dead LayerNorm is created for them
+    ThinHashSet<cg::OperatorNodeBase*> affine_norm;
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        float eps;
+        VarNode *x, *weight, *bias;
+        if (auto add = try_cast_as_op<opr::Elemwise>(opr)) {
+            if (auto norm = match_affine(add, eps, x, weight, bias)) {
+                affine_norm.insert(norm);
+            }
+        }
+    });
+
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        if (auto elem = try_cast_as_op<opr::Elemwise>(opr)) {
+            float eps;
+            VarNode *x = nullptr, *weight = nullptr, *bias = nullptr;
+            if (!match_affine(elem, eps, x, weight, bias) && !affine_norm.count(opr)) {
+                x = match_norm(elem->output(0), eps);
+            }
+            if (x) {
+                opr::LayerNorm::Param param;
+                param.affine = weight != nullptr;
+                param.eps = eps;
+                param.normalized_dim = 1;
+                SymbolVar new_x = rewriter.get_var(x), ln;
+                if (param.affine) {
+                    //! LayerNorm requires the params to be of the normalized shape
+                    auto as_vector = [&](VarNode* var) -> SymbolVar {
+                        auto new_var = rewriter.get_var(var);
+                        if (var->shape().ndim == 1) {
+                            return new_var;
+                        }
+                        return opr::Reshape::make(
+                                new_var, TensorShape{var->shape().total_nr_elems()});
+                    };
+                    ln = opr::LayerNorm::make(
+                            new_x, as_vector(weight), as_vector(bias), param,
+                            elem->config());
+                } else {
+                    ln = opr::LayerNorm::make(new_x, param, elem->config());
+                }
+                rewriter.replace_var(
+                        opr->output(0), ln.node(),
+                        mgb_cstr_log("replace (x - mean(x)) / sqrt(var(x) + eps) -> "
+                                     "layer_norm(x)"));
+                return;
+            }
+        }
+        rewriter.auto_replace_outputs(opr);
+    };
+    state.graph().iter(on_opr);
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FuseAttentionPass ================ */
+const char* FuseAttentionPass::name() const {
+    return mgb_cstr_log("fuse_attention");
+}
+
+void FuseAttentionPass::apply(OptState& state) const {
+    MIDOUT_B("FuseAttentionPass::apply")
+    using Mode = opr::Elemwise::Mode;
+    auto rewriter = state.graph().make_rewriter();
+
+    //! get the operands if var is the product of a matrix (not transposed) and
+    //! another matrix, which may be transposed
+    auto as_matmul = [&](VarNode* var, VarNode*& a, VarNode*& b, bool& trans_b) {
+        auto opr = skip_marker(var)->owner_opr();
+        opr::MatrixMul::Param param;
+        if (auto mm = try_cast_as_op<opr::MatrixMul>(opr)) {
+            param = mm->param();
+        } else if (auto bmm = try_cast_as_op<opr::BatchedMatrixMul>(opr)) {
+            param = bmm->param();
+        } else {
+            return false;
+        }
+        using Param = opr::MatrixMul::Param;
+        if (param.transposeA || param.format != Param::Format::DEFAULT ||
+            param.compute_mode != Param::ComputeMode::DEFAULT) {
+            return false;
+        }
+        a = skip_marker(opr->input(0));
+        b = skip_marker(opr->input(1));
+        trans_b = param.transposeB;
+        return true;
+    };
+    //! match q * k^T, where k^T is given by transposeB or a Dimshuffle which
+    //! swaps the last two axes
+    auto match_qk = [&](VarNode* var, VarNode*& q, VarNode*& k) {
+        bool trans_b;
+        if (!as_matmul(var, q, k, trans_b)) {
+            return false;
+        }
+        if (trans_b) {
+            return true;
+        }
+        auto shuffle = try_cast_as_op<opr::Dimshuffle>(k->owner_opr());
+        if (!shuffle) {
+            return false;
+        }
+        auto&& param = shuffle->param();
+        size_t ndim = param.pattern_len;
+        if (ndim < 2 || skip_marker(shuffle->input(0))->shape().ndim != ndim) {
+            return false;
+        }
+        for (size_t i = 0; i + 2 < ndim; ++i) {
+            if (param.pattern[i] != static_cast<int>(i)) {
+                return false;
+            }
+        }
+        if (param.pattern[ndim - 2] != static_cast<int>(ndim - 1) ||
+            param.pattern[ndim - 1] != static_cast<int>(ndim - 2)) {
+            return false;
+        }
+        k = skip_marker(shuffle->input(0));
+        return true;
+    };
+    //! match q * k^T, optionally multiplied or divided by a scalar
+    auto match_scaled_qk = [&](VarNode* var, VarNode*& q, VarNode*& k,
+                               float& scale) {
+        scale = 1.f;
+        if (match_qk(var, q, k)) {
+            return true;
+        }
+        if (auto mul = as_elemwise(var, Mode::MUL)) {
+            for (size_t i = 0; i < 2; ++i) {
+                if (as_scalar(mul->input(i), scale) &&
+                    match_qk(mul->input(1 - i), q, k)) {
+                    return true;
+                }
+            }
+        } else if (auto div = as_elemwise(var, Mode::TRUE_DIV)) {
+            if (as_scalar(div->input(1), scale) && scale != 0.f &&
+                match_qk(div->input(0), q, k)) {
+                scale = 1.f / scale;
+                return true;
+            }
+        }
+        return false;
+    };
+    //! match the scores, i.e. the input of softmax, which is the scaled q * k^T
+    //! plus an optional mask
+    auto match_scores = [&](VarNode* var, VarNode*& q, VarNode*& k, float& scale,
+                            VarNode*& mask) {
+        mask = nullptr;
+        if (match_scaled_qk(var, q, k, scale)) {
+            return true;
+        }
+        if (auto add = as_elemwise(var, Mode::ADD)) {
+            for (size_t i = 0; i < 2; ++i) {
+                if (match_scaled_qk(add->input(i), q, k, scale)) {
+                    mask = skip_marker(add->input(1 - i));
+                    return true;
+                }
+            }
+        } else if (auto fma = as_elemwise(var, Mode::FUSE_MUL_ADD3)) {
+            for (size_t i = 0; i < 2; ++i) {
+                if (as_scalar(fma->input(i), scale) &&
+                    match_qk(fma->input(1 - i), q, k)) {
+                    mask = skip_marker(fma->input(2));
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        VarNode *p, *v, *q, *k, *mask;
+        bool trans_v;
+        float scale;
+        if (!as_matmul(opr->output(0), p, v, trans_v) || trans_v) {
+            rewriter.auto_replace_outputs(opr);
+            return;
+        }
+        auto softmax = try_cast_as_op<opr::Softmax>(p->owner_opr());
+        VarNode* scores = softmax ? skip_marker(softmax->input(0)) : nullptr;
+        if (!scores || !match_scores(scores, q, k, scale, mask)) {
+            rewriter.auto_replace_outputs(opr);
+            return;
+        }
+        auto&& shp = scores->shape();
+        int ndim = shp.ndim, axis = softmax->param().axis;
+        auto dtype = q->dtype();
+        //! the mask should not broadcast q * k^T to a larger shape
+        TensorShape qk_shp = q->shape();
+        bool ndim_ok = ndim >= 2 && qk_shp.ndim == shp.ndim &&
+                       k->shape().ndim == shp.ndim && v->shape().ndim == shp.ndim;
+        if (ndim_ok) {
+            qk_shp[ndim - 1] = k->shape()[ndim - 2];
+        }
+        if (!ndim_ok || (axis != ndim - 1 && axis != -1) ||
+            (dtype != dtype::Float32() && dtype != dtype::Float16()) ||
+            k->dtype() != dtype || v->dtype() != dtype ||
+            (mask && mask->dtype() != dtype) || !qk_shp.eq_shape(shp) ||
+            !p->shape().eq_shape(shp)) {
+            rewriter.auto_replace_outputs(opr);
+            return;
+        }
+        opr::Attention::Param param{scale, false};
+        SymbolVar out;
+        if (mask) {
+            //! the mask of Attention is either shared by the batches or of the
+            //! same shape as the scores
+            SymbolVar new_mask = rewriter.get_var(mask);
+            auto&& mshp = mask->shape();
+            size_t Lq = shp[ndim - 2], Lk = shp[ndim - 1];
+            if (mshp.ndim >= 2 && mshp.total_nr_elems() == Lq * Lk &&
+                mshp[mshp.ndim - 2] == Lq && mshp[mshp.ndim - 1] == Lk) {
+                if (mshp.ndim != 2) {
+                    new_mask = opr::Reshape::make(new_mask, TensorShape{Lq, Lk});
+                }
+            } else if (!mshp.eq_shape(shp)) {
+                new_mask = opr::Broadcast::make(new_mask, shp);
+            }
+            out = opr::Attention::make(
+                    rewriter.get_var(q), rewriter.get_var(k), rewriter.get_var(v),
+                    new_mask, param, opr->config());
+        } else {
+            out = opr::Attention::make(
+                    rewriter.get_var(q), rewriter.get_var(k), rewriter.get_var(v),
+                    param, opr->config());
+        }
+        rewriter.replace_var(
+                opr->output(0), out.node(),
+                mgb_cstr_log("replace softmax(q * k^T * scale + mask) * v -> "
+                             "attention(q, k, v, mask)"));
+    };
+    state.graph().iter(on_opr);
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
 /* ================ ParamMergePass ================ */
 const char* ParamMergePass::name() const {
     return mgb_cstr_log("param_merge");
@@ -77,7 +77,8 @@ public:
 };
 
 /*!
- * \brief replace the dtype of opr from float32 to float16.
+ * \brief replace the dtype of opr from float32 to float16, or to bfloat16 if
+ * it is given as the target dtype.
  */
 class ConvertF32ToF16Pass : public Pass {
     ThinHashMap<
@@ -85,6 +86,7 @@ class ConvertF32ToF16Pass : public Pass {
             thin_function<OperatorNodeBase*(OperatorNodeBase*, const VarNodeArray&)>>
             m_opr_replace_func;
     VarReplaceCheckFlag m_var_replace_check_flag = VarReplaceCheckFlag::CHECK_ALL;
+    DType m_target_dtype;
 
 public:
     const char* name() const override;
@@ -96,7 +98,8 @@ public:
 
     void apply(OptState& opt) const override;
 
-    static std::unique_ptr<ConvertF32ToF16Pass> make(bool use_f32_comp);
+    static std::unique_ptr<ConvertF32ToF16Pass> make(
+            bool use_f32_comp, DType target_dtype = dtype::Float16());
 };
 
 /*!
@@ -190,6 +193,40 @@ public:
     void apply(OptState& opt) const override;
 };
 
+/*!
+ * \brief fuse the decomposed softmax, i.e.
+ * exp(x - max(x, axis)) / sum(exp(x - max(x, axis)), axis), to a Softmax opr
+ */
+class FuseSoftmaxPass : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fuse the decomposed layer norm along the last axis, i.e.
+ * (x - mean(x)) / sqrt(mean((x - mean(x))^2) + eps) and its affine transform
+ * with weight and bias, to a LayerNorm opr
+ */
+class FuseLayerNormPass : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fuse softmax(q * k^T * scale + mask) * v, where the scale and the
+ * additive mask are optional and the product of matrices is computed by
+ * (Batched)MatrixMul, to an Attention opr
+ *
+ * The softmax must have been fused to a Softmax opr by FuseSoftmaxPass.
+ */
+class FuseAttentionPass : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
 /*!
  * \brief merge all the SharedDeviceTensor oprs into one
  *      MultipleDeviceTensorHolder
@@ -329,6 +366,14 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
             ret |= 1u << 4;
         if (fuse_preprocess)
             ret |= 1u << 5;
+        if (bf16_io_f32_comp)
+            ret |= 1u << 6;
+        if (fuse_softmax)
+            ret |= 1u << 7;
+        if (fuse_layer_norm)
+            ret |= 1u << 8;
+        if (fuse_attention)
+            ret |= 1u << 9;
         return ret;
     }
 
@@ -340,6 +385,10 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
         ret.fuse_conv_bias_with_z = buf & 1u << 3;
         ret.weight_preprocess = buf & 1u << 4;
         ret.fuse_preprocess = buf & 1u << 5;
+        ret.bf16_io_f32_comp = buf & 1u << 6;
+        ret.fuse_softmax = buf & 1u << 7;
+        ret.fuse_layer_norm = buf & 1u << 8;
+        ret.fuse_attention = buf & 1u << 9;
         ret.layout_transform = (LayoutTransform)(buf >> 32);
         return ret;
     }
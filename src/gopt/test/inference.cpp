@@ -19,9 +19,12 @@
 
 #include "megbrain/opr/basic_arith_wrapper.h"
 #include "megbrain/opr/blas.h"
+#include "megbrain/opr/dnn/attention.h"
 #include "megbrain/opr/dnn/batch_norm.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/dnn/pooling.h"
+#include "megbrain/opr/dnn/norm.h"
+#include "megbrain/opr/dnn/softmax.h"
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/io.h"
 #include "megbrain/opr/nn_int.h"
@@ -737,6 +740,166 @@ TEST(TestGoptInference, Float16IOFloat32ComputeDeConv) {
     MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-2);
 }
 
+TEST(TestGoptInference, BFloat16IOFloat32Compute) {
+    constexpr size_t INP_H = 10, INP_W = 10;
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp)).rename(name);
+    };
+    graph->options().graph_opt_level = 0;
+    auto x = mkvar("x", {2, 4, INP_H, INP_W}), w = mkvar("w", {8, 4, 3, 3}),
+         b = mkvar("b", {1, 8, 1, 1}), m = mkvar("m", {INP_W, 6});
+    opr::ConvBias::Param param;
+    param.pad_h = param.pad_w = 1;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto y = opr::ConvBias::make(x, w, b, param, {});
+    y = opr::Reshape::make(y, {2 * 8 * INP_H, INP_W});
+    y = opr::MatrixMul::make(y, m);
+    SymbolVar y_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_bf16_io_f32_comp();
+    unpack_vector(gopt::optimize_for_inference({y}, options), y_opt);
+    auto&& conv = find_opr<opr::ConvBias>(y_opt);
+    ASSERT_EQ(conv.output(0)->dtype(), dtype::BFloat16());
+    ASSERT_EQ(
+            conv.param().compute_mode,
+            opr::ConvBias::Param::ConvBias::ComputeMode::FLOAT32);
+    ASSERT_EQ(find_opr<opr::MatrixMul>(y_opt).output(0)->dtype(), dtype::BFloat16());
+    ASSERT_EQ(y_opt.dtype(), dtype::Float32());
+
+    HostTensorND host_y, host_y_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_opt, host_y_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-1);
+}
+
+TEST(TestGoptInference, FuseSoftmax) {
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto x = opr::Host2DeviceCopy::make(*graph, gen({4, 16, 32})).rename("x");
+    using Mode = opr::Reduce::Mode;
+    auto softmax = [&](SymbolVar x, int axis) {
+        auto max = opr::Reduce::make(x, {Mode::MAX, axis});
+        auto exp = opr::exp(x - opr::MarkNoBroadcastElemwise::make(max));
+        return exp / opr::Reduce::make(exp, {Mode::SUM, axis});
+    };
+    auto y0 = softmax(x, 2), y1 = softmax(x, 1);
+    //! reduced along different axes, which should not be fused
+    auto max = opr::Reduce::make(x, {Mode::MAX, 2});
+    auto exp = opr::exp(x - max);
+    auto y2 = exp / opr::Reduce::make(exp, {Mode::SUM, 1});
+
+    SymbolVar y0_opt, y1_opt, y2_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_softmax();
+    unpack_vector(
+            gopt::optimize_for_inference({y0, y1, y2}, options), y0_opt, y1_opt,
+            y2_opt);
+    ASSERT_EQ(opr::Softmax::typeinfo(), y0_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_EQ(2, find_opr<opr::Softmax>(y0_opt).param().axis);
+    ASSERT_EQ(1, find_opr<opr::Softmax>(y1_opt).param().axis);
+    ASSERT_EQ(0u, find_opr_num<opr::Softmax>(y2_opt));
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1),
+             make_callback_copy(y1_opt, host_y1_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-5);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-5);
+}
+
+TEST(TestGoptInference, FuseLayerNorm) {
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp)).rename(name);
+    };
+    auto x = mkvar("x", {4, 16, 32}), w = mkvar("w", {32}), b = mkvar("b", {32});
+    using Mode = opr::Reduce::Mode;
+    auto centered = [&](SymbolVar x, int axis) {
+        return x - opr::Reduce::make(x, {Mode::MEAN, axis});
+    };
+    auto var_eps = [&](SymbolVar x, int axis) {
+        auto d = centered(x, axis);
+        return opr::Reduce::make(d * d, {Mode::MEAN, axis}) + 1e-5f;
+    };
+    auto y0 = centered(x, 2) / opr::PowC::make(var_eps(x, 2), {0.5f});
+    auto y1 = centered(x, 2) * opr::PowC::make(var_eps(x, 2), {-0.5f}) * w + b;
+    //! normalized along the second axis, which should not be fused
+    auto y2 = centered(x, 1) / opr::PowC::make(var_eps(x, 1), {0.5f});
+
+    SymbolVar y0_opt, y1_opt, y2_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_layer_norm();
+    unpack_vector(
+            gopt::optimize_for_inference({y0, y1, y2}, options), y0_opt, y1_opt,
+            y2_opt);
+    ASSERT_EQ(opr::LayerNorm::typeinfo(), y0_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_FALSE(find_opr<opr::LayerNorm>(y0_opt).param().affine);
+    ASSERT_EQ(opr::LayerNorm::typeinfo(), y1_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_TRUE(find_opr<opr::LayerNorm>(y1_opt).param().affine);
+    ASSERT_EQ(0u, find_opr_num<opr::LayerNorm>(y2_opt));
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1),
+             make_callback_copy(y1_opt, host_y1_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-4);
+}
+
+TEST(TestGoptInference, FuseAttention) {
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp)).rename(name);
+    };
+    auto q = mkvar("q", {2, 16, 32}), k = mkvar("k", {2, 24, 32}),
+         v = mkvar("v", {2, 24, 8}), mask = mkvar("mask", {16, 24});
+    opr::BatchedMatrixMul::Param trans_b;
+    trans_b.transposeB = true;
+    auto qk = opr::BatchedMatrixMul::make(q, k, trans_b);
+    auto qk_shuffle =
+            opr::BatchedMatrixMul::make(q, opr::Dimshuffle::make(k, {0, 2, 1}));
+    auto y0 = opr::BatchedMatrixMul::make(
+            opr::Softmax::make(qk * 0.125f + mask, {-1}), v);
+    auto y1 = opr::BatchedMatrixMul::make(opr::Softmax::make(qk_shuffle / 4.f, {2}), v);
+    //! softmax along the queries, which should not be fused
+    auto y2 = opr::BatchedMatrixMul::make(opr::Softmax::make(qk, {1}), v);
+
+    SymbolVar y0_opt, y1_opt, y2_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_attention();
+    unpack_vector(
+            gopt::optimize_for_inference({y0, y1, y2}, options), y0_opt, y1_opt,
+            y2_opt);
+    ASSERT_EQ(opr::Attention::typeinfo(), y0_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_EQ(4u, y0_opt.node()->owner_opr()->input().size());
+    ASSERT_FLOAT_EQ(0.125f, find_opr<opr::Attention>(y0_opt).param().scale);
+    ASSERT_EQ(opr::Attention::typeinfo(), y1_opt.node()->owner_opr()->dyn_typeinfo());
+    ASSERT_EQ(3u, y1_opt.node()->owner_opr()->input().size());
+    ASSERT_FLOAT_EQ(0.25f, find_opr<opr::Attention>(y1_opt).param().scale);
+    ASSERT_EQ(0u, find_opr_num<opr::Attention>(y2_opt));
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1),
+             make_callback_copy(y1_opt, host_y1_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-4);
+}
+
 TEST(TestGoptInference, Float16IOFloat32ComputeWarpPerspective) {
     constexpr size_t INP_H = 10, INP_W = 10, N = 2;
     HostTensorGenerator<> gen;
@@ -0,0 +1,92 @@
+/**
+ * \file src/opr/impl/dnn/attention.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/attention.h"
+
+#include "../internal/megdnn_opr_wrapper.inl"
+
+using namespace mgb;
+using namespace opr;
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(AttentionForward);
+
+AttentionForward::AttentionForward(
+        VarNode* q, VarNode* k, VarNode* v, VarNode* mask, const Param& param,
+        const OperatorNodeConfig& config)
+        : Super{q->owner_graph(), config, "attention", {q, k, v}} {
+    init_megdnn_opr(*this, param);
+    if (mask) {
+        add_input({q, k, v, mask});
+    } else {
+        add_input({q, k, v});
+    }
+}
+
+SymbolVar AttentionForward::make(
+        SymbolVar q, SymbolVar k, SymbolVar v, const Param& param,
+        const OperatorNodeConfig& config) {
+    return q.insert_single_output_opr<AttentionForward>(
+            q.node(), k.node(), v.node(), nullptr, param, config);
+}
+
+SymbolVar AttentionForward::make(
+        SymbolVar q, SymbolVar k, SymbolVar v, SymbolVar mask, const Param& param,
+        const OperatorNodeConfig& config) {
+    return q.insert_single_output_opr<AttentionForward>(
+            q.node(), k.node(), v.node(), mask.node(), param, config);
+}
+
+megdnn::TensorLayout AttentionForward::mask_layout(
+        const TensorShapeArray& input_shapes) const {
+    if (input_shapes.size() == 4) {
+        return {input_shapes[3], input(3)->dtype()};
+    }
+    megdnn::TensorLayout layout;
+    layout.ndim = 0;
+    layout.dtype = input(0)->dtype();
+    return layout;
+}
+
+size_t AttentionForward::get_workspace_size_bytes(
+        const TensorShapeArray& input_shapes,
+        const TensorShapeArray& output_shapes) const {
+    return megdnn_opr()->get_workspace_in_bytes(
+            {input_shapes[0], input(0)->dtype()},
+            {input_shapes[1], input(1)->dtype()},
+            {input_shapes[2], input(2)->dtype()}, mask_layout(input_shapes),
+            {output_shapes[0], output(0)->dtype()});
+}
+
+void AttentionForward::scn_do_execute() {
+    auto&& inp = input();
+    megdnn::TensorND mask;
+    if (inp.size() == 4) {
+        mask = inp[3]->dev_tensor().as_megdnn();
+    } else {
+        mask = {nullptr, mask_layout({})};
+    }
+    megdnn_opr()->exec(
+            inp[0]->dev_tensor().as_megdnn(), inp[1]->dev_tensor().as_megdnn(),
+            inp[2]->dev_tensor().as_megdnn(), mask,
+            output(0)->dev_tensor().as_megdnn(),
+            intl::get_megdnn_workspace_from_var(output().back()));
+}
+
+void AttentionForward::get_output_var_shape(
+        const TensorShapeArray& inp_shape, TensorShapeArray& out_shape) const {
+    TensorLayout dst;
+    megdnn_opr()->deduce_layout(
+            {inp_shape[0], input(0)->dtype()}, {inp_shape[1], input(1)->dtype()},
+            {inp_shape[2], input(2)->dtype()}, {}, dst);
+    out_shape[0] = dst;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
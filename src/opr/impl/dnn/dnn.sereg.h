@@ -11,6 +11,7 @@
  */
 
 #include "megbrain/opr/dnn/adaptive_pooling.h"
+#include "megbrain/opr/dnn/attention.h"
 #include "megbrain/opr/dnn/batch_norm.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/dnn/correlation.h"
@@ -19,10 +20,13 @@
 #include "megbrain/opr/dnn/local.h"
 #include "megbrain/opr/dnn/lrn.h"
 #include "megbrain/opr/dnn/lsq.h"
+#include "megbrain/opr/dnn/norm.h"
 #include "megbrain/opr/dnn/pooling.h"
+#include "megbrain/opr/dnn/rnn.h"
 #include "megbrain/opr/dnn/roi_align.h"
 #include "megbrain/opr/dnn/roi_pooling.h"
 #include "megbrain/opr/dnn/sliding_window_transpose.h"
+#include "megbrain/opr/dnn/softmax.h"
 #include "megbrain/opr/dnn/tqt.h"
 #include "megbrain/serialization/sereg.h"
 #include "megdnn/opr_param_defs.h"
@@ -500,6 +504,69 @@ struct OprLoadDumpImpl<opr::DeformableConvBackwardFilter, 0>
                   opr::DeformableConvBackwardFilter,
                   MakeConvCaller5<megdnn::DeformableConvBackwardFilter>,
                   megdnn::Convolution> {};
+
+//! the mask of attention is optional
+template <>
+struct OprMaker<opr::Attention, 0> {
+    using Opr = opr::Attention;
+    using Param = Opr::Param;
+    static cg::OperatorNodeBase* make(
+            const Param& param, const cg::VarNodeArray& inputs, ComputingGraph& graph,
+            const OperatorNodeConfig& config) {
+        MGB_MARK_USED_VAR(graph);
+        if (inputs.size() == 3) {
+            return Opr::make(inputs[0], inputs[1], inputs[2], param, config)
+                    .node()
+                    ->owner_opr();
+        } else {
+            mgb_assert(inputs.size() == 4);
+            return Opr::make(inputs[0], inputs[1], inputs[2], inputs[3], param, config)
+                    .node()
+                    ->owner_opr();
+        }
+    }
+};
+
+//! seq_len of LSTM and GRU is the optional last input
+template <>
+struct OprMaker<opr::LSTM, 0> {
+    using Opr = opr::LSTM;
+    using Param = Opr::Param;
+    static cg::OperatorNodeBase* make(
+            const Param& param, const cg::VarNodeArray& i, ComputingGraph& graph,
+            const OperatorNodeConfig& config) {
+        MGB_MARK_USED_VAR(graph);
+        if (i.size() == 4) {
+            return Opr::make(i[0], i[1], i[2], i[3], param, config)[0]
+                    .node()
+                    ->owner_opr();
+        } else {
+            mgb_assert(i.size() == 5);
+            return Opr::make(i[0], i[1], i[2], i[3], i[4], param, config)[0]
+                    .node()
+                    ->owner_opr();
+        }
+    }
+};
+
+template <>
+struct OprMaker<opr::GRU, 0> {
+    using Opr = opr::GRU;
+    using Param = Opr::Param;
+    static cg::OperatorNodeBase* make(
+            const Param& param, const cg::VarNodeArray& i, ComputingGraph& graph,
+            const OperatorNodeConfig& config) {
+        MGB_MARK_USED_VAR(graph);
+        if (i.size() == 3) {
+            return Opr::make(i[0], i[1], i[2], param, config)[0].node()->owner_opr();
+        } else {
+            mgb_assert(i.size() == 4);
+            return Opr::make(i[0], i[1], i[2], i[3], param, config)[0]
+                    .node()
+                    ->owner_opr();
+        }
+    }
+};
 }  // namespace serialization
 
 namespace opr {
@@ -593,6 +660,12 @@ MGB_SEREG_OPR(TQT, 2);
 MGB_SEREG_OPR(TQTBackward, 3);
 MGB_SEREG_OPR(LSQ, 4);
 MGB_SEREG_OPR(LSQBackward, 5);
+MGB_SEREG_OPR(Softmax, 1);
+MGB_SEREG_OPR(LayerNorm, 3);
+MGB_SEREG_OPR(GroupNorm, 3);
+MGB_SEREG_OPR(Attention, 0);
+MGB_SEREG_OPR(LSTM, 0);
+MGB_SEREG_OPR(GRU, 0);
 }  // namespace opr
 
 }  // namespace mgb
@@ -0,0 +1,39 @@
+/**
+ * \file src/opr/impl/dnn/norm.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/norm.h"
+
+#include "../internal/megdnn_opr_wrapper.inl"
+
+using namespace mgb;
+using namespace opr;
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(LayerNormForward);
+MEGDNN_OPR_INIT3(LayerNormForward, "layer_norm")
+
+SymbolVar LayerNormForward::make(
+        SymbolVar data, const Param& param, const OperatorNodeConfig& config) {
+    mgb_assert(!param.affine, "weight and bias are required by affine layer norm");
+    auto placeholder = data.make_scalar_dt(0);
+    return make(data, placeholder, placeholder, param, config);
+}
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(GroupNormForward);
+MEGDNN_OPR_INIT3(GroupNormForward, "group_norm")
+
+SymbolVar GroupNormForward::make(
+        SymbolVar data, const Param& param, const OperatorNodeConfig& config) {
+    mgb_assert(!param.affine, "weight and bias are required by affine group norm");
+    auto placeholder = data.make_scalar_dt(0);
+    return make(data, placeholder, placeholder, param, config);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
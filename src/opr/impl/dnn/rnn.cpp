@@ -0,0 +1,195 @@
+/**
+ * \file src/opr/impl/dnn/rnn.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "megbrain/opr/dnn/rnn.h"
+
+#include "../internal/megdnn_opr_wrapper.inl"
+
+using namespace mgb;
+using namespace opr;
+
+namespace {
+//! the layout of seq_len, which is empty if the opr has no such input
+megdnn::TensorLayout get_seq_len_layout(
+        const TensorShapeArray& input_shapes, size_t nr_input) {
+    if (input_shapes.size() == nr_input + 1) {
+        return {input_shapes.back(), dtype::Int32()};
+    }
+    megdnn::TensorLayout layout;
+    layout.ndim = 0;
+    layout.dtype = dtype::Int32();
+    return layout;
+}
+
+megdnn::TensorND get_seq_len(const VarNodeArray& inputs, size_t nr_input) {
+    if (inputs.size() == nr_input + 1) {
+        return inputs.back()->dev_tensor().as_megdnn();
+    }
+    return {nullptr, get_seq_len_layout({}, nr_input)};
+}
+}  // anonymous namespace
+
+/* ================= LSTMForward =================  */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(LSTMForward);
+
+LSTMForward::LSTMForward(
+        VarNode* input, VarNode* hx, VarNode* cx, VarNode* flatten_weights,
+        VarNode* seq_len, const Param& param, const OperatorNodeConfig& config)
+        : Super{input->owner_graph(),
+                config,
+                "lstm",
+                {input, hx, cx, flatten_weights}} {
+    init_megdnn_opr(*this, param);
+    if (seq_len) {
+        add_input({input, hx, cx, flatten_weights, seq_len});
+    } else {
+        add_input({input, hx, cx, flatten_weights});
+    }
+}
+
+std::array<SymbolVar, 3> LSTMForward::make(
+        SymbolVar input, SymbolVar hx, SymbolVar cx, SymbolVar flatten_weights,
+        const Param& param, const OperatorNodeConfig& config) {
+    auto node = input.node()->owner_graph()->insert_opr(std::make_unique<LSTMForward>(
+            input.node(), hx.node(), cx.node(), flatten_weights.node(), nullptr, param,
+            config));
+    return {node->output(0), node->output(1), node->output(2)};
+}
+
+std::array<SymbolVar, 3> LSTMForward::make(
+        SymbolVar input, SymbolVar hx, SymbolVar cx, SymbolVar flatten_weights,
+        SymbolVar seq_len, const Param& param, const OperatorNodeConfig& config) {
+    auto node = input.node()->owner_graph()->insert_opr(std::make_unique<LSTMForward>(
+            input.node(), hx.node(), cx.node(), flatten_weights.node(), seq_len.node(),
+            param, config));
+    return {node->output(0), node->output(1), node->output(2)};
+}
+
+void LSTMForward::init_output_dtype() {
+    for (size_t i = 0; i < 3; ++i) {
+        output(i)->dtype(input(0)->dtype());
+    }
+}
+
+megdnn::TensorLayout LSTMForward::seq_len_layout(
+        const TensorShapeArray& input_shapes) const {
+    return get_seq_len_layout(input_shapes, 4);
+}
+
+size_t LSTMForward::get_workspace_size_bytes(
+        const TensorShapeArray& input_shapes,
+        const TensorShapeArray& output_shapes) const {
+    auto dtype = input(0)->dtype();
+    return megdnn_opr()->get_workspace_in_bytes(
+            {input_shapes[0], dtype}, seq_len_layout(input_shapes),
+            {input_shapes[1], dtype}, {input_shapes[2], dtype},
+            {input_shapes[3], dtype}, {output_shapes[0], dtype},
+            {output_shapes[1], dtype}, {output_shapes[2], dtype});
+}
+
+void LSTMForward::scn_do_execute() {
+    auto&& inp = input();
+    megdnn_opr()->exec(
+            inp[0]->dev_tensor().as_megdnn(), get_seq_len(inp, 4),
+            inp[1]->dev_tensor().as_megdnn(), inp[2]->dev_tensor().as_megdnn(),
+            inp[3]->dev_tensor().as_megdnn(), output(0)->dev_tensor().as_megdnn(),
+            output(1)->dev_tensor().as_megdnn(), output(2)->dev_tensor().as_megdnn(),
+            intl::get_megdnn_workspace_from_var(output().back()));
+}
+
+void LSTMForward::get_output_var_shape(
+        const TensorShapeArray& inp_shape, TensorShapeArray& out_shape) const {
+    auto dtype = input(0)->dtype();
+    TensorLayout output, hy, cy;
+    megdnn_opr()->deduce_layout(
+            {inp_shape[0], dtype}, seq_len_layout(inp_shape), {inp_shape[1], dtype},
+            {inp_shape[2], dtype}, {inp_shape[3], dtype}, output, hy, cy);
+    out_shape[0] = output;
+    out_shape[1] = hy;
+    out_shape[2] = cy;
+}
+
+/* ================= GRUForward =================  */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(GRUForward);
+
+GRUForward::GRUForward(
+        VarNode* input, VarNode* hx, VarNode* flatten_weights, VarNode* seq_len,
+        const Param& param, const OperatorNodeConfig& config)
+        : Super{input->owner_graph(), config, "gru", {input, hx, flatten_weights}} {
+    init_megdnn_opr(*this, param);
+    if (seq_len) {
+        add_input({input, hx, flatten_weights, seq_len});
+    } else {
+        add_input({input, hx, flatten_weights});
+    }
+}
+
+std::array<SymbolVar, 2> GRUForward::make(
+        SymbolVar input, SymbolVar hx, SymbolVar flatten_weights, const Param& param,
+        const OperatorNodeConfig& config) {
+    auto node = input.node()->owner_graph()->insert_opr(std::make_unique<GRUForward>(
+            input.node(), hx.node(), flatten_weights.node(), nullptr, param, config));
+    return {node->output(0), node->output(1)};
+}
+
+std::array<SymbolVar, 2> GRUForward::make(
+        SymbolVar input, SymbolVar hx, SymbolVar flatten_weights, SymbolVar seq_len,
+        const Param& param, const OperatorNodeConfig& config) {
+    auto node = input.node()->owner_graph()->insert_opr(std::make_unique<GRUForward>(
+            input.node(), hx.node(), flatten_weights.node(), seq_len.node(), param,
+            config));
+    return {node->output(0), node->output(1)};
+}
+
+void GRUForward::init_output_dtype() {
+    for (size_t i = 0; i < 2; ++i) {
+        output(i)->dtype(input(0)->dtype());
+    }
+}
+
+megdnn::TensorLayout GRUForward::seq_len_layout(
+        const TensorShapeArray& input_shapes) const {
+    return get_seq_len_layout(input_shapes, 3);
+}
+
+size_t GRUForward::get_workspace_size_bytes(
+        const TensorShapeArray& input_shapes,
+        const TensorShapeArray& output_shapes) const {
+    auto dtype = input(0)->dtype();
+    return megdnn_opr()->get_workspace_in_bytes(
+            {input_shapes[0], dtype}, seq_len_layout(input_shapes),
+            {input_shapes[1], dtype}, {input_shapes[2], dtype},
+            {output_shapes[0], dtype}, {output_shapes[1], dtype});
+}
+
+void GRUForward::scn_do_execute() {
+    auto&& inp = input();
+    megdnn_opr()->exec(
+            inp[0]->dev_tensor().as_megdnn(), get_seq_len(inp, 3),
+            inp[1]->dev_tensor().as_megdnn(), inp[2]->dev_tensor().as_megdnn(),
+            output(0)->dev_tensor().as_megdnn(), output(1)->dev_tensor().as_megdnn(),
+            intl::get_megdnn_workspace_from_var(output().back()));
+}
+
+void GRUForward::get_output_var_shape(
+        const TensorShapeArray& inp_shape, TensorShapeArray& out_shape) const {
+    auto dtype = input(0)->dtype();
+    TensorLayout output, hy;
+    megdnn_opr()->deduce_layout(
+            {inp_shape[0], dtype}, seq_len_layout(inp_shape), {inp_shape[1], dtype},
+            {inp_shape[2], dtype}, output, hy);
+    out_shape[0] = output;
+    out_shape[1] = hy;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
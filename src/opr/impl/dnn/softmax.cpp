@@ -0,0 +1,40 @@
+/**
+ * \file src/opr/impl/dnn/softmax.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/opr/dnn/softmax.h"
+#include "megbrain/graph/grad_impl.h"
+#include "megbrain/opr/basic_arith.h"
+
+#include "../internal/megdnn_opr_wrapper.inl"
+
+using namespace mgb;
+using namespace opr;
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(SoftmaxForward);
+MEGDNN_OPR_INIT1(SoftmaxForward, "softmax")
+
+#if MGB_ENABLE_GRAD
+MGB_IMPL_OPR_GRAD(SoftmaxForward) {
+    mgb_assert(wrt_idx == 0);
+    //! dx = y * (dy - sum(dy * y, axis))
+    int axis = opr.param().axis;
+    if (axis < 0) {
+        size_t ndim = opr.input(0)->shape().ndim;
+        mgb_assert(ndim, "softmax grad requires the ndim of input to be known");
+        axis += static_cast<int>(ndim);
+    }
+    SymbolVar y{opr.output(0)}, dy{out_grad[0]};
+    auto sum = Reduce::make(dy * y, {Reduce::Param::Mode::SUM, axis});
+    return (y * (dy - sum)).node();
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
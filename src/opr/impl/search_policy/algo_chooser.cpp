@@ -11,8 +11,12 @@
  */
 
 #include "megbrain/opr/search_policy/algo_chooser.h"
+#include <algorithm>
+#include <atomic>
 #include <limits>
+#include <thread>
 #include <unordered_set>
+#include "megbrain/comp_node_env.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/internal/megdnn_opr_wrapper.h"
 #include "megbrain/opr/search_policy/algo_chooser_helper.h"
@@ -58,6 +62,17 @@ std::string profile_name(Opr* opr) {
     return ret;
 }
 
+//! the results profiled with FastRunConfig::max_profile_candidates only cover
+//! part of the candidates, so they are cached apart from the full ones
+template <typename Opr>
+std::string profile_name(Opr* opr, uint32_t max_profile_candidates) {
+    std::string ret = profile_name(opr);
+    if (max_profile_candidates) {
+        ret.append(ssprintf(":max%u", max_profile_candidates));
+    }
+    return ret;
+}
+
 template <typename Opr>
 std::string format_fixlayouts(
         const typename opr::AlgoChooser<Opr>::FixedTensorLayouts& layouts,
@@ -89,6 +104,17 @@ std::string format_fixlayouts(
     return ret;
 }
 
+//! serialize a search item to a string which identifies it
+std::string serialize_search_item(const Algorithm::SearchItem& item) {
+    std::string ret;
+    Algorithm::serialize_write_pod(item.opr_type, ret);
+    for (auto&& layout : item.layouts) {
+        ret += layout.serialize();
+    }
+    ret += item.param;
+    return ret;
+}
+
 /**
  * \brief Check if the sub opr list has circular dependence.
  */
@@ -97,13 +123,8 @@ class CircularDepsChecker {
         std::string data_hold;
         size_t hash = 0;
 
-        SearchItemStorage(const Algorithm::SearchItem& item) {
-            Algorithm::serialize_write_pod(item.opr_type, data_hold);
-            for (auto&& layout : item.layouts) {
-                data_hold += layout.serialize();
-            }
-            data_hold += item.param;
-        }
+        SearchItemStorage(const Algorithm::SearchItem& item)
+                : data_hold{serialize_search_item(item)} {}
 
         SearchItemStorage& init_hash() {
             hash = XXHash64CT::hash(data_hold.data(), data_hold.size(), 20201225);
@@ -239,6 +260,18 @@ typename opr::AlgoChooser<Opr>::FixedTensorLayouts to_fixed_layouts(
     return ret;
 }
 
+//! a search item to be profiled, along with the opr it is profiled for
+struct ProfileItem {
+    Algorithm::SearchItem item;
+    //! 0 for the items without sub oprs, or 1 + the max height of their sub
+    //! oprs, so the items of the same height never depend on each other
+    size_t height;
+    const cg::OperatorNodeBase* mgb_opr;
+    CompNode cn;
+    megdnn::param::ExecutionPolicy execution_policy;
+    bool allow_weight_preprocess;
+};
+
 /**
  * flatten search space in postorder traversal
  * The subopr search construct a search tree
@@ -252,15 +285,17 @@ typename opr::AlgoChooser<Opr>::FixedTensorLayouts to_fixed_layouts(
  * D1 -> D2 -> D3 -> E -> B1 -> B2 -> C -> A
  */
 template <typename Opr>
-std::vector<megdnn::Algorithm::SearchItem> flatten_search_space(
+std::vector<ProfileItem> flatten_search_space(
         const typename opr::AlgoChooser<Opr>::AlgoChooserHelper& helper,
         CircularDepsChecker& checker) {
     auto&& search_item = megdnn::Algorithm::SearchItem{
             OprTypeFromOprTrait<Opr>::opr_type, helper.param(),
             to_layout_array<Opr>(helper.fastrun_layouts())};
     checker.put(search_item);
-    std::vector<megdnn::Algorithm::SearchItem> ret;
-    for (auto algo_info : helper.get_all_candidates()) {
+    std::vector<ProfileItem> ret;
+    size_t height = 0;
+    for (auto algo_info :
+         helper.get_profile_candidates(helper.execution_policy().strategy)) {
         megdnn::Algorithm* algo = helper.get_algorithm_from_desc(algo_info.desc);
         mgb_assert(algo, "Unknown algo description");
         std::vector<megdnn::Algorithm::SearchItem>&& sub_items = algo->get_subopr_list(
@@ -275,11 +310,14 @@ std::vector<megdnn::Algorithm::SearchItem> flatten_search_space(
                     _item.param, helper.mgb_opr(), helper.comp_node(),
                     helper.execution_policy(), helper.allow_weight_preprocess());
             auto space = flatten_search_space<_Opr>(sub_helper, checker);
+            height = std::max(height, space.back().height + 1);
             ret.insert(ret.end(), space.begin(), space.end());
         });
     }
-    ret.push_back(search_item);
     checker.remove(search_item);
+    ret.push_back(
+            {std::move(search_item), height, helper.mgb_opr(), helper.comp_node(),
+             helper.execution_policy(), helper.allow_weight_preprocess()});
     return ret;
 }
 
@@ -322,6 +360,196 @@ static Algorithm::Info::Desc deserialize_read_pod(
     return ret;
 }
 
+//! a string which identifies the profiling of a ProfileItem
+std::string profile_item_key(const ProfileItem& item) {
+    std::string ret = serialize_search_item(item.item);
+    Algorithm::serialize_write_pod(item.execution_policy.strategy, ret);
+    ret += item.cn.to_string();
+    return ret;
+}
+
+//! the searches of the fastrun oprs collected in the prealloc run of a graph,
+//! which are profiled together when the first opr is profiled
+class ProfileBatch final : public UserDataContainer::UserData {
+    MGB_TYPEINFO_OBJ_DECL;
+
+    std::unordered_set<std::string> m_keys;
+
+public:
+    //! the top-level search items, whose sub oprs are not known until the
+    //! workspace limits are known
+    std::vector<ProfileItem> items;
+
+    void add(ProfileItem item) {
+        if (m_keys.insert(profile_item_key(item)).second) {
+            items.emplace_back(std::move(item));
+        }
+    }
+
+    void clear() {
+        m_keys.clear();
+        items.clear();
+    }
+};
+MGB_TYPEINFO_OBJ_IMPL(ProfileBatch);
+
+//! take the search space of the oprs in the ProfileBatch of the graph
+std::vector<ProfileItem> take_profile_batch(cg::ComputingGraph* graph) {
+    std::vector<ProfileItem> ret;
+    auto batch = graph->options().user_data.get_user_data<ProfileBatch>();
+    if (!batch.second) {
+        return ret;
+    }
+    for (auto&& top : batch.first[0]->items) {
+        std::vector<Algorithm::SearchItem> search_items{top.item};
+        FOREACH_OPR_TYPE_DISPATCH(search_items, {
+            auto&& megdnn_opr = opr::intl::create_megdnn_opr<_Opr>(top.cn);
+            megdnn_opr->param() =
+                    Algorithm::deserialize_read_pod<typename _Opr::Param>(_item.param);
+            typename opr::AlgoChooser<_Opr>::AlgoChooserHelper helper(
+                    to_fixed_layouts<_Opr>(_item.layouts), megdnn_opr.get(),
+                    _item.param, top.mgb_opr, top.cn, top.execution_policy,
+                    top.allow_weight_preprocess);
+            CircularDepsChecker circular_deps_checker;
+            auto space = flatten_search_space<_Opr>(helper, circular_deps_checker);
+            ret.insert(ret.end(), space.begin(), space.end());
+        });
+    }
+    batch.first[0]->clear();
+    return ret;
+}
+
+//! the CPU comp nodes to profile on concurrently are put on the devices
+//! starting from this, which are not used otherwise
+constexpr int PROFILE_DEVICE_BASE = 1 << 21;
+
+/*!
+ * \brief get a copy of the CPU comp node \p cn for worker \p worker to
+ *      profile on, whose threads are pinned to the cores from \p core_begin
+ */
+CompNode get_profile_comp_node(CompNode cn, size_t worker, size_t core_begin) {
+    auto loc = cn.locator(), loc_logical = cn.locator_logical();
+    loc.device = loc_logical.device = PROFILE_DEVICE_BASE + static_cast<int>(worker);
+    loc.numa_node = loc_logical.numa_node = -1;
+    auto ret = CompNode::load(loc, loc_logical);
+    CompNodeEnv::from_comp_node(ret).cpu_env().set_affinity([core_begin](size_t i) {
+        sys::set_cpu_affinity({static_cast<int>(core_begin + i)});
+    });
+    return ret;
+}
+
+size_t get_nr_threads(CompNode cn) {
+    auto&& loc = cn.locator();
+    return loc.type == CompNode::DeviceType::MULTITHREAD ? loc.nr_threads : 1;
+}
+
+void profile_item(const ProfileItem& item, CompNode profile_cn) {
+    std::vector<Algorithm::SearchItem> search_items{item.item};
+    FOREACH_OPR_TYPE_DISPATCH(search_items, {
+        auto&& megdnn_opr = opr::intl::create_megdnn_opr<_Opr>(item.cn);
+        megdnn_opr->param() =
+                Algorithm::deserialize_read_pod<typename _Opr::Param>(_item.param);
+        typename opr::AlgoChooser<_Opr>::AlgoChooserHelper helper(
+                to_fixed_layouts<_Opr>(_item.layouts), megdnn_opr.get(), _item.param,
+                item.mgb_opr, item.cn, item.execution_policy,
+                item.allow_weight_preprocess);
+        helper.set_profile_comp_node(profile_cn);
+        helper.profile(item.execution_policy.strategy);
+    });
+}
+
+/*!
+ * \brief profile the items which do not depend on each other
+ *
+ * The items on CPU comp nodes are distributed to as many workers as the cores
+ * can hold, and each worker profiles on its own copy of the comp node pinned
+ * to disjoint cores, so the timings are not skewed by each other.
+ */
+void profile_items_concurrently(const std::vector<const ProfileItem*>& items) {
+    std::vector<const ProfileItem*> cpu_items;
+    size_t nr_threads = 1;
+    for (auto item : items) {
+        if (item->cn.device_type() == CompNode::DeviceType::CPU) {
+            cpu_items.push_back(item);
+            nr_threads = std::max(nr_threads, get_nr_threads(item->cn));
+        } else {
+            profile_item(*item, item->cn);
+        }
+    }
+    size_t nr_worker = std::min<size_t>(
+            cpu_items.size(), static_cast<size_t>(sys::get_cpu_count()) / nr_threads);
+    if (nr_worker <= 1) {
+        for (auto item : cpu_items) {
+            profile_item(*item, item->cn);
+        }
+        return;
+    }
+
+    std::atomic_size_t next_item{0};
+    std::vector<std::exception_ptr> errors(nr_worker);
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < nr_worker; ++worker) {
+        workers.emplace_back([&, worker]() {
+            MGB_TRY {
+                for (size_t i; (i = next_item++) < cpu_items.size();) {
+                    auto item = cpu_items[i];
+                    profile_item(
+                            *item, get_profile_comp_node(
+                                           item->cn, worker, worker * nr_threads));
+                }
+            }
+            MGB_CATCH(..., { errors[worker] = std::current_exception(); })
+        });
+    }
+    for (auto&& i : workers) {
+        i.join();
+    }
+    for (auto&& i : errors) {
+        if (i) {
+            std::rethrow_exception(i);
+        }
+    }
+}
+
+/*!
+ * \brief profile the items of a flattened search space, dropping the
+ *      duplicated ones
+ *
+ * If \p concurrent is true, the items of the same height are profiled
+ * concurrently, from the lowest height on.
+ */
+void profile_items(std::vector<ProfileItem> items, bool concurrent) {
+    //! sub oprs shared by several candidates or oprs appear more than once in
+    //! the search space, and only the first occurrence needs to be profiled
+    std::unordered_set<std::string> visited_items;
+    items.erase(
+            std::remove_if(
+                    items.begin(), items.end(),
+                    [&visited_items](const ProfileItem& item) {
+                        return !visited_items.insert(profile_item_key(item)).second;
+                    }),
+            items.end());
+    if (!concurrent) {
+        for (auto&& item : items) {
+            profile_item(item, item.cn);
+        }
+        return;
+    }
+    std::stable_sort(
+            items.begin(), items.end(),
+            [](const ProfileItem& x, const ProfileItem& y) {
+                return x.height < y.height;
+            });
+    std::vector<const ProfileItem*> same_height;
+    for (size_t i = 0; i < items.size(); ++i) {
+        same_height.push_back(&items[i]);
+        if (i + 1 == items.size() || items[i + 1].height != items[i].height) {
+            profile_items_concurrently(same_height);
+            same_height.clear();
+        }
+    }
+}
+
 }  // namespace
 
 namespace mgb {
@@ -497,6 +725,7 @@ AlgoChooser<Opr>::AlgoChooserHelper::AlgoChooserHelper(
           m_param{param_str},
           m_base_mgb_opr{mgb_opr},
           m_cn{cn},
+          m_profile_cn{cn},
           m_execution_policy{execution_policy},
           m_allow_weight_preprocess{allow_weight_preprocess} {
     auto fastrun_batch_size =
@@ -586,16 +815,15 @@ typename AlgoChooser<Opr>::ImplExecutionPolicy AlgoChooser<Opr>::AlgoChooserHelp
     if (enable_update) {
         CircularDepsChecker circular_deps_checker;
         auto&& search_items = flatten_search_space<Opr>(*this, circular_deps_checker);
-        FOREACH_OPR_TYPE_DISPATCH(search_items, {
-            auto&& megdnn_opr = intl::create_megdnn_opr<_Opr>(m_cn);
-            megdnn_opr->param() =
-                    Algorithm::deserialize_read_pod<typename _Opr::Param>(_item.param);
-            typename AlgoChooser<_Opr>::AlgoChooserHelper sub_helper(
-                    to_fixed_layouts<_Opr>(_item.layouts), megdnn_opr.get(),
-                    _item.param, m_base_mgb_opr, m_cn, m_execution_policy,
-                    m_allow_weight_preprocess);
-            sub_helper.profile(selected_strategy);
-        });
+        //! with the candidates pruned, the searches of the whole graph are
+        //! profiled together, so that the independent ones run concurrently
+        bool batch = owner_graph()->options().fast_run_config.max_profile_candidates;
+        if (batch) {
+            auto graph_items = take_profile_batch(owner_graph());
+            search_items.insert(
+                    search_items.begin(), graph_items.begin(), graph_items.end());
+        }
+        profile_items(std::move(search_items), batch);
     }
 
     typename AlgoChooser<Opr>::ImplExecutionPolicy policy;
@@ -610,7 +838,10 @@ std::pair<
 AlgoChooser<Opr>::AlgoChooserHelper::get_profile_result_from_cache(
         const ExecutionStrategy& selected_strategy) const {
     MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("get_profile_result_from_cache")))
-    AlgoChooserProfileCache cache(m_cn, profile_name(m_dnn_opr).c_str());
+    auto max_candidates =
+            owner_graph()->options().fast_run_config.max_profile_candidates;
+    AlgoChooserProfileCache cache(
+            m_cn, profile_name(m_dnn_opr, max_candidates).c_str());
 
     typename Opr::Param origin_param = m_dnn_opr->param();
     AlgoChooserProfileCache::Key cache_key{
@@ -796,6 +1027,41 @@ std::vector<typename AlgoChooser<Opr>::ImplAlgo> AlgoChooser<
     MIDOUT_E
 }
 
+template <typename Opr>
+std::vector<typename AlgoChooser<Opr>::ImplAlgo> AlgoChooser<Opr>::AlgoChooserHelper::
+        get_profile_candidates(const ExecutionStrategy& selected_strategy) const {
+    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("get_profile_candidates")))
+    auto ret = get_all_candidates();
+    size_t max_candidates =
+            owner_graph()->options().fast_run_config.max_profile_candidates;
+    if (!max_candidates) {
+        return ret;
+    }
+
+    //! the heuristic choice at the front is always kept
+    auto target_attr = extract_algo_attribute(selected_strategy);
+    auto get_algo = [this](const ImplAlgo& algo) {
+        auto palgo = m_dnn_opr->get_algorithm_from_desc(algo.desc);
+        mgb_assert(palgo, "Unknown algo description");
+        return palgo;
+    };
+    auto has_negative_attr = [&](const ImplAlgo& algo) {
+        return get_algo(algo)->contain_attribute_any(target_attr.second);
+    };
+    ret.erase(std::remove_if(ret.begin() + 1, ret.end(), has_negative_attr), ret.end());
+    std::stable_partition(ret.begin() + 1, ret.end(), [&](const ImplAlgo& algo) {
+        return !get_algo(algo)->contain_attribute_all(AlgoAttribute::NAIVE);
+    });
+    if (ret.size() > max_candidates) {
+        mgb_log_debug(
+                "%s: profile %zu of %zu candidate algorithms",
+                m_base_mgb_opr->dyn_typeinfo()->name, max_candidates, ret.size());
+        ret.erase(ret.begin() + max_candidates, ret.end());
+    }
+    return ret;
+    MIDOUT_E
+}
+
 template <typename Opr>
 Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper::
         profile_single_algo(const ImplExecutionPolicy& policy, double& timeout) const {
@@ -822,8 +1088,8 @@ Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper:
                 src.to_string().c_str());
         param.dtypes[i] = src.dtype.enumv();
     }
-    param.comp_node_physical = m_cn.locator();
-    param.comp_node_logical = m_cn.locator_logical();
+    param.comp_node_physical = m_profile_cn.locator();
+    param.comp_node_logical = m_profile_cn.locator_logical();
     mgb_assert(param.shapes.size() == m_fastrun_layouts.size());
     for (size_t i = 0; i < param.shapes.size(); ++i)
         param.shapes[i] = m_fastrun_layouts[i];
@@ -833,6 +1099,15 @@ Maybe<AlgoChooserProfileCache::ResultEntry> AlgoChooser<Opr>::AlgoChooserHelper:
     Algorithm* palgo = m_dnn_opr->get_algorithm_from_desc(policy.algo);
     mgb_assert(palgo, "can not find algo when profile single algo");
 
+    if (m_profile_cn != m_cn) {
+        auto rst = TimedProfiler<Opr>::profile_inplace(param);
+        std::string algo_desc;
+        serialize_write_pod(policy.algo, algo_desc);
+        return AlgoChooserProfileCache::ResultEntry{
+                algo_desc, static_cast<uint32_t>(palgo->attribute()), rst.time,
+                param.workspace};
+    }
+
     auto rst = TimedProfiler<Opr>::profile(param, timeout);
     // MIOpen conv profiles all available algos when a specfic shape is
     // provided for the first time, which probably adds to the result time.
@@ -877,7 +1152,7 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
                     return result.algo;
                 });
     }
-    for (auto algo : get_all_candidates()) {
+    for (auto algo : get_profile_candidates(selected_strategy)) {
         std::string desc;
         serialize_write_pod(algo.desc, desc);
         if (rst_algos.find(desc) != rst_algos.end()) {
@@ -954,7 +1229,10 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
             incache_layouts.data(), incache_layouts.size(), &origin_param,
             sizeof(origin_param)};
 
-    AlgoChooserProfileCache cache(m_cn, profile_name(m_dnn_opr).c_str());
+    auto max_candidates =
+            owner_graph()->options().fast_run_config.max_profile_candidates;
+    AlgoChooserProfileCache cache(
+            m_cn, profile_name(m_dnn_opr, max_candidates).c_str());
     cache.put(cache_key, prof_rst);
     MIDOUT_E
 }
@@ -1059,6 +1337,9 @@ std::pair<AlgoAttribute, AlgoAttribute> AlgoChooser<Opr>::AlgoChooserHelper::
             const FixedTensorLayouts& layouts) const;                             \
     template std::vector<typename AlgoChooser<megdnn::Opr>::ImplAlgo>             \
     AlgoChooser<megdnn::Opr>::AlgoChooserHelper::get_all_candidates() const;      \
+    template std::vector<typename AlgoChooser<megdnn::Opr>::ImplAlgo>             \
+    AlgoChooser<megdnn::Opr>::AlgoChooserHelper::get_profile_candidates(          \
+            const ExecutionStrategy& selected_strategy) const;                    \
     template Maybe<AlgoChooserProfileCache::ResultEntry>                          \
     AlgoChooser<megdnn::Opr>::AlgoChooserHelper::profile_single_algo(             \
             const typename AlgoChooser<megdnn::Opr>::ImplExecutionPolicy& policy, \
@@ -1131,9 +1412,45 @@ size_t AlgoChooser<Opr>::setup_algo(
     }
 
     if (WorkspaceLimitGetter::is_prealloc_run(mgb_opr->owner_graph())) {
+#if MGB_ENABLE_FASTRUN
+        //! all the fastrun oprs of the graph are seen in the prealloc run, and
+        //! they are profiled together when the first of them is profiled
+        auto strategy = mgb_opr->execution_policy().strategy;
+        cg::ComputingGraph* graph = mgb_opr->owner_graph();
+        if (graph->options().fast_run_config.max_profile_candidates &&
+            (strategy & ExecutionStrategy::PROFILE) &&
+            !(strategy & ExecutionStrategy::HEURISTIC) && !mgb_opr->algo_chooser()) {
+            std::string param_str;
+            Algorithm::serialize_write_pod(megdnn_opr->param(), param_str);
+            AlgoChooserHelper helper(
+                    layouts, megdnn_opr, param_str, mgb_opr, mgb_opr->comp_node(),
+                    mgb_opr->execution_policy(), allow_weight_preprocess);
+            graph->options().user_data.get_user_data_or_create<ProfileBatch>()->add(
+                    {{OprTypeFromOprTrait<Opr>::opr_type, param_str,
+                      to_layout_array<Opr>(helper.fastrun_layouts())},
+                     0,
+                     mgb_opr,
+                     mgb_opr->comp_node(),
+                     mgb_opr->execution_policy(),
+                     allow_weight_preprocess});
+        }
+#endif
         return 0;
     }
 
+    // the heuristic results are already cached globally; the other
+    // strategies reuse the choices of this opr for previously seen layouts
+    bool use_opr_cache =
+            !(mgb_opr->execution_policy().strategy & ExecutionStrategy::HEURISTIC);
+    if (use_opr_cache) {
+        size_t workspace;
+        if (mgb_opr->get_cached_algo(
+                    cache_key.build_key_storage(), megdnn_opr->execution_policy(),
+                    workspace)) {
+            return workspace;
+        }
+    }
+
     std::string param_str;
     Algorithm::serialize_write_pod(megdnn_opr->param(), param_str);
     AlgoChooserHelper helper(
@@ -1166,7 +1483,11 @@ size_t AlgoChooser<Opr>::setup_algo(
 
     megdnn_opr->execution_policy() = policy;
 
-    if (mgb_opr->execution_policy().strategy & ExecutionStrategy::HEURISTIC) {
+    if (use_opr_cache) {
+        mgb_opr->put_cached_algo(
+                cache_key.build_key_storage(), policy, workspace,
+                mgb_opr->owner_graph()->options().seq_opt.static_mem_plan_cache_size);
+    } else {
         HeuristicCache::Result cache_result{policy, workspace};
         HeuristicCache::instance().put(cache_key, cache_result);
     }
@@ -30,4 +30,31 @@ void AlgoChooserHelper::set_execution_policy(const ExecutionPolicy& policy) {
     m_policy = policy;
 }
 
+bool AlgoChooserHelper::get_cached_algo(
+        const megdnn::HeuristicCache::KeyStorage& key, AlgorithmPolicy& policy,
+        size_t& workspace) const {
+    for (auto iter = m_algo_cache.begin(); iter != m_algo_cache.end(); ++iter) {
+        if (iter->key == key) {
+            policy = iter->policy;
+            workspace = iter->workspace;
+            m_algo_cache.splice(m_algo_cache.begin(), m_algo_cache, iter);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AlgoChooserHelper::put_cached_algo(
+        const megdnn::HeuristicCache::KeyStorage& key, const AlgorithmPolicy& policy,
+        size_t workspace, size_t capacity) const {
+    if (!capacity) {
+        m_algo_cache.clear();
+        return;
+    }
+    m_algo_cache.push_front({key, policy, workspace});
+    while (m_algo_cache.size() > capacity) {
+        m_algo_cache.pop_back();
+    }
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -383,6 +383,15 @@ Maybe<typename TimedProfiler<Opr>::Result> TimedProfiler<Opr>::profile(
     return None;
 }
 
+template <typename Opr>
+typename TimedProfiler<Opr>::Result TimedProfiler<Opr>::profile_inplace(
+        const Param& param) {
+    param.actual_timeout = std::numeric_limits<double>::infinity();
+    auto raw_param = TParam::from_pod(const_cast<Param&>(param));
+    prof_init_device(raw_param);
+    return prof_impl(raw_param).template as_single_pod<Result>();
+}
+
 template <typename Opr>
 void TimedProfiler<Opr>::prof_init_device(const TParam& raw_param) {
     MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("TimedProfiler::prof_init_device")))
@@ -403,6 +412,8 @@ void TimedProfiler<Opr>::prof_init_device(const TParam& raw_param) {
     TimedProfiler<megdnn::Opr>::prof_impl(const TParam& raw_param);           \
     template Maybe<typename TimedProfiler<megdnn::Opr>::Result>               \
     TimedProfiler<megdnn::Opr>::profile(const Param& param, double& timeout); \
+    template typename TimedProfiler<megdnn::Opr>::Result                      \
+    TimedProfiler<megdnn::Opr>::profile_inplace(const Param& param);          \
     template void TimedProfiler<megdnn::Opr>::prof_init_device(const TParam& raw_param);
 
 MGB_FOREACH_FASTRUN_OPR(INST)
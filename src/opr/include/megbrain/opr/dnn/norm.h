@@ -0,0 +1,61 @@
+/**
+ * \file src/opr/include/megbrain/opr/dnn/norm.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/opr/internal/megdnn_opr_wrapper.h"
+#include "megdnn/oprs.h"
+
+namespace mgb {
+namespace opr {
+
+/*!
+ * \brief layer normalization over the last param().normalized_dim dims
+ *
+ * weight and bias are ignored if param().affine is false, and the overload
+ * without them fills in scalar placeholders.
+ */
+MGB_DEFINE_OPR_CLASS(
+        LayerNormForward, intl::MegDNNOprWrapperFwd<megdnn::LayerNormForward>) // {
+public:
+    LayerNormForward(
+            VarNode* data, VarNode* weight, VarNode* bias, const Param& param,
+            const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar data, SymbolVar weight, SymbolVar bias, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+    static SymbolVar make(
+            SymbolVar data, const Param& param, const OperatorNodeConfig& config = {});
+};
+using LayerNorm = LayerNormForward;
+
+/*!
+ * \brief group normalization of (N, C, *) input, see LayerNormForward for
+ * the non-affine overload
+ */
+MGB_DEFINE_OPR_CLASS(
+        GroupNormForward, intl::MegDNNOprWrapperFwd<megdnn::GroupNormForward>) // {
+public:
+    GroupNormForward(
+            VarNode* data, VarNode* weight, VarNode* bias, const Param& param,
+            const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar data, SymbolVar weight, SymbolVar bias, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+    static SymbolVar make(
+            SymbolVar data, const Param& param, const OperatorNodeConfig& config = {});
+};
+using GroupNorm = GroupNormForward;
+
+}  // namespace opr
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,89 @@
+/**
+ * \file src/opr/include/megbrain/opr/dnn/rnn.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megbrain/opr/internal/megdnn_opr_wrapper.h"
+#include "megdnn/oprs.h"
+
+namespace mgb {
+namespace opr {
+
+/*!
+ * \brief LSTM over a sequence, whose outputs are the output sequence and the
+ *      final hidden and cell states
+ *
+ * seq_len is optional and is the last input if given, so the opr has four
+ * inputs if all the sequences are full.
+ */
+MGB_DEFINE_OPR_CLASS(LSTMForward, intl::MegDNNOprWrapperFwd<megdnn::LSTMForward>) // {
+    void init_output_dtype() override;
+    size_t get_workspace_size_bytes(
+            const TensorShapeArray& input_shapes,
+            const TensorShapeArray& output_shapes) const override;
+    void scn_do_execute() override;
+    void get_output_var_shape(
+            const TensorShapeArray& inp_shape,
+            TensorShapeArray& out_shape) const override;
+
+    megdnn::TensorLayout seq_len_layout(const TensorShapeArray& input_shapes) const;
+
+public:
+    //! seq_len may be nullptr
+    LSTMForward(
+            VarNode* input, VarNode* hx, VarNode* cx, VarNode* flatten_weights,
+            VarNode* seq_len, const Param& param, const OperatorNodeConfig& config);
+    static std::array<SymbolVar, 3> make(
+            SymbolVar input, SymbolVar hx, SymbolVar cx, SymbolVar flatten_weights,
+            const Param& param = {}, const OperatorNodeConfig& config = {});
+    static std::array<SymbolVar, 3> make(
+            SymbolVar input, SymbolVar hx, SymbolVar cx, SymbolVar flatten_weights,
+            SymbolVar seq_len, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+using LSTM = LSTMForward;
+
+/*!
+ * \brief GRU over a sequence, whose outputs are the output sequence and the
+ *      final hidden states
+ *
+ * seq_len is optional and is the last input if given.
+ */
+MGB_DEFINE_OPR_CLASS(GRUForward, intl::MegDNNOprWrapperFwd<megdnn::GRUForward>) // {
+    void init_output_dtype() override;
+    size_t get_workspace_size_bytes(
+            const TensorShapeArray& input_shapes,
+            const TensorShapeArray& output_shapes) const override;
+    void scn_do_execute() override;
+    void get_output_var_shape(
+            const TensorShapeArray& inp_shape,
+            TensorShapeArray& out_shape) const override;
+
+    megdnn::TensorLayout seq_len_layout(const TensorShapeArray& input_shapes) const;
+
+public:
+    //! seq_len may be nullptr
+    GRUForward(
+            VarNode* input, VarNode* hx, VarNode* flatten_weights, VarNode* seq_len,
+            const Param& param, const OperatorNodeConfig& config);
+    static std::array<SymbolVar, 2> make(
+            SymbolVar input, SymbolVar hx, SymbolVar flatten_weights,
+            const Param& param = {}, const OperatorNodeConfig& config = {});
+    static std::array<SymbolVar, 2> make(
+            SymbolVar input, SymbolVar hx, SymbolVar flatten_weights, SymbolVar seq_len,
+            const Param& param = {}, const OperatorNodeConfig& config = {});
+};
+using GRU = GRUForward;
+
+}  // namespace opr
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
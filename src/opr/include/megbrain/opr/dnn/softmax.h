@@ -0,0 +1,39 @@
+/**
+ * \file src/opr/include/megbrain/opr/dnn/softmax.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain/opr/internal/megdnn_opr_wrapper.h"
+#include "megdnn/oprs.h"
+
+namespace mgb {
+namespace opr {
+
+/*!
+ * \brief softmax along param().axis, computed by a single kernel
+ *
+ * It is usually created by FuseSoftmaxPass from the
+ * exp(x - max(x)) / sum(exp(x - max(x))) subgraph.
+ */
+MGB_DEFINE_OPR_CLASS(
+        SoftmaxForward, intl::MegDNNOprWrapperFwd<megdnn::SoftmaxForward>) // {
+public:
+    SoftmaxForward(VarNode* src, const Param& param, const OperatorNodeConfig& config);
+    static SymbolVar make(
+            SymbolVar src, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+using Softmax = SoftmaxForward;
+
+}  // namespace opr
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
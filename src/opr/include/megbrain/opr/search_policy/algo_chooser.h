@@ -77,6 +77,8 @@ public:
         std::string m_param;
         const cg::OperatorNodeBase* m_base_mgb_opr;
         CompNode m_cn;
+        //! comp node where the algorithms are profiled
+        CompNode m_profile_cn;
         megdnn::param::ExecutionPolicy m_execution_policy;
         bool m_allow_weight_preprocess;
 
@@ -102,6 +104,14 @@ public:
             return m_execution_policy;
         }
         CompNode comp_node() const { return m_cn; }
+
+        /*!
+         * \brief profile the algorithms on another comp node of the same
+         *      kind, which are run in place without time limit
+         *
+         * The results are still cached for comp_node().
+         */
+        void set_profile_comp_node(CompNode cn) { m_profile_cn = cn; }
         const std::string& param() const { return m_param; }
 
         bool allow_weight_preprocess() const { return m_allow_weight_preprocess; }
@@ -150,6 +160,17 @@ public:
         //! put first
         std::vector<ImplAlgo> get_all_candidates() const;
 
+        /*!
+         * \brief get candidate algos to be profiled
+         *
+         * All the candidates are returned unless
+         * FastRunConfig::max_profile_candidates is set, in which case algos
+         * with negative attributes of the strategy are dropped, naive algos
+         * are moved to the end and the list is truncated.
+         */
+        std::vector<ImplAlgo> get_profile_candidates(
+                const ExecutionStrategy& selected_strategy) const;
+
         /*!
          * \brief profile a single algorithm
          *
@@ -13,9 +13,12 @@
 #pragma once
 
 #include "megbrain/graph/operator_node.h"
+#include "megdnn/heuristic_cache.h"
 #include "megdnn/oprs/base.h"
 #include "megdnn/oprs/nn.h"
 
+#include <list>
+
 namespace mgb {
 namespace opr {
 
@@ -59,6 +62,24 @@ public:
     void setup_algo_chooser(AlgoChooserHook&& func) { m_algo_chooser = func; }
     AlgoChooserHook algo_chooser() const { return m_algo_chooser; }
 
+    /*!
+     * \brief find the algorithm chosen for the layouts and param in \p key
+     *
+     * The algorithms chosen by AlgoChooser::setup_algo() for recently seen
+     * layouts are kept in the opr, so that they are not chosen again when
+     * the shapes switch back.
+     *
+     * \return whether the algorithm is found
+     */
+    bool get_cached_algo(
+            const megdnn::HeuristicCache::KeyStorage& key, AlgorithmPolicy& policy,
+            size_t& workspace) const;
+
+    //! record the chosen algorithm, keeping at most \p capacity of them
+    void put_cached_algo(
+            const megdnn::HeuristicCache::KeyStorage& key,
+            const AlgorithmPolicy& policy, size_t workspace, size_t capacity) const;
+
 protected:
     ~AlgoChooserHelper();
 
@@ -66,6 +87,15 @@ protected:
     ExecutionPolicy m_policy;
 
     AlgoChooserHook m_algo_chooser;
+
+private:
+    struct CachedAlgo {
+        megdnn::HeuristicCache::KeyStorage key;
+        AlgorithmPolicy policy;
+        size_t workspace;
+    };
+    //! most recently used one at the front
+    mutable std::list<CachedAlgo> m_algo_cache;
 };
 }  // namespace mixin
 }  // namespace opr
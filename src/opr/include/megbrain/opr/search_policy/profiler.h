@@ -135,6 +135,14 @@ public:
 
     static Maybe<Result> profile(const Param& param, double& timeout);
 
+    /*!
+     * \brief profile in the caller thread without time limit
+     *
+     * It is used when several algorithms are profiled concurrently, which
+     * the single worker process of sys::TimedFuncInvoker could not do.
+     */
+    static Result profile_inplace(const Param& param);
+
 private:
     using TParam = sys::TimedFuncInvoker::Param;
     using TResult = sys::TimedFuncInvoker::Result;
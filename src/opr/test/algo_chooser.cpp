@@ -24,7 +24,10 @@
 #include "megdnn/heuristic_cache.h"
 #include "megdnn/oprs/base.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <mutex>
 #include <random>
 #include <utility>
 
@@ -345,6 +348,164 @@ TEST(TestOprDNN, FastrunNoProfilingOnShapeChange) {
 #endif  // MGB_ENABLE_FASTRUN
 #endif  // MGB_CUDA
 
+#if MGB_ENABLE_FASTRUN
+TEST(TestOprDNN, FastrunMaxProfileCandidates) {
+    megdnn::HeuristicCache::instance().clear();
+
+    //! number of profiled algorithms of each result put into the cache
+    std::vector<uint32_t> nr_algos;
+    auto on_get = [](const std::string&, const void*, size_t, const void*, size_t) {};
+    auto on_set = [&nr_algos](
+                          const std::string& category, const void*, size_t,
+                          const void* val, size_t val_size) {
+        if (category.compare(0, 8, "profile:")) {
+            return;
+        }
+        //! number of profiled algorithms is stored at the beginning
+        uint32_t nr_algo;
+        ASSERT_GE(val_size, sizeof(nr_algo));
+        memcpy(&nr_algo, val, sizeof(nr_algo));
+        nr_algos.push_back(nr_algo);
+    };
+    PersistentCacheHook cache_hook{on_get, on_set};
+
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({3, 5, 17, 19}, cn), host_w = gen({7, 5, 3, 3}, cn);
+    auto run = [&](uint32_t max_profile_candidates) {
+        auto graph = ComputingGraph::make();
+        graph->options().fast_run_config.max_profile_candidates =
+                max_profile_candidates;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+             w = opr::Host2DeviceCopy::make(*graph, host_w);
+        opr::Convolution::ExecutionPolicy policy;
+        policy.strategy = opr::Convolution::ExecutionPolicy::Strategy::PROFILE;
+        auto y = opr::Convolution::make(x, w, {}, policy);
+
+        HostTensorND host_y;
+        auto func = graph->compile({make_callback_copy(y, host_y)});
+        func->execute();
+    };
+
+    run(1);
+    ASSERT_FALSE(nr_algos.empty());
+    for (auto i : nr_algos) {
+        ASSERT_EQ(1u, i);
+    }
+
+    // the pruned results must not be taken by a graph profiling all the
+    // candidates
+    nr_algos.clear();
+    run(0);
+    ASSERT_FALSE(nr_algos.empty());
+    ASSERT_GT(*std::max_element(nr_algos.begin(), nr_algos.end()), 1u);
+}
+
+TEST(TestOprDNN, FastrunNoLookupOnShapeSwitchBack) {
+    megdnn::HeuristicCache::instance().clear();
+
+    size_t nr_get = 0;
+    auto on_get = [&nr_get](
+                          const std::string& category, const void*, size_t,
+                          const void*, size_t) {
+        nr_get += !category.compare(0, 8, "profile:");
+    };
+    auto on_set = [](const std::string&, const void*, size_t, const void*, size_t) {};
+    PersistentCacheHook cache_hook{on_get, on_set};
+
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({3, 5, 17, 19}, cn), host_w = gen({7, 5, 3, 3}, cn);
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+         w = opr::Host2DeviceCopy::make(*graph, host_w);
+    opr::Convolution::ExecutionPolicy policy;
+    policy.strategy = opr::Convolution::ExecutionPolicy::Strategy::PROFILE;
+    auto y = opr::Convolution::make(x, w, {}, policy);
+    HostTensorND host_y;
+    auto func = graph->compile({make_callback_copy(y, host_y)});
+    auto run = [&](const TensorShape& shape) {
+        host_x->copy_from(*gen(shape, cn));
+        func->execute();
+    };
+
+    run({3, 5, 17, 19});
+    run({2, 5, 11, 13});
+    auto nr = nr_get;
+    ASSERT_GT(nr, 0u);
+
+    // the algorithms chosen for the previous shapes are kept by the opr
+    run({3, 5, 17, 19});
+    run({2, 5, 11, 13});
+    ASSERT_EQ(nr, nr_get);
+}
+
+TEST(TestOprDNN, FastrunProfileBatch) {
+    megdnn::HeuristicCache::instance().clear();
+
+    //! the profiling may run on several threads
+    std::mutex mtx;
+    std::vector<std::string> profiled_keys;
+    auto on_get = [](const std::string&, const void*, size_t, const void*, size_t) {};
+    auto on_set = [&](const std::string& category, const void* key, size_t key_size,
+                      const void*, size_t) {
+        if (!category.compare(0, 8, "profile:")) {
+            MGB_LOCK_GUARD(mtx);
+            profiled_keys.emplace_back(static_cast<const char*>(key), key_size);
+        }
+    };
+    PersistentCacheHook cache_hook{on_get, on_set};
+
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto host_x0 = gen({3, 5, 17, 19}, cn), host_x1 = gen({3, 5, 17, 19}, cn),
+         host_w0 = gen({7, 5, 3, 3}, cn), host_w1 = gen({4, 5, 3, 3}, cn);
+    auto make_graph = [&](opr::Convolution::ExecutionPolicy::Strategy strategy,
+                          uint32_t max_profile_candidates) {
+        auto graph = ComputingGraph::make();
+        graph->options().fast_run_config.max_profile_candidates =
+                max_profile_candidates;
+        auto x0 = opr::Host2DeviceCopy::make(*graph, host_x0),
+             x1 = opr::Host2DeviceCopy::make(*graph, host_x1),
+             w0 = opr::Host2DeviceCopy::make(*graph, host_w0),
+             w1 = opr::Host2DeviceCopy::make(*graph, host_w1);
+        opr::Convolution::ExecutionPolicy policy;
+        policy.strategy = strategy;
+        // the first two convolutions share the same profiling key
+        SymbolVarArray ys{
+                opr::Convolution::make(x0, w0, {}, policy),
+                opr::Convolution::make(x1, w0, {}, policy),
+                opr::Convolution::make(x0, w1, {}, policy)};
+        return std::make_pair(graph, ys);
+    };
+    auto run = [&](opr::Convolution::ExecutionPolicy::Strategy strategy,
+                   uint32_t max_profile_candidates) {
+        auto graph_ys = make_graph(strategy, max_profile_candidates);
+        std::vector<HostTensorND> host_ys(graph_ys.second.size());
+        ComputingGraph::OutputSpec out_spec;
+        for (size_t i = 0; i < host_ys.size(); ++i) {
+            out_spec.push_back(make_callback_copy(graph_ys.second[i], host_ys[i]));
+        }
+        graph_ys.first->compile(out_spec)->execute();
+        return host_ys;
+    };
+
+    using S = opr::Convolution::ExecutionPolicy::Strategy;
+    auto expect = run(S::HEURISTIC, 0);
+    auto got = run(S::PROFILE, 2);
+    for (size_t i = 0; i < expect.size(); ++i) {
+        MGB_ASSERT_TENSOR_NEAR(expect[i], got[i], 1e-4);
+    }
+
+    // each key is profiled once, though it is shared by several oprs
+    ASSERT_GE(profiled_keys.size(), 2u);
+    std::sort(profiled_keys.begin(), profiled_keys.end());
+    ASSERT_EQ(
+            profiled_keys.end(),
+            std::adjacent_find(profiled_keys.begin(), profiled_keys.end()));
+}
+#endif  // MGB_ENABLE_FASTRUN
+
 }  // anonymous namespace
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
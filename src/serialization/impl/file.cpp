@@ -11,6 +11,13 @@
 
 #include "megbrain/serialization/file.h"
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace mgb {
 namespace serialization {
 
@@ -240,6 +247,37 @@ std::unique_ptr<InputFile> InputFile::make_mem_proxy(
     return std::make_unique<SharedMemProxyImpl>(std::move(ptr), size, writable);
 }
 
+std::unique_ptr<InputFile> InputFile::make_mmap(const char* path) {
+#ifdef WIN32
+    return make_fs(path);
+#else
+    int fd = open(path, O_RDONLY);
+    mgb_assert(fd >= 0, "failed to open %s: %s", path, strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st)) {
+        auto err = errno;
+        close(fd);
+        mgb_throw(MegBrainError, "failed to stat %s: %s", path, strerror(err));
+    }
+    size_t size = st.st_size;
+    if (!size) {
+        // empty file can not be mapped; let FsImpl report read errors
+        close(fd);
+        return make_fs(path);
+    }
+    // pages are copy-on-write so that in-place modification of the shared
+    // tensors is still allowed; untouched pages stay in the page cache
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    auto err = errno;
+    close(fd);
+    mgb_assert(addr != MAP_FAILED, "failed to mmap %s: %s", path, strerror(err));
+    std::shared_ptr<void> refhold{addr, [size](void* ptr) { munmap(ptr, size); }};
+    // read-only mode: tensors are shared only if they are already aligned, to
+    // avoid dirtying the mapped pages by moving data around
+    return std::make_unique<SharedMemProxyImpl>(std::move(refhold), size, false);
+#endif
+}
+
 class OutputFile::VectorProxyImpl final : public OutputFile {
     std::vector<uint8_t>* const m_buf;
     size_t m_offset;
@@ -79,6 +79,21 @@ void check_tensor_value_valid(const std::string& name, const HostTensorND& tenso
     }
 }
 
+/*!
+ * \brief key of the shared tensors on a NUMA node in SharedTensorMapEntry
+ *
+ * Like the device mem nodes, the identity is an entry of a static table; the
+ * node has been checked against MAX_NR_NUMA_NODE when the locator was parsed.
+ */
+MemNode numa_node_mem_key(int numa_node) {
+    constexpr int MAX_NR_NUMA_NODE = CompNode::Locator::MAX_NR_NUMA_NODE;
+    static char ids[MAX_NR_NUMA_NODE];
+    mgb_assert(
+            numa_node >= 0 && numa_node < MAX_NR_NUMA_NODE, "bad numa node: %d",
+            numa_node);
+    return MemNode{ids + numa_node};
+}
+
 }  // namespace
 
 namespace mgb {
@@ -423,9 +438,17 @@ void GraphDumperOSS::dump_tensor(
     }
 
     size_t value_size = 0;
+    uint32_t value_offset = 0;
     if (has_value) {
         check_tensor_value_valid(name, tensor);
         auto begin = m_file->tell();
+        auto align = m_config.tensor_value_alignment;
+        if (align > 1 && begin % align) {
+            // the loader skips Tensor::offset bytes before reading the value
+            value_offset = align - begin % align;
+            std::vector<uint8_t> padding(value_offset, 0);
+            m_file->write(padding.data(), value_offset);
+        }
         auto&& dumper = m_config.tensor_value_dumper;
         if (dumper) {
             dumper(*m_file, *m_cur_opr, tensor);
@@ -433,7 +456,7 @@ void GraphDumperOSS::dump_tensor(
             m_file->write(tensor.raw_ptr(), tensor.layout().span().high_byte);
         }
         value_size = m_file->tell() - begin;
-        m_cur_rst.tensor_value_bytes += value_size;
+        m_cur_rst.tensor_value_bytes += value_size - value_offset;
     }
 
     auto fbname = should_keep_name ? m_builder.CreateSharedString(name) : 0;
@@ -443,8 +466,8 @@ void GraphDumperOSS::dump_tensor(
             m_builder,
             m_builder.CreateSharedString(tensor.comp_node().to_string_logical()));
     auto dtype = build_dtype(tensor.dtype());
-    auto serialized_tensor =
-            fbs::CreateTensor(m_builder, fbname, shape, comp_node, dtype, value_size);
+    auto serialized_tensor = fbs::CreateTensor(
+            m_builder, fbname, shape, comp_node, dtype, value_size, value_offset);
     m_cur_opr_tensor.emplace_back(serialized_tensor);
 }
 
@@ -680,7 +703,13 @@ std::shared_ptr<DeviceTensorND> GraphLoaderOSS::OprLoadContextImpl::
     auto layout = load_tensor_layout(tensor);
     mgb_assert(tensor->data_size());
     auto&& sh_reg = m_loader->m_shared_tensor_map.at(m_cur_shared_tensor_idx++);
-    auto&& sh_ptr_ref = sh_reg.second[comp_node.mem_node()];
+    auto mem_key = comp_node.mem_node();
+    auto numa_node = comp_node.locator().numa_node;
+    if (m_loader->m_cur_load_config->numa_local_shared_tensor && numa_node >= 0 &&
+        mem_key == CompNode::default_cpu().mem_node()) {
+        mem_key = numa_node_mem_key(numa_node);
+    }
+    auto&& sh_ptr_ref = sh_reg.second[mem_key];
     if (sh_ptr_ref) {
         // cached tensor value is valid so we can reuse it
         load_tensor_value(nullptr, layout, tensor);
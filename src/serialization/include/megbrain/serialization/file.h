@@ -88,6 +88,18 @@ public:
      */
     static std::unique_ptr<InputFile> make_mem_proxy(
             std::shared_ptr<void> ptr, size_t size, bool writable = true);
+
+    /*!
+     * \brief create an InputFile that maps a file on local file system into
+     *      memory
+     *
+     * Tensor values that are suitably aligned in the file (see
+     * GraphDumpConfig::tensor_value_alignment) share the mapped pages
+     * instead of being copied. The mapping is private, so modifying the
+     * loaded tensors never changes the file. On platforms without mmap this
+     * is equivalent to make_fs().
+     */
+    static std::unique_ptr<InputFile> make_mmap(const char* path);
 };
 
 //! abstract output file interface
@@ -58,6 +58,12 @@ struct GraphDumpConfig {
     //! names. this list record the mapping between output node and it's name
     std::vector<std::pair<std::string, SymbolVar>> alias_name_map;
 
+    //! pad tensor values so that each of them starts at a multiple of this
+    //! number of bytes in the output file, which allows the weights to be
+    //! used in place when loaded by InputFile::make_mmap(); 0 or 1 disables
+    //! padding
+    size_t tensor_value_alignment = 64;
+
     GraphDumpConfig(
             int keep_var_name_ = 1, bool keep_param_name_ = false,
             bool keep_opr_priority_ = false, bool keep_op_name_ = true,
@@ -109,6 +115,12 @@ struct GraphLoadConfig {
     //! the shape
     bool const_var_shape = false;
 
+    //! whether to keep a separate copy of the shared tensors for each NUMA
+    //! node when the graph is loaded again onto CPU comp nodes on another
+    //! NUMA node; by default the tensors loaded first are shared by all CPU
+    //! comp nodes
+    bool numa_local_shared_tensor = false;
+
     //! callback to modify loaded tensors before they are inserted into the
     //! graph
     TensorModifier tensor_modifier;
@@ -18,6 +18,9 @@
 #include "megbrain/serialization/serializer.h"
 #include "megbrain/test/helper.h"
 
+#include <cstdlib>
+#include <fstream>
+
 using namespace mgb;
 using namespace serialization;
 
@@ -865,4 +868,103 @@ TEST(TestSerializer2, LOGEXP) {
     dump();
     load();
 }
+
+TEST(TestSerializer2, MmapReadIntoTensor) {
+    auto fname = GET_OUTPUT_FILE();
+    constexpr size_t HEADER = 64, NR_ELEM = 256;
+    std::vector<float> data(NR_ELEM);
+    for (size_t i = 0; i < NR_ELEM; ++i) {
+        data[i] = i * 0.5f;
+    }
+    {
+        auto fout = OutputFile::make_fs(fname.c_str());
+        std::vector<uint8_t> header(HEADER, 0);
+        fout->write(header.data(), HEADER);
+        fout->write(data.data(), NR_ELEM * sizeof(float));
+    }
+    auto fin = InputFile::make_mmap(fname.c_str());
+    auto header = fin->read_shared(HEADER);
+    auto cn = CompNode::load("cpu0");
+    HostTensorND hv{cn};
+    fin->read_into_tensor(hv, {{NR_ELEM}, dtype::Float32()});
+    ASSERT_EQ(HEADER + NR_ELEM * sizeof(float), fin->tell());
+#ifndef WIN32
+    // aligned tensor value should be a view into the mapped file
+    ASSERT_EQ(static_cast<const dt_byte*>(header.data()) + HEADER, hv.raw_ptr());
+#endif
+    for (size_t i = 0; i < NR_ELEM; ++i) {
+        ASSERT_EQ(data[i], hv.ptr<float>()[i]);
+    }
+}
+
+TEST(TestSerializer2, MmapLoadSharedParam) {
+    auto fname = GET_OUTPUT_FILE();
+    auto cn = CompNode::load("cpu0");
+    // odd size so that the second tensor value needs padding
+    TensorShape shape{5, 13};
+
+    HostTensorGenerator<> gen;
+    auto weight_hv = gen(shape, cn), bias_hv = gen(shape, cn);
+    {
+        auto graph = ComputingGraph::make();
+        auto w = opr::SharedDeviceTensor::make(*graph, *weight_hv, {"w"}),
+             y = opr::SharedDeviceTensor::make(*graph, *bias_hv, {"y"});
+        auto dumper = GraphDumper::make(
+                OutputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+        GraphDumper::DumpConfig config;
+        config.keep_param_name = true;
+        dumper->dump({(w + y).rename("z")}, config);
+    }
+
+    auto loader = GraphLoader::make(
+            InputFile::make_mmap(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+    auto rst = loader->load();
+    auto align = cn.get_mem_addr_alignment();
+    auto shmap = loader->shared_tensor_name_map();
+#ifdef __linux__
+    // find the mapping that contains ptr in /proc/self/maps and check that it
+    // is backed by the dumped file, i.e. the param was not copied out
+    std::unique_ptr<char, void (*)(void*)> real_fname{
+            realpath(fname.c_str(), nullptr), ::free};
+    ASSERT_NE(nullptr, real_fname);
+    auto in_mapped_file = [&](const void* ptr) {
+        auto addr = reinterpret_cast<uintptr_t>(ptr);
+        std::ifstream maps{"/proc/self/maps"};
+        std::string line;
+        while (std::getline(maps, line)) {
+            unsigned long long begin, end;
+            int path_pos = -1;
+            if (sscanf(line.c_str(), "%llx-%llx %*s %*s %*s %*s %n", &begin, &end,
+                       &path_pos) < 2 ||
+                path_pos < 0 || addr < begin || addr >= end)
+                continue;
+            return line.substr(path_pos) == real_fname.get();
+        }
+        return false;
+    };
+#endif
+    auto check_param = [&](const char* name, const HostTensorND& expect) {
+        auto&& entry = *shmap.at(name);
+        ASSERT_EQ(1u, entry.size());
+        auto&& val = *entry.begin()->second;
+        ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(val.raw_ptr()) & (align - 1));
+#ifdef __linux__
+        ASSERT_TRUE(in_mapped_file(val.raw_ptr())) << name;
+#endif
+        HostTensorND host_val;
+        host_val.copy_from(val).sync();
+        MGB_ASSERT_TENSOR_EQ(expect, host_val);
+    };
+    check_param("w", *weight_hv);
+    check_param("y", *bias_hv);
+
+    HostTensorND host_z, host_z_expect;
+    host_z_expect.copy_from(*weight_hv);
+    for (size_t i = 0, it = shape.total_nr_elems(); i < it; ++i)
+        host_z_expect.ptr<float>()[i] += bias_hv->ptr<float>()[i];
+    auto func = rst.graph_compile(
+            {make_callback_copy(rst.output_var_map.at("z"), host_z)});
+    func->execute();
+    MGB_ASSERT_TENSOR_EQ(host_z_expect, host_z);
+}
 #endif